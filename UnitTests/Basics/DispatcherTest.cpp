@@ -0,0 +1,272 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for the sharded dispatcher queue
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Dispatcher/Dispatcher.h"
+#include "Dispatcher/Job.h"
+#include "Scheduler/SchedulerThread.h"
+
+using namespace triagens;
+using namespace triagens::basics;
+using namespace triagens::rest;
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief state shared by the test jobs
+////////////////////////////////////////////////////////////////////////////////
+
+struct JobState {
+  JobState ()
+    : _blocked(true),
+      _running(0),
+      _done(0) {
+  }
+
+  std::atomic<bool> _blocked;
+  std::atomic<int> _running;
+  std::atomic<int> _done;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a job which optionally waits until it is released
+////////////////////////////////////////////////////////////////////////////////
+
+class TestJob : public Job {
+  public:
+    TestJob (JobState* state, JobType type, bool blocking)
+      : Job("TestJob"),
+        _state(state),
+        _type(type),
+        _blocking(blocking) {
+    }
+
+    JobType type () const override {
+      return _type;
+    }
+
+    status_t work () override {
+      ++_state->_running;
+
+      while (_blocking && _state->_blocked.load()) {
+        usleep(1000);
+      }
+
+      ++_state->_done;
+
+      return status_t(JOB_DONE);
+    }
+
+    bool cancel (bool) override {
+      return true;
+    }
+
+    void cleanup () override {
+      delete this;
+    }
+
+    bool beginShutdown () override {
+      return true;
+    }
+
+    void handleError (basics::Exception const&) override {
+    }
+
+  private:
+    JobState* _state;
+    JobType const _type;
+    bool const _blocking;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits until a counter has reached a value, at most 10 seconds
+////////////////////////////////////////////////////////////////////////////////
+
+static bool WaitFor (std::atomic<int> const& counter, int value) {
+  for (int i = 0;  i < 10000;  ++i) {
+    if (counter.load() >= value) {
+      return true;
+    }
+
+    usleep(1000);
+  }
+
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct DispatcherSetup {
+  DispatcherSetup ()
+    : _dispatcher(nullptr) {
+    BOOST_TEST_MESSAGE("setup Dispatcher");
+
+    // all jobs created by this thread go into the first shard
+    SchedulerThread::currentThreadNumber = 0;
+  }
+
+  ~DispatcherSetup () {
+    BOOST_TEST_MESSAGE("tear-down Dispatcher");
+
+    _state._blocked = false;
+
+    _dispatcher.beginShutdown();
+    _dispatcher.shutdown();
+
+    SchedulerThread::currentThreadNumber = -1;
+  }
+
+  JobState _state;
+  Dispatcher _dispatcher;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE (DispatcherTest, DispatcherSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test an idle shard takes over read jobs of a busy shard
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (DispatcherStealReadJob) {
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, _dispatcher.addStandardQueue(2, 100, 2));
+  _dispatcher.start();
+
+  // occupies the only thread of the first shard
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, _dispatcher.addJob(new TestJob(&_state, Job::READ_JOB, true)));
+  BOOST_CHECK(WaitFor(_state._running, 1));
+
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, _dispatcher.addJob(new TestJob(&_state, Job::READ_JOB, false)));
+
+  // the first shard has a single thread, so a second thread must have run
+  // one of the jobs
+  BOOST_CHECK(WaitFor(_state._done, 1));
+  BOOST_CHECK_EQUAL(true, _state._blocked.load());
+
+  _state._blocked = false;
+  BOOST_CHECK(WaitFor(_state._done, 2));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test an idle shard takes over write jobs of a busy shard
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (DispatcherStealWriteJob) {
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, _dispatcher.addStandardQueue(2, 100, 2));
+  _dispatcher.start();
+
+  // a write job monopolizes the first shard
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, _dispatcher.addJob(new TestJob(&_state, Job::WRITE_JOB, true)));
+  BOOST_CHECK(WaitFor(_state._running, 1));
+
+  for (int i = 0;  i < 5;  ++i) {
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, _dispatcher.addJob(new TestJob(&_state, Job::WRITE_JOB, false)));
+  }
+
+  BOOST_CHECK(WaitFor(_state._done, 5));
+  BOOST_CHECK_EQUAL(true, _state._blocked.load());
+
+  _state._blocked = false;
+  BOOST_CHECK(WaitFor(_state._done, 6));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the queue size limits all shards together
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (DispatcherQueueFull) {
+  size_t const maxSize = 10;
+
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, _dispatcher.addStandardQueue(2, maxSize, 2));
+  _dispatcher.start();
+
+  // all jobs go into the first shard. it must accept the full queue size
+  // and not only its part of it. each thread may have taken one job off
+  size_t accepted = 0;
+  int res = TRI_ERROR_NO_ERROR;
+
+  while (res == TRI_ERROR_NO_ERROR && accepted < 100) {
+    Job* job = new TestJob(&_state, Job::READ_JOB, true);
+    res = _dispatcher.addJob(job);
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      ++accepted;
+    }
+    else {
+      delete job;
+    }
+  }
+
+  BOOST_CHECK_EQUAL(TRI_ERROR_QUEUE_FULL, res);
+  BOOST_CHECK(accepted >= maxSize);
+  BOOST_CHECK(accepted <= maxSize + 2);
+
+  // the shards of the round-robin distribution are full as well
+  SchedulerThread::currentThreadNumber = -1;
+
+  for (int i = 0;  i < 4;  ++i) {
+    Job* job = new TestJob(&_state, Job::READ_JOB, false);
+    BOOST_CHECK_EQUAL(TRI_ERROR_QUEUE_FULL, _dispatcher.addJob(job));
+    delete job;
+  }
+
+  // executed jobs free their place in the queue again
+  _state._blocked = false;
+  BOOST_CHECK(WaitFor(_state._done, (int) accepted));
+
+  for (size_t i = 0;  i < maxSize;  ++i) {
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, _dispatcher.addJob(new TestJob(&_state, Job::READ_JOB, false)));
+  }
+
+  BOOST_CHECK(WaitFor(_state._done, (int) (accepted + maxSize)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
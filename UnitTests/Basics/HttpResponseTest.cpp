@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for HttpResponse compression
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/StringBuffer.h"
+#include "Rest/HttpResponse.h"
+
+using namespace triagens;
+using namespace triagens::basics;
+using namespace triagens::rest;
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a response with a well compressible body
+////////////////////////////////////////////////////////////////////////////////
+
+static HttpResponse* CreateResponse (size_t length) {
+  HttpResponse* response = new HttpResponse(HttpResponse::OK, 20600);
+  response->setHeader("content-type", strlen("content-type"), "application/json; charset=utf-8");
+
+  string const value = "{\"value\":\"the quick brown foxx jumped over the lazy dog\"}";
+
+  while (response->body().length() < length) {
+    response->body().appendText(value);
+  }
+
+  return response;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a header of a response
+////////////////////////////////////////////////////////////////////////////////
+
+static string Header (HttpResponse const* response,
+                      string const& name,
+                      bool& found) {
+  return response->header(name, found);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct HttpResponseSetup {
+  HttpResponseSetup () {
+    BOOST_TEST_MESSAGE("setup HttpResponse");
+  }
+
+  ~HttpResponseSetup () {
+    BOOST_TEST_MESSAGE("tear-down HttpResponse");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE (HttpResponseTest, HttpResponseSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test deflate is preferred and can be inflated again
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (HttpResponseCompressDeflate) {
+  HttpResponse* response = CreateResponse(100000);
+  string const original(response->body().c_str(), response->body().length());
+
+  bool compressed;
+  bool found;
+  int res = response->compressForClient("gzip, deflate", 1000, 0, compressed);
+
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, res);
+  BOOST_CHECK_EQUAL(true, compressed);
+  BOOST_CHECK(response->body().length() < original.size());
+  BOOST_CHECK_EQUAL("deflate", Header(response, "content-encoding", found));
+  BOOST_CHECK_EQUAL(true, found);
+  BOOST_CHECK_EQUAL("Accept-Encoding", Header(response, "vary", found));
+
+  StringBuffer inflated(TRI_UNKNOWN_MEM_ZONE);
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, response->body().inflate(inflated));
+  BOOST_CHECK_EQUAL(original, string(inflated.c_str(), inflated.length()));
+
+  delete response;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test gzip is used if the client does not accept deflate
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (HttpResponseCompressGzip) {
+  HttpResponse* response = CreateResponse(100000);
+
+  bool compressed;
+  bool found;
+  int res = response->compressForClient("deflate;q=0, GZIP;q=0.5", 1000, 0, compressed);
+
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, res);
+  BOOST_CHECK_EQUAL(true, compressed);
+  BOOST_CHECK_EQUAL("gzip", Header(response, "content-encoding", found));
+
+  // gzip magic bytes
+  BOOST_CHECK_EQUAL((unsigned char) 0x1f, (unsigned char) response->body().c_str()[0]);
+  BOOST_CHECK_EQUAL((unsigned char) 0x8b, (unsigned char) response->body().c_str()[1]);
+
+  delete response;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test no compression without a matching accept-encoding
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (HttpResponseCompressNotAccepted) {
+  char const* headers[] = { "", "identity", "br", "deflate;q=0", "gzip;q=0.0, deflate; q=0" };
+
+  for (size_t i = 0; i < sizeof(headers) / sizeof(headers[0]); ++i) {
+    HttpResponse* response = CreateResponse(100000);
+    size_t const length = response->body().length();
+
+    bool compressed;
+    bool found;
+    int res = response->compressForClient(headers[i], 1000, 0, compressed);
+
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, res);
+    BOOST_CHECK_EQUAL(false, compressed);
+    BOOST_CHECK_EQUAL(length, response->body().length());
+    Header(response, "content-encoding", found);
+    BOOST_CHECK_EQUAL(false, found);
+
+    // the response could have been compressed for another client
+    BOOST_CHECK_EQUAL("Accept-Encoding", Header(response, "vary", found));
+
+    delete response;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the size thresholds
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (HttpResponseCompressThresholds) {
+  bool compressed;
+  bool found;
+
+  // too small
+  HttpResponse* response = CreateResponse(500);
+  size_t length = response->body().length();
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, response->compressForClient("deflate", length + 1, 0, compressed));
+  BOOST_CHECK_EQUAL(false, compressed);
+  BOOST_CHECK_EQUAL(length, response->body().length());
+  Header(response, "vary", found);
+  BOOST_CHECK_EQUAL(false, found);
+  delete response;
+
+  // exactly the minimal size
+  response = CreateResponse(500);
+  length = response->body().length();
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, response->compressForClient("deflate", length, 0, compressed));
+  BOOST_CHECK_EQUAL(true, compressed);
+  delete response;
+
+  // too big
+  response = CreateResponse(100000);
+  length = response->body().length();
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, response->compressForClient("deflate", 1000, length - 1, compressed));
+  BOOST_CHECK_EQUAL(false, compressed);
+  BOOST_CHECK_EQUAL(length, response->body().length());
+  delete response;
+
+  // exactly the maximal size
+  response = CreateResponse(100000);
+  length = response->body().length();
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, response->compressForClient("deflate", 1000, length, compressed));
+  BOOST_CHECK_EQUAL(true, compressed);
+  delete response;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test already encoded bodies are left alone
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (HttpResponseCompressAlreadyEncoded) {
+  HttpResponse* response = CreateResponse(100000);
+  response->setHeader("content-encoding", strlen("content-encoding"), "x-custom");
+  size_t const length = response->body().length();
+
+  bool compressed;
+  bool found;
+  int res = response->compressForClient("gzip, deflate", 1000, 0, compressed);
+
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, res);
+  BOOST_CHECK_EQUAL(false, compressed);
+  BOOST_CHECK_EQUAL(length, response->body().length());
+  BOOST_CHECK_EQUAL("x-custom", Header(response, "content-encoding", found));
+
+  delete response;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test incompressible content types and bodies
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (HttpResponseCompressIncompressible) {
+  bool compressed;
+
+  HttpResponse* response = CreateResponse(100000);
+  response->setHeader("content-type", strlen("content-type"), "image/png");
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, response->compressForClient("deflate", 1000, 0, compressed));
+  BOOST_CHECK_EQUAL(false, compressed);
+  delete response;
+
+  // pseudo-random data does not shrink by 10 %
+  response = new HttpResponse(HttpResponse::OK, 20600);
+  uint32_t state = 12345;
+
+  for (size_t i = 0; i < 100000; ++i) {
+    state = state * 1103515245 + 12345;
+    response->body().appendChar((char) (state >> 16));
+  }
+
+  size_t const length = response->body().length();
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, response->compressForClient("deflate", 1000, 0, compressed));
+  BOOST_CHECK_EQUAL(false, compressed);
+  BOOST_CHECK_EQUAL(length, response->body().length());
+  delete response;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test an existing vary header is extended
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (HttpResponseCompressVary) {
+  HttpResponse* response = CreateResponse(100000);
+  response->setHeader("vary", strlen("vary"), "Origin");
+
+  bool compressed;
+  bool found;
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, response->compressForClient("deflate", 1000, 0, compressed));
+  BOOST_CHECK_EQUAL("Origin, Accept-Encoding", Header(response, "vary", found));
+
+  delete response;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
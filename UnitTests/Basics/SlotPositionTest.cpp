@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for the write-ahead log reservation position
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Wal/SlotPosition.h"
+
+using namespace triagens;
+using namespace triagens::wal;
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct SlotPositionSetup {
+  SlotPositionSetup () {
+    BOOST_TEST_MESSAGE("setup SlotPosition");
+  }
+
+  ~SlotPositionSetup () {
+    BOOST_TEST_MESSAGE("tear-down SlotPosition");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE (SlotPositionTest, SlotPositionSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the parts of a position survive a round trip
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (SlotPositionRoundTrip) {
+  size_t const numbers[] = { 8192, 1048576, 1048577, 16777216 };
+
+  for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i) {
+    SlotPosition layout(numbers[i]);
+
+    uint64_t const maxOffset = ((1ULL << 29) - 1) * TRI_DF_BLOCK_ALIGNMENT;
+    uint64_t const maxGeneration = layout.generations() - 1;
+
+    uint64_t position = layout.make(maxOffset, numbers[i] - 1, maxGeneration, false);
+    BOOST_CHECK_EQUAL(maxOffset, layout.offset(position));
+    BOOST_CHECK_EQUAL(numbers[i] - 1, layout.index(position));
+    BOOST_CHECK_EQUAL(maxGeneration, layout.generation(position));
+    BOOST_CHECK_EQUAL(false, layout.blocked(position));
+
+    position = layout.make(64, 1, 3, true);
+    BOOST_CHECK_EQUAL((uint64_t) 64, layout.offset(position));
+    BOOST_CHECK_EQUAL((size_t) 1, layout.index(position));
+    BOOST_CHECK_EQUAL((uint64_t) 3, layout.generation(position));
+    BOOST_CHECK_EQUAL(true, layout.blocked(position));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the documented number of generations before a wrap
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (SlotPositionGenerations) {
+  // the maximum number of slots leaves the fewest bits for the generation
+  BOOST_CHECK_EQUAL((uint64_t) 1024, SlotPosition(16777216).generations());
+  // default number of slots
+  BOOST_CHECK_EQUAL((uint64_t) 16384, SlotPosition(1048576).generations());
+  // minimum number of slots
+  BOOST_CHECK_EQUAL((uint64_t) 2097152, SlotPosition(8192).generations());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the generation wraps around only after all generations
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (SlotPositionGenerationWrap) {
+  SlotPosition layout(16777216);
+
+  uint64_t const first = layout.make(4096, 17, 0, false);
+  uint64_t position = first;
+
+  // a logfile switch increments the generation, as in Slots::switchLogfile
+  for (uint64_t i = 1; i < layout.generations(); ++i) {
+    position = layout.make(4096, 17, layout.generation(position) + 1, false);
+    BOOST_CHECK(position != first);
+  }
+
+  position = layout.make(4096, 17, layout.generation(position) + 1, false);
+  BOOST_CHECK_EQUAL(first, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
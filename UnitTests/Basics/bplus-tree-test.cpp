@@ -0,0 +1,425 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for BPlusTree
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/bplus-tree.h"
+#include "Basics/voc-errors.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+using namespace std;
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private helpers
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test element. the preorder only looks at the key, the total order
+/// at the key and the id
+////////////////////////////////////////////////////////////////////////////////
+
+struct Element {
+  int key;
+  int id;
+};
+
+static int CmpElmElm (void*,
+                      void* left,
+                      void* right,
+                      SkipListCmpType cmptype) {
+  auto l = static_cast<Element*>(left);
+  auto r = static_cast<Element*>(right);
+
+  if (l->key != r->key) {
+    return l->key < r->key ? -1 : 1;
+  }
+  if (cmptype == SKIPLIST_CMP_PREORDER || l->id == r->id) {
+    return 0;
+  }
+  return l->id < r->id ? -1 : 1;
+}
+
+static int CmpKeyElm (void*,
+                      void* left,
+                      void* right) {
+  auto l = *(static_cast<int*>(left));
+  auto r = static_cast<Element*>(right);
+
+  if (l != r->key) {
+    return l < r->key ? -1 : 1;
+  }
+  return 0;
+}
+
+static uint64_t PrefixElm (void*,
+                           void* e) {
+  // coarse on purpose, so that equal prefixes have to be resolved by the
+  // comparison functions
+  return (static_cast<uint64_t>(static_cast<Element*>(e)->key) + 0x80000000ULL) >> 2;
+}
+
+static bool PrefixKey (void*,
+                       void* k,
+                       uint64_t* prefix) {
+  *prefix = (static_cast<uint64_t>(*static_cast<int*>(k)) + 0x80000000ULL) >> 2;
+  return true;
+}
+
+static int Freed = 0;
+
+static void FreeElm (void*) {
+  ++Freed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks that a forward and a backward scan return the expected
+/// elements
+////////////////////////////////////////////////////////////////////////////////
+
+static void CheckContents (BPlusTree const& tree,
+                           std::set<std::pair<int, int>> const& expected) {
+  BOOST_CHECK_EQUAL(expected.size(), tree.getNrUsed());
+
+  BPlusTreePosition p = tree.nextPosition(tree.startPosition());
+
+  for (auto const& it : expected) {
+    BOOST_REQUIRE(p != tree.endPosition());
+    auto e = static_cast<Element*>(tree.document(p));
+    BOOST_CHECK_EQUAL(it.first, e->key);
+    BOOST_CHECK_EQUAL(it.second, e->id);
+    p = tree.nextPosition(p);
+  }
+  BOOST_CHECK(p == tree.endPosition());
+
+  p = tree.prevPosition(tree.endPosition());
+
+  for (auto it = expected.rbegin(); it != expected.rend(); ++it) {
+    BOOST_REQUIRE(p != tree.startPosition());
+    auto e = static_cast<Element*>(tree.document(p));
+    BOOST_CHECK_EQUAL((*it).first, e->key);
+    BOOST_CHECK_EQUAL((*it).second, e->id);
+    p = tree.prevPosition(p);
+  }
+  BOOST_CHECK(p == tree.startPosition());
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CBPlusTreeSetup {
+  CBPlusTreeSetup () {
+    BOOST_TEST_MESSAGE("setup BPlusTree");
+  }
+
+  ~CBPlusTreeSetup () {
+    BOOST_TEST_MESSAGE("tear-down BPlusTree");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CBPlusTreeTest, CBPlusTreeSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test an empty tree
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_empty) {
+  BPlusTree tree(CmpElmElm, CmpKeyElm, PrefixElm, PrefixKey, nullptr, nullptr, false);
+
+  BOOST_CHECK_EQUAL(0, (int) tree.getNrUsed());
+  BOOST_CHECK_EQUAL(1, tree.height());
+  BOOST_CHECK(tree.nextPosition(tree.startPosition()) == tree.endPosition());
+  BOOST_CHECK(tree.prevPosition(tree.endPosition()) == tree.startPosition());
+
+  int key = 17;
+  BOOST_CHECK(tree.leftKeyLookup(&key) == tree.startPosition());
+  BOOST_CHECK(tree.rightKeyLookup(&key) == tree.startPosition());
+
+  Element e{ 17, 1 };
+  BOOST_CHECK(tree.lookup(&e) == tree.endPosition());
+  BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND, tree.remove(&e));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test filling in forward and reverse order
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_unique_forward_reverse) {
+  for (int reverse = 0; reverse < 2; ++reverse) {
+    BPlusTree tree(CmpElmElm, CmpKeyElm, PrefixElm, PrefixKey, nullptr, nullptr, true);
+
+    std::vector<Element> values;
+    std::set<std::pair<int, int>> expected;
+
+    for (int i = 0; i < 5000; ++i) {
+      values.push_back(Element{ i, 0 });
+      expected.emplace(i, 0);
+    }
+
+    for (int i = 0; i < 5000; ++i) {
+      int j = reverse ? 4999 - i : i;
+      BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.insert(&values[j]));
+    }
+
+    BOOST_CHECK(tree.height() > 2);
+    CheckContents(tree, expected);
+
+    for (int i = 0; i < 5000; ++i) {
+      BPlusTreePosition p = tree.lookup(&values[i]);
+      BOOST_REQUIRE(p != tree.endPosition());
+      BOOST_CHECK_EQUAL((void*) &values[i], tree.document(p));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test unique constraint violations
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_unique_violation) {
+  BPlusTree tree(CmpElmElm, CmpKeyElm, PrefixElm, PrefixKey, nullptr, nullptr, true);
+
+  std::vector<Element> values;
+  for (int i = 0; i < 200; ++i) {
+    values.push_back(Element{ i * 2, i });
+  }
+  for (auto& it : values) {
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.insert(&it));
+  }
+
+  // same document
+  BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED, tree.insert(&values[17]));
+
+  // same key, different id
+  for (int i = 0; i < 200; ++i) {
+    Element other{ i * 2, 1000 + i };
+    BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED, tree.insert(&other));
+  }
+
+  BOOST_CHECK_EQUAL(200, (int) tree.getNrUsed());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test lookups in a non-unique tree
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_lookups) {
+  for (int withPrefix = 0; withPrefix < 2; ++withPrefix) {
+    BPlusTree tree(CmpElmElm,
+                   CmpKeyElm,
+                   withPrefix ? PrefixElm : nullptr,
+                   withPrefix ? PrefixKey : nullptr,
+                   nullptr,
+                   nullptr,
+                   false);
+
+    // keys 0, 10, 20, ... each with 7 different ids
+    std::vector<Element> values;
+    for (int i = 0; i < 300; ++i) {
+      for (int j = 0; j < 7; ++j) {
+        values.push_back(Element{ i * 10, j });
+      }
+    }
+    std::random_shuffle(values.begin(), values.end());
+
+    for (auto& it : values) {
+      BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.insert(&it));
+    }
+
+    for (int key = -5; key < 3010; key += 5) {
+      BPlusTreePosition left = tree.leftKeyLookup(&key);
+      BPlusTreePosition right = tree.rightKeyLookup(&key);
+
+      // the left lookup points at the last element with a smaller key
+      if (key <= 0) {
+        BOOST_CHECK(left == tree.startPosition());
+      }
+      else {
+        auto e = static_cast<Element*>(tree.document(left));
+        BOOST_CHECK_EQUAL(std::min(2990, ((key - 1) / 10) * 10), e->key);
+        BOOST_CHECK_EQUAL(6, e->id);
+      }
+
+      // the right lookup points at the last element with a smaller or equal key
+      if (key < 0) {
+        BOOST_CHECK(right == tree.startPosition());
+      }
+      else {
+        auto e = static_cast<Element*>(tree.document(right));
+        BOOST_CHECK_EQUAL(std::min(2990, (key / 10) * 10), e->key);
+        BOOST_CHECK_EQUAL(6, e->id);
+      }
+
+      // count the elements in between
+      int found = 0;
+      for (BPlusTreePosition p = tree.nextPosition(left); p != tree.nextPosition(right); p = tree.nextPosition(p)) {
+        BOOST_CHECK_EQUAL(key, static_cast<Element*>(tree.document(p))->key);
+        ++found;
+      }
+      BOOST_CHECK_EQUAL((key >= 0 && key < 3000 && key % 10 == 0) ? 7 : 0, found);
+
+      // element lookups use the preorder as well
+      Element probe{ key, 3 };
+      BOOST_CHECK(tree.leftLookup(&probe) == left);
+      BOOST_CHECK(tree.rightLookup(&probe) == right);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test random inserts and removals against a reference
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_random_insert_remove) {
+  BPlusTree tree(CmpElmElm, CmpKeyElm, PrefixElm, PrefixKey, nullptr, FreeElm, false);
+
+  std::vector<Element> values;
+  for (int i = 0; i < 20000; ++i) {
+    values.push_back(Element{ (i * 7919) % 1000, i });
+  }
+
+  std::set<std::pair<int, int>> expected;
+  std::vector<bool> present(values.size(), false);
+
+  srand(42);
+  Freed = 0;
+  int removed = 0;
+
+  for (int round = 0; round < 6; ++round) {
+    // alternate between growing and shrinking phases
+    bool const grow = (round % 2 == 0);
+
+    for (int i = 0; i < 30000; ++i) {
+      size_t j = (size_t) rand() % values.size();
+      Element& e = values[j];
+
+      if (grow ? ! present[j] : present[j]) {
+        if (grow) {
+          BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.insert(&e));
+          expected.emplace(e.key, e.id);
+        }
+        else {
+          BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.remove(&e));
+          expected.erase(std::make_pair(e.key, e.id));
+          ++removed;
+        }
+        present[j] = ! present[j];
+      }
+      else if (grow) {
+        BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED, tree.insert(&e));
+      }
+      else {
+        BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND, tree.remove(&e));
+      }
+    }
+
+    CheckContents(tree, expected);
+    BOOST_CHECK_EQUAL(removed, Freed);
+  }
+
+  // remove everything
+  for (size_t j = 0; j < values.size(); ++j) {
+    if (present[j]) {
+      BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.remove(&values[j]));
+    }
+  }
+
+  CheckContents(tree, std::set<std::pair<int, int>>());
+  BOOST_CHECK_EQUAL(1, tree.height());
+  BOOST_CHECK_EQUAL(sizeof(BPlusTree) + sizeof(BPlusTreeLeaf), tree.memoryUsage());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test bulk loading
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_bulk_load) {
+  for (size_t n : { 1, 27, 28, 29, 1000, 100000 }) {
+    BPlusTree tree(CmpElmElm, CmpKeyElm, PrefixElm, PrefixKey, nullptr, nullptr, false);
+
+    std::vector<Element> values;
+    std::vector<void*> docs;
+    std::set<std::pair<int, int>> expected;
+
+    for (size_t i = 0; i < n; ++i) {
+      values.push_back(Element{ (int) (i / 3), (int) i });
+      expected.emplace((int) (i / 3), (int) i);
+    }
+    for (auto& it : values) {
+      docs.push_back(&it);
+    }
+
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.bulkLoad(&docs[0], docs.size()));
+    CheckContents(tree, expected);
+
+    int key = (int) (n / 6);
+    BPlusTreePosition left = tree.leftKeyLookup(&key);
+    BPlusTreePosition right = tree.rightKeyLookup(&key);
+    int found = 0;
+    for (BPlusTreePosition p = tree.nextPosition(left); p != tree.nextPosition(right); p = tree.nextPosition(p)) {
+      ++found;
+    }
+    BOOST_CHECK_EQUAL(std::min(3, (int) n - key * 3), found);
+
+    // the tree stays usable after a bulk load
+    std::vector<Element> more;
+    for (size_t i = 0; i < n; ++i) {
+      more.push_back(Element{ (int) (i / 3), (int) (n + i) });
+    }
+    for (auto& it : more) {
+      BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.insert(&it));
+      expected.emplace(it.key, it.id);
+    }
+    for (size_t i = 0; i < n; i += 2) {
+      BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.remove(&values[i]));
+      expected.erase(std::make_pair(values[i].key, values[i].id));
+    }
+    CheckContents(tree, expected);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for the json parser
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2014 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2014, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/json.h"
+#include "Basics/string-buffer.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a text and returns the stringified result or the error
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string Parse (char const* text) {
+  char* error = nullptr;
+  TRI_json_t* json = TRI_Json2String(TRI_UNKNOWN_MEM_ZONE, text, &error);
+
+  std::string result;
+
+  if (json == nullptr) {
+    result = std::string("error: ") + (error != nullptr ? error : "");
+  }
+  else {
+    TRI_string_buffer_t buffer;
+    TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
+    TRI_StringifyJson(&buffer, json);
+    result = std::string(TRI_BeginStringBuffer(&buffer), TRI_LengthStringBuffer(&buffer));
+    TRI_DestroyStringBuffer(&buffer);
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+  }
+
+  if (error != nullptr) {
+    TRI_Free(TRI_CORE_MEM_ZONE, error);
+  }
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CJsonParserSetup {
+  CJsonParserSetup () {
+    BOOST_TEST_MESSAGE("setup json parser");
+  }
+
+  ~CJsonParserSetup () {
+    BOOST_TEST_MESSAGE("tear-down json parser");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CJsonParserTest, CJsonParserSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test atoms
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_parser_atoms) {
+  BOOST_CHECK_EQUAL("null", Parse("null"));
+  BOOST_CHECK_EQUAL("true", Parse(" true "));
+  BOOST_CHECK_EQUAL("false", Parse("\n\tfalse\r\n"));
+  BOOST_CHECK_EQUAL("true", Parse("TRUE"));
+  BOOST_CHECK_EQUAL("null", Parse("Null"));
+  BOOST_CHECK_EQUAL("\"\"", Parse("\"\""));
+  BOOST_CHECK_EQUAL("\"foo\"", Parse("\"foo\""));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test numbers
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_parser_numbers) {
+  BOOST_CHECK_EQUAL("0", Parse("0"));
+  BOOST_CHECK_EQUAL("-1", Parse("-1"));
+  BOOST_CHECK_EQUAL("3", Parse("+3"));
+  BOOST_CHECK_EQUAL("1.5", Parse("1.5"));
+  BOOST_CHECK_EQUAL("-150", Parse("-1.5e2"));
+  BOOST_CHECK_EQUAL("0.015", Parse("1.5E-2"));
+  BOOST_CHECK_EQUAL("[1,2]", Parse("[1,2]"));
+
+  BOOST_CHECK_EQUAL("error: failed to parse json object: expecting EOF", Parse("01"));
+  BOOST_CHECK_EQUAL("error: expecting comma", Parse("[1.]"));
+  BOOST_CHECK_EQUAL("error: expected object, got unquoted string", Parse("-"));
+  BOOST_CHECK_EQUAL("error: number too big", Parse("1e400"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test strings that span several 16 byte blocks
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_parser_long_strings) {
+  BOOST_CHECK_EQUAL("\"0123456789abcdef0123456789abcdef\"",
+                    Parse("\"0123456789abcdef0123456789abcdef\""));
+  BOOST_CHECK_EQUAL("\"0123456789abcdef\\\"0123456789abcdef\"",
+                    Parse("\"0123456789abcdef\\\"0123456789abcdef\""));
+  BOOST_CHECK_EQUAL("\"0123456789abcdef\\n0123456789abcdef\"",
+                    Parse("\"0123456789abcdef\\u000a0123456789abcdef\""));
+  BOOST_CHECK_EQUAL("\"0123456789abcdef\\u00E40123456789abcdef\\\"\"",
+                    Parse("\"0123456789abcdef\xc3\xa4" "0123456789abcdef\\\"\""));
+  BOOST_CHECK_EQUAL("error: expected object, got unquoted string",
+                    Parse("\"0123456789abcdef0123456789abcdef"));
+  BOOST_CHECK_EQUAL("error: expected object, got unquoted string",
+                    Parse("\"0123456789abcdef0123456789abcdef\\\""));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test lists and objects
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_parser_structures) {
+  BOOST_CHECK_EQUAL("[]", Parse("[ ]"));
+  BOOST_CHECK_EQUAL("{}", Parse("{ }"));
+  BOOST_CHECK_EQUAL("{\"a\":[1,{\"b\":null}],\"\":\"\"}", Parse("{ \"a\" : [ 1, { \"b\" : null } ], \"\" : \"\" }"));
+  BOOST_CHECK_EQUAL("{\"\\u00E4\":true}", Parse("{\"\\u00e4\":true}"));
+
+  BOOST_CHECK_EQUAL("error: expecting a list element, got end-of-file", Parse("[1"));
+  BOOST_CHECK_EQUAL("error: expecting atom, got end-of-file", Parse("[1,"));
+  BOOST_CHECK_EQUAL("error: expecting a object attribute name or element, got end-of-file", Parse("{\"a\":1"));
+  BOOST_CHECK_EQUAL("error: expecting attribute name", Parse("{a:1}"));
+  BOOST_CHECK_EQUAL("error: expecting colon", Parse("{\"a\",1}"));
+  BOOST_CHECK_EQUAL("error: expected object, got '}'", Parse("{\"a\":}"));
+  BOOST_CHECK_EQUAL("error: expecting atom, got end-of-file", Parse(""));
+  BOOST_CHECK_EQUAL("error: failed to parse json object: expecting EOF", Parse("[] []"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -184,6 +184,52 @@ BOOST_AUTO_TEST_CASE (tst_compare_values_unequal) {
   // TODO: add more tests
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that sort keys order like the values
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_sort_keys) {
+  char const* values[] = {
+    "null", "false", "true", "-1e300", "-10", "-1.5", "-1", "-0.0", "0", "0.5",
+    "1", "10", "1e300", "\"\"", "\" \"", "\"0\"", "\"-1\"", "\"a\"", "\"ab\"",
+    "\"b\"", "\"a\\u0001\"", "[]", "[null]", "[null, null]", "[false]", "[0]",
+    "[0, null]", "[0, false]", "[null, 1]", "[[]]", "[[0], 1]", "[\"a\"]", "[{}]",
+    "{}", "{\"a\": null}", "{\"a\": 1}", "{\"a\": 2}", "{\"b\": 1}",
+    "{\"a\": 1, \"b\": 1}", "{\"ab\": 1}", "{\"a\": [1]}", "{\"a\": {\"b\": 1}}"
+  };
+  size_t const n = sizeof(values) / sizeof(values[0]);
+
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      TRI_json_t* l = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, values[i]);
+      TRI_json_t* r = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, values[j]);
+      BOOST_REQUIRE(l != nullptr && r != nullptr);
+
+      std::string lKey;
+      std::string rKey;
+      TRI_AppendSortKeyJson(lKey, l);
+      TRI_AppendSortKeyJson(rKey, r);
+
+      int expected = TRI_CompareValuesJson(l, r);
+      int actual = lKey.compare(rKey);
+      actual = (actual < 0 ? -1 : (actual > 0 ? 1 : 0));
+      BOOST_CHECK_MESSAGE(expected == actual, values[i] << " vs. " << values[j]);
+
+      // keys can be concatenated and inverted
+      std::string lDesc(lKey);
+      std::string rDesc(rKey);
+      for (auto& c : lDesc) { c = ~c; }
+      for (auto& c : rDesc) { c = ~c; }
+      int reversed = (lDesc + lKey).compare(rDesc + lKey);
+      reversed = (reversed < 0 ? -1 : (reversed > 0 ? 1 : 0));
+      BOOST_CHECK_MESSAGE(- expected == reversed, values[i] << " vs. " << values[j]);
+
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, l);
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, r);
+    }
+  }
+}
+
 // TODO: add tests for
   // TRI_CheckSameValueJson
   // TRI_BetweenArrayJson
@@ -812,6 +858,76 @@ BOOST_AUTO_TEST_CASE (tst_json_hashattributes_mult3) {
   FREE_JSON
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test binary encoding and decoding
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_binary_roundtrip) {
+  char const* values[] = {
+    "null",
+    "true",
+    "-13.5",
+    "\"\"",
+    "\"f\\u00f6\\u00f6 bar\"",
+    "[ ]",
+    "{ }",
+    "[ 1, null, false, \"abc\", [ 2, [ ] ], { \"a\": 1 } ]",
+    "{ \"a\": { \"b\": [ 1, 2, 3 ] }, \"\": \"empty\", \"c\": 1e300 }"
+  };
+
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+    TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, values[i]);
+    BOOST_REQUIRE(json != nullptr);
+
+    INIT_BUFFER
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, TRI_EncodeBinaryJson(sb, json));
+
+    char const* p = sb->_buffer;
+    char const* end = sb->_buffer + TRI_LengthStringBuffer(sb);
+    TRI_json_t* decoded = TRI_DecodeBinaryJson(TRI_UNKNOWN_MEM_ZONE, &p, end);
+
+    BOOST_REQUIRE(decoded != nullptr);
+    BOOST_CHECK(p == end);
+    BOOST_CHECK(TRI_CheckSameValueJson(json, decoded));
+
+    // all truncated inputs must be rejected
+    for (char const* e = sb->_buffer; e < end; ++e) {
+      p = sb->_buffer;
+      BOOST_CHECK(TRI_DecodeBinaryJson(TRI_UNKNOWN_MEM_ZONE, &p, e) == nullptr);
+    }
+
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, decoded);
+    FREE_BUFFER
+    FREE_JSON
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test varint encoding and decoding
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_binary_varint) {
+  uint64_t values[] = { 0, 1, 127, 128, 16383, 16384, 0xffffffffULL, 0xffffffffffffffffULL };
+
+  INIT_BUFFER
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, TRI_AppendVarUInt64Binary(sb, values[i]));
+  }
+  BOOST_CHECK_EQUAL(1 + 1 + 1 + 2 + 2 + 3 + 5 + 10, (int) TRI_LengthStringBuffer(sb));
+
+  char const* p = sb->_buffer;
+  char const* end = sb->_buffer + TRI_LengthStringBuffer(sb);
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+    uint64_t value;
+    BOOST_CHECK(TRI_ReadVarUInt64Binary(&p, end, &value));
+    BOOST_CHECK_EQUAL(values[i], value);
+  }
+
+  uint64_t value;
+  BOOST_CHECK(! TRI_ReadVarUInt64Binary(&p, end, &value));
+  FREE_BUFFER
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief generate tests
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for read-write locks
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2014 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2014, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+#include "Basics/locks.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CLocksSetup {
+  CLocksSetup () {
+    BOOST_TEST_MESSAGE("setup locks");
+    TRI_InitReadWriteLock(&lock);
+  }
+
+  ~CLocksSetup () {
+    TRI_DestroyReadWriteLock(&lock);
+    BOOST_TEST_MESSAGE("tear-down locks");
+  }
+
+  TRI_read_write_lock_t lock;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CLocksTest, CLocksSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timed locks on a free lock
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_timed_free) {
+  BOOST_CHECK_EQUAL(true, TRI_TimedWriteLockReadWriteLock(&lock, 1000));
+  TRI_WriteUnlockReadWriteLock(&lock);
+
+  BOOST_CHECK_EQUAL(true, TRI_TimedReadLockReadWriteLock(&lock, 1000));
+  BOOST_CHECK_EQUAL(true, TRI_TimedReadLockReadWriteLock(&lock, 1000));
+  TRI_ReadUnlockReadWriteLock(&lock);
+  TRI_ReadUnlockReadWriteLock(&lock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timed locks time out while another thread holds the lock
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_timed_timeout) {
+  TRI_WriteLockReadWriteLock(&lock);
+
+  bool gotRead = true;
+  bool gotWrite = true;
+
+  std::thread other([&] () {
+    gotRead = TRI_TimedReadLockReadWriteLock(&lock, 20 * 1000);
+    gotWrite = TRI_TimedWriteLockReadWriteLock(&lock, 20 * 1000);
+  });
+  other.join();
+
+  BOOST_CHECK_EQUAL(false, gotRead);
+  BOOST_CHECK_EQUAL(false, gotWrite);
+
+  TRI_WriteUnlockReadWriteLock(&lock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a waiting thread gets the lock once it is released
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_timed_release) {
+  TRI_ReadLockReadWriteLock(&lock);
+
+  bool gotWrite = false;
+
+  std::thread other([&] () {
+    gotWrite = TRI_TimedWriteLockReadWriteLock(&lock, 10 * 1000 * 1000);
+
+    if (gotWrite) {
+      TRI_WriteUnlockReadWriteLock(&lock);
+    }
+  });
+
+  usleep(50 * 1000);
+  TRI_ReadUnlockReadWriteLock(&lock);
+  other.join();
+
+  BOOST_CHECK_EQUAL(true, gotWrite);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for arena memory zones
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2014 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2014, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/Common.h"
+#include "Basics/tri-strings.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CArenaSetup {
+  CArenaSetup () {
+    BOOST_TEST_MESSAGE("setup arena");
+    zone = TRI_CreateArenaMemoryZone(1024);
+  }
+
+  ~CArenaSetup () {
+    TRI_FreeArenaMemoryZone(zone);
+    BOOST_TEST_MESSAGE("tear-down arena");
+  }
+
+  TRI_memory_zone_t* zone;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CArenaTest, CArenaSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief small allocations are aligned and do not overlap
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_arena_small) {
+  std::vector<char*> ptrs;
+
+  for (size_t i = 0; i < 1000; ++i) {
+    char* p = static_cast<char*>(TRI_Allocate(zone, (i % 37) + 1, false));
+    BOOST_CHECK(p != nullptr);
+    BOOST_CHECK_EQUAL(0, (int) ((uintptr_t) p % sizeof(uint64_t)));
+    memset(p, (int) (i % 256), (i % 37) + 1);
+    ptrs.emplace_back(p);
+  }
+
+  for (size_t i = 0; i < ptrs.size(); ++i) {
+    for (size_t j = 0; j < (i % 37) + 1; ++j) {
+      BOOST_CHECK_EQUAL((int) (i % 256), (int) (unsigned char) ptrs[i][j]);
+    }
+    TRI_Free(zone, ptrs[i]);
+  }
+
+  BOOST_CHECK(TRI_SizeArenaMemoryZone(zone) > 1024);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief zeroed and big allocations
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_arena_big) {
+  char* small = static_cast<char*>(TRI_Allocate(zone, 16, false));
+  char* big = static_cast<char*>(TRI_Allocate(zone, 100000, true));
+
+  BOOST_CHECK(big != nullptr);
+
+  for (size_t i = 0; i < 100000; ++i) {
+    BOOST_CHECK_EQUAL(0, big[i]);
+  }
+
+  // the head chunk is still used after a big allocation
+  char* next = static_cast<char*>(TRI_Allocate(zone, 16, false));
+  BOOST_CHECK_EQUAL(small + 16 + sizeof(uint64_t), next);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reallocation keeps the contents
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_arena_reallocate) {
+  char* p = TRI_DuplicateStringZ(zone, "the fox");
+  char* q = static_cast<char*>(TRI_Reallocate(zone, p, 64));
+
+  // last allocation is grown in place
+  BOOST_CHECK_EQUAL(p, q);
+  BOOST_CHECK_EQUAL(std::string("the fox"), std::string(q));
+
+  char* other = static_cast<char*>(TRI_Allocate(zone, 8, false));
+  BOOST_CHECK(other != nullptr);
+
+  char* r = static_cast<char*>(TRI_Reallocate(zone, q, 5000));
+  BOOST_CHECK(r != q);
+  BOOST_CHECK_EQUAL(std::string("the fox"), std::string(r));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief statistics
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_arena_statistics) {
+  uint64_t current, peak, largest;
+
+  TRI_Allocate(zone, 50000, false);
+  TRI_GetArenaMemoryStatistics(&current, &peak, &largest);
+
+  BOOST_CHECK(current >= TRI_SizeArenaMemoryZone(zone));
+  BOOST_CHECK(peak >= current);
+  BOOST_CHECK(largest >= TRI_SizeArenaMemoryZone(zone));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,313 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for shaping json texts
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/json.h"
+#include "ShapedJson/json-shaper.h"
+#include "ShapedJson/shaped-json.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief in-memory shaper
+////////////////////////////////////////////////////////////////////////////////
+
+struct TestShaper {
+  TRI_shaper_t _base;
+  std::vector<std::string> _attributes;
+  std::vector<TRI_shape_t*> _shapes;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+static TRI_shape_aid_t FindOrCreateAttributeByName (TRI_shaper_t* shaper,
+                                                    char const* name) {
+  auto s = reinterpret_cast<TestShaper*>(shaper);
+
+  for (size_t i = 0; i < s->_attributes.size(); ++i) {
+    if (s->_attributes[i] == name) {
+      return (TRI_shape_aid_t) (i + 1);
+    }
+  }
+
+  s->_attributes.emplace_back(name);
+  return (TRI_shape_aid_t) s->_attributes.size();
+}
+
+static char const* LookupAttributeId (TRI_shaper_t* shaper,
+                                      TRI_shape_aid_t aid) {
+  auto s = reinterpret_cast<TestShaper*>(shaper);
+
+  if (aid == 0 || aid > s->_attributes.size()) {
+    return nullptr;
+  }
+
+  return s->_attributes[aid - 1].c_str();
+}
+
+static TRI_shape_t const* FindShape (TRI_shaper_t* shaper,
+                                     TRI_shape_t* shape,
+                                     bool create) {
+  auto s = reinterpret_cast<TestShaper*>(shaper);
+  TRI_shape_t const* found = TRI_LookupBasicShapeShaper(shape);
+
+  if (found == nullptr) {
+    for (auto other : s->_shapes) {
+      if (other->_size == shape->_size &&
+          memcmp(&other->_type, &shape->_type, shape->_size - sizeof(TRI_shape_sid_t)) == 0) {
+        found = other;
+        break;
+      }
+    }
+  }
+
+  if (found != nullptr) {
+    TRI_Free(shaper->_memoryZone, shape);
+    return found;
+  }
+
+  if (! create) {
+    return nullptr;
+  }
+
+  shape->_sid = 1000 + s->_shapes.size();
+  s->_shapes.push_back(shape);
+
+  return shape;
+}
+
+static TRI_shape_t const* LookupShapeId (TRI_shaper_t* shaper,
+                                         TRI_shape_sid_t sid) {
+  auto s = reinterpret_cast<TestShaper*>(shaper);
+  TRI_shape_t const* shape = TRI_LookupSidBasicShapeShaper(sid);
+
+  if (shape == nullptr && sid >= 1000 && sid - 1000 < s->_shapes.size()) {
+    shape = s->_shapes[sid - 1000];
+  }
+
+  return shape;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shapes a text directly and via a json object, and checks that both
+/// give the same result
+////////////////////////////////////////////////////////////////////////////////
+
+static void CheckSame (TRI_shaper_t* shaper,
+                       char const* text) {
+  TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, text);
+  BOOST_REQUIRE(json != nullptr);
+
+  TRI_shaped_json_t* expected = TRI_ShapedJsonJson(shaper, json, true);
+  TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+  BOOST_REQUIRE(expected != nullptr);
+
+  TRI_shaped_json_t* shaped;
+  int res = TRI_ShapedJsonString(shaper, text, strlen(text), true, &shaped, nullptr);
+  BOOST_REQUIRE_EQUAL(TRI_ERROR_NO_ERROR, res);
+
+  BOOST_CHECK_EQUAL(expected->_sid, shaped->_sid);
+  BOOST_REQUIRE_EQUAL(expected->_data.length, shaped->_data.length);
+  BOOST_CHECK(memcmp(expected->_data.data, shaped->_data.data, shaped->_data.length) == 0);
+
+  TRI_FreeShapedJson(shaper->_memoryZone, expected);
+  TRI_FreeShapedJson(shaper->_memoryZone, shaped);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shapes a text directly and returns the error
+////////////////////////////////////////////////////////////////////////////////
+
+static int ShapeError (TRI_shaper_t* shaper,
+                       char const* text) {
+  TRI_shaped_json_t* shaped;
+  int res = TRI_ShapedJsonString(shaper, text, strlen(text), true, &shaped, nullptr);
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    TRI_FreeShapedJson(shaper->_memoryZone, shaped);
+  }
+  else {
+    BOOST_CHECK(shaped == nullptr);
+  }
+
+  return res;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CShapedJsonSetup {
+  CShapedJsonSetup () {
+    BOOST_TEST_MESSAGE("setup shaped json");
+
+    TRI_InitShaper(&_shaper._base, TRI_UNKNOWN_MEM_ZONE);
+    _shaper._base.findOrCreateAttributeByName = FindOrCreateAttributeByName;
+    _shaper._base.lookupAttributeId = LookupAttributeId;
+    _shaper._base.findShape = FindShape;
+    _shaper._base.lookupShapeId = LookupShapeId;
+  }
+
+  ~CShapedJsonSetup () {
+    BOOST_TEST_MESSAGE("tear-down shaped json");
+
+    for (auto shape : _shaper._shapes) {
+      TRI_Free(TRI_UNKNOWN_MEM_ZONE, shape);
+    }
+    TRI_DestroyShaper(&_shaper._base);
+  }
+
+  TestShaper _shaper;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CShapedJsonTest, CShapedJsonSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test atoms
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_shaped_string_atoms) {
+  TRI_shaper_t* shaper = &_shaper._base;
+
+  CheckSame(shaper, "null");
+  CheckSame(shaper, " true ");
+  CheckSame(shaper, "false");
+  CheckSame(shaper, "-1.5e2");
+  CheckSame(shaper, "\"\"");
+  CheckSame(shaper, "\"foo\"");
+  CheckSame(shaper, "\"0123456789abcdef\\u00e40123456789abcdef\"");
+  CheckSame(shaper, "\"0123456789abcdef\xc3\xa4" "0123456789abcdef\\\"\"");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test lists and objects
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_shaped_string_structures) {
+  TRI_shaper_t* shaper = &_shaper._base;
+
+  CheckSame(shaper, "[]");
+  CheckSame(shaper, "{}");
+  CheckSame(shaper, "[1,2,3]");
+  CheckSame(shaper, "[\"a\",\"bb\",\"0123456789abcdef0123456789abcdef\"]");
+  CheckSame(shaper, "[[1],[2,3]]");
+  CheckSame(shaper, "[1,\"a\",null,[true],{\"a\":1}]");
+  CheckSame(shaper, "{\"b\":1,\"a\":\"x\",\"c\":[1,{\"d\":null}],\"\":2}");
+  CheckSame(shaper, "{\"\\u00e4\":true,\"long\":\"0123456789abcdef0123456789abcdef\"}");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the reserved attributes
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_shaped_string_reserved) {
+  TRI_shaper_t* shaper = &_shaper._base;
+
+  CheckSame(shaper, "{\"_key\":\"test\",\"_rev\":\"1\",\"_id\":\"c/test\",\"value\":1}");
+  CheckSame(shaper, "{\"_from\":[1,{\"a\":2}],\"_to\":{\"b\":3},\"sub\":{\"_key\":\"x\"}}");
+  CheckSame(shaper, "{\"_key\":\"test\"}");
+
+  // the values of stripped attributes are not shaped
+  size_t const numShapes = _shaper._shapes.size();
+  size_t const numAttributes = _shaper._attributes.size();
+
+  TRI_shaped_json_t* shaped;
+  TRI_shaped_json_info_t info;
+  TRI_InitShapedJsonInfo(&info);
+
+  char const* text = "{\"_key\":\"a\\u00e4\",\"_rev\":{\"unseen\":[1,2]},\"_key\":1}";
+  int res = TRI_ShapedJsonString(shaper, text, strlen(text), true, &shaped, &info);
+
+  BOOST_REQUIRE_EQUAL(TRI_ERROR_NO_ERROR, res);
+  BOOST_CHECK(info._isObject);
+  BOOST_CHECK(info._hasKey);
+  BOOST_REQUIRE(info._key != nullptr);
+  BOOST_CHECK_EQUAL(std::string("a\xc3\xa4"), info._key);
+  BOOST_CHECK_EQUAL(numShapes, _shaper._shapes.size());
+  BOOST_CHECK_EQUAL(numAttributes, _shaper._attributes.size());
+
+  TRI_FreeShapedJson(shaper->_memoryZone, shaped);
+  TRI_DestroyShapedJsonInfo(&info);
+
+  // a key that is not a string
+  TRI_InitShapedJsonInfo(&info);
+  text = "{\"_key\":1}";
+  res = TRI_ShapedJsonString(shaper, text, strlen(text), true, &shaped, &info);
+
+  BOOST_REQUIRE_EQUAL(TRI_ERROR_NO_ERROR, res);
+  BOOST_CHECK(info._hasKey);
+  BOOST_CHECK(info._key == nullptr);
+
+  TRI_FreeShapedJson(shaper->_memoryZone, shaped);
+  TRI_DestroyShapedJsonInfo(&info);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test invalid texts
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_shaped_string_errors) {
+  TRI_shaper_t* shaper = &_shaper._base;
+
+  BOOST_CHECK_EQUAL(TRI_ERROR_HTTP_CORRUPTED_JSON, ShapeError(shaper, ""));
+  BOOST_CHECK_EQUAL(TRI_ERROR_HTTP_CORRUPTED_JSON, ShapeError(shaper, "[1,"));
+  BOOST_CHECK_EQUAL(TRI_ERROR_HTTP_CORRUPTED_JSON, ShapeError(shaper, "[1,]"));
+  BOOST_CHECK_EQUAL(TRI_ERROR_HTTP_CORRUPTED_JSON, ShapeError(shaper, "{\"a\":1"));
+  BOOST_CHECK_EQUAL(TRI_ERROR_HTTP_CORRUPTED_JSON, ShapeError(shaper, "{\"a\",1}"));
+  BOOST_CHECK_EQUAL(TRI_ERROR_HTTP_CORRUPTED_JSON, ShapeError(shaper, "{\"_rev\":[1,}"));
+  BOOST_CHECK_EQUAL(TRI_ERROR_HTTP_CORRUPTED_JSON, ShapeError(shaper, "{\"a\":[{\"b\":1e400}]}"));
+  BOOST_CHECK_EQUAL(TRI_ERROR_HTTP_CORRUPTED_JSON, ShapeError(shaper, "{} {}"));
+
+  // attributes cannot be created
+  _shaper._base.findOrCreateAttributeByName = [] (TRI_shaper_t*, char const*) -> TRI_shape_aid_t {
+    return 0;
+  };
+  BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_SHAPER_FAILED, ShapeError(shaper, "[1,{\"a\":1}]"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
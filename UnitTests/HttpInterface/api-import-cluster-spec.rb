@@ -0,0 +1,134 @@
+# coding: utf-8
+
+require 'rspec'
+require 'arangodb.rb'
+
+describe ArangoDB do
+  api = "/_api/import"
+  prefix = "api-import-cluster"
+
+  context "importing documents into a sharded collection:" do
+
+    before do
+      @cn = "UnitTestsImport"
+      ArangoDB.drop_collection(@cn)
+      body = "{ \"name\" : \"#{@cn}\", \"numberOfShards\" : 4 }"
+      doc = ArangoDB.post("/_api/collection", :body => body)
+      doc.code.should eq(200)
+    end
+
+    after do
+      ArangoDB.drop_collection(@cn)
+    end
+
+################################################################################
+## all documents are imported
+################################################################################
+
+    it "imports documents into all shards" do
+      cmd = api + "?collection=#{@cn}&type=list"
+      body = "[ " + (0...100).map { |i| "{ \"_key\" : \"test#{i}\", \"value\" : #{i} }" }.join(", ") + " ]"
+      doc = ArangoDB.log_post("#{prefix}-all", cmd, :body => body)
+
+      doc.code.should eq(201)
+      doc.parsed_response['error'].should eq(false)
+      doc.parsed_response['created'].should eq(100)
+      doc.parsed_response['errors'].should eq(0)
+      doc.parsed_response['updated'].should eq(0)
+      doc.parsed_response['ignored'].should eq(0)
+
+      ArangoDB.size_collection(@cn).should eq(100)
+    end
+
+################################################################################
+## some documents fail
+################################################################################
+
+    it "reports failed documents at their positions" do
+      cmd = api + "?collection=#{@cn}&type=list&details=true"
+      body =  "[ { \"_key\" : \"test1\" }, { \"_key\" : \"test2\" }, 1, { \"_key\" : \"test1\" }, "
+      body += "{ \"_key\" : \"test3\" }, { \"_key\" : \"test2\" } ]"
+      doc = ArangoDB.log_post("#{prefix}-mixed", cmd, :body => body)
+
+      doc.code.should eq(201)
+      doc.parsed_response['error'].should eq(false)
+      doc.parsed_response['created'].should eq(3)
+      doc.parsed_response['errors'].should eq(3)
+      doc.parsed_response['updated'].should eq(0)
+      doc.parsed_response['ignored'].should eq(0)
+
+      details = doc.parsed_response['details']
+      details.length.should eq(3)
+      details[0].should match(/^at position 3: /)
+      details[1].should match(/^at position 4: .*unique constraint violated/)
+      details[2].should match(/^at position 6: .*unique constraint violated/)
+
+      ArangoDB.size_collection(@cn).should eq(3)
+    end
+
+    it "counts updated and ignored documents of all shards" do
+      cmd = api + "?collection=#{@cn}&type=list"
+      body = "[ " + (0...20).map { |i| "{ \"_key\" : \"test#{i}\", \"value\" : #{i} }" }.join(", ") + " ]"
+      doc = ArangoDB.log_post("#{prefix}-duplicate-setup", cmd, :body => body)
+      doc.code.should eq(201)
+
+      cmd = api + "?collection=#{@cn}&type=list&onDuplicate=update"
+      body = "[ " + (10...30).map { |i| "{ \"_key\" : \"test#{i}\", \"other\" : #{i} }" }.join(", ") + " ]"
+      doc = ArangoDB.log_post("#{prefix}-duplicate-update", cmd, :body => body)
+
+      doc.code.should eq(201)
+      doc.parsed_response['created'].should eq(10)
+      doc.parsed_response['updated'].should eq(10)
+      doc.parsed_response['errors'].should eq(0)
+
+      cmd = api + "?collection=#{@cn}&type=list&onDuplicate=ignore"
+      body = "[ " + (25...35).map { |i| "{ \"_key\" : \"test#{i}\" }" }.join(", ") + " ]"
+      doc = ArangoDB.log_post("#{prefix}-duplicate-ignore", cmd, :body => body)
+
+      doc.code.should eq(201)
+      doc.parsed_response['created'].should eq(5)
+      doc.parsed_response['ignored'].should eq(5)
+      doc.parsed_response['errors'].should eq(0)
+
+      ArangoDB.size_collection(@cn).should eq(35)
+    end
+
+################################################################################
+## a shard rejects its documents
+################################################################################
+
+    it "reports documents of other shards when a shard rejects its documents" do
+      cmd = api + "?collection=#{@cn}&type=list&complete=true&details=true"
+      body  = "[ " + (0...40).map { |i| "{ \"_key\" : \"test#{i}\" }" }.join(", ")
+      body += ", { \"_key\" : \"test0\" } ]"
+      doc = ArangoDB.log_post("#{prefix}-complete-partial", cmd, :body => body)
+
+      # the shard of test0 stores none of its documents, the others store theirs
+      doc.code.should eq(201)
+      doc.parsed_response['error'].should eq(false)
+
+      created = doc.parsed_response['created']
+      errors = doc.parsed_response['errors']
+      created.should be > 0
+      errors.should be > 1
+      (created + errors).should eq(41)
+      doc.parsed_response['details'].length.should eq(errors)
+      doc.parsed_response['details'][0].should match(/^at position 1: .*unique constraint violated/)
+
+      ArangoDB.size_collection(@cn).should eq(created)
+    end
+
+    it "returns an error if no shard stores its documents" do
+      cmd = api + "?collection=#{@cn}&type=list&complete=true"
+      body = "[ { \"_key\" : \"test0\" }, { \"_key\" : \"test0\" } ]"
+      doc = ArangoDB.log_post("#{prefix}-complete-none", cmd, :body => body)
+
+      doc.code.should eq(409)
+      doc.parsed_response['error'].should eq(true)
+      doc.parsed_response['errorNum'].should eq(1210)
+
+      ArangoDB.size_collection(@cn).should eq(0)
+    end
+
+  end
+end
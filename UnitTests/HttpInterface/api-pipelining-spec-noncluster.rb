@@ -98,6 +98,74 @@ describe ArangoDB, :ssl => true do
       
     end
 
+################################################################################
+## checking out-of-order completion
+################################################################################
+
+    context "with handlers finishing out of order:" do
+
+      it "returns the responses in request order" do
+        n = 7
+
+        # the first request takes longest, the others finish before it
+        requests = "GET /_admin/sleep?duration=1 HTTP/1.1\r\n\r\n"
+        (0...n).each do |i|
+          requests << "GET /_admin/echo?seq=#{i} HTTP/1.1\r\n\r\n"
+        end
+
+        @socket.send requests, 0
+
+        response = read_socket @socket
+        response.scan(/HTTP\/1\.1 200/).length.should eq(n + 1)
+
+        sleep = response.index("\"duration\":1")
+        sleep.should_not eq(nil)
+
+        last = sleep
+        (0...n).each do |i|
+          pos = response.index("\"seq\":\"#{i}\"")
+          pos.should_not eq(nil)
+          pos.should be > last
+          last = pos
+        end
+      end
+
+      it "does not hold back responses after failing requests" do
+        n = 8
+
+        requests = ""
+        (0...n).each do |i|
+          if i % 2 == 0
+            requests << "GET /_api/document/UnitTestsNonExisting/#{i} HTTP/1.1\r\n\r\n"
+          else
+            requests << "GET /_admin/echo?seq=#{i} HTTP/1.1\r\n\r\n"
+          end
+        end
+
+        @socket.send requests, 0
+
+        response = read_socket @socket
+        response.scan(/HTTP\/1\.1 404/).length.should eq(n / 2)
+        response.scan(/HTTP\/1\.1 200/).length.should eq(n / 2)
+
+        statuses = response.scan(/HTTP\/1\.1 (\d+)/).map { |m| m[0] }
+        statuses.should eq(["404", "200"] * (n / 2))
+      end
+
+      it "answers a request following a slow one with a write" do
+        requests = "GET /_admin/sleep?duration=0.5 HTTP/1.1\r\n\r\n"
+        requests << "DELETE /_api/document/UnitTestsNonExisting/foo HTTP/1.1\r\n\r\n"
+        requests << "GET /_api/version HTTP/1.1\r\n\r\n"
+
+        @socket.send requests, 0
+
+        response = read_socket @socket
+        statuses = response.scan(/HTTP\/1\.1 (\d+)/).map { |m| m[0] }
+        statuses.should eq(["200", "404", "200"])
+      end
+
+    end
+
 ################################################################################
 ## checking indirect handlers
 ################################################################################
@@ -133,6 +201,45 @@ describe ArangoDB, :ssl => true do
         response.scan(/HTTP\/1\.1 201/).length.should eq(n)
       end
       
+      it "checks large responses read slowly by the client" do
+        # bodies of 4 KB and more are sent with gather writes. the client
+        # does not read at first, so the server has to continue several
+        # queued responses after partial writes
+        value = "x" * 200000
+        doc = ArangoDB.post("/_api/document?collection=#{@cn}", :body => "{ \"_key\" : \"large\", \"value\" : \"#{value}\" }")
+        doc.code.should eq(201)
+
+        n = 20
+
+        requests = ""
+        (0...n).each do |i|
+          requests << "GET /_api/document/#{@cn}/large HTTP/1.1\r\n\r\n"
+        end
+
+        @socket.send requests, 0
+        sleep 1
+
+        response = read_socket @socket
+
+        (0...n).each do |i|
+          header_end = response.index("\r\n\r\n")
+          header_end.should_not eq(nil)
+
+          header = response[0...header_end]
+          header.should match(/\AHTTP\/1\.1 200/)
+
+          length = header[/content-length: *(\d+)/i, 1].to_i
+          body = response[header_end + 4, length]
+          body.length.should eq(length)
+
+          JSON.parse(body)["value"].should eq(value)
+
+          response = response[header_end + 4 + length..-1]
+        end
+
+        response.should eq("")
+      end
+
       it "checks post and get requests" do
         n = 500
 
@@ -27,16 +27,153 @@
 
 #include "Aql/AqlItemBlock.h"
 #include "Aql/ExecutionNode.h"
+#include "Basics/json-utilities.h"
+#include "ShapedJson/Legends.h"
 
 using namespace triagens::aql;
 
 using Json = triagens::basics::Json;
 using JsonHelper = triagens::basics::JsonHelper;
+using StringBuffer = triagens::basics::StringBuffer;
+using JsonLegend = triagens::basics::JsonLegend;
+using LegendReader = triagens::basics::LegendReader;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  private defines
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief entry types of the binary representation
+////////////////////////////////////////////////////////////////////////////////
+
+#define BINARY_ENTRY_EMPTY      0
+#define BINARY_ENTRY_EMPTY_RUN  1
+#define BINARY_ENTRY_RANGE      2
+#define BINARY_ENTRY_VALUE      3
+#define BINARY_ENTRY_REFERENCE  4
+#define BINARY_ENTRY_SHAPED     5
+#define BINARY_ENTRY_SHAPED_EDGE 6
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief throws if a buffer operation failed
+////////////////////////////////////////////////////////////////////////////////
+
+static inline void CheckBufferResult (int res) {
+  if (res != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION(res);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief throws because of a malformed binary block
+////////////////////////////////////////////////////////////////////////////////
+
+static void ThrowMalformedBinary () {
+  THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "malformed binary AqlItemBlock");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a string with its length to the buffer
+////////////////////////////////////////////////////////////////////////////////
+
+static void AppendBinaryString (TRI_string_buffer_t* out,
+                                char const* value,
+                                size_t length) {
+  CheckBufferResult(TRI_AppendVarUInt64Binary(out, static_cast<uint64_t>(length)));
+  CheckBufferResult(TRI_AppendString2StringBuffer(out, value, length));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a string written by AppendBinaryString, the result points
+/// into the input
+////////////////////////////////////////////////////////////////////////////////
+
+static char const* ReadBinaryString (char const** position,
+                                     char const* end,
+                                     size_t* length) {
+  uint64_t n;
+
+  if (! TRI_ReadVarUInt64Binary(position, end, &n) ||
+      n > static_cast<uint64_t>(end - *position)) {
+    ThrowMalformedBinary();
+  }
+
+  char const* value = *position;
+  *position += n;
+  *length = static_cast<size_t>(n);
+
+  return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks that the tables of a legend only refer to its own memory
+///
+/// the legend must be aligned to 8 bytes. see JsonLegend::dump for its layout
+////////////////////////////////////////////////////////////////////////////////
+
+static bool CheckLegend (char const* legend,
+                         size_t size) {
+  using triagens::basics::AttributeId;
+  using triagens::basics::Shape;
+
+  if (size % 8 != 0 || size < 2 * sizeof(TRI_shape_size_t)) {
+    return false;
+  }
+
+  size_t offset = 0;
+  TRI_shape_size_t numberAttributes = *reinterpret_cast<TRI_shape_size_t const*>(legend);
+  offset += sizeof(TRI_shape_size_t);
+
+  if (numberAttributes > (size - offset - sizeof(TRI_shape_size_t)) / sizeof(AttributeId)) {
+    return false;
+  }
+
+  AttributeId const* aids = reinterpret_cast<AttributeId const*>(legend + offset);
+  offset += static_cast<size_t>(numberAttributes) * sizeof(AttributeId);
+
+  TRI_shape_size_t numberShapes = *reinterpret_cast<TRI_shape_size_t const*>(legend + offset);
+  offset += sizeof(TRI_shape_size_t);
+
+  if (numberShapes > (size - offset) / sizeof(Shape)) {
+    return false;
+  }
+
+  Shape const* shapes = reinterpret_cast<Shape const*>(legend + offset);
+
+  for (TRI_shape_size_t i = 0; i < numberAttributes; ++i) {
+    // attribute names must be null-terminated inside the legend
+    if (aids[i].offset >= size ||
+        memchr(legend + aids[i].offset, '\0', static_cast<size_t>(size - aids[i].offset)) == nullptr) {
+      return false;
+    }
+  }
+
+  for (TRI_shape_size_t i = 0; i < numberShapes; ++i) {
+    if (shapes[i].offset % 8 != 0 ||
+        shapes[i].offset > size ||
+        shapes[i].size < sizeof(TRI_shape_t) ||
+        shapes[i].size > size - shapes[i].offset) {
+      return false;
+    }
+  }
+
+  return true;
+}
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      AqlItemBlock
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief content type used for blocks in binary representation
+////////////////////////////////////////////////////////////////////////////////
+
+std::string const AqlItemBlock::BinaryContentType = "application/x-arango-aql-block";
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                        constructors / destructors
 // -----------------------------------------------------------------------------
@@ -207,6 +344,22 @@ void AqlItemBlock::destroy () {
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimates the memory used by the block, in bytes
+////////////////////////////////////////////////////////////////////////////////
+
+size_t AqlItemBlock::memoryUsage () const {
+  size_t result = sizeof(AqlItemBlock) +
+                  _data.capacity() * sizeof(AqlValue) +
+                  _docColls.capacity() * sizeof(TRI_document_collection_t const*);
+
+  for (auto const& it : _valueCount) {
+    result += it.first.memoryUsage();
+  }
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief shrink the block to the specified number of rows
 ////////////////////////////////////////////////////////////////////////////////
@@ -561,6 +714,361 @@ Json AqlItemBlock::toJson (triagens::arango::AqlTransaction* trx) const {
   return json;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief toBinary, append a whole AqlItemBlock to the buffer in a compact
+/// binary representation
+///
+/// the block starts with its size and the legends of all collections that
+/// documents in it come from, followed by the entries column by column
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlItemBlock::toBinary (triagens::arango::AqlTransaction* trx,
+                             StringBuffer& buffer) const {
+  TRI_string_buffer_t* out = buffer.stringBuffer();
+
+  CheckBufferResult(TRI_AppendVarUInt64Binary(out, static_cast<uint64_t>(_nrItems)));
+  CheckBufferResult(TRI_AppendVarUInt64Binary(out, static_cast<uint64_t>(_nrRegs)));
+
+  // documents are sent as their raw shaped data. the shapes and attribute
+  // names they use are sent once per collection in a legend up front
+  std::unordered_map<TRI_document_collection_t const*, uint64_t> collections;
+  std::vector<TRI_document_collection_t const*> documents;
+  std::vector<std::unique_ptr<JsonLegend>> legends;
+
+  for (RegisterId column = 0; column < _nrRegs; column++) {
+    TRI_document_collection_t const* document = _docColls[column];
+
+    for (size_t i = 0; i < _nrItems; i++) {
+      AqlValue const& a(_data[i * _nrRegs + column]);
+
+      if (a._type != AqlValue::SHAPED) {
+        continue;
+      }
+
+      TRI_ASSERT(document != nullptr);
+
+      auto it = collections.find(document);
+
+      if (it == collections.end()) {
+        documents.emplace_back(document);
+        legends.emplace_back(new JsonLegend(document->getShaper()));
+        it = collections.emplace(document, static_cast<uint64_t>(documents.size() - 1)).first;
+      }
+
+      TRI_shaped_json_t shaped;
+      TRI_EXTRACT_SHAPED_JSON_MARKER(shaped, a._marker);
+      CheckBufferResult(legends[static_cast<size_t>(it->second)]->addShape(&shaped));
+    }
+  }
+
+  CheckBufferResult(TRI_AppendVarUInt64Binary(out, static_cast<uint64_t>(documents.size())));
+
+  for (size_t j = 0; j < documents.size(); j++) {
+    std::string const name(trx->resolver()->getCollectionName(documents[j]->_info._cid));
+    AppendBinaryString(out, name.c_str(), name.size());
+
+    size_t const size = legends[j]->getSize();
+    std::unique_ptr<uint64_t[]> legend(new uint64_t[size / sizeof(uint64_t)]);
+    legends[j]->dump(legend.get());
+    AppendBinaryString(out, reinterpret_cast<char const*>(legend.get()), size);
+  }
+
+  std::unordered_map<AqlValue, uint64_t> table;   // remember duplicates
+  uint64_t nrValues = 0;
+
+  size_t emptyCount = 0;  // here we count runs of empty AqlValues
+
+  auto commitEmpties = [&] () {  // this commits an empty run to the buffer
+    if (emptyCount > 0) {
+      if (emptyCount == 1) {
+        CheckBufferResult(TRI_AppendCharStringBuffer(out, BINARY_ENTRY_EMPTY));
+      }
+      else {
+        CheckBufferResult(TRI_AppendCharStringBuffer(out, BINARY_ENTRY_EMPTY_RUN));
+        CheckBufferResult(TRI_AppendVarUInt64Binary(out, static_cast<uint64_t>(emptyCount)));
+      }
+      emptyCount = 0;
+    }
+  };
+
+  for (RegisterId column = 0; column < _nrRegs; column++) {
+    for (size_t i = 0; i < _nrItems; i++) {
+      AqlValue const& a(_data[i * _nrRegs + column]);
+
+      if (a.isEmpty()) {
+        emptyCount++;
+        continue;
+      }
+
+      commitEmpties();
+
+      if (a._type == AqlValue::RANGE) {
+        // store the bounds zig-zag encoded, so that small negative values stay short
+        int64_t low = a._range->_low;
+        int64_t high = a._range->_high;
+
+        CheckBufferResult(TRI_AppendCharStringBuffer(out, BINARY_ENTRY_RANGE));
+        CheckBufferResult(TRI_AppendVarUInt64Binary(out, (static_cast<uint64_t>(low) << 1) ^ static_cast<uint64_t>(low >> 63)));
+        CheckBufferResult(TRI_AppendVarUInt64Binary(out, (static_cast<uint64_t>(high) << 1) ^ static_cast<uint64_t>(high >> 63)));
+        continue;
+      }
+
+      auto it = table.find(a);
+
+      if (it == table.end() && a._type == AqlValue::SHAPED) {
+        TRI_df_marker_t const* marker = a._marker;
+        bool const isEdge = TRI_IS_EDGE_MARKER(marker);
+        char const* key = TRI_EXTRACT_MARKER_KEY(marker);
+        TRI_shaped_json_t shaped;
+        TRI_EXTRACT_SHAPED_JSON_MARKER(shaped, marker);
+
+        CheckBufferResult(TRI_AppendCharStringBuffer(out, isEdge ? BINARY_ENTRY_SHAPED_EDGE : BINARY_ENTRY_SHAPED));
+        CheckBufferResult(TRI_AppendVarUInt64Binary(out, collections[_docColls[column]]));
+        CheckBufferResult(TRI_AppendVarUInt64Binary(out, static_cast<uint64_t>(TRI_EXTRACT_MARKER_RID(marker))));
+        AppendBinaryString(out, key, strlen(key));
+        CheckBufferResult(TRI_AppendVarUInt64Binary(out, static_cast<uint64_t>(shaped._sid)));
+        AppendBinaryString(out, shaped._data.data, shaped._data.length);
+
+        if (isEdge) {
+          // the collection names of _from and _to are resolved here, as in toJson
+          std::string from(trx->resolver()->getCollectionNameCluster(TRI_EXTRACT_MARKER_FROM_CID(marker)));
+          from.push_back('/');
+          from.append(TRI_EXTRACT_MARKER_FROM_KEY(marker));
+          AppendBinaryString(out, from.c_str(), from.size());
+
+          std::string to(trx->resolver()->getCollectionNameCluster(TRI_EXTRACT_MARKER_TO_CID(marker)));
+          to.push_back('/');
+          to.append(TRI_EXTRACT_MARKER_TO_KEY(marker));
+          AppendBinaryString(out, to.c_str(), to.size());
+        }
+
+        table.emplace(a, nrValues++);
+      }
+      else if (it == table.end()) {
+        Json json(a.toJson(trx, _docColls[column]));
+
+        CheckBufferResult(TRI_AppendCharStringBuffer(out, BINARY_ENTRY_VALUE));
+        CheckBufferResult(TRI_EncodeBinaryJson(out, json.json()));
+        table.emplace(a, nrValues++);
+      }
+      else {
+        CheckBufferResult(TRI_AppendCharStringBuffer(out, BINARY_ENTRY_REFERENCE));
+        CheckBufferResult(TRI_AppendVarUInt64Binary(out, it->second));
+      }
+    }
+  }
+
+  commitEmpties();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fromBinary, recreate an AqlItemBlock from its binary representation
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* AqlItemBlock::fromBinary (char const** position,
+                                        char const* end) {
+  char const* p = *position;
+  uint64_t nrItems;
+  uint64_t nrRegs;
+
+  if (! TRI_ReadVarUInt64Binary(&p, end, &nrItems) ||
+      ! TRI_ReadVarUInt64Binary(&p, end, &nrRegs) ||
+      nrItems == 0 ||
+      nrRegs > ExecutionNode::MaxRegisterId) {
+    ThrowMalformedBinary();
+  }
+
+  // read the collection names and legends of the shaped documents
+  uint64_t nrCollections;
+
+  if (! TRI_ReadVarUInt64Binary(&p, end, &nrCollections) ||
+      nrCollections > static_cast<uint64_t>(end - p)) {
+    ThrowMalformedBinary();
+  }
+
+  std::vector<std::string> names;
+  std::vector<std::unique_ptr<uint64_t[]>> legendData;
+  std::vector<std::unique_ptr<LegendReader>> readers;
+
+  for (uint64_t j = 0; j < nrCollections; j++) {
+    size_t length;
+    char const* name = ReadBinaryString(&p, end, &length);
+    names.emplace_back(name, length);
+
+    // the legend is copied, because it must be aligned
+    char const* legend = ReadBinaryString(&p, end, &length);
+    std::unique_ptr<uint64_t[]> data(new uint64_t[length / sizeof(uint64_t) + 1]);
+    memcpy(data.get(), legend, length);
+
+    if (! CheckLegend(reinterpret_cast<char const*>(data.get()), length)) {
+      ThrowMalformedBinary();
+    }
+
+    readers.emplace_back(new LegendReader(reinterpret_cast<char const*>(data.get())));
+    legendData.emplace_back(std::move(data));
+  }
+
+  std::unique_ptr<AqlItemBlock> block(new AqlItemBlock(static_cast<size_t>(nrItems),
+                                                       static_cast<RegisterId>(nrRegs)));
+  std::vector<uint64_t> scratch;  // aligned copy of shaped data
+
+  std::vector<AqlValue> values;   // values made here, for references
+  uint64_t emptyRun = 0;
+
+  for (RegisterId column = 0; column < nrRegs; column++) {
+    for (size_t i = 0; i < nrItems; i++) {
+      if (emptyRun > 0) {
+        emptyRun--;
+        continue;
+      }
+
+      if (p >= end) {
+        ThrowMalformedBinary();
+      }
+
+      char type = *p++;
+
+      if (type == BINARY_ENTRY_EMPTY) {
+        // empty, do nothing here
+      }
+      else if (type == BINARY_ENTRY_EMPTY_RUN) {
+        if (! TRI_ReadVarUInt64Binary(&p, end, &emptyRun) || emptyRun == 0) {
+          ThrowMalformedBinary();
+        }
+        emptyRun--;
+      }
+      else if (type == BINARY_ENTRY_RANGE) {
+        uint64_t low;
+        uint64_t high;
+
+        if (! TRI_ReadVarUInt64Binary(&p, end, &low) ||
+            ! TRI_ReadVarUInt64Binary(&p, end, &high)) {
+          ThrowMalformedBinary();
+        }
+
+        AqlValue a(static_cast<int64_t>((low >> 1) ^ (~(low & 1) + 1)),
+                   static_cast<int64_t>((high >> 1) ^ (~(high & 1) + 1)));
+        try {
+          block->setValue(i, column, a);
+        }
+        catch (...) {
+          a.destroy();
+          throw;
+        }
+      }
+      else if (type == BINARY_ENTRY_VALUE) {
+        TRI_json_t* json = TRI_DecodeBinaryJson(TRI_UNKNOWN_MEM_ZONE, &p, end);
+
+        if (json == nullptr) {
+          ThrowMalformedBinary();
+        }
+
+        AqlValue a(new Json(TRI_UNKNOWN_MEM_ZONE, json));
+        try {
+          block->setValue(i, column, a);
+        }
+        catch (...) {
+          a.destroy();
+          throw;
+        }
+        values.emplace_back(a);
+      }
+      else if (type == BINARY_ENTRY_SHAPED || type == BINARY_ENTRY_SHAPED_EDGE) {
+        uint64_t n;
+        uint64_t rid;
+        uint64_t sid;
+        size_t keyLength;
+        size_t dataLength;
+
+        if (! TRI_ReadVarUInt64Binary(&p, end, &n) ||
+            n >= readers.size() ||
+            ! TRI_ReadVarUInt64Binary(&p, end, &rid)) {
+          ThrowMalformedBinary();
+        }
+
+        char const* key = ReadBinaryString(&p, end, &keyLength);
+
+        if (! TRI_ReadVarUInt64Binary(&p, end, &sid)) {
+          ThrowMalformedBinary();
+        }
+
+        char const* data = ReadBinaryString(&p, end, &dataLength);
+
+        if (dataLength > UINT32_MAX) {
+          ThrowMalformedBinary();
+        }
+
+        LegendReader* reader = readers[static_cast<size_t>(n)].get();
+
+        TRI_shape_t const* shape = reader->lookupShapeId(reader, static_cast<TRI_shape_sid_t>(sid));
+
+        if (shape == nullptr || shape->_type != TRI_SHAPE_ARRAY) {
+          ThrowMalformedBinary();
+        }
+
+        scratch.resize(dataLength / sizeof(uint64_t) + 1);
+        memcpy(scratch.data(), data, dataLength);
+
+        TRI_shaped_json_t shaped;
+        shaped._sid = static_cast<TRI_shape_sid_t>(sid);
+        shaped._data.data = reinterpret_cast<char*>(scratch.data());
+        shaped._data.length = static_cast<uint32_t>(dataLength);
+
+        TRI_json_t* json = TRI_JsonShapedJson(reader, &shaped);
+
+        if (json == nullptr) {
+          ThrowMalformedBinary();
+        }
+
+        // append the internal attributes in the same order as AqlValue::toJson
+        std::unique_ptr<Json> document(new Json(TRI_UNKNOWN_MEM_ZONE, json));
+        std::string id(names[static_cast<size_t>(n)]);
+        id.push_back('/');
+        id.append(key, keyLength);
+        (*document)(TRI_VOC_ATTRIBUTE_ID, Json(id));
+        (*document)(TRI_VOC_ATTRIBUTE_REV, Json(std::to_string(rid)));
+        (*document)(TRI_VOC_ATTRIBUTE_KEY, Json(std::string(key, keyLength)));
+
+        if (type == BINARY_ENTRY_SHAPED_EDGE) {
+          size_t length;
+          char const* from = ReadBinaryString(&p, end, &length);
+          (*document)(TRI_VOC_ATTRIBUTE_FROM, Json(std::string(from, length)));
+
+          char const* to = ReadBinaryString(&p, end, &length);
+          (*document)(TRI_VOC_ATTRIBUTE_TO, Json(std::string(to, length)));
+        }
+
+        AqlValue a(document.get());
+        document.release();
+        try {
+          block->setValue(i, column, a);
+        }
+        catch (...) {
+          a.destroy();
+          throw;
+        }
+        values.emplace_back(a);
+      }
+      else if (type == BINARY_ENTRY_REFERENCE) {
+        uint64_t n;
+
+        if (! TRI_ReadVarUInt64Binary(&p, end, &n) || n >= values.size()) {
+          ThrowMalformedBinary();
+        }
+
+        block->setValue(i, column, values[static_cast<size_t>(n)]);
+      }
+      else {
+        ThrowMalformedBinary();
+      }
+    }
+  }
+
+  *position = p;
+
+  return block.release();
+}
+
 // Local Variables:
 // mode: outline-minor
 // outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
@@ -30,6 +30,7 @@
 
 #include "Basics/Common.h"
 #include "Basics/JsonHelper.h"
+#include "Basics/StringBuffer.h"
 #include "Aql/AqlValue.h"
 #include "Aql/Range.h"
 #include "Aql/types.h"
@@ -269,6 +270,13 @@ namespace triagens {
           return _nrItems;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimates the memory used by the block, in bytes. values that
+/// occur multiple times in the block are only counted once
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t memoryUsage () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief getter for _data
 ////////////////////////////////////////////////////////////////////////////////
@@ -339,6 +347,33 @@ namespace triagens {
 
         triagens::basics::Json toJson (triagens::arango::AqlTransaction* trx) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief toBinary, append a whole AqlItemBlock to the buffer in a compact
+/// binary representation, the result can be used to recreate the
+/// AqlItemBlock via fromBinary. as in toJson, values are stored column by
+/// column, runs of empty values are collapsed and duplicates are referenced.
+/// documents are stored as their raw shaped data, together with one legend
+/// of the shapes and attribute names per collection. fromBinary turns them
+/// into JSON
+////////////////////////////////////////////////////////////////////////////////
+
+        void toBinary (triagens::arango::AqlTransaction* trx,
+                       triagens::basics::StringBuffer& buffer) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fromBinary, recreate an AqlItemBlock from its binary representation
+/// and advance the position. this throws if the input is malformed
+////////////////////////////////////////////////////////////////////////////////
+
+        static AqlItemBlock* fromBinary (char const** position,
+                                         char const* end);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief content type used for blocks in binary representation
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::string const BinaryContentType;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -36,6 +36,32 @@ using namespace triagens::aql;
 using Json = triagens::basics::Json;
 using JsonHelper = triagens::basics::JsonHelper;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimates the memory used by a JSON value, in bytes
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t JsonMemoryUsage (TRI_json_t const* json) {
+  switch (json->_type) {
+    case TRI_JSON_STRING:
+      return json->_value._string.length;
+
+    case TRI_JSON_ARRAY:
+    case TRI_JSON_OBJECT: {
+      size_t const n = TRI_LengthVector(&json->_value._objects);
+      size_t result = n * sizeof(TRI_json_t);
+
+      for (size_t i = 0; i < n; ++i) {
+        result += JsonMemoryUsage(static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i)));
+      }
+      return result;
+    }
+
+    default:
+      // string references point to memory owned by someone else
+      return 0;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief a quick method to decide whether a value is true
 ////////////////////////////////////////////////////////////////////////////////
@@ -406,6 +432,39 @@ size_t AqlValue::arraySize () const {
   return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimates the memory used by the value, in bytes
+////////////////////////////////////////////////////////////////////////////////
+
+size_t AqlValue::memoryUsage () const {
+  switch (_type) {
+    case JSON: {
+      TRI_ASSERT(_json != nullptr);
+      return sizeof(Json) + sizeof(TRI_json_t) + JsonMemoryUsage(_json->json());
+    }
+
+    case DOCVEC: {
+      TRI_ASSERT(_vector != nullptr);
+      size_t result = sizeof(std::vector<AqlItemBlock*>);
+      for (auto it = _vector->begin(); it != _vector->end(); ++it) {
+        result += (*it)->memoryUsage();
+      }
+      return result;
+    }
+
+    case RANGE: {
+      return sizeof(Range);
+    }
+       
+    case SHAPED: 
+    case EMPTY: {
+      // shaped values point into the datafiles
+    }
+  }
+
+  return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get the numeric value of an AqlValue
 ////////////////////////////////////////////////////////////////////////////////
@@ -1222,6 +1281,115 @@ int AqlValue::Compare (triagens::arango::AqlTransaction* trx,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a normalized sort key for the value to result
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlValue::appendSortKey (triagens::arango::AqlTransaction* trx,
+                              TRI_document_collection_t const* document,
+                              bool compareUtf8,
+                              std::string& result) const {
+  switch (_type) {
+    case AqlValue::EMPTY: {
+      // empty values sort before everything else, and all JSON keys start 
+      // with a byte greater than this
+      result.push_back(0x01);
+      return;
+    }
+
+    case AqlValue::JSON: {
+      TRI_AppendSortKeyJson(result, _json->json(), compareUtf8);
+      return;
+    }
+
+    case AqlValue::SHAPED:
+    case AqlValue::DOCVEC:
+    case AqlValue::RANGE: {
+      triagens::basics::Json json = toJson(trx, document);
+      TRI_AppendSortKeyJson(result, json.json(), compareUtf8);
+      return;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append an identity key for the value to result
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlValue::appendIdentityKey (triagens::arango::AqlTransaction* trx,
+                                  TRI_document_collection_t const* document,
+                                  std::string& result) const {
+  switch (_type) {
+    case AqlValue::EMPTY: {
+      result.push_back('E');
+      break;
+    }
+
+    case AqlValue::SHAPED: {
+      // a document is identified by its collection, key and revision
+      TRI_ASSERT(document != nullptr);
+
+      result.push_back('S');
+      result.append(std::to_string(document->_info._cid));
+      result.push_back('/');
+      result.append(TRI_EXTRACT_MARKER_KEY(_marker));
+      result.push_back('/');
+      result.append(std::to_string(TRI_EXTRACT_MARKER_RID(_marker)));
+      break;
+    }
+
+    case AqlValue::RANGE: {
+      result.push_back('R');
+      result.append(std::to_string(_range->_low));
+      result.push_back(':');
+      result.append(std::to_string(_range->_high));
+      break;
+    }
+
+    case AqlValue::JSON:
+    case AqlValue::DOCVEC: {
+      // the JSON text keeps everything AQL can observe of a value. it never
+      // contains a 0 byte, so keys of several values cannot run into each
+      // other
+      triagens::basics::Json copy;
+      TRI_json_t const* json;
+
+      if (_type == AqlValue::JSON) {
+        json = _json->json();
+      }
+      else {
+        copy = toJson(trx, document);
+        json = copy.json();
+      }
+
+      TRI_string_buffer_t buffer;
+      TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
+
+      int res = TRI_StringifyJson(&buffer, json);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        TRI_DestroyStringBuffer(&buffer);
+        THROW_ARANGO_EXCEPTION(res);
+      }
+
+      result.push_back('J');
+
+      try {
+        result.append(TRI_BeginStringBuffer(&buffer), TRI_LengthStringBuffer(&buffer));
+      }
+      catch (...) {
+        TRI_DestroyStringBuffer(&buffer);
+        throw;
+      }
+
+      TRI_DestroyStringBuffer(&buffer);
+      break;
+    }
+  }
+
+  result.push_back('\0');
+}
+
 // Local Variables:
 // mode: outline-minor
 // outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
@@ -242,6 +242,12 @@ namespace triagens {
 
       size_t arraySize () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimates the memory used by the value, in bytes
+////////////////////////////////////////////////////////////////////////////////
+
+      size_t memoryUsage () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get the numeric value of an AqlValue
 ////////////////////////////////////////////////////////////////////////////////
@@ -345,6 +351,29 @@ namespace triagens {
                           TRI_document_collection_t const*,
                           bool compareUtf8);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a normalized sort key for the value to result. comparing
+/// the keys of two values with memcmp orders them like Compare does for
+/// JSON values, so a value needs to be converted only once when it takes part
+/// in many comparisons. see TRI_AppendSortKeyJson for the properties of keys
+////////////////////////////////////////////////////////////////////////////////
+
+      void appendSortKey (triagens::arango::AqlTransaction*,
+                          TRI_document_collection_t const*,
+                          bool compareUtf8,
+                          std::string& result) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a key for the value to result that is equal for two values
+/// only if they are indistinguishable for AQL functions. unlike sort keys,
+/// these keys keep null attributes and array members, the sign of zero and
+/// the order of attributes. the key of each value ends with a 0 byte
+////////////////////////////////////////////////////////////////////////////////
+
+      void appendIdentityKey (triagens::arango::AqlTransaction*,
+                              TRI_document_collection_t const*,
+                              std::string& result) const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
@@ -28,6 +28,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "CollectionScanner.h"
+#include "Basics/Barrier.h"
+#include "Basics/Exceptions.h"
+#include "Basics/ThreadPool.h"
 
 using namespace triagens::aql;
 
@@ -120,6 +123,181 @@ void LinearCollectionScanner::reset () {
   position = 0;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                  struct ParallelCollectionScanner
+// -----------------------------------------------------------------------------
+
+size_t const ParallelCollectionScanner::SliceSize = 8192;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+ParallelCollectionScanner::ParallelCollectionScanner (triagens::arango::AqlTransaction* trx,
+                                                      TRI_transaction_collection_t* trxCollection,
+                                                      triagens::basics::ThreadPool* pool,
+                                                      FilterType const& filter) 
+  : CollectionScanner(trx, trxCollection),
+    pool(pool),
+    numPartitions(pool->numThreads() + 1),
+    filter(filter),
+    partitions(numPartitions),
+    examinedPartitions(numPartitions, 0),
+    examined(0),
+    exhausted(false) {
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief filter the next round of partitions. the round's slots of the
+/// primary index are split into contiguous partitions, and all but the last
+/// partition are handed to the thread pool. the read-lock is held until all
+/// partitions are done, and the results are concatenated in partition order.
+/// the documents returned may be empty even if the scan is not exhausted yet
+////////////////////////////////////////////////////////////////////////////////
+
+int ParallelCollectionScanner::scan (std::vector<TRI_doc_mptr_copy_t>& docs,
+                                     size_t) {
+  examined = 0;
+
+  if (exhausted) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  size_t n = 0;
+
+  auto callback = [this, &n] (void** beg, void** end) -> int {
+    size_t const slots = static_cast<size_t>(end - beg);
+    n = (std::min)(numPartitions, (slots + SliceSize - 1) / SliceSize);
+
+    TRI_ASSERT(n >= 1);
+
+    std::atomic<int> result(TRI_ERROR_NO_ERROR);
+
+    auto setResult = [&result] (int code) -> void {
+      int expected = TRI_ERROR_NO_ERROR;
+      result.compare_exchange_strong(expected, code, std::memory_order_acquire);
+    };
+
+    {
+      triagens::basics::Barrier barrier(n);
+
+      for (size_t i = 0; i < n; ++i) {
+        void** partitionBeg = beg + i * SliceSize;
+        void** partitionEnd = (i == n - 1) ? end : partitionBeg + SliceSize;
+
+        auto task = [this, i, partitionBeg, partitionEnd, &barrier, &setResult] () -> void {
+          int res;
+
+          try {
+            res = scanPartition(i, partitionBeg, partitionEnd);
+          }
+          catch (triagens::basics::Exception const& ex) {
+            res = ex.code();
+          }
+          catch (...) {
+            res = TRI_ERROR_INTERNAL;
+          }
+
+          if (res != TRI_ERROR_NO_ERROR) {
+            setResult(res);
+          }
+
+          barrier.join();
+        };
+
+        // pool threads must come first, otherwise this thread would process
+        // its own partition before the others were distributed
+        if (i != (n - 1)) {
+          try {
+            pool->enqueue(task);
+          }
+          catch (...) {
+            setResult(TRI_ERROR_OUT_OF_MEMORY);
+            barrier.join();
+          }
+        }
+        else {
+          task();
+        }
+      }
+
+      // barrier waits here until all partitions have joined
+    }
+
+    return result.load(std::memory_order_relaxed);
+  };
+
+  int res = trx->readSlots(trxCollection,
+                           position,
+                           static_cast<TRI_voc_size_t>(numPartitions * SliceSize),
+                           callback,
+                           &totalCount);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  if (n == 0) {
+    // no more slots to read
+    exhausted = true;
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i) {
+    total += partitions[i].size();
+  }
+
+  docs.reserve(docs.size() + total);
+
+  for (size_t i = 0; i < n; ++i) {
+    docs.insert(docs.end(), partitions[i].begin(), partitions[i].end());
+    partitions[i].clear();
+    examined += examinedPartitions[i];
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief filter the documents in the slots [beg, end) of the primary index
+////////////////////////////////////////////////////////////////////////////////
+
+int ParallelCollectionScanner::scanPartition (size_t partition,
+                                              void** beg,
+                                              void** end) {
+  auto& docs = partitions[partition];
+  uint64_t count = 0;
+
+  docs.clear();
+
+  for (void** ptr = beg; ptr < end; ++ptr) {
+    if (*ptr != nullptr) {
+      auto d = static_cast<TRI_doc_mptr_t const*>(*ptr);
+      ++count;
+
+      if (filter(partition, d)) {
+        docs.emplace_back(*d);
+      }
+    }
+  }
+
+  examinedPartitions[partition] = count;
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+void ParallelCollectionScanner::reset () {
+  position = 0;
+  examined = 0;
+  exhausted = false;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -37,6 +37,10 @@
 #include "VocBase/vocbase.h"
 
 namespace triagens {
+  namespace basics {
+    class ThreadPool;
+  }
+
   namespace aql {
 
 // -----------------------------------------------------------------------------
@@ -109,6 +113,58 @@ namespace triagens {
       void reset ();
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                  struct ParallelCollectionScanner
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scanner that splits the primary index into partitions which are
+/// filtered by the threads of a thread pool and the calling thread. only the
+/// documents that pass the filter are returned, in primary index order
+////////////////////////////////////////////////////////////////////////////////
+
+    struct ParallelCollectionScanner : public CollectionScanner {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief filter function, called with the number of the partition and the
+/// document. the function is called concurrently for different partitions
+////////////////////////////////////////////////////////////////////////////////
+
+      typedef std::function<bool(size_t, TRI_doc_mptr_t const*)> FilterType;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of primary index slots a partition covers in a round
+////////////////////////////////////////////////////////////////////////////////
+
+      static size_t const SliceSize;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+  
+      ParallelCollectionScanner (triagens::arango::AqlTransaction*,
+                                 TRI_transaction_collection_t*,
+                                 triagens::basics::ThreadPool*,
+                                 FilterType const&); 
+
+      int scan (std::vector<TRI_doc_mptr_copy_t>&,
+                size_t);
+      
+      void reset ();
+
+      int scanPartition (size_t,
+                         void**,
+                         void**);
+
+      triagens::basics::ThreadPool* pool;
+      size_t const numPartitions;
+      FilterType filter;
+      std::vector<std::vector<TRI_doc_mptr_copy_t>> partitions;
+      std::vector<uint64_t> examinedPartitions;
+      uint64_t examined;
+      bool exhausted;
+    };
+
   }
 }
 
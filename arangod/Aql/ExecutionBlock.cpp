@@ -28,7 +28,9 @@
 #include "Aql/ExecutionBlock.h"
 #include "Aql/CollectionScanner.h"
 #include "Aql/ExecutionEngine.h"
+#include "Aql/SpillFile.h"
 #include "Basics/ScopeGuard.h"
+#include "Basics/ThreadPool.h"
 #include "Basics/StringUtils.h"
 #include "Basics/StringBuffer.h"
 #include "Basics/json-utilities.h"
@@ -38,6 +40,7 @@
 #include "V8/v8-globals.h"
 #include "VocBase/edge-collection.h"
 #include "VocBase/index.h"
+#include "VocBase/server.h"
 #include "VocBase/vocbase.h"
 
 using namespace std;
@@ -57,6 +60,27 @@ using StringBuffer = triagens::basics::StringBuffer;
 #define LEAVE_BLOCK
 #endif
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief CPU time used by the current thread (in seconds), 0 if the platform
+/// does not provide a per-thread CPU clock
+////////////////////////////////////////////////////////////////////////////////
+
+static double ThreadCpuTime () {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  struct timespec ts;
+
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1000000000.0;
+  }
+#endif
+
+  return 0.0;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                            struct AggregatorGroup
 // -----------------------------------------------------------------------------
@@ -121,7 +145,8 @@ void AggregatorGroup::reset () {
 }
 
 void AggregatorGroup::addValues (AqlItemBlock const* src,
-                                 RegisterId groupRegister) {
+                                 RegisterId groupRegister,
+                                 RegisterId countRegister) {
   if (groupRegister == ExecutionNode::MaxRegisterId) {
     // nothing to do
     return;
@@ -132,7 +157,15 @@ void AggregatorGroup::addValues (AqlItemBlock const* src,
     TRI_ASSERT(firstRow <= lastRow);
 
     if (count) {
-      groupLength += lastRow + 1 - firstRow;
+      if (countRegister == ExecutionNode::MaxRegisterId) {
+        groupLength += lastRow + 1 - firstRow;
+      }
+      else {
+        // sum up the partial counts of the rows
+        for (size_t i = firstRow; i <= lastRow; ++i) {
+          groupLength += static_cast<size_t>(src->getValueReference(i, countRegister).toInt64());
+        }
+      }
     }
     else {
       auto block = src->slice(firstRow, lastRow + 1);
@@ -177,6 +210,7 @@ ExecutionBlock::ExecutionBlock (ExecutionEngine* engine,
   : _engine(engine),
     _trx(engine->getQuery()->trx()), 
     _exeNode(ep), 
+    _profile(nullptr),
     _done(false) {
 }
 
@@ -190,6 +224,8 @@ ExecutionBlock::~ExecutionBlock () {
   }
 
   _buffer.clear();
+
+  delete _profile;
 }
 
 // -----------------------------------------------------------------------------
@@ -222,7 +258,7 @@ bool ExecutionBlock::removeDependency (ExecutionBlock* ep) {
 
 int ExecutionBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
   for (auto d : _dependencies) {
-    int res = d->initializeCursor(items, pos);
+    int res = d->profiledInitializeCursor(items, pos);
     if (res != TRI_ERROR_NO_ERROR) {
       return res;
     }
@@ -347,6 +383,89 @@ AqlItemBlock* ExecutionBlock::getSome (size_t atLeast, size_t atMost) {
   return result.release();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializeCursor, accounting the time in the profile
+////////////////////////////////////////////////////////////////////////////////
+
+int ExecutionBlock::profiledInitializeCursor (AqlItemBlock* items, size_t pos) {
+  if (_profile == nullptr) {
+    return initializeCursor(items, pos);
+  }
+
+  double const start = TRI_microtime();
+  double const cpuStart = ThreadCpuTime();
+
+  int res = initializeCursor(items, pos);
+
+  _profile->time    += TRI_microtime() - start;
+  _profile->cpuTime += ThreadCpuTime() - cpuStart;
+
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome, accounting the call in the profile
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* ExecutionBlock::profiledGetSome (size_t atLeast, size_t atMost) {
+  if (_profile == nullptr) {
+    return getSome(atLeast, atMost);
+  }
+
+  double const start = TRI_microtime();
+  double const cpuStart = ThreadCpuTime();
+
+  AqlItemBlock* result = getSome(atLeast, atMost);
+
+  _profile->time    += TRI_microtime() - start;
+  _profile->cpuTime += ThreadCpuTime() - cpuStart;
+  ++_profile->getSomeCalls;
+
+  if (result != nullptr) {
+    _profile->rowsOut += result->size();
+
+    size_t const memory = result->memoryUsage();
+
+    if (memory > _profile->peakMemory) {
+      _profile->peakMemory = memory;
+    }
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skipSome, accounting the call in the profile
+////////////////////////////////////////////////////////////////////////////////
+
+size_t ExecutionBlock::profiledSkipSome (size_t atLeast, size_t atMost) {
+  if (_profile == nullptr) {
+    return skipSome(atLeast, atMost);
+  }
+
+  double const start = TRI_microtime();
+  double const cpuStart = ThreadCpuTime();
+
+  size_t skipped = skipSome(atLeast, atMost);
+
+  _profile->time    += TRI_microtime() - start;
+  _profile->cpuTime += ThreadCpuTime() - cpuStart;
+  ++_profile->skipSomeCalls;
+  _profile->rowsOut += skipped;
+
+  return skipped;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turn on profiling for the block
+////////////////////////////////////////////////////////////////////////////////
+
+void ExecutionBlock::enableProfiling () {
+  if (_profile == nullptr) {
+    _profile = new ExecutionBlockProfile();
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 protected methods
 // -----------------------------------------------------------------------------
@@ -443,6 +562,32 @@ void ExecutionBlock::inheritRegisters (AqlItemBlock const* src,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the normalized sort key of the values of a row in the given
+/// registers
+////////////////////////////////////////////////////////////////////////////////
+
+void ExecutionBlock::buildSortKey (std::vector<std::pair<RegisterId, bool>> const& registers,
+                                   AqlItemBlock const* block,
+                                   size_t row,
+                                   bool compareUtf8,
+                                   std::string& key) const {
+  key.clear();
+
+  for (auto const& reg : registers) {
+    size_t const offset = key.size();
+
+    block->getValueReference(row, reg.first).appendSortKey(_trx, block->getDocumentCollection(reg.first), compareUtf8, key);
+
+    if (! reg.second) {
+      // descending, so invert the key of this register
+      for (size_t i = offset; i < key.size(); i++) {
+        key[i] = ~key[i];
+      }
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief the following is internal to pull one more block and append it to
 /// our _buffer deque. Returns true if a new block was appended and false if
@@ -452,7 +597,7 @@ void ExecutionBlock::inheritRegisters (AqlItemBlock const* src,
 bool ExecutionBlock::getBlock (size_t atLeast, size_t atMost) {
   throwIfKilled(); // check if we were aborted
 
-  std::unique_ptr<AqlItemBlock> docs(_dependencies[0]->getSome(atLeast, atMost));
+  std::unique_ptr<AqlItemBlock> docs(_dependencies[0]->profiledGetSome(atLeast, atMost));
 
   if (docs == nullptr) {
     return false;
@@ -514,10 +659,10 @@ size_t ExecutionBlock::skipSome (size_t atLeast, size_t atMost) {
 // skip exactly <number> outputs, returns <true> if _done after
 // skipping, and <false> otherwise . . .
 bool ExecutionBlock::skip (size_t number) {
-  size_t skipped = skipSome(number, number);
+  size_t skipped = profiledSkipSome(number, number);
   size_t nr = skipped;
   while (nr != 0 && skipped < number) {
-    nr = skipSome(number - skipped, number - skipped);
+    nr = profiledSkipSome(number - skipped, number - skipped);
     skipped += nr;
   }
   if (nr == 0) {
@@ -772,6 +917,7 @@ EnumerateCollectionBlock::EnumerateCollectionBlock (ExecutionEngine* engine,
   : ExecutionBlock(engine, ep),
     _collection(ep->_collection),
     _scanner(nullptr),
+    _parallelScanner(nullptr),
     _posInDocuments(0),
     _random(ep->_random),
     _mustStoreResult(true) {
@@ -785,6 +931,16 @@ EnumerateCollectionBlock::EnumerateCollectionBlock (ExecutionEngine* engine,
     // random scan
     _scanner = new RandomCollectionScanner(_trx, trxCollection);
   }
+  else if (ep->isParallel() && setupParallelScan(ep)) {
+    // linear scan, filtered by the scan threads
+    auto pool = static_cast<triagens::basics::ThreadPool*>(ep->vocbase()->_server->_scanPool);
+    auto filter = [this] (size_t partition, TRI_doc_mptr_t const* mptr) -> bool {
+      return matchesScanFilter(partition, mptr);
+    };
+
+    _parallelScanner = new ParallelCollectionScanner(_trx, trxCollection, pool, filter);
+    _scanner = _parallelScanner;
+  }
   else {
     // default: linear scan
     _scanner = new LinearCollectionScanner(_trx, trxCollection);
@@ -793,6 +949,107 @@ EnumerateCollectionBlock::EnumerateCollectionBlock (ExecutionEngine* engine,
 
 EnumerateCollectionBlock::~EnumerateCollectionBlock () {
   delete _scanner;
+
+  for (auto& it : _scanFilters) {
+    delete it.expression;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up the filters for a parallel scan. the optimizer only marks
+/// collection nodes that are followed by a calculation of a simple filter
+/// condition on the loop variable and the FILTER itself. each partition gets
+/// its own copy of the expression, and everything that the expressions would
+/// compute lazily is computed here so the scan threads do not modify shared
+/// state. the downstream calculation and FILTER stay in place and see only
+/// the documents that passed
+////////////////////////////////////////////////////////////////////////////////
+
+bool EnumerateCollectionBlock::setupParallelScan (EnumerateCollectionNode const* ep) {
+  auto pool = static_cast<triagens::basics::ThreadPool*>(ep->vocbase()->_server->_scanPool);
+
+  if (pool == nullptr) {
+    return false;
+  }
+
+  auto parents = ep->getParents();
+
+  if (parents.size() != 1 ||
+      parents[0]->getType() != ExecutionNode::CALCULATION) {
+    return false;
+  }
+
+  auto expression = static_cast<CalculationNode const*>(parents[0])->expression();
+  auto&& variables = expression->variables();
+
+  if (variables.size() != 1 ||
+      (*variables.begin())->id != ep->outVariable()->id) {
+    return false;
+  }
+
+  // compute the constant values of the condition once
+  std::function<void(AstNode const*)> computeValues = [&computeValues] (AstNode const* node) -> void {
+    if (node->type == NODE_TYPE_VALUE) {
+      node->computeJson();
+      return;
+    }
+
+    size_t const n = node->numMembers();
+    for (size_t i = 0; i < n; ++i) {
+      computeValues(node->getMember(i));
+    }
+  };
+
+  computeValues(expression->node());
+
+  _scanFilterVars.emplace_back(*variables.begin());
+  _scanFilterRegs.emplace_back(0);
+
+  auto document = _trx->documentCollection(_collection->cid());
+  size_t const n = pool->numThreads() + 1;
+
+  _scanFilters.reserve(n);
+
+  for (size_t i = 0; i < n; ++i) {
+    _scanFilters.emplace_back(ScanFilter());
+    auto& filter = _scanFilters.back();
+
+    filter.expression = expression->clone();
+    filter.argv.emplace_back(AqlValue());
+    filter.docColls.emplace_back(document);
+
+    if (filter.expression->isV8()) {
+      // cannot be evaluated outside of a V8 context
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evaluate the filter condition of the parallel scan for a document
+////////////////////////////////////////////////////////////////////////////////
+
+bool EnumerateCollectionBlock::matchesScanFilter (size_t partition,
+                                                  TRI_doc_mptr_t const* mptr) {
+  auto& filter = _scanFilters[partition];
+
+  filter.argv[0] = AqlValue(reinterpret_cast<TRI_df_marker_t const*>(mptr->getDataPtr()));
+
+  TRI_document_collection_t const* myCollection = nullptr;
+  AqlValue result = filter.expression->execute(_trx, 
+                                               filter.docColls, 
+                                               filter.argv, 
+                                               0, 
+                                               _scanFilterVars, 
+                                               _scanFilterRegs, 
+                                               &myCollection);
+
+  bool const matches = result.isTrue();
+  result.destroy();
+
+  return matches;
 }
 
 bool EnumerateCollectionBlock::moreDocuments (size_t hint) {
@@ -814,12 +1071,34 @@ bool EnumerateCollectionBlock::moreDocuments (size_t hint) {
   if (res != TRI_ERROR_NO_ERROR) {
     THROW_ARANGO_EXCEPTION(res);
   }
+
+  if (_parallelScanner != nullptr) {
+    // a round of the parallel scan may not let any document pass
+    while (true) {
+      _engine->_stats.scannedFull += static_cast<int64_t>(_parallelScanner->examined);
+      _engine->_stats.filtered += static_cast<int64_t>(_parallelScanner->examined - newDocs.size());
+
+      if (! newDocs.empty() || _parallelScanner->exhausted) {
+        break;
+      }
+
+      throwIfKilled(); // check if we were aborted
+
+      res = _scanner->scan(newDocs, hint);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        THROW_ARANGO_EXCEPTION(res);
+      }
+    }
+  }
   
   if (newDocs.empty()) {
     return false;
   }
 
-  _engine->_stats.scannedFull += static_cast<int64_t>(newDocs.size());
+  if (_parallelScanner == nullptr) {
+    _engine->_stats.scannedFull += static_cast<int64_t>(newDocs.size());
+  }
 
   _documents.swap(newDocs);
   _posInDocuments = 0;
@@ -998,6 +1277,10 @@ IndexRangeBlock::IndexRangeBlock (ExecutionEngine* engine,
                                   IndexRangeNode const* en)
   : ExecutionBlock(engine, en),
     _collection(en->collection()),
+    _currentIndex(en->_index),
+    _otherConditions(),
+    _projections(),
+    _projectionFields(),
     _posInDocs(0),
     _anyBoundVariable(false),
     _skiplistIterator(nullptr),
@@ -1026,6 +1309,31 @@ IndexRangeBlock::IndexRangeBlock (ExecutionEngine* engine,
     removeOverlapsIndexOr(*_condition);
   }
 
+  for (auto const& lookup : en->_otherLookups) {
+    // multi-index nodes are only created for constant bounds
+    auto condition = new IndexOrCondition();
+
+    try {
+      for (size_t i = 0; i < lookup.ranges.size(); i++) {
+        condition->emplace_back(IndexAndCondition());
+        for (auto ri : lookup.ranges[i]) {
+          TRI_ASSERT(ri.isConstant());
+          condition->at(i).emplace_back(ri.clone());
+        }
+      }
+
+      if (condition->size() > 1) {
+        removeOverlapsIndexOr(*condition);
+      }
+
+      _otherConditions.emplace_back(lookup.index, condition);
+    }
+    catch (...) {
+      delete condition;
+      throw;
+    }
+  }
+
   std::vector<std::vector<RangeInfo>> const& orRanges = en->_ranges;
   TRI_ASSERT(en->_index != nullptr);
 
@@ -1042,10 +1350,33 @@ IndexRangeBlock::IndexRangeBlock (ExecutionEngine* engine,
     _anyBoundVariable |= ! isConstant;
     _allBoundsConstant.push_back(isConstant);
   }
+
+  if (en->_indexOnly) {
+    // a field below another indexed field is part of that field's value
+    auto const& fields = en->_index->fields;
+
+    for (size_t i = 0; i < fields.size(); ++i) {
+      bool isSubField = false;
+
+      for (size_t j = 0; j < fields.size(); ++j) {
+        if (j != i && 
+            (fields[i].compare(0, fields[j].size() + 1, fields[j] + ".") == 0 ||
+             (j < i && fields[i] == fields[j]))) {
+          isSubField = true;
+          break;
+        }
+      }
+
+      if (! isSubField) {
+        _projectionFields.emplace_back(make_pair(i, triagens::basics::StringUtils::split(fields[i], '.')));
+      }
+    }
+  }
 }
 
 IndexRangeBlock::~IndexRangeBlock () {
   destroyHashIndexSearchValues();
+  clearProjections();
 
   for (auto e : _allVariableBoundExpressions) {
     delete e;
@@ -1054,6 +1385,10 @@ IndexRangeBlock::~IndexRangeBlock () {
   if (_freeCondition && _condition != nullptr) {
     delete _condition;
   }
+
+  for (auto& it : _otherConditions) {
+    delete it.second;
+  }
     
   if (_skiplistIterator != nullptr) {
     TRI_FreeSkiplistIterator(_skiplistIterator);
@@ -1382,13 +1717,30 @@ bool IndexRangeBlock::initRanges () {
   }
   
   auto en = static_cast<IndexRangeNode const*>(getPlanNode());
-  TRI_ASSERT(en->_index != nullptr);
+
+  if (en->isMultiIndex()) {
+    // all lookups are carried out at once by readMultiIndex
+    TRI_ASSERT(! _anyBoundVariable);
+    return true;
+  }
+
+  return initIndexIterator();
+  LEAVE_BLOCK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the iterator for the current index and _condition
+////////////////////////////////////////////////////////////////////////////////
+
+bool IndexRangeBlock::initIndexIterator () {
+  ENTER_BLOCK
+  TRI_ASSERT(_currentIndex != nullptr);
    
-  if (en->_index->type == TRI_IDX_TYPE_PRIMARY_INDEX) {
+  if (_currentIndex->type == TRI_IDX_TYPE_PRIMARY_INDEX) {
     return true; //no initialization here!
   }
   
-  if (en->_index->type == TRI_IDX_TYPE_EDGE_INDEX) {
+  if (_currentIndex->type == TRI_IDX_TYPE_EDGE_INDEX) {
     if (_condition->empty()) {
       return false;
     }
@@ -1398,7 +1750,7 @@ bool IndexRangeBlock::initRanges () {
     return (_edgeIndexIterator != nullptr);
   }
       
-  if (en->_index->type == TRI_IDX_TYPE_HASH_INDEX) {
+  if (_currentIndex->type == TRI_IDX_TYPE_HASH_INDEX) {
     if (_condition->empty()) {
       return false;
     }
@@ -1408,7 +1760,7 @@ bool IndexRangeBlock::initRanges () {
     return (_hashIndexSearchValue._values != nullptr); 
   }
   
-  if (en->_index->type == TRI_IDX_TYPE_SKIPLIST_INDEX) {
+  if (_currentIndex->type == TRI_IDX_TYPE_SKIPLIST_INDEX) {
     if (_condition->empty()) {
       return false;
     }
@@ -1448,14 +1800,14 @@ void IndexRangeBlock::sortConditions () {
     TRI_IF_FAILURE("IndexRangeBlock::sortConditions") {
       THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
     }
-    next.reserve(en->_index->fields.size());
+    next.reserve(_currentIndex->fields.size());
     prefix.emplace_back(next);
     // prefix[s][t] = position in _condition[s] corresponding to the <t>th index
     // field
-    for (size_t t = 0; t < en->_index->fields.size(); t++) {
+    for (size_t t = 0; t < _currentIndex->fields.size(); t++) {
       for (size_t u = 0; u < _condition->at(s).size(); u++) {
         auto ri = _condition->at(s)[u];
-        if (en->_index->fields[t].compare(ri._attr) == 0) {
+        if (_currentIndex->fields[t].compare(ri._attr) == 0) {
     
           TRI_IF_FAILURE("IndexRangeBlock::sortConditionsInner") {
             THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
@@ -1624,28 +1976,128 @@ bool IndexRangeBlock::readIndex (size_t atMost) {
   else { 
     _documents.clear();
   }
+  clearProjections();
   
   auto en = static_cast<IndexRangeNode const*>(getPlanNode());
   
-  if (en->_index->type == TRI_IDX_TYPE_PRIMARY_INDEX) {
+  if (en->isMultiIndex()) {
+    if (_flag) {
+      readMultiIndex();
+    }
+  }
+  else if (_currentIndex->type == TRI_IDX_TYPE_PRIMARY_INDEX) {
     if (_flag) {
       readPrimaryIndex(*_condition);
     }
   }
-  else if (en->_index->type == TRI_IDX_TYPE_EDGE_INDEX) {
+  else {
+    readCurrentIndex(atMost);
+  }
+  _flag = false;
+  return (! _documents.empty());
+  LEAVE_BLOCK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read from the current index, depending on its type
+////////////////////////////////////////////////////////////////////////////////
+
+void IndexRangeBlock::readCurrentIndex (size_t atMost) {
+  if (_currentIndex->type == TRI_IDX_TYPE_PRIMARY_INDEX) {
+    readPrimaryIndex(*_condition);
+  }
+  else if (_currentIndex->type == TRI_IDX_TYPE_EDGE_INDEX) {
     readEdgeIndex(atMost);
   }
-  else if (en->_index->type == TRI_IDX_TYPE_HASH_INDEX) {
+  else if (_currentIndex->type == TRI_IDX_TYPE_HASH_INDEX) {
     readHashIndex(atMost);
   }
-  else if (en->_index->type == TRI_IDX_TYPE_SKIPLIST_INDEX) {
+  else if (_currentIndex->type == TRI_IDX_TYPE_SKIPLIST_INDEX) {
     readSkiplistIndex(atMost);
   }
   else {
     TRI_ASSERT(false);
   }
-  _flag = false;
-  return (! _documents.empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read the results of all lookups of a multi-index node at once.
+/// for a union, documents found by more than one lookup are returned only
+/// once, in the order they were first found. for an intersection, the 
+/// sorted document pointers of the lookups are intersected
+////////////////////////////////////////////////////////////////////////////////
+
+void IndexRangeBlock::readMultiIndex () {
+  ENTER_BLOCK;
+  auto en = static_cast<IndexRangeNode const*>(getPlanNode());
+  bool const intersect = en->isIntersection();
+
+  Index const* mainIndex = _currentIndex;
+  IndexOrCondition* mainCondition = _condition;
+
+  auto sortByDocument = [] (TRI_doc_mptr_copy_t const& lhs, TRI_doc_mptr_copy_t const& rhs) -> bool {
+    return lhs.getDataPtr() < rhs.getDataPtr();
+  };
+
+  std::vector<TRI_doc_mptr_copy_t> result;
+  std::unordered_set<void const*> seen;
+
+  try {
+    for (size_t i = 0; i <= _otherConditions.size(); ++i) {
+      if (i > 0) {
+        _currentIndex = _otherConditions[i - 1].first;
+        _condition = _otherConditions[i - 1].second;
+      }
+
+      // read everything the lookup produces
+      _documents.clear();
+
+      if (initIndexIterator()) {
+        size_t n;
+        do {
+          n = _documents.size();
+          readCurrentIndex(DefaultBatchSize);
+        }
+        while (_documents.size() > n && _currentIndex->type != TRI_IDX_TYPE_PRIMARY_INDEX);
+      }
+
+      if (intersect) {
+        std::sort(_documents.begin(), _documents.end(), sortByDocument);
+
+        if (i == 0) {
+          result.swap(_documents);
+        }
+        else {
+          std::vector<TRI_doc_mptr_copy_t> both;
+          std::set_intersection(result.begin(), result.end(),
+                                _documents.begin(), _documents.end(),
+                                std::back_inserter(both), sortByDocument);
+          result.swap(both);
+        }
+
+        if (result.empty()) {
+          // nothing can be left after intersecting with the other lookups
+          break;
+        }
+      }
+      else {
+        for (auto const& document : _documents) {
+          if (seen.emplace(document.getDataPtr()).second) {
+            result.emplace_back(document);
+          }
+        }
+      }
+    }
+  }
+  catch (...) {
+    _currentIndex = mainIndex;
+    _condition = mainCondition;
+    throw;
+  }
+
+  _currentIndex = mainIndex;
+  _condition = mainCondition;
+  _documents.swap(result);
   LEAVE_BLOCK;
 }
 
@@ -1758,10 +2210,25 @@ AqlItemBlock* IndexRangeBlock::getSome (size_t atLeast,
         // The result is in the first variable of this depth,
         // we do not need to do a lookup in getPlanNode()->_registerPlan->varInfo,
         // but can just take cur->getNrRegs() as registerId:
-        res->setValue(j, static_cast<triagens::aql::RegisterId>(curRegs),
-                      AqlValue(reinterpret_cast<TRI_df_marker_t
-                               const*>(_documents[_posInDocs++].getDataPtr())));
-        // No harm done, if the setValue throws!
+        if (! _projections.empty()) {
+          // index-only scan, hand over the value built from the index entry
+          AqlValue a(new Json(TRI_UNKNOWN_MEM_ZONE, _projections[_posInDocs]));
+          _projections[_posInDocs++] = nullptr;
+
+          try {
+            res->setValue(j, static_cast<triagens::aql::RegisterId>(curRegs), a);
+          }
+          catch (...) {
+            a.destroy();
+            throw;
+          }
+        }
+        else {
+          res->setValue(j, static_cast<triagens::aql::RegisterId>(curRegs),
+                        AqlValue(reinterpret_cast<TRI_df_marker_t
+                                 const*>(_documents[_posInDocs++].getDataPtr())));
+          // No harm done, if the setValue throws!
+        }
       }
     }
 
@@ -1977,8 +2444,7 @@ void IndexRangeBlock::readEdgeIndex (size_t atMost) {
     return;
   }
 
-  auto en = static_cast<IndexRangeNode const*>(getPlanNode());
-  TRI_index_t* idx = en->_index->getInternals();
+  TRI_index_t* idx = _currentIndex->getInternals();
   TRI_ASSERT(idx != nullptr);
  
   try { 
@@ -2039,8 +2505,7 @@ void IndexRangeBlock::destroyHashIndexSearchValues () {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool IndexRangeBlock::setupHashIndexSearchValue (IndexAndCondition const& range) { 
-  auto en = static_cast<IndexRangeNode const*>(getPlanNode());
-  TRI_index_t* idx = en->_index->getInternals();
+  TRI_index_t* idx = _currentIndex->getInternals();
   TRI_ASSERT(idx != nullptr);
   TRI_hash_index_t* hashIndex = (TRI_hash_index_t*) idx;
 
@@ -2122,7 +2587,7 @@ void IndexRangeBlock::readHashIndex (size_t atMost) {
   }
 
   auto en = static_cast<IndexRangeNode const*>(getPlanNode());
-  TRI_index_t* idx = en->_index->getInternals();
+  TRI_index_t* idx = _currentIndex->getInternals();
   TRI_ASSERT(idx != nullptr);
   
   size_t nrSent = 0;
@@ -2139,6 +2604,26 @@ void IndexRangeBlock::readHashIndex (size_t atMost) {
     _engine->_stats.scannedIndex += static_cast<int64_t>(numRead);
     nrSent += numRead;
 
+    if (en->_indexOnly) {
+      // all documents found have exactly the values searched for
+      for (size_t i = 0; i < numRead; ++i) {
+        TRI_json_t* projection = (i == 0 ? buildProjection(_hashIndexSearchValue._values) 
+                                         : TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, _projections.back()));
+
+        if (projection == nullptr) {
+          THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+        }
+
+        try {
+          _projections.emplace_back(projection);
+        }
+        catch (...) {
+          TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, projection);
+          throw;
+        }
+      }
+    }
+
     if (_hashNextElement == nullptr) {
       destroyHashIndexSearchValues();
 
@@ -2195,7 +2680,7 @@ void IndexRangeBlock::getSkiplistIterator (IndexAndCondition const& ranges) {
   TRI_ASSERT(_skiplistIterator == nullptr);
   
   auto en = static_cast<IndexRangeNode const*>(getPlanNode());
-  TRI_index_t* idx = en->_index->getInternals();
+  TRI_index_t* idx = _currentIndex->getInternals();
   TRI_ASSERT(idx != nullptr);
 
   TRI_shaper_t* shaper = _collection->documentCollection()->getShaper(); 
@@ -2281,6 +2766,13 @@ void IndexRangeBlock::readSkiplistIndex (size_t atMost) {
   if (_skiplistIterator == nullptr) {
     return;
   }
+
+  auto en = static_cast<IndexRangeNode const*>(getPlanNode());
+  std::vector<TRI_shaped_json_t> values;
+
+  if (en->_indexOnly) {
+    values.resize(en->_index->fields.size());
+  }
   
   try {
     size_t nrSent = 0;
@@ -2301,9 +2793,35 @@ void IndexRangeBlock::readSkiplistIndex (size_t atMost) {
         _documents.emplace_back(*(indexElement->_document));
         ++nrSent;
         ++_engine->_stats.scannedIndex;
-      }
-    }
-  }
+
+        if (en->_indexOnly) {
+          TRI_shaped_sub_t const* subObjects = SkiplistIndex_Subobjects(indexElement);
+
+          for (auto const& field : _projectionFields) {
+            TRI_shaped_sub_t const* sub = &subObjects[field.first];
+            // small values are stored in the index entry itself, only
+            // larger ones need to be read from the document
+            char const* data = nullptr;
+            if (sub->_sid > BasicShapes::TRI_SHAPE_SID_SHORT_STRING) {
+              data = indexElement->_document->getShapedJsonPtr();
+            }
+            values[field.first]._sid = sub->_sid;
+            TRI_InspectShapedSub(sub, data, values[field.first]);
+          }
+
+          TRI_json_t* projection = buildProjection(values.data());
+
+          try {
+            _projections.emplace_back(projection);
+          }
+          catch (...) {
+            TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, projection);
+            throw;
+          }
+        }
+      }
+    }
+  }
   catch (...) {
     if (_skiplistIterator != nullptr) {
       TRI_FreeSkiplistIterator(_skiplistIterator);
@@ -2314,6 +2832,64 @@ void IndexRangeBlock::readSkiplistIndex (size_t atMost) {
   LEAVE_BLOCK;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the value of the out variable for an index-only scan. this
+/// is an object with the indexed attributes, nested by their paths
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* IndexRangeBlock::buildProjection (TRI_shaped_json_t const* values) const {
+  TRI_shaper_t* shaper = _collection->documentCollection()->getShaper(); 
+  TRI_json_t* result = TRI_CreateObjectJson(TRI_UNKNOWN_MEM_ZONE, _projectionFields.size());
+
+  if (result == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  for (auto const& field : _projectionFields) {
+    auto const& path = field.second;
+    TRI_json_t* parent = result;
+
+    // create the objects for the leading parts of the attribute path
+    for (size_t i = 0; i + 1 < path.size() && parent != nullptr; ++i) {
+      TRI_json_t* sub = TRI_LookupObjectJson(parent, path[i].c_str());
+
+      if (sub == nullptr) {
+        TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, parent, path[i].c_str(), TRI_CreateObjectJson(TRI_UNKNOWN_MEM_ZONE));
+        sub = TRI_LookupObjectJson(parent, path[i].c_str());
+      }
+
+      parent = sub;
+    }
+
+    TRI_json_t* value = TRI_JsonShapedJson(shaper, &values[field.first]);
+
+    if (parent == nullptr || value == nullptr) {
+      if (value != nullptr) {
+        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, value);
+      }
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, result);
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, parent, path.back().c_str(), value);
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the values built for an index-only scan
+////////////////////////////////////////////////////////////////////////////////
+
+void IndexRangeBlock::clearProjections () {
+  for (auto projection : _projections) {
+    if (projection != nullptr) {
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, projection);
+    }
+  }
+  _projections.clear();
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                          class EnumerateListBlock
 // -----------------------------------------------------------------------------
@@ -2816,12 +3392,26 @@ SubqueryBlock::SubqueryBlock (ExecutionEngine* engine,
                               ExecutionBlock* subquery)
   : ExecutionBlock(engine, en), 
     _outReg(ExecutionNode::MaxRegisterId),
-    _subquery(subquery) {
+    _subquery(subquery),
+    _memoize(en->isDeterministic()),
+    _inRegs(),
+    _memoized() {
   
   auto it = en->getRegisterPlan()->varInfo.find(en->_outVariable->id);
   TRI_ASSERT(it != en->getRegisterPlan()->varInfo.end());
   _outReg = it->second.registerId;
   TRI_ASSERT(_outReg < ExecutionNode::MaxRegisterId);
+
+  if (_memoize) {
+    // the result of a deterministic subquery only depends on the values of
+    // the outer variables it uses
+    for (auto const& v : en->getVariablesUsedHere()) {
+      auto it2 = en->getRegisterPlan()->varInfo.find(v->id);
+      TRI_ASSERT(it2 != en->getRegisterPlan()->varInfo.end());
+      TRI_ASSERT(it2->second.registerId < ExecutionNode::MaxRegisterId);
+      _inRegs.emplace_back(it2->second.registerId);
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2829,8 +3419,15 @@ SubqueryBlock::SubqueryBlock (ExecutionEngine* engine,
 ////////////////////////////////////////////////////////////////////////////////
 
 SubqueryBlock::~SubqueryBlock () {
+  clearMemoizedResults();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of subquery results kept across blocks
+////////////////////////////////////////////////////////////////////////////////
+
+size_t const SubqueryBlock::MaxMemoizedResults = 1024;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief initialize, tell dependency and the subquery
 ////////////////////////////////////////////////////////////////////////////////
@@ -2846,6 +3443,11 @@ int SubqueryBlock::initialize () {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief getSome
+/// a deterministic subquery is executed only once per distinct combination
+/// of the outer variables it uses within a block, and all rows with the same
+/// combination share the result. a constant subquery is executed once for the
+/// whole query. results for combinations that repeat within a block are also
+/// kept for later blocks, which get copies of them
 ////////////////////////////////////////////////////////////////////////////////
 
 AqlItemBlock* SubqueryBlock::getSome (size_t atLeast,
@@ -2857,42 +3459,65 @@ AqlItemBlock* SubqueryBlock::getSome (size_t atLeast,
     return nullptr;
   }
 
-  // TODO: constant and deterministic subqueries only need to be executed once
-  bool const subqueryIsConst = false; // TODO 
-
-  std::vector<AqlItemBlock*>* subqueryResults = nullptr;
+  // results of this block by key, and whether the key occurred more than once.
+  // the values are owned by res
+  std::unordered_map<std::string, std::pair<AqlValue, bool>> results;
+  std::string key;
 
   for (size_t i = 0; i < res->size(); i++) {
-    int ret = _subquery->initializeCursor(res.get(), i);
+    if (_memoize) {
+      buildMemoizeKey(res.get(), i, key);
+
+      auto it = results.find(key);
 
-    if (ret != TRI_ERROR_NO_ERROR) {
-      THROW_ARANGO_EXCEPTION(ret);
+      if (it != results.end()) {
+        // re-use subquery result calculated for an earlier row
+        res->setValue(i, _outReg, (*it).second.first);
+        (*it).second.second = true;
+        continue;
+      }
     }
 
-    if (i > 0 && subqueryIsConst) {
-      // re-use already calculated subquery result
-      TRI_ASSERT(subqueryResults != nullptr);
-      res->setValue(i, _outReg, AqlValue(subqueryResults));
+    AqlValue value;
+    auto it = (_memoize ? _memoized.find(key) : _memoized.end());
+
+    if (it != _memoized.end()) {
+      // re-use subquery result calculated for an earlier block
+      value = (*it).second.clone();
     }
     else {
-      // initial subquery execution or subquery is not constant
-      subqueryResults = executeSubquery(); 
-      TRI_ASSERT(subqueryResults != nullptr);
-      try {
-        TRI_IF_FAILURE("SubqueryBlock::getSome") {
-          THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
-        }
-        res->setValue(i, _outReg, AqlValue(subqueryResults));
+      int ret = _subquery->profiledInitializeCursor(res.get(), i);
+
+      if (ret != TRI_ERROR_NO_ERROR) {
+        THROW_ARANGO_EXCEPTION(ret);
       }
-      catch (...) {
-        destroySubqueryResults(subqueryResults);
-        throw;
+
+      value = AqlValue(executeSubquery()); 
+    }
+
+    try {
+      TRI_IF_FAILURE("SubqueryBlock::getSome") {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
       }
-    } 
+      res->setValue(i, _outReg, value);
+    }
+    catch (...) {
+      value.destroy();
+      throw;
+    }
+
+    if (_memoize) {
+      // the value is owned by res now
+      results.emplace(key, make_pair(value, _inRegs.empty()));
+    }
       
     throwIfKilled(); // check if we were aborted
+  }
 
+  if (_memoize) {
+    memoizeResults(results);
   }
+
   // Clear out registers no longer needed later:
   clearRegisters(res.get());
   return res.release();
@@ -2903,6 +3528,8 @@ AqlItemBlock* SubqueryBlock::getSome (size_t atLeast,
 ////////////////////////////////////////////////////////////////////////////////
 
 int SubqueryBlock::shutdown (int errorCode) {
+  clearMemoizedResults();
+
   int res = ExecutionBlock::shutdown(errorCode);
   if (res != TRI_ERROR_NO_ERROR) {
     return res;
@@ -2919,7 +3546,7 @@ std::vector<AqlItemBlock*>* SubqueryBlock::executeSubquery () {
   auto results = new std::vector<AqlItemBlock*>;
   try {
     do {
-      unique_ptr<AqlItemBlock> tmp(_subquery->getSome(DefaultBatchSize, DefaultBatchSize));
+      unique_ptr<AqlItemBlock> tmp(_subquery->profiledGetSome(DefaultBatchSize, DefaultBatchSize));
       if (tmp.get() == nullptr) {
         break;
       }
@@ -2951,6 +3578,64 @@ void SubqueryBlock::destroySubqueryResults (std::vector<AqlItemBlock*>* results)
   delete results;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remember the results of a block's subquery executions for later
+/// blocks. only results that were used more than once are kept, so a
+/// subquery that never sees the same outer values twice is not copied
+////////////////////////////////////////////////////////////////////////////////
+
+void SubqueryBlock::memoizeResults (std::unordered_map<std::string, std::pair<AqlValue, bool>> const& results) {
+  for (auto const& it : results) {
+    if (_memoized.size() >= MaxMemoizedResults) {
+      return;
+    }
+
+    if (! it.second.second || _memoized.find(it.first) != _memoized.end()) {
+      continue;
+    }
+
+    AqlValue copy = it.second.first.clone();
+
+    try {
+      _memoized.emplace(it.first, copy);
+    }
+    catch (...) {
+      copy.destroy();
+      throw;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the key of the outer variables of a row
+///
+/// sort keys cannot be used here. they drop null attributes and trailing null
+/// array members, and they do not keep the sign of zero and the order of
+/// attributes, so HAS(), LENGTH() or ATTRIBUTES() could tell apart values
+/// with the same sort key
+////////////////////////////////////////////////////////////////////////////////
+
+void SubqueryBlock::buildMemoizeKey (AqlItemBlock const* block,
+                                     size_t row,
+                                     std::string& key) const {
+  key.clear();
+
+  for (auto const& reg : _inRegs) {
+    block->getValueReference(row, reg).appendIdentityKey(_trx, block->getDocumentCollection(reg), key);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy all memoized results
+////////////////////////////////////////////////////////////////////////////////
+
+void SubqueryBlock::clearMemoizedResults () {
+  for (auto& it : _memoized) {
+    it.second.destroy();
+  }
+  _memoized.clear();
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 class FilterBlock
 // -----------------------------------------------------------------------------
@@ -3161,9 +3846,13 @@ SortedAggregateBlock::SortedAggregateBlock (ExecutionEngine* engine,
                                             AggregateNode const* en)
   : ExecutionBlock(engine, en),
     _aggregateRegisters(),
+    _groupKeyRegisters(),
+    _groupKey(),
+    _rowKey(),
     _currentGroup(en->_count),
     _expressionRegister(ExecutionNode::MaxRegisterId),
     _groupRegister(ExecutionNode::MaxRegisterId),
+    _countRegister(ExecutionNode::MaxRegisterId),
     _variableNames() {
  
   for (auto p : en->_aggregateVariables) {
@@ -3177,6 +3866,7 @@ SortedAggregateBlock::SortedAggregateBlock (ExecutionEngine* engine,
     TRI_ASSERT((*itIn).second.registerId < ExecutionNode::MaxRegisterId);
     TRI_ASSERT((*itOut).second.registerId < ExecutionNode::MaxRegisterId);
     _aggregateRegisters.emplace_back(make_pair((*itOut).second.registerId, (*itIn).second.registerId));
+    _groupKeyRegisters.emplace_back(make_pair((*itIn).second.registerId, true));
   }
 
   if (en->_outVariable != nullptr) {
@@ -3192,6 +3882,12 @@ SortedAggregateBlock::SortedAggregateBlock (ExecutionEngine* engine,
       _expressionRegister = (*it).second.registerId;
     }
 
+    if (en->_countVariable != nullptr) {
+      auto it = registerPlan.find(en->_countVariable->id);
+      TRI_ASSERT(it != registerPlan.end());
+      _countRegister = (*it).second.registerId;
+    }
+
     // construct a mapping of all register ids to variable names
     // we need this mapping to generate the grouped output
 
@@ -3292,31 +3988,17 @@ int SortedAggregateBlock::getOrSkipSome (size_t atLeast,
 
     bool newGroup = false;
     if (! isTotalAggregation) {
+      // the group values of each row are converted only once, into a key
+      // that can be compared bytewise with the key of the current group
+      buildSortKey(_groupKeyRegisters, cur, _pos, false, _rowKey);
+
       if (_currentGroup.groupValues[0].isEmpty()) {
         // we never had any previous group
         newGroup = true;
       }
-      else {
-        // we already had a group, check if the group has changed
-        size_t i = 0;
-
-        for (auto it = _aggregateRegisters.begin(); it != _aggregateRegisters.end(); ++it) {
-          int cmp = AqlValue::Compare(
-            _trx,
-            _currentGroup.groupValues[i],
-            _currentGroup.collections[i],
-            cur->getValue(_pos, (*it).second),
-            cur->getDocumentCollection((*it).second),
-            false
-          );
-
-          if (cmp != 0) {
-            // group change
-            newGroup = true;
-            break;
-          }
-          ++i;
-        }
+      else if (_rowKey != _groupKey) {
+        // group change
+        newGroup = true;
       }
     }
 
@@ -3347,6 +4029,7 @@ int SortedAggregateBlock::getOrSkipSome (size_t atLeast,
         _currentGroup.collections[i] = cur->getDocumentCollection((*it).second);
         ++i;
       }
+      _groupKey.swap(_rowKey);
       if (! skipping) {
         _currentGroup.setFirstRow(_pos);
       }
@@ -3398,7 +4081,7 @@ int SortedAggregateBlock::getOrSkipSome (size_t atLeast,
       // hasMore
 
       // move over the last group details into the group before we delete the block
-      _currentGroup.addValues(cur, _groupRegister);
+      _currentGroup.addValues(cur, _groupRegister, _countRegister);
 
       delete cur;
       cur = _buffer.front();
@@ -3451,7 +4134,7 @@ void SortedAggregateBlock::emitGroup (AqlItemBlock const* cur,
 
   if (_groupRegister != ExecutionNode::MaxRegisterId) {
     // set the group values
-    _currentGroup.addValues(cur, _groupRegister);
+    _currentGroup.addValues(cur, _groupRegister, _countRegister);
 
     if (static_cast<AggregateNode const*>(_exeNode)->_count) {
       // only set group count in result register
@@ -3485,7 +4168,8 @@ HashedAggregateBlock::HashedAggregateBlock (ExecutionEngine* engine,
                                             AggregateNode const* en)
   : ExecutionBlock(engine, en),
     _aggregateRegisters(),
-    _groupRegister(ExecutionNode::MaxRegisterId) {
+    _groupRegister(ExecutionNode::MaxRegisterId),
+    _countRegister(ExecutionNode::MaxRegisterId) {
  
   for (auto p : en->_aggregateVariables) {
     // We know that planRegisters() has been run, so
@@ -3508,6 +4192,12 @@ HashedAggregateBlock::HashedAggregateBlock (ExecutionEngine* engine,
     TRI_ASSERT(it != registerPlan.end());
     _groupRegister = (*it).second.registerId;
     TRI_ASSERT(_groupRegister > 0 && _groupRegister < ExecutionNode::MaxRegisterId);
+
+    if (en->_countVariable != nullptr) {
+      auto it = registerPlan.find(en->_countVariable->id);
+      TRI_ASSERT(it != registerPlan.end());
+      _countRegister = (*it).second.registerId;
+    }
   }
   else {
     TRI_ASSERT(! static_cast<AggregateNode const*>(_exeNode)->_count);
@@ -3626,6 +4316,11 @@ int HashedAggregateBlock::getOrSkipSome (size_t atLeast,
       groupValues.emplace_back(cur->getValueReference(_pos, _aggregateRegisters[i].second));
     }
 
+    // rows with partial counts contribute their count, all others one
+    size_t const increment = (_countRegister == ExecutionNode::MaxRegisterId ? 
+                              1 : 
+                              static_cast<size_t>(cur->getValueReference(_pos, _countRegister).toInt64()));
+
     // now check if we already know this group
     auto it = allGroups.find(groupValues);
 
@@ -3638,11 +4333,11 @@ int HashedAggregateBlock::getOrSkipSome (size_t atLeast,
         group.emplace_back(cur->getValueReference(_pos, _aggregateRegisters[i].second).clone());
       }
 
-      allGroups.emplace(group, 1);
+      allGroups.emplace(group, increment);
     }
     else {
       // existing group. simply increase the counter
-      (*it).second++;
+      (*it).second += increment;
     }
 
     if (++_pos >= cur->size()) {
@@ -3733,12 +4428,23 @@ bool HashedAggregateBlock::GroupKeyEqual::operator() (std::vector<AqlValue> cons
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   class SortBlock
 // -----------------------------------------------------------------------------
+
+size_t const SortBlock::MaxMergeRuns = 16;
         
 SortBlock::SortBlock (ExecutionEngine* engine,
                       SortNode const* en)
   : ExecutionBlock(engine, en),
     _sortRegisters(),
-    _stable(en->_stable) {
+    _stable(en->_stable),
+    _limit(en->_limit),
+    _spillThreshold(0),
+    _runs(),
+    _mergeBlocks(),
+    _mergePos(),
+    _mergeKeys(),
+    _mergeHeap(),
+    _mergeRemaining(0),
+    _merging(false) {
   
   for (auto p : en->_elements) {
     auto it = en->getRegisterPlan()->varInfo.find(p.first->id);
@@ -3749,9 +4455,12 @@ SortBlock::SortBlock (ExecutionEngine* engine,
 }
 
 SortBlock::~SortBlock () {
+  clearRuns();
 }
 
 int SortBlock::initialize () {
+  _spillThreshold = _engine->getQuery()->spillThreshold();
+
   return ExecutionBlock::initialize();
 }
 
@@ -3760,8 +4469,39 @@ int SortBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
   if (res != TRI_ERROR_NO_ERROR) {
     return res;
   }
-  // suck all blocks into _buffer
-  while (getBlock(DefaultBatchSize, DefaultBatchSize)) {
+
+  clearRuns();
+
+  if (_limit > 0) {
+    // only the best rows are kept while reading the input
+    doTopK();
+  }
+  else {
+    // suck all blocks into _buffer, writing sorted runs to disk whenever
+    // the buffered rows reach the spill threshold
+    size_t buffered = 0;
+
+    while (getBlock(DefaultBatchSize, DefaultBatchSize)) {
+      buffered += _buffer.back()->size();
+
+      if (_spillThreshold > 0 && buffered >= _spillThreshold) {
+        spillRun();
+        buffered = 0;
+      }
+    }
+
+    if (! _runs.empty()) {
+      if (! _buffer.empty()) {
+        spillRun();
+      }
+      startMerge();
+      _done = _mergeHeap.empty();
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    if (! _buffer.empty()) {
+      doSorting();
+    }
   }
 
   if (_buffer.empty()) {
@@ -3769,8 +4509,6 @@ int SortBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
     return TRI_ERROR_NO_ERROR;
   }
 
-  doSorting();
-
   _done = false;
   _pos = 0;
 
@@ -3801,22 +4539,42 @@ void SortBlock::doSorting () {
     count++;
   }
 
-  std::vector<TRI_document_collection_t const*> colls;
-  for (RegisterId i = 0; i < _sortRegisters.size(); i++) {
-    colls.emplace_back(_buffer.front()->getDocumentCollection(_sortRegisters[i].first));
+  // extract the sort key of each row once, so that comparisons do not need
+  // to convert values again
+  std::vector<std::string> keys;
+  keys.resize(sum);
+  for (size_t i = 0; i < sum; i++) {
+    buildSortKey(_sortRegisters, _buffer[coords[i].first], coords[i].second, true, keys[i]);
+  }
+
+  std::vector<size_t> order;
+  order.reserve(sum);
+  for (size_t i = 0; i < sum; i++) {
+    order.emplace_back(i);
   }
 
-  // comparison function
-  OurLessThan ourLessThan(_trx, _buffer, _sortRegisters, colls);
+  auto ourLessThan = [&keys] (size_t a, size_t b) -> bool {
+    return keys[a] < keys[b];
+  };
 
   // sort coords
   if (_stable) {
-    std::stable_sort(coords.begin(), coords.end(), ourLessThan);
+    std::stable_sort(order.begin(), order.end(), ourLessThan);
   }
   else {
-    std::sort(coords.begin(), coords.end(), ourLessThan);
+    std::sort(order.begin(), order.end(), ourLessThan);
   }
 
+  {
+    std::vector<std::pair<size_t, size_t>> sorted;
+    sorted.reserve(sum);
+    for (auto i : order) {
+      sorted.emplace_back(coords[i]);
+    }
+    coords.swap(sorted);
+  }
+  keys.clear();
+
   // here we collect the new blocks (later swapped into _buffer):
   std::deque<AqlItemBlock*> newbuffer;
 
@@ -3942,85 +4700,441 @@ void SortBlock::doSorting () {
   }
 }
 
-// -----------------------------------------------------------------------------
-// --SECTION--                                      class SortBlock::OurLessThan
-// -----------------------------------------------------------------------------
+void SortBlock::doTopK () {
+  // the rows kept so far are stored in chunks of DefaultBatchSize rows. all 
+  // values in there are private copies, so a row can be overwritten when a
+  // better one arrives, and the input blocks can be freed right away
+  std::vector<AqlItemBlock*> chunks;
+  // the slots of the kept rows, organized as a heap with the worst row first
+  std::vector<size_t> heap;
+  // the arrival number of the row in each slot, used to break ties
+  std::vector<uint64_t> arrival;
+  // the sort key of the row in each slot
+  std::vector<std::string> keys;
+  std::string rowKey;
+  uint64_t seen = 0;
+  RegisterId nrRegs = 0;
+
+  auto location = [&chunks] (size_t slot) -> std::pair<AqlItemBlock*, size_t> {
+    return std::make_pair(chunks[slot / DefaultBatchSize], slot % DefaultBatchSize);
+  };
 
-bool SortBlock::OurLessThan::operator() (std::pair<size_t, size_t> const& a,
-                                         std::pair<size_t, size_t> const& b) {
+  // whether the row in slot a sorts before the row in slot b. breaking ties
+  // by arrival keeps the result stable
+  auto before = [&] (size_t a, size_t b) -> bool {
+    int cmp = keys[a].compare(keys[b]);
 
-  size_t i = 0;
-  for (auto reg : _sortRegisters) {
-
-    int cmp = AqlValue::Compare(
-      _trx,
-      _buffer[a.first]->getValue(a.second, reg.first),
-      _colls[i],
-      _buffer[b.first]->getValue(b.second, reg.first),
-      _colls[i],
-      true
-    );
-    
-    if (cmp == -1) {
-      return reg.second;
-    } 
-    else if (cmp == 1) {
-      return ! reg.second;
+    if (cmp != 0) {
+      return cmp < 0;
+    }
+    return arrival[a] < arrival[b];
+  };
+
+  auto copyRow = [&] (AqlItemBlock const* src, size_t row, size_t slot) -> void {
+    auto dst = location(slot);
+
+    for (RegisterId j = 0; j < nrRegs; j++) {
+      dst.first->destroyValue(dst.second, j);
+
+      AqlValue const& a = src->getValueReference(row, j);
+
+      if (! a.isEmpty()) {
+        AqlValue b = a.clone();
+        try {
+          dst.first->setValue(dst.second, j, b);
+        }
+        catch (...) {
+          b.destroy();
+          throw;
+        }
+      }
+    }
+  };
+
+  try {
+    while (getBlock(DefaultBatchSize, DefaultBatchSize)) {
+      AqlItemBlock* cur = _buffer.front();
+      
+      TRI_IF_FAILURE("SortBlock::doTopK") {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+      }
+
+      nrRegs = cur->getNrRegs();
+
+      for (size_t i = 0; i < cur->size(); i++, seen++) {
+        buildSortKey(_sortRegisters, cur, i, true, rowKey);
+
+        if (heap.size() < _limit) {
+          size_t const slot = heap.size();
+
+          if (slot % DefaultBatchSize == 0) {
+            auto chunk = new AqlItemBlock((std::min)(_limit - slot, DefaultBatchSize), nrRegs);
+            try {
+              chunks.emplace_back(chunk);
+            }
+            catch (...) {
+              delete chunk;
+              throw;
+            }
+            for (RegisterId j = 0; j < nrRegs; j++) {
+              chunk->setDocumentCollection(j, cur->getDocumentCollection(j));
+            }
+          }
+
+          arrival.emplace_back(seen);
+          keys.emplace_back(std::move(rowKey));
+          heap.emplace_back(slot);
+          copyRow(cur, i, slot);
+          std::push_heap(heap.begin(), heap.end(), before);
+          continue;
+        }
+        
+        if (rowKey < keys[heap.front()]) {
+          // the new row replaces the worst one kept so far
+          std::pop_heap(heap.begin(), heap.end(), before);
+          size_t const slot = heap.back();
+          copyRow(cur, i, slot);
+          arrival[slot] = seen;
+          keys[slot].swap(rowKey);
+          std::push_heap(heap.begin(), heap.end(), before);
+        }
+      }
+
+      // rows not kept are freed together with their block
+      delete cur;
+      _buffer.pop_front();
+    }
+
+    std::sort_heap(heap.begin(), heap.end(), before);
+
+    // move the kept rows into _buffer in sorted order
+    size_t const n = heap.size();
+    size_t count = 0;
+
+    while (count < n) {
+      size_t const sizeNext = (std::min)(n - count, DefaultBatchSize);
+      std::unique_ptr<AqlItemBlock> next(new AqlItemBlock(sizeNext, nrRegs));
+
+      for (RegisterId j = 0; j < nrRegs; j++) {
+        next->setDocumentCollection(j, chunks[0]->getDocumentCollection(j));
+      }
+
+      for (size_t i = 0; i < sizeNext; i++) {
+        auto src = location(heap[count + i]);
+
+        for (RegisterId j = 0; j < nrRegs; j++) {
+          AqlValue a = src.first->getValue(src.second, j);
+
+          if (! a.isEmpty()) {
+            // each value in the chunks is referenced exactly once, so it
+            // can be handed over to the new block
+            src.first->steal(a);
+            try {
+              next->setValue(i, j, a);
+            }
+            catch (...) {
+              a.destroy();
+              throw;
+            }
+            src.first->eraseValue(src.second, j);
+          }
+        }
+      }
+
+      _buffer.emplace_back(next.get());
+      next.release();
+      count += sizeNext;
+    }
+  }
+  catch (...) {
+    for (auto x : chunks) {
+      delete x;
     }
-    i++;
+    throw;
   }
 
-  return false;
+  for (auto x : chunks) {
+    delete x;
+  }
 }
 
-// -----------------------------------------------------------------------------
-// --SECTION--                                                  class LimitBlock
-// -----------------------------------------------------------------------------
+int SortBlock::shutdown (int errorCode) {
+  clearRuns();
 
-int LimitBlock::initialize () {
-  int res = ExecutionBlock::initialize();
+  return ExecutionBlock::shutdown(errorCode);
+}
 
-  if (res != TRI_ERROR_NO_ERROR) {
-    return res;
+bool SortBlock::hasMore () {
+  if (! _merging) {
+    return ExecutionBlock::hasMore();
   }
-  return TRI_ERROR_NO_ERROR;
+  return ! _mergeHeap.empty();
 }
 
-int LimitBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
-  int res = ExecutionBlock::initializeCursor(items, pos);
-  if (res != TRI_ERROR_NO_ERROR) {
-    return res;
+int64_t SortBlock::remaining () {
+  if (! _merging) {
+    return ExecutionBlock::remaining();
   }
-  _state = 0;
-  _count = 0;
-  return TRI_ERROR_NO_ERROR;
+  return _mergeRemaining;
 }
 
-int LimitBlock::getOrSkipSome (size_t atLeast,
-                               size_t atMost,
-                               bool skipping,
-                               AqlItemBlock*& result,
-                               size_t& skipped) {
+int SortBlock::getOrSkipSome (size_t atLeast,
+                              size_t atMost,
+                              bool skipping,
+                              AqlItemBlock*& result,
+                              size_t& skipped) {
+  if (! _merging) {
+    return ExecutionBlock::getOrSkipSome(atLeast, atMost, skipping, result, skipped);
+  }
 
   TRI_ASSERT(result == nullptr && skipped == 0);
 
-  if (_state == 2) {
+  if (_done || _mergeHeap.empty()) {
+    _done = true;
     return TRI_ERROR_NO_ERROR;
   }
 
-  if (_state == 0) {
-    if (_fullCount) {
-      // properly initialize fullcount value, which has a default of -1
-      if (_engine->_stats.fullCount == -1) {
-        _engine->_stats.fullCount = 0;
-      }
-      _engine->_stats.fullCount += static_cast<int64_t>(_offset);
-    }
+  RegisterId const nrRegs = _mergeBlocks[_mergeHeap.front()]->getNrRegs();
+  std::unique_ptr<AqlItemBlock> res;
 
-    if (_offset > 0) {
-      ExecutionBlock::_dependencies[0]->skip(_offset);
-    }
-    _state = 1;
+  if (! skipping) {
+    res.reset(new AqlItemBlock(atMost, nrRegs));
+  }
+
+  skipped = mergeRows(atMost, res.get());
+
+  if (_mergeHeap.empty()) {
+    _done = true;
+  }
+
+  if (! skipping) {
+    if (skipped < atMost) {
+      res->shrink(skipped);
+    }
+    result = res.release();
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+void SortBlock::spillRun () {
+  if (_runs.size() >= MaxMergeRuns) {
+    // merge the existing runs first, so that the number of open files
+    // stays bounded no matter how large the input is
+    compactRuns();
+  }
+
+  doSorting();
+
+  auto run = new SpillFile();
+  try {
+    _runs.emplace_back(run);
+  }
+  catch (...) {
+    delete run;
+    throw;
+  }
+
+  for (auto block : _buffer) {
+    run->write(_trx, block);
+    _mergeRemaining += static_cast<int64_t>(block->size());
+  }
+
+  _engine->_stats.spilledBytes += run->size();
+
+  for (auto x : _buffer) {
+    delete x;
+  }
+  _buffer.clear();
+}
+
+void SortBlock::compactRuns () {
+  int64_t const total = _mergeRemaining;
+
+  std::unique_ptr<SpillFile> merged(new SpillFile());
+
+  startMerge();
+
+  RegisterId const nrRegs = _mergeBlocks[_mergeHeap.front()]->getNrRegs();
+
+  while (! _mergeHeap.empty()) {
+    std::unique_ptr<AqlItemBlock> block(new AqlItemBlock(DefaultBatchSize, nrRegs));
+    size_t const n = mergeRows(DefaultBatchSize, block.get());
+
+    if (n < DefaultBatchSize) {
+      block->shrink(n);
+    }
+    merged->write(_trx, block.get());
+  }
+
+  _engine->_stats.spilledBytes += merged->size();
+
+  // the merged run replaces all others. as it holds the rows of the
+  // earlier runs in their merge order, a stable sort stays stable
+  clearRuns();
+  _runs.emplace_back(merged.get());
+  merged.release();
+  _mergeRemaining = total;
+}
+
+void SortBlock::startMerge () {
+  size_t const n = _runs.size();
+
+  _mergeBlocks.resize(n, nullptr);
+  _mergePos.resize(n, 0);
+  _mergeKeys.resize(n);
+  _mergeHeap.reserve(n);
+
+  for (size_t i = 0; i < n; i++) {
+    _runs[i]->rewind();
+    _mergeBlocks[i] = _runs[i]->read();
+    TRI_ASSERT(_mergeBlocks[i] != nullptr);
+    buildSortKey(_sortRegisters, _mergeBlocks[i], 0, true, _mergeKeys[i]);
+    _mergeHeap.emplace_back(i);
+  }
+
+  std::make_heap(_mergeHeap.begin(), _mergeHeap.end(), [this] (size_t a, size_t b) -> bool {
+    return mergeAfter(a, b);
+  });
+
+  _merging = true;
+}
+
+size_t SortBlock::mergeRows (size_t atMost,
+                             AqlItemBlock* result) {
+  auto after = [this] (size_t a, size_t b) -> bool {
+    return mergeAfter(a, b);
+  };
+
+  size_t produced = 0;
+
+  while (produced < atMost && ! _mergeHeap.empty()) {
+    std::pop_heap(_mergeHeap.begin(), _mergeHeap.end(), after);
+    size_t const run = _mergeHeap.back();
+    AqlItemBlock* cur = _mergeBlocks[run];
+    size_t const pos = _mergePos[run];
+
+    if (result != nullptr) {
+      RegisterId const nrRegs = cur->getNrRegs();
+
+      for (RegisterId j = 0; j < nrRegs; j++) {
+        AqlValue const& a = cur->getValueReference(pos, j);
+
+        if (! a.isEmpty()) {
+          // values read back from a run may be shared between rows, so
+          // they are copied rather than stolen
+          AqlValue b = a.clone();
+          try {
+            result->setValue(produced, j, b);
+          }
+          catch (...) {
+            b.destroy();
+            throw;
+          }
+        }
+      }
+    }
+
+    produced++;
+    _mergeRemaining--;
+
+    if (++_mergePos[run] == cur->size()) {
+      // advance to the next block of this run
+      delete cur;
+      _mergeBlocks[run] = nullptr;
+      _mergeBlocks[run] = _runs[run]->read();
+      _mergePos[run] = 0;
+    }
+
+    if (_mergeBlocks[run] == nullptr) {
+      _mergeHeap.pop_back();
+    }
+    else {
+      buildSortKey(_sortRegisters, _mergeBlocks[run], _mergePos[run], true, _mergeKeys[run]);
+      std::push_heap(_mergeHeap.begin(), _mergeHeap.end(), after);
+    }
+  }
+
+  return produced;
+}
+
+bool SortBlock::mergeAfter (size_t a, 
+                            size_t b) const {
+  int cmp = _mergeKeys[a].compare(_mergeKeys[b]);
+
+  if (cmp != 0) {
+    return cmp > 0;
+  }
+  // ties are broken by run number, so that a stable sort stays stable
+  return a > b;
+}
+
+void SortBlock::clearRuns () {
+  for (auto x : _mergeBlocks) {
+    delete x;
+  }
+  _mergeBlocks.clear();
+  _mergePos.clear();
+  _mergeKeys.clear();
+  _mergeHeap.clear();
+
+  for (auto x : _runs) {
+    delete x;
+  }
+  _runs.clear();
+
+  _mergeRemaining = 0;
+  _merging = false;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  class LimitBlock
+// -----------------------------------------------------------------------------
+
+int LimitBlock::initialize () {
+  int res = ExecutionBlock::initialize();
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+  return TRI_ERROR_NO_ERROR;
+}
+
+int LimitBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
+  int res = ExecutionBlock::initializeCursor(items, pos);
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+  _state = 0;
+  _count = 0;
+  return TRI_ERROR_NO_ERROR;
+}
+
+int LimitBlock::getOrSkipSome (size_t atLeast,
+                               size_t atMost,
+                               bool skipping,
+                               AqlItemBlock*& result,
+                               size_t& skipped) {
+
+  TRI_ASSERT(result == nullptr && skipped == 0);
+
+  if (_state == 2) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  if (_state == 0) {
+    if (_fullCount) {
+      // properly initialize fullcount value, which has a default of -1
+      if (_engine->_stats.fullCount == -1) {
+        _engine->_stats.fullCount = 0;
+      }
+      _engine->_stats.fullCount += static_cast<int64_t>(_offset);
+    }
+
+    if (_offset > 0) {
+      ExecutionBlock::_dependencies[0]->skip(_offset);
+    }
+    _state = 1;
     _count = 0;
     if (_limit == 0 && ! _fullCount) {
       // quick exit for limit == 0
@@ -4289,7 +5403,7 @@ int ModificationBlock::extractKey (AqlValue const& value,
 void ModificationBlock::constructMptr (TRI_doc_mptr_copy_t* dst,
                                        TRI_df_marker_t const* marker) const { 
   dst->_rid = TRI_EXTRACT_MARKER_RID(marker);
-  dst->_fid = 0;
+  dst->_fidNumber = 0;
   dst->_hash = 0;
   dst->_prev = nullptr;
   dst->_next = nullptr;
@@ -5293,6 +6407,7 @@ int GatherBlock::shutdown (int errorCode) {
     }
     _gatherBlockBuffer.clear();
     _gatherBlockPos.clear();
+    _gatherBlockKeys.clear();
   }
     
   return TRI_ERROR_NO_ERROR;
@@ -5322,6 +6437,7 @@ int GatherBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
     }
     _gatherBlockBuffer.clear();
     _gatherBlockPos.clear();
+    _gatherBlockKeys.clear();
     
     _gatherBlockBuffer.reserve(_dependencies.size());
     _gatherBlockPos.reserve(_dependencies.size());
@@ -5329,6 +6445,7 @@ int GatherBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
       _gatherBlockBuffer.emplace_back(); 
       _gatherBlockPos.emplace_back(make_pair(i, 0)); 
     }
+    _gatherBlockKeys.resize(_dependencies.size());
   }
 
   _done = false;
@@ -5418,21 +6535,45 @@ AqlItemBlock* GatherBlock::getSome (size_t atLeast, size_t atMost) {
 
   // the simple case . . .  
   if (_isSimple) {
-    auto res = _dependencies.at(_atDep)->getSome(atLeast, atMost);
-    while (res == nullptr && _atDep < _dependencies.size() - 1) {
-      _atDep++;
-      res = _dependencies.at(_atDep)->getSome(atLeast, atMost);
-    }
-    if (res == nullptr) {
-      _done = true;
+    // let all remaining shards work concurrently, and take the data of the
+    // first one that has answered. the order does not matter here
+    prefetchDependencies(_atDep, atLeast, atMost);
+
+    while (true) {
+      size_t which = _atDep;
+
+      for (size_t i = _atDep; i < _dependencies.size(); i++) {
+        if (isDependencyReady(i)) {
+          which = i;
+          break;
+        }
+      }
+
+      auto res = _dependencies.at(which)->profiledGetSome(atLeast, atMost);
+
+      if (res != nullptr) {
+        return res;
+      }
+
+      // an exhausted dependency other than _atDep will not be ready again,
+      // and will be skipped quickly once _atDep gets there
+      if (which == _atDep) {
+        if (_atDep == _dependencies.size() - 1) {
+          _done = true;
+          return nullptr;
+        }
+        _atDep++;
+      }
     }
-    return res;
   }
  
   // the non-simple case . . .
   size_t available = 0; // nr of available rows
   size_t index = 0;     // an index of a non-empty buffer
   
+  // let all shards work concurrently . . .
+  prefetchDependencies(0, atLeast, atMost);
+
   // pull more blocks from dependencies . . .
   for (size_t i = 0; i < _dependencies.size(); i++) {
     
@@ -5462,18 +6603,16 @@ AqlItemBlock* GatherBlock::getSome (size_t atLeast, size_t atMost) {
   
   size_t toSend = (std::min)(available, atMost); // nr rows in outgoing block
   
-  // get collections for ourLessThan . . .
-  std::vector<TRI_document_collection_t const*> colls;
-  for (RegisterId i = 0; i < _sortRegisters.size(); i++) {
-    colls.emplace_back(_gatherBlockBuffer.at(index).front()->
-        getDocumentCollection(_sortRegisters[i].first));
+  // get the sort keys of the current rows for ourLessThan . . .
+  for (size_t i = 0; i < _dependencies.size(); i++) {
+    updateSortKey(i);
   }
   
   // the following is similar to AqlItemBlock's slice method . . .
   std::unordered_map<AqlValue, AqlValue> cache;
   
   // comparison function 
-  OurLessThan ourLessThan(_trx, _gatherBlockBuffer, _sortRegisters, colls);
+  OurLessThan ourLessThan(_gatherBlockBuffer, _gatherBlockKeys);
   AqlItemBlock* example =_gatherBlockBuffer.at(index).front();
   size_t nrRegs = example->getNrRegs();
 
@@ -5522,6 +6661,7 @@ AqlItemBlock* GatherBlock::getSome (size_t atLeast, size_t atMost) {
       _gatherBlockBuffer.at(val.first).pop_front();
       _gatherBlockPos.at(val.first) = make_pair(val.first, 0);
     }
+    updateSortKey(val.first);
   }
 
   return res.release();
@@ -5540,10 +6680,10 @@ size_t GatherBlock::skipSome (size_t atLeast, size_t atMost) {
 
   // the simple case . . .  
   if (_isSimple) {
-    auto skipped = _dependencies.at(_atDep)->skipSome(atLeast, atMost);
+    auto skipped = _dependencies.at(_atDep)->profiledSkipSome(atLeast, atMost);
     while (skipped == 0 && _atDep < _dependencies.size() - 1) {
       _atDep++;
-      skipped = _dependencies.at(_atDep)->skipSome(atLeast, atMost);
+      skipped = _dependencies.at(_atDep)->profiledSkipSome(atLeast, atMost);
     }
     if (skipped == 0) {
       _done = true;
@@ -5553,20 +6693,18 @@ size_t GatherBlock::skipSome (size_t atLeast, size_t atMost) {
 
   // the non-simple case . . .
   size_t available = 0; // nr of available rows
-  size_t index = 0;     // an index of a non-empty buffer
   TRI_ASSERT(_dependencies.size() != 0); 
 
+  // let all shards work concurrently . . .
+  prefetchDependencies(0, atLeast, atMost);
+
   // pull more blocks from dependencies . . .
   for (size_t i = 0; i < _dependencies.size(); i++) {
     if (_gatherBlockBuffer.at(i).empty()) {
       if (getBlock(i, atLeast, atMost)) {
-        index = i;
         _gatherBlockPos.at(i) = make_pair(i, 0);           
       }
     } 
-    else {
-      index = i;
-    }
 
     auto cur = _gatherBlockBuffer.at(i);
     if (! cur.empty()) {
@@ -5584,15 +6722,13 @@ size_t GatherBlock::skipSome (size_t atLeast, size_t atMost) {
   
   size_t skipped = (std::min)(available, atMost); //nr rows in outgoing block
   
-  // get collections for ourLessThan . . .
-  std::vector<TRI_document_collection_t const*> colls;
-  for (RegisterId i = 0; i < _sortRegisters.size(); i++) {
-    colls.emplace_back(_gatherBlockBuffer.at(index).front()->
-        getDocumentCollection(_sortRegisters[i].first));
+  // get the sort keys of the current rows for ourLessThan . . .
+  for (size_t i = 0; i < _dependencies.size(); i++) {
+    updateSortKey(i);
   }
   
   // comparison function 
-  OurLessThan ourLessThan(_trx, _gatherBlockBuffer, _sortRegisters, colls);
+  OurLessThan ourLessThan(_gatherBlockBuffer, _gatherBlockKeys);
 
   for (size_t i = 0; i < skipped; i++) {
     // get the next smallest row from the buffer . . .
@@ -5608,6 +6744,7 @@ size_t GatherBlock::skipSome (size_t atLeast, size_t atMost) {
       _gatherBlockBuffer.at(val.first).pop_front();
       _gatherBlockPos.at(val.first) = make_pair(val.first, 0);
     }
+    updateSortKey(val.first);
   }
 
   return skipped;
@@ -5623,7 +6760,7 @@ bool GatherBlock::getBlock (size_t i, size_t atLeast, size_t atMost) {
   ENTER_BLOCK
   TRI_ASSERT(i < _dependencies.size());
   TRI_ASSERT(! _isSimple);
-  AqlItemBlock* docs = _dependencies.at(i)->getSome(atLeast, atMost);
+  AqlItemBlock* docs = _dependencies.at(i)->profiledGetSome(atLeast, atMost);
   if (docs != nullptr) {
     try {
       _gatherBlockBuffer.at(i).emplace_back(docs);
@@ -5639,6 +6776,39 @@ bool GatherBlock::getBlock (size_t i, size_t atLeast, size_t atMost) {
   LEAVE_BLOCK
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts fetching from all remote dependencies from the given one on
+////////////////////////////////////////////////////////////////////////////////
+
+void GatherBlock::prefetchDependencies (size_t from, size_t atLeast, size_t atMost) {
+  ENTER_BLOCK
+  for (size_t i = from; i < _dependencies.size(); i++) {
+    auto dep = _dependencies.at(i);
+
+    if (dep->getPlanNode()->getType() == ExecutionNode::REMOTE) {
+      static_cast<RemoteBlock*>(dep)->prefetch(atLeast, atMost);
+    }
+  }
+  LEAVE_BLOCK
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not dependency i can deliver data without waiting
+////////////////////////////////////////////////////////////////////////////////
+
+bool GatherBlock::isDependencyReady (size_t i) const {
+  ENTER_BLOCK
+  auto dep = _dependencies.at(i);
+
+  if (dep->getPlanNode()->getType() == ExecutionNode::REMOTE) {
+    return static_cast<RemoteBlock const*>(dep)->isReady();
+  }
+
+  // local dependencies never wait for the network
+  return false;
+  LEAVE_BLOCK
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief OurLessThan: comparison method for elements of _gatherBlockPos
 ////////////////////////////////////////////////////////////////////////////////
@@ -5653,28 +6823,21 @@ bool GatherBlock::OurLessThan::operator() (std::pair<size_t, size_t> const& a,
     return true;
   }
 
-  size_t i = 0;
-  for (auto reg : _sortRegisters) {
-
-    int cmp = AqlValue::Compare(
-      _trx,
-      _gatherBlockBuffer.at(a.first).front()->getValue(a.second, reg.first),
-      _colls[i],
-      _gatherBlockBuffer.at(b.first).front()->getValue(b.second, reg.first),
-      _colls[i],
-      true
-    );
-
-    if (cmp == -1) {
-      return reg.second;
-    } 
-    else if (cmp == 1) {
-      return ! reg.second;
-    }
-    i++;
+  return _gatherBlockKeys[a.first] < _gatherBlockKeys[b.first];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recompute the sort key of the current row of dependency i
+////////////////////////////////////////////////////////////////////////////////
+
+void GatherBlock::updateSortKey (size_t i) {
+  if (_gatherBlockBuffer.at(i).empty()) {
+    _gatherBlockKeys.at(i).clear();
+    return;
   }
 
-  return false;
+  buildSortKey(_sortRegisters, _gatherBlockBuffer.at(i).front(), 
+               _gatherBlockPos.at(i).second, true, _gatherBlockKeys.at(i));
 }
 
 // -----------------------------------------------------------------------------
@@ -6536,6 +7699,61 @@ static bool throwExceptionAfterBadSyncRequest (ClusterCommResult* res,
   LEAVE_BLOCK
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief local helper to throw an exception if an asynchronous HTTP request
+/// went wrong
+////////////////////////////////////////////////////////////////////////////////
+
+static void throwExceptionAfterBadAsyncRequest (ClusterCommResult* res) {
+  ENTER_BLOCK
+  if (res->status == CL_COMM_TIMEOUT) {
+    std::string errorMessage = std::string("Timeout in communication with shard '") + 
+      std::string(res->shardID) + 
+      std::string("' on cluster node '") +
+      std::string(res->serverID) +
+      std::string("' failed.");
+    
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CLUSTER_TIMEOUT,
+                                   errorMessage);
+  }
+
+  if (res->status != CL_COMM_RECEIVED || res->answer == nullptr) {
+    std::string errorMessage = std::string("Communication with shard '") + 
+      std::string(res->shardID) + 
+      std::string("' on cluster node '") +
+      std::string(res->serverID) +
+      std::string("' failed: ") +
+      res->errorMessage;
+
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CLUSTER_CONNECTION_LOST,
+                                   errorMessage);
+  }
+
+  if (res->answer_code == triagens::rest::HttpResponse::OK) {
+    return;
+  }
+
+  // the DBserver reported an error, extract error number and message
+  Json responseBodyJson(TRI_UNKNOWN_MEM_ZONE,
+                        TRI_JsonString(TRI_UNKNOWN_MEM_ZONE,
+                                       res->answer->body()));
+
+  int errorNum = JsonHelper::getNumericValue<int>(responseBodyJson.json(), "errorNum", TRI_ERROR_INTERNAL);
+  std::string errorMessage = std::string("Error message received from shard '") + 
+    std::string(res->shardID) + 
+    std::string("' on cluster node '") +
+    std::string(res->serverID) +
+    std::string("': ") +
+    JsonHelper::getStringValue(responseBodyJson.json(), "errorMessage", "(no valid error in response)");
+
+  if (errorNum == TRI_ERROR_NO_ERROR) {
+    errorNum = TRI_ERROR_CLUSTER_AQL_COMMUNICATION;
+  }
+
+  THROW_ARANGO_EXCEPTION_MESSAGE(errorNum, errorMessage);
+  LEAVE_BLOCK
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief timeout
 ////////////////////////////////////////////////////////////////////////////////
@@ -6554,7 +7772,11 @@ RemoteBlock::RemoteBlock (ExecutionEngine* engine,
   : ExecutionBlock(engine, en),
     _server(server),
     _ownName(ownName),
-    _queryId(queryId) {
+    _queryId(queryId),
+    _prefetch(ownName.empty()),
+    _exhausted(false),
+    _pendingTransactionId(0),
+    _pendingOperationId(0) {
 
   TRI_ASSERT(! queryId.empty());
   TRI_ASSERT_EXPENSIVE((triagens::arango::ServerState::instance()->isCoordinator() && ownName.empty()) ||
@@ -6562,6 +7784,10 @@ RemoteBlock::RemoteBlock (ExecutionEngine* engine,
 }
 
 RemoteBlock::~RemoteBlock () {
+  if (_pendingOperationId != 0) {
+    // nobody is interested in the answer anymore
+    ClusterComm::instance()->drop("AQL", _pendingTransactionId, _pendingOperationId, "");
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -6582,14 +7808,14 @@ ClusterCommResult* RemoteBlock::sendRequest (
   if (! _ownName.empty()) {
     headers.emplace(make_pair("Shard-Id", _ownName));
   }
+  // getSome results are then sent in binary, other operations ignore this
+  headers.emplace(make_pair("Accept", AqlItemBlock::BinaryContentType));
 
   auto result = cc->syncRequest(clientTransactionId,
                                 coordTransactionId,
                                 _server,
                                 type,
-                                std::string("/_db/") 
-                                + triagens::basics::StringUtils::urlEncode(_engine->getQuery()->trx()->vocbase()->_name)
-                                + urlPart + _queryId,
+                                buildUrl(urlPart),
                                 body,
                                 headers,
                                 defaultTimeOut);
@@ -6598,6 +7824,212 @@ ClusterCommResult* RemoteBlock::sendRequest (
   LEAVE_BLOCK
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds the URL for a request to the remote query
+////////////////////////////////////////////////////////////////////////////////
+
+std::string RemoteBlock::buildUrl (std::string const& urlPart) const {
+  return std::string("/_db/") 
+         + triagens::basics::StringUtils::urlEncode(_engine->getQuery()->trx()->vocbase()->_name)
+         + urlPart + _queryId;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends an asynchronous getSome request
+////////////////////////////////////////////////////////////////////////////////
+
+void RemoteBlock::startGetSome (size_t atLeast,
+                                size_t atMost) {
+  ENTER_BLOCK
+  TRI_ASSERT(_pendingOperationId == 0);
+  TRI_ASSERT(_buffer.empty());
+
+  Json body(Json::Object, 2);
+  body("atLeast", Json(static_cast<double>(atLeast)))
+      ("atMost", Json(static_cast<double>(atMost)));
+
+  std::unique_ptr<std::string> bodyString(new std::string(body.toString()));
+  std::unique_ptr<std::map<std::string, std::string>> headers(new std::map<std::string, std::string>);
+
+  if (! _ownName.empty()) {
+    headers->emplace(make_pair("Shard-Id", _ownName));
+  }
+  headers->emplace(make_pair("Accept", AqlItemBlock::BinaryContentType));
+
+  ClusterComm* cc = ClusterComm::instance();
+  CoordTransactionID const coordTransactionId = TRI_NewTickServer();
+
+  // ClusterComm takes over the body and the headers
+  std::unique_ptr<ClusterCommResult> res(cc->asyncRequest("AQL",
+                                                          coordTransactionId,
+                                                          _server,
+                                                          rest::HttpRequest::HTTP_REQUEST_PUT,
+                                                          buildUrl("/_api/aql/getSome/"),
+                                                          bodyString.release(),
+                                                          true,
+                                                          headers.release(),
+                                                          nullptr,
+                                                          defaultTimeOut));
+
+  _pendingTransactionId = coordTransactionId;
+  _pendingOperationId = res->operationID;
+  LEAVE_BLOCK
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits for the asynchronous getSome request and buffers its result
+////////////////////////////////////////////////////////////////////////////////
+
+void RemoteBlock::collectGetSome () {
+  ENTER_BLOCK
+  TRI_ASSERT(_pendingOperationId != 0);
+
+  ClusterComm* cc = ClusterComm::instance();
+  std::unique_ptr<ClusterCommResult> res(cc->wait("AQL",
+                                                  _pendingTransactionId,
+                                                  _pendingOperationId,
+                                                  "",
+                                                  defaultTimeOut));
+
+  if (res->status == CL_COMM_TIMEOUT) {
+    // the answer may still come in, it must not stay in the queues then
+    cc->drop("AQL", _pendingTransactionId, _pendingOperationId, "");
+  }
+
+  _pendingOperationId = 0;
+
+  throwExceptionAfterBadAsyncRequest(res.get());
+
+  bool found;
+  char const* contentType = res->answer->header("content-type", found);
+
+  AqlItemBlock* block = processGetSomeResponse(res->answer->body(),
+                                               res->answer->bodySize(),
+                                               found && contentType != nullptr &&
+                                               AqlItemBlock::BinaryContentType == contentType);
+
+  if (block == nullptr) {
+    _exhausted = true;
+    return;
+  }
+
+  try {
+    _buffer.emplace_back(block);
+  }
+  catch (...) {
+    delete block;
+    throw;
+  }
+  LEAVE_BLOCK
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits for the request in flight and throws away all buffered data
+////////////////////////////////////////////////////////////////////////////////
+
+void RemoteBlock::discardPrefetched () {
+  ENTER_BLOCK
+  if (_pendingOperationId != 0) {
+    collectGetSome();
+  }
+
+  for (auto it : _buffer) {
+    delete it;
+  }
+  _buffer.clear();
+  _pos = 0;
+  _exhausted = false;
+  LEAVE_BLOCK
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turns the body of a getSome response into a block
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* RemoteBlock::processGetSomeResponse (char const* body,
+                                                   size_t length,
+                                                   bool binary) {
+  ENTER_BLOCK
+  if (binary) {
+    // flags byte, statistics, then the block itself
+    char const* p = body;
+    char const* end = body + length;
+
+    if (p >= end) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "malformed binary getSome response");
+    }
+
+    bool exhausted = (*p++ != 0);
+    TRI_json_t* stats = TRI_DecodeBinaryJson(TRI_UNKNOWN_MEM_ZONE, &p, end);
+
+    if (stats == nullptr) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "malformed binary getSome response");
+    }
+
+    ExecutionStats newStats(Json(TRI_UNKNOWN_MEM_ZONE, stats));
+
+    _engine->_stats.addDelta(_deltaStats, newStats);
+    _deltaStats = newStats;
+
+    if (exhausted) {
+      return nullptr;
+    }
+
+    return AqlItemBlock::fromBinary(&p, end);
+  }
+
+  Json responseBodyJson(TRI_UNKNOWN_MEM_ZONE,
+                        TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, body));
+
+  ExecutionStats newStats(responseBodyJson.get("stats"));
+  
+  _engine->_stats.addDelta(_deltaStats, newStats);
+  _deltaStats = newStats;
+  
+  if (JsonHelper::getBooleanValue(responseBodyJson.json(), "exhausted", true)) {
+    return nullptr;
+  }
+    
+  return new triagens::aql::AqlItemBlock(responseBodyJson);
+  LEAVE_BLOCK
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts fetching the next block in the background
+////////////////////////////////////////////////////////////////////////////////
+
+void RemoteBlock::prefetch (size_t atLeast,
+                            size_t atMost) {
+  ENTER_BLOCK
+  if (_prefetch &&
+      _pendingOperationId == 0 &&
+      _buffer.empty() &&
+      ! _exhausted) {
+    startGetSome(atLeast, atMost);
+  }
+  LEAVE_BLOCK
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not getSome can return without waiting for the network
+////////////////////////////////////////////////////////////////////////////////
+
+bool RemoteBlock::isReady () const {
+  ENTER_BLOCK
+  if (! _buffer.empty()) {
+    return true;
+  }
+
+  if (_pendingOperationId == 0) {
+    return false;
+  }
+
+  std::unique_ptr<ClusterCommResult const> res(ClusterComm::instance()->enquire(_pendingOperationId));
+
+  return (res != nullptr && res->status >= CL_COMM_TIMEOUT);
+  LEAVE_BLOCK
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief initialize
 ////////////////////////////////////////////////////////////////////////////////
@@ -6620,6 +8052,9 @@ int RemoteBlock::initialize () {
 
 int RemoteBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
   ENTER_BLOCK
+  // the remote query must not be busy with a getSome when it is reset
+  discardPrefetched();
+
   // For every call we simply forward via HTTP
 
   Json body(Json::Object, 4);
@@ -6660,6 +8095,14 @@ int RemoteBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
 
 int RemoteBlock::shutdown (int errorCode) {
   ENTER_BLOCK
+  // the remote query must not be busy with a getSome when it is shut down,
+  // but an error in the prefetched answer is of no interest anymore
+  try {
+    discardPrefetched();
+  }
+  catch (...) {
+  }
+
   // For every call we simply forward via HTTP
 
   std::unique_ptr<ClusterCommResult> res;
@@ -6707,36 +8150,73 @@ int RemoteBlock::shutdown (int errorCode) {
 AqlItemBlock* RemoteBlock::getSome (size_t atLeast,
                                     size_t atMost) {
   ENTER_BLOCK
-  // For every call we simply forward via HTTP
+  if (! _prefetch) {
+    // For every call we simply forward via HTTP
+
+    Json body(Json::Object, 2);
+    body("atLeast", Json(static_cast<double>(atLeast)))
+        ("atMost", Json(static_cast<double>(atMost)));
+    std::string bodyString(body.toString());
+
+    std::unique_ptr<ClusterCommResult> res;
+    res.reset(sendRequest(rest::HttpRequest::HTTP_REQUEST_PUT,
+                          "/_api/aql/getSome/",
+                          bodyString));
+    throwExceptionAfterBadSyncRequest(res.get(), false);
+
+    // If we get here, then res->result is the response which will be
+    // a serialized AqlItemBlock:
+    bool found;
+    std::string const& contentType = res->result->getHeaderField("content-type", found);
+    StringBuffer const& responseBodyBuf(res->result->getBody());
+    return processGetSomeResponse(responseBodyBuf.c_str(),
+                                  responseBodyBuf.length(),
+                                  found && contentType == AqlItemBlock::BinaryContentType);
+  }
 
-  Json body(Json::Object, 2);
-  body("atLeast", Json(static_cast<double>(atLeast)))
-      ("atMost", Json(static_cast<double>(atMost)));
-  std::string bodyString(body.toString());
+  if (_buffer.empty()) {
+    if (_pendingOperationId == 0) {
+      if (_exhausted) {
+        return nullptr;
+      }
+      startGetSome(atLeast, atMost);
+    }
 
-  std::unique_ptr<ClusterCommResult> res;
-  res.reset(sendRequest(rest::HttpRequest::HTTP_REQUEST_PUT,
-                        "/_api/aql/getSome/",
-                        bodyString));
-  throwExceptionAfterBadSyncRequest(res.get(), false);
+    collectGetSome();
 
-  // If we get here, then res->result is the response which will be
-  // a serialized AqlItemBlock:
-  StringBuffer const& responseBodyBuf(res->result->getBody());
-  Json responseBodyJson(TRI_UNKNOWN_MEM_ZONE,
-                        TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, 
-                                       responseBodyBuf.begin()));
+    if (_buffer.empty()) {
+      // remote side is exhausted
+      return nullptr;
+    }
+  }
 
-  ExecutionStats newStats(responseBodyJson.get("stats"));
-  
-  _engine->_stats.addDelta(_deltaStats, newStats);
-  _deltaStats = newStats;
-  
-  if (JsonHelper::getBooleanValue(responseBodyJson.json(), "exhausted", true)) {
-    return nullptr;
+  // hand out the buffered block, or a part of it if it is too big
+  AqlItemBlock* cur = _buffer.front();
+  std::unique_ptr<AqlItemBlock> result;
+
+  if (_pos == 0 && cur->size() <= atMost) {
+    _buffer.pop_front();
+    result.reset(cur);
   }
-    
-  return new triagens::aql::AqlItemBlock(responseBodyJson);
+  else {
+    size_t to = (std::min)(cur->size(), _pos + atMost);
+    result.reset(cur->slice(_pos, to));
+
+    if (to == cur->size()) {
+      delete cur;
+      _buffer.pop_front();
+      _pos = 0;
+    }
+    else {
+      _pos = to;
+    }
+  }
+
+  // let the remote side work on the next block while our caller works on
+  // this one
+  prefetch(atLeast, atMost);
+
+  return result.release();
   LEAVE_BLOCK
 }
 
@@ -6746,6 +8226,37 @@ AqlItemBlock* RemoteBlock::getSome (size_t atLeast,
 
 size_t RemoteBlock::skipSome (size_t atLeast, size_t atMost) {
   ENTER_BLOCK
+  if (_prefetch) {
+    if (_pendingOperationId != 0) {
+      collectGetSome();
+    }
+
+    // skip over buffered data first
+    if (! _buffer.empty()) {
+      size_t skipped = 0;
+
+      while (skipped < atMost && ! _buffer.empty()) {
+        AqlItemBlock* cur = _buffer.front();
+        size_t n = (std::min)(cur->size() - _pos, atMost - skipped);
+
+        skipped += n;
+        _pos += n;
+
+        if (_pos == cur->size()) {
+          delete cur;
+          _buffer.pop_front();
+          _pos = 0;
+        }
+      }
+
+      return skipped;
+    }
+
+    if (_exhausted) {
+      return 0;
+    }
+  }
+
   // For every call we simply forward via HTTP
 
   Json body(Json::Object, 2);
@@ -6780,6 +8291,20 @@ size_t RemoteBlock::skipSome (size_t atLeast, size_t atMost) {
 
 bool RemoteBlock::hasMore () {
   ENTER_BLOCK
+  if (_prefetch) {
+    if (_pendingOperationId != 0) {
+      collectGetSome();
+    }
+
+    if (! _buffer.empty()) {
+      return true;
+    }
+
+    if (_exhausted) {
+      return false;
+    }
+  }
+
   // For every call we simply forward via HTTP
   std::unique_ptr<ClusterCommResult> res;
   res.reset(sendRequest(rest::HttpRequest::HTTP_REQUEST_GET,
@@ -6806,6 +8331,12 @@ bool RemoteBlock::hasMore () {
 
 int64_t RemoteBlock::count () const {
   ENTER_BLOCK
+  // the remote query must not be busy with a getSome. the answer is buffered,
+  // which does not change the logical state of the block
+  if (_pendingOperationId != 0) {
+    const_cast<RemoteBlock*>(this)->collectGetSome();
+  }
+
   // For every call we simply forward via HTTP
   std::unique_ptr<ClusterCommResult> res;
   res.reset(sendRequest(rest::HttpRequest::HTTP_REQUEST_GET,
@@ -6833,6 +8364,19 @@ int64_t RemoteBlock::count () const {
 
 int64_t RemoteBlock::remaining () {
   ENTER_BLOCK
+  int64_t buffered = 0;
+
+  if (_prefetch) {
+    if (_pendingOperationId != 0) {
+      collectGetSome();
+    }
+
+    for (auto it : _buffer) {
+      buffered += static_cast<int64_t>(it->size());
+    }
+    buffered -= static_cast<int64_t>(_pos);
+  }
+
   // For every call we simply forward via HTTP
   std::unique_ptr<ClusterCommResult> res;
   res.reset(sendRequest(rest::HttpRequest::HTTP_REQUEST_GET,
@@ -6850,7 +8394,7 @@ int64_t RemoteBlock::remaining () {
     THROW_ARANGO_EXCEPTION(TRI_ERROR_CLUSTER_AQL_COMMUNICATION);
   }
   return JsonHelper::getNumericValue<int64_t>
-               (responseBodyJson.json(), "remaining", 0);
+               (responseBodyJson.json(), "remaining", 0) + buffered;
   LEAVE_BLOCK
 }
 
@@ -34,6 +34,7 @@
 #include "Aql/CollectionScanner.h"
 #include "Aql/ExecutionNode.h"
 #include "Aql/Range.h"
+#include "Aql/SpillFile.h"
 #include "Aql/WalkerWorker.h"
 #include "Aql/ExecutionStats.h"
 #include "Basics/StringBuffer.h"
@@ -93,7 +94,8 @@ namespace triagens {
       }
 
       void addValues (AqlItemBlock const* src, 
-                      RegisterId groupRegister);
+                      RegisterId groupRegister,
+                      RegisterId countRegister = ExecutionNode::MaxRegisterId);
     };
 
 // -----------------------------------------------------------------------------
@@ -256,6 +258,18 @@ namespace triagens {
                                AqlItemBlock* dst,
                                size_t,
                                size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the normalized sort key of the values of a row in the given
+/// registers (true = ascending | false = descending). keys of rows compare
+/// with memcmp in the order the rows are sorted in
+////////////////////////////////////////////////////////////////////////////////
+
+        void buildSortKey (std::vector<std::pair<RegisterId, bool>> const&,
+                           AqlItemBlock const*,
+                           size_t,
+                           bool,
+                           std::string&) const;
         
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief the following is internal to pull one more block and append it to
@@ -298,6 +312,32 @@ namespace triagens {
         // skipping, and <false> otherwise . . .
         bool skip (size_t number);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief entry points used by parent blocks and the engine. these call
+/// initializeCursor, getSome and skipSome and account the call in the
+/// profile of the block if the query is profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        int profiledInitializeCursor (AqlItemBlock* items, size_t pos);
+
+        AqlItemBlock* profiledGetSome (size_t atLeast, size_t atMost);
+
+        size_t profiledSkipSome (size_t atLeast, size_t atMost);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turn on profiling for the block
+////////////////////////////////////////////////////////////////////////////////
+
+        void enableProfiling ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the profile of the block, nullptr if it is not profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        ExecutionBlockProfile const* profile () const {
+          return _profile;
+        }
+
         virtual bool hasMore ();
 
         virtual int64_t count () const {
@@ -346,6 +386,13 @@ namespace triagens {
 
         std::vector<ExecutionBlock*> _dependencies;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execution profile of the block, nullptr if the query is not
+/// profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        ExecutionBlockProfile* _profile;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief this is our buffer for the items, it is a deque of AqlItemBlocks.
 /// We keep the following invariant between this and the other two variables
@@ -509,12 +556,45 @@ namespace triagens {
 
         size_t skipSome (size_t atLeast, size_t atMost) override final;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up the filters for a parallel scan, returns false if the
+/// collection must be scanned sequentially
+////////////////////////////////////////////////////////////////////////////////
+
+        bool setupParallelScan (EnumerateCollectionNode const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evaluate the filter condition of the parallel scan for a document.
+/// this is called concurrently by the scan threads, each partition has its
+/// own filter
+////////////////////////////////////////////////////////////////////////////////
+
+        bool matchesScanFilter (size_t, 
+                                TRI_doc_mptr_t const*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
 
       private:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief filter condition of a parallel scan, with the arguments for its
+/// evaluation
+////////////////////////////////////////////////////////////////////////////////
+
+        struct ScanFilter {
+          Expression* expression;
+          std::vector<AqlValue> argv;
+          std::vector<TRI_document_collection_t const*> docColls;
+        };
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -527,6 +607,27 @@ namespace triagens {
 
         CollectionScanner* _scanner;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the collection scanner if the scan is done in parallel, nullptr
+/// otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+        ParallelCollectionScanner* _parallelScanner;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief filter conditions of a parallel scan, one for each partition
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<ScanFilter> _scanFilters;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief variable and register the filter conditions are evaluated with
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Variable*> _scanFilterVars;
+
+        std::vector<RegisterId> _scanFilterRegs;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief document buffer
 ////////////////////////////////////////////////////////////////////////////////
@@ -624,6 +725,25 @@ namespace triagens {
         
         bool initRanges ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the iterator for the current index and _condition
+////////////////////////////////////////////////////////////////////////////////
+
+        bool initIndexIterator ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read from the current index, depending on its type
+////////////////////////////////////////////////////////////////////////////////
+
+        void readCurrentIndex (size_t atMost);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read the results of all lookups of a multi-index node at once and
+/// unite or intersect them
+////////////////////////////////////////////////////////////////////////////////
+
+        void readMultiIndex ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read using the primary index
 ////////////////////////////////////////////////////////////////////////////////
@@ -678,6 +798,19 @@ namespace triagens {
 
         void readSkiplistIndex (size_t atMost);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the value of the out variable for an index-only scan from
+/// the values of the indexed attributes, in the order of the index fields
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_json_t* buildProjection (TRI_shaped_json_t const*) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the values built for an index-only scan
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearProjections ();
+
 ////////////////////////////////////////////////////////////////////////////////
 // @brief: sorts the index range conditions and resets _posInRanges to 0
 ////////////////////////////////////////////////////////////////////////////////
@@ -703,7 +836,7 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief: subclass for comparing IndexAndConditions in _condition. Similar to
-/// OurLessThan in the SortBlock
+/// OurLessThan in the GatherBlock
 ////////////////////////////////////////////////////////////////////////////////
 
         class SortFunc {
@@ -737,12 +870,40 @@ namespace triagens {
 
         Collection const* _collection;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the index currently read. this is the index of the plan node,
+/// unless one of the other lookups of a multi-index node is carried out
+////////////////////////////////////////////////////////////////////////////////
+
+        Index const* _currentIndex;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the indexes and conditions of the other lookups of a multi-index
+/// node. the conditions are owned by the block
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::pair<Index const*, IndexOrCondition*>> _otherConditions;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief document buffer
 ////////////////////////////////////////////////////////////////////////////////
 
         std::vector<TRI_doc_mptr_copy_t> _documents;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief values of the out variable for an index-only scan, one for each
+/// entry in _documents
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_json_t*> _projections;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief positions and attribute paths of the index fields that make up
+/// the value of an index-only scan. fields below another field are left out
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::pair<size_t, std::vector<std::string>>> _projectionFields;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief current position in _allDocs
 ////////////////////////////////////////////////////////////////////////////////
@@ -1084,6 +1245,34 @@ namespace triagens {
 
         void destroySubqueryResults (std::vector<AqlItemBlock*>*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the key of the outer variables of a row. rows get the same
+/// key only if the subquery cannot tell their values apart
+////////////////////////////////////////////////////////////////////////////////
+
+        void buildMemoizeKey (AqlItemBlock const*,
+                              size_t,
+                              std::string&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remember the results of a block's subquery executions for later
+/// blocks
+////////////////////////////////////////////////////////////////////////////////
+
+        void memoizeResults (std::unordered_map<std::string, std::pair<AqlValue, bool>> const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy all memoized results
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearMemoizedResults ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of subquery results kept across blocks
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxMemoizedResults;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief output register
 ////////////////////////////////////////////////////////////////////////////////
@@ -1095,6 +1284,27 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         ExecutionBlock* _subquery;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the subquery results can be reused for input rows with the
+/// same values of the outer variables
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _memoize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief registers of the outer variables used in the subquery. empty if
+/// the subquery is constant
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<RegisterId> _inRegs;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief subquery results kept across blocks, by the key of the outer
+/// variables. the values are owned by the block
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<std::string, AqlValue> _memoized;
     };
 
 // -----------------------------------------------------------------------------
@@ -1200,6 +1410,20 @@ namespace triagens {
 
         std::vector<std::pair<RegisterId, RegisterId>> _aggregateRegisters;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the in registers, in the form buildSortKey expects them
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::pair<RegisterId, bool>> _groupKeyRegisters;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief key of the values of the current group and of the current row
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _groupKey;
+
+        std::string _rowKey;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief details about the current group
 ////////////////////////////////////////////////////////////////////////////////
@@ -1221,6 +1445,13 @@ namespace triagens {
 
         RegisterId _groupRegister;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the optional register with partial counts that are summed up
+/// instead of counting rows. if not used, this has a value of MaxRegisterId
+////////////////////////////////////////////////////////////////////////////////
+
+        RegisterId _countRegister;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief list of variables names for the registers
 ////////////////////////////////////////////////////////////////////////////////
@@ -1267,6 +1498,13 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         RegisterId _groupRegister;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the optional register with partial counts that are summed up
+/// instead of counting rows. if not used, this has a value of MaxRegisterId
+////////////////////////////////////////////////////////////////////////////////
+
+        RegisterId _countRegister;
         
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief hasher for a vector of AQL values
@@ -1324,6 +1562,22 @@ namespace triagens {
 
         virtual int initializeCursor (AqlItemBlock* items, size_t pos);
 
+        int shutdown (int) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getOrSkipSome, reads from the merged runs if the input was spilled
+////////////////////////////////////////////////////////////////////////////////
+
+        int getOrSkipSome (size_t atLeast,
+                           size_t atMost,
+                           bool skipping,
+                           AqlItemBlock*& result,
+                           size_t& skipped) override;
+
+        bool hasMore () override;
+
+        int64_t remaining () override;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief dosorting
 ////////////////////////////////////////////////////////////////////////////////
@@ -1333,31 +1587,51 @@ namespace triagens {
         void doSorting ();
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief OurLessThan
+/// @brief sort the rows in _buffer, write them to a new run and free them
 ////////////////////////////////////////////////////////////////////////////////
 
-        class OurLessThan {
+        void spillRun ();
 
-          public:
-            OurLessThan (triagens::arango::AqlTransaction* trx,
-                         std::deque<AqlItemBlock*>& buffer,
-                         std::vector<std::pair<RegisterId, bool>>& sortRegisters,
-                         std::vector<TRI_document_collection_t const*>& colls)
-              : _trx(trx),
-                _buffer(buffer),
-                _sortRegisters(sortRegisters),
-                _colls(colls) {
-            }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief merge all runs written so far into a single run
+////////////////////////////////////////////////////////////////////////////////
 
-            bool operator() (std::pair<size_t, size_t> const& a,
-                             std::pair<size_t, size_t> const& b);
+        void compactRuns ();
 
-          private:
-            triagens::arango::AqlTransaction* _trx;
-            std::deque<AqlItemBlock*>& _buffer;
-            std::vector<std::pair<RegisterId, bool>>& _sortRegisters;
-            std::vector<TRI_document_collection_t const*>& _colls;
-        };
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read the first block of every run and set up the merge heap
+////////////////////////////////////////////////////////////////////////////////
+
+        void startMerge ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief produce up to atMost rows of the merge, copying them into result
+/// unless it is a nullptr. returns the number of rows produced
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t mergeRows (size_t atMost,
+                          AqlItemBlock* result);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove all runs and the state of a merge
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearRuns ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief heap order for the merge, whether the current row of run a must be
+/// produced after the current row of run b
+////////////////////////////////////////////////////////////////////////////////
+
+        bool mergeAfter (size_t, 
+                         size_t) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief keep only the best _limit rows of the input and put them into
+/// _buffer in sorted order
+////////////////////////////////////////////////////////////////////////////////
+
+        void doTopK ();
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief pairs, consisting of variable and sort direction
@@ -1372,6 +1646,63 @@ namespace triagens {
 
         bool _stable;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows to produce, 0 means all
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _limit;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows buffered before a sorted run is written to disk,
+/// 0 means never
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _spillThreshold;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of runs merged at once. every run keeps a file
+/// open while it is merged, so when this many runs exist they are merged
+/// into one before the next run is written
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxMergeRuns;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the sorted runs written so far
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<SpillFile*> _runs;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief current block, position in it and sort key of the row there for
+/// each run while merging
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<AqlItemBlock*> _mergeBlocks;
+
+        std::vector<size_t> _mergePos;
+
+        std::vector<std::string> _mergeKeys;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the runs that still have rows, as a heap with the run holding the
+/// smallest current row first
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<size_t> _mergeHeap;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows not yet produced by the merge
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t _mergeRemaining;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the output comes from merging runs instead of _buffer
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _merging;
+
     };
 
 // -----------------------------------------------------------------------------
@@ -1894,6 +2225,19 @@ namespace triagens {
         
         bool getBlock (size_t i, size_t atLeast, size_t atMost);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts fetching from all remote dependencies from the given one
+/// on, so that the shards work concurrently
+////////////////////////////////////////////////////////////////////////////////
+
+        void prefetchDependencies (size_t from, size_t atLeast, size_t atMost);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not dependency i can deliver data without waiting
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isDependencyReady (size_t i) const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief _gatherBlockBuffer: buffer the incoming block from each dependency
 /// separately 
@@ -1937,25 +2281,32 @@ namespace triagens {
         class OurLessThan {
 
           public:
-            OurLessThan (triagens::arango::AqlTransaction* trx,
-                         std::vector<std::deque<AqlItemBlock*>>& gatherBlockBuffer,
-                         std::vector<std::pair<RegisterId, bool>>& sortRegisters,
-                         std::vector<TRI_document_collection_t const*>& colls)
-              : _trx(trx),
-                _gatherBlockBuffer(gatherBlockBuffer),
-                _sortRegisters(sortRegisters),
-                _colls(colls) {
+            OurLessThan (std::vector<std::deque<AqlItemBlock*>>& gatherBlockBuffer,
+                         std::vector<std::string>& gatherBlockKeys)
+              : _gatherBlockBuffer(gatherBlockBuffer),
+                _gatherBlockKeys(gatherBlockKeys) {
             }
 
             bool operator() (std::pair<size_t, size_t> const& a,
                              std::pair<size_t, size_t> const& b);
 
           private:
-            triagens::arango::AqlTransaction* _trx;
             std::vector<std::deque<AqlItemBlock*>>& _gatherBlockBuffer;
-            std::vector<std::pair<RegisterId, bool>>& _sortRegisters;
-            std::vector<TRI_document_collection_t const*>& _colls;
+            std::vector<std::string>& _gatherBlockKeys;
         };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief _gatherBlockKeys: the sort key of the current row of each 
+/// dependency, empty if there is no current row
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> _gatherBlockKeys;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recompute the sort key of the current row of dependency i
+////////////////////////////////////////////////////////////////////////////////
+
+        void updateSortKey (size_t i);
     };
 
 // -----------------------------------------------------------------------------
@@ -2398,6 +2749,22 @@ namespace triagens {
 
         int64_t remaining () override final;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts fetching the next block in the background
+///
+/// This does nothing if a request is already in flight, if there is still
+/// buffered data, or if the remote side is exhausted.
+////////////////////////////////////////////////////////////////////////////////
+
+        void prefetch (size_t atLeast,
+                       size_t atMost);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not getSome can return without waiting for the network
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isReady () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief internal method to send a request
 ////////////////////////////////////////////////////////////////////////////////
@@ -2409,6 +2776,41 @@ namespace triagens {
                   std::string const& urlPart,
                   std::string const& body) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds the URL for a request to the remote query
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string buildUrl (std::string const& urlPart) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends an asynchronous getSome request
+////////////////////////////////////////////////////////////////////////////////
+
+        void startGetSome (size_t atLeast,
+                           size_t atMost);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits for the asynchronous getSome request and buffers its result
+////////////////////////////////////////////////////////////////////////////////
+
+        void collectGetSome ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits for the request in flight and throws away all buffered data
+////////////////////////////////////////////////////////////////////////////////
+
+        void discardPrefetched ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turns the body of a getSome response into a block, returns a
+/// nullptr if the remote side is exhausted. the body is either JSON or the
+/// binary representation, depending on the content type of the response
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* processGetSomeResponse (char const* body,
+                                              size_t length,
+                                              bool binary);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief our server, can be like "shard:S1000" or like "server:Claus"
 ////////////////////////////////////////////////////////////////////////////////
@@ -2433,8 +2835,28 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         ExecutionStats _deltaStats;
-        
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not blocks are fetched ahead of time. this is done on
+/// the coordinator only
+////////////////////////////////////////////////////////////////////////////////
+
+        bool const _prefetch;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the remote side reported that it is exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _exhausted;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief transaction and operation id of the getSome request in flight,
+/// the operation id is 0 if there is none
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::arango::CoordTransactionID _pendingTransactionId;
+
+        triagens::arango::OperationID _pendingOperationId;
     };
 
   }  // namespace triagens::aql
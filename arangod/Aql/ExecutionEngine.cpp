@@ -1071,8 +1071,15 @@ ExecutionEngine* ExecutionEngine::instanciateFromPlan (QueryRegistry* queryRegis
 
     TRI_ASSERT(root != nullptr);
     engine->_root = root;
+
+    if (query->profiling()) {
+      for (auto block : engine->_blocks) {
+        block->enableProfiling();
+      }
+    }
+
     root->initialize();
-    root->initializeCursor(nullptr, 0);
+    root->profiledInitializeCursor(nullptr, 0);
   
     return engine;
   }
@@ -1094,6 +1101,67 @@ void ExecutionEngine::addBlock (ExecutionBlock* block) {
   _blocks.emplace_back(block);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the per-block profiles, one entry per profiled block
+/// the inclusive times of a block contain the times of its dependencies (and
+/// of its subquery), which are subtracted to get the block's own times
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json ExecutionEngine::profileToJson () const {
+  triagens::basics::Json result(triagens::basics::Json::Array, _blocks.size());
+
+  for (auto block : _blocks) {
+    auto profile = block->profile();
+
+    if (profile == nullptr) {
+      continue;
+    }
+
+    uint64_t rowsIn  = 0;
+    double innerTime = 0.0;
+    double innerCpu  = 0.0;
+
+    for (auto dependency : block->getDependencies()) {
+      auto p = dependency->profile();
+
+      if (p != nullptr) {
+        rowsIn    += p->rowsOut;
+        innerTime += p->time;
+        innerCpu  += p->cpuTime;
+      }
+    }
+
+    // the subquery is executed from within the block, but its results are
+    // not input rows of the block
+    auto subqueryBlock = dynamic_cast<SubqueryBlock*>(block);
+
+    if (subqueryBlock != nullptr && 
+        subqueryBlock->getSubquery() != nullptr &&
+        subqueryBlock->getSubquery()->profile() != nullptr) {
+      auto p = subqueryBlock->getSubquery()->profile();
+      innerTime += p->time;
+      innerCpu  += p->cpuTime;
+    }
+
+    auto node = block->getPlanNode();
+
+    result.add(triagens::basics::Json(triagens::basics::Json::Object, 11)
+      ("id", triagens::basics::Json(static_cast<double>(node->id())))
+      ("type", triagens::basics::Json(node->getTypeString()))
+      ("getSomeCalls", triagens::basics::Json(static_cast<double>(profile->getSomeCalls)))
+      ("skipSomeCalls", triagens::basics::Json(static_cast<double>(profile->skipSomeCalls)))
+      ("rowsIn", triagens::basics::Json(static_cast<double>(rowsIn)))
+      ("rowsOut", triagens::basics::Json(static_cast<double>(profile->rowsOut)))
+      ("time", triagens::basics::Json(profile->time))
+      ("selfTime", triagens::basics::Json((std::max)(0.0, profile->time - innerTime)))
+      ("cpuTime", triagens::basics::Json(profile->cpuTime))
+      ("selfCpuTime", triagens::basics::Json((std::max)(0.0, profile->cpuTime - innerCpu)))
+      ("peakMemory", triagens::basics::Json(static_cast<double>(profile->peakMemory))));
+  }
+
+  return result;
+}
+
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
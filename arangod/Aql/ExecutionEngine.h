@@ -112,7 +112,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         int initializeCursor (AqlItemBlock* items, size_t pos) {
-          return _root->initializeCursor(items, pos);
+          return _root->profiledInitializeCursor(items, pos);
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -149,7 +149,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         AqlItemBlock* getSome (size_t atLeast, size_t atMost) {
-          return _root->getSome(atLeast, atMost);
+          return _root->profiledGetSome(atLeast, atMost);
         }
         
 ////////////////////////////////////////////////////////////////////////////////
@@ -157,7 +157,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         size_t skipSome (size_t atLeast, size_t atMost) {
-          return _root->skipSome(atLeast, atMost);
+          return _root->profiledSkipSome(atLeast, atMost);
         }
         
 ////////////////////////////////////////////////////////////////////////////////
@@ -165,7 +165,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         AqlItemBlock* getOne () {
-          return _root->getSome(1, 1);
+          return _root->profiledGetSome(1, 1);
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -206,6 +206,12 @@ namespace triagens {
 
         void addBlock (ExecutionBlock*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the per-block profiles, one entry per profiled block
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Json profileToJson () const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
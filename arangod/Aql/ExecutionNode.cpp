@@ -185,14 +185,21 @@ ExecutionNode* ExecutionNode::fromJsonFactory (ExecutionPlan* plan,
 
       bool count = JsonHelper::checkAndGetBooleanValue(oneNode.json(), "count");
 
-      return new AggregateNode(plan,
-                               oneNode,
-                               expressionVariable,
-                               outVariable,
-                               keepVariables,
-                               plan->getAst()->variables()->variables(false),
-                               aggregateVariables,  
-                               count);
+      auto node = new AggregateNode(plan,
+                                    oneNode,
+                                    expressionVariable,
+                                    outVariable,
+                                    keepVariables,
+                                    plan->getAst()->variables()->variables(false),
+                                    aggregateVariables,  
+                                    count);
+
+      Variable* countVariable = varFromJson(plan->getAst(), oneNode, "countVariable", Optional);
+      if (countVariable != nullptr) {
+        node->setCountVariable(countVariable);
+      }
+
+      return node;
     }
     case INSERT:
       return new InsertNode(plan, oneNode);
@@ -1166,7 +1173,8 @@ EnumerateCollectionNode::EnumerateCollectionNode (ExecutionPlan* plan,
     _vocbase(plan->getAst()->query()->vocbase()),
     _collection(plan->getAst()->query()->collections()->get(JsonHelper::checkAndGetStringValue(base.json(), "collection"))),
     _outVariable(varFromJson(plan->getAst(), base, "outVariable")),
-    _random(JsonHelper::checkAndGetBooleanValue(base.json(), "random")) {
+    _random(JsonHelper::checkAndGetBooleanValue(base.json(), "random")),
+    _parallel(JsonHelper::getBooleanValue(base.json(), "parallel", false)) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1186,7 +1194,8 @@ void EnumerateCollectionNode::toJsonHelper (triagens::basics::Json& nodes,
   json("database", triagens::basics::Json(_vocbase->_name))
       ("collection", triagens::basics::Json(_collection->getName()))
       ("outVariable", _outVariable->toJson())
-      ("random", triagens::basics::Json(_random));
+      ("random", triagens::basics::Json(_random))
+      ("parallel", triagens::basics::Json(_parallel));
 
   // And add it:
   nodes(json);
@@ -1206,6 +1215,7 @@ ExecutionNode* EnumerateCollectionNode::clone (ExecutionPlan* plan,
   }
     
   auto c = new EnumerateCollectionNode(plan, _id, _vocbase, _collection, outVariable, _random);
+  c->_parallel = _parallel;
 
   CloneHelper(c, plan, withDependencies, withProperties);
 
@@ -1488,6 +1498,30 @@ void IndexRangeNode::toJsonHelper (triagens::basics::Json& nodes,
  
   json("index", _index->toJson()); 
   json("reverse", triagens::basics::Json(_reverse));
+  json("indexOnly", triagens::basics::Json(_indexOnly));
+
+  if (! _otherLookups.empty()) {
+    triagens::basics::Json lookups(triagens::basics::Json::Array, _otherLookups.size());
+
+    for (auto const& lookup : _otherLookups) {
+      triagens::basics::Json lookupRanges(triagens::basics::Json::Array, lookup.ranges.size());
+
+      for (auto const& x : lookup.ranges) {
+        triagens::basics::Json range(triagens::basics::Json::Array, x.size());
+        for (auto const& y : x) {
+          range.add(y.toJson());
+        }
+        lookupRanges.add(range);
+      }
+
+      lookups.add(triagens::basics::Json(triagens::basics::Json::Object)
+                    ("index", lookup.index->toJson())
+                    ("ranges", lookupRanges));
+    }
+
+    json("otherLookups", lookups);
+    json("intersect", triagens::basics::Json(_intersect));
+  }
 
   // And add it:
   nodes(json);
@@ -1513,6 +1547,8 @@ ExecutionNode* IndexRangeNode::clone (ExecutionPlan* plan,
 
   auto c = new IndexRangeNode(plan, _id, _vocbase, _collection, 
                               outVariable, _index, ranges, _reverse);
+  c->_indexOnly = _indexOnly;
+  c->otherLookups(_otherLookups, _intersect);
 
   CloneHelper(c, plan, withDependencies, withProperties);
 
@@ -1531,7 +1567,10 @@ IndexRangeNode::IndexRangeNode (ExecutionPlan* plan,
     _outVariable(varFromJson(plan->getAst(), json, "outVariable")),
     _index(nullptr), 
     _ranges(),
-    _reverse(false) {
+    _reverse(false),
+    _indexOnly(false),
+    _otherLookups(),
+    _intersect(false) {
 
   triagens::basics::Json rangeArrayJson(TRI_UNKNOWN_MEM_ZONE, JsonHelper::checkAndGetArrayValue(json.json(), "ranges"));
 
@@ -1552,10 +1591,42 @@ IndexRangeNode::IndexRangeNode (ExecutionPlan* plan,
 
   _index = _collection->getIndex(iid);
   _reverse = JsonHelper::checkAndGetBooleanValue(json.json(), "reverse");
+  _indexOnly = JsonHelper::getBooleanValue(json.json(), "indexOnly", false);
 
   if (_index == nullptr) {
     THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "index not found");
   }
+
+  triagens::basics::Json lookups = json.get("otherLookups");
+
+  if (lookups.isArray()) {
+    for (size_t i = 0; i < lookups.size(); ++i) {
+      triagens::basics::Json lookupJson(lookups.at(static_cast<int>(i)));
+
+      auto lookupIndex = JsonHelper::checkAndGetObjectValue(lookupJson.json(), "index");
+      auto index = _collection->getIndex(JsonHelper::checkAndGetStringValue(lookupIndex, "id"));
+
+      if (index == nullptr) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "index not found");
+      }
+      
+      std::vector<std::vector<RangeInfo>> ranges;
+      triagens::basics::Json lookupRanges(TRI_UNKNOWN_MEM_ZONE, JsonHelper::checkAndGetArrayValue(lookupJson.json(), "ranges"));
+
+      for (size_t j = 0; j < lookupRanges.size(); j++) {
+        ranges.emplace_back();
+
+        triagens::basics::Json rangeJson(lookupRanges.at(static_cast<int>(j)));
+        for (size_t k = 0; k < rangeJson.size(); k++) {
+          ranges.back().emplace_back(rangeJson.at(static_cast<int>(k)));
+        }
+      }
+
+      _otherLookups.emplace_back(index, ranges);
+    }
+
+    _intersect = JsonHelper::getBooleanValue(json.json(), "intersect", false);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1563,6 +1634,11 @@ IndexRangeNode::IndexRangeNode (ExecutionPlan* plan,
 ////////////////////////////////////////////////////////////////////////////////
 
 ExecutionNode::IndexMatch IndexRangeNode::matchesIndex (IndexMatchVec const& pattern) const {
+  if (isMultiIndex()) {
+    // the combined results of multiple lookups are not sorted by any index
+    return IndexMatch();
+  }
+
   return CompareIndex(this, _index, pattern);
 }
 
@@ -1572,49 +1648,91 @@ ExecutionNode::IndexMatch IndexRangeNode::matchesIndex (IndexMatchVec const& pat
 ////////////////////////////////////////////////////////////////////////////////
  
 double IndexRangeNode::estimateCost (size_t& nrItems) const { 
-  static double const EqualityReductionFactor = 100.0;
-
   size_t incoming = 0;
   double const dependencyCost = _dependencies.at(0)->getCost(incoming);
+  
+  double cost = estimateLookupCost(_index, _ranges, incoming, nrItems);
+
+  if (_otherLookups.empty()) {
+    return dependencyCost + cost;
+  }
+
+  // multiple lookups. all of them need to be carried out
+  size_t const total = (std::max)(incoming * _collection->count(), static_cast<size_t>(1));
+  size_t sum = nrItems;
+  double fraction = static_cast<double>(nrItems) / static_cast<double>(total);
+
+  for (auto const& lookup : _otherLookups) {
+    size_t items = 0;
+    cost += estimateLookupCost(lookup.index, lookup.ranges, incoming, items);
+    sum += items;
+    // assume the conditions are independent
+    fraction *= static_cast<double>(items) / static_cast<double>(total);
+  }
+
+  if (_intersect) {
+    nrItems = static_cast<size_t>(fraction * static_cast<double>(total));
+  }
+  else {
+    nrItems = (std::min)(sum, total);
+  }
+
+  nrItems = (std::max)(nrItems, static_cast<size_t>(1));
+
+  // combining the lookups requires another pass over their results
+  return dependencyCost + cost + static_cast<double>(sum) * 0.1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimate the cost and number of items for a single index lookup,
+/// not including the cost of the dependencies
+////////////////////////////////////////////////////////////////////////////////
+
+double IndexRangeNode::estimateLookupCost (Index const* index,
+                                           std::vector<std::vector<RangeInfo>> const& ranges,
+                                           size_t incoming,
+                                           size_t& nrItems) const {
+  static double const EqualityReductionFactor = 100.0;
+
   size_t docCount = _collection->count();
 
-  TRI_ASSERT(! _ranges.empty());
+  TRI_ASSERT(! ranges.empty());
   
-  if (_index->type == TRI_IDX_TYPE_PRIMARY_INDEX) {
+  if (index->type == TRI_IDX_TYPE_PRIMARY_INDEX) {
     // always an equality lookup
 
     // selectivity of primary index is always 1
-    nrItems = incoming * _ranges.size();
-    return dependencyCost + nrItems;
+    nrItems = incoming * ranges.size();
+    return nrItems;
   }
   
-  if (_index->type == TRI_IDX_TYPE_EDGE_INDEX) {
+  if (index->type == TRI_IDX_TYPE_EDGE_INDEX) {
     // always an equality lookup
     
     // check if the index can provide a selectivity estimate
-    if (! estimateItemsWithIndexSelectivity(incoming, nrItems)) {
+    if (! estimateItemsWithIndexSelectivity(index, ranges.size(), incoming, nrItems)) {
       // use hard-coded heuristic
-      nrItems = incoming * _ranges.size() * docCount / static_cast<size_t>(EqualityReductionFactor);
+      nrItems = incoming * ranges.size() * docCount / static_cast<size_t>(EqualityReductionFactor);
     }
         
     nrItems = (std::max)(nrItems, static_cast<size_t>(1));
 
-    return dependencyCost + nrItems;
+    return nrItems;
   }
 
-  if (_index->type == TRI_IDX_TYPE_HASH_INDEX) {
+  if (index->type == TRI_IDX_TYPE_HASH_INDEX) {
     // always an equality lookup
 
     // check if the index can provide a selectivity estimate
-    if (! estimateItemsWithIndexSelectivity(incoming, nrItems)) {
+    if (! estimateItemsWithIndexSelectivity(index, ranges.size(), incoming, nrItems)) {
       // use hard-coded heuristic
-      if (_index->unique) {
-        nrItems = incoming * _ranges.size();
+      if (index->unique) {
+        nrItems = incoming * ranges.size();
       }
       else {
-        double cost = static_cast<double>(docCount) * incoming * _ranges.size();
+        double cost = static_cast<double>(docCount) * incoming * ranges.size();
         // the more attributes are contained in the index, the more specific the lookup will be
-        for (size_t i = 0; i < _ranges.at(0).size(); ++i) { 
+        for (size_t i = 0; i < ranges.at(0).size(); ++i) { 
           cost /= EqualityReductionFactor; 
         }
     
@@ -1624,26 +1742,26 @@ double IndexRangeNode::estimateCost (size_t& nrItems) const {
         
     nrItems = (std::max)(nrItems, static_cast<size_t>(1));
     // the more attributes an index matches, the better it is
-    double matchLengthFactor = _ranges.at(0).size() * 0.01;
+    double matchLengthFactor = ranges.at(0).size() * 0.01;
 
     // this is to prefer the hash index over skiplists if everything else is equal
-    return dependencyCost + ((static_cast<double>(nrItems) - matchLengthFactor) * 0.9999995);
+    return ((static_cast<double>(nrItems) - matchLengthFactor) * 0.9999995);
   }
 
-  if (_index->type == TRI_IDX_TYPE_SKIPLIST_INDEX) {
-    auto const count = _ranges.at(0).size();
+  if (index->type == TRI_IDX_TYPE_SKIPLIST_INDEX) {
+    auto const count = ranges.at(0).size();
     
     if (count == 0) {
       // no ranges? so this is unlimited -> has to be more expensive
       nrItems = incoming * docCount;
-      return dependencyCost + nrItems;
+      return nrItems;
     }
 
-    if (_index->unique) {
+    if (index->unique) {
       bool allEquality = true;
-      for (auto const& x : _ranges) {
+      for (auto const& x : ranges) {
         // check if we are using all indexed attributes in the query
-        if (x.size() != _index->fields.size()) {
+        if (x.size() != index->fields.size()) {
           allEquality = false;
           break;
         }
@@ -1657,24 +1775,63 @@ double IndexRangeNode::estimateCost (size_t& nrItems) const {
 
       if (allEquality) {
         // unique index, all attributes compared using eq (==) operator
-        nrItems = incoming * _ranges.size();
-        return dependencyCost + nrItems;
+        nrItems = incoming * ranges.size();
+        return nrItems;
       }
     }
 
     // build a total cost for the index usage by peeking into all ranges
     double totalCost = 0.0;
 
-    for (auto const& x : _ranges) {
+    for (auto const& x : ranges) {
       double cost = static_cast<double>(docCount) * incoming;
+      size_t start = 0;
+
+      if (index->hasPrefixSelectivityEstimate()) {
+        // leading equality lookups are estimated from the distinct counts
+        // the index maintains for each prefix of its attributes
+        size_t numEqualities = 0;
+        while (numEqualities < x.size() && x[numEqualities].is1ValueRangeInfo()) {
+          ++numEqualities;
+        }
+
+        if (numEqualities > 0) {
+          double const estimate = index->prefixSelectivityEstimate(numEqualities);
+
+          if (estimate > 0.0) {
+            cost = static_cast<double>(incoming) / estimate;
+            start = numEqualities;
+          }
+        }
+      }
+
+      for (size_t i = start; i < x.size(); ++i) {
+        auto const& y = x[i];
 
-      for (auto const& y : x) { //only doing the 1-d case so far
         if (y.is1ValueRangeInfo()) {
           // equality lookup
           cost /= EqualityReductionFactor;
           continue;
         }
 
+        if (i == 0 && 
+            y.isValid() && 
+            y.isConstant() && 
+            index->hasRangeFractionEstimate()) {
+          // constant range on the first attribute, use the index histogram
+          double const fraction = index->rangeFractionEstimate(
+            y._lowConst.isDefined() ? y._lowConst.bound().json() : nullptr,
+            y._lowConst.inclusive(),
+            y._highConst.isDefined() ? y._highConst.bound().json() : nullptr,
+            y._highConst.inclusive()
+          );
+
+          if (fraction >= 0.0) {
+            cost *= fraction;
+            continue;
+          }
+        }
+
         bool hasLowerBound = false;
         bool hasUpperBound = false;
 
@@ -1713,12 +1870,12 @@ double IndexRangeNode::estimateCost (size_t& nrItems) const {
 
     nrItems = static_cast<size_t>(totalCost);
 
-    return dependencyCost + totalCost;
+    return totalCost;
   }
 
   // no index
   nrItems = incoming * docCount;
-  return dependencyCost + nrItems;
+  return nrItems;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1767,22 +1924,24 @@ std::vector<Variable const*> IndexRangeNode::getVariablesUsedHere () const {
 /// selectivity info (if present)
 ////////////////////////////////////////////////////////////////////////////////
 
-bool IndexRangeNode::estimateItemsWithIndexSelectivity (size_t incoming,
+bool IndexRangeNode::estimateItemsWithIndexSelectivity (Index const* index,
+                                                        size_t numRanges,
+                                                        size_t incoming,
                                                         size_t& nrItems) const {
   // check if the index can provide a selectivity estimate
-  if (! _index->hasSelectivityEstimate()) {
+  if (! index->hasSelectivityEstimate()) {
     return false; 
   }
 
   // use index selectivity estimate
-  double estimate = _index->selectivityEstimate();
+  double estimate = index->selectivityEstimate();
 
   if (estimate <= 0.0) {
     // avoid DIV0
     return false;
   }
 
-  nrItems = static_cast<size_t>(incoming * _ranges.size() * (1.0 / estimate));
+  nrItems = static_cast<size_t>(incoming * numRanges * (1.0 / estimate));
   return true;
 }
 
@@ -2061,6 +2220,59 @@ bool SubqueryNode::canThrow () {
   return finder._canThrow;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the subquery is deterministic. We have to look at
+/// all nodes in the subquery plan, including nested subqueries
+////////////////////////////////////////////////////////////////////////////////
+
+struct DeterministicFinder : public WalkerWorker<ExecutionNode> {
+  bool _isDeterministic;
+
+  DeterministicFinder () 
+    : _isDeterministic(true) {
+  }
+
+  ~DeterministicFinder () {
+  }
+
+  bool before (ExecutionNode* node) override final {
+    switch (node->getType()) {
+      case ExecutionNode::CALCULATION: {
+        if (! static_cast<CalculationNode*>(node)->expression()->isDeterministic()) {
+          _isDeterministic = false;
+        }
+        break;
+      }
+      case ExecutionNode::ENUMERATE_COLLECTION: {
+        if (static_cast<EnumerateCollectionNode*>(node)->isRandom()) {
+          _isDeterministic = false;
+        }
+        break;
+      }
+      case ExecutionNode::INSERT:
+      case ExecutionNode::REMOVE:
+      case ExecutionNode::REPLACE:
+      case ExecutionNode::UPDATE:
+      case ExecutionNode::UPSERT: {
+        _isDeterministic = false;
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+
+    return ! _isDeterministic;
+  }
+
+};
+
+bool SubqueryNode::isDeterministic () const {
+  DeterministicFinder finder;
+  _subquery->walk(&finder);
+  return finder._isDeterministic;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                             methods of FilterNode
 // -----------------------------------------------------------------------------
@@ -2132,7 +2344,8 @@ SortNode::SortNode (ExecutionPlan* plan,
                     bool stable)
   : ExecutionNode(plan, base),
     _elements(elements),
-    _stable(stable) {
+    _stable(stable),
+    _limit(JsonHelper::getNumericValue<size_t>(base.json(), "limit", 0)) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2156,6 +2369,7 @@ void SortNode::toJsonHelper (triagens::basics::Json& nodes,
   }
   json("elements", values);
   json("stable", triagens::basics::Json(_stable));
+  json("limit", triagens::basics::Json(static_cast<double>(_limit)));
 
   // And add it:
   nodes(json);
@@ -2293,6 +2507,12 @@ double SortNode::estimateCost (size_t& nrItems) const {
   if (nrItems <= 3.0) {
     return depCost + nrItems;
   }
+  if (_limit > 0 && _limit < nrItems) {
+    // top-k sort with a bounded heap
+    double cost = depCost + nrItems * log(static_cast<double>(_limit) + 1.0);
+    nrItems = _limit;
+    return cost;
+  }
   return depCost + nrItems * log(nrItems);
 }
 
@@ -2315,7 +2535,8 @@ AggregateNode::AggregateNode (ExecutionPlan* plan,
     _outVariable(outVariable),
     _keepVariables(keepVariables),
     _variableMap(variableMap),
-    _count(count) {
+    _count(count),
+    _countVariable(nullptr) {
 
 }
 
@@ -2364,6 +2585,11 @@ void AggregateNode::toJsonHelper (triagens::basics::Json& nodes,
   }
 
   json("count", triagens::basics::Json(_count));
+
+  // count variable might be empty
+  if (_countVariable != nullptr) {
+    json("countVariable", _countVariable->toJson());
+  }
   
   _options.toJson(json, zone);
 
@@ -2380,6 +2606,7 @@ ExecutionNode* AggregateNode::clone (ExecutionPlan* plan,
                                      bool withProperties) const {
   auto outVariable = _outVariable;
   auto expressionVariable = _expressionVariable;
+  auto countVariable = _countVariable;
   auto aggregateVariables = _aggregateVariables;
 
   if (withProperties) {
@@ -2387,6 +2614,10 @@ ExecutionNode* AggregateNode::clone (ExecutionPlan* plan,
       expressionVariable = plan->getAst()->variables()->createVariable(expressionVariable);
     }
 
+    if (countVariable != nullptr) {
+      countVariable = plan->getAst()->variables()->createVariable(countVariable);
+    }
+
     if (outVariable != nullptr) {
       outVariable = plan->getAst()->variables()->createVariable(outVariable);
     }
@@ -2411,6 +2642,10 @@ ExecutionNode* AggregateNode::clone (ExecutionPlan* plan,
                              _variableMap,
                              _count);
 
+  if (countVariable != nullptr) {
+    c->setCountVariable(countVariable);
+  }
+
   CloneHelper(c, plan, withDependencies, withProperties);
 
   return static_cast<ExecutionNode*>(c);
@@ -2463,6 +2698,10 @@ std::vector<Variable const*> AggregateNode::getVariablesUsedHere () const {
     v.insert(_expressionVariable);
   }
 
+  if (_countVariable != nullptr) {
+    v.insert(_countVariable);
+  }
+
   if (_outVariable != nullptr && ! _count) {
     if (_keepVariables.empty()) {
       // Here we have to find all user defined variables in this query
@@ -849,7 +849,8 @@ namespace triagens {
             _vocbase(vocbase), 
             _collection(collection),
             _outVariable(outVariable),  
-            _random(random) {
+            _random(random),
+            _parallel(false) {
           TRI_ASSERT(_vocbase != nullptr);
           TRI_ASSERT(_collection != nullptr);
           TRI_ASSERT(_outVariable != nullptr);
@@ -929,6 +930,30 @@ namespace triagens {
           _random = true;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the documents are iterated in random order
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isRandom () const {
+          return _random;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enable or disable the parallel scan of the collection
+////////////////////////////////////////////////////////////////////////////////
+
+        void parallel (bool value) {
+          _parallel = value;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the collection is scanned by multiple threads
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isParallel () const {
+          return _parallel;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the database
 ////////////////////////////////////////////////////////////////////////////////
@@ -982,6 +1007,13 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         bool _random;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the collection is partitioned among the scan threads,
+/// which apply the filter condition of the following FILTER node
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _parallel;
     };
 
 // -----------------------------------------------------------------------------
@@ -1103,6 +1135,21 @@ namespace triagens {
 
       public:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an additional index lookup, used for index unions and intersections
+////////////////////////////////////////////////////////////////////////////////
+
+        struct IndexLookup {
+          IndexLookup (Index const* index,
+                       std::vector<std::vector<RangeInfo>> const& ranges)
+            : index(index),
+              ranges(ranges) {
+          }
+
+          Index const* index;
+          std::vector<std::vector<RangeInfo>> ranges;
+        };
+
         IndexRangeNode (ExecutionPlan* plan,
                         size_t id,
                         TRI_vocbase_t* vocbase, 
@@ -1117,7 +1164,10 @@ namespace triagens {
             _outVariable(outVariable),
             _index(index),
             _ranges(ranges),
-            _reverse(reverse) {
+            _reverse(reverse),
+            _indexOnly(false),
+            _otherLookups(),
+            _intersect(false) {
           TRI_ASSERT(_vocbase != nullptr);
           TRI_ASSERT(_collection != nullptr);
           TRI_ASSERT(_outVariable != nullptr);
@@ -1219,6 +1269,19 @@ namespace triagens {
           _reverse = value;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the out variable is produced from the index entries
+/// alone. it then only contains the indexed attributes
+////////////////////////////////////////////////////////////////////////////////
+
+        void indexOnly (bool value) {
+          _indexOnly = value;
+        }
+
+        bool isIndexOnly () const {
+          return _indexOnly;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief getIndex, hand out the index used
 ////////////////////////////////////////////////////////////////////////////////
@@ -1227,18 +1290,60 @@ namespace triagens {
           return _index;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add further index lookups to the node. the results of all lookups
+/// are either united (deduplicated by document) or intersected
+////////////////////////////////////////////////////////////////////////////////
+
+        void otherLookups (std::vector<IndexLookup> const& lookups,
+                           bool intersect) {
+          _otherLookups.clear();
+          for (auto const& lookup : lookups) {
+            _otherLookups.emplace_back(lookup.index, lookup.ranges);
+          }
+          _intersect = intersect;
+        }
+
+        std::vector<IndexLookup> const& otherLookups () const {
+          return _otherLookups;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the node combines the results of multiple index
+/// lookups
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isMultiIndex () const {
+          return ! _otherLookups.empty();
+        }
+
+        bool isIntersection () const {
+          return _intersect;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
 
       private:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimate the cost and number of items for a single index lookup
+////////////////////////////////////////////////////////////////////////////////
+
+        double estimateLookupCost (Index const*,
+                                   std::vector<std::vector<RangeInfo>> const&,
+                                   size_t,
+                                   size_t&) const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief provide an estimate for the number of items, using the index
 /// selectivity info (if present)
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool estimateItemsWithIndexSelectivity (size_t,
+        bool estimateItemsWithIndexSelectivity (Index const*,
+                                                size_t,
+                                                size_t,
                                                 size_t&) const;
 
 // -----------------------------------------------------------------------------
@@ -1282,6 +1387,26 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         bool _reverse;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the out variable from the index entries instead of reading
+/// the documents
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _indexOnly;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief additional index lookups, whose results are combined with the
+/// results of the lookup in _index
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<IndexLookup> _otherLookups;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief intersect the results of the lookups instead of uniting them
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _intersect;
     };
 
 // -----------------------------------------------------------------------------
@@ -1374,6 +1499,30 @@ namespace triagens {
           _fullCount = true;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the node fully counts what it limits
+////////////////////////////////////////////////////////////////////////////////
+
+        bool fullCount () const {
+          return _fullCount;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the offset
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t offset () const {
+          return _offset;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the limit
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t limit () const {
+          return _limit;
+        }
+
       private:
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1680,6 +1829,15 @@ namespace triagens {
 
         bool canThrow ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the subquery always produces the same result for
+/// the same values of the outer variables it uses. this is false if any
+/// expression in the subquery is non-deterministic, if documents are iterated
+/// in random order or if the subquery modifies data
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isDeterministic () const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -1865,7 +2023,8 @@ namespace triagens {
                   bool stable) 
           : ExecutionNode(plan, id),
             _elements(elements),
-            _stable(stable) {
+            _stable(stable),
+            _limit(0) {
         }
         
         SortNode (ExecutionPlan* plan,
@@ -1905,6 +2064,7 @@ namespace triagens {
                               bool withDependencies,
                               bool withProperties) const override final {
           auto c = new SortNode(plan, _id, _elements, _stable);
+          c->setLimit(_limit);
 
           CloneHelper(c, plan, withDependencies, withProperties);
 
@@ -1955,6 +2115,23 @@ namespace triagens {
 
         bool simplify (ExecutionPlan*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tell the node that only the first limit rows of its output are
+/// used. 0 means all rows are used
+////////////////////////////////////////////////////////////////////////////////
+
+        void setLimit (size_t limit) {
+          _limit = limit;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of rows the node needs to produce, 0 means all
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t limit () const {
+          return _limit;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -1973,6 +2150,13 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         bool _stable;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of rows to produce, 0 means all. if set, the sort keeps
+/// only the best rows in a bounded heap (top-k sort)
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _limit;
     };
 
 
@@ -2016,7 +2200,8 @@ namespace triagens {
             _outVariable(outVariable),
             _keepVariables(keepVariables),
             _variableMap(variableMap),
-            _count(count) {
+            _count(count),
+            _countVariable(nullptr) {
 
           // outVariable can be a nullptr, but only if _count is not set
           if (_count) {
@@ -2147,6 +2332,24 @@ namespace triagens {
           _expressionVariable = variable;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the variable with partial counts (might be null)
+////////////////////////////////////////////////////////////////////////////////
+
+        Variable const* countVariable () const {
+          return _countVariable;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the variable with partial counts. the node will then sum up
+/// these counts per group instead of counting its input rows
+////////////////////////////////////////////////////////////////////////////////
+
+        void setCountVariable (Variable const* variable) {
+          TRI_ASSERT(_count);
+          _countVariable = variable;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the variable map
 ////////////////////////////////////////////////////////////////////////////////
@@ -2234,6 +2437,13 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         bool _count;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief variable with partial counts (might be null). if set, the COUNT of
+/// a group is the sum of this variable's values instead of the number of rows
+////////////////////////////////////////////////////////////////////////////////
+
+        Variable const* _countVariable;
     };
 
 // -----------------------------------------------------------------------------
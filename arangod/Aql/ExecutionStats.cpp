@@ -56,6 +56,11 @@ Json ExecutionStats::toJson () const {
     json.set("fullCount",      Json(static_cast<double>(fullCount)));
   }
 
+  if (spilledBytes > 0) {
+    // only reported by queries that had to write temporary files
+    json.set("spilledBytes",   Json(static_cast<double>(spilledBytes)));
+  }
+
   return json;
 }
 
@@ -78,7 +83,8 @@ ExecutionStats::ExecutionStats()
    scannedFull(0),
    scannedIndex(0),
    filtered(0),
-   fullCount(-1) {
+   fullCount(-1),
+   spilledBytes(0) {
 }
 
 ExecutionStats::ExecutionStats (triagens::basics::Json const& jsonStats) {
@@ -94,6 +100,7 @@ ExecutionStats::ExecutionStats (triagens::basics::Json const& jsonStats) {
 
   // note: fullCount is an optional attribute!
   fullCount      = JsonHelper::getNumericValue<int64_t>(jsonStats.json(), "fullCount", -1);
+  spilledBytes   = JsonHelper::getNumericValue<int64_t>(jsonStats.json(), "spilledBytes", 0);
 }
 
 // -----------------------------------------------------------------------------
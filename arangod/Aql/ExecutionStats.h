@@ -69,6 +69,7 @@ namespace triagens {
         scannedIndex   += summand.scannedIndex;
         fullCount      += summand.fullCount;
         filtered       += summand.filtered;
+        spilledBytes   += summand.spilledBytes;
       }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -82,6 +83,7 @@ namespace triagens {
         scannedIndex   += newStats.scannedIndex   - lastStats.scannedIndex;
         fullCount      += newStats.fullCount      - lastStats.fullCount;
         filtered       += newStats.filtered       - lastStats.filtered;
+        spilledBytes   += newStats.spilledBytes   - lastStats.spilledBytes;
       }
 
 
@@ -121,6 +123,68 @@ namespace triagens {
 
       int64_t fullCount; 
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of bytes written to temporary files
+////////////////////////////////////////////////////////////////////////////////
+
+      int64_t spilledBytes; 
+
+    };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execution profile of a single execution block, only collected if
+/// the query is run with the profile option
+////////////////////////////////////////////////////////////////////////////////
+
+    struct ExecutionBlockProfile {
+
+      ExecutionBlockProfile ()
+        : getSomeCalls(0),
+          skipSomeCalls(0),
+          rowsOut(0),
+          time(0.0),
+          cpuTime(0.0),
+          peakMemory(0) {
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of calls to getSome
+////////////////////////////////////////////////////////////////////////////////
+
+      uint64_t getSomeCalls;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of calls to skipSome
+////////////////////////////////////////////////////////////////////////////////
+
+      uint64_t skipSomeCalls;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows returned or skipped by the block
+////////////////////////////////////////////////////////////////////////////////
+
+      uint64_t rowsOut;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wall clock time spent in the block, including its dependencies
+/// (in seconds)
+////////////////////////////////////////////////////////////////////////////////
+
+      double time;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief CPU time spent in the block, including its dependencies
+/// (in seconds)
+////////////////////////////////////////////////////////////////////////////////
+
+      double cpuTime;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimated memory of the largest AqlItemBlock returned (in bytes)
+////////////////////////////////////////////////////////////////////////////////
+
+      size_t peakMemory;
+
     };
 
   }
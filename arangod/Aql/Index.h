@@ -137,6 +137,52 @@ namespace triagens {
 
         return internals->selectivityEstimate(internals);
       }
+
+      bool hasPrefixSelectivityEstimate () const {
+        if (! hasInternals()) { 
+          return false;
+        }
+
+        return getInternals()->prefixSelectivityEstimate != nullptr;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief selectivity of equality lookups on the first n attributes, 0 if
+/// the index cannot provide an estimate at the moment
+////////////////////////////////////////////////////////////////////////////////
+
+      double prefixSelectivityEstimate (size_t n) const {
+        TRI_index_t* internals = getInternals();
+
+        TRI_ASSERT(internals->prefixSelectivityEstimate != nullptr);
+
+        return internals->prefixSelectivityEstimate(internals, n);
+      }
+
+      bool hasRangeFractionEstimate () const {
+        if (! hasInternals()) { 
+          return false;
+        }
+
+        return getInternals()->rangeFractionEstimate != nullptr;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fraction of index entries whose first attribute lies inside the
+/// range, negative if the index cannot provide an estimate at the moment.
+/// a nullptr bound leaves the range open on that side
+////////////////////////////////////////////////////////////////////////////////
+
+      double rangeFractionEstimate (TRI_json_t const* low,
+                                    bool lowInclusive,
+                                    TRI_json_t const* high,
+                                    bool highInclusive) const {
+        TRI_index_t* internals = getInternals();
+
+        TRI_ASSERT(internals->rangeFractionEstimate != nullptr);
+
+        return internals->rangeFractionEstimate(internals, low, lowInclusive, high, highInclusive);
+      }
       
       inline bool hasInternals () const {
         return (internals != nullptr);
@@ -582,6 +582,24 @@ void Optimizer::setupRules () {
                moveCalculationsDownRule_pass9,
                true);
 
+  // fuse SORT and a following LIMIT into a top-k sort
+  registerRule("sort-limit",
+               applySortLimitRule,
+               applySortLimitRule_pass9,
+               true);
+
+  // read only the index entries if no other attributes are used
+  registerRule("use-index-only",
+               useIndexOnlyRule,
+               useIndexOnlyRule_pass9,
+               true);
+
+  // partition full collection scans with a filter among the scan threads
+  registerRule("parallelize-scan",
+               parallelizeScanRule,
+               parallelizeScanRule_pass9,
+               true);
+
   if (triagens::arango::ServerState::instance()->isCoordinator()) {
     // distribute operations in cluster
     registerRule("scatter-in-cluster",
@@ -604,6 +622,16 @@ void Optimizer::setupRules () {
                  distributeSortToClusterRule,
                  distributeSortToClusterRule_pass10,
                  true);
+
+    registerRule("distribute-collect-to-cluster",
+                 distributeAggregateToClusterRule,
+                 distributeAggregateToClusterRule_pass10,
+                 true);
+
+    registerRule("distribute-limit-to-cluster",
+                 distributeLimitToClusterRule,
+                 distributeLimitToClusterRule_pass10,
+                 true);
     
     registerRule("remove-unnecessary-remote-scatter",
                  removeUnnecessaryRemoteScatterRule,
@@ -198,6 +198,15 @@ namespace triagens {
 
         moveCalculationsDownRule_pass9                = 900,
 
+        // let SORT nodes followed by a LIMIT produce only the rows needed
+        applySortLimitRule_pass9                      = 910,
+
+        // answer queries from index entries if only indexed attributes are used
+        useIndexOnlyRule_pass9                        = 920,
+
+        // let the scan threads filter full collection scans
+        parallelizeScanRule_pass9                     = 930,
+
 //////////////////////////////////////////////////////////////////////////////
 /// "Pass 10": final transformations for the cluster
 //////////////////////////////////////////////////////////////////////////////
@@ -216,6 +225,13 @@ namespace triagens {
         // move SortNodes into the distribution.
         // adjust gathernode to also contain the sort criteria.
         distributeSortToClusterRule_pass10            = 1030,
+
+        // split COLLECTs into a partial COLLECT on the cluster nodes and a 
+        // merging COLLECT on the coordinator
+        distributeAggregateToClusterRule_pass10       = 1033,
+
+        // copy LimitNodes into the distribution as per-shard bounds
+        distributeLimitToClusterRule_pass10           = 1036,
         
         // try to get rid of a RemoteNode->ScatterNode combination which has
         // only a SingletonNode and possibly some CalculationNodes as dependencies
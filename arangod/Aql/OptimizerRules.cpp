@@ -32,6 +32,8 @@
 #include "Aql/Function.h"
 #include "Aql/Variable.h"
 #include "Aql/types.h"
+#include "Basics/StringUtils.h"
+#include "VocBase/server.h"
 
 using namespace triagens::aql;
 using Json = triagens::basics::Json;
@@ -1093,6 +1095,343 @@ int triagens::aql::moveCalculationsDownRule (Optimizer* opt,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tell SORT nodes that are followed by a LIMIT how many rows are 
+/// needed
+/// this rule modifies the plan in place
+/// the SORT then keeps only the best offset + limit rows in a bounded heap 
+/// instead of sorting its complete input. the LIMIT stays in the plan and
+/// still applies the offset
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::applySortLimitRule (Optimizer* opt, 
+                                       ExecutionPlan* plan, 
+                                       Optimizer::Rule const* rule) {
+  std::vector<ExecutionNode*> nodes = plan->findNodesOfType(EN::LIMIT, true);
+  bool modified = false;
+
+  for (auto n : nodes) {
+    auto limitNode = static_cast<LimitNode*>(n);
+
+    if (limitNode->fullCount()) {
+      // all rows must be produced so they can be counted
+      continue;
+    }
+
+    size_t const needed = limitNode->offset() + limitNode->limit();
+
+    if (needed == 0 || needed < limitNode->offset()) {
+      continue;
+    }
+
+    // calculations do not change the number of rows, so we can look past them
+    auto deps = n->getDependencies();
+    auto current = deps.empty() ? nullptr : deps[0];
+
+    while (current != nullptr && 
+           current->getType() == EN::CALCULATION) {
+      deps = current->getDependencies();
+      current = deps.empty() ? nullptr : deps[0];
+    }
+
+    if (current == nullptr || 
+        current->getType() != EN::SORT ||
+        current->getParents().size() != 1) {
+      continue;
+    }
+
+    auto sortNode = static_cast<SortNode*>(current);
+
+    if (sortNode->limit() == 0 || needed < sortNode->limit()) {
+      sortNode->setLimit(needed);
+      modified = true;
+    }
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief helper to check whether an expression uses a variable only for
+/// accessing attributes below the given attribute paths
+////////////////////////////////////////////////////////////////////////////////
+
+struct IndexOnlyAccessChecker {
+  Variable const* searchVariable;
+  std::vector<std::vector<std::string>> const& fields;
+  bool isCovered;
+
+  IndexOnlyAccessChecker (Variable const* searchVariable,
+                          std::vector<std::vector<std::string>> const& fields)
+    : searchVariable(searchVariable),
+      fields(fields),
+      isCovered(true) {
+  }
+
+  void analyze (AstNode const* node) {
+    TRI_ASSERT(node != nullptr);
+
+    if (! isCovered) {
+      return;
+    }
+
+    if (node->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+      // collect the attribute names from the outermost access inwards
+      std::vector<std::string> path;
+
+      while (node->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+        path.emplace_back(node->getStringValue());
+        node = node->getMember(0);
+      }
+
+      if (node->type == NODE_TYPE_REFERENCE &&
+          static_cast<Variable const*>(node->getData())->id == searchVariable->id) {
+        std::reverse(path.begin(), path.end());
+        isCovered = coversPath(path);
+        return;
+      }
+      // fall-through to the expression the attributes are accessed on
+    }
+
+    if (node->type == NODE_TYPE_REFERENCE) {
+      if (static_cast<Variable const*>(node->getData())->id == searchVariable->id) {
+        // the variable is used as a whole
+        isCovered = false;
+      }
+      return;
+    }
+
+    size_t const n = node->numMembers();
+    for (size_t i = 0; i < n; ++i) {
+      auto sub = node->getMember(i);
+      if (sub != nullptr) {
+        analyze(sub);
+      }
+    }
+  }
+
+  bool coversPath (std::vector<std::string> const& path) const {
+    for (auto const& field : fields) {
+      if (field.size() <= path.size() &&
+          std::equal(field.begin(), field.end(), path.begin())) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief let IndexRangeNodes on hash and skiplist indexes build their out
+/// variable from the index entries if only indexed attributes of it are used
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::useIndexOnlyRule (Optimizer* opt, 
+                                     ExecutionPlan* plan, 
+                                     Optimizer::Rule const* rule) {
+  std::vector<ExecutionNode*> nodes = plan->findNodesOfType(EN::INDEX_RANGE, true);
+  bool modified = false;
+
+  for (auto n : nodes) {
+    auto indexNode = static_cast<IndexRangeNode*>(n);
+    auto index = indexNode->getIndex();
+
+    if (indexNode->isIndexOnly() ||
+        indexNode->isMultiIndex() ||
+        (index->type != TRI_IDX_TYPE_HASH_INDEX && 
+         index->type != TRI_IDX_TYPE_SKIPLIST_INDEX)) {
+      continue;
+    }
+
+    std::vector<std::vector<std::string>> fields;
+    bool isUsable = true;
+
+    for (auto const& field : index->fields) {
+      if (field.empty() || field[0] == '_') {
+        // system attributes are not contained in the index entries
+        isUsable = false;
+        break;
+      }
+      fields.emplace_back(triagens::basics::StringUtils::split(field, '.'));
+    }
+
+    if (! isUsable) {
+      continue;
+    }
+
+    // all later uses of the out variable must be attribute accesses in
+    // calculations
+    auto outVariable = indexNode->outVariable();
+    IndexOnlyAccessChecker checker(outVariable, fields);
+    ExecutionNode* current = n;
+
+    while (checker.isCovered) {
+      auto parents = current->getParents();
+
+      if (parents.empty()) {
+        break;
+      }
+
+      current = parents[0];
+      auto&& used = current->getVariablesUsedHere();
+
+      if (std::find(used.begin(), used.end(), outVariable) == used.end()) {
+        continue;
+      }
+
+      if (current->getType() != EN::CALCULATION) {
+        checker.isCovered = false;
+        break;
+      }
+
+      checker.analyze(static_cast<CalculationNode*>(current)->expression()->node());
+    }
+
+    if (checker.isCovered) {
+      indexNode->indexOnly(true);
+      modified = true;
+    }
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check whether a filter condition can be evaluated by the scan
+/// threads. only operators that are evaluated without V8 and without access
+/// to the query are allowed, and the loop variable may only be used for
+/// accessing attributes. _id, _from and _to are excluded because their
+/// values are built with the transaction's collection name resolver
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsParallelScanCondition (AstNode const* node,
+                                     Variable const* variable) {
+  switch (node->type) {
+    case NODE_TYPE_VALUE: {
+      return true;
+    }
+
+    case NODE_TYPE_ATTRIBUTE_ACCESS: {
+      auto member = node->getMember(0);
+
+      if (member->type == NODE_TYPE_REFERENCE) {
+        if (static_cast<Variable const*>(member->getData())->id != variable->id) {
+          return false;
+        }
+
+        std::string const name(node->getStringValue());
+
+        return (name != TRI_VOC_ATTRIBUTE_ID &&
+                name != TRI_VOC_ATTRIBUTE_FROM &&
+                name != TRI_VOC_ATTRIBUTE_TO);
+      }
+
+      return IsParallelScanCondition(member, variable);
+    }
+
+    case NODE_TYPE_OPERATOR_UNARY_NOT:
+    case NODE_TYPE_OPERATOR_BINARY_AND:
+    case NODE_TYPE_OPERATOR_BINARY_OR:
+    case NODE_TYPE_OPERATOR_BINARY_EQ:
+    case NODE_TYPE_OPERATOR_BINARY_NE:
+    case NODE_TYPE_OPERATOR_BINARY_LT:
+    case NODE_TYPE_OPERATOR_BINARY_LE:
+    case NODE_TYPE_OPERATOR_BINARY_GT:
+    case NODE_TYPE_OPERATOR_BINARY_GE:
+    case NODE_TYPE_OPERATOR_TERNARY: {
+      size_t const n = node->numMembers();
+
+      for (size_t i = 0; i < n; ++i) {
+        if (! IsParallelScanCondition(node->getMember(i), variable)) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    default: {
+      return false;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief let the scan threads filter full collection scans that are directly
+/// followed by a simple filter condition on the loop variable. the rule only
+/// marks the EnumerateCollectionNode, the calculation and the FILTER stay in
+/// the plan. it does nothing if the server was started without scan threads
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::parallelizeScanRule (Optimizer* opt, 
+                                        ExecutionPlan* plan, 
+                                        Optimizer::Rule const* rule) {
+  bool modified = false;
+  auto scanPool = plan->getAst()->query()->vocbase()->_server->_scanPool;
+
+  if (scanPool != nullptr &&
+      ! triagens::arango::ServerState::instance()->isCoordinator()) {
+    std::vector<ExecutionNode*> nodes = plan->findNodesOfType(EN::ENUMERATE_COLLECTION, true);
+
+    for (auto n : nodes) {
+      auto collectionNode = static_cast<EnumerateCollectionNode*>(n);
+
+      if (collectionNode->isRandom() || 
+          collectionNode->isParallel()) {
+        continue;
+      }
+
+      auto parents = n->getParents();
+
+      if (parents.size() != 1 ||
+          parents[0]->getType() != EN::CALCULATION) {
+        continue;
+      }
+
+      auto calculationNode = static_cast<CalculationNode*>(parents[0]);
+      parents = calculationNode->getParents();
+
+      if (parents.size() != 1 ||
+          parents[0]->getType() != EN::FILTER) {
+        continue;
+      }
+
+      auto&& used = parents[0]->getVariablesUsedHere();
+
+      if (used.size() != 1 ||
+          used[0]->id != calculationNode->outVariable()->id) {
+        continue;
+      }
+
+      auto expression = calculationNode->expression();
+
+      if (expression->isV8() || 
+          ! expression->isDeterministic()) {
+        continue;
+      }
+
+      auto&& variables = expression->variables();
+
+      if (variables.size() != 1 ||
+          (*variables.begin())->id != collectionNode->outVariable()->id ||
+          ! IsParallelScanCondition(expression->node(), collectionNode->outVariable())) {
+        continue;
+      }
+
+      collectionNode->parallel(true);
+      modified = true;
+    }
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief determine the "right" type of AggregateNode and 
 /// add a sort node for each COLLECT (note: the sort may be removed later) 
@@ -1958,6 +2297,426 @@ class FilterToEnumCollFinder : public WalkerWorker<ExecutionNode> {
     bool modified () const {
       return _modified;
     }
+
+  private:
+
+    // build the condition for looking up the ranges of <var> at the positions
+    // <validPos> with the index <idx>. returns false if the index cannot be
+    // used for all of the positions
+    bool buildIndexOrCondition (Variable const* var,
+                                Index const* idx,
+                                size_t prefix,
+                                std::vector<size_t> const& validPos,
+                                IndexOrCondition& indexOrCondition) const {
+      // initialize all conditions with empty ranges
+      indexOrCondition.clear();
+      indexOrCondition.resize(validPos.size());
+
+      // ranges must be valid and all comparisons == if hash
+      // index or == followed by a single <, >, >=, or <=
+      // if a skip index in the order of the fields of the
+      // index.
+      TRI_ASSERT(idx != nullptr);
+
+      if (idx->type == TRI_IDX_TYPE_PRIMARY_INDEX) {
+        for (size_t k = 0; k < validPos.size(); k++) {
+          bool handled = false;
+
+          auto const map = _rangeInfoMapVec->find(var->name, validPos[k]);
+          auto range = map->find(std::string(TRI_VOC_ATTRIBUTE_ID));
+
+          if (range != map->end()) { 
+            if (! range->second.is1ValueRangeInfo()) {
+              indexOrCondition.clear();   // not usable
+              break;
+            }
+
+            indexOrCondition.at(k).push_back(range->second);
+            handled = true;
+          }
+
+          if (! handled) {
+            range = map->find(std::string(TRI_VOC_ATTRIBUTE_KEY));
+
+            if (range != map->end()) {
+              if (! range->second.is1ValueRangeInfo()) {
+                indexOrCondition.clear();   // not usable
+                break;
+              }
+
+              indexOrCondition.at(k).push_back(range->second);
+            }
+          }
+        }
+      }
+      else if (idx->type == TRI_IDX_TYPE_EDGE_INDEX) {
+        for (size_t k = 0; k < validPos.size(); k++) {
+          bool handled = false;
+
+          auto const map = _rangeInfoMapVec->find(var->name, validPos[k]);
+          auto range = map->find(std::string(TRI_VOC_ATTRIBUTE_FROM));
+
+          if (range != map->end()) { 
+            if (! range->second.is1ValueRangeInfo()) {
+              indexOrCondition.clear();
+              break; // not usable
+            }
+
+            indexOrCondition.at(k).push_back(range->second);
+            handled = true;
+          }
+
+          if (! handled) {
+            range = map->find(std::string(TRI_VOC_ATTRIBUTE_TO));
+
+            if (range != map->end()) {
+              if (! range->second.is1ValueRangeInfo()) {
+                indexOrCondition.clear();   // not usable
+                break;
+              }
+
+              indexOrCondition.at(k).push_back(range->second);
+            }
+          }
+        }
+      }
+      else if (idx->type == TRI_IDX_TYPE_HASH_INDEX) {
+        // each valid orCondition should match every field of the given index
+        for (size_t k = 0; k < validPos.size() && ! indexOrCondition.empty(); k++) {
+          auto const map = _rangeInfoMapVec->find(var->name, validPos[k]);
+
+          for (size_t j = 0; j < idx->fields.size(); j++) {
+            auto range = map->find(idx->fields[j]);
+
+            if (range == map->end() || ! range->second.is1ValueRangeInfo()) {
+              indexOrCondition.clear();   // not usable
+              break;
+            }
+
+            if (idx->sparse) {
+              // a sparse hash index must not be used if any of the lookup values is
+              // either null (null is not contained in a sparse index) or is calculated
+              // using an expression with unknown result. this is because the expression
+              // result may be null and using the sparse index then would not allow
+              // finding the document
+              bool mustClear = false;
+              auto const& rib = range->second; 
+
+              if (rib.isConstant()) {
+                // value is constant (and an equality because we're looking at a hash index)
+                auto const& value = rib._lowConst.bound();
+                if (value.isEmpty() || value.isNull()) {
+                  // lookup value is null. can't use a sparse index.
+                  mustClear = true;
+                }
+              }
+              else {
+                // non-constant lookup value. it might be null, so we can't use the index
+                mustClear = true;
+              }
+
+              if (mustClear) {
+                // not usable
+                indexOrCondition.clear();   
+                break; // exit for loop
+              }
+            }
+
+            indexOrCondition.at(k).push_back(range->second);
+          }
+        }
+      }
+      else if (idx->type == TRI_IDX_TYPE_SKIPLIST_INDEX) {
+        for (size_t k = 0; k < validPos.size(); k++) {
+          auto const map = _rangeInfoMapVec->find(var->name, validPos[k]);
+
+          // check if there is a range that contains the first index attribute
+          auto range = map->find(idx->fields[0]);
+
+          if (range == map->end()) { 
+            indexOrCondition.clear();
+            break; // not usable
+          }
+
+          // insert the first index attribute
+          indexOrCondition.at(k).push_back(range->second);
+
+          // iterate over all index attributes from left to right 
+          bool equality = range->second.is1ValueRangeInfo();
+          bool handled = false;
+          size_t j = 0;
+          while (++j < prefix && equality) {
+            range = map->find(idx->fields[j]);
+
+            if (range == map->end()) { 
+              indexOrCondition.clear();
+              handled = true;
+              break; // not usable
+            }
+
+            indexOrCondition.at(k).push_back(range->second);
+            equality = equality && range->second.is1ValueRangeInfo();
+          }
+
+          if (handled) {
+            break; // exit for loop
+          }
+        }
+
+        // check if index is sparse and exclude it if required
+        // a sparse skiplist index must not be used if any of the lookup values is
+        // either null (null is not contained in a sparse index) or is calculated
+        // using an expression with unknown result. this is because the expression
+        // result may be null and using the sparse index then would not allow
+        // finding the document
+        if (idx->sparse && ! indexOrCondition.empty()) {
+          for (size_t k = 0; k < validPos.size() && ! indexOrCondition.empty(); k++) {
+            auto const map = _rangeInfoMapVec->find(var->name, validPos[k]);
+
+            for (size_t j = 0; j < idx->fields.size(); j++) {
+              auto range = map->find(idx->fields[j]);
+
+              if (range == map->end()) { 
+                indexOrCondition.clear();
+                break; // not usable
+              }
+
+              auto const& rib = range->second; 
+
+              // if the lookup value is dynamic, undefined or includes null, then we 
+              // can't use the index
+              if (! rib.isConstant() || 
+                  ! rib._lowConst.isDefined() ||
+                  (rib._lowConst.inclusive() && rib._lowConst.bound().isNull())) {
+                indexOrCondition.clear();
+                break;
+              }
+            }
+          }
+        }
+
+      }
+
+      // check if there are all positions are non-empty
+      bool isEmpty = indexOrCondition.empty();
+
+      if (! isEmpty) {
+        for (size_t k = 0; k < validPos.size(); k++) {
+          if (indexOrCondition.at(k).empty()) {
+            isEmpty = true;
+            break;
+          }
+        }
+      }
+
+      return ! isEmpty;
+    }
+
+    // number of leading fields of a skiplist index <idx> that are used by the
+    // ranges of <var> at position <pos>
+    size_t branchPrefix (Variable const* var,
+                         Index const* idx,
+                         size_t pos) const {
+      if (idx->type != TRI_IDX_TYPE_SKIPLIST_INDEX) {
+        return 0;
+      }
+
+      auto const map = _rangeInfoMapVec->find(var->name, pos);
+      size_t prefix = 0;
+
+      while (prefix < idx->fields.size() && map->find(idx->fields[prefix]) != map->end()) {
+        ++prefix;
+      }
+      return prefix;
+    }
+
+    // rank index types for combining lookups. lower is better
+    static int indexPreference (Index const* idx) {
+      switch (idx->type) {
+        case TRI_IDX_TYPE_PRIMARY_INDEX:
+          return 0;
+        case TRI_IDX_TYPE_EDGE_INDEX:
+          return 1;
+        case TRI_IDX_TYPE_HASH_INDEX:
+          return 2;
+        default:
+          return 3;
+      }
+    }
+
+    // whether or not all bounds of the condition are constant. only such
+    // conditions are used for multi-index lookups
+    static bool isConstantCondition (IndexOrCondition const& condition) {
+      for (auto const& indexAnd : condition) {
+        for (auto const& range : indexAnd) {
+          if (! range.isConstant()) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    // register a possible replacement for the EnumerateCollectionNode <node>
+    void addChange (EnumerateCollectionNode const* node,
+                    ExecutionNode* newNode) {
+      // if all goes well, this node will be used, if an 
+      // exception happens, the destructor will free it
+      std::unique_ptr<ExecutionNode> guard(newNode);
+
+      size_t place = node->id();
+      std::unordered_map<size_t, size_t>::iterator it 
+           = _changesPlaces.find(place);
+      if (it == _changesPlaces.end()) {
+        _changes.emplace_back(std::make_pair(place, std::vector<ExecutionNode*>()));
+        it = _changesPlaces.emplace(place, _changes.size()-1).first;
+      }
+      std::vector<ExecutionNode*>& vec = _changes[it->second].second;
+      vec.push_back(newNode);
+      guard.release();
+    }
+
+    // OR-combined conditions on attributes that are indexed separately: look
+    // up each OR branch with the best index for it and unite the results.
+    // branches that use the same index are looked up together
+    void addIndexUnion (EnumerateCollectionNode const* node,
+                        Variable const* var,
+                        std::vector<size_t> const& validPos,
+                        std::vector<Index*> const& idxs) {
+      std::vector<Index const*> lookupIndexes;
+      std::vector<IndexOrCondition> lookupConditions;
+
+      for (auto const pos : validPos) {
+        std::vector<size_t> const branch{ pos };
+        Index const* best = nullptr;
+        IndexOrCondition bestCondition;
+
+        for (auto const idx : idxs) {
+          IndexOrCondition condition;
+
+          if (! buildIndexOrCondition(var, idx, branchPrefix(var, idx, pos), branch, condition) ||
+              ! isConstantCondition(condition)) {
+            continue;
+          }
+
+          if (best == nullptr ||
+              indexPreference(idx) < indexPreference(best) ||
+              (indexPreference(idx) == indexPreference(best) && condition[0].size() > bestCondition[0].size())) {
+            best = idx;
+            bestCondition.swap(condition);
+          }
+        }
+
+        if (best == nullptr) {
+          // the branch cannot be looked up using an index
+          return;
+        }
+
+        size_t j = 0;
+        while (j < lookupIndexes.size() && lookupIndexes[j] != best) {
+          ++j;
+        }
+        if (j == lookupIndexes.size()) {
+          lookupIndexes.emplace_back(best);
+          lookupConditions.emplace_back();
+        }
+        lookupConditions[j].emplace_back(bestCondition[0]);
+      }
+
+      if (lookupIndexes.size() < 2) {
+        // all branches use the same index. this is handled already
+        return;
+      }
+
+      std::vector<IndexRangeNode::IndexLookup> otherLookups;
+      for (size_t j = 1; j < lookupIndexes.size(); ++j) {
+        otherLookups.emplace_back(lookupIndexes[j], lookupConditions[j]);
+      }
+
+      std::unique_ptr<IndexRangeNode> newNode
+        (new IndexRangeNode(_plan, 
+            _plan->nextId(), node->vocbase(), node->collection(), 
+            node->outVariable(), lookupIndexes[0], lookupConditions[0], false));
+      newNode->otherLookups(otherLookups, false);
+      addChange(node, newNode.release());
+    }
+
+    // AND-combined conditions on attributes that are indexed separately: 
+    // look up the conditions with each of the indexes and intersect the
+    // results. an index is only used if it covers attributes not covered
+    // by the indexes picked before
+    void addIndexIntersection (EnumerateCollectionNode const* node,
+                               Variable const* var,
+                               std::vector<size_t> const& validPos,
+                               std::vector<Index*> const& idxs,
+                               std::vector<size_t> const& prefixes) {
+      TRI_ASSERT(validPos.size() == 1);
+
+      std::vector<size_t> candidates;
+      std::vector<IndexOrCondition> conditions(idxs.size());
+
+      for (size_t i = 0; i < idxs.size(); i++) {
+        auto const idx = idxs.at(i);
+
+        if (! buildIndexOrCondition(var, idx, prefixes.at(i), validPos, conditions[i]) ||
+            ! isConstantCondition(conditions[i])) {
+          continue;
+        }
+
+        if (idx->type == TRI_IDX_TYPE_PRIMARY_INDEX) {
+          // nothing can beat a primary index lookup
+          return;
+        }
+
+        candidates.emplace_back(i);
+      }
+
+      if (candidates.size() < 2) {
+        return;
+      }
+
+      std::sort(candidates.begin(), candidates.end(), [&] (size_t lhs, size_t rhs) -> bool {
+        if (indexPreference(idxs[lhs]) != indexPreference(idxs[rhs])) {
+          return indexPreference(idxs[lhs]) < indexPreference(idxs[rhs]);
+        }
+        return conditions[lhs][0].size() > conditions[rhs][0].size();
+      });
+
+      std::unordered_set<std::string> covered;
+      std::vector<size_t> chosen;
+
+      for (auto const i : candidates) {
+        bool coversNew = false;
+
+        for (auto const& range : conditions[i][0]) {
+          if (covered.emplace(range._attr).second) {
+            coversNew = true;
+          }
+        }
+
+        if (coversNew) {
+          chosen.emplace_back(i);
+        }
+      }
+
+      if (chosen.size() < 2) {
+        return;
+      }
+
+      std::vector<IndexRangeNode::IndexLookup> otherLookups;
+      for (size_t j = 1; j < chosen.size(); ++j) {
+        otherLookups.emplace_back(idxs[chosen[j]], conditions[chosen[j]]);
+      }
+
+      std::unique_ptr<IndexRangeNode> newNode
+        (new IndexRangeNode(_plan, 
+            _plan->nextId(), node->vocbase(), node->collection(), 
+            node->outVariable(), idxs[chosen[0]], conditions[chosen[0]], false));
+      newNode->otherLookups(otherLookups, true);
+      addChange(node, newNode.release());
+    }
+
+  public:
     
     bool before (ExecutionNode* en) override final {
       _canThrow = (_canThrow || en->canThrow()); // can any node walked over throw?
@@ -2130,225 +2889,23 @@ class FilterToEnumCollFinder : public WalkerWorker<ExecutionNode> {
                   // enumerate collection node with a IndexRangeNode ... 
 
                   for (size_t i = 0; i < idxs.size(); i++) {
-                    // initialize all conditions with empty ranges
-                    IndexOrCondition indexOrCondition(validPos.size());
-
-                    // ranges must be valid and all comparisons == if hash
-                    // index or == followed by a single <, >, >=, or <=
-                    // if a skip index in the order of the fields of the
-                    // index.
                     auto const idx = idxs.at(i);
-                    TRI_ASSERT(idx != nullptr);
-
-                    if (idx->type == TRI_IDX_TYPE_PRIMARY_INDEX) {
-                      for (size_t k = 0; k < validPos.size(); k++) {
-                        bool handled = false;
-
-                        auto const map = _rangeInfoMapVec->find(var->name, validPos[k]);
-                        auto range = map->find(std::string(TRI_VOC_ATTRIBUTE_ID));
-
-                        if (range != map->end()) { 
-                          if (! range->second.is1ValueRangeInfo()) {
-                            indexOrCondition.clear();   // not usable
-                            break;
-                          }
-
-                          indexOrCondition.at(k).push_back(range->second);
-                          handled = true;
-                        }
-
-                        if (! handled) {
-                          range = map->find(std::string(TRI_VOC_ATTRIBUTE_KEY));
-
-                          if (range != map->end()) {
-                            if (! range->second.is1ValueRangeInfo()) {
-                              indexOrCondition.clear();   // not usable
-                              break;
-                            }
-
-                            indexOrCondition.at(k).push_back(range->second);
-                          }
-                        }
-                      }
-                    }
-                    else if (idx->type == TRI_IDX_TYPE_EDGE_INDEX) {
-                      for (size_t k = 0; k < validPos.size(); k++) {
-                        bool handled = false;
-
-                        auto const map = _rangeInfoMapVec->find(var->name, validPos[k]);
-                        auto range = map->find(std::string(TRI_VOC_ATTRIBUTE_FROM));
-
-                        if (range != map->end()) { 
-                          if (! range->second.is1ValueRangeInfo()) {
-                            indexOrCondition.clear();
-                            break; // not usable
-                          }
-
-                          indexOrCondition.at(k).push_back(range->second);
-                          handled = true;
-                        }
-
-                        if (! handled) {
-                          range = map->find(std::string(TRI_VOC_ATTRIBUTE_TO));
-
-                          if (range != map->end()) {
-                            if (! range->second.is1ValueRangeInfo()) {
-                              indexOrCondition.clear();   // not usable
-                              break;
-                            }
-
-                            indexOrCondition.at(k).push_back(range->second);
-                          }
-                        }
-                      }
-                    }
-                    else if (idx->type == TRI_IDX_TYPE_HASH_INDEX) {
-                      // each valid orCondition should match every field of the given index
-                      for (size_t k = 0; k < validPos.size() && ! indexOrCondition.empty(); k++) {
-                        auto const map = _rangeInfoMapVec->find(var->name, validPos[k]);
-
-                        for (size_t j = 0; j < idx->fields.size(); j++) {
-                          auto range = map->find(idx->fields[j]);
-
-                          if (range == map->end() || ! range->second.is1ValueRangeInfo()) {
-                            indexOrCondition.clear();   // not usable
-                            break;
-                          }
- 
-                          if (idx->sparse) {
-                            // a sparse hash index must not be used if any of the lookup values is
-                            // either null (null is not contained in a sparse index) or is calculated
-                            // using an expression with unknown result. this is because the expression
-                            // result may be null and using the sparse index then would not allow
-                            // finding the document
-                            bool mustClear = false;
-                            auto const& rib = range->second; 
-
-                            if (rib.isConstant()) {
-                              // value is constant (and an equality because we're looking at a hash index)
-                              auto const& value = rib._lowConst.bound();
-                              if (value.isEmpty() || value.isNull()) {
-                                // lookup value is null. can't use a sparse index.
-                                mustClear = true;
-                              }
-                            }
-                            else {
-                              // non-constant lookup value. it might be null, so we can't use the index
-                              mustClear = true;
-                            }
-                          
-                            if (mustClear) {
-                              // not usable
-                              indexOrCondition.clear();   
-                              break; // exit for loop
-                            }
-                          }
-
-                          indexOrCondition.at(k).push_back(range->second);
-                        }
-                      }
-                    }
-                    else if (idx->type == TRI_IDX_TYPE_SKIPLIST_INDEX) {
-                      for (size_t k = 0; k < validPos.size(); k++) {
-                        auto const map = _rangeInfoMapVec->find(var->name, validPos[k]);
-
-                        // check if there is a range that contains the first index attribute
-                        auto range = map->find(idx->fields[0]);
-
-                        if (range == map->end()) { 
-                          indexOrCondition.clear();
-                          break; // not usable
-                        }
-
-                        // insert the first index attribute
-                        indexOrCondition.at(k).push_back(range->second);
-                       
-                        // iterate over all index attributes from left to right 
-                        bool equality = range->second.is1ValueRangeInfo();
-                        bool handled = false;
-                        size_t j = 0;
-                        while (++j < prefixes.at(i) && equality) {
-                          range = map->find(idx->fields[j]);
-
-                          if (range == map->end()) { 
-                            indexOrCondition.clear();
-                            handled = true;
-                            break; // not usable
-                          }
-
-                          indexOrCondition.at(k).push_back(range->second);
-                          equality = equality && range->second.is1ValueRangeInfo();
-                        }
-
-                        if (handled) {
-                          break; // exit for loop
-                        }
-                      }
-
-                      // check if index is sparse and exclude it if required
-                      // a sparse skiplist index must not be used if any of the lookup values is
-                      // either null (null is not contained in a sparse index) or is calculated
-                      // using an expression with unknown result. this is because the expression
-                      // result may be null and using the sparse index then would not allow
-                      // finding the document
-                      if (idx->sparse && ! indexOrCondition.empty()) {
-                        for (size_t k = 0; k < validPos.size() && ! indexOrCondition.empty(); k++) {
-                          auto const map = _rangeInfoMapVec->find(var->name, validPos[k]);
-
-                          for (size_t j = 0; j < idx->fields.size(); j++) {
-                            auto range = map->find(idx->fields[j]);
-
-                            if (range == map->end()) { 
-                              indexOrCondition.clear();
-                              break; // not usable
-                            }
-
-                            auto const& rib = range->second; 
-
-                            // if the lookup value is dynamic, undefined or includes null, then we 
-                            // can't use the index
-                            if (! rib.isConstant() || 
-                                ! rib._lowConst.isDefined() ||
-                                (rib._lowConst.inclusive() && rib._lowConst.bound().isNull())) {
-                              indexOrCondition.clear();
-                              break;
-                            }
-                          }
-                        }
-                      }
+                    IndexOrCondition indexOrCondition;
 
+                    if (buildIndexOrCondition(var, idx, prefixes.at(i), validPos, indexOrCondition)) {
+                      addChange(node, new IndexRangeNode(_plan, 
+                          _plan->nextId(), node->vocbase(), node->collection(), 
+                          node->outVariable(), idx, indexOrCondition, false));
                     }
+                  }
 
-
-                    // check if there are all positions are non-empty
-                    bool isEmpty = indexOrCondition.empty();
-
-                    if (! isEmpty) {
-                      for (size_t k = 0; k < validPos.size(); k++) {
-                        if (indexOrCondition.at(k).empty()) {
-                          isEmpty = true;
-                          break;
-                        }
-                      }
-                    }
-
-                    if (! isEmpty) {
-                      std::unique_ptr<ExecutionNode> newNode
-                        (new IndexRangeNode(_plan, 
-                            _plan->nextId(), node->vocbase(), node->collection(), 
-                            node->outVariable(), idx, indexOrCondition, false));
-                      size_t place = node->id();
-                      std::unordered_map<size_t, size_t>::iterator it 
-                           = _changesPlaces.find(place);
-                      if (it == _changesPlaces.end()) {
-                        _changes.emplace_back(std::make_pair(place, std::vector<ExecutionNode*>()));
-                        it = _changesPlaces.emplace(place, _changes.size()-1).first;
-                      }
-                      std::vector<ExecutionNode*>& vec = _changes[it->second].second;
-                      vec.push_back(newNode.release());
-                      // if all goes well, this node will be used, if an 
-                      // exception happens, the destructor will free it
-                    }
+                  // the results of multiple indexes may be combined if no 
+                  // single index covers the condition
+                  if (validPos.size() > 1) {
+                    addIndexUnion(node, var, validPos, idxs);
+                  }
+                  else {
+                    addIndexIntersection(node, var, validPos, idxs, prefixes);
                   }
                 }
               }
@@ -3084,7 +3641,10 @@ int triagens::aql::removeFiltersCoveredByIndexRule (Optimizer* opt,
     bool handled = false;
     auto current = n;
     while (current != nullptr) {
-      if (current->getType() == EN::INDEX_RANGE) {
+      // the results of an index union need not satisfy the ranges of its first lookup
+      if (current->getType() == EN::INDEX_RANGE &&
+          (! static_cast<IndexRangeNode const*>(current)->isMultiIndex() ||
+           static_cast<IndexRangeNode const*>(current)->isIntersection())) {
         // found an index range, now check if the expression is covered by the index
         auto const& ranges = static_cast<IndexRangeNode const*>(current)->ranges();
 
@@ -3790,6 +4350,227 @@ int triagens::aql::distributeSortToClusterRule (Optimizer* opt,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief split a COLLECT into a partial COLLECT on the DBservers and a COLLECT
+/// on the coordinator that merges the partial results
+/// this rule modifies the plan in place
+///
+/// only COLLECTs without INTO and COLLECT ... WITH COUNT INTO are split. for 
+/// these, each shard sends only one row per group to the coordinator. the
+/// coordinator groups these rows again, and sums up the partial counts
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::distributeAggregateToClusterRule (Optimizer* opt, 
+                                                     ExecutionPlan* plan,
+                                                     Optimizer::Rule const* rule) {
+  bool modified = false;
+
+  std::vector<ExecutionNode*> nodes
+    = plan->findNodesOfType(EN::GATHER, true);
+  
+  for (auto n : nodes) {
+    auto remoteNodeList = n->getDependencies();
+    auto gatherNode = static_cast<GatherNode*>(n);
+    TRI_ASSERT(remoteNodeList.size() > 0);
+    auto rn = remoteNodeList[0];
+    auto parents = n->getParents();
+
+    if (parents.size() != 1 || 
+        parents[0]->getType() != EN::AGGREGATE) {
+      continue;
+    }
+
+    auto collectNode = static_cast<AggregateNode*>(parents[0]);
+
+    if ((collectNode->hasOutVariable() && ! collectNode->count()) ||
+        collectNode->countVariable() != nullptr) {
+      // INTO needs all rows of a group on the coordinator
+      continue;
+    }
+
+    auto const& aggregateVariables = collectNode->aggregateVariables();
+    bool const isSorted = (collectNode->aggregationMethod() == AggregationOptions::AggregationMethod::AGGREGATION_METHOD_SORTED);
+
+    if (isSorted && ! aggregateVariables.empty()) {
+      // the sorted variant needs its input in group order. this is only the
+      // case if the SortNode in front of the COLLECT has been moved to the
+      // DBservers and the GatherNode merges the shards by the groups
+      auto const& elements = gatherNode->getElements();
+
+      if (elements.size() != aggregateVariables.size()) {
+        continue;
+      }
+
+      bool canOptimize = true;
+      for (size_t i = 0; i < elements.size(); ++i) {
+        if (elements[i].first != aggregateVariables[i].second) {
+          canOptimize = false;
+          break;
+        }
+      }
+
+      if (! canOptimize) {
+        continue;
+      }
+    }
+
+    // the partial COLLECT groups by the original expressions and writes into
+    // new temporary variables. the coordinator groups by these
+    auto variables = plan->getAst()->variables();
+
+    std::vector<std::pair<Variable const*, Variable const*>> partialVariables;
+    std::vector<std::pair<Variable const*, Variable const*>> mergeVariables;
+    SortElementVector elements;
+
+    for (auto const& it : aggregateVariables) {
+      auto partialOut = variables->createTemporaryVariable();
+      partialVariables.emplace_back(std::make_pair(partialOut, it.second));
+      mergeVariables.emplace_back(std::make_pair(it.first, partialOut));
+      elements.emplace_back(std::make_pair(partialOut, true));
+    }
+
+    Variable const* partialCount = nullptr;
+    if (collectNode->count()) {
+      partialCount = variables->createTemporaryVariable();
+    }
+
+    auto partialNode = new AggregateNode(plan,
+                                         plan->nextId(),
+                                         collectNode->getOptions(),
+                                         partialVariables,
+                                         nullptr,
+                                         partialCount,
+                                         std::vector<Variable const*>(),
+                                         collectNode->variableMap(),
+                                         collectNode->count());
+    plan->registerNode(partialNode);
+    
+    auto mergeNode = new AggregateNode(plan,
+                                       plan->nextId(),
+                                       collectNode->getOptions(),
+                                       mergeVariables,
+                                       nullptr,
+                                       collectNode->outVariable(),
+                                       std::vector<Variable const*>(),
+                                       collectNode->variableMap(),
+                                       collectNode->count());
+    plan->registerNode(mergeNode);
+
+    if (partialCount != nullptr) {
+      mergeNode->setCountVariable(partialCount);
+    }
+
+    // put the partial COLLECT in front of the RemoteNode
+    plan->insertDependency(rn, partialNode);
+    plan->replaceNode(collectNode, mergeNode);
+
+    if (isSorted) {
+      // the shards' results arrive sorted by the new group variables
+      gatherNode->setElements(elements);
+    }
+    else {
+      // the order of the rows is irrelevant for the hashed variant, and
+      // the former sort criteria are no longer available after the COLLECT
+      gatherNode->setElements(SortElementVector());
+    }
+
+    modified = true;
+  }
+  
+  if (modified) {
+    plan->findVarUsage();
+  }
+  
+  opt->addPlan(plan, rule, modified);
+  
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copy LIMITs into the cluster distribution part of the plan
+/// this rule modifies the plan in place
+///
+/// a LIMIT following a GatherNode is copied in front of the RemoteNode, with 
+/// an offset of 0 and a limit of the original offset plus limit. no shard 
+/// needs to return more rows than this. if the LIMIT follows a SORT that has
+/// been moved to the DBservers, each shard thus returns its top rows only
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::distributeLimitToClusterRule (Optimizer* opt, 
+                                                 ExecutionPlan* plan,
+                                                 Optimizer::Rule const* rule) {
+  bool modified = false;
+
+  std::vector<ExecutionNode*> nodes
+    = plan->findNodesOfType(EN::GATHER, true);
+  
+  for (auto n : nodes) {
+    auto remoteNodeList = n->getDependencies();
+    TRI_ASSERT(remoteNodeList.size() > 0);
+    auto rn = remoteNodeList[0];
+    auto parents = n->getParents();
+
+    if (parents.size() != 1 || 
+        parents[0]->getType() != EN::LIMIT) {
+      continue;
+    }
+
+    auto limitNode = static_cast<LimitNode*>(parents[0]);
+
+    if (limitNode->fullCount() ||
+        limitNode->offset() + limitNode->limit() < limitNode->offset()) {
+      // the shards must produce all rows so they can be counted
+      continue;
+    }
+
+    // data-modification operations on the DBservers must not be cut short
+    bool canOptimize = true;
+    auto node = rn->getDependencies().empty() ? nullptr : rn->getDependencies()[0];
+
+    while (node != nullptr) {
+      auto type = node->getType();
+
+      if (type == EN::INSERT ||
+          type == EN::REMOVE ||
+          type == EN::REPLACE ||
+          type == EN::UPDATE ||
+          type == EN::UPSERT) {
+        canOptimize = false;
+        break;
+      }
+
+      if (type == EN::REMOTE ||
+          type == EN::SCATTER ||
+          type == EN::DISTRIBUTE) {
+        break;
+      }
+
+      auto const& deps = node->getDependencies();
+      node = deps.empty() ? nullptr : deps[0];
+    }
+
+    if (! canOptimize) {
+      continue;
+    }
+
+    auto bound = new LimitNode(plan, 
+                               plan->nextId(), 
+                               limitNode->offset() + limitNode->limit());
+    plan->registerNode(bound);
+    plan->insertDependency(rn, bound);
+
+    modified = true;
+  }
+  
+  if (modified) {
+    plan->findVarUsage();
+  }
+  
+  opt->addPlan(plan, rule, modified);
+  
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief try to get rid of a RemoteNode->ScatterNode combination which has
 /// only a SingletonNode and possibly some CalculationNodes as dependencies
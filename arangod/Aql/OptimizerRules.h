@@ -98,6 +98,30 @@ namespace triagens {
 
     int moveCalculationsDownRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tell SORT nodes that are followed by a LIMIT how many rows are 
+/// needed, so they can keep only the best rows instead of sorting everything
+/// this rule modifies the plan in place
+////////////////////////////////////////////////////////////////////////////////
+
+    int applySortLimitRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief let IndexRangeNodes on hash and skiplist indexes build their out
+/// variable from the index entries if only indexed attributes of it are used
+/// this rule modifies the plan in place
+////////////////////////////////////////////////////////////////////////////////
+
+    int useIndexOnlyRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief let the scan threads filter full collection scans that are directly
+/// followed by a simple filter condition on the loop variable
+/// this rule modifies the plan in place
+////////////////////////////////////////////////////////////////////////////////
+
+    int parallelizeScanRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief determine the "right" type of AggregateNode and 
 /// add a sort node for each COLLECT (may be removed later) 
@@ -181,6 +205,20 @@ namespace triagens {
 
     int distributeSortToClusterRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief split a COLLECT following a GatherNode into a partial COLLECT on the
+/// DBservers and a COLLECT on the coordinator that merges the partial results
+////////////////////////////////////////////////////////////////////////////////
+
+    int distributeAggregateToClusterRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copy a LIMIT following a GatherNode to the DBservers, so that each
+/// shard returns at most offset + limit rows
+////////////////////////////////////////////////////////////////////////////////
+
+    int distributeLimitToClusterRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief try to get rid of a RemoteNode->ScatterNode combination which has
 /// only a SingletonNode and possibly some CalculationNodes as dependencies
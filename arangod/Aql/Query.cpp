@@ -72,6 +72,12 @@ static std::string StateNames[] = {
 static_assert(sizeof(StateNames) / sizeof(std::string) == static_cast<size_t>(ExecutionState::INVALID_STATE), 
               "invalid number of ExecutionState values");
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief chunk size of the arena for the query strings
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const StringsChunkSize = 4096;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    struct Profile
 // -----------------------------------------------------------------------------
@@ -181,7 +187,7 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
     _bindParameters(bindParameters),
     _options(options),
     _collections(vocbase),
-    _strings(),
+    _strings(nullptr),
     _ast(nullptr),
     _profile(nullptr),
     _state(INVALID_STATE),
@@ -204,7 +210,6 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
   
   _ast = new Ast(this);
   _nodes.reserve(32);
-  _strings.reserve(32);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -228,7 +233,7 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
     _bindParameters(nullptr),
     _options(options),
     _collections(vocbase),
-    _strings(),
+    _strings(nullptr),
     _ast(nullptr),
     _profile(nullptr),
     _state(INVALID_STATE),
@@ -251,7 +256,6 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
 
   _ast = new Ast(this);
   _nodes.reserve(32);
-  _strings.reserve(32);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -298,8 +302,8 @@ Query::~Query () {
   }
 
   // free strings
-  for (auto it = _strings.begin(); it != _strings.end(); ++it) {
-    TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, const_cast<char*>(*it));
+  if (_strings != nullptr) {
+    TRI_FreeArenaMemoryZone(_strings);
   }
   // free nodes
   for (auto it = _nodes.begin(); it != _nodes.end(); ++it) {
@@ -680,6 +684,11 @@ QueryResult Query::execute (QueryRegistry* registry) {
 
     stats = _engine->_stats.toJson();
 
+    triagens::basics::Json nodes;
+    if (profiling()) {
+      nodes = _engine->profileToJson();
+    }
+
     _trx->commit();
     
     cleanupPlanAndEngine(TRI_ERROR_NO_ERROR);
@@ -693,6 +702,10 @@ QueryResult Query::execute (QueryRegistry* registry) {
 
     if (_profile != nullptr && profiling()) {
       result.profile = _profile->toJson(TRI_UNKNOWN_MEM_ZONE);
+
+      if (result.profile != nullptr && nodes.isArray()) {
+        TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, result.profile, "nodes", nodes.steal());
+      }
     }
 
     return result;
@@ -760,6 +773,11 @@ QueryResultV8 Query::executeV8 (v8::Isolate* isolate, QueryRegistry* registry) {
 
     stats = _engine->_stats.toJson();
 
+    triagens::basics::Json nodes;
+    if (profiling()) {
+      nodes = _engine->profileToJson();
+    }
+
     _trx->commit();
     
     cleanupPlanAndEngine(TRI_ERROR_NO_ERROR);
@@ -771,6 +789,10 @@ QueryResultV8 Query::executeV8 (v8::Isolate* isolate, QueryRegistry* registry) {
 
     if (_profile != nullptr && profiling()) {
       result.profile = _profile->toJson(TRI_UNKNOWN_MEM_ZONE);
+
+      if (result.profile != nullptr && nodes.isArray()) {
+        TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, result.profile, "nodes", nodes.steal());
+      }
     }
 
     return result;
@@ -937,26 +959,27 @@ char* Query::registerString (char const* p,
     return const_cast<char*>(empty);
   }
 
+  if (_strings == nullptr) {
+    _strings = TRI_CreateArenaMemoryZone(StringsChunkSize);
+
+    if (_strings == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+  }
+
   char* copy = nullptr;
   if (mustUnescape) {
     size_t outLength;
-    copy = TRI_UnescapeUtf8StringZ(TRI_UNKNOWN_MEM_ZONE, p, length, &outLength);
+    copy = TRI_UnescapeUtf8StringZ(_strings, p, length, &outLength);
   }
   else {
-    copy = TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, p, length);
+    copy = TRI_DuplicateString2Z(_strings, p, length);
   }
 
   if (copy == nullptr) {
     THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
   }
 
-  try {
-    _strings.emplace_back(copy);
-  }
-  catch (...) {
-    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
-  }
-
   return copy;
 }
 
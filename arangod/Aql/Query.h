@@ -296,6 +296,19 @@ namespace triagens {
           return 0;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows a SORT may buffer before it writes a sorted run to
+/// a temporary file, 0 means everything is sorted in memory
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t spillThreshold () const {
+          double value = getNumericOption("spillThreshold", 0.0);
+          if (value > 0) {
+            return static_cast<size_t>(value);
+          }
+          return 0;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief extract a region from the query
 ////////////////////////////////////////////////////////////////////////////////
@@ -615,10 +628,11 @@ namespace triagens {
         Collections                       _collections;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief all strings created in the query - used for easy memory deallocation
+/// @brief arena memory zone for all strings created in the query. it is
+/// created lazily and freed with the query in one go
 ////////////////////////////////////////////////////////////////////////////////
 
-        std::vector<char const*>          _strings;
+        TRI_memory_zone_t*                _strings;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief _ast, we need an ast to manage the memory for AstNodes, even
@@ -32,6 +32,7 @@
 #include "Aql/ExecutionBlock.h"
 #include "Basics/ConditionLocker.h"
 #include "Basics/StringUtils.h"
+#include "Basics/json-utilities.h"
 #include "HttpServer/HttpServer.h"
 #include "HttpServer/HttpHandlerFactory.h"
 #include "Rest/HttpRequest.h"
@@ -348,6 +349,11 @@ void RestAqlHandler::createQueryFromString () {
 ///             AqlItemBlock.
 ///             If "atLeast" is not given it defaults to 1, if "atMost" is not
 ///             given it defaults to ExecutionBlock::DefaultBatchSize.
+///             If the request has the HTTP header "Accept:" set to
+///             "application/x-arango-aql-block", the result is sent in a
+///             compact binary representation instead: a flags byte (1 if the
+///             cursor is exhausted), the binary encoded statistics and, if
+///             not exhausted, the binary representation of the AqlItemBlock.
 /// For the "skipSome" operation one has to give:
 ///   "atLeast": 
 ///   "atMost": both must be positive integers, the cursor skips never 
@@ -724,6 +730,36 @@ void RestAqlHandler::handleUseQuery (std::string const& operation,
       }
       items.reset(block->getSomeForShard(atLeast, atMost, shardId));
     }
+
+    char const* accept = _request->header("accept", found);
+    if (found && accept != nullptr && AqlItemBlock::BinaryContentType == accept) {
+      // the client understands the binary representation of AqlItemBlocks
+      _response = createResponse(triagens::rest::HttpResponse::OK);
+      _response->setContentType(AqlItemBlock::BinaryContentType);
+
+      try {
+        StringBuffer& out = _response->body();
+        Json stats(query->getStats());
+
+        out.appendChar(items.get() == nullptr ? 1 : 0);
+        int res = TRI_EncodeBinaryJson(out.stringBuffer(), stats.json());
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          THROW_ARANGO_EXCEPTION(res);
+        }
+
+        if (items.get() != nullptr) {
+          items->toBinary(query->trx(), out);
+        }
+      }
+      catch (...) {
+        LOG_ERROR("cannot transform AqlItemBlock to binary");
+        generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_HTTP_SERVER_ERROR,
+                      "cannot transform AqlItemBlock to binary");
+      }
+      return;
+    }
+
     if (items.get() == nullptr) {
       answerBody("exhausted", Json(true))
         ("error", Json(false))
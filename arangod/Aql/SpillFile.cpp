@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief AQL temporary file for item blocks that do not fit into memory
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/SpillFile.h"
+#include "Aql/AqlItemBlock.h"
+#include "Basics/Exceptions.h"
+#include "Basics/StringBuffer.h"
+#include "Basics/files.h"
+#include "Basics/logging.h"
+
+using namespace triagens::aql;
+using StringBuffer = triagens::basics::StringBuffer;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an empty temporary file, throws if this is not possible
+////////////////////////////////////////////////////////////////////////////////
+
+SpillFile::SpillFile ()
+  : _filename(),
+    _fd(-1),
+    _size(0),
+    _written(0),
+    _read(0),
+    _buffer() {
+
+  char* name = nullptr;
+  long systemError;
+  std::string errorMessage;
+
+  int res = TRI_GetTempName("aql", &name, false, systemError, errorMessage);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_CREATE_TEMP_FILE, errorMessage);
+  }
+
+  _filename = name;
+  TRI_Free(TRI_CORE_MEM_ZONE, name);
+
+  _fd = TRI_CREATE(_filename.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+
+  if (_fd < 0) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_CREATE_TEMP_FILE,
+                                   std::string("cannot create spill file '") + _filename + "'");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief close and remove the file
+////////////////////////////////////////////////////////////////////////////////
+
+SpillFile::~SpillFile () {
+  if (_fd >= 0) {
+    TRI_CLOSE(_fd);
+  }
+
+  int res = TRI_UnlinkFile(_filename.c_str());
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    LOG_WARNING("cannot remove spill file '%s'", _filename.c_str());
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a block to the file. each block is stored as its length in
+/// 4 bytes followed by the output of AqlItemBlock::toBinary
+////////////////////////////////////////////////////////////////////////////////
+
+void SpillFile::write (triagens::arango::AqlTransaction* trx,
+                       AqlItemBlock const* block) {
+  StringBuffer out(TRI_UNKNOWN_MEM_ZONE);
+
+  // reserve the length field, it is filled in below
+  uint32_t length = 0;
+  out.appendText(reinterpret_cast<char const*>(&length), sizeof(length));
+  block->toBinary(trx, out);
+
+  if (out.length() - sizeof(length) > UINT32_MAX) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_WRITE_FILE, "block too big for spill file");
+  }
+
+  length = static_cast<uint32_t>(out.length() - sizeof(length));
+  memcpy(const_cast<char*>(out.c_str()), &length, sizeof(length));
+
+  if (! TRI_WritePointer(_fd, out.c_str(), out.length())) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_WRITE_FILE,
+                                   std::string("cannot write spill file '") + _filename + "'");
+  }
+
+  _size += static_cast<int64_t>(out.length());
+  _written++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finish writing and position the file at the first block
+////////////////////////////////////////////////////////////////////////////////
+
+void SpillFile::rewind () {
+  if (TRI_LSEEK(_fd, 0, SEEK_SET) != 0) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_WRITE_FILE,
+                                   std::string("cannot rewind spill file '") + _filename + "'");
+  }
+
+  _read = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read the next block, returns nullptr when all blocks were read
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* SpillFile::read () {
+  if (_read == _written) {
+    return nullptr;
+  }
+
+  uint32_t length;
+
+  if (! TRI_ReadPointer(_fd, &length, sizeof(length))) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                                   std::string("cannot read spill file '") + _filename + "'");
+  }
+
+  _buffer.resize(length);
+
+  if (! TRI_ReadPointer(_fd, &_buffer[0], length)) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                                   std::string("cannot read spill file '") + _filename + "'");
+  }
+
+  char const* p = _buffer.c_str();
+  AqlItemBlock* block = AqlItemBlock::fromBinary(&p, p + length);
+  _read++;
+
+  return block;
+}
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief AQL temporary file for item blocks that do not fit into memory
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_SPILL_FILE_H
+#define ARANGODB_AQL_SPILL_FILE_H 1
+
+#include "Basics/Common.h"
+
+namespace triagens {
+  namespace arango {
+    class AqlTransaction;
+  }
+
+  namespace aql {
+
+    class AqlItemBlock;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   class SpillFile
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief SpillFile, a temporary file holding a sequence of AqlItemBlocks.
+/// blocks are appended in the binary format of AqlItemBlock::toBinary and
+/// can be read back in the same order after rewind(). the file is removed
+/// when the object is destroyed
+////////////////////////////////////////////////////////////////////////////////
+
+    class SpillFile {
+
+      public:
+
+        SpillFile (SpillFile const&) = delete;
+        SpillFile& operator= (SpillFile const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an empty temporary file, throws if this is not possible
+////////////////////////////////////////////////////////////////////////////////
+
+        SpillFile ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief close and remove the file
+////////////////////////////////////////////////////////////////////////////////
+
+        ~SpillFile ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a block to the file. values lose their document collection
+/// and come back as JSON
+////////////////////////////////////////////////////////////////////////////////
+
+        void write (triagens::arango::AqlTransaction*,
+                    AqlItemBlock const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finish writing and position the file at the first block
+////////////////////////////////////////////////////////////////////////////////
+
+        void rewind ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read the next block, returns nullptr when all blocks were read.
+/// the caller owns the returned block
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* read ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of bytes written to the file
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t size () const {
+          return _size;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief name of the file
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _filename;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief file descriptor
+////////////////////////////////////////////////////////////////////////////////
+
+        int _fd;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of bytes written
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t _size;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of blocks written and read
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _written;
+
+        size_t _read;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read buffer, reused for all blocks
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _buffer;
+    };
+
+  }
+}
+
+#endif
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
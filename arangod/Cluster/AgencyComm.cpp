@@ -250,7 +250,8 @@ void AgencyCommResult::clear () {
 
 bool AgencyCommResult::parseJsonNode (TRI_json_t const* node,
                                       std::string const& stripKeyPrefix,
-                                      bool withDirs) {
+                                      bool withDirs,
+                                      std::map<std::string, uint64_t> const* knownIndexes) {
   if (! TRI_IsObjectJson(node)) {
     return true;
   }
@@ -305,7 +306,8 @@ bool AgencyCommResult::parseJsonNode (TRI_json_t const* node,
     for (size_t i = 0; i < n; ++i) {
       if (! parseJsonNode((TRI_json_t const*) TRI_AtVector(&nodes->_value._objects, i),
                            stripKeyPrefix,
-                           withDirs)) {
+                           withDirs,
+                           knownIndexes)) {
         return false;
       }
     }
@@ -322,9 +324,21 @@ bool AgencyCommResult::parseJsonNode (TRI_json_t const* node,
 
         // get "modifiedIndex"
         entry._index = triagens::basics::JsonHelper::stringUInt64(node, "modifiedIndex");
-        entry._json  = triagens::basics::JsonHelper::fromString(value->_value._string.data, value->_value._string.length - 1);
+        entry._json  = nullptr;
         entry._isDir = false;
 
+        if (knownIndexes != nullptr) {
+          auto it = knownIndexes->find(prefix);
+
+          if (it != knownIndexes->end() && (*it).second == entry._index) {
+            // value has not changed since the caller has seen it
+            _values.emplace(std::make_pair(prefix, entry));
+            return true;
+          }
+        }
+
+        entry._json  = triagens::basics::JsonHelper::fromString(value->_value._string.data, value->_value._string.length - 1);
+
         _values.emplace(std::make_pair(prefix, entry));
       }
     }
@@ -339,7 +353,8 @@ bool AgencyCommResult::parseJsonNode (TRI_json_t const* node,
 ////////////////////////////////////////////////////////////////////////////////
 
 bool AgencyCommResult::parse (std::string const& stripKeyPrefix,
-                              bool withDirs) {
+                              bool withDirs,
+                              std::map<std::string, uint64_t> const* knownIndexes) {
   TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, _body.c_str());
 
   if (! TRI_IsObjectJson(json)) {
@@ -352,7 +367,7 @@ bool AgencyCommResult::parse (std::string const& stripKeyPrefix,
   // get "node" attribute
   TRI_json_t const* node = TRI_LookupObjectJson(json, "node");
 
-  const bool result = parseJsonNode(node, stripKeyPrefix, withDirs);
+  const bool result = parseJsonNode(node, stripKeyPrefix, withDirs, knownIndexes);
   TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
 
   return result;
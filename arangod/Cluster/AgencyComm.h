@@ -214,12 +214,15 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief recursively flatten the JSON response into a map
 ///
-/// stripKeyPrefix is decoded, as is the _globalPrefix
+/// stripKeyPrefix is decoded, as is the _globalPrefix. if knownIndexes is
+/// given, the values of all keys with an unchanged modifiedIndex are not
+/// parsed and their entries have a _json of nullptr
 ////////////////////////////////////////////////////////////////////////////////
 
       bool parseJsonNode (TRI_json_t const*,
                           std::string const&,
-                          bool);
+                          bool,
+                          std::map<std::string, uint64_t> const* = nullptr);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// parse an agency result
@@ -227,7 +230,8 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
       bool parse (std::string const&,
-                  bool);
+                  bool,
+                  std::map<std::string, uint64_t> const* = nullptr);
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
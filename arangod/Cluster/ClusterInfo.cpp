@@ -37,6 +37,7 @@
 #include "Basics/vector.h"
 #include "Basics/json-utilities.h"
 #include "Basics/JsonHelper.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/ReadLocker.h"
 #include "Basics/WriteLocker.h"
 #include "Basics/StringUtils.h"
@@ -266,10 +267,17 @@ ClusterInfo::ClusterInfo ()
     _uniqid(),
     _plannedDatabases(),
     _currentDatabases(),
+    _plannedCollections(new PlannedCollections()),
     _collectionsValid(false),
+    _currentCollections(new CurrentCollections()),
+    _collectionsCurrentValid(false),
     _serversValid(false),
     _DBServersValid(false),
-    _coordinatorsValid(false) {
+    _coordinatorsValid(false),
+    _plannedCollectionsLoadsStarted(0),
+    _plannedCollectionsLoadInstalled(0),
+    _currentCollectionsLoadsStarted(0),
+    _currentCollectionsLoadInstalled(0) {
 
   _uniqid._currentValue = _uniqid._upperValue = 0ULL;
 
@@ -327,21 +335,43 @@ uint64_t ClusterInfo::uniqid (uint64_t count) {
 void ClusterInfo::flush () {
   WRITE_LOCKER(_lock);
 
+  // the collection snapshots are kept as the base for the next reload,
+  // which will only parse the entries that have changed meanwhile
   _collectionsValid = false;
   _collectionsCurrentValid = false;
   _serversValid = false;
   _DBServersValid = false;
   _coordinatorsValid = false;
 
-  _collections.clear();
-  _collectionsCurrent.clear();
   _servers.clear();
-  _shardIds.clear();
 
   clearPlannedDatabases();
   clearCurrentDatabases();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief notification that the Plan has changed
+////////////////////////////////////////////////////////////////////////////////
+
+void ClusterInfo::planChanged () {
+  {
+    WRITE_LOCKER(_lock);
+
+    _collectionsCurrentValid = false;
+    _serversValid = false;
+    _DBServersValid = false;
+    _coordinatorsValid = false;
+
+    _servers.clear();
+
+    clearPlannedDatabases();
+    clearCurrentDatabases();
+  }
+
+  // the planned collections stay valid until the new snapshot is there
+  loadPlannedCollections(true);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief ask whether a cluster database exists
 ////////////////////////////////////////////////////////////////////////////////
@@ -575,10 +605,42 @@ void ClusterInfo::loadCurrentDatabases () {
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief (re-)load the information about collections from the agency
 /// Usually one does not have to call this directly.
+///
+/// The new snapshot is built outside of _lock from the previous one: only
+/// the collections whose agency entries have a new modifiedIndex are parsed
+/// again. Concurrent reloads of readers are serialized, and a reader skips
+/// its reload if another one that started later has already finished.
 ////////////////////////////////////////////////////////////////////////////////
 
 static const std::string prefixPlannedCollections = "Plan/Collections";
 void ClusterInfo::loadPlannedCollections (bool acquireLock) {
+  uint64_t seen;
+  {
+    READ_LOCKER(_lock);
+    seen = _plannedCollectionsLoadsStarted;
+  }
+
+  // a caller without acquireLock holds the Plan lock in the agency itself
+  // and must not wait for a reader that waits for the agency lock
+  std::unique_ptr<triagens::basics::MutexLocker> loadLocker;
+
+  if (acquireLock) {
+    loadLocker.reset(new triagens::basics::MutexLocker(&_plannedCollectionsLoadLock));
+  }
+
+  uint64_t ticket;
+  shared_ptr<PlannedCollections const> previous;
+  {
+    WRITE_LOCKER(_lock);
+
+    if (acquireLock && _collectionsValid && _plannedCollectionsLoadInstalled > seen) {
+      // somebody else has loaded the collections after we were called
+      return;
+    }
+
+    ticket = ++_plannedCollectionsLoadsStarted;
+    previous = _plannedCollections;
+  }
 
   AgencyCommResult result;
 
@@ -596,11 +658,10 @@ void ClusterInfo::loadPlannedCollections (bool acquireLock) {
   }
 
   if (result.successful()) {
-    result.parse(prefixPlannedCollections + "/", false);
+    result.parse(prefixPlannedCollections + "/", false, &previous->_indexes);
 
-    WRITE_LOCKER(_lock);
-    _collections.clear();
-    _shards.clear();
+    shared_ptr<PlannedCollections> snapshot(new PlannedCollections());
+    size_t reused = 0;
 
     std::map<std::string, AgencyCommResultEntry>::iterator it = result._values.begin();
 
@@ -619,42 +680,76 @@ void ClusterInfo::loadPlannedCollections (bool acquireLock) {
       const std::string database   = parts[0];
       const std::string collection = parts[1];
 
-      // check whether we have created an entry for the database already
-      AllCollections::iterator it2 = _collections.find(database);
+      shared_ptr<CollectionInfo> collectionData;
 
-      if (it2 == _collections.end()) {
-        // not yet, so create an entry for the database
-        DatabaseCollections empty;
-        _collections.emplace(std::make_pair(database, empty));
-        it2 = _collections.find(database);
-      }
+      if ((*it).second._json == nullptr) {
+        // unchanged since the previous snapshot, reuse its entry
+        AllCollections::const_iterator old = previous->_collections.find(database);
 
-      TRI_json_t* json = (*it).second._json;
-      // steal the json
-      (*it).second._json = nullptr;
+        if (old != previous->_collections.end()) {
+          DatabaseCollections::const_iterator old2 = (*old).second.find(collection);
+
+          if (old2 != (*old).second.end()) {
+            collectionData = (*old2).second;
+          }
+        }
+
+        if (collectionData == nullptr) {
+          // the entry was not usable last time either
+          continue;
+        }
 
-      shared_ptr<CollectionInfo> collectionData (new CollectionInfo(json));
-      vector<string>* shardKeys = new vector<string>;
-      *shardKeys = collectionData->shardKeys();
-      _shardKeys.insert(
-                    make_pair(collection, shared_ptr<vector<string> > (shardKeys)));
-      map<ShardID, ServerID> shardIDs = collectionData->shardIds();
-      vector<string>* shards = new vector<string>;
-      map<ShardID, ServerID>::iterator it3;
-      for (it3 = shardIDs.begin(); it3 != shardIDs.end(); ++it3) {
-        shards->push_back(it3->first);
+        auto keys = previous->_shardKeys.find(collection);
+        auto shards = previous->_shards.find(collection);
+        if (keys != previous->_shardKeys.end() && shards != previous->_shards.end()) {
+          snapshot->_shardKeys.emplace(collection, (*keys).second);
+          snapshot->_shards.emplace(collection, (*shards).second);
+        }
+        ++reused;
+      }
+      else {
+        TRI_json_t* json = (*it).second._json;
+        // steal the json
+        (*it).second._json = nullptr;
+
+        collectionData.reset(new CollectionInfo(json));
+        vector<string>* shardKeys = new vector<string>;
+        *shardKeys = collectionData->shardKeys();
+        snapshot->_shardKeys.insert(
+                      make_pair(collection, shared_ptr<vector<string> > (shardKeys)));
+        map<ShardID, ServerID> shardIDs = collectionData->shardIds();
+        vector<string>* shards = new vector<string>;
+        map<ShardID, ServerID>::iterator it3;
+        for (it3 = shardIDs.begin(); it3 != shardIDs.end(); ++it3) {
+          shards->push_back(it3->first);
+        }
+        snapshot->_shards.emplace(
+                std::make_pair(collection, shared_ptr<vector<string> >(shards)));
       }
-      _shards.emplace(
-              std::make_pair(collection, shared_ptr<vector<string> >(shards)));
+
+      snapshot->_indexes.emplace(key, (*it).second._index);
 
       // insert the collection into the existing map, insert it under its
       // ID as well as under its name, so that a lookup can be done with
       // either of the two.
+      DatabaseCollections& databaseCollections = snapshot->_collections[database];
+
+      databaseCollections.emplace(std::make_pair(collection, collectionData));
+      databaseCollections.emplace(std::make_pair(collectionData->name(),
+                                                 collectionData));
+    }
 
-      (*it2).second.emplace(std::make_pair(collection, collectionData));
-      (*it2).second.emplace(std::make_pair(collectionData->name(),
-                                           collectionData));
+    LOG_TRACE("loaded %s, reused %llu of %llu entries",
+              prefixPlannedCollections.c_str(),
+              (unsigned long long) reused,
+              (unsigned long long) result._values.size());
 
+    WRITE_LOCKER(_lock);
+
+    if (ticket > _plannedCollectionsLoadInstalled) {
+      // a reload started after ours may have finished first
+      _plannedCollections = snapshot;
+      _plannedCollectionsLoadInstalled = ticket;
     }
     _collectionsValid = true;
     return;
@@ -664,6 +759,19 @@ void ClusterInfo::loadPlannedCollections (bool acquireLock) {
   _collectionsValid = false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the current snapshot of the planned collections
+////////////////////////////////////////////////////////////////////////////////
+
+shared_ptr<ClusterInfo::PlannedCollections const> ClusterInfo::plannedCollections () {
+  if (! _collectionsValid) {
+    loadPlannedCollections(true);
+  }
+
+  READ_LOCKER(_lock);
+  return _plannedCollections;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief ask about a collection
 /// If it is not found in the cache, the cache is reloaded once
@@ -680,25 +788,28 @@ shared_ptr<CollectionInfo> ClusterInfo::getCollection
   }
 
   while (true) {   // left by break
+    shared_ptr<PlannedCollections const> snapshot;
     {
       READ_LOCKER(_lock);
-      // look up database by id
-      AllCollections::const_iterator it = _collections.find(databaseID);
+      snapshot = _plannedCollections;
+    }
 
-      if (it != _collections.end()) {
-        // look up collection by id (or by name)
-        DatabaseCollections::const_iterator it2 = (*it).second.find(collectionID);
+    // look up database by id
+    AllCollections::const_iterator it = snapshot->_collections.find(databaseID);
 
-        if (it2 != (*it).second.end()) {
-          return (*it2).second;
-        }
+    if (it != snapshot->_collections.end()) {
+      // look up collection by id (or by name)
+      DatabaseCollections::const_iterator it2 = (*it).second.find(collectionID);
+
+      if (it2 != (*it).second.end()) {
+        return (*it2).second;
       }
     }
+
     if (++tries >= 2) {
       break;
     }
 
-    // must load collections outside the lock
     loadPlannedCollections(true);
   }
 
@@ -756,11 +867,16 @@ const std::vector<shared_ptr<CollectionInfo> > ClusterInfo::getCollections
   // always reload
   loadPlannedCollections(true);
 
-  READ_LOCKER(_lock);
+  shared_ptr<PlannedCollections const> snapshot;
+  {
+    READ_LOCKER(_lock);
+    snapshot = _plannedCollections;
+  }
+
   // look up database by id
-  AllCollections::const_iterator it = _collections.find(databaseID);
+  AllCollections::const_iterator it = snapshot->_collections.find(databaseID);
 
-  if (it == _collections.end()) {
+  if (it == snapshot->_collections.end()) {
     return result;
   }
 
@@ -789,6 +905,31 @@ const std::vector<shared_ptr<CollectionInfo> > ClusterInfo::getCollections
 
 static const std::string prefixCurrentCollections = "Current/Collections";
 void ClusterInfo::loadCurrentCollections (bool acquireLock) {
+  uint64_t seen;
+  {
+    READ_LOCKER(_lock);
+    seen = _currentCollectionsLoadsStarted;
+  }
+
+  std::unique_ptr<triagens::basics::MutexLocker> loadLocker;
+
+  if (acquireLock) {
+    loadLocker.reset(new triagens::basics::MutexLocker(&_currentCollectionsLoadLock));
+  }
+
+  uint64_t ticket;
+  shared_ptr<CurrentCollections const> previous;
+  {
+    WRITE_LOCKER(_lock);
+
+    if (acquireLock && _collectionsCurrentValid && _currentCollectionsLoadInstalled > seen) {
+      // somebody else has loaded the collections after we were called
+      return;
+    }
+
+    ticket = ++_currentCollectionsLoadsStarted;
+    previous = _currentCollections;
+  }
 
   AgencyCommResult result;
 
@@ -806,11 +947,40 @@ void ClusterInfo::loadCurrentCollections (bool acquireLock) {
   }
 
   if (result.successful()) {
-    result.parse(prefixCurrentCollections + "/", false);
+    result.parse(prefixCurrentCollections + "/", false, &previous->_indexes);
 
-    WRITE_LOCKER(_lock);
-    _collectionsCurrent.clear();
-    _shardIds.clear();
+    shared_ptr<CurrentCollections> snapshot(new CurrentCollections());
+
+    // A collection of the previous snapshot can only be reused if none of
+    // its shard entries has changed and no shard has been added or removed.
+    // Count the unchanged entries per collection first:
+    std::map<std::string, size_t> unchanged;
+    std::map<std::string, size_t> entries;
+
+    for (auto const& it : result._values) {
+      std::string::size_type pos = it.first.rfind('/');
+
+      if (pos == std::string::npos) {
+        continue;
+      }
+
+      std::string const prefix = it.first.substr(0, pos);
+      ++entries[prefix];
+
+      if (it.second._json == nullptr) {
+        ++unchanged[prefix];
+      }
+    }
+
+    std::map<std::string, size_t> previousEntries;
+
+    for (auto const& it : previous->_indexes) {
+      std::string::size_type pos = it.first.rfind('/');
+
+      if (pos != std::string::npos) {
+        ++previousEntries[it.first.substr(0, pos)];
+      }
+    }
 
     std::map<std::string, AgencyCommResultEntry>::iterator it = result._values.begin();
 
@@ -831,28 +1001,75 @@ void ClusterInfo::loadCurrentCollections (bool acquireLock) {
       const std::string collection = parts[1];
       const std::string shardID    = parts[2];
 
-      // check whether we have created an entry for the database already
-      AllCollectionsCurrent::iterator it2 = _collectionsCurrent.find(database);
+      std::string const prefix = database + "/" + collection;
+      bool const reusable = (unchanged[prefix] == entries[prefix] &&
+                             previousEntries[prefix] == entries[prefix]);
 
-      if (it2 == _collectionsCurrent.end()) {
-        // not yet, so create an entry for the database
-        DatabaseCollectionsCurrent empty;
-        _collectionsCurrent.insert(std::make_pair(database, empty));
-        it2 = _collectionsCurrent.find(database);
+      DatabaseCollectionsCurrent& databaseCollections = snapshot->_collections[database];
+
+      if (reusable) {
+        // all shards of the collection are unchanged, reuse its entry
+        AllCollectionsCurrent::const_iterator old = previous->_collections.find(database);
+
+        if (old == previous->_collections.end()) {
+          continue;
+        }
+
+        DatabaseCollectionsCurrent::const_iterator old2 = (*old).second.find(collection);
+
+        if (old2 == (*old).second.end()) {
+          continue;
+        }
+
+        databaseCollections.emplace(collection, (*old2).second);
+
+        auto server = previous->_shardIds.find(shardID);
+
+        if (server != previous->_shardIds.end()) {
+          snapshot->_shardIds.emplace(shardID, (*server).second);
+        }
+
+        snapshot->_indexes.emplace(key, (*it).second._index);
+        continue;
       }
 
       TRI_json_t* json = (*it).second._json;
-      // steal the json
-      (*it).second._json = nullptr;
+
+      if (json == nullptr) {
+        // unchanged shard of a changed collection, copy its value from the
+        // previous snapshot
+        AllCollectionsCurrent::const_iterator old = previous->_collections.find(database);
+
+        if (old != previous->_collections.end()) {
+          DatabaseCollectionsCurrent::const_iterator old2 = (*old).second.find(collection);
+
+          if (old2 != (*old).second.end()) {
+            TRI_json_t const* shardJson = (*old2).second->shardJson(shardID);
+
+            if (shardJson != nullptr) {
+              json = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, shardJson);
+            }
+          }
+        }
+
+        if (json == nullptr) {
+          continue;
+        }
+      }
+      else {
+        // steal the json
+        (*it).second._json = nullptr;
+      }
+
+      snapshot->_indexes.emplace(key, (*it).second._index);
 
       // check whether we already have a CollectionInfoCurrent:
       DatabaseCollectionsCurrent::iterator it3;
-      it3 = it2->second.find(collection);
-      if (it3 == it2->second.end()) {
+      it3 = databaseCollections.find(collection);
+      if (it3 == databaseCollections.end()) {
         shared_ptr<CollectionInfoCurrent> collectionDataCurrent
                     (new CollectionInfoCurrent(shardID, json));
-        it2->second.insert(make_pair(collection, collectionDataCurrent));
-        it3 = it2->second.find(collection);
+        databaseCollections.insert(make_pair(collection, collectionDataCurrent));
       }
       else {
         it3->second->add(shardID, json);
@@ -869,9 +1086,17 @@ void ClusterInfo::loadCurrentCollections (bool acquireLock) {
       std::string DBserver = triagens::basics::JsonHelper::getStringValue
                     (json, "DBServer", "");
       if (DBserver != "") {
-        _shardIds.insert(make_pair(shardID, DBserver));
+        snapshot->_shardIds.insert(make_pair(shardID, DBserver));
       }
     }
+
+    WRITE_LOCKER(_lock);
+
+    if (ticket > _currentCollectionsLoadInstalled) {
+      // a reload started after ours may have finished first
+      _currentCollections = snapshot;
+      _currentCollectionsLoadInstalled = ticket;
+    }
     _collectionsCurrentValid = true;
     return;
   }
@@ -880,6 +1105,19 @@ void ClusterInfo::loadCurrentCollections (bool acquireLock) {
   _collectionsCurrentValid = false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the current snapshot of the current collections
+////////////////////////////////////////////////////////////////////////////////
+
+shared_ptr<ClusterInfo::CurrentCollections const> ClusterInfo::currentCollections () {
+  if (! _collectionsCurrentValid) {
+    loadCurrentCollections(true);
+  }
+
+  READ_LOCKER(_lock);
+  return _currentCollections;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief ask about a collection in current. This returns information about
 /// all shards in the collection.
@@ -897,26 +1135,28 @@ shared_ptr<CollectionInfoCurrent> ClusterInfo::getCollectionCurrent
   }
 
   while (true) {
+    shared_ptr<CurrentCollections const> snapshot;
     {
       READ_LOCKER(_lock);
-      // look up database by id
-      AllCollectionsCurrent::const_iterator it = _collectionsCurrent.find(databaseID);
+      snapshot = _currentCollections;
+    }
 
-      if (it != _collectionsCurrent.end()) {
-        // look up collection by id
-        DatabaseCollectionsCurrent::const_iterator it2 = (*it).second.find(collectionID);
+    // look up database by id
+    AllCollectionsCurrent::const_iterator it = snapshot->_collections.find(databaseID);
 
-        if (it2 != (*it).second.end()) {
-          return (*it2).second;
-        }
+    if (it != snapshot->_collections.end()) {
+      // look up collection by id
+      DatabaseCollectionsCurrent::const_iterator it2 = (*it).second.find(collectionID);
+
+      if (it2 != (*it).second.end()) {
+        return (*it2).second;
       }
     }
-    
+
     if (++tries >= 2) {
       break;
     }
 
-    // must load collections outside the lock
     loadCurrentCollections(true);
   }
 
@@ -1136,9 +1376,14 @@ int ClusterInfo::createCollectionCoordinator (string const& databaseName,
       // check if a collection with the same name is already planned
       loadPlannedCollections(false);
 
-      READ_LOCKER(_lock);
-      AllCollections::const_iterator it = _collections.find(databaseName);
-      if (it != _collections.end()) {
+      shared_ptr<PlannedCollections const> snapshot;
+      {
+        READ_LOCKER(_lock);
+        snapshot = _plannedCollections;
+      }
+
+      AllCollections::const_iterator it = snapshot->_collections.find(databaseName);
+      if (it != snapshot->_collections.end()) {
         const std::string name = JsonHelper::getStringValue(json, "name", "");
 
         DatabaseCollections::const_iterator it2 = (*it).second.find(name);
@@ -2131,13 +2376,16 @@ ServerID ClusterInfo::getResponsibleServer (ShardID const& shardID) {
   }
 
   while (true) {
+    shared_ptr<CurrentCollections const> snapshot;
     {
       READ_LOCKER(_lock);
-      std::map<ShardID, ServerID>::const_iterator it = _shardIds.find(shardID);
+      snapshot = _currentCollections;
+    }
 
-      if (it != _shardIds.end()) {
-        return (*it).second;
-      }
+    std::map<ShardID, ServerID>::const_iterator it = snapshot->_shardIds.find(shardID);
+
+    if (it != snapshot->_shardIds.end()) {
+      return (*it).second;
     }
 
     if (++tries >= 2) {
@@ -2189,16 +2437,22 @@ int ClusterInfo::getResponsibleShard (CollectionID const& collectionID,
 
   while (true) {
     {
-      // Get the sharding keys and the number of shards:
-      READ_LOCKER(_lock);
-      map<CollectionID, shared_ptr<vector<string>>>::iterator it
-          = _shards.find(collectionID);
+      // Get the sharding keys and the number of shards from the snapshot,
+      // no lock is held while hashing the document:
+      shared_ptr<PlannedCollections const> snapshot;
+      {
+        READ_LOCKER(_lock);
+        snapshot = _plannedCollections;
+      }
+
+      map<CollectionID, shared_ptr<vector<string>>>::const_iterator it
+          = snapshot->_shards.find(collectionID);
 
-      if (it != _shards.end()) {
+      if (it != snapshot->_shards.end()) {
         shards = it->second;
-        map<CollectionID, shared_ptr<vector<string>>>::iterator it2
-            = _shardKeys.find(collectionID);
-        if (it2 != _shardKeys.end()) {
+        map<CollectionID, shared_ptr<vector<string>>>::const_iterator it2
+            = snapshot->_shardKeys.find(collectionID);
+        if (it2 != snapshot->_shardKeys.end()) {
           shardKeysPtr = it2->second;
           shardKeys = new char const* [shardKeysPtr->size()];
           if (shardKeys != nullptr) {
@@ -33,6 +33,7 @@
 
 #include "Basics/Common.h"
 #include "Basics/JsonHelper.h"
+#include "Basics/Mutex.h"
 #include "Cluster/AgencyComm.h"
 #include "VocBase/collection.h"
 #include "VocBase/index.h"
@@ -670,6 +671,18 @@ namespace triagens {
           return std::string("");
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the JSON of one shardID, or nullptr if there is none
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_json_t const* shardJson (ShardID const& shardID) const {
+          std::map<ShardID, TRI_json_t*>::const_iterator it = _jsons.find(shardID);
+          if (it != _jsons.end()) {
+            return it->second;
+          }
+          return nullptr;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -704,6 +717,36 @@ namespace triagens {
         typedef std::map<DatabaseID, DatabaseCollectionsCurrent>
                 AllCollectionsCurrent;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief snapshot of Plan/Collections
+///
+/// A snapshot is never modified after it has been published. A reload
+/// builds a new snapshot, reusing the entries of the previous one whose
+/// agency modifiedIndex has not changed, and swaps it in. Readers keep
+/// the snapshot they have fetched for as long as they need it.
+////////////////////////////////////////////////////////////////////////////////
+
+        struct PlannedCollections {
+          AllCollections _collections;
+          std::map<CollectionID, std::shared_ptr<std::vector<std::string>>>
+                         _shards;
+          std::map<CollectionID, std::shared_ptr<std::vector<std::string>>>
+                         _shardKeys;
+          std::map<std::string, uint64_t> _indexes;
+                                        // agency key => modifiedIndex
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief snapshot of Current/Collections, see PlannedCollections
+////////////////////////////////////////////////////////////////////////////////
+
+        struct CurrentCollections {
+          AllCollectionsCurrent _collections;
+          std::map<ShardID, ServerID> _shardIds;
+          std::map<std::string, uint64_t> _indexes;
+                                        // agency key => modifiedIndex
+        };
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -764,6 +807,14 @@ namespace triagens {
 
         void flush ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief notification that the Plan has changed
+/// The planned collections are reloaded right away, readers keep using the
+/// previous snapshot meanwhile. All other caches are flushed.
+////////////////////////////////////////////////////////////////////////////////
+
+        void planChanged ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief ask whether a cluster database exists
 ////////////////////////////////////////////////////////////////////////////////
@@ -997,6 +1048,20 @@ namespace triagens {
 
       private:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the current snapshot of the planned collections, loads it
+/// if the cache is invalid
+////////////////////////////////////////////////////////////////////////////////
+
+        std::shared_ptr<PlannedCollections const> plannedCollections ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the current snapshot of the current collections, loads it
+/// if the cache is invalid
+////////////////////////////////////////////////////////////////////////////////
+
+        std::shared_ptr<CurrentCollections const> currentCollections ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief flushes the list of planned databases
 ////////////////////////////////////////////////////////////////////////////////
@@ -1061,10 +1126,10 @@ namespace triagens {
         std::map<DatabaseID, std::map<ServerID, struct TRI_json_t*> >
               _currentDatabases;        // from Current/Databases
 
-        AllCollections                  _collections;
+        std::shared_ptr<PlannedCollections const> _plannedCollections;
                                         // from Plan/Collections/
         bool                            _collectionsValid;
-        AllCollectionsCurrent           _collectionsCurrent;
+        std::shared_ptr<CurrentCollections const> _currentCollections;
                                         // from Current/Collections/
         bool                            _collectionsCurrentValid;
         std::map<ServerID, std::string> _servers;
@@ -1076,15 +1141,24 @@ namespace triagens {
         std::map<ServerID, ServerID>    _coordinators;
                                         // from Current/Coordinators
         bool                            _coordinatorsValid;
-        std::map<ShardID, ServerID>     _shardIds;
-                                        // from Current/Collections/
-        std::map<CollectionID, std::shared_ptr<std::vector<std::string>>>
-                                        _shards;
-                                        // from Plan/Collections/
-                               // (may later come from Current/Colletions/ )
-        std::map<CollectionID, std::shared_ptr<std::vector<std::string>>>
-                                        _shardKeys;
-                                        // from Plan/Collections/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief serializes the collection reloads of readers which found the
+/// cache invalid, so that a burst of cache misses causes only one reload
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Mutex         _plannedCollectionsLoadLock;
+        triagens::basics::Mutex         _currentCollectionsLoadLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of collection reloads started, and the number of the
+/// reload whose snapshot is currently installed, protected by _lock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t                        _plannedCollectionsLoadsStarted;
+        uint64_t                        _plannedCollectionsLoadInstalled;
+        uint64_t                        _currentCollectionsLoadsStarted;
+        uint64_t                        _currentCollectionsLoadInstalled;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                          private static variables
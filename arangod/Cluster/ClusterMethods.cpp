@@ -75,6 +75,59 @@ static T ExtractFigure (TRI_json_t const* json,
   return static_cast<T>(value->_value._number);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sorts out the _key attribute of a new document and determines the
+/// shard responsible for it
+////////////////////////////////////////////////////////////////////////////////
+
+static int PrepareDocumentForShard (ClusterInfo* ci,
+                                    shared_ptr<CollectionInfo> const& collinfo,
+                                    TRI_json_t* json,
+                                    ShardID& shardID) {
+  string const collid = StringUtils::itoa(collinfo->id());
+
+  // Sort out the _key attribute:
+  // The user is allowed to specify _key, provided that _key is the one
+  // and only sharding attribute, because in this case we can delegate
+  // the responsibility to make _key attributes unique to the responsible
+  // shard. Otherwise, we ensure uniqueness here and now by taking a
+  // cluster-wide unique number. Note that we only know the sharding
+  // attributes a bit further down the line when we have determined
+  // the responsible shard.
+  TRI_json_t* subjson = TRI_LookupObjectJson(json, TRI_VOC_ATTRIBUTE_KEY);
+  bool userSpecifiedKey = false;
+  if (subjson == nullptr) {
+    // The user did not specify a key, let's create one:
+    uint64_t uid = ci->uniqid();
+    string const _key = triagens::basics::StringUtils::itoa(uid);
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, TRI_VOC_ATTRIBUTE_KEY,
+                         TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE,
+                                                  _key.c_str(), _key.size()));
+  }
+  else {
+    userSpecifiedKey = true;
+  }
+
+  // Now find the responsible shard:
+  bool usesDefaultShardingAttributes;
+  int error = ci->getResponsibleShard( collid, json, true, shardID,
+                                       usesDefaultShardingAttributes );
+  if (error == TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
+    return TRI_ERROR_CLUSTER_SHARD_GONE;
+  }
+
+  // Now perform the above mentioned check:
+  if (userSpecifiedKey && ! usesDefaultShardingAttributes) {
+    return TRI_ERROR_CLUSTER_MUST_NOT_SPECIFY_KEY;
+  }
+
+  if (userSpecifiedKey && ! collinfo->allowUserKeys()) {
+    return TRI_ERROR_CLUSTER_MUST_NOT_SPECIFY_KEY;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief merge headers of a DB server response into the current response
 ////////////////////////////////////////////////////////////////////////////////
@@ -416,12 +469,14 @@ int figuresOnCoordinator (string const& dbname,
             result->_numberShapes         += ExtractFigure<TRI_voc_ssize_t>(figures, "shapes", "count");
             result->_numberAttributes     += ExtractFigure<TRI_voc_ssize_t>(figures, "attributes", "count");
             result->_numberIndexes        += ExtractFigure<TRI_voc_ssize_t>(figures, "indexes", "count");
+            result->_numberMasterPointers += ExtractFigure<TRI_voc_ssize_t>(figures, "masterPointers", "count");
 
             result->_sizeAlive            += ExtractFigure<int64_t>(figures, "alive", "size");
             result->_sizeDead             += ExtractFigure<int64_t>(figures, "dead", "size");
             result->_sizeShapes           += ExtractFigure<int64_t>(figures, "shapes", "size");
             result->_sizeAttributes       += ExtractFigure<int64_t>(figures, "attributes", "size");
             result->_sizeIndexes          += ExtractFigure<int64_t>(figures, "indexes", "size");
+            result->_sizeMasterPointers   += ExtractFigure<int64_t>(figures, "masterPointers", "size");
 
             result->_numberDatafiles      += ExtractFigure<TRI_voc_ssize_t>(figures, "datafiles", "count");
             result->_numberJournalfiles   += ExtractFigure<TRI_voc_ssize_t>(figures, "journals", "count");
@@ -547,50 +602,12 @@ int createDocumentOnCoordinator (
     return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
   }
 
-  string const collid = StringUtils::itoa(collinfo->id());
-
-  // Sort out the _key attribute:
-  // The user is allowed to specify _key, provided that _key is the one
-  // and only sharding attribute, because in this case we can delegate
-  // the responsibility to make _key attributes unique to the responsible
-  // shard. Otherwise, we ensure uniqueness here and now by taking a
-  // cluster-wide unique number. Note that we only know the sharding
-  // attributes a bit further down the line when we have determined
-  // the responsible shard.
-  TRI_json_t* subjson = TRI_LookupObjectJson(json, TRI_VOC_ATTRIBUTE_KEY);
-  bool userSpecifiedKey = false;
-  string _key;
-  if (subjson == nullptr) {
-    // The user did not specify a key, let's create one:
-    uint64_t uid = ci->uniqid();
-    _key = triagens::basics::StringUtils::itoa(uid);
-    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, TRI_VOC_ATTRIBUTE_KEY,
-                         TRI_CreateStringReferenceJson(TRI_UNKNOWN_MEM_ZONE,
-                                                       _key.c_str(), _key.size()));
-  }
-  else {
-    userSpecifiedKey = true;
-  }
-
-  // Now find the responsible shard:
-  bool usesDefaultShardingAttributes;
   ShardID shardID;
-  int error = ci->getResponsibleShard( collid, json, true, shardID,
-                                       usesDefaultShardingAttributes );
-  if (error == TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
-    return TRI_ERROR_CLUSTER_SHARD_GONE;
-  }
-
-  // Now perform the above mentioned check:
-  if (userSpecifiedKey && ! usesDefaultShardingAttributes) {
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
-    return TRI_ERROR_CLUSTER_MUST_NOT_SPECIFY_KEY;
-  }
+  int error = PrepareDocumentForShard(ci, collinfo, json, shardID);
 
-  if (userSpecifiedKey && ! collinfo->allowUserKeys()) {
+  if (error != TRI_ERROR_NO_ERROR) {
     TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
-    return TRI_ERROR_CLUSTER_MUST_NOT_SPECIFY_KEY;
+    return error;
   }
 
   string const body = JsonHelper::toString(json);
@@ -629,6 +646,198 @@ int createDocumentOnCoordinator (
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates many documents in a coordinator
+///
+/// The documents are grouped by their responsible shard and each shard
+/// receives a single import request, all shards are contacted in parallel.
+/// Each shard reports the outcome of every document, which is mapped back
+/// to the position of the document in the input and counted.
+///
+/// A shard that rejects its request as a whole has not stored any of its
+/// documents, they are counted as errors. Other shards may have stored
+/// theirs nevertheless. The error of the first rejecting shard is returned.
+////////////////////////////////////////////////////////////////////////////////
+
+int createDocumentsOnCoordinator (
+                string const& dbname,
+                string const& collname,
+                vector<TRI_json_t*>& documents,
+                string const& parameters,
+                vector<string>& errors,
+                map<string, size_t>& counts) {
+
+  // Set a few variables needed for our work:
+  ClusterInfo* ci = ClusterInfo::instance();
+  ClusterComm* cc = ClusterComm::instance();
+
+  size_t const n = documents.size();
+  errors.clear();
+  errors.resize(n);
+  counts.clear();
+
+  // First determine the collection ID from the name:
+  shared_ptr<CollectionInfo> collinfo = ci->getCollection(dbname, collname);
+
+  if (collinfo->empty()) {
+    for (auto json : documents) {
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+    }
+    documents.clear();
+    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+  }
+
+  // Now group the documents by their responsible shard, the position
+  // of each document in the input is kept to map the results back:
+  map<ShardID, vector<size_t>> positions;
+  map<ShardID, TRI_json_t*> bodies;
+
+  for (size_t i = 0; i < n; ++i) {
+    TRI_json_t* json = documents[i];
+    ShardID shardID;
+    int error = PrepareDocumentForShard(ci, collinfo, json, shardID);
+
+    if (error != TRI_ERROR_NO_ERROR) {
+      errors[i] = TRI_errno_string(error);
+      counts["errors"]++;
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+      continue;
+    }
+
+    auto it = bodies.find(shardID);
+
+    if (it == bodies.end()) {
+      it = bodies.emplace(shardID, TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE)).first;
+    }
+
+    // the shard body takes over the document
+    TRI_PushBack3ArrayJson(TRI_UNKNOWN_MEM_ZONE, (*it).second, json);
+    positions[shardID].push_back(i);
+  }
+
+  documents.clear();
+
+  // Send one request per shard, all of them in parallel:
+  CoordTransactionID coordTransactionID = TRI_NewTickServer();
+
+  for (auto& it : bodies) {
+    map<string, string>* headers = new map<string, string>;
+    string* body = new string(JsonHelper::toString(it.second));
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, it.second);
+
+    ClusterCommResult* res;
+    res = cc->asyncRequest("", coordTransactionID, "shard:" + it.first,
+                           triagens::rest::HttpRequest::HTTP_REQUEST_POST,
+                           "/_db/" + StringUtils::urlEncode(dbname) +
+                           "/_api/import?type=list&results=true&collection=" +
+                           StringUtils::urlEncode(it.first) + parameters,
+                           body, true, headers, NULL, 300.0);
+    delete res;
+  }
+
+  // Now listen to the results:
+  int result = TRI_ERROR_NO_ERROR;
+
+  for (size_t count = bodies.size(); count > 0; count--) {
+    ClusterCommResult* res = cc->wait("", coordTransactionID, 0, "", 0.0);
+    vector<size_t> const& shardPositions = positions[res->shardID];
+
+    int error = TRI_ERROR_NO_ERROR;
+    string errorMessage;
+    TRI_json_t* json = nullptr;
+
+    if (res->status == CL_COMM_TIMEOUT) {
+      error = TRI_ERROR_CLUSTER_TIMEOUT;
+    }
+    else if (res->status != CL_COMM_RECEIVED || res->answer == nullptr) {
+      error = TRI_ERROR_CLUSTER_CONNECTION_LOST;
+    }
+    else {
+      json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, res->answer->body());
+
+      if (! TRI_IsObjectJson(json)) {
+        error = TRI_ERROR_INTERNAL;
+      }
+      else if (JsonHelper::getBooleanValue(json, "error", false)) {
+        // the shard rejected the whole request
+        error = JsonHelper::getNumericValue<int>(json, "errorNum", TRI_ERROR_INTERNAL);
+        errorMessage = JsonHelper::getStringValue(json, "errorMessage", "");
+      }
+    }
+
+    if (error == TRI_ERROR_NO_ERROR) {
+      TRI_json_t const* results = TRI_LookupObjectJson(json, "results");
+
+      if (TRI_IsArrayJson(results)) {
+        // the shard reports one result per document, with <position> being
+        // the 1-based position of the document in the shard's list
+        vector<bool> reported(shardPositions.size(), false);
+        size_t const m = TRI_LengthArrayJson(results);
+
+        for (size_t j = 0; j < m; ++j) {
+          TRI_json_t const* entry = static_cast<TRI_json_t const*>(TRI_AtVector(&results->_value._objects, j));
+          size_t const position = JsonHelper::getNumericValue<size_t>(entry, "position", 0);
+
+          if (position == 0 || 
+              position > shardPositions.size() ||
+              reported[position - 1]) {
+            continue;
+          }
+
+          reported[position - 1] = true;
+          string const status = JsonHelper::getStringValue(entry, "status", "");
+
+          if (status == "created" || status == "updated" || status == "ignored") {
+            counts[status]++;
+          }
+          else {
+            int const errorNum = JsonHelper::getNumericValue<int>(entry, "errorNum", TRI_ERROR_INTERNAL);
+            errors[shardPositions[position - 1]] = JsonHelper::getStringValue(entry, "errorMessage", TRI_errno_string(errorNum));
+            counts["errors"]++;
+          }
+        }
+
+        for (size_t j = 0; j < shardPositions.size(); ++j) {
+          if (! reported[j]) {
+            errors[shardPositions[j]] = "no result reported by shard '" + res->shardID + "'";
+            counts["errors"]++;
+          }
+        }
+      }
+      else {
+        // without per-document results, at least keep the shard's counters
+        for (auto name : { "created", "errors", "updated", "ignored" }) {
+          counts[name] += JsonHelper::getNumericValue<size_t>(json, name, 0);
+        }
+      }
+    }
+    else {
+      if (errorMessage.empty()) {
+        errorMessage = TRI_errno_string(error);
+      }
+
+      // a rejected request stored none of the shard's documents. after a
+      // timeout or a lost connection this is unknown, they are counted as
+      // errors as well
+      for (auto i : shardPositions) {
+        errors[i] = errorMessage;
+      }
+      counts["errors"] += shardPositions.size();
+
+      if (result == TRI_ERROR_NO_ERROR) {
+        result = error;
+      }
+    }
+
+    if (json != nullptr) {
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+    }
+    delete res;
+  }
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief deletes a document in a coordinator
 ////////////////////////////////////////////////////////////////////////////////
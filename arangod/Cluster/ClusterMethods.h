@@ -121,6 +121,22 @@ namespace triagens {
                  std::map<std::string, std::string>& resultHeaders,
                  std::string& resultBody);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates many documents in a coordinator, using one request per
+/// responsible shard. takes over the documents. errors receives the error
+/// message for each document in input order (empty if the document was
+/// stored), counts the number of created, updated, ignored and failed
+/// documents. documents may have been stored even if an error is returned
+////////////////////////////////////////////////////////////////////////////////
+
+    int createDocumentsOnCoordinator (
+                 std::string const& dbname,
+                 std::string const& collname,
+                 std::vector<TRI_json_t*>& documents,
+                 std::string const& parameters,
+                 std::vector<std::string>& errors,
+                 std::map<std::string, size_t>& counts);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief delete a document in a coordinator
 ////////////////////////////////////////////////////////////////////////////////
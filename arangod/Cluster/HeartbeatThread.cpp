@@ -164,8 +164,10 @@ void HeartbeatThread::run () {
 
       // get the current version of the Plan
       AgencyCommResult result = _agency.getValues("Plan/Version", false);
+      uint64_t agencyIndex = 0;
 
       if (result.successful()) {
+        agencyIndex = result.index();
         result.parse("", false);
 
         std::map<std::string, AgencyCommResultEntry>::iterator it = result._values.begin();
@@ -176,6 +178,8 @@ void HeartbeatThread::run () {
 
           if (planVersion > lastPlanVersion) {
             handlePlanChangeCoordinator(planVersion, lastPlanVersion);
+            // check again right away, more changes may follow
+            agencyIndex = 0;
           }
         }
       }
@@ -220,6 +224,38 @@ void HeartbeatThread::run () {
           }
         }
       }
+
+      if (_stop) {
+        break;
+      }
+
+      const double remain = interval - (TRI_microtime() - start);
+
+      if (agencyIndex > 0 && remain > 0.0) {
+        // watch Plan/Version for changes, so that the collection cache is
+        // refreshed as soon as the plan changes
+        result.clear();
+
+        result = _agency.watchValue("Plan/Version",
+                                    agencyIndex + 1,
+                                    remain,
+                                    false);
+
+        if (result.successful()) {
+          result.parse("", false);
+          std::map<std::string, AgencyCommResultEntry>::iterator it = result._values.begin();
+
+          if (it != result._values.end()) {
+            // there is a plan version
+            uint64_t planVersion = triagens::basics::JsonHelper::stringUInt64((*it).second._json);
+
+            if (planVersion > lastPlanVersion) {
+              handlePlanChangeCoordinator(planVersion, lastPlanVersion);
+              shouldSleep = false;
+            }
+          }
+        }
+      }
     }
     else {
       // ! isCoordinator
@@ -403,8 +439,9 @@ bool HeartbeatThread::handlePlanChangeCoordinator (uint64_t currentPlanVersion,
   bool fetchingUsersFailed = false;
   LOG_TRACE("found a plan update");
 
-  // invalidate our local cache
-  ClusterInfo::instance()->flush();
+  // refresh our local cache, lookups are served from the previous
+  // snapshot of the planned collections until the new one is loaded
+  ClusterInfo::instance()->planChanged();
 
   AgencyCommResult result;
 
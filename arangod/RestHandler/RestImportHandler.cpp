@@ -32,6 +32,8 @@
 #include "Basics/JsonHelper.h"
 #include "Basics/StringUtils.h"
 #include "Basics/tri-strings.h"
+#include "Cluster/ClusterMethods.h"
+#include "Cluster/ServerState.h"
 #include "Rest/HttpRequest.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/edge-collection.h"
@@ -64,13 +66,6 @@ RestImportHandler::RestImportHandler (HttpRequest* request)
 ////////////////////////////////////////////////////////////////////////////////
 
 HttpHandler::status_t RestImportHandler::execute () {
-  if (ServerState::instance()->isCoordinator()) {
-    generateError(HttpResponse::NOT_IMPLEMENTED,
-                  TRI_ERROR_CLUSTER_UNSUPPORTED,
-                  "'/_api/import' is not yet supported in a cluster");
-    return status_t(HANDLER_DONE);
-  }
-  
   // set default value for onDuplicate
   _onDuplicateAction = DUPLICATE_ERROR;
       
@@ -155,6 +150,22 @@ bool RestImportHandler::extractComplete () const {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the "results" value. coordinators set it to get the outcome
+/// of every document, so they can map it back to their own input
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestImportHandler::extractResults () const {
+  bool found;
+  char const* results = _request->value("results", found);
+
+  if (found) {
+    return StringUtils::boolean(results);
+  }
+
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create a position string
 ////////////////////////////////////////////////////////////////////////////////
@@ -174,6 +185,20 @@ void RestImportHandler::registerError (RestImportResult& result,
   result._errors.push_back(errorMsg);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief register the outcome of a document, if requested
+////////////////////////////////////////////////////////////////////////////////
+
+void RestImportHandler::registerResult (RestImportResult& result,
+                                        size_t i,
+                                        char const* status,
+                                        int errorNum,
+                                        std::string const& errorMessage) {
+  if (result._withResults) {
+    result._results.push_back(RestImportDocumentResult{ i, status, errorNum, errorMessage });
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief construct an error message
 ////////////////////////////////////////////////////////////////////////////////
@@ -194,16 +219,13 @@ std::string RestImportHandler::buildParseError (size_t i,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief process a single JSON document
+/// @brief checks that a JSON value can be imported as a document
 ////////////////////////////////////////////////////////////////////////////////
 
-int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
-                                             RestImportResult& result,
-                                             char const* lineStart,
-                                             TRI_json_t const* json,
-                                             bool isEdgeCollection,
-                                             bool waitForSync,
-                                             size_t i) {
+int RestImportHandler::checkSingleDocument (RestImportResult& result,
+                                            char const* lineStart,
+                                            TRI_json_t const* json,
+                                            size_t i) {
 
   if (! TRI_IsObjectJson(json)) {
     std::string errorMsg;
@@ -225,9 +247,31 @@ int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
     return TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID;
   }
 
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process a single JSON document
+////////////////////////////////////////////////////////////////////////////////
+
+int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
+                                             RestImportResult& result,
+                                             char const* lineStart,
+                                             TRI_json_t const* json,
+                                             bool isEdgeCollection,
+                                             bool waitForSync,
+                                             size_t i) {
+
+  int res = checkSingleDocument(result, lineStart, json, i);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    registerResult(result, i, "error", res, result._errors.back().substr(positionise(i).size()));
+    return res;
+  }
+
   // document ok, now import it
   TRI_doc_mptr_copy_t document;
-  int res = TRI_ERROR_NO_ERROR;
+  char const* status = "created";
 
   if (isEdgeCollection) {
     char const* from = extractJsonStringValue(json, TRI_VOC_ATTRIBUTE_FROM);
@@ -240,9 +284,10 @@ int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
         part = part.substr(0, 255) + "...";
       }
     
-      std::string errorMsg = positionise(i) + "missing '_from' or '_to' attribute, offending document: " + part;
+      std::string errorMsg = "missing '_from' or '_to' attribute, offending document: " + part;
 
-      registerError(result, errorMsg);
+      registerError(result, positionise(i) + errorMsg);
+      registerResult(result, i, "error", TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE, errorMsg);
       return TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE;
     }
 
@@ -319,6 +364,7 @@ int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
 
           if (res == TRI_ERROR_NO_ERROR) {
             ++result._numUpdated;
+            status = "updated";
           }
         }
       }
@@ -328,6 +374,7 @@ int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
           
         if (res == TRI_ERROR_NO_ERROR) {
           ++result._numUpdated;
+          status = "updated";
         }
       }
       else {
@@ -335,26 +382,97 @@ int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
         TRI_ASSERT(_onDuplicateAction == DUPLICATE_IGNORE); 
         res = TRI_ERROR_NO_ERROR;
         ++result._numIgnored;
+        status = "ignored";
       }
     }
   }
 
 
   if (res != TRI_ERROR_NO_ERROR) {
-    string part = JsonHelper::toString(json);
-    if (part.size() > 255) {
-      // UTF-8 chars in string will be escaped so we can truncate it at any point
-      part = part.substr(0, 255) + "...";
+    registerCreateError(result, json, res, i);
+  }
+  else {
+    registerResult(result, i, status, TRI_ERROR_NO_ERROR, "");
+  }
+
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process a single line containing a document, shaping it directly
+/// from the input
+///
+/// lines that are no valid documents or cannot be shaped are left to
+/// handleSingleDocument, which reports them
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestImportHandler::handleSingleLine (RestImportTransaction& trx,
+                                          RestImportResult& result,
+                                          char const* lineStart,
+                                          bool waitForSync,
+                                          size_t i,
+                                          int& res) {
+  TRI_shaper_t* shaper = trx.documentCollection()->getShaper();  // PROTECTED by trx here
+  TRI_shaped_json_t* shaped;
+  TRI_shaped_json_info_t info;
+
+  TRI_InitShapedJsonInfo(&info);
+
+  if (TRI_ShapedJsonString(shaper, lineStart, strlen(lineStart), true, &shaped, &info) != TRI_ERROR_NO_ERROR) {
+    TRI_DestroyShapedJsonInfo(&info);
+    return false;
+  }
+
+  if (! info._isObject || 
+      (info._hasKey && info._key == nullptr)) {
+    // not an object, or a _key that is not a string
+    TRI_FreeShapedJson(shaper->_memoryZone, shaped);
+    TRI_DestroyShapedJsonInfo(&info);
+    return false;
+  }
+
+  TRI_doc_mptr_copy_t document;
+  res = trx.createDocument(info._key, &document, shaped, waitForSync);
+
+  TRI_FreeShapedJson(shaper->_memoryZone, shaped);
+  TRI_DestroyShapedJsonInfo(&info);
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    ++result._numCreated;
+    registerResult(result, i, "created", TRI_ERROR_NO_ERROR, "");
+  }
+  else {
+    // the document is only parsed for the error message
+    TRI_json_t* json = parseJsonLine(lineStart, lineStart + strlen(lineStart));
+    registerCreateError(result, json, res, i);
+
+    if (json != nullptr) {
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
     }
+  }
 
-    std::string errorMsg = positionise(i) +
-                           "creating document failed with error '" + TRI_errno_string(res) +
-                           "', offending document: " + part;
-      
-    registerError(result, errorMsg);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief register a document that could not be created
+////////////////////////////////////////////////////////////////////////////////
+
+void RestImportHandler::registerCreateError (RestImportResult& result,
+                                             TRI_json_t const* json,
+                                             int res,
+                                             size_t i) {
+  string part = JsonHelper::toString(json);
+  if (part.size() > 255) {
+    // UTF-8 chars in string will be escaped so we can truncate it at any point
+    part = part.substr(0, 255) + "...";
   }
 
-  return res;
+  std::string errorMsg = string("creating document failed with error '") + TRI_errno_string(res) +
+                         "', offending document: " + part;
+    
+  registerError(result, positionise(i) + errorMsg);
+  registerResult(result, i, "error", res, errorMsg);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -451,7 +569,13 @@ int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
 ///   contain a `details` attribute which is an array with more detailed
 ///   information about which documents could not be inserted.
 ///
-/// Note: this API is currently not supported on cluster coordinators.
+/// On a cluster coordinator, the documents are grouped by their responsible
+/// shards and each shard receives all of its documents in one request. All
+/// shards are contacted in parallel. Note that `complete` is then applied to
+/// each shard individually, so documents may already have been imported into
+/// other shards when the import fails. The result then counts the imported
+/// documents, and all documents of the failed shards as errors. An error is
+/// only returned if no document was imported at all.
 ///
 /// @RESTRETURNCODES
 ///
@@ -475,10 +599,6 @@ int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
 /// is returned if the server cannot auto-generate a document key (out of keys
 /// error) for a document with no user-defined key.
 ///
-/// @RESTRETURNCODE{501}
-/// The server will respond with *HTTP 501* if this API is called on a cluster
-/// coordinator.
-///
 /// @EXAMPLES
 ///
 /// Importing documents with heterogenous attributes from a JSON array:
@@ -709,6 +829,7 @@ int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
 
 bool RestImportHandler::createFromJson (string const& type) {
   RestImportResult result;
+  result._withResults = extractResults();
 
   vector<string> const& suffix = _request->suffix();
 
@@ -775,6 +896,17 @@ bool RestImportHandler::createFromJson (string const& type) {
     return false;
   }
 
+  if (ServerState::instance()->isCoordinator()) {
+    CollectedDocuments documents;
+    int res = TRI_ERROR_NO_ERROR;
+
+    if (! processJsonDocuments(linewise, complete, result, collectDocuments(result, documents), res)) {
+      return false;
+    }
+
+    return createOnCoordinator(collection, result, documents, res, waitForSync, overwrite);
+  }
+
   // find and load collection given by name or identifier
   RestImportTransaction trx(new StandaloneTransactionContext(), _vocbase, collection);
 
@@ -799,110 +931,24 @@ bool RestImportHandler::createFromJson (string const& type) {
     trx.truncate(false);
   }
 
-  if (linewise) {
-    // each line is a separate JSON document
-    char const* ptr = _request->body();
-    char const* end = ptr + _request->bodySize();
-    size_t i = 0;
-
-    while (ptr < end) {
-      // read line until done
-      i++;
-        
-      TRI_ASSERT(ptr != nullptr);
-
-      // trim whitespace at start of line
-      while (ptr < end && 
-             (*ptr == ' ' || *ptr == '\t' || *ptr == '\r' || *ptr == '\b' || *ptr == '\f')) {
-        ++ptr;
-      }
-
-      if (ptr == end || *ptr == '\0') {
-        break;
-      }
-
-      // now find end of line
-      char const* pos = strchr(ptr, '\n');
-      char const* oldPtr = nullptr;
-
-      TRI_json_t* json = nullptr;
-
-      if (pos == ptr) {
-        // line starting with \n, i.e. empty line
-        ptr = pos + 1;
-        ++result._numEmpty;
-        continue;
-      }
-      else if (pos != nullptr) {
-        // non-empty line
-        *(const_cast<char*>(pos)) = '\0';
-        TRI_ASSERT(ptr != nullptr);
-        oldPtr = ptr;
-        json = parseJsonLine(ptr, pos);
-        ptr = pos + 1;
-      }
-      else {
-        // last-line, non-empty
-        TRI_ASSERT(pos == nullptr);
-        TRI_ASSERT(ptr != nullptr);
-        oldPtr = ptr;
-        json = parseJsonLine(ptr);
-        ptr = end;
-      }
+  DocumentHandler const handler = [&] (char const* lineStart, TRI_json_t const* json, size_t i) -> int {
+    return handleSingleDocument(trx, result, lineStart, json, isEdgeCollection, waitForSync, i);
+  };
 
-      res = handleSingleDocument(trx, result, oldPtr, json, isEdgeCollection, waitForSync, i);
+  // documents that are only inserted are shaped directly from their lines.
+  // edges and documents that might update existing ones need the parsed values
+  LineHandler lineHandler = nullptr;
 
-      if (json != nullptr) {
-        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
-      }
-      
-      if (res != TRI_ERROR_NO_ERROR) {
-        if (complete) {
-          // only perform a full import: abort
-          break;
-        }
-
-        res = TRI_ERROR_NO_ERROR;
-      }
-    }
+  if (! isEdgeCollection && _onDuplicateAction == DUPLICATE_ERROR) {
+    lineHandler = [&] (char const* lineStart, size_t i, int& res) -> bool {
+      return handleSingleLine(trx, result, lineStart, waitForSync, i, res);
+    };
   }
 
-  else {
-    // the entire request body is one JSON document
-    TRI_json_t* documents = TRI_Json2String(TRI_UNKNOWN_MEM_ZONE, _request->body(), nullptr);
-
-    if (! TRI_IsArrayJson(documents)) {
-      if (documents != nullptr) {
-        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, documents);
-      }
-
-      generateError(HttpResponse::BAD,
-                    TRI_ERROR_HTTP_BAD_PARAMETER,
-                    "expecting a JSON array in the request");
-      return false;
-    }
-
-    size_t const n = documents->_value._objects._length;
-
-    for (size_t i = 0; i < n; ++i) {
-      TRI_json_t const* json = static_cast<TRI_json_t const*>(TRI_AtVector(&documents->_value._objects, i));
-
-      res = handleSingleDocument(trx, result, nullptr, json, isEdgeCollection, waitForSync, i + 1);
-      
-      if (res != TRI_ERROR_NO_ERROR) {
-        if (complete) {
-          // only perform a full import: abort
-          break;
-        }
-
-        res = TRI_ERROR_NO_ERROR;
-      }
-    }
-
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, documents);
+  if (! processJsonDocuments(linewise, complete, result, handler, res, lineHandler)) {
+    return false;
   }
 
-
   // this may commit, even if previous errors occurred
   res = trx.finish(res);
 
@@ -1007,7 +1053,13 @@ bool RestImportHandler::createFromJson (string const& type) {
 ///   contain a `details` attribute which is an array with more detailed
 ///   information about which documents could not be inserted.
 ///
-/// Note: this API is currently not supported on cluster coordinators.
+/// On a cluster coordinator, the documents are grouped by their responsible
+/// shards and each shard receives all of its documents in one request. All
+/// shards are contacted in parallel. Note that `complete` is then applied to
+/// each shard individually, so documents may already have been imported into
+/// other shards when the import fails. The result then counts the imported
+/// documents, and all documents of the failed shards as errors. An error is
+/// only returned if no document was imported at all.
 ///
 /// @RESTRETURNCODES
 ///
@@ -1031,10 +1083,6 @@ bool RestImportHandler::createFromJson (string const& type) {
 /// is returned if the server cannot auto-generate a document key (out of keys
 /// error) for a document with no user-defined key.
 ///
-/// @RESTRETURNCODE{501}
-/// The server will respond with *HTTP 501* if this API is called on a cluster
-/// coordinator.
-///
 /// @EXAMPLES
 ///
 /// Importing two documents, with attributes `_key`, `value1` and `value2` each. One
@@ -1198,6 +1246,7 @@ bool RestImportHandler::createFromJson (string const& type) {
 
 bool RestImportHandler::createFromKeyValueList () {
   RestImportResult result;
+  result._withResults = extractResults();
 
   vector<string> const& suffix = _request->suffix();
 
@@ -1277,6 +1326,13 @@ bool RestImportHandler::createFromKeyValueList () {
 
   current = next + 1;
 
+  if (ServerState::instance()->isCoordinator()) {
+    CollectedDocuments documents;
+    int res = processKeyValueLines(keys, current, bodyEnd, (size_t) lineNumber, complete, result, collectDocuments(result, documents));
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, keys);
+
+    return createOnCoordinator(collection, result, documents, res, waitForSync, overwrite);
+  }
 
   // find and load collection given by name or identifier
   RestImportTransaction trx(new StandaloneTransactionContext(), _vocbase, collection);
@@ -1303,12 +1359,172 @@ bool RestImportHandler::createFromKeyValueList () {
     trx.truncate(false);
   }
 
-  size_t i = (size_t) lineNumber;
+  DocumentHandler const handler = [&] (char const* lineStart, TRI_json_t const* json, size_t i) -> int {
+    return handleSingleDocument(trx, result, lineStart, json, isEdgeCollection, waitForSync, i);
+  };
+
+  res = processKeyValueLines(keys, current, bodyEnd, (size_t) lineNumber, complete, result, handler);
+
+  // we'll always commit, even if previous errors occurred
+  res = trx.finish(res);
+
+  TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, keys);
+
+  // .............................................................................
+  // outside write transaction
+  // .............................................................................
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    generateTransactionError(collection, res);
+  }
+  else {
+    // generate result
+    generateDocumentsCreated(result);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hands all JSON documents of the request body to a handler,
+/// returns false if the body is malformed
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestImportHandler::processJsonDocuments (bool linewise,
+                                              bool complete,
+                                              RestImportResult& result,
+                                              DocumentHandler const& handler,
+                                              int& res,
+                                              LineHandler const& lineHandler) {
+  if (linewise) {
+    // each line is a separate JSON document
+    char const* ptr = _request->body();
+    char const* end = ptr + _request->bodySize();
+    size_t i = 0;
+
+    while (ptr < end) {
+      // read line until done
+      i++;
+        
+      TRI_ASSERT(ptr != nullptr);
+
+      // trim whitespace at start of line
+      while (ptr < end && 
+             (*ptr == ' ' || *ptr == '\t' || *ptr == '\r' || *ptr == '\b' || *ptr == '\f')) {
+        ++ptr;
+      }
+
+      if (ptr == end || *ptr == '\0') {
+        break;
+      }
+
+      // now find end of line
+      char const* pos = strchr(ptr, '\n');
+      char const* oldPtr = nullptr;
+
+      char const* oldEnd = nullptr;
+
+      if (pos == ptr) {
+        // line starting with \n, i.e. empty line
+        ptr = pos + 1;
+        ++result._numEmpty;
+        continue;
+      }
+      else if (pos != nullptr) {
+        // non-empty line
+        *(const_cast<char*>(pos)) = '\0';
+        TRI_ASSERT(ptr != nullptr);
+        oldPtr = ptr;
+        oldEnd = pos;
+        ptr = pos + 1;
+      }
+      else {
+        // last-line, non-empty
+        TRI_ASSERT(pos == nullptr);
+        TRI_ASSERT(ptr != nullptr);
+        oldPtr = ptr;
+        oldEnd = end;
+        ptr = end;
+      }
+
+      if (lineHandler == nullptr || ! lineHandler(oldPtr, i, res)) {
+        TRI_json_t* json = parseJsonLine(oldPtr, oldEnd);
+
+        res = handler(oldPtr, json, i);
+
+        if (json != nullptr) {
+          TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+        }
+      }
+      
+      if (res != TRI_ERROR_NO_ERROR) {
+        if (complete) {
+          // only perform a full import: abort
+          break;
+        }
+
+        res = TRI_ERROR_NO_ERROR;
+      }
+    }
+  }
+
+  else {
+    // the entire request body is one JSON document
+    TRI_json_t* documents = TRI_Json2String(TRI_UNKNOWN_MEM_ZONE, _request->body(), nullptr);
+
+    if (! TRI_IsArrayJson(documents)) {
+      if (documents != nullptr) {
+        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, documents);
+      }
+
+      generateError(HttpResponse::BAD,
+                    TRI_ERROR_HTTP_BAD_PARAMETER,
+                    "expecting a JSON array in the request");
+      return false;
+    }
+
+    size_t const n = documents->_value._objects._length;
+
+    for (size_t i = 0; i < n; ++i) {
+      TRI_json_t const* json = static_cast<TRI_json_t const*>(TRI_AtVector(&documents->_value._objects, i));
+
+      res = handler(nullptr, json, i + 1);
+      
+      if (res != TRI_ERROR_NO_ERROR) {
+        if (complete) {
+          // only perform a full import: abort
+          break;
+        }
+
+        res = TRI_ERROR_NO_ERROR;
+      }
+    }
+
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, documents);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hands all documents built from the key/value lines of the request
+/// body to a handler
+////////////////////////////////////////////////////////////////////////////////
+
+int RestImportHandler::processKeyValueLines (TRI_json_t const* keys,
+                                             char const* current,
+                                             char const* bodyEnd,
+                                             size_t lineNumber,
+                                             bool complete,
+                                             RestImportResult& result,
+                                             DocumentHandler const& handler) {
+  int res = TRI_ERROR_NO_ERROR;
+  size_t i = lineNumber;
 
   while (current != nullptr && current < bodyEnd) {
     i++;
 
-    next = static_cast<char const*>(memchr(current, '\n', bodyEnd - current));
+    char const* next = static_cast<char const*>(memchr(current, '\n', bodyEnd - current));
 
     char const* lineStart = current;
     char const* lineEnd   = next;
@@ -1350,7 +1566,7 @@ bool RestImportHandler::createFromKeyValueList () {
       TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, values);
 
       if (json != nullptr) {
-        res = handleSingleDocument(trx, result, lineStart, json, isEdgeCollection, waitForSync, i);
+        res = handler(lineStart, json, i);
         TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
       }
       else {
@@ -1374,23 +1590,119 @@ bool RestImportHandler::createFromKeyValueList () {
     }
   }
 
-  // we'll always commit, even if previous errors occurred
-  res = trx.finish(res);
+  return res;
+}
 
-  TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, keys);
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a handler that collects copies of all valid documents,
+/// together with their positions in the input
+////////////////////////////////////////////////////////////////////////////////
 
-  // .............................................................................
-  // outside write transaction
-  // .............................................................................
+RestImportHandler::DocumentHandler RestImportHandler::collectDocuments (RestImportResult& result,
+                                                                       CollectedDocuments& documents) {
+  return [this, &result, &documents] (char const* lineStart, TRI_json_t const* json, size_t i) -> int {
+    int res = checkSingleDocument(result, lineStart, json, i);
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+      if (copy == nullptr) {
+        return TRI_ERROR_OUT_OF_MEMORY;
+      }
+
+      documents.emplace_back(i, copy);
+    }
+
+    return res;
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief imports the collected documents on a coordinator
+///
+/// the documents are grouped by their responsible shards, and each shard
+/// receives all of its documents in a single import request
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestImportHandler::createOnCoordinator (string const& collection,
+                                             RestImportResult& result,
+                                             CollectedDocuments& documents,
+                                             int res,
+                                             bool waitForSync,
+                                             bool overwrite) {
+  string const& dbname = _request->databaseName();
+
+  if (res == TRI_ERROR_NO_ERROR && overwrite) {
+    // truncate collection first
+    res = truncateCollectionOnCoordinator(dbname, collection);
+  }
+
+  vector<TRI_json_t*> jsons;
+  vector<size_t> positions;
+  jsons.reserve(documents.size());
+  positions.reserve(documents.size());
+
+  for (auto& it : documents) {
+    positions.push_back(it.first);
+    jsons.push_back(it.second);
+  }
+  documents.clear();
 
   if (res != TRI_ERROR_NO_ERROR) {
+    for (auto json : jsons) {
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+    }
+
     generateTransactionError(collection, res);
+    return false;
   }
-  else {
-    // generate result
-    generateDocumentsCreated(result);
+
+  string parameters("&waitForSync=");
+  parameters.append(waitForSync ? "true" : "false");
+  parameters.append("&complete=");
+  parameters.append(extractComplete() ? "true" : "false");
+
+  switch (_onDuplicateAction) {
+    case DUPLICATE_UPDATE:
+      parameters.append("&onDuplicate=update");
+      break;
+    case DUPLICATE_REPLACE:
+      parameters.append("&onDuplicate=replace");
+      break;
+    case DUPLICATE_IGNORE:
+      parameters.append("&onDuplicate=ignore");
+      break;
+    case DUPLICATE_ERROR:
+      break;
+  }
+
+  vector<string> errors;
+  map<string, size_t> counts;
+
+  res = createDocumentsOnCoordinator(dbname, collection, jsons, parameters, errors, counts);
+
+  if (res != TRI_ERROR_NO_ERROR && 
+      counts["created"] + counts["updated"] + counts["ignored"] == 0) {
+    // nothing was stored, so report the error as a single server would
+    generateTransactionError(collection, res);
+    return false;
+  }
+
+  // some shards may have rejected their documents while others stored
+  // theirs. this is reported like the errors of single documents
+  result._numCreated += counts["created"];
+  result._numUpdated += counts["updated"];
+  result._numIgnored += counts["ignored"];
+  result._numErrors  += counts["errors"];
+
+  // errors is in input order
+  for (size_t i = 0; i < errors.size(); ++i) {
+    if (! errors[i].empty()) {
+      result._errors.push_back(positionise(positions[i]) + errors[i]);
+    }
   }
 
+  generateDocumentsCreated(result);
   return true;
 }
 
@@ -1426,6 +1738,25 @@ void RestImportHandler::generateDocumentsCreated (RestImportResult const& result
     TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, &json, "details", messages);
   }
 
+  if (result._withResults) {
+    TRI_json_t* results = TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE, result._results.size());
+
+    for (auto const& it : result._results) {
+      TRI_json_t* entry = TRI_CreateObjectJson(TRI_UNKNOWN_MEM_ZONE);
+
+      TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, entry, "position", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, (double) it._position));
+      TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, entry, "status", TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, it._status, strlen(it._status)));
+
+      if (it._errorNum != TRI_ERROR_NO_ERROR) {
+        TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, entry, "errorNum", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, (double) it._errorNum));
+        TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, entry, "errorMessage", TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, it._errorMessage.c_str(), it._errorMessage.size()));
+      }
+
+      TRI_PushBack3ArrayJson(TRI_UNKNOWN_MEM_ZONE, results, entry);
+    }
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, &json, "results", results);
+  }
+
   generateResult(HttpResponse::CREATED, &json);
   TRI_DestroyJson(TRI_UNKNOWN_MEM_ZONE, &json);
 }
@@ -48,6 +48,17 @@ namespace triagens {
 // --SECTION--                                                  RestImportResult
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief outcome of importing a single document
+////////////////////////////////////////////////////////////////////////////////
+
+    struct RestImportDocumentResult {
+      size_t      _position;      // position of the document in the input
+      char const* _status;        // "created", "updated", "ignored" or "error"
+      int         _errorNum;
+      std::string _errorMessage;  // without the position
+    };
+
     struct RestImportResult {
 
       public:
@@ -57,7 +68,9 @@ namespace triagens {
           _numCreated(0),
           _numIgnored(0),
           _numUpdated(0),
-          _errors() {
+          _errors(),
+          _withResults(false),
+          _results() {
         }
 
         ~RestImportResult () { }
@@ -69,6 +82,11 @@ namespace triagens {
         size_t _numUpdated;
 
         std::vector<std::string> _errors;
+
+        // the outcome of every document is only kept if a coordinator asks
+        // for it with the "results" parameter
+        bool _withResults;
+        std::vector<RestImportDocumentResult> _results;
     };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -119,6 +137,12 @@ namespace triagens {
 
         bool extractComplete () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the "results" value
+////////////////////////////////////////////////////////////////////////////////
+
+        bool extractResults () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create a position string
 ////////////////////////////////////////////////////////////////////////////////
@@ -132,6 +156,16 @@ namespace triagens {
         void registerError (RestImportResult&,
                             std::string const&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief register the outcome of a document, if requested
+////////////////////////////////////////////////////////////////////////////////
+
+        void registerResult (RestImportResult&,
+                             size_t,
+                             char const*,
+                             int,
+                             std::string const&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief construct an error message
 ////////////////////////////////////////////////////////////////////////////////
@@ -139,6 +173,36 @@ namespace triagens {
         std::string buildParseError (size_t,
                                      char const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handler for a single JSON document, called with the start of the
+/// input line, the document and its position in the input
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef std::function<int(char const*, TRI_json_t const*, size_t)> DocumentHandler;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handler for a single line of a linewise import, called with the
+/// line and its position in the input. returns false if the line must be
+/// parsed and handed to the document handler instead
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef std::function<bool(char const*, size_t, int&)> LineHandler;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief documents collected on a coordinator, with their input positions
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef std::vector<std::pair<size_t, TRI_json_t*>> CollectedDocuments;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks that a JSON value can be imported as a document
+////////////////////////////////////////////////////////////////////////////////
+
+        int checkSingleDocument (RestImportResult&,
+                                 char const*,
+                                 TRI_json_t const*,
+                                 size_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief process a single JSON document
 ////////////////////////////////////////////////////////////////////////////////
@@ -151,6 +215,27 @@ namespace triagens {
                                   bool,
                                   size_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process a single line containing a document, shaping it directly
+/// from the input
+////////////////////////////////////////////////////////////////////////////////
+
+        bool handleSingleLine (RestImportTransaction&,
+                               RestImportResult&,
+                               char const*,
+                               bool,
+                               size_t,
+                               int&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief register a document that could not be created
+////////////////////////////////////////////////////////////////////////////////
+
+        void registerCreateError (RestImportResult&,
+                                  TRI_json_t const*,
+                                  int,
+                                  size_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief creates documents by JSON objects
 /// each line of the input stream contains an individual JSON object
@@ -171,6 +256,47 @@ namespace triagens {
 
         bool createFromKeyValueList ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hands all JSON documents of the request body to a handler
+////////////////////////////////////////////////////////////////////////////////
+
+        bool processJsonDocuments (bool,
+                                   bool,
+                                   RestImportResult&,
+                                   DocumentHandler const&,
+                                   int&,
+                                   LineHandler const& = nullptr);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hands all documents from key/value lines to a handler
+////////////////////////////////////////////////////////////////////////////////
+
+        int processKeyValueLines (TRI_json_t const*,
+                                  char const*,
+                                  char const*,
+                                  size_t,
+                                  bool,
+                                  RestImportResult&,
+                                  DocumentHandler const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a handler collecting the documents on a coordinator
+////////////////////////////////////////////////////////////////////////////////
+
+        DocumentHandler collectDocuments (RestImportResult&,
+                                          CollectedDocuments&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief imports the collected documents on a coordinator
+////////////////////////////////////////////////////////////////////////////////
+
+        bool createOnCoordinator (std::string const&,
+                                  RestImportResult&,
+                                  CollectedDocuments&,
+                                  int,
+                                  bool,
+                                  bool);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief creates the result
 ////////////////////////////////////////////////////////////////////////////////
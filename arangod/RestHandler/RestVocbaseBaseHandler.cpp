@@ -30,6 +30,7 @@
 #include "RestVocbaseBaseHandler.h"
 
 #include "Basics/JsonHelper.h"
+#include "Basics/ScopeGuard.h"
 #include "Basics/StringUtils.h"
 #include "Basics/conversions.h"
 #include "Basics/string-buffer.h"
@@ -288,27 +289,44 @@ void RestVocbaseBaseHandler::generateDocument (SingleCollectionReadOnlyTransacti
   char const* key = TRI_EXTRACT_MARKER_KEY(&mptr);  // PROTECTED by trx from above
   string const&& id = DocumentHelper::assembleDocumentId(resolver->getCollectionName(cid), key);
 
+  // all temporary values die with the response, so they are allocated in an
+  // arena that is freed in one go
+  TRI_memory_zone_t* zone = TRI_CreateArenaMemoryZone(8192);
+
+  if (zone == nullptr) {
+    generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_OUT_OF_MEMORY);
+    return;
+  }
+
+  // the arena must also be freed if any of the below throws
+  triagens::basics::ScopeGuard guard{
+    []() -> void { },
+    [&zone]() -> void {
+      TRI_FreeArenaMemoryZone(zone);
+    }
+  };
+
   TRI_json_t augmented;
-  TRI_InitObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, 5);
+  TRI_InitObjectJson(zone, &augmented, 5);
 
-  TRI_json_t* idJson = TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, id.c_str(), id.size());
+  TRI_json_t* idJson = TRI_CreateStringCopyJson(zone, id.c_str(), id.size());
 
   if (idJson != nullptr) {
-    TRI_Insert2ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_ID, idJson);
+    TRI_Insert2ObjectJson(zone, &augmented, TRI_VOC_ATTRIBUTE_ID, idJson);
   }
 
   // convert rid from uint64_t to string
   string const&& rid = StringUtils::itoa(mptr._rid);
-  TRI_json_t* rev = TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, rid.c_str(), rid.size());
+  TRI_json_t* rev = TRI_CreateStringCopyJson(zone, rid.c_str(), rid.size());
 
   if (rev != nullptr) {
-    TRI_Insert2ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_REV, rev);
+    TRI_Insert2ObjectJson(zone, &augmented, TRI_VOC_ATTRIBUTE_REV, rev);
   }
 
-  TRI_json_t* keyJson = TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, key, strlen(key));
+  TRI_json_t* keyJson = TRI_CreateStringCopyJson(zone, key, strlen(key));
 
   if (keyJson != nullptr) {
-    TRI_Insert2ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_KEY, keyJson);
+    TRI_Insert2ObjectJson(zone, &augmented, TRI_VOC_ATTRIBUTE_KEY, keyJson);
   }
 
   TRI_df_marker_type_t type = static_cast<TRI_df_marker_t const*>(mptr.getDataPtr())->_type;  // PROTECTED by trx passed from above
@@ -318,42 +336,28 @@ void RestVocbaseBaseHandler::generateDocument (SingleCollectionReadOnlyTransacti
     string const&& from = DocumentHelper::assembleDocumentId(resolver->getCollectionNameCluster(marker->_fromCid), string((char*) marker + marker->_offsetFromKey));
     string const&& to = DocumentHelper::assembleDocumentId(resolver->getCollectionNameCluster(marker->_toCid), string((char*) marker +  marker->_offsetToKey));
 
-    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_FROM, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, from.c_str(), from.size()));
-    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_TO, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, to.c_str(), to.size()));
+    TRI_Insert3ObjectJson(zone, &augmented, TRI_VOC_ATTRIBUTE_FROM, TRI_CreateStringCopyJson(zone, from.c_str(), from.size()));
+    TRI_Insert3ObjectJson(zone, &augmented, TRI_VOC_ATTRIBUTE_TO, TRI_CreateStringCopyJson(zone, to.c_str(), to.size()));
   }
   else if (type == TRI_WAL_MARKER_EDGE) {
     triagens::wal::edge_marker_t const* marker = static_cast<triagens::wal::edge_marker_t const*>(mptr.getDataPtr());  // PROTECTED by trx passed from above
     string const&& from = DocumentHelper::assembleDocumentId(resolver->getCollectionNameCluster(marker->_fromCid), string((char*) marker + marker->_offsetFromKey));
     string const&& to = DocumentHelper::assembleDocumentId(resolver->getCollectionNameCluster(marker->_toCid), string((char*) marker +  marker->_offsetToKey));
 
-    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_FROM, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, from.c_str(), from.size()));
-    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_TO, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, to.c_str(), to.size()));
+    TRI_Insert3ObjectJson(zone, &augmented, TRI_VOC_ATTRIBUTE_FROM, TRI_CreateStringCopyJson(zone, from.c_str(), from.size()));
+    TRI_Insert3ObjectJson(zone, &augmented, TRI_VOC_ATTRIBUTE_TO, TRI_CreateStringCopyJson(zone, to.c_str(), to.size()));
   }
 
   // add document identifier to buffer
   TRI_string_buffer_t buffer;
 
   // convert object to string
-  TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
+  TRI_InitStringBuffer(&buffer, zone);
 
   TRI_shaped_json_t shapedJson;
   TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, mptr.getDataPtr());  // PROTECTED by trx passed from above
   TRI_StringifyAugmentedShapedJson(shaper, &buffer, &shapedJson, &augmented);
 
-  TRI_DestroyJson(TRI_UNKNOWN_MEM_ZONE, &augmented);
-
-  if (idJson) {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, idJson);
-  }
-
-  if (rev) {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, rev);
-  }
-
-  if (keyJson) {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, keyJson);
-  }
-
   // and generate a response
   _response = createResponse(HttpResponse::OK);
   _response->setContentType("application/json; charset=utf-8");
@@ -365,8 +369,6 @@ void RestVocbaseBaseHandler::generateDocument (SingleCollectionReadOnlyTransacti
   else {
     _response->headResponse(TRI_LengthStringBuffer(&buffer));
   }
-
-  TRI_DestroyStringBuffer(&buffer);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -74,6 +74,7 @@
 #include "RestServer/ConsoleThread.h"
 #include "RestServer/VocbaseContext.h"
 #include "Scheduler/ApplicationScheduler.h"
+#include "SkipLists/skiplistIndex.h"
 #include "Statistics/statistics.h"
 #include "V8/V8LineEditor.h"
 #include "V8/v8-conv.h"
@@ -304,17 +305,20 @@ ArangoServer::ArangoServer (int argc, char** argv)
     _dispatcherQueueSize(8192),
     _v8Contexts(8),
     _indexThreads(2),
+    _scanThreads(0),
     _databasePath(),
     _defaultMaximalSize(TRI_JOURNAL_DEFAULT_MAXIMAL_SIZE),
     _defaultWaitForSync(false),
     _forceSyncProperties(true),
     _ignoreDatafileErrors(true),
+    _skiplistImplementation("skiplist"),
     _disableReplicationApplier(false),
     _disableQueryTracking(false),
     _server(nullptr),
     _queryRegistry(nullptr),
     _pairForAql(nullptr),
-    _indexPool(nullptr) {
+    _indexPool(nullptr),
+    _scanPool(nullptr) {
 
   TRI_SetApplicationName("arangod");
 
@@ -342,6 +346,7 @@ ArangoServer::ArangoServer (int argc, char** argv)
 ////////////////////////////////////////////////////////////////////////////////
 
 ArangoServer::~ArangoServer () {
+  delete _scanPool;
   delete _indexPool;
 
   delete _jobManager;
@@ -550,8 +555,10 @@ void ArangoServer::buildApplicationServer () {
     ("database.wait-for-sync", &_defaultWaitForSync, "default wait-for-sync behavior, can be overwritten when creating a collection")
     ("database.force-sync-properties", &_forceSyncProperties, "force syncing of collection properties to disk, will use waitForSync value of collection when turned off")
     ("database.ignore-datafile-errors", &_ignoreDatafileErrors, "load collections even if datafiles may contain errors")
+    ("database.skiplist-implementation", &_skiplistImplementation, "data structure used by skiplist indexes (skiplist or btree)")
     ("database.disable-query-tracking", &_disableQueryTracking, "turn off AQL query tracking by default")
     ("database.index-threads", &_indexThreads, "threads to start for parallel background index creation")
+    ("database.scan-threads", &_scanThreads, "threads to start for parallel collection scans in AQL queries")
   ;
 
   // .............................................................................
@@ -642,6 +649,14 @@ void ArangoServer::buildApplicationServer () {
 
 
   IGNORE_DATAFILE_ERRORS = _ignoreDatafileErrors;
+
+  if (_skiplistImplementation == "btree") {
+    SKIPLIST_INDEX_USE_BPLUS_TREE = true;
+  }
+  else if (_skiplistImplementation != "skiplist") {
+    LOG_FATAL_AND_EXIT("invalid value for --database.skiplist-implementation: '%s'. possible values: skiplist, btree",
+                       _skiplistImplementation.c_str());
+  }
   
   // .............................................................................
   // init nonces
@@ -760,6 +775,13 @@ void ArangoServer::buildApplicationServer () {
       _indexThreads = 128;
     }
   }
+
+  if (_scanThreads > 0) {
+    if (_scanThreads > 128) {
+      // some arbitrary limit
+      _scanThreads = 128;
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1245,9 +1267,14 @@ void ArangoServer::openDatabases (bool checkVersion,
     _indexPool = new triagens::basics::ThreadPool(_indexThreads, "IndexBuilder");
   }
 
+  if (_scanThreads > 0) {
+    _scanPool = new triagens::basics::ThreadPool(_scanThreads, "CollectionScanner");
+  }
+
   int res = TRI_InitServer(_server,
                            _applicationEndpointServer,
                            _indexPool,
+                           _scanPool,
                            _databasePath.c_str(),
                            _applicationV8->appPath().c_str(),
                            &defaults,
@@ -372,6 +372,23 @@ namespace triagens {
 
         int _indexThreads;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of background threads for parallel collection scans
+/// @startDocuBlock scanThreads
+/// `--database.scan-threads`
+///
+/// Specifies the *number* of background threads for parallel collection scans
+/// in AQL queries. When a query iterates over a full collection and filters
+/// the documents right away, the collection can be split into partitions that
+/// are filtered by the scan threads and the thread executing the query in
+/// parallel. The scan threads are shared among all queries and databases.
+/// The default value of *0* turns off parallel scans, meaning that collections
+/// are always scanned by the thread executing the query.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        int _scanThreads;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief path to the database
 /// @startDocuBlock DatabaseDirectory
@@ -478,6 +495,28 @@ namespace triagens {
 
         bool _ignoreDatafileErrors;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief data structure used by skiplist indexes
+/// @startDocuBlock databaseSkiplistImplementation
+/// `--database.skiplist-implementation value`
+///
+/// Selects the data structure backing skiplist indexes. Possible values are
+/// *skiplist* and *btree*.
+///
+/// *btree* stores the index entries in a cache-conscious B+-tree with inline
+/// key prefixes. Indexes of this kind are bulk-loaded when they are created
+/// or when their collection is loaded, which is considerably faster than
+/// inserting the documents one by one, and range scans touch far fewer cache
+/// lines. The option only affects indexes instantiated after startup, so it
+/// applies to all skiplist indexes once their collections are loaded. The
+/// persistent index definitions are not changed.
+///
+/// The default is *skiplist*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _skiplistImplementation;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief disable the replication applier on server startup
 /// @startDocuBlock serverDisableReplicationApplier
@@ -592,6 +631,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         triagens::basics::ThreadPool* _indexPool;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief thread pool for parallel collection scans
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::ThreadPool* _scanPool;
     };
   }
 }
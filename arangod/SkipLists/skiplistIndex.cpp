@@ -28,6 +28,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "skiplistIndex.h"
+#include "Basics/json-utilities.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/Utf8Helper.h"
 #include "ShapedJson/json-shaper.h"
 #include "ShapedJson/shaped-json.h"
@@ -201,6 +203,142 @@ static int CmpKeyElm (void* sli,
   return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes the key prefix of a shaped value
+///
+/// The prefix holds the type class in its upper three bits, in the order
+/// used by TRI_CompareShapeTypes, followed by an order-preserving encoding
+/// of numbers and booleans. Strings are compared using the collation, so
+/// only their type class goes into the prefix. Returns false if the shape
+/// is unknown.
+///
+/// The prefix is not exact for any type but booleans. Numbers only keep the
+/// upper 61 bits of their encoding, so numbers that differ in the lowest
+/// three mantissa bits get the same prefix. The prefix only orders values
+/// with different prefixes, and the B+-tree must always compare the full
+/// values of elements with equal prefixes.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ShapePrefix (TRI_shaper_t* shaper,
+                         TRI_shaped_json_t const* value,
+                         uint64_t* prefix) {
+  TRI_shape_t const* shape = shaper->lookupShapeId(shaper, value->_sid);
+
+  if (shape == nullptr) {
+    return false;
+  }
+
+  switch (shape->_type) {
+    case TRI_SHAPE_ILLEGAL: {
+      *prefix = 0;
+      return true;
+    }
+
+    case TRI_SHAPE_NULL: {
+      *prefix = 1ULL << 61;
+      return true;
+    }
+
+    case TRI_SHAPE_BOOLEAN: {
+      *prefix = (2ULL << 61) | (*((TRI_shape_boolean_t*) value->_data.data) ? 1 : 0);
+      return true;
+    }
+
+    case TRI_SHAPE_NUMBER: {
+      TRI_shape_number_t number;
+      memcpy(&number, value->_data.data, sizeof(TRI_shape_number_t));
+
+      if (number == 0.0) {
+        // -0.0 and 0.0 compare equal
+        number = 0.0;
+      }
+
+      uint64_t bits;
+      memcpy(&bits, &number, sizeof(uint64_t));
+
+      // flip the sign bit of positive numbers and all bits of negative ones
+      // so that the unsigned order matches the numeric order
+      if (bits & 0x8000000000000000ULL) {
+        bits = ~bits;
+      }
+      else {
+        bits |= 0x8000000000000000ULL;
+      }
+
+      // this drops the lowest three mantissa bits, see above
+      *prefix = (3ULL << 61) | (bits >> 3);
+      return true;
+    }
+
+    case TRI_SHAPE_SHORT_STRING:
+    case TRI_SHAPE_LONG_STRING: {
+      *prefix = 4ULL << 61;
+      return true;
+    }
+
+    case TRI_SHAPE_LIST:
+    case TRI_SHAPE_HOMOGENEOUS_LIST:
+    case TRI_SHAPE_HOMOGENEOUS_SIZED_LIST: {
+      *prefix = 5ULL << 61;
+      return true;
+    }
+
+    case TRI_SHAPE_ARRAY: {
+      *prefix = 6ULL << 61;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes the B+-tree prefix of an element from its first field
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t PrefixElm (void* sli,
+                           void* e) {
+  auto element = static_cast<TRI_skiplist_index_element_t const*>(e);
+  SkiplistIndex* skiplistindex = static_cast<SkiplistIndex*>(sli);
+
+  if (skiplistindex->_numFields == 0) {
+    return 0;
+  }
+
+  TRI_shaped_sub_t const* sub = SkiplistIndex_Subobjects(element);
+  TRI_shaped_json_t value;
+
+  value._sid = sub->_sid;
+  TRI_InspectShapedSub(sub, element->_document->getShapedJsonPtr(), value);  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  uint64_t prefix;
+
+  if (! ShapePrefix(skiplistindex->_collection->getShaper(), &value, &prefix)) {  // ONLY IN INDEX, PROTECTED by RUNTIME
+    // cannot happen for stored documents
+    TRI_ASSERT(false);
+    return 0;
+  }
+
+  return prefix;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes the B+-tree prefix of a key from its first field
+////////////////////////////////////////////////////////////////////////////////
+
+static bool PrefixKey (void* sli,
+                       void* k,
+                       uint64_t* prefix) {
+  auto key = static_cast<TRI_skiplist_index_key_t const*>(k);
+  SkiplistIndex* skiplistindex = static_cast<SkiplistIndex*>(sli);
+
+  if (key->_numFields == 0) {
+    return false;
+  }
+
+  return ShapePrefix(skiplistindex->_collection->getShaper(), &key->_fields[0], prefix);  // ONLY IN INDEX, PROTECTED by RUNTIME
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief frees an element in the skiplist
 ////////////////////////////////////////////////////////////////////////////////
@@ -210,12 +348,416 @@ static void FreeElm (void* e) {
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, element);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief accessors for the skiplist variant of the index
+///
+/// The iterator and interval functions below are templates over one of the
+/// two accessor structs, so both variants share the same lookup logic.
+////////////////////////////////////////////////////////////////////////////////
+
+struct SkiplistAccess {
+  typedef triagens::basics::SkipListNode* Position;
+  typedef TRI_skiplist_iterator_interval_t Interval;
+
+  static Position start (SkiplistIndex const* idx) {
+    return idx->skiplist->startNode();
+  }
+
+  static Position end (SkiplistIndex const* idx) {
+    return idx->skiplist->endNode();
+  }
+
+  static Position next (SkiplistIndex const*, Position p) {
+    return p->nextNode();
+  }
+
+  static Position prev (SkiplistIndex const* idx, Position p) {
+    return idx->skiplist->prevNode(p);
+  }
+
+  static void* document (SkiplistIndex const*, Position p) {
+    return p->document();
+  }
+
+  static Position leftKeyLookup (SkiplistIndex const* idx, TRI_skiplist_index_key_t* key) {
+    return idx->skiplist->leftKeyLookup(key);
+  }
+
+  static Position rightKeyLookup (SkiplistIndex const* idx, TRI_skiplist_index_key_t* key) {
+    return idx->skiplist->rightKeyLookup(key);
+  }
+
+  static uint64_t size (SkiplistIndex const* idx) {
+    return idx->skiplist->getNrUsed();
+  }
+
+  static Position& cursor (TRI_skiplist_iterator_t* iterator) {
+    return iterator->_cursor;
+  }
+
+  static Position cursor (TRI_skiplist_iterator_t const* iterator) {
+    return iterator->_cursor;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief accessors for the B+-tree variant of the index
+////////////////////////////////////////////////////////////////////////////////
+
+struct BPlusTreeAccess {
+  typedef triagens::basics::BPlusTreePosition Position;
+  typedef TRI_bplustree_iterator_interval_t Interval;
+
+  static Position start (SkiplistIndex const* idx) {
+    return idx->btree->startPosition();
+  }
+
+  static Position end (SkiplistIndex const* idx) {
+    return idx->btree->endPosition();
+  }
+
+  static Position next (SkiplistIndex const* idx, Position p) {
+    return idx->btree->nextPosition(p);
+  }
+
+  static Position prev (SkiplistIndex const* idx, Position p) {
+    return idx->btree->prevPosition(p);
+  }
+
+  static void* document (SkiplistIndex const* idx, Position p) {
+    return idx->btree->document(p);
+  }
+
+  static Position leftKeyLookup (SkiplistIndex const* idx, TRI_skiplist_index_key_t* key) {
+    return idx->btree->leftKeyLookup(key);
+  }
+
+  static Position rightKeyLookup (SkiplistIndex const* idx, TRI_skiplist_index_key_t* key) {
+    return idx->btree->rightKeyLookup(key);
+  }
+
+  static uint64_t size (SkiplistIndex const* idx) {
+    return idx->btree->getNrUsed();
+  }
+
+  static Position& cursor (TRI_skiplist_iterator_t* iterator) {
+    return iterator->_position;
+  }
+
+  static Position cursor (TRI_skiplist_iterator_t const* iterator) {
+    return iterator->_position;
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                          skiplistIndex statistics
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of buckets of the equi-depth histogram
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t const HistogramBuckets = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief minimum number of modifications before the statistics are stale.
+/// larger indexes wait for modifications of half their size, so the walks
+/// cost a constant amount per modification when amortized
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t const MinModificationsForStatistics = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create empty statistics
+////////////////////////////////////////////////////////////////////////////////
+
+SkiplistIndexStatistics::SkiplistIndexStatistics ()
+  : _lock(),
+    _zone(TRI_UNKNOWN_MEM_ZONE),
+    _minimum(nullptr),
+    _boundaries(),
+    _bucketCounts(),
+    _distinct(),
+    _count(0),
+    _modifications(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the statistics
+////////////////////////////////////////////////////////////////////////////////
+
+SkiplistIndexStatistics::~SkiplistIndexStatistics () {
+  clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reset the statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void SkiplistIndexStatistics::clear () {
+  if (_minimum != nullptr) {
+    TRI_FreeJson(_zone, _minimum);
+    _minimum = nullptr;
+  }
+
+  for (auto it : _boundaries) {
+    if (it != nullptr) {
+      TRI_FreeJson(_zone, it);
+    }
+  }
+
+  _boundaries.clear();
+  _bucketCounts.clear();
+  _distinct.clear();
+  _count = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief exchange the figures with other statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void SkiplistIndexStatistics::swap (SkiplistIndexStatistics& other) {
+  std::swap(_zone, other._zone);
+  std::swap(_minimum, other._minimum);
+  _boundaries.swap(other._boundaries);
+  _bucketCounts.swap(other._bucketCounts);
+  _distinct.swap(other._distinct);
+  std::swap(_count, other._count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the value of the first indexed attribute of an element
+/// into json. returns nullptr if the shape is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_json_t* FirstValueJson (TRI_shaper_t* shaper,
+                                   TRI_skiplist_index_element_t const* element) {
+  auto subObjects = SkiplistIndex_Subobjects(element);
+
+  TRI_shaped_json_t shaped;
+  shaped._sid = subObjects[0]._sid;
+  TRI_InspectShapedSub(&subObjects[0], element->_document->getShapedJsonPtr(), shaped);  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  return TRI_JsonShapedJson(shaper, &shaped);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes the statistics by walking the index in order
+///
+/// Neighbouring elements are compared attribute by attribute. The first
+/// attribute in which they differ tells which prefixes start a new distinct
+/// value. Histogram buckets are only closed between different values of the
+/// first attribute, so each value falls into exactly one bucket.
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename Access>
+static void ComputeStatistics (SkiplistIndex* skiplistIndex,
+                               SkiplistIndexStatistics* statistics) {
+  statistics->clear();
+
+  TRI_shaper_t* shaper = skiplistIndex->_collection->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+  statistics->_zone = shaper->_memoryZone;
+
+  size_t const numFields = skiplistIndex->_numFields;
+  uint64_t const n = Access::size(skiplistIndex);
+  uint64_t const depth = (std::max)(static_cast<uint64_t>(1), n / HistogramBuckets);
+
+  statistics->_distinct.resize(numFields, 0);
+  statistics->_count = n;
+
+  if (n == 0) {
+    return;
+  }
+
+  bool validHistogram = true;
+  TRI_skiplist_index_element_t const* previous = nullptr;
+  uint64_t inBucket = 0;
+
+  auto const end = Access::end(skiplistIndex);
+  auto position = Access::next(skiplistIndex, Access::start(skiplistIndex));
+
+  while (position != end) {
+    auto element = static_cast<TRI_skiplist_index_element_t const*>(Access::document(skiplistIndex, position));
+    size_t firstDifference = 0;
+
+    if (previous == nullptr) {
+      statistics->_minimum = FirstValueJson(shaper, element);
+      validHistogram = (statistics->_minimum != nullptr);
+    }
+    else {
+      firstDifference = numFields;
+
+      for (size_t j = 0; j < numFields; ++j) {
+        if (CompareElementElement(previous, j, element, j, shaper) != 0) {
+          firstDifference = j;
+          break;
+        }
+      }
+
+      if (firstDifference == 0 && inBucket >= depth && validHistogram) {
+        TRI_json_t* boundary = FirstValueJson(shaper, previous);
+        statistics->_boundaries.emplace_back(boundary);
+        statistics->_bucketCounts.emplace_back(inBucket);
+        validHistogram = (boundary != nullptr);
+        inBucket = 0;
+      }
+    }
+
+    for (size_t j = firstDifference; j < numFields; ++j) {
+      ++statistics->_distinct[j];
+    }
+
+    ++inBucket;
+    previous = element;
+    position = Access::next(skiplistIndex, position);
+  }
+
+  if (validHistogram) {
+    TRI_json_t* boundary = FirstValueJson(shaper, previous);
+    statistics->_boundaries.emplace_back(boundary);
+    statistics->_bucketCounts.emplace_back(inBucket);
+    validHistogram = (boundary != nullptr);
+  }
+
+  if (! validHistogram) {
+    // keep the distinct counts, but do not use a partial histogram
+    for (auto it : statistics->_boundaries) {
+      if (it != nullptr) {
+        TRI_FreeJson(statistics->_zone, it);
+      }
+    }
+    statistics->_boundaries.clear();
+    statistics->_bucketCounts.clear();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts modifications of the index
+///
+/// This runs under the write lock of the collection, so it does not walk the
+/// index. The cleanup thread recomputes the statistics once they are stale.
+////////////////////////////////////////////////////////////////////////////////
+
+static void NoteModifications (SkiplistIndex* skiplistIndex,
+                               uint64_t n) {
+  if (skiplistIndex->_statistics != nullptr) {
+    skiplistIndex->_statistics->_modifications += n;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recomputes the statistics of the index
+///
+/// The caller must hold a lock on the collection, so there are no writes
+/// during the walk. The new figures are computed aside and swapped in, so
+/// estimates only wait for the swap.
+////////////////////////////////////////////////////////////////////////////////
+
+static void RecomputeStatistics (SkiplistIndex* skiplistIndex) {
+  SkiplistIndexStatistics* statistics = skiplistIndex->_statistics;
+
+  if (statistics == nullptr) {
+    return;
+  }
+
+  SkiplistIndexStatistics fresh;
+
+  try {
+    if (skiplistIndex->btree != nullptr) {
+      ComputeStatistics<BPlusTreeAccess>(skiplistIndex, &fresh);
+    }
+    else {
+      ComputeStatistics<SkiplistAccess>(skiplistIndex, &fresh);
+    }
+  }
+  catch (...) {
+    // statistics are optional. the optimizer falls back to its heuristics
+    fresh.clear();
+  }
+
+  statistics->_modifications = 0;
+
+  MUTEX_LOCKER(statistics->_lock);
+  statistics->swap(fresh);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimates which part of a histogram bucket lies inside a range
+///
+/// The bucket covers [lower, upper] if lowerInclusive is set, and
+/// (lower, upper] otherwise. Partial overlaps are interpolated linearly for
+/// numbers and counted as half a bucket for other types.
+////////////////////////////////////////////////////////////////////////////////
+
+static double BucketOverlap (TRI_json_t const* lower,
+                             bool lowerInclusive,
+                             TRI_json_t const* upper,
+                             TRI_json_t const* low,
+                             bool lowInclusive,
+                             TRI_json_t const* high,
+                             bool highInclusive) {
+  if (low != nullptr) {
+    int res = TRI_CompareValuesJson(low, upper);
+
+    if (res > 0 || (res == 0 && ! lowInclusive)) {
+      // range starts behind the bucket
+      return 0.0;
+    }
+  }
+
+  if (high != nullptr) {
+    int res = TRI_CompareValuesJson(high, lower);
+
+    if (res < 0 || (res == 0 && (! highInclusive || ! lowerInclusive))) {
+      // range ends before the bucket
+      return 0.0;
+    }
+  }
+
+  bool coversLower = true;
+  bool coversUpper = true;
+
+  if (low != nullptr) {
+    int res = TRI_CompareValuesJson(low, lower);
+    coversLower = (res < 0 || (res == 0 && (lowInclusive || ! lowerInclusive)));
+  }
+
+  if (high != nullptr) {
+    int res = TRI_CompareValuesJson(high, upper);
+    coversUpper = (res > 0 || (res == 0 && highInclusive));
+  }
+
+  if (coversLower && coversUpper) {
+    return 1.0;
+  }
+
+  if (TRI_IsNumberJson(lower) && 
+      TRI_IsNumberJson(upper) &&
+      (coversLower || TRI_IsNumberJson(low)) &&
+      (coversUpper || TRI_IsNumberJson(high))) {
+    double const from = lower->_value._number;
+    double const to   = upper->_value._number;
+
+    if (to <= from) {
+      return 1.0;
+    }
+
+    double const a = coversLower ? from : low->_value._number;
+    double const b = coversUpper ? to : high->_value._number;
+
+    return (std::min)(1.0, (std::max)(0.0, (b - a) / (to - from)));
+  }
+
+  return 0.5;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the current interval that the iterator points at
 ////////////////////////////////////////////////////////////////////////////////
 
-static inline TRI_skiplist_iterator_interval_t* GetInterval (TRI_skiplist_iterator_t const* iterator) {
-  return static_cast<TRI_skiplist_iterator_interval_t*>(TRI_AtVector(&iterator->_intervals, iterator->_currentInterval));
+template<typename Access>
+static inline typename Access::Interval* GetInterval (TRI_skiplist_iterator_t const* iterator) {
+  return static_cast<typename Access::Interval*>(TRI_AtVector(&iterator->_intervals, iterator->_currentInterval));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -223,6 +765,7 @@ static inline TRI_skiplist_iterator_interval_t* GetInterval (TRI_skiplist_iterat
 /// interval or before it - without advancing the iterator.
 ////////////////////////////////////////////////////////////////////////////////
 
+template<typename Access>
 static bool SkiplistHasPrevIterationCallback (TRI_skiplist_iterator_t const* iterator) {
   // Note that iterator->_cursor == nullptr if we are before the largest
   // document (i.e. the first one in the iterator)!
@@ -238,15 +781,15 @@ static bool SkiplistHasPrevIterationCallback (TRI_skiplist_iterator_t const* ite
     return true;
   }
 
-  void const* leftNode 
-    = iterator->_index->skiplist->prevNode(iterator->_cursor);
+  typename Access::Position leftNode
+    = Access::prev(iterator->_index, Access::cursor(iterator));
 
   // Note that leftNode can be nullptr here!
   // ...........................................................................
   // If the leftNode == left end point AND there are no more intervals
   // then we have no next.
   // ...........................................................................
-  if (leftNode == GetInterval(iterator)->_leftEndPoint) {
+  if (leftNode == GetInterval<Access>(iterator)->_leftEndPoint) {
     return false;
   }
 
@@ -258,9 +801,10 @@ static bool SkiplistHasPrevIterationCallback (TRI_skiplist_iterator_t const* ite
 /// interval - without advancing the iterator.
 ////////////////////////////////////////////////////////////////////////////////
 
+template<typename Access>
 static bool SkiplistHasNextIterationCallback (TRI_skiplist_iterator_t const* iterator) {
   if (iterator == nullptr || 
-      iterator->_cursor == nullptr) {
+      Access::cursor(iterator) == Access::end(iterator->_index)) {
     return false;
   }
 
@@ -272,14 +816,15 @@ static bool SkiplistHasNextIterationCallback (TRI_skiplist_iterator_t const* ite
     return true;
   }
 
-  void const* leftNode = iterator->_cursor->nextNode();
+  typename Access::Position leftNode
+    = Access::next(iterator->_index, Access::cursor(iterator));
 
   // Note that leftNode can be nullptr here!
   // ...........................................................................
   // If the left == right end point AND there are no more intervals then we have
   // no next.
   // ...........................................................................
-  if (leftNode == GetInterval(iterator)->_rightEndPoint) {
+  if (leftNode == GetInterval<Access>(iterator)->_rightEndPoint) {
     return false;
   }
 
@@ -290,6 +835,7 @@ static bool SkiplistHasNextIterationCallback (TRI_skiplist_iterator_t const* ite
 /// @brief Jumps backwards by jumpSize and returns the document
 ////////////////////////////////////////////////////////////////////////////////
 
+template<typename Access>
 static TRI_skiplist_index_element_t* SkiplistPrevIterationCallback (
                         TRI_skiplist_iterator_t* iterator) {
   static const int64_t jumpSize = 1;
@@ -301,47 +847,51 @@ static TRI_skiplist_index_element_t* SkiplistPrevIterationCallback (
     return nullptr;
   }
 
-  TRI_skiplist_iterator_interval_t* interval = GetInterval(iterator);
+  typename Access::Interval* interval = GetInterval<Access>(iterator);
 
   if (interval == nullptr) {
     return nullptr;
   }
 
+  SkiplistIndex const* idx = iterator->_index;
+  typename Access::Position& cursor = Access::cursor(iterator);
+
   // ...........................................................................
   // use the current cursor and move jumpSize backward
   // ...........................................................................
 
-  triagens::basics::SkipListNode* result = nullptr; 
+  typename Access::Position result = Access::end(idx);
 
   for (int64_t j = 0; j < jumpSize; ++j) {
     while (true) {   // will be left by break
-      result = iterator->_index->skiplist->prevNode(iterator->_cursor);
+      result = Access::prev(idx, cursor);
 
       if (result == interval->_leftEndPoint) {
         if (iterator->_currentInterval == 0) {
-          iterator->_cursor = nullptr;  // exhausted
+          cursor = Access::end(idx);  // exhausted
           return nullptr;
         }
         --iterator->_currentInterval;
-        interval = GetInterval(iterator);
+        interval = GetInterval<Access>(iterator);
         TRI_ASSERT(interval != nullptr);
-        iterator->_cursor = interval->_rightEndPoint;
-        result = iterator->_index->skiplist->prevNode(iterator->_cursor);
+        cursor = interval->_rightEndPoint;
+        result = Access::prev(idx, cursor);
       }
 
-      iterator->_cursor = result;
+      cursor = result;
       break;   // we found a prev one
     }
   }
 
-  TRI_ASSERT(result != nullptr);
-  return static_cast<TRI_skiplist_index_element_t*>(result->document()); //iterator->_cursor->document());
+  TRI_ASSERT(result != Access::end(idx));
+  return static_cast<TRI_skiplist_index_element_t*>(Access::document(idx, result));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Jumps forwards by jumpSize and returns the document
 ////////////////////////////////////////////////////////////////////////////////
 
+template<typename Access>
 static TRI_skiplist_index_element_t* SkiplistNextIterationCallback (
                                TRI_skiplist_iterator_t* iterator) {
   static const int64_t jumpSize = 1;
@@ -349,42 +899,55 @@ static TRI_skiplist_index_element_t* SkiplistNextIterationCallback (
   TRI_ASSERT(jumpSize > 0);
 
   if (iterator == nullptr ||
-      iterator->_cursor == nullptr) {
+      Access::cursor(iterator) == Access::end(iterator->_index)) {
     // In this case the iterator is exhausted or does not even have intervals.
     return nullptr;
   }
   
-  TRI_skiplist_iterator_interval_t* interval = GetInterval(iterator);
+  typename Access::Interval* interval = GetInterval<Access>(iterator);
 
   if (interval == nullptr) {
     return nullptr;
   }
 
+  SkiplistIndex const* idx = iterator->_index;
+  typename Access::Position& cursor = Access::cursor(iterator);
+
   // ...........................................................................
   // use the current cursor and move jumpSize forward
   // ...........................................................................
 
   for (int64_t j = 0; j < jumpSize; ++j) {
     while (true) {   // will be left by break
-      iterator->_cursor = iterator->_cursor->nextNode();
-      if (iterator->_cursor != interval->_rightEndPoint) {
+      cursor = Access::next(idx, cursor);
+      if (cursor != interval->_rightEndPoint) {
         // Note that _cursor can be nullptr here!
         break;   // we found a next one
       }
       if (iterator->_currentInterval == (iterator->_intervals._length - 1)) {
-        iterator->_cursor = nullptr;  // exhausted
+        cursor = Access::end(idx);  // exhausted
         return nullptr;
       }
       ++iterator->_currentInterval;
-      interval = GetInterval(iterator);
+      interval = GetInterval<Access>(iterator);
       TRI_ASSERT(interval != nullptr);
-      iterator->_cursor = interval->_leftEndPoint;
+      cursor = interval->_leftEndPoint;
     }
   }
 
-  return static_cast<TRI_skiplist_index_element_t*>(iterator->_cursor->document());
+  return static_cast<TRI_skiplist_index_element_t*>(Access::document(idx, cursor));
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public globals
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether new skiplist indexes are backed by a B+-tree
+////////////////////////////////////////////////////////////////////////////////
+
+bool SKIPLIST_INDEX_USE_BPLUS_TREE = false;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                           skiplistIndex     common public methods
 // -----------------------------------------------------------------------------
@@ -411,6 +974,12 @@ void SkiplistIndex_destroy (SkiplistIndex* slIndex) {
 
   delete slIndex->skiplist;
   slIndex->skiplist = nullptr;
+
+  delete slIndex->btree;
+  slIndex->btree = nullptr;
+
+  delete slIndex->_statistics;
+  slIndex->_statistics = nullptr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -437,6 +1006,9 @@ void SkiplistIndex_free (SkiplistIndex* slIndex) {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief creates a new skiplist index
+///
+/// The index is backed by a B+-tree instead of a skiplist if
+/// SKIPLIST_INDEX_USE_BPLUS_TREE is set.
 ////////////////////////////////////////////////////////////////////////////////
 
 SkiplistIndex* SkiplistIndex_new (TRI_document_collection_t* document,
@@ -452,11 +1024,22 @@ SkiplistIndex* SkiplistIndex_new (TRI_document_collection_t* document,
   skiplistIndex->_numFields = numFields;
   skiplistIndex->unique = unique;
   try {
-    skiplistIndex->skiplist = new triagens::basics::SkipList(
+    if (SKIPLIST_INDEX_USE_BPLUS_TREE) {
+      skiplistIndex->btree = new triagens::basics::BPlusTree(
+                                           CmpElmElm, CmpKeyElm, 
+                                           PrefixElm, PrefixKey, skiplistIndex,
+                                           FreeElm, unique);
+    }
+    else {
+      skiplistIndex->skiplist = new triagens::basics::SkipList(
                                            CmpElmElm, CmpKeyElm, skiplistIndex,
                                            FreeElm, unique);
+    }
+
+    skiplistIndex->_statistics = new SkiplistIndexStatistics();
   }
   catch (...) {
+    SkiplistIndex_destroy(skiplistIndex);
     TRI_Free(TRI_CORE_MEM_ZONE, skiplistIndex);
     return nullptr;
   }
@@ -474,16 +1057,17 @@ SkiplistIndex* SkiplistIndex_new (TRI_document_collection_t* document,
 // Tests whether the LeftEndPoint is > than RightEndPoint (1)   [undefined]
 // .............................................................................
 
+template<typename Access>
 static bool skiplistIndex_findHelperIntervalValid(
                         SkiplistIndex* skiplistIndex,
-                        TRI_skiplist_iterator_interval_t const* interval) {
+                        typename Access::Interval const* interval) {
   int compareResult;
-  triagens::basics::SkipListNode* lNode;
-  triagens::basics::SkipListNode* rNode;
+  typename Access::Position lNode;
+  typename Access::Position rNode;
 
   lNode = interval->_leftEndPoint;
 
-  if (lNode == nullptr) {
+  if (lNode == Access::end(skiplistIndex)) {
     return false;
   }
   // Note that the right end point can be nullptr to indicate the end of
@@ -495,64 +1079,69 @@ static bool skiplistIndex_findHelperIntervalValid(
     return false;
   }
 
-  if (lNode->nextNode() == rNode) {
+  if (Access::next(skiplistIndex, lNode) == rNode) {
     // Interval empty, nothing to do with it.
     return false;
   }
 
-  if (nullptr != rNode && rNode->nextNode() == lNode) {
+  if (Access::end(skiplistIndex) != rNode && 
+      Access::next(skiplistIndex, rNode) == lNode) {
     // Interval empty, nothing to do with it.
     return false;
   }
 
-  if (skiplistIndex->skiplist->getNrUsed() == 0) {
+  if (Access::size(skiplistIndex) == 0) {
     return false;
   }
 
-  if ( lNode == skiplistIndex->skiplist->startNode() ||
-       nullptr == rNode ) {
+  if ( lNode == Access::start(skiplistIndex) ||
+       Access::end(skiplistIndex) == rNode ) {
     // The index is not empty, the nodes are not neighbours, one of them
     // is at the boundary, so the interval is valid and not empty.
     return true;
   }
 
   compareResult = CmpElmElm( skiplistIndex,
-                             lNode->document(), rNode->document(), 
+                             Access::document(skiplistIndex, lNode), 
+                             Access::document(skiplistIndex, rNode), 
                              triagens::basics::SKIPLIST_CMP_TOTORDER );
   return (compareResult == -1);
   // Since we know that the nodes are not neighbours, we can guarantee
   // at least one document in the interval.
 }
 
+template<typename Access>
 static bool skiplistIndex_findHelperIntervalIntersectionValid (
                     SkiplistIndex* skiplistIndex,
-                    TRI_skiplist_iterator_interval_t* lInterval,
-                    TRI_skiplist_iterator_interval_t* rInterval,
-                    TRI_skiplist_iterator_interval_t* interval) {
-  triagens::basics::SkipListNode* lNode;
-  triagens::basics::SkipListNode* rNode;
+                    typename Access::Interval* lInterval,
+                    typename Access::Interval* rInterval,
+                    typename Access::Interval* interval) {
+  typename Access::Position lNode;
+  typename Access::Position rNode;
 
   lNode = lInterval->_leftEndPoint;
   rNode = rInterval->_leftEndPoint;
 
-  if (nullptr == lNode || nullptr == rNode) {
+  if (Access::end(skiplistIndex) == lNode || 
+      Access::end(skiplistIndex) == rNode) {
     // At least one left boundary is the end, intersection is empty.
     return false;
   }
 
   int compareResult;
   // Now find the larger of the two start nodes:
-  if (lNode == skiplistIndex->skiplist->startNode()) {
+  if (lNode == Access::start(skiplistIndex)) {
     // We take rNode, even if it is the start node as well.
     compareResult = -1;
   }
-  else if (rNode == skiplistIndex->skiplist->startNode()) {
+  else if (rNode == Access::start(skiplistIndex)) {
     // We take lNode
     compareResult = 1;
   }
   else {
-    compareResult = CmpElmElm(skiplistIndex, lNode->document(), 
-                              rNode->document(), 
+    compareResult = CmpElmElm(skiplistIndex, 
+                              Access::document(skiplistIndex, lNode), 
+                              Access::document(skiplistIndex, rNode), 
                               triagens::basics::SKIPLIST_CMP_TOTORDER);
   }
 
@@ -567,17 +1156,18 @@ static bool skiplistIndex_findHelperIntervalIntersectionValid (
   rNode = rInterval->_rightEndPoint;
 
   // Now find the smaller of the two end nodes:
-  if (nullptr == lNode) {
+  if (Access::end(skiplistIndex) == lNode) {
     // We take rNode, even is this also the end node.
     compareResult = 1;
   }
-  else if (nullptr == rNode) {
+  else if (Access::end(skiplistIndex) == rNode) {
     // We take lNode.
     compareResult = -1;
   }
   else {
-    compareResult = CmpElmElm(skiplistIndex, lNode->document(), 
-                              rNode->document(),
+    compareResult = CmpElmElm(skiplistIndex, 
+                              Access::document(skiplistIndex, lNode), 
+                              Access::document(skiplistIndex, rNode), 
                               triagens::basics::SKIPLIST_CMP_TOTORDER);
   }
 
@@ -588,25 +1178,26 @@ static bool skiplistIndex_findHelperIntervalIntersectionValid (
     interval->_rightEndPoint = rNode;
   }
 
-  return skiplistIndex_findHelperIntervalValid(skiplistIndex, interval);
+  return skiplistIndex_findHelperIntervalValid<Access>(skiplistIndex, interval);
 }
 
+template<typename Access>
 static void SkiplistIndex_findHelper (SkiplistIndex* skiplistIndex,
                                       TRI_vector_t const* shapeList,
                                       TRI_index_operator_t const* indexOperator,
                                       TRI_vector_t* resultIntervalList) {
+  typedef typename Access::Interval Interval;
+
   TRI_skiplist_index_key_t          values;
   TRI_vector_t                      leftResult;
   TRI_vector_t                      rightResult;
   TRI_relation_index_operator_t*    relationOperator;
   TRI_logical_index_operator_t*     logicalOperator;
-  TRI_skiplist_iterator_interval_t  interval;
-  triagens::basics::SkipListNode*   temp;
+  Interval                          interval;
+  typename Access::Position         temp;
 
-  TRI_InitVector(&(leftResult), TRI_UNKNOWN_MEM_ZONE,
-                 sizeof(TRI_skiplist_iterator_interval_t));
-  TRI_InitVector(&(rightResult), TRI_UNKNOWN_MEM_ZONE,
-                 sizeof(TRI_skiplist_iterator_interval_t));
+  TRI_InitVector(&(leftResult), TRI_UNKNOWN_MEM_ZONE, sizeof(Interval));
+  TRI_InitVector(&(rightResult), TRI_UNKNOWN_MEM_ZONE, sizeof(Interval));
 
   relationOperator  = (TRI_relation_index_operator_t*) indexOperator;
   logicalOperator   = (TRI_logical_index_operator_t*) indexOperator;
@@ -630,22 +1221,20 @@ static void SkiplistIndex_findHelper (SkiplistIndex* skiplistIndex,
 
   switch (indexOperator->_type) {
     case TRI_AND_INDEX_OPERATOR: {
-      SkiplistIndex_findHelper(skiplistIndex,shapeList,
-                               logicalOperator->_left, &leftResult);
-      SkiplistIndex_findHelper(skiplistIndex,shapeList,
-                               logicalOperator->_right, &rightResult);
+      SkiplistIndex_findHelper<Access>(skiplistIndex,shapeList,
+                                       logicalOperator->_left, &leftResult);
+      SkiplistIndex_findHelper<Access>(skiplistIndex,shapeList,
+                                       logicalOperator->_right, &rightResult);
 
       for (size_t i = 0; i < leftResult._length; ++i) {
         for (size_t j = 0; j < rightResult._length; ++j) {
-          TRI_skiplist_iterator_interval_t* tempLeftInterval;
-          TRI_skiplist_iterator_interval_t* tempRightInterval;
+          Interval* tempLeftInterval;
+          Interval* tempRightInterval;
 
-          tempLeftInterval  =  (TRI_skiplist_iterator_interval_t*)
-                               TRI_AtVector(&leftResult, i);
-          tempRightInterval =  (TRI_skiplist_iterator_interval_t*)
-                               TRI_AtVector(&rightResult, j);
+          tempLeftInterval  =  (Interval*) TRI_AtVector(&leftResult, i);
+          tempRightInterval =  (Interval*) TRI_AtVector(&rightResult, j);
 
-          if (skiplistIndex_findHelperIntervalIntersectionValid(
+          if (skiplistIndex_findHelperIntervalIntersectionValid<Access>(
                             skiplistIndex,
                             tempLeftInterval,
                             tempRightInterval,
@@ -661,27 +1250,27 @@ static void SkiplistIndex_findHelper (SkiplistIndex* skiplistIndex,
 
 
     case TRI_EQ_INDEX_OPERATOR: {
-      temp = skiplistIndex->skiplist->leftKeyLookup(&values);
-      TRI_ASSERT(nullptr != temp);
+      temp = Access::leftKeyLookup(skiplistIndex, &values);
+      TRI_ASSERT(Access::end(skiplistIndex) != temp);
       interval._leftEndPoint = temp;
       if (skiplistIndex->unique) {
         // At most one hit:
-        temp = temp->nextNode();
-        if (nullptr != temp) {
-          if (0 == CmpKeyElm(skiplistIndex, &values, temp->document())) {
-            interval._rightEndPoint = temp->nextNode();
-            if (skiplistIndex_findHelperIntervalValid(skiplistIndex,
-                                                      &interval)) {
+        temp = Access::next(skiplistIndex, temp);
+        if (Access::end(skiplistIndex) != temp) {
+          if (0 == CmpKeyElm(skiplistIndex, &values, Access::document(skiplistIndex, temp))) {
+            interval._rightEndPoint = Access::next(skiplistIndex, temp);
+            if (skiplistIndex_findHelperIntervalValid<Access>(skiplistIndex,
+                                                              &interval)) {
               TRI_PushBackVector(resultIntervalList, &interval);
             }
           }
         }
       }
       else {
-        temp = skiplistIndex->skiplist->rightKeyLookup(&values);
-        interval._rightEndPoint = temp->nextNode();
-        if (skiplistIndex_findHelperIntervalValid(skiplistIndex,
-                                                  &interval)) {
+        temp = Access::rightKeyLookup(skiplistIndex, &values);
+        interval._rightEndPoint = Access::next(skiplistIndex, temp);
+        if (skiplistIndex_findHelperIntervalValid<Access>(skiplistIndex,
+                                                          &interval)) {
           TRI_PushBackVector(resultIntervalList, &interval);
         }
       }
@@ -689,44 +1278,44 @@ static void SkiplistIndex_findHelper (SkiplistIndex* skiplistIndex,
     }
 
     case TRI_LE_INDEX_OPERATOR: {
-      interval._leftEndPoint  = skiplistIndex->skiplist->startNode();
-      temp = skiplistIndex->skiplist->rightKeyLookup(&values);
-      interval._rightEndPoint = temp->nextNode();
+      interval._leftEndPoint  = Access::start(skiplistIndex);
+      temp = Access::rightKeyLookup(skiplistIndex, &values);
+      interval._rightEndPoint = Access::next(skiplistIndex, temp);
 
-      if (skiplistIndex_findHelperIntervalValid(skiplistIndex, &interval)) {
+      if (skiplistIndex_findHelperIntervalValid<Access>(skiplistIndex, &interval)) {
         TRI_PushBackVector(resultIntervalList, &interval);
       }
       return;
     }
 
     case TRI_LT_INDEX_OPERATOR: {
-      interval._leftEndPoint  = skiplistIndex->skiplist->startNode();
-      temp = skiplistIndex->skiplist->leftKeyLookup(&values);
-      interval._rightEndPoint = temp->nextNode();
+      interval._leftEndPoint  = Access::start(skiplistIndex);
+      temp = Access::leftKeyLookup(skiplistIndex, &values);
+      interval._rightEndPoint = Access::next(skiplistIndex, temp);
 
-      if (skiplistIndex_findHelperIntervalValid(skiplistIndex, &interval)) {
+      if (skiplistIndex_findHelperIntervalValid<Access>(skiplistIndex, &interval)) {
         TRI_PushBackVector(resultIntervalList, &interval);
       }
       return;
     }
 
     case TRI_GE_INDEX_OPERATOR: {
-      temp = skiplistIndex->skiplist->leftKeyLookup(&values);
+      temp = Access::leftKeyLookup(skiplistIndex, &values);
       interval._leftEndPoint = temp;
-      interval._rightEndPoint = skiplistIndex->skiplist->endNode();
+      interval._rightEndPoint = Access::end(skiplistIndex);
 
-      if (skiplistIndex_findHelperIntervalValid(skiplistIndex, &interval)) {
+      if (skiplistIndex_findHelperIntervalValid<Access>(skiplistIndex, &interval)) {
         TRI_PushBackVector(resultIntervalList, &interval);
       }
       return;
     }
 
     case TRI_GT_INDEX_OPERATOR: {
-      temp = skiplistIndex->skiplist->rightKeyLookup(&values);
+      temp = Access::rightKeyLookup(skiplistIndex, &values);
       interval._leftEndPoint = temp;
-      interval._rightEndPoint = skiplistIndex->skiplist->endNode();
+      interval._rightEndPoint = Access::end(skiplistIndex);
 
-      if (skiplistIndex_findHelperIntervalValid(skiplistIndex, &interval)) {
+      if (skiplistIndex_findHelperIntervalValid<Access>(skiplistIndex, &interval)) {
         TRI_PushBackVector(resultIntervalList, &interval);
       }
       return;
@@ -739,37 +1328,36 @@ static void SkiplistIndex_findHelper (SkiplistIndex* skiplistIndex,
   } // end of switch statement
 }
 
-TRI_skiplist_iterator_t* SkiplistIndex_find (
-                            SkiplistIndex* skiplistIndex,
-                            TRI_vector_t const* shapeList,
-                            TRI_index_operator_t const* indexOperator,
-                            bool reverse) {
-  TRI_skiplist_iterator_t* results = static_cast<TRI_skiplist_iterator_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_skiplist_iterator_t), true));
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the intervals of an iterator and positions its cursor
+////////////////////////////////////////////////////////////////////////////////
 
-  if (results == nullptr) {
-    return nullptr; // calling procedure needs to care when the iterator is null
-  }
+template<typename Access>
+static void SkiplistIndex_findIntervals (SkiplistIndex* skiplistIndex,
+                                         TRI_vector_t const* shapeList,
+                                         TRI_index_operator_t const* indexOperator,
+                                         bool reverse,
+                                         TRI_skiplist_iterator_t* results) {
+  typedef typename Access::Interval Interval;
 
-  results->_index = skiplistIndex;
   TRI_InitVector(&(results->_intervals), TRI_UNKNOWN_MEM_ZONE,
-                 sizeof(TRI_skiplist_iterator_interval_t));
-  results->_currentInterval = 0;
-  results->_cursor          = nullptr;
+                 sizeof(Interval));
+  Access::cursor(results) = Access::end(skiplistIndex);
 
   if (reverse) {
     // reverse iteration intentionally assigns the reverse traversal
     // methods to hasNext() and next() so the interface remains the same
     // for the caller!
-    results->hasNext         = SkiplistHasPrevIterationCallback;
-    results->next            = SkiplistPrevIterationCallback;
+    results->hasNext         = SkiplistHasPrevIterationCallback<Access>;
+    results->next            = SkiplistPrevIterationCallback<Access>;
   }
   else {
-    results->hasNext         = SkiplistHasNextIterationCallback;
-    results->next            = SkiplistNextIterationCallback;
+    results->hasNext         = SkiplistHasNextIterationCallback<Access>;
+    results->next            = SkiplistNextIterationCallback<Access>;
   }
 
-  SkiplistIndex_findHelper(skiplistIndex, shapeList, indexOperator,
-                           &(results->_intervals));
+  SkiplistIndex_findHelper<Access>(skiplistIndex, shapeList, indexOperator,
+                                   &(results->_intervals));
 
   size_t const n = TRI_LengthVector(&results->_intervals);
 
@@ -778,15 +1366,38 @@ TRI_skiplist_iterator_t* SkiplistIndex_find (
     if (reverse) {
       // start at last interval, right endpoint
       results->_currentInterval = n - 1;
-      TRI_skiplist_iterator_interval_t* tmp = static_cast<TRI_skiplist_iterator_interval_t*>(TRI_AtVector(&results->_intervals, n - 1));
-      results->_cursor = tmp->_rightEndPoint;
+      Interval* tmp = static_cast<Interval*>(TRI_AtVector(&results->_intervals, n - 1));
+      Access::cursor(results) = tmp->_rightEndPoint;
     }
     else {
       // start at first interval, left endpoint
-      TRI_skiplist_iterator_interval_t* tmp = static_cast<TRI_skiplist_iterator_interval_t*>(TRI_AtVector(&results->_intervals, 0));
-      results->_cursor = tmp->_leftEndPoint;
+      Interval* tmp = static_cast<Interval*>(TRI_AtVector(&results->_intervals, 0));
+      Access::cursor(results) = tmp->_leftEndPoint;
     }
   }
+}
+
+TRI_skiplist_iterator_t* SkiplistIndex_find (
+                            SkiplistIndex* skiplistIndex,
+                            TRI_vector_t const* shapeList,
+                            TRI_index_operator_t const* indexOperator,
+                            bool reverse) {
+  TRI_skiplist_iterator_t* results = static_cast<TRI_skiplist_iterator_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_skiplist_iterator_t), true));
+
+  if (results == nullptr) {
+    return nullptr; // calling procedure needs to care when the iterator is null
+  }
+
+  results->_index = skiplistIndex;
+  results->_currentInterval = 0;
+  results->_cursor          = nullptr;
+
+  if (skiplistIndex->btree != nullptr) {
+    SkiplistIndex_findIntervals<BPlusTreeAccess>(skiplistIndex, shapeList, indexOperator, reverse, results);
+  }
+  else {
+    SkiplistIndex_findIntervals<SkiplistAccess>(skiplistIndex, shapeList, indexOperator, reverse, results);
+  }
 
   return results;
 }
@@ -796,9 +1407,16 @@ TRI_skiplist_iterator_t* SkiplistIndex_find (
 /// ownership for the element is transferred to the index
 ////////////////////////////////////////////////////////////////////////////////
 
-int SkiplistIndex_insert (SkiplistIndex* skiplistIndex,
+static int InsertElement (SkiplistIndex* skiplistIndex,
                           TRI_skiplist_index_element_t* element) {
-  int res = skiplistIndex->skiplist->insert(element);
+  int res;
+
+  if (skiplistIndex->btree != nullptr) {
+    res = skiplistIndex->btree->insert(element);
+  }
+  else {
+    res = skiplistIndex->skiplist->insert(element);
+  }
 
   if (res != TRI_ERROR_NO_ERROR) {
     TRI_Free(TRI_UNKNOWN_MEM_ZONE, element);
@@ -807,6 +1425,121 @@ int SkiplistIndex_insert (SkiplistIndex* skiplistIndex,
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a new element into the index and updates the statistics
+/// ownership for the element is transferred to the index
+////////////////////////////////////////////////////////////////////////////////
+
+int SkiplistIndex_insert (SkiplistIndex* skiplistIndex,
+                          TRI_skiplist_index_element_t* element) {
+  int res = InsertElement(skiplistIndex, element);
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    NoteModifications(skiplistIndex, 1);
+  }
+
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills an empty index with many elements at once
+/// ownership for the elements is transferred to the index
+///
+/// The B+-tree variant sorts the elements and bulk-loads them, which is much
+/// cheaper than inserting them one by one. The skiplist variant inserts them
+/// one by one. If the index was empty, the statistics are computed right
+/// away, as filling the index already cost more than the walk. Otherwise
+/// the modifications are counted once at the end.
+////////////////////////////////////////////////////////////////////////////////
+
+int SkiplistIndex_bulkLoad (SkiplistIndex* skiplistIndex,
+                            std::vector<TRI_skiplist_index_element_t*>* elements) {
+  size_t const n = elements->size();
+  bool const wasEmpty = (SkiplistIndex_getNrUsed(skiplistIndex) == 0);
+
+  auto freeElements = [&elements] (size_t from) -> void {
+    for (size_t i = from; i < elements->size(); ++i) {
+      TRI_Free(TRI_UNKNOWN_MEM_ZONE, (*elements)[i]);
+    }
+  };
+
+  if (skiplistIndex->btree == nullptr ||
+      skiplistIndex->btree->getNrUsed() > 0) {
+    for (size_t i = 0; i < n; ++i) {
+      int res = InsertElement(skiplistIndex, (*elements)[i]);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        freeElements(i + 1);
+        NoteModifications(skiplistIndex, i);
+        return res;
+      }
+    }
+
+    if (wasEmpty) {
+      RecomputeStatistics(skiplistIndex);
+    }
+    else {
+      NoteModifications(skiplistIndex, n);
+    }
+
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  int res = TRI_ERROR_NO_ERROR;
+
+  try {
+    // sort by prefix first, so most comparisons do not touch the documents
+    std::vector<std::pair<uint64_t, TRI_skiplist_index_element_t*>> sorted;
+    sorted.reserve(n);
+
+    for (auto it : *elements) {
+      sorted.emplace_back(PrefixElm(skiplistIndex, it), it);
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [&skiplistIndex] (std::pair<uint64_t, TRI_skiplist_index_element_t*> const& l,
+                                                              std::pair<uint64_t, TRI_skiplist_index_element_t*> const& r) {
+      if (l.first != r.first) {
+        return l.first < r.first;
+      }
+      return CmpElmElm(skiplistIndex, l.second, r.second, triagens::basics::SKIPLIST_CMP_TOTORDER) < 0;
+    });
+
+    for (size_t i = 0; i < n; ++i) {
+      (*elements)[i] = sorted[i].second;
+    }
+  }
+  catch (...) {
+    res = TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    // check for duplicates, which are neighbours now
+    triagens::basics::SkipListCmpType const cmptype = (skiplistIndex->unique ? 
+                                                       triagens::basics::SKIPLIST_CMP_PREORDER :
+                                                       triagens::basics::SKIPLIST_CMP_TOTORDER);
+
+    for (size_t i = 1; i < n; ++i) {
+      if (0 == CmpElmElm(skiplistIndex, (*elements)[i - 1], (*elements)[i], cmptype)) {
+        res = TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
+        break;
+      }
+    }
+  }
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    res = skiplistIndex->btree->bulkLoad(reinterpret_cast<void* const*>(elements->data()), n);
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    freeElements(0);
+  }
+  else {
+    RecomputeStatistics(skiplistIndex);
+  }
+
+  return res;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief removes an entry from the skip list
 /// ownership for the element is transferred to the index
@@ -814,10 +1547,21 @@ int SkiplistIndex_insert (SkiplistIndex* skiplistIndex,
 
 int SkiplistIndex_remove (SkiplistIndex* skiplistIndex,
                           TRI_skiplist_index_element_t* element) {
-  int res = skiplistIndex->skiplist->remove(element);
+  int res;
+
+  if (skiplistIndex->btree != nullptr) {
+    res = skiplistIndex->btree->remove(element);
+  }
+  else {
+    res = skiplistIndex->skiplist->remove(element);
+  }
 
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, element);
 
+  if (res == TRI_ERROR_NO_ERROR) {
+    NoteModifications(skiplistIndex, 1);
+  }
+
   if (res == TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND) {
     // This is for the case of a rollback in an aborted transaction.
     // We silently ignore the fact that the document was not there.
@@ -833,6 +1577,9 @@ int SkiplistIndex_remove (SkiplistIndex* skiplistIndex,
 ////////////////////////////////////////////////////////////////////////////////
 
 uint64_t SkiplistIndex_getNrUsed (SkiplistIndex* skiplistIndex) {
+  if (skiplistIndex->btree != nullptr) {
+    return skiplistIndex->btree->getNrUsed();
+  }
   return skiplistIndex->skiplist->getNrUsed();
 }
 
@@ -841,11 +1588,108 @@ uint64_t SkiplistIndex_getNrUsed (SkiplistIndex* skiplistIndex) {
 ////////////////////////////////////////////////////////////////////////////////
 
 size_t SkiplistIndex_memoryUsage (SkiplistIndex const* skiplistIndex) {
+  if (skiplistIndex->btree != nullptr) {
+    return sizeof(SkiplistIndex) + 
+           skiplistIndex->btree->memoryUsage() +
+           skiplistIndex->btree->getNrUsed() * SkiplistIndex_ElementSize(skiplistIndex);
+  }
+
   return sizeof(SkiplistIndex) + 
          skiplistIndex->skiplist->memoryUsage() +
          skiplistIndex->skiplist->getNrUsed() * SkiplistIndex_ElementSize(skiplistIndex);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recomputes the statistics of the index if they are stale
+///
+/// This is called by the cleanup thread with a read lock on the collection,
+/// never while planning a query.
+////////////////////////////////////////////////////////////////////////////////
+
+void SkiplistIndex_refreshStatistics (SkiplistIndex* skiplistIndex) {
+  SkiplistIndexStatistics* statistics = skiplistIndex->_statistics;
+
+  if (statistics == nullptr || statistics->_modifications.load() == 0) {
+    return;
+  }
+
+  {
+    MUTEX_LOCKER(statistics->_lock);
+
+    if (statistics->_count > 0 &&
+        statistics->_modifications.load() < (std::max)(MinModificationsForStatistics, statistics->_count / 2)) {
+      return;
+    }
+  }
+
+  RecomputeStatistics(skiplistIndex);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimate the selectivity of equality lookups on the first n
+/// indexed attributes. returns 0 if no statistics are available
+////////////////////////////////////////////////////////////////////////////////
+
+double SkiplistIndex_prefixSelectivity (SkiplistIndex const* skiplistIndex,
+                                        size_t n) {
+  SkiplistIndexStatistics* statistics = skiplistIndex->_statistics;
+
+  if (statistics == nullptr) {
+    return 0.0;
+  }
+
+  MUTEX_LOCKER(statistics->_lock);
+
+  if (statistics->_count == 0 || 
+      statistics->_distinct.empty() || 
+      n == 0) {
+    return 0.0;
+  }
+
+  n = (std::min)(n, statistics->_distinct.size());
+
+  return static_cast<double>(statistics->_distinct[n - 1]) / static_cast<double>(statistics->_count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimate the fraction of elements with a first attribute value
+/// inside a range, using the histogram. returns a negative value if no
+/// histogram is available
+////////////////////////////////////////////////////////////////////////////////
+
+double SkiplistIndex_rangeFraction (SkiplistIndex const* skiplistIndex,
+                                    TRI_json_t const* low,
+                                    bool lowInclusive,
+                                    TRI_json_t const* high,
+                                    bool highInclusive) {
+  SkiplistIndexStatistics* statistics = skiplistIndex->_statistics;
+
+  if (statistics == nullptr) {
+    return -1.0;
+  }
+
+  MUTEX_LOCKER(statistics->_lock);
+
+  if (statistics->_count == 0 ||
+      statistics->_minimum == nullptr ||
+      statistics->_boundaries.empty()) {
+    return -1.0;
+  }
+
+  double matching = 0.0;
+  TRI_json_t const* lower = statistics->_minimum;
+
+  for (size_t i = 0; i < statistics->_boundaries.size(); ++i) {
+    TRI_json_t const* upper = statistics->_boundaries[i];
+
+    matching += static_cast<double>(statistics->_bucketCounts[i]) * 
+                BucketOverlap(lower, (i == 0), upper, low, lowInclusive, high, highInclusive);
+    lower = upper;
+  }
+
+  return (std::min)(1.0, matching / static_cast<double>(statistics->_count));
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
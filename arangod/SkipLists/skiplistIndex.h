@@ -32,6 +32,8 @@
 
 #include "Basics/Common.h"
 
+#include "Basics/Mutex.h"
+#include "Basics/bplus-tree.h"
 #include "Basics/skip-list.h"
 
 #include "IndexOperators/index-operator.h"
@@ -43,16 +45,58 @@
 
 struct TRI_doc_mptr_t;
 struct TRI_document_collection_t;
+struct TRI_json_t;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      skiplistIndex public globals
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether new skiplist indexes are backed by a B+-tree
+////////////////////////////////////////////////////////////////////////////////
+
+extern bool SKIPLIST_INDEX_USE_BPLUS_TREE;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                        skiplistIndex public types
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief value statistics of a skiplist index, used by the query optimizer
+///
+/// The statistics are computed by walking the index in order, which yields
+/// exact distinct counts for each prefix of the indexed attributes and an
+/// equi-depth histogram over the first attribute. They are computed when the
+/// index is filled. Inserts and removals only count the modifications. Once
+/// they exceed a fraction of the index size, the statistics are stale and the
+/// cleanup thread recomputes them. Estimates only read the figures.
+////////////////////////////////////////////////////////////////////////////////
+
+struct SkiplistIndexStatistics {
+  SkiplistIndexStatistics ();
+  ~SkiplistIndexStatistics ();
+
+  void clear ();
+  void swap (SkiplistIndexStatistics&);
+
+  triagens::basics::Mutex  _lock;          // protects the figures below
+  TRI_memory_zone_t*       _zone;          // zone of the boundary values
+  TRI_json_t*              _minimum;       // smallest value of the first attribute
+  std::vector<TRI_json_t*> _boundaries;    // inclusive upper bucket boundaries
+  std::vector<uint64_t>    _bucketCounts;  // elements per bucket
+  std::vector<uint64_t>    _distinct;      // distinct values of the first i + 1 attributes
+  uint64_t                 _count;         // elements at computation time
+
+  std::atomic<uint64_t>    _modifications; // inserts and removals since then
+};
+
 typedef struct {
   triagens::basics::SkipList* skiplist;
+  triagens::basics::BPlusTree* btree;   // used instead of the skiplist if set
   bool unique;
   struct TRI_document_collection_t* _collection;
   size_t _numFields;
+  SkiplistIndexStatistics* _statistics;
 }
 SkiplistIndex;
 
@@ -88,6 +132,18 @@ typedef struct TRI_skiplist_iterator_interval_s {
 }
 TRI_skiplist_iterator_interval_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief interval of an iterator over the B+-tree variant, with the same
+/// semantics as above. The start and end positions of the tree take the roles
+/// of the start node and of nullptr
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct TRI_bplustree_iterator_interval_s {
+  triagens::basics::BPlusTreePosition _leftEndPoint;
+  triagens::basics::BPlusTreePosition _rightEndPoint;
+}
+TRI_bplustree_iterator_interval_t;
+
 typedef struct TRI_skiplist_iterator_s {
   SkiplistIndex* _index;
   TRI_vector_t _intervals;
@@ -104,6 +160,8 @@ typedef struct TRI_skiplist_iterator_s {
                  // See SkiplistNextIterationCallback and
                  // SkiplistPrevIterationCallback for the exact
                  // condition for the iterator to be exhausted.
+  triagens::basics::BPlusTreePosition _position;
+                 // the cursor if the index uses the B+-tree variant
   bool  (*hasNext) (struct TRI_skiplist_iterator_s const*);
   TRI_skiplist_index_element_t* (*next)(struct TRI_skiplist_iterator_s*);
 }
@@ -154,6 +212,14 @@ int SkiplistIndex_remove (SkiplistIndex*, TRI_skiplist_index_element_t*);
 bool SkiplistIndex_update (SkiplistIndex*, const TRI_skiplist_index_element_t*,
                            const TRI_skiplist_index_element_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills an empty index with many elements at once
+/// ownership for the elements is transferred to the index
+////////////////////////////////////////////////////////////////////////////////
+
+int SkiplistIndex_bulkLoad (SkiplistIndex*, 
+                            std::vector<TRI_skiplist_index_element_t*>*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the number of elements in the index
 ////////////////////////////////////////////////////////////////////////////////
@@ -166,6 +232,32 @@ uint64_t SkiplistIndex_getNrUsed (SkiplistIndex*);
 
 size_t SkiplistIndex_memoryUsage (SkiplistIndex const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recomputes the statistics of the index if they are stale. the
+/// caller must hold a read lock on the collection
+////////////////////////////////////////////////////////////////////////////////
+
+void SkiplistIndex_refreshStatistics (SkiplistIndex*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimate the selectivity of equality lookups on the first n
+/// indexed attributes, i.e. the number of distinct values divided by the
+/// number of elements. returns 1 for an empty index
+////////////////////////////////////////////////////////////////////////////////
+
+double SkiplistIndex_prefixSelectivity (SkiplistIndex const*, size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimate the fraction of elements with a first attribute value
+/// inside a range. a nullptr bound means the range is open on that side
+////////////////////////////////////////////////////////////////////////////////
+
+double SkiplistIndex_rangeFraction (SkiplistIndex const*,
+                                    struct TRI_json_t const*,
+                                    bool,
+                                    struct TRI_json_t const*,
+                                    bool);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the memory size of a skiplist index element
 ////////////////////////////////////////////////////////////////////////////////
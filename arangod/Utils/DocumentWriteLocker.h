@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief single-document write locker
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_UTILS_DOCUMENT_WRITE_LOCKER_H
+#define ARANGODB_UTILS_DOCUMENT_WRITE_LOCKER_H 1
+
+#include "Basics/Common.h"
+
+#include "VocBase/document-collection.h"
+#include "VocBase/transaction.h"
+
+namespace triagens {
+  namespace arango {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         class DocumentWriteLocker
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks a collection for a write of a single document
+///
+/// the write runs concurrently with other single-document writes into the
+/// collection if the collection allows it, and write-locks the collection
+/// otherwise. see TRI_BeginConcurrentWriteDocumentCollection
+////////////////////////////////////////////////////////////////////////////////
+
+    class DocumentWriteLocker {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        DocumentWriteLocker (DocumentWriteLocker const&) = delete;
+        DocumentWriteLocker& operator= (DocumentWriteLocker const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the locker
+///
+/// the key must stay valid until the lock is released
+////////////////////////////////////////////////////////////////////////////////
+
+        DocumentWriteLocker (TRI_transaction_collection_t* trxCollection,
+                             char const* key,
+                             bool doLock)
+          : _document(trxCollection->_collection->_collection),
+            _key(key),
+            _doLock(false),
+            _concurrent(false) {
+
+          if (doLock) {
+            _concurrent = TRI_BeginConcurrentWriteDocumentCollection(trxCollection, _key);
+
+            if (! _concurrent) {
+              _document->beginWrite(_document);
+            }
+            _doLock = true;
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the locker
+////////////////////////////////////////////////////////////////////////////////
+
+        ~DocumentWriteLocker () {
+          unlock();
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief release the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        inline void unlock () {
+          if (_doLock) {
+            if (_concurrent) {
+              TRI_EndConcurrentWriteDocumentCollection(_document, _key);
+            }
+            else {
+              _document->endWrite(_document);
+            }
+            _doLock = false;
+          }
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection pointer
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_document_collection_t* _document;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief key of the document
+////////////////////////////////////////////////////////////////////////////////
+
+        char const* _key;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock flag
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _doLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the collection is locked for a concurrent write
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _concurrent;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -443,6 +443,68 @@ namespace triagens {
           return TRI_ERROR_NO_ERROR;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hand the next batchSize slots of the primary index to a callback,
+/// starting at the internal offset. the read-lock is held while the callback
+/// runs, so the callback may distribute the slots to other threads as long
+/// as it waits for them. the callback is not called if there are no more
+/// slots to read
+////////////////////////////////////////////////////////////////////////////////
+
+        int readSlots (TRI_transaction_collection_t* trxCollection,
+                       TRI_voc_size_t& internalSkip,
+                       TRI_voc_size_t batchSize,
+                       std::function<int(void**, void**)> const& callback,
+                       uint32_t* total) {
+
+          TRI_document_collection_t* document = documentCollection(trxCollection);
+
+          // READ-LOCK START
+          int res = this->lock(trxCollection, TRI_TRANSACTION_READ);
+
+          if (res != TRI_ERROR_NO_ERROR) {
+            return res;
+          }
+
+          *total = (uint32_t) document->_primaryIndex._nrUsed;
+
+          if (*total == 0 ||
+              internalSkip >= document->_primaryIndex._nrAlloc) {
+            // nothing to do
+            this->unlock(trxCollection, TRI_TRANSACTION_READ);
+
+            // READ-LOCK END
+            return TRI_ERROR_NO_ERROR;
+          }
+
+          if (orderBarrier(trxCollection) == nullptr) {
+            this->unlock(trxCollection, TRI_TRANSACTION_READ);
+            return TRI_ERROR_OUT_OF_MEMORY;
+          }
+
+          void** beg = document->_primaryIndex._table + internalSkip;
+          void** end = document->_primaryIndex._table + document->_primaryIndex._nrAlloc;
+
+          if (static_cast<size_t>(end - beg) > batchSize) {
+            end = beg + batchSize;
+          }
+
+          try {
+            res = callback(beg, end);
+          }
+          catch (...) {
+            this->unlock(trxCollection, TRI_TRANSACTION_READ);
+            throw;
+          }
+
+          internalSkip += static_cast<TRI_voc_size_t>(end - beg);
+
+          this->unlock(trxCollection, TRI_TRANSACTION_READ);
+          // READ-LOCK END
+
+          return res;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read all master pointers, using skip and limit and an internal
 /// offset into the primary index. this can be used for incremental access to
@@ -289,12 +289,24 @@ ApplicationV8::ApplicationV8 (TRI_server_t* server,
     _frontendVersionCheck(true),
     _gcInterval(1000),
     _gcFrequency(10.0),
+    _minContexts(0),
+    _contextsMaxIdle(60.0),
     _v8Options(""),
     _startupLoader(),
     _vocbase(nullptr),
     _nrInstances(),
     _contexts(),
+    _contextsLock(),
+    _issuedGlobalMethods(),
+    _contextCreationLock(),
+    _nextContextId(0),
     _contextCondition(),
+    _contextWaiters(0),
+    _numContextWaits(0),
+    _contextWaitTime(0.0),
+    _maxContextWaitTime(0.0),
+    _numContextsCreated(0),
+    _numContextsDestroyed(0),
     _freeContexts(),
     _dirtyContexts(),
     _busyContexts(),
@@ -347,29 +359,62 @@ void ApplicationV8::setVocbase (TRI_vocbase_t* vocbase) {
 ApplicationV8::V8Context* ApplicationV8::enterContext (std::string const& name,
                                                        TRI_vocbase_s* vocbase,
                                                        bool allowUseDatabase) {
+  bool const isStandard = (name == DEFAULT_NAME);
+  double waitStart = 0.0;
+
   CONDITION_LOCKER(guard, _contextCondition);
 
-  while (_freeContexts[name].empty() && ! _stopping) {
+  while (_freeContexts[name].empty() && _dirtyContexts[name].empty() && ! _stopping) {
+    if (isStandard && waitStart == 0.0) {
+      waitStart = TRI_microtime();
+      ++_contextWaiters;
+
+      // wake up the GC thread so it can create an additional context
+      guard.broadcast();
+    }
+
     LOG_DEBUG("waiting for unused V8 context");
     guard.wait();
   }
 
+  if (waitStart > 0.0) {
+    double const waitTime = TRI_microtime() - waitStart;
+
+    --_contextWaiters;
+    ++_numContextWaits;
+    _contextWaitTime += waitTime;
+
+    if (waitTime > _maxContextWaitTime) {
+      _maxContextWaitTime = waitTime;
+    }
+  }
+
   // in case we are in the shutdown phase, do not enter a context!
   // the context might have been deleted by the shutdown
   if (_stopping) {
     return nullptr;
   }
 
-  LOG_TRACE("found unused V8 context");
-  TRI_ASSERT(! _freeContexts[name].empty());
+  V8Context* context;
 
-  V8Context* context = _freeContexts[name].back();
+  if (! _freeContexts[name].empty()) {
+    LOG_TRACE("found unused V8 context");
+    context = _freeContexts[name].back();
+    _freeContexts[name].pop_back();
+  }
+  else {
+    // all unused contexts are waiting for their garbage collection. rather than
+    // letting the request wait for the GC, use one of them right away. it will
+    // be put back into the dirty list when it is returned
+    LOG_TRACE("found dirty V8 context, postponing its garbage collection");
+    context = _dirtyContexts[name].back();
+    _dirtyContexts[name].pop_back();
+  }
 
   TRI_ASSERT(context != nullptr);
   auto isolate = context->isolate;
   TRI_ASSERT(isolate != nullptr);
 
-  _freeContexts[name].pop_back();
   _busyContexts[name].insert(context);
 
   context->_locker = new v8::Locker(isolate);
@@ -480,7 +525,8 @@ void ApplicationV8::exitContext (V8Context* context) {
   // default is false
   bool performGarbageCollection = false;
 
-  // postpone garbage collection for standard contexts
+  // garbage collection is never performed here but postponed, so the GC
+  // thread can collect the garbage while the context is unused
   if (isStandard) {
     if (context->_lastGcStamp + _gcFrequency < lastGc) {
       LOG_TRACE("V8 context has reached GC timeout threshold and will be scheduled for GC");
@@ -490,61 +536,28 @@ void ApplicationV8::exitContext (V8Context* context) {
       LOG_TRACE("V8 context has reached maximum number of requests and will be scheduled for GC");
       performGarbageCollection = true;
     }
-
-    if (performGarbageCollection) {
-      _dirtyContexts[name].push_back(context);
-    }
-    else {
-      _freeContexts[name].push_back(context);
-    }
-
-    _busyContexts[name].erase(context);
-
-    delete context->_locker;
-    context->_locker = nullptr;
-
-    TRI_ASSERT(! v8::Locker::IsLocked(isolate));
-
-    guard.broadcast();
+  }
+  else if (context->_numExecutions >= 1000) {
+    LOG_TRACE("V8 context has reached maximum number of requests and will be scheduled for GC");
+    performGarbageCollection = true;
   }
 
-  // non-standard case: directly collect the garbage
+  if (performGarbageCollection) {
+    _dirtyContexts[name].push_back(context);
+  }
   else {
-    if (context->_numExecutions >= 1000) {
-      LOG_TRACE("V8 context has reached maximum number of requests and will be scheduled for GC");
-      performGarbageCollection = true;
-    }
-
-    _busyContexts[name].erase(context);
-
-    if (performGarbageCollection) {
-      guard.unlock();
-
-      isolate->Enter();
-      {
-        v8::HandleScope scope(isolate);
-        auto localContext = v8::Local<v8::Context>::New(isolate, context->_context);
-
-        localContext->Enter();
-      
-        TRI_ASSERT(context->_locker->IsLocked(isolate));
-        TRI_ASSERT(v8::Locker::IsLocked(isolate));
+    _freeContexts[name].push_back(context);
+  }
 
-        TRI_RunGarbageCollectionV8(isolate, 1.0);
+  _busyContexts[name].erase(context);
+  context->_lastUsedStamp = TRI_microtime();
 
-        localContext->Exit();
-      }
-      isolate->Exit();
+  delete context->_locker;
+  context->_locker = nullptr;
 
-      guard.lock();
+  TRI_ASSERT(! v8::Locker::IsLocked(isolate));
 
-      context->_numExecutions = 0;
-    }
-
-    delete context->_locker;
-    context->_locker = nullptr;
-    _freeContexts[name].push_back(context);
-  }
+  guard.broadcast();
 
   LOG_TRACE("returned dirty V8 context");
 }
@@ -555,14 +568,21 @@ void ApplicationV8::exitContext (V8Context* context) {
 
 bool ApplicationV8::addGlobalContextMethod (string const& method) {
   bool result = true;
-  size_t nrInstances = _nrInstances[DEFAULT_NAME];
 
-  for (size_t i = 0; i < nrInstances; ++i) {
-    if (! _contexts[DEFAULT_NAME][i]->addGlobalContextMethod(method)) {
+  WRITE_LOCKER(_contextsLock);
+
+  for (auto& context : _contexts[DEFAULT_NAME]) {
+    if (context != nullptr && ! context->addGlobalContextMethod(method)) {
       result = false;
     }
   }
 
+  // remember the method so contexts created later will execute it, too
+  if (result &&
+      std::find(_issuedGlobalMethods.begin(), _issuedGlobalMethods.end(), method) == _issuedGlobalMethods.end()) {
+    _issuedGlobalMethods.push_back(method);
+  }
+
   return result;
 }
 
@@ -589,12 +609,16 @@ void ApplicationV8::collectGarbage () {
 
   while (_stopping == 0) {
     V8Context* context = nullptr;
+    V8Context* idleContext = nullptr;
+    bool addContext = false;
 
     {
       bool gotSignal = false;
       CONDITION_LOCKER(guard, _contextCondition);
 
-      if (_dirtyContexts[DEFAULT_NAME].empty()) {
+      context = pickDirtyContextForGc();
+
+      if (context == nullptr && ! needsAdditionalContext()) {
         uint64_t waitTime = useReducedWait ? reducedWaitTime : regularWaitTime;
 
         // we'll wait for a signal or a timeout
@@ -603,11 +627,20 @@ void ApplicationV8::collectGarbage () {
         // use a reduced wait time in the next round because we seem to be idle
         // the reduced wait time will allow use to perfom GC for more contexts
         useReducedWait = ! gotSignal;
+
+        context = pickDirtyContextForGc();
       }
 
-      if (! _dirtyContexts[DEFAULT_NAME].empty()) {
-        context = _dirtyContexts[DEFAULT_NAME].back();
-        _dirtyContexts[DEFAULT_NAME].pop_back();
+      if (needsAdditionalContext()) {
+        // requests are waiting and all contexts are in use. creating a new
+        // context has priority over collecting the garbage of dirty contexts
+        if (context != nullptr) {
+          _dirtyContexts[context->_name].push_back(context);
+          context = nullptr;
+        }
+        addContext = true;
+      }
+      else if (context != nullptr) {
         useReducedWait = false;
       }
       else if (! gotSignal && ! _freeContexts[DEFAULT_NAME].empty()) {
@@ -620,6 +653,11 @@ void ApplicationV8::collectGarbage () {
         // already. increase the wait time so we don't cycle too much in the GC loop
         // and waste CPU unnecessary
         useReducedWait = (context != nullptr);
+
+        if (context == nullptr) {
+          // nothing to clean up. check if the pool can be shrunk
+          idleContext = pickIdleContextForRemoval();
+        }
       }
     }
 
@@ -627,7 +665,13 @@ void ApplicationV8::collectGarbage () {
     double lastGc = TRI_microtime();
     gc->updateGcStamp(lastGc);
 
-    if (context != nullptr) {
+    if (addContext) {
+      addStandardContext();
+    }
+    else if (idleContext != nullptr) {
+      removeStandardContext(idleContext);
+    }
+    else if (context != nullptr) {
       LOG_TRACE("collecting V8 garbage");
       auto isolate = context->isolate;
       TRI_ASSERT(context->_locker == nullptr);
@@ -653,15 +697,24 @@ void ApplicationV8::collectGarbage () {
       delete context->_locker;
       context->_locker = nullptr;
 
-      // update garbage collection statistics
-      context->_hasDeadObjects = false;
-      context->_numExecutions  = 0;
-      context->_lastGcStamp    = lastGc;
+      double const gcDuration = TRI_microtime() - lastGc;
 
       {
         CONDITION_LOCKER(guard, _contextCondition);
 
-        _freeContexts[DEFAULT_NAME].push_back(context);
+        // update garbage collection statistics
+        context->_hasDeadObjects = false;
+        context->_numExecutions  = 0;
+        context->_lastGcStamp    = lastGc;
+        context->_lastGcDuration = gcDuration;
+        context->_gcTime        += gcDuration;
+        ++context->_numGcs;
+
+        if (gcDuration > context->_maxGcDuration) {
+          context->_maxGcDuration = gcDuration;
+        }
+
+        _freeContexts[context->_name].push_back(context);
         guard.broadcast();
       }
     }
@@ -670,6 +723,58 @@ void ApplicationV8::collectGarbage () {
   _gcFinished = true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns statistics about the pool of standard contexts
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json ApplicationV8::statistics () {
+  triagens::basics::Json result(triagens::basics::Json::Object);
+  triagens::basics::Json contexts(triagens::basics::Json::Array);
+
+  CONDITION_LOCKER(guard, _contextCondition);
+
+  size_t numContexts;
+  {
+    READ_LOCKER(_contextsLock);
+    numContexts = _contexts[DEFAULT_NAME].size();
+
+    for (auto& context : _contexts[DEFAULT_NAME]) {
+      if (context == nullptr) {
+        continue;
+      }
+
+      bool const busy = (_busyContexts[DEFAULT_NAME].find(context) != _busyContexts[DEFAULT_NAME].end());
+
+      contexts.add(triagens::basics::Json(triagens::basics::Json::Object)
+        ("id", triagens::basics::Json(static_cast<double>(context->_id)))
+        ("busy", triagens::basics::Json(busy))
+        ("executions", triagens::basics::Json(static_cast<double>(context->_numExecutions)))
+        ("lastUsed", triagens::basics::Json(context->_lastUsedStamp))
+        ("gcRuns", triagens::basics::Json(static_cast<double>(context->_numGcs)))
+        ("gcTime", triagens::basics::Json(context->_gcTime))
+        ("lastGc", triagens::basics::Json(context->_lastGcStamp))
+        ("lastGcPause", triagens::basics::Json(context->_lastGcDuration))
+        ("maxGcPause", triagens::basics::Json(context->_maxGcDuration)));
+    }
+  }
+
+  result("contexts", triagens::basics::Json(static_cast<double>(numContexts)))
+        ("minimum", triagens::basics::Json(static_cast<double>(_minContexts)))
+        ("maximum", triagens::basics::Json(static_cast<double>(_nrInstances[DEFAULT_NAME])))
+        ("free", triagens::basics::Json(static_cast<double>(_freeContexts[DEFAULT_NAME].size())))
+        ("dirty", triagens::basics::Json(static_cast<double>(_dirtyContexts[DEFAULT_NAME].size())))
+        ("busy", triagens::basics::Json(static_cast<double>(_busyContexts[DEFAULT_NAME].size())))
+        ("waiting", triagens::basics::Json(static_cast<double>(_contextWaiters)))
+        ("waits", triagens::basics::Json(static_cast<double>(_numContextWaits)))
+        ("waitTime", triagens::basics::Json(_contextWaitTime))
+        ("maxWaitTime", triagens::basics::Json(_maxContextWaitTime))
+        ("created", triagens::basics::Json(static_cast<double>(_numContextsCreated)))
+        ("destroyed", triagens::basics::Json(static_cast<double>(_numContextsDestroyed)))
+        ("details", contexts);
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief disables actions
 ////////////////////////////////////////////////////////////////////////////////
@@ -877,10 +982,8 @@ void ApplicationV8::versionCheck () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void ApplicationV8::prepareServer () {
-  size_t nrInstances = _nrInstances[DEFAULT_NAME];
-
-  for (size_t i = 0;  i < nrInstances;  ++i) {
-    prepareV8Server(DEFAULT_NAME, i, _startupFile);
+  for (auto& context : _contexts[DEFAULT_NAME]) {
+    prepareV8Server(context, _startupFile);
   }
 }
 
@@ -892,8 +995,8 @@ bool ApplicationV8::prepareNamedContexts (const string& name,
                                           size_t concurrency,
                                           const string& worker) {
   {
-    CONDITION_LOCKER(guard, _contextCondition);
-    _contexts[name] = new V8Context*[concurrency];
+    WRITE_LOCKER(_contextsLock);
+    _contexts[name].resize(concurrency, nullptr);
     _nrInstances[name] = concurrency;
   }
   
@@ -906,11 +1009,11 @@ bool ApplicationV8::prepareNamedContexts (const string& name,
       return false;
     }
 
-    prepareV8Server(name, i, "server/worker.js");
-
     // and generate MAIN
     V8Context* context = _contexts[name][i];
 
+    prepareV8Server(context, "server/worker.js");
+
     TRI_ASSERT(context->_locker == nullptr);
     context->_locker = new v8::Locker(context->isolate);
     auto isolate = context->isolate;
@@ -966,6 +1069,8 @@ void ApplicationV8::setupOptions (map<string, basics::ProgramOptionsDescription>
   options["Javascript Options:help-admin"]
     ("javascript.gc-interval", &_gcInterval, "JavaScript request-based garbage collection interval (each x requests)")
     ("javascript.gc-frequency", &_gcFrequency, "JavaScript time-based garbage collection frequency (each x seconds)")
+    ("javascript.v8-contexts-minimum", &_minContexts, "minimum number of V8 contexts kept for executing JavaScript actions (0 = same as maximum)")
+    ("javascript.v8-contexts-max-idle", &_contextsMaxIdle, "time (in seconds) after which surplus idle V8 contexts are destroyed")
     ("javascript.app-path", &_appPath, "directory for Foxx applications (normal mode)")
     ("javascript.startup-directory", &_startupPath, "path to the directory containing JavaScript startup scripts")
     ("javascript.v8-options", &_v8Options, "options to pass to v8")
@@ -1046,7 +1151,15 @@ bool ApplicationV8::prepare () {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool ApplicationV8::prepare2 () {
-  size_t nrInstances = _nrInstances[DEFAULT_NAME];
+  size_t const maxInstances = _nrInstances[DEFAULT_NAME];
+
+  if (_minContexts == 0 || _minContexts > maxInstances) {
+    _minContexts = maxInstances;
+  }
+
+  // only the minimum number of contexts is created on startup, more contexts
+  // are created on demand by the GC thread
+  size_t const nrInstances = static_cast<size_t>(_minContexts);
   v8::V8::InitializeICU();
 
   TRI_ASSERT(_platform == nullptr);
@@ -1056,10 +1169,13 @@ bool ApplicationV8::prepare2 () {
 
   // setup instances
   {
-    CONDITION_LOCKER(guard, _contextCondition);
-    _contexts[DEFAULT_NAME] = new V8Context*[nrInstances];
+    WRITE_LOCKER(_contextsLock);
+    _contexts[DEFAULT_NAME].resize(nrInstances, nullptr);
+    _nextContextId = nrInstances;
   }
 
+  LOG_DEBUG("creating %d of at most %d V8 contexts", (int) nrInstances, (int) maxInstances);
+
   std::vector<std::thread> threads;
   _ok = true;
   for (size_t i = 0; i < nrInstances;  ++i) {
@@ -1167,15 +1283,14 @@ void ApplicationV8::stop () {
   {
     CONDITION_LOCKER(guard, _contextCondition);
 
-    for (auto all : _contexts) {
-      const string& name = all.first;
-      size_t nrInstances = _nrInstances[name];
+    WRITE_LOCKER(_contextsLock);
 
-      for (size_t i = 0;  i < nrInstances;  ++i) {
-        shutdownV8Instance(name, i);
+    for (auto& all : _contexts) {
+      for (auto& context : all.second) {
+        shutdownV8Instance(context);
       }
 
-      delete[] _contexts[name];
+      all.second.clear();
     }
   }
 
@@ -1255,11 +1370,141 @@ ApplicationV8::V8Context* ApplicationV8::pickFreeContextForGc () {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief prepares a V8 instance
+/// @brief determine which dirty context should be picked for the GC
 ////////////////////////////////////////////////////////////////////////////////
 
-bool ApplicationV8::prepareV8Instance (const string& name, size_t i, bool useActions) {
-  CONDITION_LOCKER(guard, _contextCondition);
+ApplicationV8::V8Context* ApplicationV8::pickDirtyContextForGc () {
+  for (auto& it : _dirtyContexts) {
+    if (! it.second.empty()) {
+      V8Context* context = it.second.back();
+      it.second.pop_back();
+
+      return context;
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not an additional standard context should be created
+////////////////////////////////////////////////////////////////////////////////
+
+bool ApplicationV8::needsAdditionalContext () {
+  if (_contextWaiters == 0 ||
+      ! _freeContexts[DEFAULT_NAME].empty() ||
+      ! _dirtyContexts[DEFAULT_NAME].empty()) {
+    return false;
+  }
+
+  READ_LOCKER(_contextsLock);
+  return _contexts[DEFAULT_NAME].size() < _nrInstances[DEFAULT_NAME];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief determine which of the free contexts has been idle long enough to
+/// be removed from the pool
+////////////////////////////////////////////////////////////////////////////////
+
+ApplicationV8::V8Context* ApplicationV8::pickIdleContextForRemoval () {
+  if (_contextWaiters > 0) {
+    return nullptr;
+  }
+
+  {
+    READ_LOCKER(_contextsLock);
+
+    if (_contexts[DEFAULT_NAME].size() <= _minContexts) {
+      return nullptr;
+    }
+  }
+
+  double const threshold = TRI_microtime() - _contextsMaxIdle;
+  auto& free = _freeContexts[DEFAULT_NAME];
+
+  for (auto it = free.begin(); it != free.end(); ++it) {
+    V8Context* context = (*it);
+
+    // context #0 executes the one-time startup actions and is never removed
+    if (context->_id != 0 && context->_lastUsedStamp < threshold) {
+      free.erase(it);
+      return context;
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an additional standard context and puts it into the pool
+////////////////////////////////////////////////////////////////////////////////
+
+bool ApplicationV8::addStandardContext () {
+  size_t const id = _nextContextId++;
+
+  LOG_DEBUG("creating additional V8 context #%d", (int) id);
+
+  V8Context* context = createV8Context(DEFAULT_NAME, id, _useActions);
+
+  if (context == nullptr) {
+    return false;
+  }
+
+  prepareV8Server(context, _startupFile);
+
+  {
+    WRITE_LOCKER(_contextsLock);
+
+    // the context has loaded a fresh state, but it must also execute the
+    // global methods issued since the server was started
+    for (auto& method : _issuedGlobalMethods) {
+      context->addGlobalContextMethod(method);
+    }
+
+    _contexts[DEFAULT_NAME].push_back(context);
+  }
+
+  {
+    CONDITION_LOCKER(guard, _contextCondition);
+
+    context->_lastUsedStamp = TRI_microtime();
+    ++_numContextsCreated;
+
+    _freeContexts[DEFAULT_NAME].push_back(context);
+    guard.broadcast();
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes an idle standard context from the pool and destroys it
+////////////////////////////////////////////////////////////////////////////////
+
+void ApplicationV8::removeStandardContext (V8Context* context) {
+  LOG_DEBUG("removing idle V8 context #%d", (int) context->_id);
+
+  {
+    WRITE_LOCKER(_contextsLock);
+
+    auto& contexts = _contexts[DEFAULT_NAME];
+    contexts.erase(std::remove(contexts.begin(), contexts.end(), context), contexts.end());
+  }
+
+  shutdownV8Instance(context);
+
+  {
+    CONDITION_LOCKER(guard, _contextCondition);
+    ++_numContextsDestroyed;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a new V8 isolate and context, without registering it
+////////////////////////////////////////////////////////////////////////////////
+
+ApplicationV8::V8Context* ApplicationV8::createV8Context (const string& name, size_t i, bool useActions) {
+  MUTEX_LOCKER(_contextCreationLock);
 
   vector<string> files;
 
@@ -1267,7 +1512,7 @@ bool ApplicationV8::prepareV8Instance (const string& name, size_t i, bool useAct
 
   v8::Isolate* isolate = v8::Isolate::New();
   
-  V8Context* context = _contexts[name][i] = new V8Context();
+  V8Context* context = new V8Context();
 
   if (context == nullptr) {
     LOG_FATAL_AND_EXIT("cannot initialize V8 context #%d", (int) i);
@@ -1382,7 +1627,30 @@ bool ApplicationV8::prepareV8Instance (const string& name, size_t i, bool useAct
 
   LOG_TRACE("initialised V8 context #%d", (int) i);
 
-  _freeContexts[name].push_back(context);
+  return context;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prepares a V8 instance
+////////////////////////////////////////////////////////////////////////////////
+
+bool ApplicationV8::prepareV8Instance (const string& name, size_t i, bool useActions) {
+  V8Context* context = createV8Context(name, i, useActions);
+
+  if (context == nullptr) {
+    return false;
+  }
+
+  {
+    WRITE_LOCKER(_contextsLock);
+    _contexts[name][i] = context;
+  }
+
+  {
+    CONDITION_LOCKER(guard, _contextCondition);
+    context->_lastUsedStamp = TRI_microtime();
+    _freeContexts[name].push_back(context);
+  }
 
   return true;
 }
@@ -1391,11 +1659,9 @@ bool ApplicationV8::prepareV8Instance (const string& name, size_t i, bool useAct
 /// @brief prepares the V8 server
 ////////////////////////////////////////////////////////////////////////////////
 
-void ApplicationV8::prepareV8Server (const string& name, const size_t i, const string& startupFile) {
+void ApplicationV8::prepareV8Server (V8Context* context, const string& startupFile) {
 
   // enter context and isolate
-  V8Context* context = _contexts[name][i];
-
   auto isolate = context->isolate;
   TRI_ASSERT(context->_locker == nullptr);
   context->_locker = new v8::Locker(isolate);
@@ -1428,17 +1694,17 @@ void ApplicationV8::prepareV8Server (const string& name, const size_t i, const s
   context->_locker = nullptr;
 
   // initialise garbage collection for context
-  LOG_TRACE("initialised V8 server #%d", (int) i);
+  LOG_TRACE("initialised V8 server #%d", (int) context->_id);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief shut downs a V8 instances
 ////////////////////////////////////////////////////////////////////////////////
 
-void ApplicationV8::shutdownV8Instance (const string& name, size_t i) {
-  LOG_TRACE("shutting down V8 context #%d", (int) i);
+void ApplicationV8::shutdownV8Instance (V8Context* context) {
+  size_t const i = context->_id;
 
-  V8Context* context = _contexts[name][i];
+  LOG_TRACE("shutting down V8 context #%d", (int) i);
 
   auto isolate = context->isolate;
   isolate->Enter();
@@ -37,6 +37,9 @@
 #include <v8.h>
 
 #include "Basics/ConditionVariable.h"
+#include "Basics/JsonHelper.h"
+#include "Basics/Mutex.h"
+#include "Basics/ReadWriteLock.h"
 #include "V8/JSLoader.h"
 
 // -----------------------------------------------------------------------------
@@ -247,6 +250,36 @@ namespace triagens {
 
           double _lastGcStamp;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timestamp of the last time the context was returned to the pool
+////////////////////////////////////////////////////////////////////////////////
+
+          double _lastUsedStamp = 0.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of garbage collections performed for the context
+////////////////////////////////////////////////////////////////////////////////
+
+          uint64_t _numGcs = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total time spent in garbage collection for the context (seconds)
+////////////////////////////////////////////////////////////////////////////////
+
+          double _gcTime = 0.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief duration of the last garbage collection for the context (seconds)
+////////////////////////////////////////////////////////////////////////////////
+
+          double _lastGcDuration = 0.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief longest garbage collection for the context (seconds)
+////////////////////////////////////////////////////////////////////////////////
+
+          double _maxGcDuration = 0.0;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not the context has dead (ex-v8 wrapped) objects
 ////////////////////////////////////////////////////////////////////////////////
@@ -325,6 +358,12 @@ namespace triagens {
 
         void collectGarbage ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns statistics about the pool of standard contexts
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Json statistics ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief disables actions
 ////////////////////////////////////////////////////////////////////////////////
@@ -427,6 +466,47 @@ namespace triagens {
 
         V8Context* pickFreeContextForGc ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief determine which dirty context should be picked for the GC
+////////////////////////////////////////////////////////////////////////////////
+
+        V8Context* pickDirtyContextForGc ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not an additional standard context should be created
+///
+/// Caller must hold the _contextCondition.
+////////////////////////////////////////////////////////////////////////////////
+
+        bool needsAdditionalContext ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief determine which of the free contexts has been idle long enough to
+/// be removed from the pool
+///
+/// Caller must hold the _contextCondition.
+////////////////////////////////////////////////////////////////////////////////
+
+        V8Context* pickIdleContextForRemoval ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an additional standard context and puts it into the pool
+////////////////////////////////////////////////////////////////////////////////
+
+        bool addStandardContext ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes an idle standard context from the pool and destroys it
+////////////////////////////////////////////////////////////////////////////////
+
+        void removeStandardContext (V8Context*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a new V8 isolate and context, without registering it
+////////////////////////////////////////////////////////////////////////////////
+
+        V8Context* createV8Context (const std::string& name, size_t id, bool useActions);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief prepares a V8 instance
 ////////////////////////////////////////////////////////////////////////////////
@@ -448,13 +528,13 @@ namespace triagens {
 /// @brief prepares the V8 server
 ////////////////////////////////////////////////////////////////////////////////
 
-        void prepareV8Server (const std::string& name, size_t i, const std::string& startupFile);
+        void prepareV8Server (V8Context*, const std::string& startupFile);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief shuts down a V8 instance
 ////////////////////////////////////////////////////////////////////////////////
 
-        void shutdownV8Instance (const std::string& name, size_t i);
+        void shutdownV8Instance (V8Context*);
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
@@ -538,6 +618,37 @@ namespace triagens {
 
         double _gcFrequency;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief minimum number of V8 contexts for executing JavaScript actions
+/// @startDocuBlock jsV8ContextsMinimum
+/// `--javascript.v8-contexts-minimum number`
+///
+/// Specifies the minimum *number* of V8 contexts that are kept for executing
+/// JavaScript actions. The server starts with this number of contexts and
+/// creates additional contexts on demand, up to the number specified by
+/// `--javascript.v8-contexts`. Contexts that have been idle for longer than
+/// `--javascript.v8-contexts-max-idle` seconds are destroyed again until
+/// the minimum is reached. The default value *0* means that the minimum is
+/// equal to the maximum number of contexts, so the pool does not grow or
+/// shrink.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _minContexts;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief idle time after which surplus V8 contexts are destroyed
+/// @startDocuBlock jsV8ContextsMaxIdle
+/// `--javascript.v8-contexts-max-idle seconds`
+///
+/// Specifies the time (in seconds) after which an unused V8 context is
+/// destroyed if there are more contexts than specified by
+/// `--javascript.v8-contexts-minimum`.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        double _contextsMaxIdle;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief optional arguments to pass to v8
 /// @startDocuBlock jsV8Options
@@ -595,7 +706,33 @@ namespace triagens {
 /// @brief V8 contexts
 ////////////////////////////////////////////////////////////////////////////////
 
-        std::map<std::string, V8Context**> _contexts;
+        std::map<std::string, std::vector<V8Context*>> _contexts;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock protecting _contexts and _issuedGlobalMethods
+///
+/// If both locks are needed, the _contextCondition must be acquired first.
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::ReadWriteLock _contextsLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief global methods issued so far, replayed in contexts created later
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> _issuedGlobalMethods;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief mutex serializing the creation of V8 contexts
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::Mutex _contextCreationLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief identifier for the next standard context created on demand
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _nextContextId;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief V8 contexts queue lock
@@ -603,6 +740,42 @@ namespace triagens {
 
         basics::ConditionVariable _contextCondition;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads currently waiting for a standard context
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _contextWaiters;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of times a thread had to wait for a standard context
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _numContextWaits;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total time threads spent waiting for a standard context (seconds)
+////////////////////////////////////////////////////////////////////////////////
+
+        double _contextWaitTime;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief longest time a thread waited for a standard context (seconds)
+////////////////////////////////////////////////////////////////////////////////
+
+        double _maxContextWaitTime;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of standard contexts created on demand
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _numContextsCreated;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of idle standard contexts destroyed
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _numContextsDestroyed;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief V8 free contexts
 ////////////////////////////////////////////////////////////////////////////////
@@ -610,7 +783,7 @@ namespace triagens {
         std::map<std::string, std::vector<V8Context*>> _freeContexts;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief V8 free contexts
+/// @brief V8 contexts waiting for garbage collection
 ////////////////////////////////////////////////////////////////////////////////
 
         std::map<std::string, std::vector<V8Context*>> _dirtyContexts;
@@ -1746,6 +1746,12 @@ static TRI_doc_collection_info_t* GetFigures (TRI_vocbase_col_t* collection) {
 /// * *indexes.count*: The total number of indexes defined for the
 ///   collection, including the pre-defined indexes (e.g. primary index).
 /// * *indexes.size*: The total memory allocated for indexes in bytes.
+/// * *masterPointers.count*: The number of master pointers allocated for
+///   the documents of the collection. There is one master pointer per live
+///   document, plus one per document that was inserted or updated in a
+///   running transaction.
+/// * *masterPointers.size*: The total memory allocated for master pointers
+///   in bytes, including unused master pointers of partially filled blocks.
 /// * *maxTick*: The tick of the last marker that was stored in a journal
 ///   of the collection. This might be 0 if the collection does not yet have
 ///   a journal.
@@ -1865,6 +1871,11 @@ static void JS_FiguresVocbaseCol (const v8::FunctionCallbackInfo<v8::Value>& arg
   indexes->Set(TRI_V8_ASCII_STRING("count"),     v8::Number::New(isolate, (double) info->_numberIndexes));
   indexes->Set(TRI_V8_ASCII_STRING("size"),      v8::Number::New(isolate, (double) info->_sizeIndexes));
 
+  v8::Handle<v8::Object> masterPointers = v8::Object::New(isolate);
+  result->Set(TRI_V8_ASCII_STRING("masterPointers"), masterPointers);
+  masterPointers->Set(TRI_V8_ASCII_STRING("count"), v8::Number::New(isolate, (double) info->_numberMasterPointers));
+  masterPointers->Set(TRI_V8_ASCII_STRING("size"),  v8::Number::New(isolate, (double) info->_sizeMasterPointers));
+
   result->Set(TRI_V8_ASCII_STRING("lastTick"),   V8TickId(isolate, info->_tickMax));
   result->Set(TRI_V8_ASCII_STRING("uncollectedLogfileEntries"), v8::Number::New(isolate, (double) info->_uncollectedLogfileEntries));
 
@@ -44,6 +44,7 @@
 #include "Basics/MutexLocker.h"
 #include "Utils/transactions.h"
 #include "Utils/V8ResolverGuard.h"
+#include "V8Server/ApplicationV8.h"
 
 #include "HttpServer/ApplicationEndpointServer.h"
 #include "V8/v8-conv.h"
@@ -553,6 +554,46 @@ static void JS_FlushWal (const v8::FunctionCallbackInfo<v8::Value>& args) {
   TRI_V8_RETURN_TRUE();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns statistics about the pool of V8 contexts
+/// @startDocuBlock v8ContextStatistics
+/// `internal.v8ContextStatistics()`
+///
+/// Returns an object with statistics about the pool of V8 contexts used for
+/// executing JavaScript actions:
+///
+/// - *contexts*: number of contexts currently in the pool
+/// - *minimum*, *maximum*: bounds between which the pool grows and shrinks
+/// - *free*, *dirty*, *busy*: number of unused contexts, contexts waiting for
+///   their garbage collection and contexts currently in use
+/// - *waiting*: number of threads currently waiting for a context
+/// - *waits*, *waitTime*, *maxWaitTime*: number of times a thread had to wait
+///   for a context, and the total and maximum time spent waiting (in seconds)
+/// - *created*, *destroyed*: number of contexts created on demand and number
+///   of idle contexts destroyed
+/// - *details*: per-context execution and garbage collection pause times
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+static void JS_V8ContextStatistics (const v8::FunctionCallbackInfo<v8::Value>& args) {
+  v8::Isolate* isolate = args.GetIsolate();
+  v8::HandleScope scope(isolate);
+
+  if (args.Length() != 0) {
+    TRI_V8_THROW_EXCEPTION_USAGE("V8_CONTEXT_STATISTICS()");
+  }
+
+  TRI_GET_GLOBALS();
+
+  if (v8g->_applicationV8 == nullptr) {
+    TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
+  }
+
+  triagens::basics::Json json = v8g->_applicationV8->statistics();
+
+  TRI_V8_RETURN(TRI_ObjectJson(isolate, json.json()));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief normalize UTF 16 strings
 ////////////////////////////////////////////////////////////////////////////////
@@ -2811,6 +2852,7 @@ void TRI_InitV8VocBridge (v8::Isolate* isolate,
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("TRANSACTION"), JS_Transaction, true);
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("WAL_FLUSH"), JS_FlushWal, true);
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("WAL_PROPERTIES"), JS_PropertiesWal, true);
+  TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("V8_CONTEXT_STATISTICS"), JS_V8ContextStatistics, true);
   
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("ENABLE_NATIVE_BACKTRACES"), JS_EnableNativeBacktraces, true);
 
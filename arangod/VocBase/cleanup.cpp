@@ -315,6 +315,9 @@ void TRI_CleanupVocBase (void* data) {
           document->cleanupIndexes(document);
         }
 
+        // refresh stale index statistics, so that queries do not have to
+        TRI_RefreshIndexStatisticsDocumentCollection(document);
+
         CleanupDocumentCollection(collection, document);
       }
 
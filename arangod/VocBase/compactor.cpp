@@ -496,16 +496,18 @@ static bool Compactifier (TRI_df_marker_t const* marker,
     TRI_ASSERT(((TRI_df_marker_t*) found2->getDataPtr())->_size > 0);  // ONLY in COMPACTIFIER, PROTECTED by fake trx outside
 
     // the fid might change
-    if (found->_fid != context->_compactor->_fid) {
+    TRI_voc_fid_t const foundFid = document->_headersPtr->fid(found);
+
+    if (foundFid != context->_compactor->_fid) {
       // update old datafile's info
-      TRI_doc_datafile_info_t* dfi = TRI_FindDatafileInfoDocumentCollection(document, found->_fid, false);
+      TRI_doc_datafile_info_t* dfi = TRI_FindDatafileInfoDocumentCollection(document, foundFid, false);
 
       if (dfi != nullptr) {
         dfi->_numberDead += 1;
         dfi->_sizeDead += AlignedSize(marker);
       }
 
-      found2->_fid = context->_compactor->_fid;
+      document->_headersPtr->setFid(found2, context->_compactor->_fid);
     }
 
     // let marker point to the new position
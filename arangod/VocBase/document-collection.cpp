@@ -33,6 +33,7 @@
 #include "Basics/conversions.h"
 #include "Basics/files.h"
 #include "Basics/logging.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/tri-strings.h"
 #include "Basics/ThreadPool.h"
 #include "Basics/Exceptions.h"
@@ -44,7 +45,7 @@
 #include "ShapedJson/shape-accessor.h"
 #include "Utils/transactions.h"
 #include "Utils/CollectionReadLocker.h"
-#include "Utils/CollectionWriteLocker.h"
+#include "Utils/DocumentWriteLocker.h"
 #include "VocBase/edge-collection.h"
 #include "VocBase/index.h"
 #include "VocBase/key-generator.h"
@@ -110,7 +111,10 @@ void TRI_doc_mptr_copy_t::setDataPtr (void const* d) {
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_document_collection_t::TRI_document_collection_t () 
-  : _useSecondaryIndexes(true),
+  : _groupReaders(0),
+    _groupWaitingReaders(0),
+    _groupWriters(0),
+    _useSecondaryIndexes(true),
     _keyGenerator(nullptr),
     _uncollectedLogfileEntries(0) {
 
@@ -242,6 +246,8 @@ static inline void SetRevision (TRI_document_collection_t* document,
                                 bool force) {
   TRI_col_info_t* info = &document->_info;
 
+  MUTEX_LOCKER(document->_revisionLock);
+
   if (force || rid > info->_revision) {
     info->_revision = rid;
   }
@@ -279,7 +285,11 @@ static int InsertPrimaryIndex (TRI_document_collection_t* document,
   TRI_ASSERT(header->getDataPtr() != nullptr);  // ONLY IN INDEX, PROTECTED by RUNTIME
 
   // insert into primary index
-  int res = TRI_InsertKeyPrimaryIndex(&document->_primaryIndex, header, (void const**) &found);
+  int res;
+  {
+    MUTEX_LOCKER(document->_primaryIndexLock);
+    res = TRI_InsertKeyPrimaryIndex(&document->_primaryIndex, header, (void const**) &found);
+  }
 
   if (res != TRI_ERROR_NO_ERROR) {
     return res;
@@ -321,7 +331,11 @@ static int InsertSecondaryIndexes (TRI_document_collection_t* document,
   // we can start at index #1 here (index #0 is the primary index)
   for (size_t i = 1;  i < n;  ++i) {
     TRI_index_t* idx = static_cast<TRI_index_t*>(document->_allIndexes._buffer[i]);
-    int res = idx->insert(idx, header, isRollback);
+    int res;
+    {
+      MUTEX_LOCKER(document->_indexLocks[i % TRI_DOCUMENT_INDEX_LOCKS]);
+      res = idx->insert(idx, header, isRollback);
+    }
 
     // in case of no-memory, return immediately
     if (res == TRI_ERROR_OUT_OF_MEMORY) {
@@ -350,7 +364,11 @@ static int DeletePrimaryIndex (TRI_document_collection_t* document,
     return TRI_ERROR_DEBUG;
   }
 
-  TRI_doc_mptr_t* found = static_cast<TRI_doc_mptr_t*>(TRI_RemoveKeyPrimaryIndex(&document->_primaryIndex, TRI_EXTRACT_MARKER_KEY(header))); // ONLY IN INDEX, PROTECTED by RUNTIME
+  TRI_doc_mptr_t* found;
+  {
+    MUTEX_LOCKER(document->_primaryIndexLock);
+    found = static_cast<TRI_doc_mptr_t*>(TRI_RemoveKeyPrimaryIndex(&document->_primaryIndex, TRI_EXTRACT_MARKER_KEY(header))); // ONLY IN INDEX, PROTECTED by RUNTIME
+  }
 
   if (found == nullptr) {
     return TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND;
@@ -380,7 +398,11 @@ static int DeleteSecondaryIndexes (TRI_document_collection_t* document,
   // we can start at index #1 here (index #0 is the primary index)
   for (size_t i = 1;  i < n;  ++i) {
     TRI_index_t* idx = static_cast<TRI_index_t*>(document->_allIndexes._buffer[i]);
-    int res = idx->remove(idx, header, isRollback);
+    int res;
+    {
+      MUTEX_LOCKER(document->_indexLocks[i % TRI_DOCUMENT_INDEX_LOCKS]);
+      res = idx->remove(idx, header, isRollback);
+    }
 
     if (res != TRI_ERROR_NO_ERROR) {
       // an error occurred
@@ -410,7 +432,7 @@ static int CreateHeader (TRI_document_collection_t* document,
   }
 
   header->_rid     = marker->_rid;
-  header->_fid     = fid;
+  document->_headersPtr->setFid(header, fid);
   header->setDataPtr(marker);  // ONLY IN OPENITERATOR
   header->_hash    = TRI_HashKeyPrimaryIndex(TRI_EXTRACT_MARKER_KEY(header));  // ONLY IN OPENITERATOR, PROTECTED by RUNTIME
   *result = header;
@@ -430,7 +452,8 @@ static int CreateHeader (TRI_document_collection_t* document,
 /// @brief updates an existing header
 ////////////////////////////////////////////////////////////////////////////////
 
-static void UpdateHeader (TRI_voc_fid_t fid,
+static void UpdateHeader (TRI_document_collection_t* document,
+                          TRI_voc_fid_t fid,
                           TRI_df_marker_t const* m,
                           TRI_doc_mptr_t* newHeader,
                           TRI_doc_mptr_t const* oldHeader) {
@@ -442,7 +465,7 @@ static void UpdateHeader (TRI_voc_fid_t fid,
   TRI_ASSERT(m->_size > 0);
 
   newHeader->_rid     = marker->_rid;
-  newHeader->_fid     = fid;
+  document->_headersPtr->setFid(newHeader, fid);
   newHeader->setDataPtr(marker);  // ONLY IN OPENITERATOR
 }
 
@@ -655,7 +678,10 @@ static int LookupDocument (TRI_document_collection_t* document,
                            TRI_voc_key_t key,
                            TRI_doc_update_policy_t const* policy,
                            TRI_doc_mptr_t*& header) {
-  header = static_cast<TRI_doc_mptr_t*>(TRI_LookupByKeyPrimaryIndex(&document->_primaryIndex, key));
+  {
+    MUTEX_LOCKER(document->_primaryIndexLock);
+    header = static_cast<TRI_doc_mptr_t*>(TRI_LookupByKeyPrimaryIndex(&document->_primaryIndex, key));
+  }
 
   if (header == nullptr) {
     return TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND;
@@ -705,8 +731,10 @@ static int UpdateDocument (TRI_transaction_collection_t* trxCollection,
   TRI_doc_mptr_t* newHeader = oldHeader;
 
   // update the header. this will modify oldHeader, too !!!
-  newHeader->_rid = operation.rid;
-  newHeader->setDataPtr(operation.marker->mem());  // PROTECTED by trx in trxCollection
+  TRI_doc_mptr_copy_t newData = oldData;
+  newData._rid = operation.rid;
+  newData.setDataPtr(operation.marker->mem());
+  TRI_CopyHeaderDocumentCollection(document, newHeader, newData);  // PROTECTED by trx in trxCollection
 
   // insert new document into secondary indexes
   res = InsertSecondaryIndexes(document, newHeader, false);
@@ -716,7 +744,7 @@ static int UpdateDocument (TRI_transaction_collection_t* trxCollection,
     DeleteSecondaryIndexes(document, newHeader, true);
 
     // copy back old header data
-    oldHeader->copy(oldData);
+    TRI_CopyHeaderDocumentCollection(document, oldHeader, oldData);
 
     InsertSecondaryIndexes(document, oldHeader, true);
 
@@ -857,6 +885,155 @@ static int CloneMarkerNoLegend (triagens::wal::Marker*& marker,
   return TRI_ERROR_INTERNAL;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enters the group of readers of a collection
+///
+/// the caller must hold _lock in read mode. waits until there are no
+/// concurrent writers, for at most timeout µseconds unless timeout is 0.
+/// returns whether the group was entered
+////////////////////////////////////////////////////////////////////////////////
+
+static bool EnterReaders (TRI_document_collection_t* document,
+                          uint64_t timeout) {
+  bool entered = true;
+
+  TRI_LockCondition(&document->_groupCondition);
+
+  if (document->_groupWriters > 0) {
+    ++document->_groupWaitingReaders;
+
+    while (document->_groupWriters > 0) {
+      if (timeout == 0) {
+        TRI_WaitCondition(&document->_groupCondition);
+      }
+      else if (! TRI_TimedWaitCondition(&document->_groupCondition, timeout)) {
+        entered = (document->_groupWriters == 0);
+        break;
+      }
+    }
+
+    --document->_groupWaitingReaders;
+
+    if (! entered) {
+      // writers might wait for us to give up
+      TRI_BroadcastCondition(&document->_groupCondition);
+    }
+  }
+
+  if (entered) {
+    ++document->_groupReaders;
+  }
+
+  TRI_UnlockCondition(&document->_groupCondition);
+
+  return entered;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enters the group of readers of a collection if there are no
+/// concurrent writers
+////////////////////////////////////////////////////////////////////////////////
+
+static bool TryEnterReaders (TRI_document_collection_t* document) {
+  bool entered = false;
+
+  TRI_LockCondition(&document->_groupCondition);
+
+  if (document->_groupWriters == 0) {
+    ++document->_groupReaders;
+    entered = true;
+  }
+
+  TRI_UnlockCondition(&document->_groupCondition);
+
+  return entered;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief leaves the group of readers of a collection
+////////////////////////////////////////////////////////////////////////////////
+
+static void LeaveReaders (TRI_document_collection_t* document) {
+  TRI_LockCondition(&document->_groupCondition);
+
+  TRI_ASSERT(document->_groupReaders > 0);
+
+  if (--document->_groupReaders == 0) {
+    TRI_BroadcastCondition(&document->_groupCondition);
+  }
+
+  TRI_UnlockCondition(&document->_groupCondition);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enters the group of concurrent writers of a collection
+///
+/// the caller must hold _lock in read mode. waits until there are neither
+/// active nor waiting readers, so that writers cannot starve readers
+////////////////////////////////////////////////////////////////////////////////
+
+static void EnterWriters (TRI_document_collection_t* document) {
+  TRI_LockCondition(&document->_groupCondition);
+
+  while (document->_groupReaders > 0 || document->_groupWaitingReaders > 0) {
+    TRI_WaitCondition(&document->_groupCondition);
+  }
+
+  ++document->_groupWriters;
+
+  TRI_UnlockCondition(&document->_groupCondition);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief leaves the group of concurrent writers of a collection
+////////////////////////////////////////////////////////////////////////////////
+
+static void LeaveWriters (TRI_document_collection_t* document) {
+  TRI_LockCondition(&document->_groupCondition);
+
+  TRI_ASSERT(document->_groupWriters > 0);
+
+  if (--document->_groupWriters == 0) {
+    TRI_BroadcastCondition(&document->_groupCondition);
+  }
+
+  TRI_UnlockCondition(&document->_groupCondition);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not single-document writes into a collection may run
+/// concurrently
+///
+/// a failed write re-inserts the old values of its document into the
+/// indexes, which fails for a unique index if a concurrent writer has taken
+/// the value meanwhile. post-insert hooks, such as the one of the cap
+/// constraint, modify other documents
+////////////////////////////////////////////////////////////////////////////////
+
+static bool AllowsConcurrentWrites (TRI_document_collection_t const* document) {
+  size_t const n = document->_allIndexes._length;
+
+  // we can start at index #1 here (index #0 is the primary index)
+  for (size_t i = 1;  i < n;  ++i) {
+    TRI_index_t const* idx = static_cast<TRI_index_t const*>(document->_allIndexes._buffer[i]);
+
+    if (idx->_unique || idx->postInsert != nullptr) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the lock for a document key
+////////////////////////////////////////////////////////////////////////////////
+
+static inline triagens::basics::Mutex& KeyLock (TRI_document_collection_t* document,
+                                                char const* key) {
+  return document->_keyLocks[TRI_HashKeyPrimaryIndex(key) % TRI_DOCUMENT_KEY_LOCKS];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read locks a collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -950,8 +1127,7 @@ static int EndWrite (TRI_document_collection_t* document) {
 ////////////////////////////////////////////////////////////////////////////////
 
 static int BeginReadTimed (TRI_document_collection_t* document,
-                           uint64_t timeout,
-                           uint64_t sleepPeriod) {
+                           uint64_t timeout) {
   if (triagens::arango::Transaction::_makeNolockHeaders != nullptr) {
     std::string collName(document->_info._name);
     auto it = triagens::arango::Transaction::_makeNolockHeaders->find(collName);
@@ -962,22 +1138,13 @@ static int BeginReadTimed (TRI_document_collection_t* document,
       return TRI_ERROR_NO_ERROR;
     }
   }
-  uint64_t waited = 0;
 
   // LOCKING-DEBUG
   // std::cout << "BeginReadTimed: " << document->_info._name << std::endl;
-  while (! TRI_TRY_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document)) {
-#ifdef _WIN32
-    usleep((unsigned long) sleepPeriod);
-#else
-    usleep((useconds_t) sleepPeriod);
-#endif
-
-    waited += sleepPeriod;
 
-    if (waited > timeout) {
-      return TRI_ERROR_LOCK_TIMEOUT;
-    }
+  // the waiting thread is woken up as soon as the lock is released
+  if (! TRI_TIMED_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document, timeout)) {
+    return TRI_ERROR_LOCK_TIMEOUT;
   }
 
   return TRI_ERROR_NO_ERROR;
@@ -988,8 +1155,7 @@ static int BeginReadTimed (TRI_document_collection_t* document,
 ////////////////////////////////////////////////////////////////////////////////
 
 static int BeginWriteTimed (TRI_document_collection_t* document,
-                            uint64_t timeout,
-                            uint64_t sleepPeriod) {
+                            uint64_t timeout) {
   if (triagens::arango::Transaction::_makeNolockHeaders != nullptr) {
     std::string collName(document->_info._name);
     auto it = triagens::arango::Transaction::_makeNolockHeaders->find(collName);
@@ -1000,22 +1166,12 @@ static int BeginWriteTimed (TRI_document_collection_t* document,
       return TRI_ERROR_NO_ERROR;
     }
   }
-  uint64_t waited = 0;
 
   // LOCKING-DEBUG
   // std::cout << "BeginWriteTimed: " << document->_info._name << std::endl;
-  while (! TRI_TRY_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document)) {
-#ifdef _WIN32
-    usleep((unsigned long) sleepPeriod);
-#else
-    usleep((useconds_t) sleepPeriod);
-#endif
 
-    waited += sleepPeriod;
-
-    if (waited > timeout) {
-      return TRI_ERROR_LOCK_TIMEOUT;
-    }
+  if (! TRI_TIMED_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document, timeout)) {
+    return TRI_ERROR_LOCK_TIMEOUT;
   }
 
   return TRI_ERROR_NO_ERROR;
@@ -1211,23 +1367,25 @@ static int OpenIteratorApplyInsert (open_iterator_state_t* state,
 
   // it is an update, but only if found has a smaller revision identifier
   else if (found->_rid < d->_rid ||
-           (found->_rid == d->_rid && found->_fid <= operation->_fid)) {
+           (found->_rid == d->_rid && document->_headersPtr->fid(found) <= operation->_fid)) {
     // save the old data
     TRI_doc_mptr_copy_t oldData = *found;
 
     TRI_doc_mptr_t* newHeader = static_cast<TRI_doc_mptr_t*>(CONST_CAST(found));
 
     // update the header info
-    UpdateHeader(operation->_fid, marker, newHeader, found);
+    UpdateHeader(document, operation->_fid, marker, newHeader, found);
     document->_headersPtr->moveBack(newHeader, &oldData);  // ONLY IN OPENITERATOR
 
     // update the datafile info
     TRI_doc_datafile_info_t* dfi;
-    if (oldData._fid == state->_fid) {
+    TRI_voc_fid_t const oldFid = document->_headersPtr->fid(&oldData);
+
+    if (oldFid == state->_fid) {
       dfi = state->_dfi;
     }
     else {
-      dfi = TRI_FindDatafileInfoDocumentCollection(document, oldData._fid, true);
+      dfi = TRI_FindDatafileInfoDocumentCollection(document, oldFid, true);
     }
 
     if (dfi != nullptr && found->getDataPtr() != nullptr) {  // ONLY IN OPENITERATOR, PROTECTED by RUNTIME
@@ -1317,11 +1475,13 @@ static int OpenIteratorApplyRemove (open_iterator_state_t* state,
     TRI_doc_datafile_info_t* dfi;
 
     // update the datafile info
-    if (found->_fid == state->_fid) {
+    TRI_voc_fid_t const foundFid = document->_headersPtr->fid(found);
+
+    if (foundFid == state->_fid) {
       dfi = state->_dfi;
     }
     else {
-      dfi = TRI_FindDatafileInfoDocumentCollection(document, found->_fid, true);
+      dfi = TRI_FindDatafileInfoDocumentCollection(document, foundFid, true);
     }
 
     if (dfi != nullptr) {
@@ -1922,6 +2082,10 @@ static TRI_doc_collection_info_t* Figures (TRI_document_collection_t* document)
     info->_numberIndexes++;
   }
 
+  // add master pointer information
+  info->_numberMasterPointers = (TRI_voc_ssize_t) document->_headersPtr->allocated();
+  info->_sizeMasterPointers   = (int64_t) document->_headersPtr->memory();
+
   // get information about shape files (DEPRECATED, thus hard-coded to 0)
   info->_shapefileSize    = 0;
   info->_numberShapefiles = 0;
@@ -1970,6 +2134,7 @@ static int InitBaseDocumentCollection (TRI_document_collection_t* document,
   TRI_InitBarrierList(&document->_barrierList, document);
 
   TRI_InitReadWriteLock(&document->_lock);
+  TRI_InitCondition(&document->_groupCondition);
   TRI_InitReadWriteLock(&document->_compactionLock);
 
   return TRI_ERROR_NO_ERROR;
@@ -1986,6 +2151,7 @@ static void DestroyBaseDocumentCollection (TRI_document_collection_t* document)
   }
 
   TRI_DestroyReadWriteLock(&document->_compactionLock);
+  TRI_DestroyCondition(&document->_groupCondition);
   TRI_DestroyReadWriteLock(&document->_lock);
 
   TRI_DestroyPrimaryIndex(&document->_primaryIndex);
@@ -2695,20 +2861,13 @@ int TRI_RollbackOperationDocumentCollection (TRI_document_collection_t* document
     return TRI_ERROR_NO_ERROR;
   }
   else if (type == TRI_VOC_DOCUMENT_OPERATION_UPDATE) {
-    // copy the existing header's state
-    TRI_doc_mptr_copy_t copy = *header;
-    
     // remove the current values from the indexes
     DeleteSecondaryIndexes(document, header, true);
-    // revert to the old state
-    header->copy(*oldData);
+    // revert to the old state. the header is not changed again after it
+    // is back in the secondary indexes, where concurrent writers use it
+    TRI_CopyHeaderDocumentCollection(document, header, *oldData);
     // re-insert old state
-    int res = InsertSecondaryIndexes(document, header, true);
-    // revert again to the new state, because other parts of the new state
-    // will be reverted at some other place
-    header->copy(copy);
-    
-    return res;
+    return InsertSecondaryIndexes(document, header, true);
   }
   else if (type == TRI_VOC_DOCUMENT_OPERATION_REMOVE) {
     int res = InsertPrimaryIndex(document, header, true);
@@ -3119,6 +3278,26 @@ static int FillIndex (TRI_document_collection_t* document,
     idx->sizeHint(idx, (size_t) document->_primaryIndex._nrUsed);
   }
 
+  if (idx->batchInsert != nullptr) {
+    // let the index load all documents at once
+    std::vector<TRI_doc_mptr_t const*> documents;
+
+    try {
+      documents.reserve((size_t) document->_primaryIndex._nrUsed);
+
+      for (;  ptr < end;  ++ptr) {
+        if (*ptr != nullptr) {
+          documents.emplace_back(static_cast<TRI_doc_mptr_t const*>(*ptr));
+        }
+      }
+    }
+    catch (...) {
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    return idx->batchInsert(idx, &documents);
+  }
+
 #ifdef TRI_ENABLE_MAINTAINER_MODE
   static const int LoopSize = 10000;
   int counter = 0;
@@ -3382,9 +3561,142 @@ static int ComparePidName (void const* left, void const* right) {
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read locks the documents and indexes
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_ReadLockDocumentCollection (TRI_document_collection_t* document) {
+  TRI_ReadLockReadWriteLock(&document->_lock);
+  EnterReaders(document, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tries to read lock the documents and indexes
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_TryReadLockDocumentCollection (TRI_document_collection_t* document) {
+  if (! TRI_TryReadLockReadWriteLock(&document->_lock)) {
+    return false;
+  }
+
+  if (! TryEnterReaders(document)) {
+    TRI_ReadUnlockReadWriteLock(&document->_lock);
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read locks the documents and indexes, with a timeout (in µseconds)
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_TimedReadLockDocumentCollection (TRI_document_collection_t* document,
+                                          uint64_t timeout) {
+  if (! TRI_TimedReadLockReadWriteLock(&document->_lock, timeout)) {
+    return false;
+  }
+
+  if (! EnterReaders(document, timeout)) {
+    TRI_ReadUnlockReadWriteLock(&document->_lock);
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read unlocks the documents and indexes
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_ReadUnlockDocumentCollection (TRI_document_collection_t* document) {
+  LeaveReaders(document);
+  TRI_ReadUnlockReadWriteLock(&document->_lock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks a collection for a single-document write that may run
+/// concurrently with other writes
+///
+/// only operations of single-operation transactions qualify. operations of
+/// other transactions may be rolled back when their transaction is aborted,
+/// which relinks their headers at list positions that concurrent writers
+/// might have changed. the collection is read-locked, which excludes all
+/// holders of the write lock, and the writer waits until there are no
+/// readers. writes of the same key are serialised by the key lock
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_BeginConcurrentWriteDocumentCollection (TRI_transaction_collection_t* trxCollection,
+                                                 char const* key) {
+  TRI_transaction_t const* trx = trxCollection->_transaction;
+
+  if ((trx->_hints & (TRI_transaction_hint_t) TRI_TRANSACTION_HINT_SINGLE_OPERATION) == 0) {
+    return false;
+  }
+
+  TRI_document_collection_t* document = trxCollection->_collection->_collection;
+
+  if (triagens::arango::Transaction::_makeNolockHeaders != nullptr) {
+    std::string collName(document->_info._name);
+    auto it = triagens::arango::Transaction::_makeNolockHeaders->find(collName);
+    if (it != triagens::arango::Transaction::_makeNolockHeaders->end()) {
+      // do not lock by command
+      return false;
+    }
+  }
+
+  TRI_ReadLockReadWriteLock(&document->_lock);
+
+  if (! AllowsConcurrentWrites(document)) {
+    TRI_ReadUnlockReadWriteLock(&document->_lock);
+    return false;
+  }
+
+  EnterWriters(document);
+  KeyLock(document, key).lock();
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unlocks a collection after a concurrent single-document write
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_EndConcurrentWriteDocumentCollection (TRI_document_collection_t* document,
+                                               char const* key) {
+  KeyLock(document, key).unlock();
+  LeaveWriters(document);
+
+  TRI_ReadUnlockReadWriteLock(&document->_lock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief changes the contents of a header that is in the primary index
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_CopyHeaderDocumentCollection (TRI_document_collection_t* document,
+                                       TRI_doc_mptr_t* header,
+                                       TRI_doc_mptr_t const& contents) {
+  // writers hold at most one of these locks at a time, so taking all of
+  // them in a fixed order cannot deadlock
+  document->_primaryIndexLock.lock();
+
+  for (size_t i = 0;  i < TRI_DOCUMENT_INDEX_LOCKS;  ++i) {
+    document->_indexLocks[i].lock();
+  }
+
+  header->copyContents(contents);
+
+  for (size_t i = TRI_DOCUMENT_INDEX_LOCKS;  i > 0;  --i) {
+    document->_indexLocks[i - 1].unlock();
+  }
+
+  document->_primaryIndexLock.unlock();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief update statistics for a collection
-/// note: the write-lock for the collection must be held to call this
+/// note: the collection must be write-locked or locked for a concurrent write
 ////////////////////////////////////////////////////////////////////////////////
 
 void TRI_UpdateRevisionDocumentCollection (TRI_document_collection_t* document,
@@ -3409,6 +3721,32 @@ bool TRI_IsFullyCollectedDocumentCollection (TRI_document_collection_t* document
   return (uncollected == 0);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recomputes stale value statistics of the indexes of a collection
+///
+/// The indexes are walked under a read lock, which blocks writers. The lock
+/// is only tried, so that the cleanup thread does not queue up behind a long
+/// running write and retries in its next iteration instead.
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_RefreshIndexStatisticsDocumentCollection (TRI_document_collection_t* document) {
+  if (! TRI_TRY_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document)) {
+    return;
+  }
+
+  size_t const n = document->_allIndexes._length;
+
+  for (size_t i = 0; i < n; ++i) {
+    TRI_index_t* idx = static_cast<TRI_index_t*>(document->_allIndexes._buffer[i]);
+
+    if (idx->refreshStatistics != nullptr) {
+      idx->refreshStatistics(idx);
+    }
+  }
+
+  TRI_READ_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief returns a description of all indexes
 ///
@@ -5024,7 +5362,7 @@ int TRI_RemoveShapedJsonDocumentCollection (TRI_transaction_collection_t* trxCol
       return TRI_ERROR_DEBUG;
     }
 
-    triagens::arango::CollectionWriteLocker collectionLocker(document, lock);
+    triagens::arango::DocumentWriteLocker collectionLocker(trxCollection, key, lock);
 
     triagens::wal::DocumentOperation operation(marker, freeMarker, trxCollection, TRI_VOC_DOCUMENT_OPERATION_REMOVE, rid);
 
@@ -5056,7 +5394,7 @@ int TRI_RemoveShapedJsonDocumentCollection (TRI_transaction_collection_t* trxCol
 
     operation.indexed();
 
-    document->_headersPtr->unlink(header);  // PROTECTED by trx in trxCollection
+    // the header is unlinked when the operation is handled
     document->_numberDocuments--;
 
     TRI_IF_FAILURE("RemoveDocumentNoOperation") {
@@ -5133,7 +5471,7 @@ int TRI_InsertShapedJsonDocumentCollection (TRI_transaction_collection_t* trxCol
     keyString = key;
   }
 
-  uint64_t const hash = TRI_HashKeyPrimaryIndex(keyString.c_str(), keyString.size());
+  uint32_t const hash = TRI_HashKeyPrimaryIndex(keyString.c_str(), keyString.size());
 
 
   int res = TRI_ERROR_NO_ERROR;
@@ -5166,7 +5504,7 @@ int TRI_InsertShapedJsonDocumentCollection (TRI_transaction_collection_t* trxCol
       return TRI_ERROR_DEBUG;
     }
 
-    triagens::arango::CollectionWriteLocker collectionLocker(document, lock);
+    triagens::arango::DocumentWriteLocker collectionLocker(trxCollection, keyString.c_str(), lock);
 
     triagens::wal::DocumentOperation operation(marker, freeMarker, trxCollection, TRI_VOC_DOCUMENT_OPERATION_INSERT, rid);
 
@@ -5250,7 +5588,7 @@ int TRI_UpdateShapedJsonDocumentCollection (TRI_transaction_collection_t* trxCol
       return TRI_ERROR_DEBUG;
     }
 
-    triagens::arango::CollectionWriteLocker collectionLocker(document, lock);
+    triagens::arango::DocumentWriteLocker collectionLocker(trxCollection, key, lock);
 
     // get the header pointer of the previous revision
     TRI_doc_mptr_t* oldHeader;
@@ -33,6 +33,7 @@
 
 #include "Basics/Common.h"
 
+#include "Basics/Mutex.h"
 #include "VocBase/barrier.h"
 #include "VocBase/collection.h"
 #include "VocBase/headers.h"
@@ -65,21 +66,28 @@ class KeyGenerator;
 ////////////////////////////////////////////////////////////////////////////////
 
 #define TRI_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
-  TRI_ReadLockReadWriteLock(&(a)->_lock)
+  TRI_ReadLockDocumentCollection(a)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief tries to read lock the documents and indexes
 ////////////////////////////////////////////////////////////////////////////////
 
 #define TRI_TRY_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
-  TRI_TryReadLockReadWriteLock(&(a)->_lock)
+  TRI_TryReadLockDocumentCollection(a)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read locks the documents and indexes, with a timeout
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_TIMED_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a, b) \
+  TRI_TimedReadLockDocumentCollection((a), (b))
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read unlocks the documents and indexes
 ////////////////////////////////////////////////////////////////////////////////
 
 #define TRI_READ_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
-  TRI_ReadUnlockReadWriteLock(&(a)->_lock)
+  TRI_ReadUnlockDocumentCollection(a)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write locks the documents and indexes
@@ -95,6 +103,13 @@ class KeyGenerator;
 #define TRI_TRY_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
   TRI_TryWriteLockReadWriteLock(&(a)->_lock)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write locks the documents and indexes, with a timeout
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_TIMED_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a, b) \
+  TRI_TimedWriteLockReadWriteLock(&(a)->_lock, (b))
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write unlocks the documents and indexes
 ////////////////////////////////////////////////////////////////////////////////
@@ -108,12 +123,17 @@ class KeyGenerator;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief master pointer
+///
+/// there is one master pointer per live document, so its size matters. The
+/// struct only has virtual methods in maintainer mode, where the accessors
+/// for the data pointer check for a running transaction. Otherwise it has no
+/// vtable and is trivially destructible
 ////////////////////////////////////////////////////////////////////////////////
 
 struct TRI_doc_mptr_t {
     TRI_voc_rid_t          _rid;     // this is the revision identifier
-    TRI_voc_fid_t          _fid;     // this is the datafile identifier
-    uint64_t               _hash;    // the pre-calculated hash value of the key
+    uint32_t               _fidNumber; // number of the datafile, see TRI_headers_t::fid
+    uint32_t               _hash;    // the pre-calculated hash value of the key
     TRI_doc_mptr_t*        _prev;    // previous master pointer
     TRI_doc_mptr_t*        _next;    // next master pointer
   protected:
@@ -121,19 +141,21 @@ struct TRI_doc_mptr_t {
 
   public:
     TRI_doc_mptr_t () : _rid(0), 
-                        _fid(0), 
+                        _fidNumber(0),
                         _hash(0),
                         _prev(nullptr),
                         _next(nullptr),
                         _dataptr(nullptr) {
     }
 
+#ifdef TRI_ENABLE_MAINTAINER_MODE
     virtual ~TRI_doc_mptr_t () {
     }
+#endif
 
     void clear () {
       _rid = 0;
-      _fid = 0;
+      _fidNumber = 0;
       setDataPtr(nullptr);
       _hash = 0;
       _prev = nullptr;
@@ -143,13 +165,23 @@ struct TRI_doc_mptr_t {
     void copy (TRI_doc_mptr_t const& that) {
       // This is for cases where we explicitly have to copy originals!
       _rid = that._rid;
-      _fid = that._fid;
+      _fidNumber = that._fidNumber;
       _dataptr = that._dataptr;
       _hash = that._hash;
       _prev = that._prev;
       _next = that._next;
     }
 
+    void copyContents (TRI_doc_mptr_t const& that) {
+      // This is for restoring a header that is still linked into the list of
+      // headers. Its list pointers might have been changed by concurrent
+      // writers since "that" was copied, so they are kept
+      _rid = that._rid;
+      _fidNumber = that._fidNumber;
+      _dataptr = that._dataptr;
+      _hash = that._hash;
+    }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return a pointer to the beginning of the marker
 ////////////////////////////////////////////////////////////////////////////////
@@ -297,6 +329,7 @@ typedef struct TRI_doc_collection_info_s {
   TRI_voc_ssize_t _numberAttributes;
   TRI_voc_ssize_t _numberTransactions;
   TRI_voc_ssize_t _numberIndexes;
+  TRI_voc_ssize_t _numberMasterPointers;
 
   int64_t         _sizeAlive;
   int64_t         _sizeDead;
@@ -304,6 +337,7 @@ typedef struct TRI_doc_collection_info_s {
   int64_t         _sizeAttributes;
   int64_t         _sizeTransactions;
   int64_t         _sizeIndexes;
+  int64_t         _sizeMasterPointers;
 
   int64_t         _datafileSize;
   int64_t         _journalfileSize;
@@ -315,11 +349,27 @@ typedef struct TRI_doc_collection_info_s {
 }
 TRI_doc_collection_info_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of key locks of a document collection
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_DOCUMENT_KEY_LOCKS (64)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of secondary index locks of a document collection
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_DOCUMENT_INDEX_LOCKS (8)
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief document collection with global read-write lock
 ///
 /// A document collection is a collection with a single read-write lock. This
 /// lock is used to coordinate the read and write transactions.
+///
+/// Single-document writes of single-operation transactions only read-lock it
+/// when the collection allows it, see TRI_BeginConcurrentWriteDocumentCollection.
+/// They run concurrently with each other, but not with readers.
 ////////////////////////////////////////////////////////////////////////////////
 
 struct TRI_document_collection_t : public TRI_collection_t {
@@ -330,6 +380,30 @@ struct TRI_document_collection_t : public TRI_collection_t {
 
   TRI_read_write_lock_t        _lock;
 
+  // ...........................................................................
+  // readers and concurrent writers both hold _lock in read mode. readers
+  // additionally count themselves here, so that the two groups exclude each
+  // other. a reader only waits for active writers, so nested read locks of
+  // a thread never block. a writer also waits for waiting readers
+  // ...........................................................................
+
+  TRI_condition_t              _groupCondition;
+  int64_t                      _groupReaders;
+  int64_t                      _groupWaitingReaders;
+  int64_t                      _groupWriters;
+
+  // ...........................................................................
+  // concurrent writers lock the key of their document, and serialise their
+  // changes of the primary index, of each secondary index (index i uses
+  // lock i % TRI_DOCUMENT_INDEX_LOCKS) and of the collection revision.
+  // the headers have their own lock
+  // ...........................................................................
+
+  triagens::basics::Mutex      _keyLocks[TRI_DOCUMENT_KEY_LOCKS];
+  triagens::basics::Mutex      _primaryIndexLock;
+  triagens::basics::Mutex      _indexLocks[TRI_DOCUMENT_INDEX_LOCKS];
+  triagens::basics::Mutex      _revisionLock;
+
 private:
   TRI_shaper_t*                _shaper;
 
@@ -370,7 +444,7 @@ public:
   std::set<TRI_voc_tid_t>*     _failedTransactions;
 
   std::atomic<int64_t>         _uncollectedLogfileEntries;
-  int64_t                      _numberDocuments;
+  std::atomic<int64_t>         _numberDocuments;
   TRI_read_write_lock_t        _compactionLock;
   double                       _lastCompaction;
 
@@ -392,8 +466,8 @@ public:
   int (*beginWrite) (struct TRI_document_collection_t*);
   int (*endWrite) (struct TRI_document_collection_t*);
 
-  int (*beginReadTimed) (struct TRI_document_collection_t*, uint64_t, uint64_t);
-  int (*beginWriteTimed) (struct TRI_document_collection_t*, uint64_t, uint64_t);
+  int (*beginReadTimed) (struct TRI_document_collection_t*, uint64_t);
+  int (*beginWriteTimed) (struct TRI_document_collection_t*, uint64_t);
 
 #ifdef TRI_ENABLE_MAINTAINER_MODE
   void (*dump) (struct TRI_document_collection_t*);
@@ -459,26 +533,26 @@ size_t TRI_DocumentIteratorDocumentCollection (triagens::arango::TransactionBase
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief tries to read lock the journal files and the parameter file
 ///
-/// note: the return value of the call to TRI_TryReadLockReadWriteLock is
+/// note: the return value of the call to TRI_TryReadLockDocumentCollection
 /// is checked so we cannot add logging here
 ////////////////////////////////////////////////////////////////////////////////
 
 #define TRI_TRY_READ_LOCK_DATAFILES_DOC_COLLECTION(a) \
-  TRI_TryReadLockReadWriteLock(&(a)->_lock)
+  TRI_TryReadLockDocumentCollection(a)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read locks the journal files and the parameter file
 ////////////////////////////////////////////////////////////////////////////////
 
 #define TRI_READ_LOCK_DATAFILES_DOC_COLLECTION(a) \
-  TRI_ReadLockReadWriteLock(&(a)->_lock)
+  TRI_ReadLockDocumentCollection(a)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read unlocks the journal files and the parameter file
 ////////////////////////////////////////////////////////////////////////////////
 
 #define TRI_READ_UNLOCK_DATAFILES_DOC_COLLECTION(a) \
-  TRI_ReadUnlockReadWriteLock(&(a)->_lock)
+  TRI_ReadUnlockDocumentCollection(a)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write locks the journal files and the parameter file
@@ -686,9 +760,64 @@ void TRI_FreeDocumentCollection (TRI_document_collection_t*);
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read locks the documents and indexes
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_ReadLockDocumentCollection (TRI_document_collection_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tries to read lock the documents and indexes
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_TryReadLockDocumentCollection (TRI_document_collection_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read locks the documents and indexes, with a timeout (in µseconds)
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_TimedReadLockDocumentCollection (TRI_document_collection_t*,
+                                          uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read unlocks the documents and indexes
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_ReadUnlockDocumentCollection (TRI_document_collection_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks a collection for a single-document write that may run
+/// concurrently with other writes
+///
+/// returns false if the write must write-lock the collection instead
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_BeginConcurrentWriteDocumentCollection (struct TRI_transaction_collection_s*,
+                                                 char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unlocks a collection after a concurrent single-document write
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_EndConcurrentWriteDocumentCollection (TRI_document_collection_t*,
+                                               char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief changes the contents of a header that is in the primary index
+///
+/// concurrent writers read the markers of other documents in the indexes, so
+/// the contents are only changed while all index locks are held. a writer
+/// that has read the old data pointer is done with it afterwards, and the old
+/// marker can be freed
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_CopyHeaderDocumentCollection (TRI_document_collection_t*,
+                                       TRI_doc_mptr_t*,
+                                       TRI_doc_mptr_t const&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief update statistics for a collection
-/// note: the write-lock for the collection must be held to call this
+/// note: the collection must be write-locked or locked for a concurrent write
 ////////////////////////////////////////////////////////////////////////////////
 
 void TRI_UpdateRevisionDocumentCollection (TRI_document_collection_t*,
@@ -701,6 +830,12 @@ void TRI_UpdateRevisionDocumentCollection (TRI_document_collection_t*,
 
 bool TRI_IsFullyCollectedDocumentCollection (TRI_document_collection_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recomputes stale value statistics of the indexes of a collection
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_RefreshIndexStatisticsDocumentCollection (TRI_document_collection_t*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create an index, based on a JSON description
 ////////////////////////////////////////////////////////////////////////////////
@@ -30,6 +30,7 @@
 #include "headers.h"
 
 #include "Basics/logging.h"
+#include "Basics/MutexLocker.h"
 #include "VocBase/document-collection.h"
 
 // -----------------------------------------------------------------------------
@@ -37,27 +38,28 @@
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief get the size (number of entries) for a block, based on a function
+/// @brief get the size (number of entries) for a slab, based on a function
 ///
-/// this adaptively increases the number of entries per block until a certain
+/// this adaptively increases the number of entries per slab until a certain
 /// threshold. the benefit of this is that small collections (with few
 /// documents) only use little memory whereas bigger collections allocate new
-/// blocks in bigger chunks.
-/// the lowest value for the number of entries in a block is BLOCK_SIZE_UNIT,
-/// the highest value is BLOCK_SIZE_UNIT << 8.
+/// slabs in bigger chunks.
+/// the lowest value for the number of entries in a slab is SLAB_SIZE_UNIT,
+/// the highest value is SLAB_SIZE_UNIT << 5.
 ////////////////////////////////////////////////////////////////////////////////
 
-static inline size_t GetBlockSize (size_t blockNumber) {
-  static size_t const BLOCK_SIZE_UNIT = 128;
+static inline size_t GetSlabSize (size_t slabNumber) {
+  static size_t const SLAB_SIZE_UNIT = 128;
 
-  if (blockNumber < 8) {
-    // use a small block size in the beginning to save memory
-    return (size_t) (BLOCK_SIZE_UNIT << blockNumber);
+  if (slabNumber < 5) {
+    // use a small slab size in the beginning to save memory
+    return (size_t) (SLAB_SIZE_UNIT << slabNumber);
   }
 
-  // use a block size of 32768
-  // this will use 32768 * sizeof(TRI_doc_mptr_t) bytes, i.e. 1.5 MB
-  return (size_t) (BLOCK_SIZE_UNIT << 8);
+  // use a slab size of 4096
+  // this will use 4096 * sizeof(TRI_doc_mptr_t) bytes, i.e. 160 KB. slabs
+  // are freed individually, so they are kept smaller than blocks used to be
+  return (size_t) (SLAB_SIZE_UNIT << 5);
 }
 
 // -----------------------------------------------------------------------------
@@ -69,14 +71,20 @@ static inline size_t GetBlockSize (size_t blockNumber) {
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_headers_t::TRI_headers_t ()
-  : _freelist(nullptr),
-    _begin(nullptr),
+  : _begin(nullptr),
     _end(nullptr),
     _nrAllocated(0),
     _nrLinked(0),
-    _totalSize(0) {
-
-  TRI_InitVectorPointer2(&_blocks, TRI_UNKNOWN_MEM_ZONE, 16);
+    _totalSize(0),
+    _memory(0),
+    _slabs(),
+    _partial(),
+    _fids(),
+    _fidNumbers(),
+    _lastNumber(0) {
+
+  // number 0 is used by headers without a datafile
+  _fids.push_back(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -84,11 +92,10 @@ TRI_headers_t::TRI_headers_t ()
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_headers_t::~TRI_headers_t () {
-  for (size_t i = 0;  i < _blocks._length;  ++i) {
-    delete[] static_cast<TRI_doc_mptr_t*>(_blocks._buffer[i]);
+  for (auto slab : _slabs) {
+    delete[] slab->_begin;
+    delete slab;
   }
-
-  TRI_DestroyVectorPointer(&_blocks);
 }
 
 // -----------------------------------------------------------------------------
@@ -106,6 +113,8 @@ void TRI_headers_t::moveBack (TRI_doc_mptr_t* header,
     return;
   }
 
+  MUTEX_LOCKER(_lock);
+
   TRI_ASSERT(_nrAllocated > 0);
   TRI_ASSERT(_nrLinked > 0);
   TRI_ASSERT(_totalSize > 0);
@@ -165,6 +174,238 @@ void TRI_headers_t::moveBack (TRI_doc_mptr_t* header,
 ////////////////////////////////////////////////////////////////////////////////
 
 void TRI_headers_t::unlink (TRI_doc_mptr_t* header) {
+  MUTEX_LOCKER(_lock);
+
+  unlinkHeader(header);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves a header around in the list, using its previous position
+/// (specified in "old"), note that this is only used in revert operations
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_headers_t::move (TRI_doc_mptr_t* header,
+                          TRI_doc_mptr_t* old) {
+  if (header == nullptr) {
+    return;
+  }
+
+  MUTEX_LOCKER(_lock);
+
+  moveHeader(header, old);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves a header back into the list, using its previous position
+/// (specified in "old")
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_headers_t::relink (TRI_doc_mptr_t* header,
+                            TRI_doc_mptr_t* old) {
+  if (header == nullptr) {
+    return;
+  }
+
+  TRI_ASSERT(header->getDataPtr() != nullptr); // ONLY IN HEADERS, PROTECTED by RUNTIME
+
+  int64_t size = (int64_t) ((TRI_df_marker_t*) header->getDataPtr())->_size; // ONLY IN HEADERS, PROTECTED by RUNTIME
+  TRI_ASSERT(size > 0);
+
+  MUTEX_LOCKER(_lock);
+
+  TRI_ASSERT(_begin != header);
+  TRI_ASSERT(_end != header);
+
+  moveHeader(header, old);
+  _nrLinked++;
+  _totalSize += TRI_DF_ALIGN_BLOCK(size);
+  TRI_ASSERT(_totalSize > 0);
+
+  TRI_ASSERT(header->_prev != header);
+  TRI_ASSERT(header->_next != header);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief requests a new header
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_doc_mptr_t* TRI_headers_t::request (size_t size) {
+  TRI_ASSERT(size > 0);
+
+  MUTEX_LOCKER(_lock);
+
+  if (_partial.empty() && ! allocateSlab()) {
+    // out of memory
+    TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+    return nullptr;
+  }
+
+  // take the header from the slab with the lowest address, so that the
+  // headers in use are packed into as few slabs as possible
+  slab_t* slab = *_partial.begin();
+  TRI_ASSERT(slab->_freelist != nullptr);
+
+  TRI_doc_mptr_t* result = const_cast<TRI_doc_mptr_t*>(slab->_freelist);
+
+  slab->_freelist = static_cast<TRI_doc_mptr_t const*>(result->getDataPtr()); // ONLY IN HEADERS, PROTECTED by RUNTIME
+  result->setDataPtr(nullptr); // ONLY IN HEADERS
+
+  if (++slab->_used == slab->_size) {
+    _partial.erase(_partial.begin());
+  }
+
+  // put new header at the end of the list
+  if (_begin == nullptr) {
+    // list of headers is empty
+    TRI_ASSERT(_nrLinked == 0);
+    TRI_ASSERT(_totalSize == 0);
+
+    _begin = result;
+    _end   = result;
+
+    result->_prev   = nullptr;
+    result->_next   = nullptr;
+  }
+  else {
+    // list is not empty
+    TRI_ASSERT(_nrLinked > 0);
+    TRI_ASSERT(_totalSize > 0);
+    TRI_ASSERT(_nrAllocated > 0);
+    TRI_ASSERT(_begin != nullptr);
+    TRI_ASSERT(_end != nullptr);
+
+    _end->_next   = result;
+    result->_prev = _end;
+    result->_next = nullptr;
+    _end          = result;
+  }
+
+  _nrAllocated++;
+  _nrLinked++;
+  _totalSize += (int64_t) TRI_DF_ALIGN_BLOCK(size);
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases a header, putting it back onto the freelist
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_headers_t::release (TRI_doc_mptr_t* header,
+                             bool doUnlink) {
+  if (header == nullptr) {
+    return;
+  }
+
+  MUTEX_LOCKER(_lock);
+
+  if (doUnlink) {
+    unlinkHeader(header);
+  }
+
+  header->clear();
+  TRI_ASSERT(_nrAllocated > 0);
+  _nrAllocated--;
+
+  slab_t* slab = findSlab(header);
+  TRI_ASSERT(slab != nullptr);
+  TRI_ASSERT(slab->_used > 0);
+
+  header->setDataPtr(slab->_freelist); // ONLY IN HEADERS
+  slab->_freelist = header;
+
+  if (slab->_used-- == slab->_size) {
+    // the slab has a free header again
+    _partial.insert(slab);
+  }
+
+  if (slab->_used == 0 && _partial.size() > 1) {
+    // another slab has free headers, so this one is not needed anymore.
+    // keeping the last slab with free headers avoids allocating and freeing
+    // a slab over and over again when documents are inserted and removed
+    freeSlab(slab);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adjust the total size of the markers handed out
+/// this is called by the collector
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_headers_t::adjustTotalSize (int64_t oldSize,
+                                     int64_t newSize) {
+  // oldSize = size of marker in WAL
+  // newSize = size of marker in datafile
+
+  MUTEX_LOCKER(_lock);
+
+  _totalSize -= (  TRI_DF_ALIGN_BLOCK(oldSize) 
+                 - TRI_DF_ALIGN_BLOCK(newSize));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the id of the datafile or logfile a header points into
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_voc_fid_t TRI_headers_t::fid (TRI_doc_mptr_t const* header) const {
+  MUTEX_LOCKER(_lock);
+
+  TRI_ASSERT(header->_fidNumber < _fids.size());
+
+  return _fids[header->_fidNumber];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the id of the datafile or logfile a header points into
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_headers_t::setFid (TRI_doc_mptr_t* header,
+                            TRI_voc_fid_t fid) {
+  MUTEX_LOCKER(_lock);
+
+  // most headers are set to the datafile or logfile that is currently
+  // written to, so check the last one first
+  if (_fids[_lastNumber] != fid) {
+    if (fid == 0) {
+      _lastNumber = 0;
+    }
+    else {
+      auto it = _fidNumbers.find(fid);
+
+      if (it != _fidNumbers.end()) {
+        _lastNumber = (*it).second;
+      }
+      else {
+        TRI_ASSERT(_fids.size() < (size_t) UINT32_MAX);
+
+        uint32_t const number = static_cast<uint32_t>(_fids.size());
+        _fids.push_back(fid);
+
+        try {
+          _fidNumbers.emplace(fid, number);
+        }
+        catch (...) {
+          _fids.pop_back();
+          throw;
+        }
+
+        _lastNumber = number;
+      }
+    }
+  }
+
+  header->_fidNumber = _lastNumber;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unlinks a header from the linked list, the caller must hold the lock
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_headers_t::unlinkHeader (TRI_doc_mptr_t* header) {
   int64_t size;
 
   TRI_ASSERT(header != nullptr);
@@ -216,16 +457,11 @@ void TRI_headers_t::unlink (TRI_doc_mptr_t* header) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief moves a header around in the list, using its previous position
-/// (specified in "old"), note that this is only used in revert operations
+/// @brief moves a header around in the list, the caller must hold the lock
 ////////////////////////////////////////////////////////////////////////////////
 
-void TRI_headers_t::move (TRI_doc_mptr_t* header,
-                          TRI_doc_mptr_t* old) {
-  if (header == nullptr) {
-    return;
-  }
-
+void TRI_headers_t::moveHeader (TRI_doc_mptr_t* header,
+                                TRI_doc_mptr_t* old) {
   TRI_ASSERT(_nrAllocated > 0);
   TRI_ASSERT(header->_prev != header);
   TRI_ASSERT(header->_next != header);
@@ -287,168 +523,108 @@ void TRI_headers_t::move (TRI_doc_mptr_t* header,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief moves a header back into the list, using its previous position
-/// (specified in "old")
+/// @brief allocates a new slab
 ////////////////////////////////////////////////////////////////////////////////
 
-void TRI_headers_t::relink (TRI_doc_mptr_t* header,
-                            TRI_doc_mptr_t* old) {
-  if (header == nullptr) {
-    return;
-  }
-
-  TRI_ASSERT(header->getDataPtr() != nullptr); // ONLY IN HEADERS, PROTECTED by RUNTIME
-
-  int64_t size = (int64_t) ((TRI_df_marker_t*) header->getDataPtr())->_size; // ONLY IN HEADERS, PROTECTED by RUNTIME
-  TRI_ASSERT(size > 0);
-
-  TRI_ASSERT(_begin != header);
-  TRI_ASSERT(_end != header);
-
-  this->move(header, old);
-  _nrLinked++;
-  _totalSize += TRI_DF_ALIGN_BLOCK(size);
-  TRI_ASSERT(_totalSize > 0);
-
-  TRI_ASSERT(header->_prev != header);
-  TRI_ASSERT(header->_next != header);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// @brief requests a new header
-////////////////////////////////////////////////////////////////////////////////
+bool TRI_headers_t::allocateSlab () {
+  size_t const slabSize = GetSlabSize(_slabs.size());
+  TRI_ASSERT(slabSize > 0);
 
-TRI_doc_mptr_t* TRI_headers_t::request (size_t size) {
-  TRI_doc_mptr_t* header;
+  slab_t* slab = nullptr;
 
-  TRI_ASSERT(size > 0);
+  try {
+    slab = new slab_t;
+    slab->_begin = nullptr;
+    slab->_begin = new TRI_doc_mptr_t[slabSize];
+    slab->_size = slabSize;
+    slab->_used = 0;
 
-  if (_freelist == nullptr) {
-    size_t blockSize = GetBlockSize(_blocks._length);
-    TRI_ASSERT(blockSize > 0);
+    // keep the slabs ordered by address, so that findSlab can use a
+    // binary search
+    _slabs.insert(std::upper_bound(_slabs.begin(), _slabs.end(), slab, slab_less_t()), slab);
 
-    TRI_doc_mptr_t* begin;
     try {
-      begin = new TRI_doc_mptr_t[blockSize];
+      _partial.insert(slab);
     }
-    catch (std::exception&) {
-      begin = nullptr;
+    catch (...) {
+      _slabs.erase(std::lower_bound(_slabs.begin(), _slabs.end(), slab, slab_less_t()));
+      throw;
     }
-
-    // out of memory
-    if (begin == nullptr) {
-      TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
-      return nullptr;
+  }
+  catch (...) {
+    if (slab != nullptr) {
+      delete[] slab->_begin;
+      delete slab;
     }
 
-    TRI_doc_mptr_t* ptr = begin + (blockSize - 1);
-
-    header = nullptr;
-
-    for (;  begin <= ptr;  ptr--) {
-      ptr->setDataPtr(header); // ONLY IN HEADERS
-      header = ptr;
-    }
+    return false;
+  }
 
-    _freelist = header;
+  TRI_doc_mptr_t* begin = slab->_begin;
+  TRI_doc_mptr_t* ptr = begin + (slabSize - 1);
+  TRI_doc_mptr_t* header = nullptr;
 
-    TRI_PushBackVectorPointer(&_blocks, begin);
+  for (;  begin <= ptr;  ptr--) {
+    ptr->setDataPtr(header); // ONLY IN HEADERS
+    header = ptr;
   }
 
-  TRI_ASSERT(_freelist != nullptr);
+  slab->_freelist = header;
+  _memory += slabSize * sizeof(TRI_doc_mptr_t);
 
-  TRI_doc_mptr_t* result = const_cast<TRI_doc_mptr_t*>(_freelist);
-  TRI_ASSERT(result != nullptr);
+  return true;
+}
 
-  _freelist = static_cast<TRI_doc_mptr_t const*>(result->getDataPtr()); // ONLY IN HEADERS, PROTECTED by RUNTIME
-  result->setDataPtr(nullptr); // ONLY IN HEADERS
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees an unused slab
+////////////////////////////////////////////////////////////////////////////////
 
-  // put new header at the end of the list
-  if (_begin == nullptr) {
-    // list of headers is empty
-    TRI_ASSERT(_nrLinked == 0);
-    TRI_ASSERT(_totalSize == 0);
+void TRI_headers_t::freeSlab (slab_t* slab) {
+  TRI_ASSERT(slab->_used == 0);
 
-    _begin = result;
-    _end   = result;
+  _partial.erase(slab);
 
-    result->_prev   = nullptr;
-    result->_next   = nullptr;
-  }
-  else {
-    // list is not empty
-    TRI_ASSERT(_nrLinked > 0);
-    TRI_ASSERT(_totalSize > 0);
-    TRI_ASSERT(_nrAllocated > 0);
-    TRI_ASSERT(_begin != nullptr);
-    TRI_ASSERT(_end != nullptr);
+  auto it = std::lower_bound(_slabs.begin(), _slabs.end(), slab, slab_less_t());
+  TRI_ASSERT(it != _slabs.end() && *it == slab);
+  _slabs.erase(it);
 
-    _end->_next   = result;
-    result->_prev = _end;
-    result->_next = nullptr;
-    _end          = result;
-  }
-
-  _nrAllocated++;
-  _nrLinked++;
-  _totalSize += (int64_t) TRI_DF_ALIGN_BLOCK(size);
+  _memory -= slab->_size * sizeof(TRI_doc_mptr_t);
 
-  return result;
+  delete[] slab->_begin;
+  delete slab;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief releases a header, putting it back onto the freelist
+/// @brief finds the slab a header belongs to
 ////////////////////////////////////////////////////////////////////////////////
 
-void TRI_headers_t::release (TRI_doc_mptr_t* header,
-                             bool unlinkHeader) {
-  if (header == nullptr) {
-    return;
-  }
-
-  if (unlinkHeader) {
-    this->unlink(header);
-  }
-
-  header->clear();
-  TRI_ASSERT(_nrAllocated > 0);
-  _nrAllocated--;
-
-  header->setDataPtr(_freelist); // ONLY IN HEADERS
-  _freelist = header;
+TRI_headers_t::slab_t* TRI_headers_t::findSlab (TRI_doc_mptr_t const* header) const {
+  // find the last slab that starts at or before the header
+  size_t lo = 0;
+  size_t hi = _slabs.size();
 
-  if (_nrAllocated == 0 && _blocks._length >= 8) {
-    // if this was the last header, we can safely reclaim some
-    // memory by freeing all already-allocated blocks and wiping the freelist
-    // we only do this if we had allocated 8 blocks of headers
-    // this limit is arbitrary, but will ensure we only free memory if
-    // it is sensible and not everytime the last document is removed
+  while (lo < hi) {
+    size_t const mid = lo + (hi - lo) / 2;
 
-    for (size_t i = 0;  i < _blocks._length;  ++i) {
-      delete[] static_cast<TRI_doc_mptr_t*>(_blocks._buffer[i]);
-      _blocks._buffer[i] = nullptr;
+    if (_slabs[mid]->_begin <= header) {
+      lo = mid + 1;
     }
+    else {
+      hi = mid;
+    }
+  }
 
-    // set length to 0
-    _blocks._length = 0;
-    _freelist = nullptr;
-    _begin = nullptr;
-    _end = nullptr;
+  if (lo == 0) {
+    return nullptr;
   }
-}
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief adjust the total size of the markers handed out
-/// this is called by the collector
-////////////////////////////////////////////////////////////////////////////////
+  slab_t* slab = _slabs[lo - 1];
 
-void TRI_headers_t::adjustTotalSize (int64_t oldSize,
-                                     int64_t newSize) {
-  // oldSize = size of marker in WAL
-  // newSize = size of marker in datafile
+  if (header >= slab->_begin + slab->_size) {
+    return nullptr;
+  }
 
-  _totalSize -= (  TRI_DF_ALIGN_BLOCK(oldSize) 
-                 - TRI_DF_ALIGN_BLOCK(newSize));
+  return slab;
 }
 
 // -----------------------------------------------------------------------------
@@ -31,7 +31,8 @@
 #define ARANGODB_VOC_BASE_HEADERS_H 1
 
 #include "Basics/Common.h"
-#include "Basics/vector.h"
+#include "Basics/Mutex.h"
+#include "VocBase/voc-types.h"
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                              forward declarations
@@ -113,6 +114,22 @@ class TRI_headers_t {
 
     void adjustTotalSize (int64_t, int64_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the id of the datafile or logfile a header points into
+////////////////////////////////////////////////////////////////////////////////
+
+    TRI_voc_fid_t fid (struct TRI_doc_mptr_t const*) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the id of the datafile or logfile a header points into
+///
+/// headers only store the 32 bit number of the datafile in the fid table of
+/// the collection. numbers are never reused, so the table has one entry per
+/// datafile or logfile that ever contained a document of the collection
+////////////////////////////////////////////////////////////////////////////////
+
+    void setFid (struct TRI_doc_mptr_t*, TRI_voc_fid_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the element at the head of the list
 ///
@@ -141,6 +158,22 @@ class TRI_headers_t {
       return _nrLinked;
     }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of allocated headers
+////////////////////////////////////////////////////////////////////////////////
+
+    inline size_t allocated () const {
+      return _nrAllocated;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the memory used by the header slabs
+////////////////////////////////////////////////////////////////////////////////
+
+    inline size_t memory () const {
+      return _memory;
+    }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the total size of linked headers
 ////////////////////////////////////////////////////////////////////////////////
@@ -150,20 +183,91 @@ class TRI_headers_t {
     }
 
 // -----------------------------------------------------------------------------
-// --SECTION--                                                 private variables
+// --SECTION--                                                     private types
 // -----------------------------------------------------------------------------
 
   private:
 
-    TRI_doc_mptr_t const*  _freelist;    // free headers
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a slab of headers
+///
+/// every slab keeps its own freelist and the number of headers handed out,
+/// so that a slab can be freed as soon as its last header is released
+////////////////////////////////////////////////////////////////////////////////
+
+    struct slab_t {
+      TRI_doc_mptr_t*        _begin;     // first header of the slab
+      size_t                 _size;      // number of headers in the slab
+      size_t                 _used;      // number of headers handed out
+      TRI_doc_mptr_t const*  _freelist;  // free headers of the slab
+    };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief orders slabs by their address
+////////////////////////////////////////////////////////////////////////////////
+
+    struct slab_less_t {
+      bool operator() (slab_t const* lhs, slab_t const* rhs) const {
+        return lhs->_begin < rhs->_begin;
+      }
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocate a new slab
+////////////////////////////////////////////////////////////////////////////////
+
+    bool allocateSlab ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unlink a header, the caller must hold the lock
+////////////////////////////////////////////////////////////////////////////////
+
+    void unlinkHeader (struct TRI_doc_mptr_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief move a header, the caller must hold the lock
+////////////////////////////////////////////////////////////////////////////////
+
+    void moveHeader (struct TRI_doc_mptr_t*, struct TRI_doc_mptr_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free an unused slab
+////////////////////////////////////////////////////////////////////////////////
+
+    void freeSlab (slab_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find the slab a header belongs to
+////////////////////////////////////////////////////////////////////////////////
+
+    slab_t* findSlab (struct TRI_doc_mptr_t const*) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
 
     TRI_doc_mptr_t*        _begin;       // start pointer to list of allocated headers
     TRI_doc_mptr_t*        _end;         // end pointer to list of allocated headers
     size_t                 _nrAllocated; // number of allocated headers
     size_t                 _nrLinked;    // number of linked headers
     int64_t                _totalSize;   // total size of markers for linked headers
+    size_t                 _memory;      // memory used by the slabs
+
+    std::vector<slab_t*>                 _slabs;    // all slabs, ordered by address
+    std::set<slab_t*, slab_less_t>       _partial;  // slabs with free headers
+
+    std::vector<TRI_voc_fid_t>                   _fids;        // fid table
+    std::unordered_map<TRI_voc_fid_t, uint32_t>  _fidNumbers;  // fid => number
+    uint32_t                                     _lastNumber;  // number of the last fid set
 
-    TRI_vector_pointer_t   _blocks;
+    // protects all of the above against concurrent single-document writes
+    // into the collection. the accessors for the list and the counters are
+    // not locked, their callers hold the collection lock
+    mutable triagens::basics::Mutex              _lock;
 };
 
 #endif
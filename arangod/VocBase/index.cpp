@@ -94,10 +94,14 @@ void TRI_InitIndex (TRI_index_t* idx,
 
   // init common functions
   idx->selectivityEstimate    = nullptr;
+  idx->prefixSelectivityEstimate = nullptr;
+  idx->rangeFractionEstimate  = nullptr;
   idx->memory                 = nullptr;
   idx->removeIndex            = nullptr;
   idx->cleanup                = nullptr;
+  idx->refreshStatistics      = nullptr;
   idx->sizeHint               = nullptr;
+  idx->batchInsert            = nullptr;
   idx->postInsert             = nullptr;
 
   LOG_TRACE("initialising index of type %s", TRI_TypeNameIndex(idx->_type));
@@ -1276,14 +1280,15 @@ static int SkiplistIndexHelper (TRI_skiplist_index_t const* skiplistIndex,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief inserts a document into a skip list index
+/// @brief creates the skiplist index element for a document
+///
+/// Sets element to nullptr if the document is to be ignored by a sparse index.
 ////////////////////////////////////////////////////////////////////////////////
 
-static int InsertSkiplistIndex (TRI_index_t* idx,
-                                TRI_doc_mptr_t const* doc,
-                                bool isRollback) {
-
-  TRI_skiplist_index_t* skiplistIndex = (TRI_skiplist_index_t*) idx;
+static int CreateSkiplistElement (TRI_skiplist_index_t* skiplistIndex,
+                                  TRI_doc_mptr_t const* doc,
+                                  TRI_skiplist_index_element_t*& element) {
+  element = nullptr;
 
   // ...........................................................................
   // Allocate storage to shaped json objects stored as a simple list.
@@ -1314,7 +1319,7 @@ static int InsertSkiplistIndex (TRI_index_t* idx,
   // .........................................................................
 
   if (res == TRI_ERROR_ARANGO_INDEX_DOCUMENT_ATTRIBUTE_MISSING) {
-    if (idx->_sparse) {
+    if (skiplistIndex->base._sparse) {
       TRI_Free(TRI_UNKNOWN_MEM_ZONE, skiplistElement);
       return TRI_ERROR_NO_ERROR;
     }
@@ -1327,11 +1332,132 @@ static int InsertSkiplistIndex (TRI_index_t* idx,
     return res;
   }
 
+  element = skiplistElement;
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a document into a skip list index
+////////////////////////////////////////////////////////////////////////////////
+
+static int InsertSkiplistIndex (TRI_index_t* idx,
+                                TRI_doc_mptr_t const* doc,
+                                bool isRollback) {
+
+  TRI_skiplist_index_t* skiplistIndex = (TRI_skiplist_index_t*) idx;
+
+  TRI_skiplist_index_element_t* skiplistElement;
+  int res = CreateSkiplistElement(skiplistIndex, doc, skiplistElement);
+
+  if (res != TRI_ERROR_NO_ERROR || skiplistElement == nullptr) {
+    return res;
+  }
+
   // insert into the index. the memory for the element will be owned or freed
   // by the index
   return SkiplistIndex_insert(skiplistIndex->_skiplistIndex, skiplistElement);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts many documents into an empty skip list index
+////////////////////////////////////////////////////////////////////////////////
+
+static int BatchInsertSkiplistIndex (TRI_index_t* idx,
+                                     std::vector<TRI_doc_mptr_t const*> const* docs) {
+  TRI_skiplist_index_t* skiplistIndex = (TRI_skiplist_index_t*) idx;
+
+  std::vector<TRI_skiplist_index_element_t*> elements;
+  int res = TRI_ERROR_NO_ERROR;
+
+  try {
+    elements.reserve(docs->size());
+
+    for (auto doc : *docs) {
+      TRI_skiplist_index_element_t* skiplistElement;
+      res = CreateSkiplistElement(skiplistIndex, doc, skiplistElement);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        break;
+      }
+
+      if (skiplistElement != nullptr) {
+        elements.push_back(skiplistElement);
+      }
+    }
+  }
+  catch (...) {
+    res = TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    for (auto it : elements) {
+      TRI_Free(TRI_UNKNOWN_MEM_ZONE, it);
+    }
+    return res;
+  }
+
+  // the memory for the elements will be owned or freed by the index
+  return SkiplistIndex_bulkLoad(skiplistIndex->_skiplistIndex, &elements);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the selectivity estimate of equality lookups on the first
+/// n attributes of a skiplist index
+////////////////////////////////////////////////////////////////////////////////
+
+static double PrefixSelectivityEstimateSkiplistIndex (TRI_index_t const* idx,
+                                                      size_t n) {
+  TRI_skiplist_index_t const* skiplistIndex = (TRI_skiplist_index_t const*) idx;
+
+  return SkiplistIndex_prefixSelectivity(skiplistIndex->_skiplistIndex, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the selectivity estimate of a skiplist index, which is the
+/// selectivity of equality lookups on all its attributes
+////////////////////////////////////////////////////////////////////////////////
+
+static double SelectivityEstimateSkiplistIndex (TRI_index_t const* idx) {
+  if (idx->_unique) {
+    return 1.0;
+  }
+
+  double estimate = PrefixSelectivityEstimateSkiplistIndex(idx, idx->_fields._length);
+
+  if (estimate <= 0.0) {
+    // no statistics yet
+    return 1.0;
+  }
+
+  return estimate;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the fraction of entries of a skiplist index with a first
+/// attribute value inside a range
+////////////////////////////////////////////////////////////////////////////////
+
+static double RangeFractionEstimateSkiplistIndex (TRI_index_t const* idx,
+                                                  TRI_json_t const* low,
+                                                  bool lowInclusive,
+                                                  TRI_json_t const* high,
+                                                  bool highInclusive) {
+  TRI_skiplist_index_t const* skiplistIndex = (TRI_skiplist_index_t const*) idx;
+
+  return SkiplistIndex_rangeFraction(skiplistIndex->_skiplistIndex, low, lowInclusive, high, highInclusive);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recomputes the value statistics of a skiplist index if they are
+/// stale
+////////////////////////////////////////////////////////////////////////////////
+
+static void RefreshStatisticsSkiplistIndex (TRI_index_t* idx) {
+  TRI_skiplist_index_t* skiplistIndex = (TRI_skiplist_index_t*) idx;
+
+  SkiplistIndex_refreshStatistics(skiplistIndex->_skiplistIndex);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the memory used by the index
 ////////////////////////////////////////////////////////////////////////////////
@@ -1472,11 +1598,19 @@ TRI_index_t* TRI_CreateSkiplistIndex (TRI_document_collection_t* document,
 
   TRI_InitIndex(idx, iid, TRI_IDX_TYPE_SKIPLIST_INDEX, document, sparse, unique);
 
+  idx->_hasSelectivityEstimate   = true;
+  idx->selectivityEstimate       = SelectivityEstimateSkiplistIndex;
+  idx->prefixSelectivityEstimate = PrefixSelectivityEstimateSkiplistIndex;
+  idx->rangeFractionEstimate     = RangeFractionEstimateSkiplistIndex;
+  idx->refreshStatistics         = RefreshStatisticsSkiplistIndex;
+
   idx->memory   = MemorySkiplistIndex;
   idx->json     = JsonSkiplistIndex;
   idx->insert   = InsertSkiplistIndex;
   idx->remove   = RemoveSkiplistIndex;
 
+  idx->batchInsert = BatchInsertSkiplistIndex;
+
   // ...........................................................................
   // Copy the contents of the shape list vector into a new vector and store this
   // ...........................................................................
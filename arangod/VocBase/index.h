@@ -103,6 +103,12 @@ typedef struct TRI_index_s {
   bool _hasSelectivityEstimate;
 
   double (*selectivityEstimate) (struct TRI_index_s const*);
+
+  // value statistics for the optimizer, nullptr if the index does not maintain any.
+  // selectivity of equality lookups on the first n attributes, 0 if unknown
+  double (*prefixSelectivityEstimate) (struct TRI_index_s const*, size_t);
+  // fraction of entries with a first attribute inside a range, negative if unknown
+  double (*rangeFractionEstimate) (struct TRI_index_s const*, TRI_json_t const*, bool, TRI_json_t const*, bool);
   size_t (*memory) (struct TRI_index_s const*);
   TRI_json_t* (*json) (struct TRI_index_s const*);
   void (*removeIndex) (struct TRI_index_s*, struct TRI_document_collection_t*);
@@ -120,9 +126,17 @@ typedef struct TRI_index_s {
   // a garbage collection function for the index
   int (*cleanup) (struct TRI_index_s*);
 
+  // NULL by default. recomputes stale value statistics, called by the cleanup
+  // thread with a read lock on the collection
+  void (*refreshStatistics) (struct TRI_index_s*);
+
   // give index a hint about the expected size
   int (*sizeHint) (struct TRI_index_s*, size_t);
 
+  // NULL by default. fills an empty index with many documents at once. if
+  // set, it is used instead of insert when the index is filled initially
+  int (*batchInsert) (struct TRI_index_s*, std::vector<struct TRI_doc_mptr_t const*> const*);
+
   // .........................................................................................
   // the following functions are called by the query machinery which attempting to determine an
   // appropriate index and when using the index to obtain a result set.
@@ -88,19 +88,24 @@ void TRI_DestroyPrimaryIndex (TRI_primary_index_t*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief hash the key
+///
+/// master pointers store 32 bits of the hash only, so the hash is folded to
+/// 32 bits here already
 ////////////////////////////////////////////////////////////////////////////////
   
-static inline uint64_t TRI_HashKeyPrimaryIndex (char const* key) {
-  return TRI_FnvHashString(key);
+static inline uint32_t TRI_HashKeyPrimaryIndex (char const* key) {
+  uint64_t const hash = TRI_FnvHashString(key);
+  return static_cast<uint32_t>(hash ^ (hash >> 32));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief hash the key
 ////////////////////////////////////////////////////////////////////////////////
   
-static inline uint64_t TRI_HashKeyPrimaryIndex (char const* key,
+static inline uint32_t TRI_HashKeyPrimaryIndex (char const* key,
                                                 size_t length) {
-  return TRI_FnvHashPointer(static_cast<void const*>(key), length);
+  uint64_t const hash = TRI_FnvHashPointer(static_cast<void const*>(key), length);
+  return static_cast<uint32_t>(hash ^ (hash >> 32));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
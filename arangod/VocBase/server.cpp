@@ -1700,6 +1700,7 @@ TRI_server_t* TRI_CreateServer () {
 int TRI_InitServer (TRI_server_t* server,
                     void* applicationEndpointServer,
                     void* indexPool,
+                    void* scanPool,
                     char const* basePath,
                     char const* appPath,
                     TRI_vocbase_defaults_t const* defaults,
@@ -1716,6 +1717,7 @@ int TRI_InitServer (TRI_server_t* server,
   server->_applicationEndpointServer = applicationEndpointServer;
 
   server->_indexPool                 = indexPool;
+  server->_scanPool                  = scanPool;
 
   // .............................................................................
   // set up paths and filenames
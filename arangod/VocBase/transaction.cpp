@@ -177,7 +177,7 @@ static void FreeOperations (TRI_transaction_t* trx) {
 
         if (op->type == TRI_VOC_DOCUMENT_OPERATION_UPDATE ||
             op->type == TRI_VOC_DOCUMENT_OPERATION_REMOVE) {
-          TRI_voc_fid_t fid = op->oldHeader._fid;
+          TRI_voc_fid_t fid = document->_headersPtr->fid(&op->oldHeader);
           TRI_df_marker_t const* marker = static_cast<TRI_df_marker_t const*>(op->oldHeader.getDataPtr());  // PROTECTED by trx from above
 
           auto it2 = stats.find(fid);
@@ -367,7 +367,7 @@ static int LockCollection (TRI_transaction_collection_t* trxCollection,
       res = document->beginRead(document);
     }
     else {
-      res = document->beginReadTimed(document, trx->_timeout, TRI_TRANSACTION_DEFAULT_SLEEP_DURATION);
+      res = document->beginReadTimed(document, trx->_timeout);
     }
   }
   else {
@@ -379,7 +379,7 @@ static int LockCollection (TRI_transaction_collection_t* trxCollection,
       res = document->beginWrite(document);
     }
     else {
-      res = document->beginWriteTimed(document, trx->_timeout, TRI_TRANSACTION_DEFAULT_SLEEP_DURATION);
+      res = document->beginWriteTimed(document, trx->_timeout);
     }
   }
 
@@ -1215,7 +1215,9 @@ int TRI_AddOperationTransaction (triagens::wal::DocumentOperation& operation,
   if (operation.type == TRI_VOC_DOCUMENT_OPERATION_INSERT ||
       operation.type == TRI_VOC_DOCUMENT_OPERATION_UPDATE) {
     // adjust the data position in the header
-    operation.header->setDataPtr(position);  // PROTECTED by ongoing trx from operation
+    TRI_doc_mptr_copy_t data = *operation.header;
+    data.setDataPtr(position);
+    TRI_CopyHeaderDocumentCollection(document, operation.header, data);  // PROTECTED by ongoing trx from operation
     if (operation.type == TRI_VOC_DOCUMENT_OPERATION_INSERT && sizeChanged) {
       document->_headersPtr->adjustTotalSize(0, sizeChanged);
     }
@@ -1226,9 +1228,9 @@ int TRI_AddOperationTransaction (triagens::wal::DocumentOperation& operation,
   }
 
   // set header file id
-  operation.header->_fid = fid;
+  document->_headersPtr->setFid(operation.header, fid);
 
-  TRI_ASSERT(operation.header->_fid > 0);
+  TRI_ASSERT(document->_headersPtr->fid(operation.header) > 0);
 
   if (isSingleOperationTransaction) {
     // operation is directly executed
@@ -1239,11 +1241,12 @@ int TRI_AddOperationTransaction (triagens::wal::DocumentOperation& operation,
     if (operation.type == TRI_VOC_DOCUMENT_OPERATION_UPDATE ||
         operation.type == TRI_VOC_DOCUMENT_OPERATION_REMOVE) {
       // update datafile statistics for the old header
-      TRI_ASSERT(operation.oldHeader._fid > 0);
+      TRI_voc_fid_t const oldFid = document->_headersPtr->fid(&operation.oldHeader);
+      TRI_ASSERT(oldFid > 0);
        
       TRI_LOCK_JOURNAL_ENTRIES_DOC_COLLECTION(document);
 
-      TRI_doc_datafile_info_t* dfi = TRI_FindDatafileInfoDocumentCollection(document, operation.oldHeader._fid, false);
+      TRI_doc_datafile_info_t* dfi = TRI_FindDatafileInfoDocumentCollection(document, oldFid, false);
       // the old header might point to the WAL. in this case, there'll be no stats update
 
       if (dfi != nullptr) {
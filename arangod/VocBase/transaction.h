@@ -74,12 +74,6 @@ struct TRI_vocbase_col_s;
 
 #define TRI_TRANSACTION_DEFAULT_LOCK_TIMEOUT 30000000ULL
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief sleep time (in µs) while waiting for lock acquisition
-////////////////////////////////////////////////////////////////////////////////
-
-#define TRI_TRANSACTION_DEFAULT_SLEEP_DURATION 10000ULL
-
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
@@ -638,7 +638,7 @@ int CollectorThread::processCollectionOperations (CollectorCache* cache) {
 
           // we can safely update the master pointer's dataptr value
           found->setDataPtr(static_cast<void*>(const_cast<char*>(operation.datafilePosition)));
-          found->_fid = fid;
+          document->_headersPtr->setFid(found, fid);
         }
       }
       else if (walMarker->_type == TRI_WAL_MARKER_EDGE) {
@@ -662,7 +662,7 @@ int CollectorThread::processCollectionOperations (CollectorCache* cache) {
 
           // we can safely update the master pointer's dataptr value
           found->setDataPtr(static_cast<void*>(const_cast<char*>(operation.datafilePosition)));
-          found->_fid = fid;
+          document->_headersPtr->setFid(found, fid);
         }
       }
       else if (walMarker->_type == TRI_WAL_MARKER_REMOVE) {
@@ -95,6 +95,12 @@ namespace triagens {
           // move header to the end of the list
           document->_headersPtr->moveBack(header, &oldHeader);  // PROTECTED by trx in trxCollection
         }
+        else if (type == TRI_VOC_DOCUMENT_OPERATION_REMOVE) {
+          // the header is only unlinked once the operation is in the log,
+          // so a failed operation does not need to relink it at a list
+          // position that concurrent writers might have changed meanwhile
+          document->_headersPtr->unlink(header);  // PROTECTED by trx in trxCollection
+        }
 
         // free the local marker buffer
         marker->freeBuffer();
@@ -108,6 +114,13 @@ namespace triagens {
 
         TRI_document_collection_t* document = trxCollection->_collection->_collection;
 
+        if (type == TRI_VOC_DOCUMENT_OPERATION_UPDATE &&
+            status == StatusType::HANDLED) {
+          // the header was moved to the end of the list. this must happen
+          // before the rollback, because it uses the size of the new marker
+          document->_headersPtr->move(header, &oldHeader);  // PROTECTED by trx in trxCollection
+        }
+
         if (status == StatusType::INDEXED || status == StatusType::HANDLED) {
           TRI_RollbackOperationDocumentCollection(document, type, header, &oldHeader);
         }
@@ -116,11 +129,10 @@ namespace triagens {
           document->_headersPtr->release(header, true);  // PROTECTED by trx in trxCollection
         }
         else if (type == TRI_VOC_DOCUMENT_OPERATION_UPDATE) {
-          document->_headersPtr->move(header, &oldHeader);  // PROTECTED by trx in trxCollection
-          header->copy(oldHeader);
+          TRI_CopyHeaderDocumentCollection(document, header, oldHeader);
         }
         else if (type == TRI_VOC_DOCUMENT_OPERATION_REMOVE) {
-          if (status != StatusType::CREATED) {
+          if (status == StatusType::HANDLED) {
             document->_headersPtr->relink(header, &oldHeader); // PROTECTED by trx in trxCollection 
           }
         }
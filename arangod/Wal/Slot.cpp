@@ -57,7 +57,7 @@ Slot::Slot ()
 ////////////////////////////////////////////////////////////////////////////////
 
 std::string Slot::statusText () const {
-  switch (_status) {
+  switch (_status.load(std::memory_order_relaxed)) {
     case StatusType::UNUSED:
       return "unused";
     case StatusType::USED:
@@ -125,7 +125,7 @@ void Slot::setUnused () {
   _logfileId   = 0;
   _mem         = nullptr;
   _size        = 0;
-  _status      = StatusType::UNUSED;
+  _status.store(StatusType::UNUSED, std::memory_order_release);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -141,7 +141,7 @@ void Slot::setUsed (void* mem,
   _logfileId = logfileId;
   _mem = mem;
   _size = size;
-  _status = StatusType::USED;
+  _status.store(StatusType::USED, std::memory_order_release);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -151,10 +151,10 @@ void Slot::setUsed (void* mem,
 void Slot::setReturned (bool waitForSync) {
   TRI_ASSERT(isUsed());
   if (waitForSync) {
-    _status = StatusType::RETURNED_WFS;
+    _status.store(StatusType::RETURNED_WFS, std::memory_order_release);
   }
   else {
-    _status = StatusType::RETURNED;
+    _status.store(StatusType::RETURNED, std::memory_order_release);
   }
 }
 
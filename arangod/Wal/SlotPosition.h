@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Write-ahead log reservation position
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_WAL_SLOT_POSITION_H
+#define ARANGODB_WAL_SLOT_POSITION_H 1
+
+#include "Basics/Common.h"
+#include "VocBase/datafile.h"
+
+namespace triagens {
+  namespace wal {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 class SlotPosition
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief layout of the reservation position
+///
+/// the position is a single 64 bit value, so that a writer can claim a slot
+/// and the logfile space for its marker with one compare-and-swap:
+///
+/// - the write offset in the current logfile, in units of the datafile block
+///   alignment (29 bits, logfiles of up to 4 GB)
+/// - the index of the slot to hand out next (just enough bits for the
+///   configured number of slots)
+/// - the logfile generation, incremented on every logfile switch so that a
+///   writer cannot reserve space in a stale logfile (all remaining bits)
+/// - a flag that is set while there is no writeable logfile (1 bit)
+///
+/// the generation wraps around after generations() logfile switches. a
+/// writer that read a position before a switch can only reserve space with
+/// it if it is stalled between reading the position and its compare-and-swap
+/// for a multiple of generations() switches, and if the offset and slot
+/// index are then exactly the same again. with the maximum of 16M slots,
+/// there are 1024 generations, so the writer would have to be stalled while
+/// 1024 logfiles are written. the default of 1M slots gives 16384
+/// generations
+////////////////////////////////////////////////////////////////////////////////
+
+    class SlotPosition {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the layout for a number of slots
+////////////////////////////////////////////////////////////////////////////////
+
+        explicit SlotPosition (size_t numberOfSlots)
+          : _indexBits(IndexBits(numberOfSlots)),
+            _indexMask((1ULL << _indexBits) - 1),
+            _generationShift(OffsetBits + _indexBits),
+            _generationMask((1ULL << (63 - _generationShift)) - 1) {
+
+          TRI_ASSERT(numberOfSlots > 0);
+          TRI_ASSERT(static_cast<uint64_t>(numberOfSlots - 1) <= _indexMask);
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extract the write offset from a position
+////////////////////////////////////////////////////////////////////////////////
+
+        inline uint64_t offset (uint64_t position) const {
+          return (position & OffsetMask) * TRI_DF_BLOCK_ALIGNMENT;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extract the slot index from a position
+////////////////////////////////////////////////////////////////////////////////
+
+        inline size_t index (uint64_t position) const {
+          return static_cast<size_t>((position >> OffsetBits) & _indexMask);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extract the logfile generation from a position
+////////////////////////////////////////////////////////////////////////////////
+
+        inline uint64_t generation (uint64_t position) const {
+          return (position >> _generationShift) & _generationMask;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a position is blocked
+////////////////////////////////////////////////////////////////////////////////
+
+        inline bool blocked (uint64_t position) const {
+          return (position & BlockedFlag) != 0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of logfile switches after which the generation wraps
+////////////////////////////////////////////////////////////////////////////////
+
+        inline uint64_t generations () const {
+          return _generationMask + 1;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build a position
+////////////////////////////////////////////////////////////////////////////////
+
+        inline uint64_t make (uint64_t offset,
+                              size_t index,
+                              uint64_t generation,
+                              bool blocked) const {
+          TRI_ASSERT(offset % TRI_DF_BLOCK_ALIGNMENT == 0);
+          TRI_ASSERT(offset / TRI_DF_BLOCK_ALIGNMENT <= OffsetMask);
+          TRI_ASSERT(static_cast<uint64_t>(index) <= _indexMask);
+
+          return (offset / TRI_DF_BLOCK_ALIGNMENT) |
+                 (static_cast<uint64_t>(index) << OffsetBits) |
+                 ((generation & _generationMask) << _generationShift) |
+                 (blocked ? BlockedFlag : 0);
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of bits needed for the slot indexes
+////////////////////////////////////////////////////////////////////////////////
+
+        static int IndexBits (size_t numberOfSlots) {
+          int bits = 1;
+
+          while (bits < 24 && (static_cast<uint64_t>(numberOfSlots) - 1) >> bits != 0) {
+            ++bits;
+          }
+
+          return bits;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        static int const      OffsetBits  = 29;
+        static uint64_t const OffsetMask  = (1ULL << OffsetBits) - 1;
+        static uint64_t const BlockedFlag = 1ULL << 63;
+
+        int const      _indexBits;
+        uint64_t const _indexMask;
+        int const      _generationShift;
+        uint64_t const _generationMask;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -36,8 +36,25 @@
 #include "VocBase/server.h"
 #include "Wal/LogfileManager.h"
 
+#include <thread>
+
 using namespace triagens::wal;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a marker fits into a logfile at the given offset,
+/// leaving room for the footer
+////////////////////////////////////////////////////////////////////////////////
+
+static inline bool FitsIntoLogfile (Logfile const* logfile,
+                                    uint64_t offset,
+                                    uint32_t size) {
+  return offset + size + Logfile::overhead() <= logfile->allocatedSize();
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -52,14 +69,15 @@ Slots::Slots (LogfileManager* logfileManager,
   : _logfileManager(logfileManager),
     _condition(),
     _lock(),
+    _regionLock(),
     _slots(new Slot[numberOfSlots]),
     _numberOfSlots(numberOfSlots),
-    _freeSlots(numberOfSlots),
     _waiting(0),
-    _handoutIndex(0),
+    _layout(numberOfSlots),
+    _position(_layout.make(0, 0, 0, true)),
+    _tickIndex(0),
     _recycleIndex(0),
     _logfile(nullptr),
-    _lastAssignedTick(0),
     _lastCommittedTick(0),
     _lastCommittedDataTick(0),
     _numEvents(0)  {
@@ -86,10 +104,9 @@ Slots::~Slots () {
 void Slots::statistics (Slot::TickType& lastTick,
                         Slot::TickType& lastDataTick,
                         uint64_t& numEvents) {
-  MUTEX_LOCKER(_lock);
-  lastTick     = _lastCommittedTick;
-  lastDataTick = _lastCommittedDataTick;
-  numEvents    = _numEvents;
+  lastTick     = _lastCommittedTick.load();
+  lastDataTick = _lastCommittedDataTick.load();
+  numEvents    = _numEvents.load();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -127,8 +144,7 @@ int Slots::flush (bool waitForSync) {
 ////////////////////////////////////////////////////////////////////////////////
 
 Slot::TickType Slots::lastCommittedTick () {
-  MUTEX_LOCKER(_lock);
-  return _lastCommittedTick;
+  return _lastCommittedTick.load();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -136,110 +152,7 @@ Slot::TickType Slots::lastCommittedTick () {
 ////////////////////////////////////////////////////////////////////////////////
 
 SlotInfo Slots::nextUnused (uint32_t size) {
-  // we need to use the aligned size for writing
-  uint32_t alignedSize = TRI_DF_ALIGN_BLOCK(size);
-  int iterations = 0;
-  bool hasWaited = false;
-
-  TRI_ASSERT(size > 0);
-
-  while (++iterations < 1000) {
-    {
-      MUTEX_LOCKER(_lock);
-
-      Slot* slot = &_slots[_handoutIndex];
-      TRI_ASSERT(slot != nullptr);
-
-      if (slot->isUnused()) {
-        if (hasWaited) {
-          CONDITION_LOCKER(guard, _condition);
-          TRI_ASSERT(_waiting > 0);
-          --_waiting;
-          hasWaited = false;
-        }
-
-        // cycle until we have a valid logfile
-        while (_logfile == nullptr ||
-               _logfile->freeSize() < static_cast<uint64_t>(alignedSize)) {
-
-          if (_logfile != nullptr) {
-            // seal existing logfile by creating a footer marker
-            int res = writeFooter(slot);
-
-            if (res != TRI_ERROR_NO_ERROR) {
-              return SlotInfo(res);
-            }
-
-            // advance to next slot
-            slot = &_slots[_handoutIndex];
-            _logfileManager->setLogfileSealRequested(_logfile);
-
-            _logfile = nullptr;
-          }
-
-          // fetch the next free logfile (this may create a new one)
-          Logfile::StatusType status = newLogfile(alignedSize);
-
-          if (_logfile == nullptr) {
-            usleep(10 * 1000);
-
-            TRI_IF_FAILURE("LogfileManagerGetWriteableLogfile") {
-              return SlotInfo(TRI_ERROR_ARANGO_NO_JOURNAL);
-            }
-
-            // try again in next iteration
-          }
-          else if (status == Logfile::StatusType::EMPTY) {
-            // inititialise the empty logfile by writing a header marker
-            int res = writeHeader(slot);
-
-            if (res != TRI_ERROR_NO_ERROR) {
-              return SlotInfo(res);
-            }
-
-            // advance to next slot
-            slot = &_slots[_handoutIndex];
-            _logfileManager->setLogfileOpen(_logfile);
-          }
-          else {
-            TRI_ASSERT(status == Logfile::StatusType::OPEN);
-          }
-        }
-
-        // if we get here, we got a free slot for the actual data...
-
-        char* mem = _logfile->reserve(alignedSize);
-
-        if (mem == nullptr) {
-          return SlotInfo(TRI_ERROR_INTERNAL);
-        }
-
-        // only in this case we return a valid slot
-        slot->setUsed(static_cast<void*>(mem), size, _logfile->id(), handout());
-
-        return SlotInfo(slot);
-      }
-    }
-
-    // if we get here, all slots are busy
-    CONDITION_LOCKER(guard, _condition);
-    if (! hasWaited) {
-      ++_waiting;
-      hasWaited = true;
-    }
-
-    bool mustWait;
-    {
-      MUTEX_LOCKER(_lock);
-      mustWait = (_freeSlots == 0);
-    }
-
-    if (mustWait) {
-      guard.wait(10 * 1000);
-    }
-  }
-
-  return SlotInfo(TRI_ERROR_ARANGO_NO_JOURNAL);
+  return reserve(size, 0, 0, 0, nullptr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -255,125 +168,7 @@ SlotInfo Slots::nextUnused (uint32_t size,
                             uint32_t legendOffset,
                             void*& oldLegend) {
                             // legendOffset 0 means no legend included
-  // we need to use the aligned size for writing
-  uint32_t alignedSize = TRI_DF_ALIGN_BLOCK(size);
-  int iterations = 0;
-  bool hasWaited = false;
-
-  TRI_ASSERT(size > 0);
-
-  while (++iterations < 1000) {
-    {
-      MUTEX_LOCKER(_lock);
-
-      Slot* slot = &_slots[_handoutIndex];
-      TRI_ASSERT(slot != nullptr);
-
-      if (slot->isUnused()) {
-        if (hasWaited) {
-          CONDITION_LOCKER(guard, _condition);
-          TRI_ASSERT(_waiting > 0);
-          --_waiting;
-          hasWaited = false;
-        }
-
-        // cycle until we have a valid logfile
-        while (_logfile == nullptr ||
-               _logfile->freeSize() < static_cast<uint64_t>(alignedSize)) {
-
-          if (_logfile != nullptr) {
-            // seal existing logfile by creating a footer marker
-            int res = writeFooter(slot);
-
-            if (res != TRI_ERROR_NO_ERROR) {
-              return SlotInfo(res);
-            }
-
-            // advance to next slot
-            slot = &_slots[_handoutIndex];
-            _logfileManager->setLogfileSealRequested(_logfile);
-
-            _logfile = nullptr;
-          }
-
-          // fetch the next free logfile (this may create a new one)
-          Logfile::StatusType status = newLogfile(alignedSize);
-
-          if (_logfile == nullptr) {
-            usleep(10 * 1000);
-
-            TRI_IF_FAILURE("LogfileManagerGetWriteableLogfile") {
-              return SlotInfo(TRI_ERROR_ARANGO_NO_JOURNAL);
-            }
-
-            // try again in next iteration
-          }
-          else if (status == Logfile::StatusType::EMPTY) {
-            // inititialise the empty logfile by writing a header marker
-            int res = writeHeader(slot);
-
-            if (res != TRI_ERROR_NO_ERROR) {
-              return SlotInfo(res);
-            }
-
-            // advance to next slot
-            slot = &_slots[_handoutIndex];
-            _logfileManager->setLogfileOpen(_logfile);
-          }
-          else {
-            TRI_ASSERT(status == Logfile::StatusType::OPEN);
-          }
-        }
-
-        // if we get here, we got a free slot for the actual data...
-        
-        // Now sort out the legend business:
-        if (legendOffset == 0) {
-          void* legend = _logfile->lookupLegend(cid, sid);
-          if (nullptr == legend) {
-            // Bad, we would need a legend for this marker
-            return SlotInfo(TRI_ERROR_LEGEND_NOT_IN_WAL_FILE);
-          }
-          oldLegend = legend;
-        }
-
-        char* mem = _logfile->reserve(alignedSize);
-
-        if (mem == nullptr) {
-          return SlotInfo(TRI_ERROR_INTERNAL);
-        }
-
-        if (legendOffset != 0) {
-          void* legend = static_cast<void*>(mem + legendOffset);
-          _logfile->cacheLegend(cid, sid, legend);
-        }
-
-        // only in this case we return a valid slot
-        slot->setUsed(static_cast<void*>(mem), size, _logfile->id(), handout());
-
-        return SlotInfo(slot);
-      }
-    }
-
-    // if we get here, all slots are busy
-    CONDITION_LOCKER(guard, _condition);
-    if (! hasWaited) {
-      ++_waiting;
-      hasWaited = true;
-    }
-
-    bool mustWait;
-    {
-      MUTEX_LOCKER(_lock);
-      mustWait = (_freeSlots == 0);
-    }
-
-    if (mustWait) {
-      guard.wait(10 * 1000);
-    }
-  }
-
-  return SlotInfo(TRI_ERROR_ARANGO_NO_JOURNAL);
+  return reserve(size, cid, sid, legendOffset, &oldLegend);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -387,11 +182,8 @@ void Slots::returnUsed (SlotInfo& slotInfo,
 
   TRI_ASSERT(tick > 0);
 
-  {
-    MUTEX_LOCKER(_lock);
-    slotInfo.slot->setReturned(waitForSync);
-    ++_numEvents;
-  }
+  slotInfo.slot->setReturned(waitForSync);
+  ++_numEvents;
 
   _logfileManager->signalSync();
 
@@ -402,12 +194,16 @@ void Slots::returnUsed (SlotInfo& slotInfo,
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get the next synchronisable region
+///
+/// this is only called by the synchroniser thread. writers only ever turn
+/// unused slots into used ones and used slots into returned ones, so the
+/// slots from the recycle index up to the first slot not yet returned are
+/// stable and can be scanned without blocking the writers
 ////////////////////////////////////////////////////////////////////////////////
 
 SyncRegion Slots::getSyncRegion () {
   SyncRegion region;
-
-  MUTEX_LOCKER(_lock);
+  char* end = nullptr;
 
   size_t slotIndex = _recycleIndex;
 
@@ -418,10 +214,10 @@ SyncRegion Slots::getSyncRegion () {
     if (! slot->isReturned()) {
       // found a slot that is not yet returned
       // if it belongs to another logfile, we can seal the logfile we created
-      // the region for
-      auto otherId = slot->logfileId();
-      if (region.logfileId != 0 && otherId != 0 && 
-          otherId != region.logfileId) {
+      // the region for. slots that are still being reserved are ignored
+      if (region.logfileId != 0 && 
+          slot->isUsed() &&
+          slot->logfileId() != region.logfileId) {
         region.canSeal = true;
       }
       break;
@@ -457,16 +253,39 @@ SyncRegion Slots::getSyncRegion () {
       region.waitForSync |= slot->waitForSync();
     }
 
+    end = static_cast<char*>(slot->mem()) + TRI_DF_ALIGN_BLOCK(slot->size());
+
     if (++slotIndex >= _numberOfSlots) {
       slotIndex = 0;
     }
 
+    if (static_cast<TRI_df_marker_t const*>(slot->mem())->_type == TRI_DF_MARKER_FOOTER) {
+      // the footer is the last marker of a logfile. the header of the next
+      // logfile may not have been handed out yet
+      region.checkMore = true;
+      region.canSeal   = true;
+      break;
+    }
+
     if (slotIndex == _recycleIndex) {
       // one full loop
       break;
     }
   }
 
+  if (region.logfile != nullptr) {
+    // writers do not maintain the datafile's write position. advance it
+    // here, up to the end of the last returned marker
+    MUTEX_LOCKER(_regionLock);
+
+    TRI_datafile_t* datafile = region.logfile->df();
+
+    if (end > datafile->_next) {
+      datafile->_next        = end;
+      datafile->_currentSize = static_cast<TRI_voc_size_t>(end - datafile->_data);
+    }
+  }
+
   return region;
 }
 
@@ -480,7 +299,7 @@ void Slots::returnSyncRegion (SyncRegion const& region) {
   size_t slotIndex = region.firstSlotIndex;
 
   {
-    MUTEX_LOCKER(_lock);
+    MUTEX_LOCKER(_regionLock);
 
     while (true) {
       Slot* slot = &_slots[slotIndex];
@@ -503,7 +322,6 @@ void Slots::returnSyncRegion (SyncRegion const& region) {
       region.logfile->update(m);
 
       slot->setUnused();
-      ++_freeSlots;
 
       // update recycle index, too
       if (++_recycleIndex >= _numberOfSlots) {
@@ -530,13 +348,13 @@ void Slots::returnSyncRegion (SyncRegion const& region) {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get the current open region of a logfile
-/// this uses the slots lock
+/// this uses the region lock
 ////////////////////////////////////////////////////////////////////////////////
 
 void Slots::getActiveLogfileRegion (Logfile* logfile,
                                     char const*& begin,
                                     char const*& end) {
-  MUTEX_LOCKER(_lock);
+  MUTEX_LOCKER(_regionLock);
 
   TRI_datafile_t* datafile = logfile->df();
 
@@ -546,14 +364,14 @@ void Slots::getActiveLogfileRegion (Logfile* logfile,
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get the current tick range of a logfile
-/// this uses the slots lock
+/// this uses the region lock
 ////////////////////////////////////////////////////////////////////////////////
 
 void Slots::getActiveTickRange (Logfile* logfile,
                                 TRI_voc_tick_t& tickMin,
                                 TRI_voc_tick_t& tickMax) {
 
-  MUTEX_LOCKER(_lock);
+  MUTEX_LOCKER(_regionLock);
   
   TRI_datafile_t* datafile = logfile->df();
 
@@ -565,6 +383,285 @@ void Slots::getActiveTickRange (Logfile* logfile,
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reserve a slot and logfile space for a marker, without taking the
+/// slots lock in the common case
+///
+/// a writer claims the next slot and the space for its marker with a single
+/// compare-and-swap on the reservation position, so slot order and logfile
+/// order are always the same. the slots lock is only taken if the current
+/// logfile is full or if there is no current logfile. a non-null legend
+/// pointer selects the legend handling explained in
+/// LogfileManager::allocateAndWrite
+////////////////////////////////////////////////////////////////////////////////
+
+SlotInfo Slots::reserve (uint32_t size,
+                         TRI_voc_cid_t cid,
+                         TRI_shape_sid_t sid,
+                         uint32_t legendOffset,
+                         void** oldLegend) {
+  // we need to use the aligned size for writing
+  uint32_t alignedSize = TRI_DF_ALIGN_BLOCK(size);
+  int iterations = 0;
+  bool hasWaited = false;
+
+  TRI_ASSERT(size > 0);
+
+  while (iterations < 1000) {
+    uint64_t position = _position.load(std::memory_order_acquire);
+    Logfile* logfile = nullptr;
+    bool mustSwitch = _layout.blocked(position);
+
+    if (! mustSwitch) {
+      // the logfile is published before the position is unblocked, but a
+      // concurrent rollover may already have blocked the position and
+      // retracted the logfile since we have read the position. in this
+      // case the compare-and-swap below would fail anyway, so start over
+      logfile = _logfile.load(std::memory_order_acquire);
+
+      if (logfile == nullptr ||
+          _position.load(std::memory_order_acquire) != position) {
+        continue;
+      }
+
+      mustSwitch = ! FitsIntoLogfile(logfile, _layout.offset(position), alignedSize);
+    }
+
+    if (mustSwitch) {
+      bool busy;
+      bool worked;
+      int res;
+
+      {
+        MUTEX_LOCKER(_lock);
+        res = switchLogfile(alignedSize, false, busy, worked);
+      }
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        stopWaiting(hasWaited);
+        return SlotInfo(res);
+      }
+
+      if (busy) {
+        ++iterations;
+        waitForProgress(hasWaited);
+      }
+      continue;
+    }
+
+    size_t const index = _layout.index(position);
+    Slot* slot = &_slots[index];
+    TRI_ASSERT(slot != nullptr);
+
+    if (! slot->isUnused()) {
+      // all slots are busy
+      ++iterations;
+      waitForProgress(hasWaited);
+      continue;
+    }
+
+    // Now sort out the legend business:
+    if (oldLegend != nullptr && legendOffset == 0) {
+      void* legend = logfile->lookupLegend(cid, sid);
+      if (nullptr == legend) {
+        // Bad, we would need a legend for this marker
+        stopWaiting(hasWaited);
+        return SlotInfo(TRI_ERROR_LEGEND_NOT_IN_WAL_FILE);
+      }
+      *oldLegend = legend;
+    }
+
+    uint64_t const offset = _layout.offset(position);
+    uint64_t const next = _layout.make(offset + alignedSize,
+                                       (index + 1 == _numberOfSlots) ? 0 : index + 1,
+                                       _layout.generation(position),
+                                       false);
+
+    if (! _position.compare_exchange_weak(position, next, std::memory_order_acq_rel)) {
+      // another writer was faster, try again
+      continue;
+    }
+
+    // if we get here, the slot and the logfile region are ours. nothing
+    // must fail from here on, as the next slot waits for our tick
+    char* mem = logfile->df()->_data + offset;
+
+    if (oldLegend != nullptr && legendOffset != 0) {
+      void* legend = static_cast<void*>(mem + legendOffset);
+
+      try {
+        logfile->cacheLegend(cid, sid, legend);
+      }
+      catch (...) {
+        // the marker carries its legend anyway. if it cannot be cached,
+        // the next marker of this shape writes its own legend
+      }
+    }
+
+    slot->setUsed(static_cast<void*>(mem), size, logfile->id(), handout(index));
+    stopWaiting(hasWaited);
+
+    return SlotInfo(slot);
+  }
+
+  stopWaiting(hasWaited);
+
+  return SlotInfo(TRI_ERROR_ARANGO_NO_JOURNAL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief seal the current logfile and open the next one if required
+/// this must be called with the slots lock held
+///
+/// writing the footer blocks the position, so no writer can reserve space
+/// until the next logfile has been opened. if this cannot be completed
+/// because there is no free slot or no writeable logfile, busy is set and
+/// the call must be repeated later. if seal is false, the logfile is only
+/// switched if a marker of the specified size does not fit into it anymore
+////////////////////////////////////////////////////////////////////////////////
+
+int Slots::switchLogfile (uint32_t size,
+                          bool seal,
+                          bool& busy,
+                          bool& worked) {
+  busy = false;
+  worked = false;
+
+  uint64_t position = _position.load(std::memory_order_acquire);
+
+  while (! _layout.blocked(position)) {
+    // writers can still reserve space in the current logfile concurrently
+    Logfile* logfile = _logfile.load(std::memory_order_relaxed);
+    TRI_ASSERT(logfile != nullptr);
+
+    uint64_t const offset = _layout.offset(position);
+
+    if (seal) {
+      if (logfile->status() == Logfile::StatusType::EMPTY) {
+        // no need to seal a still-empty logfile
+        return TRI_ERROR_NO_ERROR;
+      }
+    }
+    else if (FitsIntoLogfile(logfile, offset, size)) {
+      // someone else switched the logfile already
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    size_t const index = _layout.index(position);
+    Slot* slot = &_slots[index];
+    TRI_ASSERT(slot != nullptr);
+
+    if (! slot->isUnused()) {
+      busy = true;
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    // reserve the footer and block the position in one go
+    uint64_t const next = _layout.make(offset + TRI_DF_ALIGN_BLOCK(sizeof(TRI_df_footer_marker_t)),
+                                       (index + 1 == _numberOfSlots) ? 0 : index + 1,
+                                       _layout.generation(position),
+                                       true);
+
+    if (_position.compare_exchange_weak(position, next, std::memory_order_acq_rel)) {
+      // seal existing logfile by creating a footer marker
+      writeFooter(slot, index, logfile, logfile->df()->_data + offset);
+      _logfileManager->setLogfileSealRequested(logfile);
+
+      _logfile.store(nullptr, std::memory_order_relaxed);
+      position = next;
+    }
+  }
+
+  // if we get here, the position is blocked and only we can change it
+  Logfile* logfile = _logfile.load(std::memory_order_relaxed);
+
+  if (logfile == nullptr) {
+    // fetch the next free logfile (this may create a new one)
+    newLogfile(size);
+    logfile = _logfile.load(std::memory_order_relaxed);
+
+    if (logfile == nullptr) {
+      TRI_IF_FAILURE("LogfileManagerGetWriteableLogfile") {
+        return TRI_ERROR_ARANGO_NO_JOURNAL;
+      }
+
+      // try again later
+      busy = true;
+      return TRI_ERROR_NO_ERROR;
+    }
+  }
+
+  // there are no outstanding slots for a logfile that is not yet active,
+  // so its datafile position is accurate
+  char* mem = logfile->df()->_next;
+  size_t index = _layout.index(position);
+
+  if (logfile->status() == Logfile::StatusType::EMPTY) {
+    Slot* slot = &_slots[index];
+    TRI_ASSERT(slot != nullptr);
+
+    if (! slot->isUnused()) {
+      busy = true;
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    // inititialise the empty logfile by writing a header marker
+    writeHeader(slot, index, logfile, mem);
+    _logfileManager->setLogfileOpen(logfile);
+
+    mem += TRI_DF_ALIGN_BLOCK(sizeof(TRI_df_header_marker_t));
+    index = (index + 1 == _numberOfSlots) ? 0 : index + 1;
+    worked = true;
+  }
+  else {
+    TRI_ASSERT(logfile->status() == Logfile::StatusType::OPEN);
+  }
+
+  // publish the new logfile to the writers
+  _logfile.store(logfile, std::memory_order_release);
+  _position.store(_layout.make(static_cast<uint64_t>(mem - logfile->df()->_data),
+                               index,
+                               _layout.generation(position) + 1,
+                               false),
+                  std::memory_order_release);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait until the synchroniser has freed slots or the logfile
+/// rollover has made progress
+////////////////////////////////////////////////////////////////////////////////
+
+void Slots::waitForProgress (bool& hasWaited) {
+  CONDITION_LOCKER(guard, _condition);
+
+  if (! hasWaited) {
+    ++_waiting;
+    hasWaited = true;
+  }
+
+  uint64_t position = _position.load(std::memory_order_acquire);
+
+  if (_layout.blocked(position) ||
+      ! _slots[_layout.index(position)].isUnused()) {
+    guard.wait(10 * 1000);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unregister a thread that has waited for progress
+////////////////////////////////////////////////////////////////////////////////
+
+void Slots::stopWaiting (bool& hasWaited) {
+  if (hasWaited) {
+    CONDITION_LOCKER(guard, _condition);
+    TRI_ASSERT(_waiting > 0);
+    --_waiting;
+    hasWaited = false;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief close a logfile
 ////////////////////////////////////////////////////////////////////////////////
@@ -576,101 +673,36 @@ int Slots::closeLogfile (Slot::TickType& lastCommittedTick,
   worked = false;
 
   while (++iterations < 1000) {
+    bool busy;
+    int res;
+
     {
       MUTEX_LOCKER(_lock);
 
-      lastCommittedTick = _lastCommittedTick;
-
-      Slot* slot = &_slots[_handoutIndex];
-      TRI_ASSERT(slot != nullptr);
+      lastCommittedTick = _lastCommittedTick.load();
 
-      if (slot->isUnused()) {
-        if (hasWaited) {
-          CONDITION_LOCKER(guard, _condition);
-          TRI_ASSERT(_waiting > 0);
-          --_waiting;
-          hasWaited = false;
-        }
-
-        if (_logfile != nullptr) {
-          if (_logfile->status() == Logfile::StatusType::EMPTY) {
-            // no need to seal a still-empty logfile
-            return TRI_ERROR_NO_ERROR;
-          }
-
-          // seal existing logfile by creating a footer marker
-          int res = writeFooter(slot);
-
-          if (res != TRI_ERROR_NO_ERROR) {
-            LOG_ERROR("could not write logfile footer: %s", TRI_errno_string(res));
-            return res;
-          }
-
-          _logfileManager->setLogfileSealRequested(_logfile);
-
-          // advance to next slot
-          slot = &_slots[_handoutIndex];
-
-          // invalidate the logfile so for the next write we'll use a
-          // new one
-          _logfile = nullptr;
-
-          // fall-through intentional
-        }
-
-        TRI_ASSERT(_logfile == nullptr);
-        // fetch the next free logfile (this may create a new one)
-        // note: as we don't have a real marker to write the size does
-        // not matter (we use a size of 1 as  it must be > 0)
-        Logfile::StatusType status = newLogfile(1);
-
-        if (_logfile == nullptr) {
-          TRI_IF_FAILURE("LogfileManagerGetWriteableLogfile") {
-            return TRI_ERROR_ARANGO_NO_JOURNAL;
-          }
-
-          usleep(10 * 1000);
-          // try again in next iteration
-        }
-        else if (status == Logfile::StatusType::EMPTY) {
-          // inititialise the empty logfile by writing a header marker
-          int res = writeHeader(slot);
-
-          if (res != TRI_ERROR_NO_ERROR) {
-            LOG_ERROR("could not write logfile header: %s", TRI_errno_string(res));
-            return res;
-          }
-
-          _logfileManager->setLogfileOpen(_logfile);
-          worked = true;
-          return TRI_ERROR_NO_ERROR;
-        }
-        else {
-          TRI_ASSERT(status == Logfile::StatusType::OPEN);
-          worked = false;
-          return TRI_ERROR_NO_ERROR;
-        }
-      }
+      // note: as we don't have a real marker to write the size does
+      // not matter (we use a size of 1 as  it must be > 0)
+      res = switchLogfile(1, true, busy, worked);
     }
 
-    // if we get here, all slots are busy
-    CONDITION_LOCKER(guard, _condition);
-    if (! hasWaited) {
-      ++_waiting;
-      hasWaited = true;
+    if (res != TRI_ERROR_NO_ERROR) {
+      LOG_ERROR("could not close logfile: %s", TRI_errno_string(res));
+      stopWaiting(hasWaited);
+      return res;
     }
 
-    bool mustWait;
-    {
-      MUTEX_LOCKER(_lock);
-      mustWait = (_freeSlots == 0);
+    if (! busy) {
+      stopWaiting(hasWaited);
+      return TRI_ERROR_NO_ERROR;
     }
 
-    if (mustWait) {
-      guard.wait(10 * 1000);
-    }
+    // if we get here, all slots are busy or there is no logfile yet
+    waitForProgress(hasWaited);
   }
 
+  stopWaiting(hasWaited);
+
   return TRI_ERROR_ARANGO_NO_JOURNAL;
 }
 
@@ -678,55 +710,55 @@ int Slots::closeLogfile (Slot::TickType& lastCommittedTick,
 /// @brief write a header marker
 ////////////////////////////////////////////////////////////////////////////////
 
-int Slots::writeHeader (Slot* slot) {
-  TRI_df_header_marker_t&& header = _logfile->getHeaderMarker();
+void Slots::writeHeader (Slot* slot,
+                         size_t index,
+                         Logfile* logfile,
+                         char* mem) {
+  TRI_df_header_marker_t&& header = logfile->getHeaderMarker();
   size_t const size = header.base._size;
 
-  TRI_df_marker_t* mem = reinterpret_cast<TRI_df_marker_t*>(_logfile->reserve(size));
-  TRI_ASSERT(mem != nullptr);
-
-  slot->setUsed(static_cast<void*>(mem), static_cast<uint32_t>(size), _logfile->id(), handout());
+  slot->setUsed(static_cast<void*>(mem), static_cast<uint32_t>(size), logfile->id(), handout(index));
   slot->fill(&header.base, size);
   slot->setReturned(false); // sync
-
-  return TRI_ERROR_NO_ERROR;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write a footer marker
 ////////////////////////////////////////////////////////////////////////////////
 
-int Slots::writeFooter (Slot* slot) {
-  TRI_ASSERT(_logfile != nullptr);
-
-  TRI_df_footer_marker_t&& footer = _logfile->getFooterMarker();
+void Slots::writeFooter (Slot* slot,
+                         size_t index,
+                         Logfile* logfile,
+                         char* mem) {
+  TRI_df_footer_marker_t&& footer = logfile->getFooterMarker();
   size_t const size = footer.base._size;
 
-  TRI_df_marker_t* mem = reinterpret_cast<TRI_df_marker_t*>(_logfile->reserve(size));
-  TRI_ASSERT(mem != nullptr);
-
-  slot->setUsed(static_cast<void*>(mem), static_cast<uint32_t>(size), _logfile->id(), handout());
+  slot->setUsed(static_cast<void*>(mem), static_cast<uint32_t>(size), logfile->id(), handout(index));
   slot->fill(&footer.base, size);
   slot->setReturned(true); // sync
-
-  return TRI_ERROR_NO_ERROR;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief handout a region and advance the handout index
+/// @brief hand out a tick for the slot with the specified index
+///
+/// ticks must grow with the slot order. the writer of the previous slot may
+/// have won its reservation but not yet fetched its tick, so wait for it.
+/// this only covers a few instructions of the other writer
 ////////////////////////////////////////////////////////////////////////////////
 
-Slot::TickType Slots::handout () {
-  TRI_ASSERT(_freeSlots > 0);
-  _freeSlots--;
+Slot::TickType Slots::handout (size_t index) {
+  int spins = 0;
 
-  if (++_handoutIndex ==_numberOfSlots) {
-    // wrap around
-    _handoutIndex = 0;
+  while (_tickIndex.load(std::memory_order_acquire) != index) {
+    if (++spins > 64) {
+      std::this_thread::yield();
+    }
   }
  
-  _lastAssignedTick = static_cast<Slot::TickType>(TRI_NewTickServer());
-  return _lastAssignedTick;
+  Slot::TickType tick = static_cast<Slot::TickType>(TRI_NewTickServer());
+  _tickIndex.store((index + 1 == _numberOfSlots) ? 0 : index + 1, std::memory_order_release);
+
+  return tick;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -761,7 +793,7 @@ Logfile::StatusType Slots::newLogfile (uint32_t size) {
   TRI_ASSERT(size > 0);
 
   Logfile::StatusType status = Logfile::StatusType::UNKNOWN;
-  _logfile = _logfileManager->getWriteableLogfile(size, status);
+  _logfile.store(_logfileManager->getWriteableLogfile(size, status), std::memory_order_relaxed);
 
   return status;
 }
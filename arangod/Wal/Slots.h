@@ -35,6 +35,7 @@
 #include "Basics/Mutex.h"
 #include "Wal/Logfile.h"
 #include "Wal/Slot.h"
+#include "Wal/SlotPosition.h"
 #include "Wal/SyncRegion.h"
 
 namespace triagens {
@@ -193,7 +194,7 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get the current open region of a logfile
-/// this uses the slots lock
+/// this uses the region lock
 ////////////////////////////////////////////////////////////////////////////////
 
         void getActiveLogfileRegion (Logfile*,
@@ -202,7 +203,7 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get the current tick range of a logfile
-/// this uses the slots lock
+/// this uses the region lock
 ////////////////////////////////////////////////////////////////////////////////
 
         void getActiveTickRange (Logfile*,
@@ -213,6 +214,40 @@ namespace triagens {
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reserve a slot and logfile space for a marker, without taking the
+/// slots lock in the common case
+////////////////////////////////////////////////////////////////////////////////
+
+        SlotInfo reserve (uint32_t,
+                          TRI_voc_cid_t,
+                          TRI_shape_sid_t,
+                          uint32_t,
+                          void**);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief seal the current logfile and open the next one if required
+/// this must be called with the slots lock held
+////////////////////////////////////////////////////////////////////////////////
+
+        int switchLogfile (uint32_t,
+                           bool,
+                           bool&,
+                           bool&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait until the synchroniser has freed slots or the logfile
+/// rollover has made progress
+////////////////////////////////////////////////////////////////////////////////
+
+        void waitForProgress (bool&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unregister a thread that has waited for progress
+////////////////////////////////////////////////////////////////////////////////
+
+        void stopWaiting (bool&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief close a logfile
 ////////////////////////////////////////////////////////////////////////////////
@@ -224,19 +259,25 @@ namespace triagens {
 /// @brief write a header marker
 ////////////////////////////////////////////////////////////////////////////////
 
-        int writeHeader (Slot*);
+        void writeHeader (Slot*,
+                          size_t,
+                          Logfile*,
+                          char*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write a footer marker
 ////////////////////////////////////////////////////////////////////////////////
 
-        int writeFooter (Slot*);
+        void writeFooter (Slot*,
+                          size_t,
+                          Logfile*,
+                          char*);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief handout a region and advance the handout index
+/// @brief hand out a tick for the slot with the specified index
 ////////////////////////////////////////////////////////////////////////////////
 
-        Slot::TickType handout ();
+        Slot::TickType handout (size_t);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief wait until all data has been synced up to a certain marker
@@ -270,11 +311,19 @@ namespace triagens {
         basics::ConditionVariable _condition;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief mutex protecting the slots interface
+/// @brief mutex serialising logfile rollovers
+/// writers only take it when the current logfile is full or when there is
+/// no current logfile
 ////////////////////////////////////////////////////////////////////////////////
 
         basics::Mutex _lock;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief mutex protecting the synced region and ticks of the active logfile
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::Mutex _regionLock;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief all slots
 ////////////////////////////////////////////////////////////////////////////////
@@ -288,58 +337,64 @@ namespace triagens {
         size_t const _numberOfSlots;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief the number of currently free slots
+/// @brief number of threads waiting for a slot, protected by the condition
 ////////////////////////////////////////////////////////////////////////////////
 
-        size_t _freeSlots;
+        uint32_t _waiting;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief whether or not someone is waiting for a slot
+/// @brief the layout of the reservation position
 ////////////////////////////////////////////////////////////////////////////////
 
-        uint32_t _waiting;
+        SlotPosition const _layout;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief the index of the slot to hand out next
+/// @brief the reservation position
+/// this packs the write offset in the current logfile, the index of the slot
+/// to hand out next, a logfile generation and a flag that is set while there
+/// is no writeable logfile. writers reserve space and a slot with a single
+/// compare-and-swap on this value
 ////////////////////////////////////////////////////////////////////////////////
 
-        size_t _handoutIndex;
+        std::atomic<uint64_t> _position;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief the index of the slot to recycle
+/// @brief the index of the slot that receives the next tick
+/// ticks are handed out in slot order so they grow with the logfile position
 ////////////////////////////////////////////////////////////////////////////////
 
-        size_t _recycleIndex;
+        std::atomic<size_t> _tickIndex;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief the current logfile to write into
+/// @brief the index of the slot to recycle
+/// this is only used by the synchroniser thread
 ////////////////////////////////////////////////////////////////////////////////
 
-        Logfile* _logfile;
+        size_t _recycleIndex;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief last assigned tick value
+/// @brief the current logfile to write into
 ////////////////////////////////////////////////////////////////////////////////
 
-        Slot::TickType _lastAssignedTick;
+        std::atomic<Logfile*> _logfile;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief last committed tick value
 ////////////////////////////////////////////////////////////////////////////////
 
-        Slot::TickType _lastCommittedTick;
+        std::atomic<Slot::TickType> _lastCommittedTick;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief last committed data tick value
 ////////////////////////////////////////////////////////////////////////////////
 
-        Slot::TickType _lastCommittedDataTick;
+        std::atomic<Slot::TickType> _lastCommittedDataTick;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief number of log events handled
 ////////////////////////////////////////////////////////////////////////////////
 
-        uint64_t _numEvents;
+        std::atomic<uint64_t> _numEvents;
 
     };
 
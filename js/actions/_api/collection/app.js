@@ -661,6 +661,12 @@ function get_api_collections (req, res) {
 ///
 /// * *figures.indexes.size*: The total memory allocated for indexes in bytes.
 ///
+/// * *figures.masterPointers.count*: The number of master pointers allocated
+///   for the documents of the collection.
+///
+/// * *figures.masterPointers.size*: The total memory allocated for master
+///   pointers in bytes.
+///
 /// * *figures.maxTick*: The tick of the last marker that was stored in a journal
 ///   of the collection. This might be 0 if the collection does not yet have
 ///   a journal.
@@ -221,8 +221,26 @@ function printIndexes (indexes) {
   print(); 
 }
 
+/* format a runtime value (in seconds) */
+function formatTime (t) {
+  'use strict';
+  return t.toFixed(5);
+}
+
+/* format a memory value (in bytes) */
+function formatMemory (m) {
+  'use strict';
+  if (m >= 1024 * 1024) {
+    return (m / (1024 * 1024)).toFixed(1) + " MB";
+  }
+  if (m >= 1024) {
+    return (m / 1024).toFixed(1) + " kB";
+  }
+  return String(m) + " B";
+}
+
 /* analzye and print execution plan */
-function processQuery (query, explain) {
+function processQuery (query, explain, profile) {
   'use strict';
   var nodes = { }, 
     parents = { }, 
@@ -230,8 +248,26 @@ function processQuery (query, explain) {
     maxTypeLen = 0,
     maxIdLen = String("Id").length,
     maxEstimateLen = String("Est.").length,
+    maxCallsLen = String("Calls").length,
+    maxItemsLen = String("Items").length,
+    maxTimeLen = String("Runtime").length,
+    maxMemoryLen = String("Memory").length,
     plan = explain.plan;
 
+  /* per-node profile columns, "-" for nodes that were not profiled */
+  var profileColumns = function (node) {
+    var p = (profile !== undefined && profile.hasOwnProperty(node.id)) ? profile[node.id] : null;
+    if (p === null) {
+      return { calls: "-", items: "-", time: "-", memory: "-" };
+    }
+    return { 
+      calls: String(p.getSomeCalls + p.skipSomeCalls), 
+      items: String(p.rowsOut), 
+      time: formatTime(p.selfTime), 
+      memory: formatMemory(p.peakMemory) 
+    };
+  };
+
   var recursiveWalk = function (n, level) {
     n.forEach(function(node) {
       nodes[node.id] = node;
@@ -257,6 +293,13 @@ function processQuery (query, explain) {
       if (String(node.estimatedNrItems).length > maxEstimateLen) {
         maxEstimateLen = String(node.estimatedNrItems).length;
       }
+      if (profile !== undefined) {
+        var p = profileColumns(node);
+        maxCallsLen = Math.max(maxCallsLen, p.calls.length);
+        maxItemsLen = Math.max(maxItemsLen, p.items.length);
+        maxTimeLen = Math.max(maxTimeLen, p.time.length);
+        maxMemoryLen = Math.max(maxMemoryLen, p.memory.length);
+      }
     });
   };
   recursiveWalk(plan.nodes, 0);
@@ -419,17 +462,27 @@ function processQuery (query, explain) {
         return keyword("EMPTY") + "   " + annotation("/* empty result set */");
       case "EnumerateCollectionNode":
         collectionVariables[node.outVariable.id] = node.collection;
-        return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + collection(node.collection) + "   " + annotation("/* full collection scan" + (node.random ? ", random order" : "") + " */");
+        return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + collection(node.collection) + "   " + annotation("/* full collection scan" + (node.random ? ", random order" : "") + (node.parallel ? ", parallel" : "") + " */");
       case "EnumerateListNode":
         return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + variableName(node.inVariable) + "   " + annotation("/* list iteration */");
       case "IndexRangeNode":
         collectionVariables[node.outVariable.id] = node.collection;
-        var index = node.index;
-        index.ranges = node.ranges.map(buildRanges).join(" || ");
-        index.collection = node.collection;
-        index.node = node.id;
-        indexes.push(index);
-        return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + collection(node.collection) + "   " + annotation("/* " + (node.reverse ? "reverse " : "") + node.index.type + " index scan") + annotation("*/");
+        var lookups = [ { index: node.index, ranges: node.ranges } ].concat(node.otherLookups || [ ]);
+        lookups.forEach(function(lookup) {
+          var index = lookup.index;
+          index.ranges = lookup.ranges.map(buildRanges).join(" || ");
+          index.collection = node.collection;
+          index.node = node.id;
+          indexes.push(index);
+        });
+        var scan;
+        if (lookups.length > 1) {
+          scan = lookups.map(function(lookup) { return lookup.index.type; }).join(", ") + (node.intersect ? " index intersection" : " index union");
+        }
+        else {
+          scan = (node.reverse ? "reverse " : "") + node.index.type + (node.indexOnly ? " index-only scan" : " index scan");
+        }
+        return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + collection(node.collection) + "   " + annotation("/* " + scan) + annotation("*/");
       case "CalculationNode":
         return keyword("LET") + " " + variableName(node.outVariable) + " = " + buildExpression(node.expression);
       case "FilterNode":
@@ -445,7 +498,7 @@ function processQuery (query, explain) {
       case "SortNode":
         return keyword("SORT") + " " + node.elements.map(function(node) {
           return variableName(node.inVariable) + " " + keyword(node.ascending ? "ASC" : "DESC"); 
-        }).join(", ");
+        }).join(", ") + (node.limit > 0 ? "   " + annotation("/* top " + node.limit + " rows */") : "");
       case "LimitNode":
         return keyword("LIMIT") + " " + value(JSON.stringify(node.offset)) + ", " + value(JSON.stringify(node.limit)); 
       case "ReturnNode":
@@ -539,8 +592,18 @@ function processQuery (query, explain) {
     var line = " " +  
       pad(1 + maxIdLen - String(node.id).length) + variable(node.id) + "   " +
       keyword(node.type) + pad(1 + maxTypeLen - String(node.type).length) + "   " + 
-      pad(1 + maxEstimateLen - String(node.estimatedNrItems).length) + value(node.estimatedNrItems) + "   " +
-      indent(level, node.type === "SingletonNode") + label(node);
+      pad(1 + maxEstimateLen - String(node.estimatedNrItems).length) + value(node.estimatedNrItems) + "   ";
+
+    if (profile !== undefined) {
+      var p = profileColumns(node);
+      line += 
+        pad(1 + maxCallsLen - p.calls.length) + value(p.calls) + "   " +
+        pad(1 + maxItemsLen - p.items.length) + value(p.items) + "   " +
+        pad(1 + maxTimeLen - p.time.length) + value(p.time) + "   " +
+        pad(1 + maxMemoryLen - p.memory.length) + value(p.memory) + "   ";
+    }
+
+    line += indent(level, node.type === "SingletonNode") + label(node);
 
     if (node.type === "CalculationNode") {
       line += variablesUsed() + constNess();
@@ -556,8 +619,17 @@ function processQuery (query, explain) {
   var line = " " + 
     pad(1 + maxIdLen - String("Id").length) + header("Id") + "   " +
     header("NodeType") + pad(1 + maxTypeLen - String("NodeType").length) + "   " +   
-    pad(1 + maxEstimateLen - String("Est.").length) + header("Est.") + "   " +
-    header("Comment");
+    pad(1 + maxEstimateLen - String("Est.").length) + header("Est.") + "   ";
+
+  if (profile !== undefined) {
+    line += 
+      pad(1 + maxCallsLen - String("Calls").length) + header("Calls") + "   " +
+      pad(1 + maxItemsLen - String("Items").length) + header("Items") + "   " +
+      pad(1 + maxTimeLen - String("Runtime").length) + header("Runtime") + "   " +
+      pad(1 + maxMemoryLen - String("Memory").length) + header("Memory") + "   ";
+  }
+
+  line += header("Comment");
   print(line);
 
 
@@ -603,6 +675,51 @@ function explain (data, options) {
   print();
 }
 
+/* the exposed profiling function */
+function profileQuery (data, options) { 
+  'use strict';
+  if (typeof data === "string") {
+    data = { query: data };
+  }
+  if (! (data instanceof Object)) {
+    throw "ArangoStatement needs initial data";
+  }
+
+  options = options || { };
+  setColors(options.colors === undefined ? true : options.colors);
+
+  var stmt = db._createStatement(data);
+  var result = stmt.explain(options);
+
+  /* execute the query with profiling turned on, using a separate statement
+     so the explain options do not leak into the execution */
+  var execOptions = { };
+  if (data.options instanceof Object) {
+    Object.keys(data.options).forEach(function(o) {
+      execOptions[o] = data.options[o];
+    });
+  }
+  execOptions.profile = true;
+
+  var cursor = db._createStatement({ 
+    query: data.query, 
+    bindVars: data.bindVars, 
+    options: execOptions 
+  }).execute();
+
+  var nodes = { }, extra = cursor.getExtra();
+  if (extra.profile && Array.isArray(extra.profile.nodes)) {
+    extra.profile.nodes.forEach(function(node) {
+      nodes[node.id] = node;
+    });
+  }
+
+  print();
+  processQuery(data.query, result, nodes);
+  print();
+}
+
 exports.explain = explain;
+exports.profile = profileQuery;
 
 });
@@ -70,6 +70,8 @@ function FiguresSuite () {
       assertEqual(0, f.dead.count);
       assertEqual(0, f.dead.size);
       assertEqual(0, f.dead.deletion);
+      assertEqual(0, f.masterPointers.count);
+      assertEqual(0, f.masterPointers.size);
 
       var d1 = c1.save({ hello : 1 });
 
@@ -119,6 +121,8 @@ function FiguresSuite () {
       assertEqual(0, f.dead.count);
       assertEqual(0, f.dead.size);
       assertEqual(0, f.dead.deletion);
+      assertEqual(2, f.masterPointers.count);
+      assertTrue(f.masterPointers.size > 0);
 
       c1.remove(d1);
 
@@ -185,6 +189,35 @@ function FiguresSuite () {
       db._drop(collection);
     },
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check master pointer memory is given back
+////////////////////////////////////////////////////////////////////////////////
+
+    testFiguresMasterPointers : function () {
+      var collection = "UnitTestsCollectionFigures";
+
+      db._drop(collection);
+      var c1 = db._create(collection);
+      var i;
+
+      for (i = 0; i < 20000; ++i) {
+        c1.save({ value : i });
+      }
+
+      var f = c1.figures();
+      assertEqual(20000, f.masterPointers.count);
+      var size = f.masterPointers.size;
+      assertTrue(size > 0);
+
+      c1.truncate();
+
+      f = c1.figures();
+      assertEqual(0, f.masterPointers.count);
+      assertTrue(f.masterPointers.size < size / 2);
+
+      db._drop(collection);
+    },
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief check figures
 ////////////////////////////////////////////////////////////////////////////////
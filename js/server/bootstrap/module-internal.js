@@ -125,6 +125,15 @@ exports.wal = {
   }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief statistics about the pool of V8 contexts
+////////////////////////////////////////////////////////////////////////////////
+
+if (global.V8_CONTEXT_STATISTICS) {
+  exports.v8ContextStatistics = global.V8_CONTEXT_STATISTICS;
+  delete global.V8_CONTEXT_STATISTICS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief defines an action
 ////////////////////////////////////////////////////////////////////////////////
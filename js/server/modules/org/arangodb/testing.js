@@ -235,6 +235,7 @@ function makeTestingArgs (appDir) {
            "javascript.startup-directory":   fs.join(topDir, "js"),
            "ruby.modules-path":              fs.join(topDir,"mr", "common", "modules"),
            "server.threads":                 "20",
+           "server.maximal-pipelined-requests": "8",
            "javascript.v8-contexts":         "5",
            "server.disable-authentication":  "true",
            "server.allow-use-database":      "true" };
@@ -0,0 +1,61 @@
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory used per document for master pointers and the primary index
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var internal = require("internal");
+
+var db = internal.db;
+
+var colName = "perf_master_pointers";
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts small documents and reports the memory per million documents
+////////////////////////////////////////////////////////////////////////////////
+
+var run = function (n) {
+  internal.db._drop(colName);
+  var c = internal.db._create(colName);
+  var i;
+
+  for (i = 0; i < n; ++i) {
+    c.save({ value: i });
+  }
+
+  var f = c.figures();
+  var perMillion = function (bytes) {
+    return (bytes * 1000000 / n / (1024 * 1024)).toFixed(1) + " MB";
+  };
+
+  internal.print(n + " documents: " +
+                 "master pointers " + perMillion(f.masterPointers.size) +
+                 " (" + (f.masterPointers.size / f.masterPointers.count).toFixed(1) + " bytes per document), " +
+                 "indexes " + perMillion(f.indexes.size) +
+                 " per million documents");
+
+  internal.db._drop(colName);
+};
+
+[ 100000, 1000000 ].forEach(run);
@@ -0,0 +1,208 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertTrue, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for skiplist index statistics used by the optimizer
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("org/arangodb").db;
+var internal = require("internal");
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerIndexStatisticsTestSuite () {
+  var c;
+
+  var skiplistIndex = function (fields) {
+    return c.getIndexes().filter(function(idx) {
+      return idx.type === "skiplist" && JSON.stringify(idx.fields) === JSON.stringify(fields);
+    })[0];
+  };
+
+  // the statistics are refreshed by the cleanup thread, so estimates lag
+  // behind modifications for a moment
+  var waitForEstimate = function (fields, condition) {
+    var estimate;
+
+    for (var i = 0; i < 200; ++i) {
+      estimate = skiplistIndex(fields).selectivityEstimate;
+      if (condition(estimate)) {
+        break;
+      }
+      internal.wait(0.1, false);
+    }
+
+    return estimate;
+  };
+
+  var indexNodes = function (query) {
+    return AQL_EXPLAIN(query).plan.nodes.filter(function(node) {
+      return node.type === "IndexRangeNode";
+    });
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsCollection");
+      c = db._create("UnitTestsCollection");
+
+      for (var i = 0; i < 1000; ++i) {
+        c.save({ value: i, low: i % 2, group: i % 10, text: "test" + i });
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsCollection");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the selectivity estimates of skiplist indexes
+////////////////////////////////////////////////////////////////////////////////
+
+    testSelectivityEstimate : function () {
+      c.ensureSkiplist("value");
+      c.ensureSkiplist("group");
+      c.ensureSkiplist("group", "value");
+
+      assertEqual(1, skiplistIndex([ "value" ]).selectivityEstimate);
+      assertEqual(0.01, skiplistIndex([ "group" ]).selectivityEstimate);
+      assertEqual(1, skiplistIndex([ "group", "value" ]).selectivityEstimate);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the statistics follow modifications
+////////////////////////////////////////////////////////////////////////////////
+
+    testSelectivityEstimateAfterModifications : function () {
+      c.ensureSkiplist("group");
+      assertEqual(0.01, skiplistIndex([ "group" ]).selectivityEstimate);
+
+      for (var i = 0; i < 3000; ++i) {
+        c.save({ value: 1000 + i, group: 1000 + i });
+      }
+
+      var estimate = waitForEstimate([ "group" ], function (estimate) {
+        return estimate > 0.5;
+      });
+      assertTrue(estimate > 0.5, estimate);
+
+      c.toArray().forEach(function(doc) {
+        if (doc.value >= 1000) {
+          c.remove(doc);
+        }
+      });
+
+      estimate = waitForEstimate([ "group" ], function (estimate) {
+        return estimate < 0.5;
+      });
+      assertTrue(estimate >= 0.01 && estimate < 0.5, estimate);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the more selective index is chosen for equality lookups
+////////////////////////////////////////////////////////////////////////////////
+
+    testChooseSelectiveEqualityIndex : function () {
+      c.ensureSkiplist("low");
+      c.ensureSkiplist("value");
+
+      var query = "FOR i IN " + c.name() + " FILTER i.low == 1 && i.value == 17 RETURN i.value";
+      var nodes = indexNodes(query);
+
+      assertEqual(1, nodes.length);
+      assertEqual([ "value" ], nodes[0].index.fields);
+      assertEqual([ 17 ], AQL_EXECUTE(query).json);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that range estimates use the histogram
+////////////////////////////////////////////////////////////////////////////////
+
+    testRangeEstimates : function () {
+      c.ensureSkiplist("value");
+
+      var nodes = indexNodes("FOR i IN " + c.name() + " FILTER i.value > 990 RETURN i");
+      assertEqual(1, nodes.length);
+      assertTrue(nodes[0].estimatedNrItems <= 30, nodes[0].estimatedNrItems);
+
+      nodes = indexNodes("FOR i IN " + c.name() + " FILTER i.value >= 100 RETURN i");
+      assertEqual(1, nodes.length);
+      assertTrue(nodes[0].estimatedNrItems >= 800, nodes[0].estimatedNrItems);
+
+      nodes = indexNodes("FOR i IN " + c.name() + " FILTER i.value >= 100 && i.value < 200 RETURN i");
+      assertEqual(1, nodes.length);
+      assertTrue(nodes[0].estimatedNrItems >= 70 && nodes[0].estimatedNrItems <= 130, nodes[0].estimatedNrItems);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the more selective index is chosen for range lookups
+////////////////////////////////////////////////////////////////////////////////
+
+    testChooseSelectiveRangeIndex : function () {
+      c.ensureSkiplist("value");
+      c.ensureSkiplist("group");
+
+      var query = "FOR i IN " + c.name() + " FILTER i.group > 0 && i.value > 995 RETURN i.value";
+      var nodes = indexNodes(query);
+
+      assertEqual(1, nodes.length);
+      assertEqual([ "value" ], nodes[0].index.fields);
+      assertEqual([ 996, 997, 998, 999 ], AQL_EXECUTE(query).json.sort());
+
+      query = "FOR i IN " + c.name() + " FILTER i.group > 8 && i.value > 5 RETURN i.value";
+      nodes = indexNodes(query);
+
+      assertEqual(1, nodes.length);
+      assertEqual([ "group" ], nodes[0].index.fields);
+      assertEqual(100, AQL_EXECUTE(query).json.length);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerIndexStatisticsTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,155 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertTrue, assertEqual, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rules
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2010-2014 triagens GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is triAGENS GmbH, Cologne, Germany
+///
+/// @author 
+/// @author Copyright 2014, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var db = require("org/arangodb").db;
+var jsunity = require("jsunity");
+var helper = require("org/arangodb/aql-helper");
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "distribute-collect-to-cluster";
+  // various choices to control the optimizer: 
+  var rulesAll         = { optimizer: { rules: [ "+all" ] } };
+  var thisRuleDisabled = { optimizer: { rules: [ "+all", "-" + ruleName ] } };
+
+  var cn1 = "UnitTestsAqlOptimizerRuleDistributeCollect1";
+  var c1;
+  
+  var explain = function (result) {
+    return helper.getCompactPlan(result).map(function(node) 
+        { return node.type; });
+  };
+
+  var sortResult = function (result) {
+    return result.sort(function (l, r) {
+      return JSON.stringify(l) < JSON.stringify(r) ? -1 : 1;
+    });
+  };
+
+  return {
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief set up
+    ////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      var i;
+      db._drop(cn1);
+      c1 = db._create(cn1, {numberOfShards:5});
+      for (i = 0; i < 100; i++){ 
+        c1.insert({ value: i, group: i % 7 });
+      }
+    },
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief tear down
+    ////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop(cn1);
+    },
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief test that rule has no effect
+    ////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [ 
+        "FOR d IN " + cn1 + " COLLECT g = d.group INTO x RETURN [ g, LENGTH(x) ]",
+        "FOR d IN " + cn1 + " COLLECT g = d.group INTO x = d.value RETURN [ g, x ]",
+        "FOR i IN 1..10 COLLECT g = i % 2 RETURN g"
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, rulesAll);
+        assertTrue(result.plan.rules.indexOf(ruleName) === -1, query);
+      });
+    },
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief test that rule has an effect
+    ////////////////////////////////////////////////////////////////////////////////
+
+    testRuleHasEffect : function () {
+      var queries = [ 
+        "FOR d IN " + cn1 + " COLLECT g = d.group RETURN g",
+        "FOR d IN " + cn1 + " COLLECT g = d.group, h = d.value % 2 RETURN [ g, h ]",
+        "FOR d IN " + cn1 + " COLLECT g = d.group WITH COUNT INTO c RETURN [ g, c ]",
+        "FOR d IN " + cn1 + " FILTER d.value > 50 COLLECT g = d.group WITH COUNT INTO c RETURN [ g, c ]",
+        "FOR d IN " + cn1 + " COLLECT WITH COUNT INTO c RETURN c",
+        "FOR d IN " + cn1 + " FILTER d.value > 1000 COLLECT WITH COUNT INTO c RETURN c"
+      ];
+
+      queries.forEach(function(query) {
+        var resultEnabled  = AQL_EXPLAIN(query, { }, rulesAll);
+        var resultDisabled = AQL_EXPLAIN(query, { }, thisRuleDisabled);
+        assertTrue(resultEnabled.plan.rules.indexOf(ruleName)  !== -1, query);
+        assertTrue(resultDisabled.plan.rules.indexOf(ruleName) === -1, query);
+
+        // there is one COLLECT on the DBservers and one on the coordinator
+        var nodes = explain(resultEnabled);
+        var remote = nodes.lastIndexOf("RemoteNode");
+        assertEqual("AggregateNode", nodes[remote - 1], query);
+        assertEqual("GatherNode", nodes[remote + 1], query);
+        assertEqual("AggregateNode", nodes[remote + 2], query);
+
+        var enabled  = AQL_EXECUTE(query, { }, rulesAll).json;
+        var disabled = AQL_EXECUTE(query, { }, thisRuleDisabled).json;
+        assertEqual(sortResult(disabled), sortResult(enabled), query);
+      });
+    },
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief test the results of a split COLLECT
+    ////////////////////////////////////////////////////////////////////////////////
+
+    testResults : function () {
+      var result = AQL_EXECUTE("FOR d IN " + cn1 + " COLLECT g = d.group WITH COUNT INTO c RETURN [ g, c ]", { }, rulesAll).json;
+      assertEqual([ [ 0, 15 ], [ 1, 15 ], [ 2, 14 ], [ 3, 14 ], [ 4, 14 ], [ 5, 14 ], [ 6, 14 ] ], result);
+
+      result = AQL_EXECUTE("FOR d IN " + cn1 + " COLLECT WITH COUNT INTO c RETURN c", { }, rulesAll).json;
+      assertEqual([ 100 ], result);
+
+      result = AQL_EXECUTE("FOR d IN " + cn1 + " COLLECT g = d.group RETURN g", { }, rulesAll).json;
+      assertEqual([ 0, 1, 2, 3, 4, 5, 6 ], result);
+    }
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
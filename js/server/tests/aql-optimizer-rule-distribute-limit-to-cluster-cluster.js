@@ -0,0 +1,136 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertTrue, assertEqual, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rules
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2010-2014 triagens GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is triAGENS GmbH, Cologne, Germany
+///
+/// @author 
+/// @author Copyright 2014, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var db = require("org/arangodb").db;
+var jsunity = require("jsunity");
+var helper = require("org/arangodb/aql-helper");
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "distribute-limit-to-cluster";
+  // various choices to control the optimizer: 
+  var rulesAll         = { optimizer: { rules: [ "+all" ] } };
+  var thisRuleDisabled = { optimizer: { rules: [ "+all", "-" + ruleName ] } };
+
+  var cn1 = "UnitTestsAqlOptimizerRuleDistributeLimit1";
+  var c1;
+  
+  var explain = function (result) {
+    return helper.getCompactPlan(result).map(function(node) 
+        { return node.type; });
+  };
+
+  return {
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief set up
+    ////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      var i;
+      db._drop(cn1);
+      c1 = db._create(cn1, {numberOfShards:5});
+      for (i = 0; i < 100; i++){ 
+        c1.insert({ value: i });
+      }
+    },
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief tear down
+    ////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop(cn1);
+    },
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief test that rule has no effect
+    ////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [ 
+        "FOR i IN 1..10 LIMIT 2 RETURN i",
+        "FOR d IN " + cn1 + " SORT d.value LIMIT 2 RETURN d.value",
+        "FOR d IN " + cn1 + " FILTER d.value > 10 LIMIT 2 RETURN d.value"
+      ];
+
+      queries.forEach(function(query) {
+        // the shards must produce all documents for the full count
+        var result = AQL_EXPLAIN(query, { }, { fullCount: true, optimizer: { rules: [ "+all" ] } });
+        assertTrue(result.plan.rules.indexOf(ruleName) === -1, query);
+      });
+
+      var result = AQL_EXPLAIN(queries[0], { }, rulesAll);
+      assertTrue(result.plan.rules.indexOf(ruleName) === -1, queries[0]);
+    },
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief test that rule has an effect
+    ////////////////////////////////////////////////////////////////////////////////
+
+    testRuleHasEffect : function () {
+      var queries = [ 
+        [ "FOR d IN " + cn1 + " SORT d.value LIMIT 2 RETURN d.value", [ 0, 1 ] ],
+        [ "FOR d IN " + cn1 + " SORT d.value DESC LIMIT 5, 3 RETURN d.value", [ 94, 93, 92 ] ],
+        [ "FOR d IN " + cn1 + " FILTER d.value >= 10 SORT d.value LIMIT 10, 5 RETURN d.value", [ 20, 21, 22, 23, 24 ] ],
+        [ "FOR d IN " + cn1 + " SORT d.value LIMIT 98, 10 RETURN d.value", [ 98, 99 ] ],
+        [ "FOR d IN " + cn1 + " SORT d.value LIMIT 0 RETURN d.value", [ ] ]
+      ];
+
+      queries.forEach(function(query) {
+        var resultEnabled  = AQL_EXPLAIN(query[0], { }, rulesAll);
+        var resultDisabled = AQL_EXPLAIN(query[0], { }, thisRuleDisabled);
+        assertTrue(resultEnabled.plan.rules.indexOf(ruleName)  !== -1, query[0]);
+        assertTrue(resultDisabled.plan.rules.indexOf(ruleName) === -1, query[0]);
+
+        // the limit is applied on the DBservers and on the coordinator
+        var nodes = explain(resultEnabled);
+        var remote = nodes.lastIndexOf("RemoteNode");
+        assertEqual("LimitNode", nodes[remote - 1], query[0]);
+        assertEqual("GatherNode", nodes[remote + 1], query[0]);
+        assertEqual("LimitNode", nodes[remote + 2], query[0]);
+
+        assertEqual(query[1], AQL_EXECUTE(query[0], { }, rulesAll).json, query[0]);
+        assertEqual(query[1], AQL_EXECUTE(query[0], { }, thisRuleDisabled).json, query[0]);
+      });
+    }
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
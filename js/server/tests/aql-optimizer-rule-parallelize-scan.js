@@ -0,0 +1,185 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rules
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("org/arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "parallelize-scan";
+  // various choices to control the optimizer:
+  var paramNone     = { optimizer: { rules: [ "-all" ] } };
+  var paramEnabled  = { optimizer: { rules: [ "-all", "+" + ruleName ] } };
+  var c;
+
+  var parallelScans = function (plan) {
+    var result = [ ];
+    plan.nodes.forEach(function(node) {
+      if (node.type === "EnumerateCollectionNode") {
+        result.push(node.parallel);
+      }
+    });
+    return result;
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsCollection");
+      c = db._create("UnitTestsCollection");
+
+      for (var i = 0; i < 20000; ++i) {
+        c.save({ value: i, group: i % 7, text: "test" + i, sub: { flag: (i % 3 === 0) } });
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsCollection");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has no effect when explicitly disabled
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleDisabled : function () {
+      var query = "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN i";
+
+      var result = AQL_EXPLAIN(query, { }, paramNone);
+      assertEqual(-1, result.plan.rules.indexOf(ruleName), query);
+      assertEqual([ false ], parallelScans(result.plan), query);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has no effect
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " RETURN i", // no filter
+        "FOR i IN " + c.name() + " FILTER i._id == 'foo' RETURN i", // _id needs the resolver
+        "FOR i IN " + c.name() + " FILTER LENGTH(i.text) > 5 RETURN i", // function call
+        "FOR i IN " + c.name() + " FILTER i.value IN [ 1, 2 ] RETURN i", // IN
+        "FOR i IN " + c.name() + " FILTER i == null RETURN i", // whole document
+        "FOR i IN " + c.name() + " LET x = i.value FILTER x > 5 RETURN i", // not directly followed by the condition
+        "FOR i IN " + c.name() + " FILTER i.value > RAND() RETURN i", // non-deterministic
+        "FOR j IN 1..2 FOR i IN " + c.name() + " FILTER i.value == j RETURN i" // other variables
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, paramEnabled);
+        assertEqual(-1, result.plan.rules.indexOf(ruleName), query);
+        parallelScans(result.plan).forEach(function(parallel) {
+          assertEqual(false, parallel, query);
+        });
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the rule marks the scan if it is applied. the rule only
+/// applies if the server was started with scan threads
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleMarksScan : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN i",
+        "FOR i IN " + c.name() + " FILTER i.group == 3 && i.sub.flag RETURN i",
+        "FOR i IN " + c.name() + " FILTER ! (i.text == 'test1' || i.value < 100) RETURN i"
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, paramEnabled);
+        var applied = (result.plan.rules.indexOf(ruleName) !== -1);
+        assertEqual([ applied ], parallelScans(result.plan), query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test results and statistics
+////////////////////////////////////////////////////////////////////////////////
+
+    testResults : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN i.value",
+        "FOR i IN " + c.name() + " FILTER i.value < 0 RETURN i.value", // empty result
+        "FOR i IN " + c.name() + " FILTER i.value == 19999 RETURN i.value", // last document only
+        "FOR i IN " + c.name() + " FILTER i.group == 3 && i.sub.flag RETURN i",
+        "FOR i IN " + c.name() + " FILTER i.text >= 'test5' RETURN i.text",
+        "FOR i IN " + c.name() + " FILTER i.missing == null RETURN i.value",
+        "FOR i IN " + c.name() + " FILTER (i.value > 100 ? i.group == 1 : true) SORT i.value DESC RETURN i.value",
+        "FOR i IN " + c.name() + " FILTER i.group != 2 LIMIT 5000, 10 RETURN i.value",
+        "FOR j IN 1..2 LET x = (FOR i IN " + c.name() + " FILTER i.group == 4 RETURN i.value) RETURN LENGTH(x)"
+      ];
+
+      queries.forEach(function(query) {
+        var expected = AQL_EXECUTE(query, { }, paramNone);
+        var actual = AQL_EXECUTE(query, { }, paramEnabled);
+        assertEqual(expected.json, actual.json, query);
+        assertEqual(expected.stats.scannedFull, actual.stats.scannedFull, query);
+        assertEqual(expected.stats.filtered, actual.stats.filtered, query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that documents can be modified after a parallel scan
+////////////////////////////////////////////////////////////////////////////////
+
+    testModify : function () {
+      var query = "FOR i IN " + c.name() + " FILTER i.group == 5 UPDATE i WITH { updated: true } IN " + c.name();
+      var result = AQL_EXECUTE(query, { }, paramEnabled);
+
+      assertEqual(2857, result.stats.writesExecuted);
+      assertEqual(2857, c.byExample({ updated: true }).count());
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
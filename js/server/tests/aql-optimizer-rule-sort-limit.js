@@ -0,0 +1,187 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertNotEqual, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rules
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var helper = require("org/arangodb/aql-helper");
+var db = require("org/arangodb").db;
+var removeAlwaysOnClusterRules = helper.removeAlwaysOnClusterRules;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "sort-limit";
+  // various choices to control the optimizer:
+  var paramNone     = { optimizer: { rules: [ "-all" ] } };
+  var paramEnabled  = { optimizer: { rules: [ "-all", "+" + ruleName ] } };
+  var c;
+
+  var sortLimit = function (plan) {
+    var limits = [ ];
+    plan.nodes.forEach(function(node) {
+      if (node.type === "SortNode") {
+        limits.push(node.limit);
+      }
+    });
+    return limits;
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsCollection");
+      c = db._create("UnitTestsCollection");
+
+      for (var i = 0; i < 3000; ++i) {
+        c.save({ value: i, group: i % 7, text: "test" + i });
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsCollection");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has no effect when explicitly disabled
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleDisabled : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " SORT i.value LIMIT 10 RETURN i",
+        "FOR i IN " + c.name() + " SORT i.value DESC LIMIT 5, 10 RETURN i"
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, paramNone);
+        assertEqual([ ], removeAlwaysOnClusterRules(result.plan.rules), query);
+        assertEqual([ 0 ], sortLimit(result.plan), query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has no effect
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " SORT i.value RETURN i", // no limit
+        "FOR i IN " + c.name() + " LIMIT 10 SORT i.value RETURN i", // limit before sort
+        "FOR i IN " + c.name() + " SORT i.value FILTER i.group == 1 LIMIT 10 RETURN i", // filter in between
+        "FOR i IN " + c.name() + " SORT i.value LIMIT 0 RETURN i" // nothing to produce
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, paramEnabled);
+        assertEqual(-1, result.plan.rules.indexOf(ruleName), query);
+        assertEqual([ 0 ], sortLimit(result.plan), query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has no effect if the full count is requested
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffectFullCount : function () {
+      var query = "FOR i IN " + c.name() + " SORT i.value LIMIT 10 RETURN i";
+      var result = AQL_EXPLAIN(query, { }, { fullCount: true, optimizer: { rules: [ "-all", "+" + ruleName ] } });
+      assertEqual(-1, result.plan.rules.indexOf(ruleName), query);
+
+      result = AQL_EXECUTE(query, { }, { fullCount: true, optimizer: { rules: [ "-all", "+" + ruleName ] } });
+      assertEqual(10, result.json.length);
+      assertEqual(3000, result.stats.fullCount);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has an effect
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleHasEffect : function () {
+      var queries = [
+        [ "FOR i IN " + c.name() + " SORT i.value LIMIT 10 RETURN i", 10 ],
+        [ "FOR i IN " + c.name() + " SORT i.value DESC LIMIT 5, 10 RETURN i", 15 ],
+        [ "FOR i IN " + c.name() + " SORT i.group, i.value LIMIT 1 RETURN i", 1 ],
+        [ "FOR i IN " + c.name() + " SORT i.value LET x = i.value * 2 LIMIT 3 RETURN x", 3 ],
+        [ "FOR i IN 1..100 SORT i DESC LIMIT 2, 3 RETURN i", 5 ]
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query[0], { }, paramEnabled);
+        assertNotEqual(-1, result.plan.rules.indexOf(ruleName), query[0]);
+        assertEqual([ query[1] ], sortLimit(result.plan), query[0]);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test results
+////////////////////////////////////////////////////////////////////////////////
+
+    testResults : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " SORT i.value LIMIT 10 RETURN i.value",
+        "FOR i IN " + c.name() + " SORT i.value DESC LIMIT 10 RETURN i.value",
+        "FOR i IN " + c.name() + " SORT i.value DESC LIMIT 995, 20 RETURN i.value",
+        "FOR i IN " + c.name() + " SORT i.text LIMIT 100 RETURN i.text",
+        "FOR i IN " + c.name() + " SORT i.group DESC, i.value LIMIT 17 RETURN [ i.group, i.value ]",
+        "FOR i IN " + c.name() + " SORT i.value LIMIT 1500, 1200 RETURN i.value", // more than one batch
+        "FOR i IN " + c.name() + " SORT i.value LIMIT 2990, 100 RETURN i.value", // limit exceeds input
+        "FOR i IN " + c.name() + " FILTER i.value < 0 SORT i.value LIMIT 10 RETURN i.value", // empty input
+        "FOR j IN 1..3 LET x = (FOR i IN " + c.name() + " FILTER i.group == j SORT i.value DESC LIMIT 3 RETURN i.value) RETURN x"
+      ];
+
+      queries.forEach(function(query) {
+        var expected = AQL_EXECUTE(query, { }, paramNone).json;
+        var actual = AQL_EXECUTE(query, { }, paramEnabled).json;
+        assertEqual(expected, actual, query);
+      });
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
@@ -0,0 +1,181 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertNotEqual, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rules
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var helper = require("org/arangodb/aql-helper");
+var db = require("org/arangodb").db;
+var removeAlwaysOnClusterRules = helper.removeAlwaysOnClusterRules;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "use-index-only";
+  // various choices to control the optimizer:
+  var paramIndex    = { optimizer: { rules: [ "-all", "+use-index-range", "+remove-filter-covered-by-index" ] } };
+  var paramEnabled  = { optimizer: { rules: [ "-all", "+use-index-range", "+remove-filter-covered-by-index", "+" + ruleName ] } };
+  var c;
+
+  var indexOnly = function (plan) {
+    var result = [ ];
+    plan.nodes.forEach(function(node) {
+      if (node.type === "IndexRangeNode") {
+        result.push(node.indexOnly);
+      }
+    });
+    return result;
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsCollection");
+      c = db._create("UnitTestsCollection");
+      c.ensureSkiplist("value");
+      c.ensureHashIndex("group", "sub.name");
+
+      for (var i = 0; i < 2000; ++i) {
+        c.save({ value: i, group: i % 7, sub: { name: "test" + (i % 3), other: i }, text: "this is a longer string value " + i });
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsCollection");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has no effect when explicitly disabled
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleDisabled : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN i.value",
+        "FOR i IN " + c.name() + " FILTER i.group == 1 && i.sub.name == 'test1' RETURN i.group"
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, paramIndex);
+        assertEqual(-1, removeAlwaysOnClusterRules(result.plan.rules).indexOf(ruleName), query);
+        assertEqual([ false ], indexOnly(result.plan), query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has no effect
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN i", // whole document
+        "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN i.group", // not indexed
+        "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN i._key", // system attribute
+        "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN MERGE(i, { })", // function argument
+        "FOR i IN " + c.name() + " FILTER i.group == 1 && i.sub.name == 'test1' RETURN i.sub", // parent of indexed attribute
+        "FOR i IN " + c.name() + " FILTER i.group == 1 && i.sub.name == 'test1' RETURN i.sub.other", // sibling of indexed attribute
+        "FOR i IN " + c.name() + " FILTER i.value > 10 LET x = (FOR j IN 1..2 RETURN i.value) RETURN x", // subquery
+        "FOR i IN " + c.name() + " FILTER i.value > 10 COLLECT v = i.value INTO g RETURN v", // whole document in INTO
+        "FOR i IN " + c.name() + " FILTER i.value > 1990 UPDATE i WITH { foo: 1 } IN " + c.name() // modification
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, paramEnabled);
+        assertEqual(-1, result.plan.rules.indexOf(ruleName), query);
+        assertEqual([ false ], indexOnly(result.plan), query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has an effect
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleHasEffect : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN i.value",
+        "FOR i IN " + c.name() + " FILTER i.value > 10 && i.value < 20 SORT i.value DESC RETURN { v: i.value }",
+        "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN 1",
+        "FOR i IN " + c.name() + " FILTER i.group == 1 && i.sub.name == 'test1' RETURN [ i.group, i.sub.name ]",
+        "FOR i IN " + c.name() + " FILTER i.group == 1 && i.sub.name == 'test1' RETURN LENGTH(i.sub.name)",
+        "FOR i IN " + c.name() + " FILTER i.value > 10 COLLECT v = i.value % 10 WITH COUNT INTO n RETURN [ v, n ]"
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, paramEnabled);
+        assertNotEqual(-1, result.plan.rules.indexOf(ruleName), query);
+        assertEqual([ true ], indexOnly(result.plan), query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test results
+////////////////////////////////////////////////////////////////////////////////
+
+    testResults : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " FILTER i.value > 10 RETURN i.value",
+        "FOR i IN " + c.name() + " FILTER i.value >= 1500 RETURN { v: i.value, x: i.value * 2 }",
+        "FOR i IN " + c.name() + " FILTER i.value > 10 && i.value < 20 SORT i.value DESC RETURN i.value",
+        "FOR i IN " + c.name() + " FILTER i.group == 1 && i.sub.name == 'test1' RETURN [ i.group, i.sub.name ]",
+        "FOR i IN " + c.name() + " FILTER i.group IN [ 1, 2 ] && i.sub.name == 'test2' RETURN [ i.group, i.sub.name ]",
+        "FOR i IN " + c.name() + " FILTER i.value > 100 COLLECT v = i.value % 10 WITH COUNT INTO n RETURN [ v, n ]",
+        "FOR i IN " + c.name() + " FILTER i.value > 100 LIMIT 5, 10 RETURN i.value",
+        "FOR j IN 1..3 FOR i IN " + c.name() + " FILTER i.value == j RETURN i.value"
+      ];
+
+      queries.forEach(function(query) {
+        // both plans iterate over the same index in the same order
+        var expected = AQL_EXECUTE(query, { }, paramIndex).json;
+        var actual = AQL_EXECUTE(query, { }, paramEnabled).json;
+        assertEqual(expected, actual, query);
+      });
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
@@ -0,0 +1,204 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertTrue, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for index unions and intersections
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("org/arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleMultiIndexTestSuite () {
+  var ruleName = "use-index-range";
+  // various choices to control the optimizer:
+  var paramNone     = { optimizer: { rules: [ "-all" ] } };
+  var paramEnabled  = { optimizer: { rules: [ "-all", "+" + ruleName ] } };
+  var paramAllPlans = { optimizer: { rules: [ "-all", "+" + ruleName ] }, allPlans: true };
+  var c;
+
+  var multiIndexNodes = function (plan) {
+    var result = [ ];
+    plan.nodes.forEach(function(node) {
+      if (node.type === "IndexRangeNode" && node.hasOwnProperty("otherLookups")) {
+        result.push({ lookups: node.otherLookups.length + 1, intersect: node.intersect });
+      }
+    });
+    return result;
+  };
+
+  var hasMultiIndexPlan = function (query, intersect) {
+    var plans = AQL_EXPLAIN(query, { }, paramAllPlans).plans;
+    return plans.some(function(plan) {
+      return multiIndexNodes(plan).some(function(node) {
+        return node.intersect === intersect;
+      });
+    });
+  };
+
+  var sorted = function (values) {
+    return values.sort(function(l, r) { return l - r; });
+  };
+
+  var unionQueries = [
+    "FOR i IN UnitTestsCollection FILTER i.a == 1 || i.b == 'b3' RETURN i.a",
+    "FOR i IN UnitTestsCollection FILTER i.a == 3 || i.b == 'b3' RETURN i.a", // overlapping
+    "FOR i IN UnitTestsCollection FILTER i.a == 1 || i.b == 'b3' || i.d == 7 RETURN i.a",
+    "FOR i IN UnitTestsCollection FILTER i.c == 3 || i.b == 'b4' RETURN i.a",
+    "FOR i IN UnitTestsCollection FILTER i.c > 18 || i.a == 1 || i.a == 500 RETURN i.a",
+    "FOR i IN UnitTestsCollection FILTER i.b == 'b3' || i.b == 'b4' || i.d == 2 RETURN i.a"
+  ];
+
+  var intersectionQueries = [
+    "FOR i IN UnitTestsCollection FILTER i.b == 'b3' && i.d == 3 RETURN i.a",
+    "FOR i IN UnitTestsCollection FILTER i.b == 'b3' && i.d == 4 RETURN i.a", // empty
+    "FOR i IN UnitTestsCollection FILTER i.b == 'b3' && i.c == 3 RETURN i.a",
+    "FOR i IN UnitTestsCollection FILTER i.d == 3 FILTER i.c >= 10 RETURN i.a"
+  ];
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsCollection");
+      c = db._create("UnitTestsCollection");
+
+      for (var i = 0; i < 1000; ++i) {
+        c.save({ a: i, b: "b" + (i % 50), c: i % 20, d: i % 30 });
+      }
+
+      c.ensureUniqueConstraint("a");
+      c.ensureHashIndex("b");
+      c.ensureHashIndex("d");
+      c.ensureSkiplist("c");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsCollection");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that unions are planned
+////////////////////////////////////////////////////////////////////////////////
+
+    testUnionPlans : function () {
+      unionQueries.forEach(function(query) {
+        assertTrue(hasMultiIndexPlan(query, false), query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that intersections are planned
+////////////////////////////////////////////////////////////////////////////////
+
+    testIntersectionPlans : function () {
+      intersectionQueries.forEach(function(query) {
+        assertTrue(hasMultiIndexPlan(query, true), query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that no multi-index plans are created
+////////////////////////////////////////////////////////////////////////////////
+
+    testNoEffect : function () {
+      var queries = [
+        "FOR i IN UnitTestsCollection FILTER i.a == 1 || i.x == 2 RETURN i", // unindexed branch
+        "FOR i IN UnitTestsCollection FILTER i.a == 1 || i.a == 2 RETURN i", // same index
+        "FOR i IN UnitTestsCollection FILTER i.b == 'b1' && i.x == 2 RETURN i", // single index
+        "FOR i IN UnitTestsCollection FILTER i._key == '1' && i.b == 'b3' RETURN i", // primary index
+        "FOR j IN 1..2 FOR i IN UnitTestsCollection FILTER i.a == j || i.b == 'b1' RETURN i" // dynamic bounds
+      ];
+
+      queries.forEach(function(query) {
+        assertTrue(! hasMultiIndexPlan(query, false), query);
+        assertTrue(! hasMultiIndexPlan(query, true), query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the union is chosen over a full scan
+////////////////////////////////////////////////////////////////////////////////
+
+    testUnionChosen : function () {
+      var query = unionQueries[0];
+      var plan = AQL_EXPLAIN(query, { }, paramEnabled).plan;
+
+      assertEqual([ { lookups: 2, intersect: false } ], multiIndexNodes(plan), query);
+
+      var result = AQL_EXECUTE(query, { }, paramEnabled);
+      assertEqual(0, result.stats.scannedFull);
+      assertEqual(21, result.json.length);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that documents found by multiple lookups are returned once
+////////////////////////////////////////////////////////////////////////////////
+
+    testUnionDeduplicates : function () {
+      var query = unionQueries[1];
+      var result = AQL_EXECUTE(query, { }, paramEnabled).json;
+
+      assertEqual(20, result.length);
+      assertEqual(sorted(result), [ 3, 53, 103, 153, 203, 253, 303, 353, 403, 453, 503, 553, 603, 653, 703, 753, 803, 853, 903, 953 ]);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test results of all plans
+////////////////////////////////////////////////////////////////////////////////
+
+    testResults : function () {
+      unionQueries.concat(intersectionQueries).forEach(function(query) {
+        var expected = sorted(AQL_EXECUTE(query, { }, paramNone).json);
+        var actual = sorted(AQL_EXECUTE(query, { }, paramEnabled).json);
+        assertEqual(expected, actual, query);
+      });
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleMultiIndexTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
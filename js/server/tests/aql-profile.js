@@ -0,0 +1,189 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertTrue, assertUndefined, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for per-node query profiles
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("org/arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function profileTestSuite () {
+  var paramProfile = { profile: true };
+  var c;
+
+  var nodesByType = function (profile, type) {
+    return profile.nodes.filter(function(node) {
+      return node.type === type;
+    });
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsCollection");
+      c = db._create("UnitTestsCollection");
+
+      for (var i = 0; i < 2500; ++i) {
+        c.save({ value: i, text: "test" + i });
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsCollection");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that no node profiles are returned by default
+////////////////////////////////////////////////////////////////////////////////
+
+    testNoProfile : function () {
+      var result = AQL_EXECUTE("FOR i IN " + c.name() + " RETURN i.value");
+
+      assertEqual(2500, result.json.length);
+      assertUndefined(result.profile);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the attributes of the node profiles
+////////////////////////////////////////////////////////////////////////////////
+
+    testProfileAttributes : function () {
+      var result = AQL_EXECUTE("FOR i IN " + c.name() + " RETURN i.value", { }, paramProfile);
+
+      assertEqual(2500, result.json.length);
+      assertTrue(Array.isArray(result.profile.nodes));
+      assertTrue(result.profile.nodes.length > 0);
+
+      result.profile.nodes.forEach(function(node) {
+        assertEqual("number", typeof node.id);
+        assertEqual("string", typeof node.type);
+        assertTrue(node.getSomeCalls >= 0);
+        assertTrue(node.skipSomeCalls >= 0);
+        assertTrue(node.rowsIn >= 0);
+        assertTrue(node.rowsOut >= 0);
+        assertTrue(node.time >= node.selfTime);
+        assertTrue(node.selfTime >= 0);
+        assertTrue(node.cpuTime >= node.selfCpuTime);
+        assertTrue(node.selfCpuTime >= 0);
+        assertTrue(node.peakMemory >= 0);
+      });
+
+      var enumerate = nodesByType(result.profile, "EnumerateCollectionNode");
+      assertEqual(1, enumerate.length);
+      assertEqual(2500, enumerate[0].rowsOut);
+      assertTrue(enumerate[0].getSomeCalls > 1);
+      assertTrue(enumerate[0].peakMemory > 0);
+
+      var ret = nodesByType(result.profile, "ReturnNode");
+      assertEqual(1, ret.length);
+      assertEqual(2500, ret[0].rowsIn);
+      assertEqual(2500, ret[0].rowsOut);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test row counts of filters and limits
+////////////////////////////////////////////////////////////////////////////////
+
+    testProfileRows : function () {
+      var query = "FOR i IN " + c.name() + " FILTER i.value >= 1000 LIMIT 10, 20 RETURN i.value";
+      var result = AQL_EXECUTE(query, { }, paramProfile);
+
+      assertEqual(20, result.json.length);
+
+      var filter = nodesByType(result.profile, "FilterNode");
+      assertEqual(1, filter.length);
+      assertTrue(filter[0].rowsIn >= filter[0].rowsOut);
+
+      var limit = nodesByType(result.profile, "LimitNode");
+      assertEqual(1, limit.length);
+      assertEqual(20, limit[0].rowsOut);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that subqueries are profiled
+////////////////////////////////////////////////////////////////////////////////
+
+    testProfileSubquery : function () {
+      var query = "FOR j IN 1..3 LET x = (FOR i IN " + c.name() + " FILTER i.value < j RETURN i.value) RETURN LENGTH(x)";
+      var result = AQL_EXECUTE(query, { }, paramProfile);
+
+      assertEqual([ 1, 2, 3 ], result.json);
+
+      var subquery = nodesByType(result.profile, "SubqueryNode");
+      assertEqual(1, subquery.length);
+      assertEqual(3, subquery[0].rowsIn);
+      assertEqual(3, subquery[0].rowsOut);
+
+      var enumerate = nodesByType(result.profile, "EnumerateCollectionNode");
+      assertEqual(1, enumerate.length);
+      assertEqual(3 * 2500, enumerate[0].rowsOut);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that profiling does not change results
+////////////////////////////////////////////////////////////////////////////////
+
+    testResults : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " SORT i.value DESC LIMIT 100 RETURN i.value",
+        "FOR i IN " + c.name() + " COLLECT t = i.value % 5 INTO g RETURN [ t, LENGTH(g) ]",
+        "FOR i IN " + c.name() + " FILTER i.value < 10 FOR j IN 1..2 RETURN [ i.value, j ]"
+      ];
+
+      queries.forEach(function(query) {
+        var expected = AQL_EXECUTE(query).json;
+        var actual = AQL_EXECUTE(query, { }, paramProfile).json;
+        assertEqual(expected, actual, query);
+      });
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(profileTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
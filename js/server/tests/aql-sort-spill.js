@@ -0,0 +1,180 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertTrue, assertUndefined, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for sorts that spill to disk
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("org/arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function sortSpillTestSuite () {
+  var paramNone  = { optimizer: { rules: [ "-all" ] } };
+  var paramSpill = { spillThreshold: 500, optimizer: { rules: [ "-all" ] } };
+  var c;
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsCollection");
+      c = db._create("UnitTestsCollection");
+
+      for (var i = 0; i < 3000; ++i) {
+        c.save({ value: (i * 7919) % 3000, group: i % 7, text: "test" + i });
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsCollection");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that nothing is spilled by default
+////////////////////////////////////////////////////////////////////////////////
+
+    testNoSpillByDefault : function () {
+      var query = "FOR i IN " + c.name() + " SORT i.value RETURN i.value";
+      var result = AQL_EXECUTE(query, { }, paramNone);
+
+      assertEqual(3000, result.json.length);
+      assertUndefined(result.stats.spilledBytes);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that nothing is spilled if the input fits
+////////////////////////////////////////////////////////////////////////////////
+
+    testNoSpillBelowThreshold : function () {
+      var query = "FOR i IN " + c.name() + " FILTER i.value < 100 SORT i.value RETURN i.value";
+      var result = AQL_EXECUTE(query, { }, paramSpill);
+
+      assertEqual(100, result.json.length);
+      assertUndefined(result.stats.spilledBytes);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that large sorts are spilled
+////////////////////////////////////////////////////////////////////////////////
+
+    testSpilled : function () {
+      var query = "FOR i IN " + c.name() + " SORT i.value RETURN i.value";
+      var result = AQL_EXECUTE(query, { }, paramSpill);
+
+      assertEqual(3000, result.json.length);
+      assertTrue(result.stats.spilledBytes > 0);
+      for (var i = 0; i < 3000; ++i) {
+        assertEqual(i, result.json[i]);
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test results of spilled sorts
+////////////////////////////////////////////////////////////////////////////////
+
+    testResults : function () {
+      var queries = [
+        "FOR i IN " + c.name() + " SORT i.value DESC RETURN i.value",
+        "FOR i IN " + c.name() + " SORT i.text RETURN i.text",
+        "FOR i IN " + c.name() + " SORT i.group, i.value DESC RETURN [ i.group, i.value ]",
+        "FOR i IN " + c.name() + " SORT i.value RETURN i",
+        "FOR i IN " + c.name() + " SORT i.value LIMIT 1200, 10 RETURN i.value",
+        "FOR i IN " + c.name() + " COLLECT g = i.group INTO x RETURN [ g, LENGTH(x) ]",
+        "FOR j IN 1..2 LET x = (FOR i IN " + c.name() + " SORT i.value DESC RETURN i.value) RETURN x[j]"
+      ];
+
+      queries.forEach(function(query) {
+        var expected = AQL_EXECUTE(query, { }, paramNone).json;
+        var actual = AQL_EXECUTE(query, { }, paramSpill).json;
+        assertEqual(expected, actual, query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test sorts that write more runs than are merged at once
+////////////////////////////////////////////////////////////////////////////////
+
+    testManyRuns : function () {
+      var query = "FOR i IN 1..40000 SORT (i * 7919) % 40000 RETURN (i * 7919) % 40000";
+      var result = AQL_EXECUTE(query, { }, { spillThreshold: 1000, optimizer: { rules: [ "-all" ] } });
+
+      assertEqual(40000, result.json.length);
+      assertTrue(result.stats.spilledBytes > 0);
+      for (var i = 0; i < 40000; ++i) {
+        assertEqual(i, result.json[i]);
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test sorts on several attributes with many runs
+////////////////////////////////////////////////////////////////////////////////
+
+    testManyRunsMultipleAttributes : function () {
+      var query = "FOR i IN 1..40000 SORT i % 3, i DESC RETURN i";
+      var expected = AQL_EXECUTE(query, { }, paramNone).json;
+      var actual = AQL_EXECUTE(query, { }, { spillThreshold: 1000, optimizer: { rules: [ "-all" ] } }).json;
+
+      assertEqual(expected, actual);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that spilled documents can be modified
+////////////////////////////////////////////////////////////////////////////////
+
+    testModifySpilled : function () {
+      var query = "FOR i IN " + c.name() + " SORT i.value UPDATE i WITH { updated: true } IN " + c.name();
+      var result = AQL_EXECUTE(query, { }, paramSpill);
+
+      assertEqual(3000, result.stats.writesExecuted);
+      assertTrue(result.stats.spilledBytes > 0);
+      assertEqual(3000, c.byExample({ updated: true }).count());
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(sortSpillTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,195 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for subquery memoization
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("org/arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function subqueryMemoizationTestSuite () {
+  var paramNone = { optimizer: { rules: [ "-all" ] } };
+  var c;
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsCollection");
+      c = db._create("UnitTestsCollection");
+
+      for (var i = 0; i < 100; ++i) {
+        c.save({ value: i, group: i % 4 });
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsCollection");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a constant subquery is executed once
+////////////////////////////////////////////////////////////////////////////////
+
+    testConstant : function () {
+      var query = "FOR i IN 1..2500 LET x = (FOR d IN " + c.name() + " RETURN d.value) RETURN LENGTH(x)";
+      var result = AQL_EXECUTE(query, { }, paramNone);
+
+      assertEqual(2500, result.json.length);
+      result.json.forEach(function(value) {
+        assertEqual(100, value);
+      });
+      assertEqual(100, result.stats.scannedFull);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a correlated subquery is executed once per outer value
+////////////////////////////////////////////////////////////////////////////////
+
+    testCorrelated : function () {
+      var query = "FOR i IN 1..2500 LET g = i % 4 LET x = (FOR d IN " + c.name() + " FILTER d.group == g RETURN d.value) RETURN [ g, SUM(x) ]";
+      var result = AQL_EXECUTE(query, { }, paramNone);
+
+      assertEqual(2500, result.json.length);
+      result.json.forEach(function(value) {
+        assertEqual(25 * value[0] + 4 * 300, value[1]);
+      });
+      // the results of the first block are reused by all later blocks
+      assertEqual(4 * 100, result.stats.scannedFull);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that distinct outer values each execute the subquery
+////////////////////////////////////////////////////////////////////////////////
+
+    testDistinct : function () {
+      var query = "FOR i IN 0..99 LET x = (FOR d IN " + c.name() + " FILTER d.value == i RETURN d.group) RETURN x";
+      var result = AQL_EXECUTE(query, { }, paramNone);
+
+      assertEqual(100, result.json.length);
+      for (var i = 0; i < 100; ++i) {
+        assertEqual([ i % 4 ], result.json[i]);
+      }
+      assertEqual(100 * 100, result.stats.scannedFull);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a non-deterministic subquery is executed for every row
+////////////////////////////////////////////////////////////////////////////////
+
+    testNonDeterministic : function () {
+      var query = "FOR i IN 1..10 LET x = (FOR d IN " + c.name() + " FILTER RAND() >= 0 RETURN d.value) RETURN LENGTH(x)";
+      var result = AQL_EXECUTE(query, { }, paramNone);
+
+      assertEqual(10, result.json.length);
+      assertEqual(10 * 100, result.stats.scannedFull);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a modifying subquery is executed for every row
+////////////////////////////////////////////////////////////////////////////////
+
+    testModification : function () {
+      var query = "FOR i IN 1..10 LET x = (INSERT { value: 1000 } IN " + c.name() + ") RETURN x";
+      var result = AQL_EXECUTE(query, { }, paramNone);
+
+      assertEqual(10, result.json.length);
+      assertEqual(10, result.stats.writesExecuted);
+      assertEqual(110, c.count());
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test nested subqueries that use variables of the outermost query
+////////////////////////////////////////////////////////////////////////////////
+
+    testNested : function () {
+      var query = "FOR i IN 1..8 LET x = (FOR j IN 1..2 LET y = (FOR d IN " + c.name() + " FILTER d.group == i % 4 RETURN d.value) RETURN SUM(y)) RETURN x";
+      var result = AQL_EXECUTE(query, { }, paramNone);
+
+      assertEqual(8, result.json.length);
+      for (var i = 1; i <= 8; ++i) {
+        var sum = 25 * (i % 4) + 4 * 300;
+        assertEqual([ sum, sum ], result.json[i - 1]);
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that values which only differ in null members, in the order of
+/// attributes or in trailing null array members do not share results
+////////////////////////////////////////////////////////////////////////////////
+
+    testValuesWithEqualSortKeys : function () {
+      var query = "FOR d IN [ { a: null }, { } ] LET s = (RETURN HAS(d, 'a')) RETURN s";
+      assertEqual([ [ true ], [ false ] ], AQL_EXECUTE(query, { }, paramNone).json);
+
+      query = "FOR d IN [ [ 1 ], [ 1, null ], [ 1 ] ] LET s = (RETURN LENGTH(d)) RETURN s";
+      assertEqual([ [ 1 ], [ 2 ], [ 1 ] ], AQL_EXECUTE(query, { }, paramNone).json);
+
+      query = "FOR d IN [ { a: 1, b: 2 }, { b: 2, a: 1 }, { a: 1, b: 2, c: null } ] LET s = (RETURN ATTRIBUTES(d)) RETURN s";
+      assertEqual([ [ [ "a", "b" ] ], [ [ "b", "a" ] ], [ [ "a", "b", "c" ] ] ], AQL_EXECUTE(query, { }, paramNone).json);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that results memoized for later blocks are not reused for
+/// values with an equal sort key
+////////////////////////////////////////////////////////////////////////////////
+
+    testValuesWithEqualSortKeysAcrossBlocks : function () {
+      var query = "FOR i IN 1..2500 LET d = (i <= 2000 ? { a: null } : { }) LET s = (RETURN HAS(d, 'a')) RETURN s[0]";
+      var result = AQL_EXECUTE(query, { }, paramNone).json;
+
+      assertEqual(2500, result.length);
+      for (var i = 0; i < 2500; ++i) {
+        assertEqual(i < 2000, result[i]);
+      }
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(subqueryMemoizationTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
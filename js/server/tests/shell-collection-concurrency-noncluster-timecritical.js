@@ -0,0 +1,217 @@
+/*jshint globalstrict:false, strict:false */
+/*global assertTrue, assertEqual */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test concurrent single-document writes into a collection
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var arangodb = require("org/arangodb");
+var tasks = require("org/arangodb/tasks");
+var testHelper = require("org/arangodb/test-helper").Helper;
+var db = arangodb.db;
+var internal = require("internal");
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                            collection concurrency
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function collectionConcurrencySuite () {
+  'use strict';
+  var cn = "UnitTestsCollectionConcurrency";
+  var numWriters = 8;
+  var perWriter = 1000;
+  var c;
+
+  var cleanupTasks = function () {
+    tasks.get().forEach(function(task) {
+      if (task.id.match(/^UnitTestsConcurrency/)) {
+        try {
+          tasks.unregister(task);
+        }
+        catch (err) {
+        }
+      }
+    });
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief each writer inserts its documents, updates all of them, removes
+/// every other one and then updates a key shared with all other writers
+////////////////////////////////////////////////////////////////////////////////
+
+  var command = function (params) {
+    var collection = require("internal").db[params.cn];
+    var i;
+
+    for (i = 0; i < params.n; ++i) {
+      collection.save({ _key: "w" + params.writer + "-" + i, writer: params.writer, value: i });
+    }
+
+    for (i = 0; i < params.n; ++i) {
+      collection.update("w" + params.writer + "-" + i, { value: i + 1, updated: true });
+    }
+
+    for (i = 0; i < params.n; i += 2) {
+      collection.remove("w" + params.writer + "-" + i);
+    }
+
+    for (i = 0; i < params.n; ++i) {
+      collection.update("shared", { last: params.writer }, true);
+    }
+
+    collection.save({ _key: "done" + params.writer });
+  };
+
+  var runWriters = function () {
+    var i;
+
+    for (i = 0; i < numWriters; ++i) {
+      tasks.register({
+        id: "UnitTestsConcurrency" + i,
+        name: "UnitTestsConcurrency" + i,
+        command: command,
+        offset: 0,
+        params: { cn: cn, writer: i, n: perWriter }
+      });
+    }
+
+    var start = internal.time();
+
+    while (internal.time() - start < 300) {
+      var done = 0;
+
+      for (i = 0; i < numWriters; ++i) {
+        if (c.exists("done" + i)) {
+          ++done;
+        }
+      }
+
+      if (done === numWriters) {
+        break;
+      }
+
+      // readers run between the writers
+      c.byExample({ updated: true }).toArray();
+      internal.wait(0.1, false);
+    }
+  };
+
+  var checkDocuments = function () {
+    var expected = 1 + numWriters + numWriters * perWriter / 2;
+    var i, j;
+
+    assertEqual(expected, c.count());
+    assertEqual(expected, c.toArray().length);
+    assertEqual(numWriters * perWriter / 2, c.byExample({ updated: true }).toArray().length);
+
+    for (i = 0; i < numWriters; ++i) {
+      assertEqual(perWriter / 2, c.byExample({ writer: i }).toArray().length);
+
+      for (j = 1; j < perWriter; j += 2) {
+        var doc = c.document("w" + i + "-" + j);
+        assertEqual(i, doc.writer);
+        assertEqual(j + 1, doc.value);
+        assertTrue(doc.updated);
+      }
+    }
+
+    var shared = c.document("shared");
+    assertTrue(shared.last >= 0 && shared.last < numWriters);
+  };
+
+  return {
+
+    setUp: function () {
+      cleanupTasks();
+      db._drop(cn);
+      c = db._create(cn);
+      c.save({ _key: "shared", last: -1 });
+    },
+
+    tearDown: function () {
+      cleanupTasks();
+      db._drop(cn);
+      c = null;
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief concurrent writes into a collection with non-unique indexes
+////////////////////////////////////////////////////////////////////////////////
+
+    testConcurrentWritesNonUniqueIndexes : function () {
+      c.ensureHashIndex("writer");
+      c.ensureSkiplist("value");
+      c.ensureHashIndex("updated", { sparse: true });
+
+      runWriters();
+      checkDocuments();
+
+      var query = "FOR d IN @@cn FILTER d.value > 0 RETURN d._key";
+      assertEqual(numWriters * perWriter / 2,
+                  db._query(query, { "@cn": cn }).toArray().length);
+
+      internal.wal.flush(true, true);
+      testHelper.waitUnload(c);
+
+      // the documents must have survived the collection of the logfiles
+      checkDocuments();
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes into a collection with a unique index lock it exclusively
+////////////////////////////////////////////////////////////////////////////////
+
+    testConcurrentWritesUniqueIndex : function () {
+      // no document has the attribute, the index only forces the write lock
+      c.ensureUniqueConstraint("unused", { sparse: true });
+
+      runWriters();
+      checkDocuments();
+    }
+
+  };
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                              main
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(collectionConcurrencySuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
@@ -0,0 +1,104 @@
+/*jshint globalstrict:false, strict:false */
+/*global assertEqual, assertTrue */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the V8 context pool statistics
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var internal = require("internal");
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function V8ContextsSuite () {
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the pool statistics
+////////////////////////////////////////////////////////////////////////////////
+
+    testStatistics : function () {
+      var stats = internal.v8ContextStatistics();
+
+      [ "contexts", "minimum", "maximum", "free", "dirty", "busy", "waiting",
+        "waits", "waitTime", "maxWaitTime", "created", "destroyed" ].forEach(function (key) {
+        assertEqual("number", typeof stats[key], key);
+        assertTrue(stats[key] >= 0, key);
+      });
+
+      assertTrue(stats.minimum >= 1);
+      assertTrue(stats.minimum <= stats.maximum);
+      assertTrue(stats.contexts >= stats.minimum);
+      assertTrue(stats.contexts <= stats.maximum);
+      assertTrue(stats.maxWaitTime <= stats.waitTime);
+      assertTrue(stats.free + stats.dirty + stats.busy <= stats.contexts);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the per-context statistics
+////////////////////////////////////////////////////////////////////////////////
+
+    testDetails : function () {
+      var stats = internal.v8ContextStatistics();
+      var ids = { };
+      var busy = 0;
+
+      assertEqual(stats.contexts, stats.details.length);
+
+      stats.details.forEach(function (context) {
+        assertEqual("boolean", typeof context.busy);
+        assertTrue(context.gcRuns >= 0);
+        assertTrue(context.gcTime >= 0);
+        assertTrue(context.maxGcPause <= context.gcTime);
+        assertTrue(context.lastGcPause <= context.maxGcPause);
+
+        ids[context.id] = true;
+        if (context.busy) {
+          ++busy;
+        }
+      });
+
+      assertEqual(stats.contexts, Object.keys(ids).length);
+      assertEqual(stats.busy, busy);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(V8ContextsSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
@@ -0,0 +1,166 @@
+/*jshint globalstrict:false, strict:false */
+/*global assertTrue, assertEqual */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test concurrent writes into the write-ahead log
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var arangodb = require("org/arangodb");
+var tasks = require("org/arangodb/tasks");
+var testHelper = require("org/arangodb/test-helper").Helper;
+var db = arangodb.db;
+var internal = require("internal");
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  wal concurrency
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function walConcurrencySuite () {
+  'use strict';
+  var cn = "UnitTestsWalConcurrency";
+  var numWriters = 8;
+  var perWriter = 2000;
+  var c;
+
+  var cleanupTasks = function () {
+    tasks.get().forEach(function(task) {
+      if (task.id.match(/^UnitTestsWal/)) {
+        try {
+          tasks.unregister(task);
+        }
+        catch (err) {
+        }
+      }
+    });
+  };
+
+  return {
+
+    setUp: function () {
+      cleanupTasks();
+      db._drop(cn);
+      c = db._create(cn);
+    },
+
+    tearDown: function () {
+      cleanupTasks();
+      db._drop(cn);
+      c = null;
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief concurrent writers while the logfile is switched continuously
+////////////////////////////////////////////////////////////////////////////////
+
+    testConcurrentWritesWithLogfileSwitches : function () {
+      var command = function (params) {
+        var collection = require("internal").db[params.cn];
+        var i, text = "";
+
+        for (i = 0; i < params.writer * 10; ++i) {
+          text += "x";
+        }
+
+        for (i = 0; i < params.n; ++i) {
+          collection.save({
+            _key: "w" + params.writer + "-" + i,
+            writer: params.writer,
+            value: i,
+            text: text
+          }, (i % 100 === 0));
+        }
+      };
+
+      var i, j;
+
+      for (i = 0; i < numWriters; ++i) {
+        tasks.register({
+          id: "UnitTestsWal" + i,
+          name: "UnitTestsWal" + i,
+          command: command,
+          offset: 0,
+          params: { cn: cn, writer: i, n: perWriter }
+        });
+      }
+
+      // force logfile switches while the writers are reserving slots
+      var expected = numWriters * perWriter;
+      var switches = 0;
+      var start = internal.time();
+
+      while (c.count() < expected && internal.time() - start < 300) {
+        internal.wal.flush(false, false);
+        ++switches;
+        internal.wait(0.01, false);
+      }
+
+      assertEqual(expected, c.count());
+      assertTrue(switches > 0);
+
+      internal.wal.flush(true, true);
+      testHelper.waitUnload(c);
+
+      // all documents must have survived the collection of the logfiles
+      assertEqual(expected, c.count());
+
+      for (i = 0; i < numWriters; ++i) {
+        assertEqual(perWriter, c.byExample({ writer: i }).count());
+
+        for (j = 0; j < perWriter; j += 97) {
+          var doc = c.document("w" + i + "-" + j);
+          assertEqual(i, doc.writer);
+          assertEqual(j, doc.value);
+          assertEqual(i * 10, doc.text.length);
+        }
+      }
+
+      var fig = c.figures();
+      assertEqual(0, fig.uncollectedLogfileEntries);
+    }
+
+  };
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                              main
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(walConcurrencySuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
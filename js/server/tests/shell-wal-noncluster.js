@@ -339,6 +339,42 @@ function walSuite () {
       assertEqual(0, fig.uncollectedLogfileEntries);
     },
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes spanning several logfiles
+////////////////////////////////////////////////////////////////////////////////
+
+    testWritesAcrossLogfiles : function () {
+      var i, j, value = "";
+
+      for (i = 0; i < 20; ++i) {
+        value += "the quick brown foxx jumped over the lazy dog.";
+      }
+
+      for (i = 0; i < 5; ++i) {
+        for (j = 0; j < 200; ++j) {
+          c.save({ _key: "test" + (i * 200 + j), value: i * 200 + j, text: value });
+        }
+
+        // seal the current logfile so the next batch goes into a new one
+        internal.wal.flush(true, false);
+      }
+
+      internal.wal.flush(true, true);
+
+      testHelper.waitUnload(c);
+
+      assertEqual(1000, c.count());
+      for (i = 0; i < 1000; i += 37) {
+        var doc = c.document("test" + i);
+        assertEqual(i, doc.value);
+        assertEqual(value, doc.text);
+      }
+
+      var fig = c.figures();
+      assertNotEqual("0", fig.lastTick);
+      assertEqual(0, fig.uncollectedLogfileEntries);
+    },
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief oversize marker
 ////////////////////////////////////////////////////////////////////////////////
@@ -128,6 +128,20 @@ namespace triagens {
           return TRI_DeflateStringBuffer(&_buffer, bufferSize);
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compress the buffer using deflate or gzip
+///
+/// compression is given up if the result would exceed maxLength bytes (if
+/// maxLength is not 0). compressed is set to true if the buffer was modified
+////////////////////////////////////////////////////////////////////////////////
+
+        int compress (size_t bufferSize,
+                      bool gzip,
+                      size_t maxLength,
+                      bool& compressed) {
+          return TRI_CompressStringBuffer(&_buffer, bufferSize, gzip, maxLength, &compressed);
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief uncompress the buffer into stringstream out, using zlib-inflate
 ////////////////////////////////////////////////////////////////////////////////
@@ -75,6 +75,14 @@ namespace triagens {
           return _name.c_str();
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of threads in the pool
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t numThreads () const {
+          return _threads.size();
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief dequeue a task
 ////////////////////////////////////////////////////////////////////////////////
@@ -106,6 +106,35 @@ int Utf8Helper::compareUtf8 (char const* left,
   return result;
 }
 
+bool Utf8Helper::appendSortKeyUtf8 (char const* value,
+                                    size_t length,
+                                    std::string& result) const {
+  if (! _coll) {
+    return false;
+  }
+
+  UnicodeString source = UnicodeString::fromUTF8(StringPiece(value, (int32_t) length));
+
+  uint8_t buffer[256];
+  int32_t needed = _coll->getSortKey(source, buffer, (int32_t) sizeof(buffer));
+
+  if (needed <= 0) {
+    return false;
+  }
+
+  if (needed <= (int32_t) sizeof(buffer)) {
+    result.append(reinterpret_cast<char const*>(buffer), needed);
+    return true;
+  }
+
+  // the key did not fit, so produce it again directly in the result
+  size_t const offset = result.size();
+  result.resize(offset + needed);
+  _coll->getSortKey(source, reinterpret_cast<uint8_t*>(&result[offset]), needed);
+
+  return true;
+}
+
 int Utf8Helper::compareUtf16 (const uint16_t* left, size_t leftLength, const uint16_t* right, size_t rightLength) const {
   if (! _coll) {
     LOG_ERROR("no Collator in Utf8Helper::compareUtf16()!");
@@ -550,6 +579,16 @@ int TRI_compare_utf8 (char const* left,
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the collation sort key of an utf8 string
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_AppendSortKeyUtf8 (char const* value,
+                            size_t length,
+                            std::string& result) {
+  return Utf8Helper::DefaultUtf8Helper.appendSortKeyUtf8(value, length, result);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Lowercase the characters in a UTF-8 string (implemented in Basic/Utf8Helper.cpp)
 ////////////////////////////////////////////////////////////////////////////////
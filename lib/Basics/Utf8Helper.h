@@ -99,6 +99,19 @@ namespace triagens {
                          char const* right,
                          size_t rightLength) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the collation sort key of an utf8 string to result
+///
+/// comparing two sort keys with memcmp gives the same order as compareUtf8.
+/// a sort key contains no zero bytes except for its terminating zero, which
+/// is appended as well. returns false if there is no collator, in which case
+/// nothing is appended
+////////////////////////////////////////////////////////////////////////////////
+
+        bool appendSortKeyUtf8 (char const* value,
+                                size_t length,
+                                std::string& result) const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief compare utf16 strings
 /// -1 : left < right
@@ -234,6 +247,15 @@ int TRI_compare_utf8 (char const* left,
                       char const* right, 
                       size_t rightLength);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the collation sort key of an utf8 string (implemented in
+/// Basic/Utf8Helper.cpp)
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_AppendSortKeyUtf8 (char const* value,
+                            size_t length,
+                            std::string& result);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Lowercase the characters in a UTF-8 string (implemented in Basic/Utf8Helper.cpp)
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,1013 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generic in-memory B+-tree implementation
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bplus-tree.h"
+#include "Basics/Exceptions.h"
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private constants
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of entries per node
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const NodeSize = TRI_BPLUS_TREE_NODE_SIZE;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief nodes with fewer entries are merged with a neighbour
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MinFill = NodeSize / 4;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief nodes are only merged if the result has at most this many entries
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaxMergeFill = NodeSize - NodeSize / 4;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of entries per node when bulk loading
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const BulkFill = NodeSize - NodeSize / 8;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a document or key to compare stored documents with
+////////////////////////////////////////////////////////////////////////////////
+
+struct BPlusTree::Probe {
+  void* _target;
+  uint64_t _prefix;
+  bool _hasPrefix;
+  bool _isKey;
+  SkipListCmpType _cmptype;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an inner node
+///
+/// _keys[i] is the smallest document in the subtree below _children[i] and
+/// _prefixes[i] its prefix. _keys[0] is never looked at and not maintained.
+////////////////////////////////////////////////////////////////////////////////
+
+struct BPlusTree::Inner {
+  uint64_t _prefixes[TRI_BPLUS_TREE_NODE_SIZE];
+  void* _keys[TRI_BPLUS_TREE_NODE_SIZE];
+  void* _children[TRI_BPLUS_TREE_NODE_SIZE];
+  size_t _count;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief one step of a path from the root to a leaf
+////////////////////////////////////////////////////////////////////////////////
+
+struct BPlusTree::PathEntry {
+  Inner* _node;
+  size_t _index;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a new B+-tree
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTree::BPlusTree (SkipListCmpElmElm cmp_elm_elm,
+                      SkipListCmpKeyElm cmp_key_elm,
+                      BPlusTreePrefixElm prefix_elm,
+                      BPlusTreePrefixKey prefix_key,
+                      void* cmpdata,
+                      SkipListFreeFunc freefunc,
+                      bool unique)
+  : _root(nullptr),
+    _firstLeaf(nullptr),
+    _lastLeaf(nullptr),
+    _height(1),
+    _cmp_elm_elm(cmp_elm_elm),
+    _cmp_key_elm(cmp_key_elm),
+    _prefix_elm(prefix_elm),
+    _prefix_key(prefix_key),
+    _cmpdata(cmpdata),
+    _free(freefunc),
+    _unique(unique),
+    _nrUsed(0),
+    _memoryUsed(sizeof(BPlusTree)) {
+
+  // note that this can throw
+  BPlusTreeLeaf* leaf = allocLeaf();
+
+  _root = leaf;
+  _firstLeaf = leaf;
+  _lastLeaf = leaf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a B+-tree and all its documents
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTree::~BPlusTree () {
+  freeSubtree(_root, 0, true);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a new document into the tree
+////////////////////////////////////////////////////////////////////////////////
+
+int BPlusTree::insert (void* doc) {
+  Probe probe = makeElementProbe(doc, SKIPLIST_CMP_TOTORDER);
+  PathEntry path[TRI_BPLUS_TREE_MAX_HEIGHT];
+  size_t slot;
+
+  BPlusTreeLeaf* leaf = descend(probe, true, &slot, path);
+  // now slot is the number of documents in leaf that are less than or equal
+  // to doc. slot can only be 0 in the first leaf, so the predecessor of doc
+  // is always in the same leaf
+
+  if (slot > 0 &&
+      0 == compare(leaf->_prefixes[slot - 1], leaf->_docs[slot - 1], probe)) {
+    // we have found a duplicate in the proper total order!
+    return TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
+  }
+
+  // uniqueness test if wanted
+  if (_unique) {
+    probe._cmptype = SKIPLIST_CMP_PREORDER;
+
+    if (slot > 0 &&
+        0 == compare(leaf->_prefixes[slot - 1], leaf->_docs[slot - 1], probe)) {
+      return TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
+    }
+
+    BPlusTreePosition next{ leaf, slot };
+
+    if (slot == leaf->_count) {
+      next = BPlusTreePosition{ leaf->_next, 0 };
+    }
+
+    if (next._leaf != nullptr &&
+        0 == compare(next._leaf->_prefixes[next._slot], next._leaf->_docs[next._slot], probe)) {
+      return TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
+    }
+  }
+
+  uint64_t const prefix = probe._prefix;
+
+  if (leaf->_count < NodeSize) {
+    // simple case: the leaf has room
+    size_t const n = leaf->_count - slot;
+
+    memmove(&leaf->_prefixes[slot + 1], &leaf->_prefixes[slot], n * sizeof(uint64_t));
+    memmove(&leaf->_docs[slot + 1], &leaf->_docs[slot], n * sizeof(void*));
+
+    leaf->_prefixes[slot] = prefix;
+    leaf->_docs[slot] = doc;
+    ++leaf->_count;
+    ++_nrUsed;
+
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // the leaf must be split. allocate all nodes needed before the tree is
+  // modified, so an out-of-memory situation leaves the tree intact
+  int fullLevels = 0;
+
+  for (int level = _height - 2; level >= 0; --level) {
+    if (path[level]._node->_count < NodeSize) {
+      break;
+    }
+    ++fullLevels;
+  }
+
+  bool const newRoot = (fullLevels == _height - 1);
+
+  if (newRoot && _height >= TRI_BPLUS_TREE_MAX_HEIGHT) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  BPlusTreeLeaf* right = nullptr;
+  Inner* inners[TRI_BPLUS_TREE_MAX_HEIGHT + 1];
+  int numInners = 0;
+
+  try {
+    right = allocLeaf();
+
+    for (int i = 0; i < fullLevels + (newRoot ? 1 : 0); ++i) {
+      inners[numInners] = allocInner();
+      ++numInners;
+    }
+  }
+  catch (...) {
+    if (right != nullptr) {
+      freeLeaf(right);
+    }
+    for (int i = 0; i < numInners; ++i) {
+      freeInner(inners[i]);
+    }
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  // split the leaf. the left half stays in the old leaf
+  {
+    uint64_t prefixes[NodeSize + 1];
+    void* docs[NodeSize + 1];
+
+    memcpy(&prefixes[0], &leaf->_prefixes[0], slot * sizeof(uint64_t));
+    memcpy(&docs[0], &leaf->_docs[0], slot * sizeof(void*));
+    prefixes[slot] = prefix;
+    docs[slot] = doc;
+    memcpy(&prefixes[slot + 1], &leaf->_prefixes[slot], (NodeSize - slot) * sizeof(uint64_t));
+    memcpy(&docs[slot + 1], &leaf->_docs[slot], (NodeSize - slot) * sizeof(void*));
+
+    size_t const leftCount = (NodeSize + 1) / 2;
+    size_t const rightCount = NodeSize + 1 - leftCount;
+
+    memcpy(&leaf->_prefixes[0], &prefixes[0], leftCount * sizeof(uint64_t));
+    memcpy(&leaf->_docs[0], &docs[0], leftCount * sizeof(void*));
+    leaf->_count = leftCount;
+
+    memcpy(&right->_prefixes[0], &prefixes[leftCount], rightCount * sizeof(uint64_t));
+    memcpy(&right->_docs[0], &docs[leftCount], rightCount * sizeof(void*));
+    right->_count = rightCount;
+
+    right->_prev = leaf;
+    right->_next = leaf->_next;
+
+    if (leaf->_next != nullptr) {
+      leaf->_next->_prev = right;
+    }
+    else {
+      _lastLeaf = right;
+    }
+    leaf->_next = right;
+  }
+
+  ++_nrUsed;
+
+  // insert the new node into its parent, splitting inner nodes as required
+  void* newChild = right;
+  void* newKey = right->_docs[0];
+  uint64_t newPrefix = right->_prefixes[0];
+
+  for (int level = _height - 2; level >= 0; --level) {
+    Inner* inner = path[level]._node;
+    size_t const pos = path[level]._index + 1;
+
+    if (inner->_count < NodeSize) {
+      size_t const n = inner->_count - pos;
+
+      memmove(&inner->_prefixes[pos + 1], &inner->_prefixes[pos], n * sizeof(uint64_t));
+      memmove(&inner->_keys[pos + 1], &inner->_keys[pos], n * sizeof(void*));
+      memmove(&inner->_children[pos + 1], &inner->_children[pos], n * sizeof(void*));
+
+      inner->_prefixes[pos] = newPrefix;
+      inner->_keys[pos] = newKey;
+      inner->_children[pos] = newChild;
+      ++inner->_count;
+
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    TRI_ASSERT(numInners > 0);
+    Inner* sibling = inners[--numInners];
+
+    uint64_t prefixes[NodeSize + 1];
+    void* keys[NodeSize + 1];
+    void* children[NodeSize + 1];
+
+    memcpy(&prefixes[0], &inner->_prefixes[0], pos * sizeof(uint64_t));
+    memcpy(&keys[0], &inner->_keys[0], pos * sizeof(void*));
+    memcpy(&children[0], &inner->_children[0], pos * sizeof(void*));
+    prefixes[pos] = newPrefix;
+    keys[pos] = newKey;
+    children[pos] = newChild;
+    memcpy(&prefixes[pos + 1], &inner->_prefixes[pos], (NodeSize - pos) * sizeof(uint64_t));
+    memcpy(&keys[pos + 1], &inner->_keys[pos], (NodeSize - pos) * sizeof(void*));
+    memcpy(&children[pos + 1], &inner->_children[pos], (NodeSize - pos) * sizeof(void*));
+
+    size_t const leftCount = (NodeSize + 1) / 2;
+    size_t const rightCount = NodeSize + 1 - leftCount;
+
+    memcpy(&inner->_prefixes[0], &prefixes[0], leftCount * sizeof(uint64_t));
+    memcpy(&inner->_keys[0], &keys[0], leftCount * sizeof(void*));
+    memcpy(&inner->_children[0], &children[0], leftCount * sizeof(void*));
+    inner->_count = leftCount;
+
+    memcpy(&sibling->_prefixes[0], &prefixes[leftCount], rightCount * sizeof(uint64_t));
+    memcpy(&sibling->_keys[0], &keys[leftCount], rightCount * sizeof(void*));
+    memcpy(&sibling->_children[0], &children[leftCount], rightCount * sizeof(void*));
+    sibling->_count = rightCount;
+
+    newChild = sibling;
+    newKey = sibling->_keys[0];
+    newPrefix = sibling->_prefixes[0];
+  }
+
+  // the root was split, so the tree grows by one level
+  TRI_ASSERT(newRoot);
+  TRI_ASSERT(numInners == 1);
+
+  Inner* root = inners[0];
+  root->_prefixes[0] = 0;
+  root->_keys[0] = nullptr;
+  root->_children[0] = _root;
+  root->_prefixes[1] = newPrefix;
+  root->_keys[1] = newKey;
+  root->_children[1] = newChild;
+  root->_count = 2;
+
+  _root = root;
+  ++_height;
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills an empty tree with documents at once
+////////////////////////////////////////////////////////////////////////////////
+
+int BPlusTree::bulkLoad (void* const* docs,
+                         size_t n) {
+  TRI_ASSERT(_nrUsed == 0);
+  TRI_ASSERT(_height == 1);
+
+  if (n == 0) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+#ifdef TRI_ENABLE_MAINTAINER_MODE
+  for (size_t i = 1; i < n; ++i) {
+    TRI_ASSERT(_cmp_elm_elm(_cmpdata, docs[i - 1], docs[i], SKIPLIST_CMP_TOTORDER) < 0);
+  }
+#endif
+
+  size_t const numLeaves = (n + BulkFill - 1) / BulkFill;
+
+  std::vector<BPlusTreeLeaf*> leaves;
+  std::vector<Inner*> inners;
+  std::vector<void*> nodes;
+  std::vector<void*> lowKeys;
+  std::vector<uint64_t> lowPrefixes;
+  int height = 1;
+
+  try {
+    leaves.reserve(numLeaves);
+    inners.reserve(numLeaves);
+    nodes.reserve(numLeaves);
+    lowKeys.reserve(numLeaves);
+    lowPrefixes.reserve(numLeaves);
+
+    // fill the leaves evenly, so that the last one is not almost empty
+    BPlusTreeLeaf* prev = nullptr;
+    size_t offset = 0;
+
+    for (size_t i = 0; i < numLeaves; ++i) {
+      size_t const count = n / numLeaves + (i < n % numLeaves ? 1 : 0);
+
+      BPlusTreeLeaf* leaf = allocLeaf();
+      leaves.push_back(leaf);
+
+      for (size_t j = 0; j < count; ++j) {
+        void* doc = docs[offset + j];
+
+        leaf->_docs[j] = doc;
+        leaf->_prefixes[j] = (_prefix_elm == nullptr ? 0 : _prefix_elm(_cmpdata, doc));
+      }
+
+      leaf->_count = count;
+      leaf->_prev = prev;
+
+      if (prev != nullptr) {
+        prev->_next = leaf;
+      }
+      prev = leaf;
+      offset += count;
+
+      nodes.push_back(leaf);
+      lowKeys.push_back(leaf->_docs[0]);
+      lowPrefixes.push_back(leaf->_prefixes[0]);
+    }
+
+    // build the inner levels bottom-up
+    while (nodes.size() > 1) {
+      size_t const m = nodes.size();
+      size_t const numParents = (m + BulkFill - 1) / BulkFill;
+      size_t offset = 0;
+
+      for (size_t i = 0; i < numParents; ++i) {
+        size_t const count = m / numParents + (i < m % numParents ? 1 : 0);
+
+        Inner* inner = allocInner();
+        inners.push_back(inner);
+
+        for (size_t j = 0; j < count; ++j) {
+          inner->_children[j] = nodes[offset + j];
+          inner->_keys[j] = lowKeys[offset + j];
+          inner->_prefixes[j] = lowPrefixes[offset + j];
+        }
+        inner->_count = count;
+
+        // the parents are written over the front part of the vectors. this
+        // is safe because there are fewer parents than children
+        nodes[i] = inner;
+        lowKeys[i] = inner->_keys[0];
+        lowPrefixes[i] = inner->_prefixes[0];
+
+        offset += count;
+      }
+
+      nodes.resize(numParents);
+      lowKeys.resize(numParents);
+      lowPrefixes.resize(numParents);
+      ++height;
+
+      if (height > TRI_BPLUS_TREE_MAX_HEIGHT) {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+      }
+    }
+  }
+  catch (...) {
+    for (auto it : leaves) {
+      freeLeaf(it);
+    }
+    for (auto it : inners) {
+      freeInner(it);
+    }
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  // replace the empty root leaf
+  freeLeaf(static_cast<BPlusTreeLeaf*>(_root));
+
+  _root = nodes[0];
+  _height = height;
+  _firstLeaf = leaves.front();
+  _lastLeaf = leaves.back();
+  _nrUsed = n;
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a document from the tree
+////////////////////////////////////////////////////////////////////////////////
+
+int BPlusTree::remove (void* doc) {
+  Probe probe = makeElementProbe(doc, SKIPLIST_CMP_TOTORDER);
+  PathEntry path[TRI_BPLUS_TREE_MAX_HEIGHT];
+  size_t slot;
+
+  BPlusTreeLeaf* leaf = descend(probe, true, &slot, path);
+  // doc is in the tree iff it is the last document that is less than or
+  // equal to itself
+
+  if (slot == 0 ||
+      0 != compare(leaf->_prefixes[slot - 1], leaf->_docs[slot - 1], probe)) {
+    return TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND;
+  }
+
+  --slot;
+
+  if (nullptr != _free) {
+    _free(leaf->_docs[slot]);
+  }
+
+  size_t const n = leaf->_count - slot - 1;
+
+  memmove(&leaf->_prefixes[slot], &leaf->_prefixes[slot + 1], n * sizeof(uint64_t));
+  memmove(&leaf->_docs[slot], &leaf->_docs[slot + 1], n * sizeof(void*));
+  --leaf->_count;
+  --_nrUsed;
+
+  if (_height == 1) {
+    // the root leaf is allowed to become empty
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  int const level = _height - 1;
+
+  if (leaf->_count == 0) {
+    removeChild(path, level);
+  }
+  else {
+    if (slot == 0) {
+      updateLowKey(path, level, leaf->_prefixes[0], leaf->_docs[0]);
+    }
+    mergeUnderfull(path, level);
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up doc in the tree using the proper order comparison.
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTreePosition BPlusTree::lookup (void* doc) const {
+  Probe probe = makeElementProbe(doc, SKIPLIST_CMP_TOTORDER);
+  BPlusTreePosition position = findLast(probe, true);
+
+  if (position._leaf == nullptr ||
+      0 != compare(position._leaf->_prefixes[position._slot], position._leaf->_docs[position._slot], probe)) {
+    return endPosition();
+  }
+
+  return position;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the last document that is less than doc in the preorder
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTreePosition BPlusTree::leftLookup (void* doc) const {
+  return findLast(makeElementProbe(doc, SKIPLIST_CMP_PREORDER), false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the last document that is less than or equal to doc in the
+/// preorder
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTreePosition BPlusTree::rightLookup (void* doc) const {
+  return findLast(makeElementProbe(doc, SKIPLIST_CMP_PREORDER), true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the last document that is less than key in the preorder
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTreePosition BPlusTree::leftKeyLookup (void* key) const {
+  return findLast(makeKeyProbe(key), false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the last document that is less than or equal to key in the
+/// preorder
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTreePosition BPlusTree::rightKeyLookup (void* key) const {
+  return findLast(makeKeyProbe(key), true);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates a new, empty leaf
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTreeLeaf* BPlusTree::allocLeaf () {
+  BPlusTreeLeaf* leaf = static_cast<BPlusTreeLeaf*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(BPlusTreeLeaf), false));
+
+  if (leaf == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  leaf->_prev = nullptr;
+  leaf->_next = nullptr;
+  leaf->_count = 0;
+
+  _memoryUsed += sizeof(BPlusTreeLeaf);
+
+  return leaf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates a new, empty inner node
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTree::Inner* BPlusTree::allocInner () {
+  Inner* inner = static_cast<Inner*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(Inner), false));
+
+  if (inner == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  inner->_count = 0;
+
+  _memoryUsed += sizeof(Inner);
+
+  return inner;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a leaf
+////////////////////////////////////////////////////////////////////////////////
+
+void BPlusTree::freeLeaf (BPlusTreeLeaf* leaf) {
+  _memoryUsed -= sizeof(BPlusTreeLeaf);
+  TRI_Free(TRI_UNKNOWN_MEM_ZONE, leaf);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees an inner node
+////////////////////////////////////////////////////////////////////////////////
+
+void BPlusTree::freeInner (Inner* inner) {
+  _memoryUsed -= sizeof(Inner);
+  TRI_Free(TRI_UNKNOWN_MEM_ZONE, inner);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a subtree, including the documents if requested
+////////////////////////////////////////////////////////////////////////////////
+
+void BPlusTree::freeSubtree (void* node,
+                             int level,
+                             bool freeDocuments) {
+  if (level == _height - 1) {
+    BPlusTreeLeaf* leaf = static_cast<BPlusTreeLeaf*>(node);
+
+    if (freeDocuments && nullptr != _free) {
+      for (size_t i = 0; i < leaf->_count; ++i) {
+        _free(leaf->_docs[i]);
+      }
+    }
+
+    freeLeaf(leaf);
+    return;
+  }
+
+  Inner* inner = static_cast<Inner*>(node);
+
+  for (size_t i = 0; i < inner->_count; ++i) {
+    freeSubtree(inner->_children[i], level + 1, freeDocuments);
+  }
+
+  freeInner(inner);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds a probe for a document
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTree::Probe BPlusTree::makeElementProbe (void* doc,
+                                              SkipListCmpType cmptype) const {
+  Probe probe;
+
+  probe._target = doc;
+  probe._hasPrefix = (_prefix_elm != nullptr);
+  probe._prefix = (probe._hasPrefix ? _prefix_elm(_cmpdata, doc) : 0);
+  probe._isKey = false;
+  probe._cmptype = cmptype;
+
+  return probe;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds a probe for a key
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTree::Probe BPlusTree::makeKeyProbe (void* key) const {
+  Probe probe;
+
+  probe._target = key;
+  probe._prefix = 0;
+  probe._hasPrefix = (_prefix_key != nullptr && _prefix_key(_cmpdata, key, &probe._prefix));
+  probe._isKey = true;
+  probe._cmptype = SKIPLIST_CMP_PREORDER;
+
+  return probe;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares a stored document with a probe
+///
+/// Returns a negative value if the stored document is less than the probe,
+/// 0 if both are equal and a positive value otherwise. The comparison
+/// functions are only called if the prefixes are identical.
+////////////////////////////////////////////////////////////////////////////////
+
+int BPlusTree::compare (uint64_t prefix,
+                        void* doc,
+                        Probe const& probe) const {
+  if (probe._hasPrefix && prefix != probe._prefix) {
+    return prefix < probe._prefix ? -1 : 1;
+  }
+
+  if (probe._isKey) {
+    int res = _cmp_key_elm(_cmpdata, probe._target, doc);
+
+    return res < 0 ? 1 : (res > 0 ? -1 : 0);
+  }
+
+  return _cmp_elm_elm(_cmpdata, doc, probe._target, probe._cmptype);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of leading entries in [from, to) that are
+/// less (or less or equal) than the probe
+////////////////////////////////////////////////////////////////////////////////
+
+size_t BPlusTree::countLess (uint64_t const* prefixes,
+                             void* const* docs,
+                             size_t from,
+                             size_t to,
+                             Probe const& probe,
+                             bool orEqual) const {
+  size_t lo = from;
+  size_t hi = to;
+
+  while (lo < hi) {
+    size_t const mid = lo + (hi - lo) / 2;
+    int const res = compare(prefixes[mid], docs[mid], probe);
+
+    if (res < 0 || (orEqual && res == 0)) {
+      lo = mid + 1;
+    }
+    else {
+      hi = mid;
+    }
+  }
+
+  return lo - from;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief descends to the leaf that contains the last document that is less
+/// (or less or equal) than the probe
+///
+/// Because the keys of the inner nodes are the smallest documents of their
+/// subtrees, the returned leaf contains at least one such document, unless
+/// there is none at all in the tree. In that case the first leaf is
+/// returned with *slot set to 0.
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTreeLeaf* BPlusTree::descend (Probe const& probe,
+                                   bool orEqual,
+                                   size_t* slot,
+                                   PathEntry* path) const {
+  void* node = _root;
+
+  for (int level = 0; level < _height - 1; ++level) {
+    Inner* inner = static_cast<Inner*>(node);
+    size_t const index = countLess(inner->_prefixes, inner->_keys, 1, inner->_count, probe, orEqual);
+
+    if (path != nullptr) {
+      path[level]._node = inner;
+      path[level]._index = index;
+    }
+
+    node = inner->_children[index];
+  }
+
+  BPlusTreeLeaf* leaf = static_cast<BPlusTreeLeaf*>(node);
+  *slot = countLess(leaf->_prefixes, leaf->_docs, 0, leaf->_count, probe, orEqual);
+
+  return leaf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the last document less (or less or equal) than the probe
+////////////////////////////////////////////////////////////////////////////////
+
+BPlusTreePosition BPlusTree::findLast (Probe const& probe,
+                                       bool orEqual) const {
+  size_t slot;
+  BPlusTreeLeaf* leaf = descend(probe, orEqual, &slot, nullptr);
+
+  if (slot == 0) {
+    TRI_ASSERT(leaf == _firstLeaf);
+    return startPosition();
+  }
+
+  return BPlusTreePosition{ leaf, slot - 1 };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief propagates a new smallest document of a node to its ancestors
+///
+/// The document is the key of the node in the nearest ancestor in which the
+/// path does not go through the first child.
+////////////////////////////////////////////////////////////////////////////////
+
+void BPlusTree::updateLowKey (PathEntry* path,
+                              int level,
+                              uint64_t prefix,
+                              void* doc) {
+  for (int l = level - 1; l >= 0; --l) {
+    size_t const index = path[l]._index;
+
+    if (index > 0) {
+      path[l]._node->_prefixes[index] = prefix;
+      path[l]._node->_keys[index] = doc;
+      return;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the empty node at a path level from its parent
+////////////////////////////////////////////////////////////////////////////////
+
+void BPlusTree::removeChild (PathEntry* path,
+                             int level) {
+  TRI_ASSERT(level > 0);
+
+  Inner* parent = path[level - 1]._node;
+  size_t const index = path[level - 1]._index;
+
+  if (level == _height - 1) {
+    BPlusTreeLeaf* leaf = static_cast<BPlusTreeLeaf*>(parent->_children[index]);
+    TRI_ASSERT(leaf->_count == 0);
+
+    if (leaf->_prev != nullptr) {
+      leaf->_prev->_next = leaf->_next;
+    }
+    else {
+      _firstLeaf = leaf->_next;
+    }
+
+    if (leaf->_next != nullptr) {
+      leaf->_next->_prev = leaf->_prev;
+    }
+    else {
+      _lastLeaf = leaf->_prev;
+    }
+
+    freeLeaf(leaf);
+  }
+  else {
+    Inner* inner = static_cast<Inner*>(parent->_children[index]);
+    TRI_ASSERT(inner->_count == 0);
+
+    freeInner(inner);
+  }
+
+  size_t const n = parent->_count - index - 1;
+
+  memmove(&parent->_prefixes[index], &parent->_prefixes[index + 1], n * sizeof(uint64_t));
+  memmove(&parent->_keys[index], &parent->_keys[index + 1], n * sizeof(void*));
+  memmove(&parent->_children[index], &parent->_children[index + 1], n * sizeof(void*));
+  --parent->_count;
+
+  if (parent->_count == 0) {
+    // only non-root inner nodes can run empty, the root always has two
+    // children at least
+    removeChild(path, level - 1);
+    return;
+  }
+
+  if (level - 1 == 0) {
+    if (parent->_count == 1) {
+      // the root has a single child left, so the tree shrinks by one level
+      _root = parent->_children[0];
+      --_height;
+      freeInner(parent);
+    }
+    return;
+  }
+
+  if (index == 0) {
+    updateLowKey(path, level - 1, parent->_prefixes[0], parent->_keys[0]);
+  }
+
+  mergeUnderfull(path, level - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief merges an underfull node with a sibling if both fit into one node
+///
+/// The right one of the two nodes is always merged into the left one, so
+/// the smallest document of the merged node does not change.
+////////////////////////////////////////////////////////////////////////////////
+
+void BPlusTree::mergeUnderfull (PathEntry* path,
+                                int level) {
+  if (level == 0) {
+    return;
+  }
+
+  Inner* parent = path[level - 1]._node;
+  size_t const index = path[level - 1]._index;
+  bool const isLeaf = (level == _height - 1);
+
+  auto countOf = [&isLeaf] (void* node) -> size_t {
+    return isLeaf ? static_cast<BPlusTreeLeaf*>(node)->_count : static_cast<Inner*>(node)->_count;
+  };
+
+  if (countOf(parent->_children[index]) >= MinFill) {
+    return;
+  }
+
+  size_t leftIndex;
+
+  if (index > 0) {
+    leftIndex = index - 1;
+  }
+  else if (index + 1 < parent->_count) {
+    leftIndex = index;
+  }
+  else {
+    // no sibling
+    return;
+  }
+
+  size_t const rightIndex = leftIndex + 1;
+  void* left = parent->_children[leftIndex];
+  void* right = parent->_children[rightIndex];
+  size_t const leftCount = countOf(left);
+  size_t const rightCount = countOf(right);
+
+  if (leftCount + rightCount > MaxMergeFill) {
+    return;
+  }
+
+  if (isLeaf) {
+    BPlusTreeLeaf* l = static_cast<BPlusTreeLeaf*>(left);
+    BPlusTreeLeaf* r = static_cast<BPlusTreeLeaf*>(right);
+
+    memcpy(&l->_prefixes[leftCount], &r->_prefixes[0], rightCount * sizeof(uint64_t));
+    memcpy(&l->_docs[leftCount], &r->_docs[0], rightCount * sizeof(void*));
+    l->_count += rightCount;
+
+    l->_next = r->_next;
+
+    if (r->_next != nullptr) {
+      r->_next->_prev = l;
+    }
+    else {
+      _lastLeaf = l;
+    }
+
+    freeLeaf(r);
+  }
+  else {
+    Inner* l = static_cast<Inner*>(left);
+    Inner* r = static_cast<Inner*>(right);
+
+    // the key of the first child of r is only known to the parent
+    r->_prefixes[0] = parent->_prefixes[rightIndex];
+    r->_keys[0] = parent->_keys[rightIndex];
+
+    memcpy(&l->_prefixes[leftCount], &r->_prefixes[0], rightCount * sizeof(uint64_t));
+    memcpy(&l->_keys[leftCount], &r->_keys[0], rightCount * sizeof(void*));
+    memcpy(&l->_children[leftCount], &r->_children[0], rightCount * sizeof(void*));
+    l->_count += rightCount;
+
+    freeInner(r);
+  }
+
+  size_t const n = parent->_count - rightIndex - 1;
+
+  memmove(&parent->_prefixes[rightIndex], &parent->_prefixes[rightIndex + 1], n * sizeof(uint64_t));
+  memmove(&parent->_keys[rightIndex], &parent->_keys[rightIndex + 1], n * sizeof(void*));
+  memmove(&parent->_children[rightIndex], &parent->_children[rightIndex + 1], n * sizeof(void*));
+  --parent->_count;
+
+  if (level - 1 == 0) {
+    if (parent->_count == 1) {
+      _root = parent->_children[0];
+      --_height;
+      freeInner(parent);
+    }
+    return;
+  }
+
+  mergeUnderfull(path, level - 1);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
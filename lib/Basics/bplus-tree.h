@@ -0,0 +1,474 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generic in-memory B+-tree implementation
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_BPLUS__TREE_H
+#define ARANGODB_BASICS_BPLUS__TREE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/skip-list.h"
+
+// number of entries in a B+-tree node. the prefixes of one node fill exactly
+// four cache lines
+#define TRI_BPLUS_TREE_NODE_SIZE 32
+
+// the tree can never get this high because a new level is only added when
+// the root node is full
+#define TRI_BPLUS_TREE_MAX_HEIGHT 48
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        BPLUS TREE
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief type of a function pointer that computes the key prefix of an
+/// element
+///
+/// The prefix must be monotonic with respect to the preorder of the tree:
+/// if a is less than or equal to b in the preorder, then the prefix of a
+/// must be less than or equal to the prefix of b. The tree then only calls
+/// the comparison functions for elements with identical prefixes.
+////////////////////////////////////////////////////////////////////////////////
+
+    typedef uint64_t (*BPlusTreePrefixElm)(void*, void*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief type of a function pointer that computes the prefix of a key
+///
+/// Returns false if no prefix can be computed for the key (e.g. because
+/// the key is empty). In this case only the comparison function is used.
+////////////////////////////////////////////////////////////////////////////////
+
+    typedef bool (*BPlusTreePrefixKey)(void*, void*, uint64_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief type of a B+-tree leaf
+///
+/// Leaves are chained in both directions so that range scans never have to
+/// go back to the inner nodes. The prefixes of all documents of a leaf are
+/// stored in front of the document pointers, so a binary search inside a
+/// leaf only touches the prefix cache lines until prefixes are equal.
+////////////////////////////////////////////////////////////////////////////////
+
+    struct BPlusTreeLeaf {
+      uint64_t _prefixes[TRI_BPLUS_TREE_NODE_SIZE];
+      void* _docs[TRI_BPLUS_TREE_NODE_SIZE];
+      BPlusTreeLeaf* _prev;
+      BPlusTreeLeaf* _next;
+      size_t _count;
+    };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief position of a document in a B+-tree
+///
+/// A position with a _leaf of nullptr is outside of the data: _slot 0 is the
+/// artificial position before the first document, _slot 1 the one behind the
+/// last document. These are the equivalents of the start node and the
+/// nullptr end node of the skiplist. Positions are invalidated by any
+/// modification of the tree.
+////////////////////////////////////////////////////////////////////////////////
+
+    struct BPlusTreePosition {
+      BPlusTreeLeaf* _leaf;
+      size_t _slot;
+
+      bool operator== (BPlusTreePosition const& other) const {
+        return _leaf == other._leaf && _slot == other._slot;
+      }
+
+      bool operator!= (BPlusTreePosition const& other) const {
+        return ! (*this == other);
+      }
+    };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief type of a B+-tree
+///
+/// The tree uses the same comparison and free functions as the skiplist
+/// and provides the same lookup operations, so it can be used as a drop-in
+/// replacement for sorted indexes. Additionally it stores a 64 bit prefix
+/// of every document inline in the nodes, and it can be bulk-loaded from
+/// sorted input in linear time.
+////////////////////////////////////////////////////////////////////////////////
+
+    class BPlusTree {
+
+      struct Probe;
+      struct Inner;
+      struct PathEntry;
+
+      public:
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a new B+-tree
+///
+/// The prefix functions may be nullptr, in which case all comparisons are
+/// done with the comparison functions.
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTree (SkipListCmpElmElm cmp_elm_elm,
+                   SkipListCmpKeyElm cmp_key_elm,
+                   BPlusTreePrefixElm prefix_elm,
+                   BPlusTreePrefixKey prefix_key,
+                   void* cmpdata,
+                   SkipListFreeFunc freefunc,
+                   bool unique);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a B+-tree and all its documents
+////////////////////////////////////////////////////////////////////////////////
+
+        ~BPlusTree ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the artificial position before the first document
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreePosition startPosition () const {
+          return BPlusTreePosition{ nullptr, 0 };
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the artificial position behind the last document
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreePosition endPosition () const {
+          return BPlusTreePosition{ nullptr, 1 };
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the position following the given one, or the end position
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreePosition nextPosition (BPlusTreePosition const& position) const {
+          if (position._leaf == nullptr) {
+            if (position._slot == 0 && _nrUsed > 0) {
+              return BPlusTreePosition{ _firstLeaf, 0 };
+            }
+            return endPosition();
+          }
+
+          if (position._slot + 1 < position._leaf->_count) {
+            return BPlusTreePosition{ position._leaf, position._slot + 1 };
+          }
+
+          if (position._leaf->_next != nullptr) {
+            return BPlusTreePosition{ position._leaf->_next, 0 };
+          }
+
+          return endPosition();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the position preceding the given one, or the start position.
+/// it is legal to call this with the end position to find the last document
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreePosition prevPosition (BPlusTreePosition const& position) const {
+          if (position._leaf == nullptr) {
+            if (position._slot == 1 && _nrUsed > 0) {
+              return BPlusTreePosition{ _lastLeaf, _lastLeaf->_count - 1 };
+            }
+            return startPosition();
+          }
+
+          if (position._slot > 0) {
+            return BPlusTreePosition{ position._leaf, position._slot - 1 };
+          }
+
+          if (position._leaf->_prev != nullptr) {
+            return BPlusTreePosition{ position._leaf->_prev, position._leaf->_prev->_count - 1 };
+          }
+
+          return startPosition();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the document at a position, which must not be the start
+/// or the end position
+////////////////////////////////////////////////////////////////////////////////
+
+        void* document (BPlusTreePosition const& position) const {
+          TRI_ASSERT(position._leaf != nullptr);
+          TRI_ASSERT(position._slot < position._leaf->_count);
+
+          return position._leaf->_docs[position._slot];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a new document into the tree
+///
+/// Comparison is done using proper order comparison. If the tree is unique
+/// then no two documents that compare equal in the preorder can be
+/// inserted. Returns TRI_ERROR_NO_ERROR if all is well,
+/// TRI_ERROR_OUT_OF_MEMORY if allocation failed and
+/// TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED if the unique constraint
+/// would have been violated or if the document is already present. In the
+/// latter two cases nothing is inserted.
+////////////////////////////////////////////////////////////////////////////////
+
+        int insert (void* doc);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills an empty tree with documents at once
+///
+/// The documents must be sorted by the proper total order and must not
+/// contain duplicates (nor preorder-duplicates for a unique tree). The
+/// leaves are filled up to seven eighths, so that later inserts do not
+/// immediately split them. Returns TRI_ERROR_NO_ERROR or
+/// TRI_ERROR_OUT_OF_MEMORY, in which case the tree remains empty and the
+/// ownership of the documents stays with the caller.
+////////////////////////////////////////////////////////////////////////////////
+
+        int bulkLoad (void* const* docs,
+                      size_t n);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a document from the tree
+///
+/// Comparison is done using proper order comparison. Returns
+/// TRI_ERROR_NO_ERROR if all is well and TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND
+/// if the document was not found.
+////////////////////////////////////////////////////////////////////////////////
+
+        int remove (void* doc);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of documents in the tree
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t getNrUsed () const {
+          return _nrUsed;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the memory used by the tree nodes
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t memoryUsage () const {
+          return _memoryUsed;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the height of the tree, 1 if the root is a leaf
+////////////////////////////////////////////////////////////////////////////////
+
+        int height () const {
+          return _height;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up doc in the tree using the proper order comparison.
+///
+/// Returns the end position if doc is not in the tree.
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreePosition lookup (void* doc) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the last document that is less than doc in the preorder
+/// or the start position if none is.
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreePosition leftLookup (void* doc) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the last document that is less than or equal to doc in the
+/// preorder or the start position if none is.
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreePosition rightLookup (void* doc) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the last document that is less than key in the preorder
+/// or the start position if none is.
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreePosition leftKeyLookup (void* key) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the last document that is less than or equal to key in the
+/// preorder or the start position if none is.
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreePosition rightKeyLookup (void* key) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates a new, empty leaf
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreeLeaf* allocLeaf ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates a new, empty inner node
+////////////////////////////////////////////////////////////////////////////////
+
+        Inner* allocInner ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a leaf
+////////////////////////////////////////////////////////////////////////////////
+
+        void freeLeaf (BPlusTreeLeaf*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees an inner node
+////////////////////////////////////////////////////////////////////////////////
+
+        void freeInner (Inner*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a subtree, including the documents if requested
+////////////////////////////////////////////////////////////////////////////////
+
+        void freeSubtree (void*, int, bool);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds a probe for a document
+////////////////////////////////////////////////////////////////////////////////
+
+        Probe makeElementProbe (void*, SkipListCmpType) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds a probe for a key
+////////////////////////////////////////////////////////////////////////////////
+
+        Probe makeKeyProbe (void*) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares a stored document with a probe
+////////////////////////////////////////////////////////////////////////////////
+
+        int compare (uint64_t, void*, Probe const&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of leading entries in [from, to) that are
+/// less (or less or equal) than the probe
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t countLess (uint64_t const*,
+                          void* const*,
+                          size_t,
+                          size_t,
+                          Probe const&,
+                          bool) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief descends to the leaf that contains the last document that is less
+/// (or less or equal) than the probe. Returns the leaf and the number of
+/// such documents in the leaf, records the path if requested
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreeLeaf* descend (Probe const&,
+                                bool,
+                                size_t*,
+                                PathEntry*) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the last document less (or less or equal) than the probe
+////////////////////////////////////////////////////////////////////////////////
+
+        BPlusTreePosition findLast (Probe const&,
+                                    bool) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief propagates a new smallest document of a node to its ancestors
+////////////////////////////////////////////////////////////////////////////////
+
+        void updateLowKey (PathEntry*,
+                           int,
+                           uint64_t,
+                           void*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the child at a path level from its parent
+////////////////////////////////////////////////////////////////////////////////
+
+        void removeChild (PathEntry*,
+                          int);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief merges an underfull node with a sibling if both fit into one node
+////////////////////////////////////////////////////////////////////////////////
+
+        void mergeUnderfull (PathEntry*,
+                             int);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        void* _root;
+        BPlusTreeLeaf* _firstLeaf;
+        BPlusTreeLeaf* _lastLeaf;
+        int _height;
+        SkipListCmpElmElm _cmp_elm_elm;
+        SkipListCmpKeyElm _cmp_key_elm;
+        BPlusTreePrefixElm _prefix_elm;
+        BPlusTreePrefixKey _prefix_key;
+        void* _cmpdata;   // will be the first argument
+        SkipListFreeFunc _free;
+        bool _unique;     // indicates whether multiple entries that
+                          // are equal in the preorder are allowed in
+        uint64_t _nrUsed;
+        size_t _memoryUsed;
+    };
+
+  }   // namespace triagens::basics
+}   // namespace triagens
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -206,9 +206,8 @@ int TRI_CompareValuesJson (TRI_json_t const* lhs,
   }
 
   // lhs and rhs have equal weights
-  if (lhs == nullptr) {
-    // both lhs and rhs are NULL, so they are equal
-    TRI_ASSERT(rhs == nullptr);
+  if (lhs == nullptr || rhs == nullptr) {
+    // both lhs and rhs are NULL or null, so they are equal
     return 0;
   }
 
@@ -324,6 +323,176 @@ int TRI_CompareValuesJson (TRI_json_t const* lhs,
   return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief type tags used in sort keys, in the order of TypeWeight. the end of
+/// an array or object is marked with a zero byte, which sorts before all tags
+////////////////////////////////////////////////////////////////////////////////
+
+static char const SortKeyEnd    = 0x00;
+static char const SortKeyEntry  = 0x01;
+static char const SortKeyNull   = 0x02;
+static char const SortKeyFalse  = 0x03;
+static char const SortKeyTrue   = 0x04;
+static char const SortKeyNumber = 0x05;
+static char const SortKeyString = 0x06;
+static char const SortKeyArray  = 0x07;
+static char const SortKeyObject = 0x08;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the sort key of a string
+///
+/// with useUTF8, this is the collation sort key. otherwise the raw bytes are
+/// used, with 0x00 and 0x01 escaped so that a zero byte can end the key
+////////////////////////////////////////////////////////////////////////////////
+
+static void AppendSortKeyString (std::string& result,
+                                 char const* value,
+                                 size_t length,
+                                 bool useUTF8) {
+  if (useUTF8 && TRI_AppendSortKeyUtf8(value, length, result)) {
+    return;
+  }
+
+  for (size_t i = 0; i < length; ++i) {
+    char const c = value[i];
+
+    if (c == 0x00 || c == 0x01) {
+      result.push_back(0x01);
+      result.push_back(c + 1);
+    }
+    else {
+      result.push_back(c);
+    }
+  }
+  result.push_back(0x00);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the sort key of a json value
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AppendSortKeyJson (std::string& result,
+                            TRI_json_t const* value,
+                            bool useUTF8) {
+  if (value == nullptr) {
+    result.push_back(SortKeyNull);
+    return;
+  }
+
+  switch (value->_type) {
+    case TRI_JSON_UNUSED:
+    case TRI_JSON_NULL: {
+      result.push_back(SortKeyNull);
+      return;
+    }
+
+    case TRI_JSON_BOOLEAN: {
+      result.push_back(value->_value._boolean ? SortKeyTrue : SortKeyFalse);
+      return;
+    }
+
+    case TRI_JSON_NUMBER: {
+      // big-endian IEEE 754 with the sign bit flipped for positive numbers and
+      // all bits flipped for negative ones orders like the numbers themselves
+      double number = value->_value._number;
+
+      if (number == 0.0) {
+        // -0 == 0
+        number = 0.0;
+      }
+
+      uint64_t bits;
+      memcpy(&bits, &number, sizeof(bits));
+
+      if (bits & (static_cast<uint64_t>(1) << 63)) {
+        bits = ~bits;
+      }
+      else {
+        bits |= (static_cast<uint64_t>(1) << 63);
+      }
+
+      result.push_back(SortKeyNumber);
+      for (int shift = 56; shift >= 0; shift -= 8) {
+        result.push_back(static_cast<char>((bits >> shift) & 0xff));
+      }
+      return;
+    }
+
+    case TRI_JSON_STRING:
+    case TRI_JSON_STRING_REFERENCE: {
+      result.push_back(SortKeyString);
+      AppendSortKeyString(result, value->_value._string.data, value->_value._string.length - 1, useUTF8);
+      return;
+    }
+
+    case TRI_JSON_ARRAY: {
+      // missing members compare like null, so trailing nulls are left out
+      size_t n = value->_value._objects._length;
+
+      while (n > 0) {
+        auto member = static_cast<TRI_json_t const*>(TRI_AtVector(&value->_value._objects, n - 1));
+
+        if (member != nullptr && 
+            member->_type != TRI_JSON_NULL && 
+            member->_type != TRI_JSON_UNUSED) {
+          break;
+        }
+        --n;
+      }
+
+      result.push_back(SortKeyArray);
+      for (size_t i = 0; i < n; ++i) {
+        TRI_AppendSortKeyJson(result, static_cast<TRI_json_t const*>(TRI_AtVector(&value->_value._objects, i)), useUTF8);
+      }
+      result.push_back(SortKeyEnd);
+      return;
+    }
+
+    case TRI_JSON_OBJECT: {
+      // objects are compared attribute by attribute in key order, with missing
+      // attributes compared like null. attributes with null values are left
+      // out, and keys are stored inverted: the object that has the smaller of
+      // two differing keys has a non-null value where the other one has none,
+      // and so it is the greater one
+      std::vector<std::pair<std::string, std::string>> entries;
+      size_t const n = value->_value._objects._length;
+
+      for (size_t i = 0; i < n; i += 2) {
+        auto key = static_cast<TRI_json_t const*>(TRI_AtVector(&value->_value._objects, i));
+        auto member = static_cast<TRI_json_t const*>(TRI_AtVector(&value->_value._objects, i + 1));
+
+        if (member == nullptr || 
+            member->_type == TRI_JSON_NULL || 
+            member->_type == TRI_JSON_UNUSED) {
+          continue;
+        }
+
+        TRI_ASSERT(TRI_IsStringJson(key));
+
+        entries.emplace_back(std::string(), std::string());
+        AppendSortKeyString(entries.back().first, key->_value._string.data, key->_value._string.length - 1, true);
+        TRI_AppendSortKeyJson(entries.back().second, member, useUTF8);
+      }
+
+      std::sort(entries.begin(), entries.end(), [] (std::pair<std::string, std::string> const& lhs,
+                                                    std::pair<std::string, std::string> const& rhs) {
+        return lhs.first < rhs.first;
+      });
+
+      result.push_back(SortKeyObject);
+      for (auto const& entry : entries) {
+        result.push_back(SortKeyEntry);
+        for (auto c : entry.first) {
+          result.push_back(~c);
+        }
+        result.append(entry.second);
+      }
+      result.push_back(SortKeyEnd);
+      return;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief check if two json values are the same
 ////////////////////////////////////////////////////////////////////////////////
@@ -868,6 +1037,328 @@ uint64_t TRI_HashJsonByAttributes (TRI_json_t const* json,
   return hash;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends an unsigned integer in variable-length binary encoding
+///
+/// Each byte carries 7 bits of the value, least significant bits first. The
+/// high bit is set in all bytes but the last.
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_AppendVarUInt64Binary (TRI_string_buffer_t* buffer,
+                               uint64_t value) {
+  char data[10];
+  size_t length = 0;
+
+  while (value >= 0x80) {
+    data[length++] = static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  data[length++] = static_cast<char>(value);
+
+  return TRI_AppendString2StringBuffer(buffer, data, length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads an unsigned integer in variable-length binary encoding
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_ReadVarUInt64Binary (char const** position,
+                              char const* end,
+                              uint64_t* value) {
+  char const* p = *position;
+  uint64_t result = 0;
+  unsigned int shift = 0;
+
+  while (p < end && shift < 64) {
+    uint8_t b = static_cast<uint8_t>(*p++);
+
+    result |= static_cast<uint64_t>(b & 0x7f) << shift;
+
+    if ((b & 0x80) == 0) {
+      *position = p;
+      *value = result;
+      return true;
+    }
+
+    shift += 7;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a binary representation of a JSON value
+///
+/// Every value starts with its type byte (TRI_json_type_e). Booleans follow
+/// as one byte, numbers as the 8 bytes of the double in little endian order.
+/// Strings follow as their length and their bytes plus a terminating NUL.
+/// Arrays and objects follow as their number of members and the members,
+/// object members as the key (encoded like a string, without type byte)
+/// and the value.
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_EncodeBinaryJson (TRI_string_buffer_t* buffer,
+                          TRI_json_t const* json) {
+  if (json == nullptr) {
+    return TRI_AppendCharStringBuffer(buffer, (char) TRI_JSON_NULL);
+  }
+
+  int res;
+
+  switch (json->_type) {
+    case TRI_JSON_UNUSED:
+    case TRI_JSON_NULL: {
+      return TRI_AppendCharStringBuffer(buffer, (char) TRI_JSON_NULL);
+    }
+
+    case TRI_JSON_BOOLEAN: {
+      res = TRI_AppendCharStringBuffer(buffer, (char) TRI_JSON_BOOLEAN);
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = TRI_AppendCharStringBuffer(buffer, json->_value._boolean ? 1 : 0);
+      }
+
+      return res;
+    }
+
+    case TRI_JSON_NUMBER: {
+      uint64_t bits;
+      memcpy(&bits, &json->_value._number, sizeof(bits));
+
+      char data[9];
+      data[0] = (char) TRI_JSON_NUMBER;
+
+      for (size_t i = 0; i < 8; ++i) {
+        data[i + 1] = static_cast<char>((bits >> (8 * i)) & 0xff);
+      }
+
+      return TRI_AppendString2StringBuffer(buffer, data, sizeof(data));
+    }
+
+    case TRI_JSON_STRING:
+    case TRI_JSON_STRING_REFERENCE: {
+      // the blob length includes the terminating NUL
+      size_t length = json->_value._string.length - 1;
+
+      res = TRI_AppendCharStringBuffer(buffer, (char) TRI_JSON_STRING);
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = TRI_AppendVarUInt64Binary(buffer, (uint64_t) length);
+      }
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = TRI_AppendString2StringBuffer(buffer, json->_value._string.data, length + 1);
+      }
+
+      return res;
+    }
+
+    case TRI_JSON_ARRAY: {
+      size_t const n = json->_value._objects._length;
+
+      res = TRI_AppendCharStringBuffer(buffer, (char) TRI_JSON_ARRAY);
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = TRI_AppendVarUInt64Binary(buffer, (uint64_t) n);
+      }
+
+      for (size_t i = 0;  i < n && res == TRI_ERROR_NO_ERROR;  ++i) {
+        res = TRI_EncodeBinaryJson(buffer, static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i)));
+      }
+
+      return res;
+    }
+
+    case TRI_JSON_OBJECT: {
+      size_t const n = json->_value._objects._length;
+
+      res = TRI_AppendCharStringBuffer(buffer, (char) TRI_JSON_OBJECT);
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = TRI_AppendVarUInt64Binary(buffer, (uint64_t) (n / 2));
+      }
+
+      for (size_t i = 0;  i + 1 < n && res == TRI_ERROR_NO_ERROR;  i += 2) {
+        auto key = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
+        size_t length = key->_value._string.length - 1;
+
+        res = TRI_AppendVarUInt64Binary(buffer, (uint64_t) length);
+
+        if (res == TRI_ERROR_NO_ERROR) {
+          res = TRI_AppendString2StringBuffer(buffer, key->_value._string.data, length + 1);
+        }
+
+        if (res == TRI_ERROR_NO_ERROR) {
+          res = TRI_EncodeBinaryJson(buffer, static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i + 1)));
+        }
+      }
+
+      return res;
+    }
+  }
+
+  return TRI_ERROR_INTERNAL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a binary encoded string, returns a pointer to its NUL
+/// terminated bytes inside the input
+////////////////////////////////////////////////////////////////////////////////
+
+static char const* ReadBinaryString (char const** position,
+                                     char const* end,
+                                     size_t* length) {
+  uint64_t n;
+
+  if (! TRI_ReadVarUInt64Binary(position, end, &n)) {
+    return nullptr;
+  }
+
+  char const* p = *position;
+
+  if (n >= (uint64_t) (end - p) || p[n] != '\0') {
+    return nullptr;
+  }
+
+  *position = p + n + 1;
+  *length = (size_t) n;
+
+  return p;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a JSON value from its binary representation
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_DecodeBinaryJson (TRI_memory_zone_t* zone,
+                                  char const** position,
+                                  char const* end) {
+  char const* p = *position;
+
+  if (p >= end) {
+    return nullptr;
+  }
+
+  TRI_json_type_e type = static_cast<TRI_json_type_e>(*p++);
+  TRI_json_t* result = nullptr;
+
+  switch (type) {
+    case TRI_JSON_NULL: {
+      result = TRI_CreateNullJson(zone);
+      break;
+    }
+
+    case TRI_JSON_BOOLEAN: {
+      if (p >= end) {
+        return nullptr;
+      }
+
+      result = TRI_CreateBooleanJson(zone, *p++ != 0);
+      break;
+    }
+
+    case TRI_JSON_NUMBER: {
+      if (end - p < 8) {
+        return nullptr;
+      }
+
+      uint64_t bits = 0;
+
+      for (size_t i = 0; i < 8; ++i) {
+        bits |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+      }
+      p += 8;
+
+      double value;
+      memcpy(&value, &bits, sizeof(value));
+
+      result = TRI_CreateNumberJson(zone, value);
+      break;
+    }
+
+    case TRI_JSON_STRING: {
+      size_t length;
+      char const* data = ReadBinaryString(&p, end, &length);
+
+      if (data == nullptr) {
+        return nullptr;
+      }
+
+      result = TRI_CreateStringCopyJson(zone, data, length);
+      break;
+    }
+
+    case TRI_JSON_ARRAY: {
+      uint64_t n;
+
+      // every member needs at least one byte
+      if (! TRI_ReadVarUInt64Binary(&p, end, &n) || n > (uint64_t) (end - p)) {
+        return nullptr;
+      }
+
+      result = TRI_CreateArrayJson(zone, (size_t) n);
+
+      if (result == nullptr) {
+        return nullptr;
+      }
+
+      for (uint64_t i = 0; i < n; ++i) {
+        TRI_json_t* member = TRI_DecodeBinaryJson(zone, &p, end);
+
+        if (member == nullptr ||
+            TRI_PushBack3ArrayJson(zone, result, member) != TRI_ERROR_NO_ERROR) {
+          TRI_FreeJson(zone, result);
+          return nullptr;
+        }
+      }
+      break;
+    }
+
+    case TRI_JSON_OBJECT: {
+      uint64_t n;
+
+      // every member needs at least three bytes
+      if (! TRI_ReadVarUInt64Binary(&p, end, &n) || n > (uint64_t) (end - p)) {
+        return nullptr;
+      }
+
+      result = TRI_CreateObjectJson(zone, (size_t) (2 * n));
+
+      if (result == nullptr) {
+        return nullptr;
+      }
+
+      for (uint64_t i = 0; i < n; ++i) {
+        size_t length;
+        char const* key = ReadBinaryString(&p, end, &length);
+        TRI_json_t* value = nullptr;
+
+        if (key != nullptr) {
+          value = TRI_DecodeBinaryJson(zone, &p, end);
+        }
+
+        if (value == nullptr) {
+          TRI_FreeJson(zone, result);
+          return nullptr;
+        }
+
+        TRI_Insert3ObjectJson(zone, result, key, value);
+      }
+      break;
+    }
+
+    default: {
+      return nullptr;
+    }
+  }
+
+  if (result != nullptr) {
+    *position = p;
+  }
+
+  return result;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -55,6 +55,20 @@ int TRI_CompareValuesJson (TRI_json_t const*,
                            TRI_json_t const*,
                            bool useUTF8 = true);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a normalized sort key for a json value to result
+///
+/// comparing the sort keys of two values with memcmp gives the same order as
+/// TRI_CompareValuesJson with the same useUTF8 setting, and equal values have
+/// equal keys. a key never is a prefix of another key, so the keys of several
+/// values can be concatenated, and a key can be inverted bytewise to reverse
+/// its order. all keys start with a byte greater than 0x01
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AppendSortKeyJson (std::string&,
+                            TRI_json_t const*,
+                            bool useUTF8 = true);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief check if two json values are the same
 ////////////////////////////////////////////////////////////////////////////////
@@ -157,6 +171,40 @@ uint64_t TRI_HashJsonByAttributes (TRI_json_t const* json,
                                    bool docComplete,
                                    int* error);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends an unsigned integer in variable-length binary encoding
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_AppendVarUInt64Binary (struct TRI_string_buffer_s*, uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads an unsigned integer in variable-length binary encoding and
+/// advances the position, returns false if the input is malformed
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_ReadVarUInt64Binary (char const** position,
+                              char const* end,
+                              uint64_t* value);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a binary representation of a JSON value
+///
+/// The binary representation can be turned into a JSON value again by
+/// TRI_DecodeBinaryJson without any parsing of text.
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_EncodeBinaryJson (struct TRI_string_buffer_s*,
+                          TRI_json_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a JSON value from its binary representation and advances
+/// the position, returns a nullptr if the input is malformed
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_DecodeBinaryJson (TRI_memory_zone_t*,
+                                  char const** position,
+                                  char const* end);
+
 #endif
 
 // -----------------------------------------------------------------------------
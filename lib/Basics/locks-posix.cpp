@@ -51,6 +51,68 @@
 
 #define BUSY_LOCK_DELAY        (10 * 1000)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the platform has pthread_rwlock_timedrdlock and
+/// pthread_rwlock_timedwrlock
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(_POSIX_TIMEOUTS) && _POSIX_TIMEOUTS > 0
+#define TRI_HAVE_TIMED_RWLOCKS 1
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+#ifdef TRI_HAVE_TIMED_RWLOCKS
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes the absolute deadline for a timed lock
+////////////////////////////////////////////////////////////////////////////////
+
+static void LockDeadline (uint64_t timeout,
+                          struct timespec* deadline) {
+  clock_gettime(CLOCK_REALTIME, deadline);
+
+  uint64_t nsec = (uint64_t) deadline->tv_nsec + (timeout % 1000000ULL) * 1000ULL;
+
+  deadline->tv_sec  += (time_t) (timeout / 1000000ULL + nsec / 1000000000ULL);
+  deadline->tv_nsec  = (long) (nsec % 1000000000ULL);
+}
+
+#else
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief polls a lock until it is acquired or the timeout is reached
+///
+/// the delay between two attempts starts small and is doubled up to
+/// BUSY_LOCK_DELAY, so that short waits are not stretched to a full delay
+////////////////////////////////////////////////////////////////////////////////
+
+static bool PollLock (TRI_read_write_lock_t* lock,
+                      uint64_t timeout,
+                      bool (*tryLock) (TRI_read_write_lock_t*)) {
+  uint64_t waited = 0;
+  uint64_t delay = 1;
+
+  while (! tryLock(lock)) {
+    if (waited > timeout) {
+      return false;
+    }
+
+    usleep((useconds_t) delay);
+    waited += delay;
+
+    if (delay < BUSY_LOCK_DELAY) {
+      delay *= 2;
+    }
+  }
+
+  return true;
+}
+
+#endif
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                             MUTEX
 // -----------------------------------------------------------------------------
@@ -264,6 +326,44 @@ again:
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read locks read-write lock, waiting at most timeout microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_TimedReadLockReadWriteLock (TRI_read_write_lock_t* lock,
+                                     uint64_t timeout) {
+#ifdef TRI_HAVE_TIMED_RWLOCKS
+  struct timespec deadline;
+  LockDeadline(timeout, &deadline);
+
+  while (true) {
+    int rc = pthread_rwlock_timedrdlock(lock, &deadline);
+
+    if (rc == 0) {
+      return true;
+    }
+
+    if (rc != EAGAIN) {
+      // ETIMEDOUT, or an error
+      if (rc == EDEADLK) {
+        LOG_ERROR("rw-lock deadlock detected");
+      }
+      return false;
+    }
+
+    // too many concurrent read locks, wait in a busy loop as
+    // TRI_ReadLockReadWriteLock does
+    if (timeout < BUSY_LOCK_DELAY) {
+      return false;
+    }
+    timeout -= BUSY_LOCK_DELAY;
+    usleep(BUSY_LOCK_DELAY);
+  }
+#else
+  return PollLock(lock, timeout, TRI_TryReadLockReadWriteLock);
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read unlocks read-write lock
 ////////////////////////////////////////////////////////////////////////////////
@@ -313,6 +413,28 @@ void TRI_WriteLockReadWriteLock (TRI_read_write_lock_t* lock) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write locks read-write lock, waiting at most timeout microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_TimedWriteLockReadWriteLock (TRI_read_write_lock_t* lock,
+                                      uint64_t timeout) {
+#ifdef TRI_HAVE_TIMED_RWLOCKS
+  struct timespec deadline;
+  LockDeadline(timeout, &deadline);
+
+  int rc = pthread_rwlock_timedwrlock(lock, &deadline);
+
+  if (rc == EDEADLK) {
+    LOG_ERROR("rw-lock deadlock detected");
+  }
+
+  return (rc == 0);
+#else
+  return PollLock(lock, timeout, TRI_TryWriteLockReadWriteLock);
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write unlocks read-write lock
 ////////////////////////////////////////////////////////////////////////////////
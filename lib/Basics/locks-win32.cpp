@@ -227,6 +227,34 @@ static void DecrementReaders (TRI_read_write_lock_t* lock) {
 }
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief polls a lock until it is acquired or the timeout is reached
+///
+/// the delay between two attempts starts small and is doubled up to 10 ms
+////////////////////////////////////////////////////////////////////////////////
+
+static bool PollLock (TRI_read_write_lock_t* lock,
+                      uint64_t timeout,
+                      bool (*tryLock) (TRI_read_write_lock_t*)) {
+  uint64_t waited = 0;
+  uint64_t delay = 1;
+
+  while (! tryLock(lock)) {
+    if (waited > timeout) {
+      return false;
+    }
+
+    usleep((unsigned long) delay);
+    waited += delay;
+
+    if (delay < 10 * 1000) {
+      delay *= 2;
+    }
+  }
+
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -361,6 +389,15 @@ void TRI_ReadLockReadWriteLock (TRI_read_write_lock_t* lock) {
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read locks read-write lock, waiting at most timeout microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_TimedReadLockReadWriteLock (TRI_read_write_lock_t* lock,
+                                     uint64_t timeout) {
+  return PollLock(lock, timeout, TRI_TryReadLockReadWriteLock);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read unlocks read-write lock
 ////////////////////////////////////////////////////////////////////////////////
@@ -505,6 +542,15 @@ void TRI_WriteLockReadWriteLock (TRI_read_write_lock_t* lock) {
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write locks read-write lock, waiting at most timeout microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_TimedWriteLockReadWriteLock (TRI_read_write_lock_t* lock,
+                                      uint64_t timeout) {
+  return PollLock(lock, timeout, TRI_TryWriteLockReadWriteLock);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write unlocks read-write lock
 ////////////////////////////////////////////////////////////////////////////////
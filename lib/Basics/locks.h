@@ -208,6 +208,17 @@ bool TRI_TryReadLockReadWriteLock (TRI_read_write_lock_t* lock);
 
 void TRI_ReadLockReadWriteLock (TRI_read_write_lock_t* lock);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read locks read-write lock, waiting at most timeout microseconds
+///
+/// returns false if the lock could not be acquired in time. the caller is
+/// woken up as soon as the lock becomes available, where the platform
+/// supports timed read-write locks
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_TimedReadLockReadWriteLock (TRI_read_write_lock_t* lock,
+                                     uint64_t timeout);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read unlocks read-write lock
 ////////////////////////////////////////////////////////////////////////////////
@@ -226,6 +237,15 @@ bool TRI_TryWriteLockReadWriteLock (TRI_read_write_lock_t* lock);
 
 void TRI_WriteLockReadWriteLock (TRI_read_write_lock_t* lock);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write locks read-write lock, waiting at most timeout microseconds
+///
+/// returns false if the lock could not be acquired in time
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_TimedWriteLockReadWriteLock (TRI_read_write_lock_t* lock,
+                                      uint64_t timeout);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write unlocks read-write lock
 ////////////////////////////////////////////////////////////////////////////////
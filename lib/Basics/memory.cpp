@@ -84,6 +84,40 @@
 #define REALLOC_WRAPPER(zone, ptr, n) BuiltInRealloc(ptr, n)
 #endif
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief chunk of an arena memory zone
+///
+/// the chunk data follows the header. Each allocation in the chunk is
+/// preceded by its size, so that reallocations can copy the old contents
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct arena_chunk_s {
+  struct arena_chunk_s* _next;
+  uint64_t _size;
+  uint64_t _used;
+}
+arena_chunk_t;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief arena memory zone
+///
+/// the zone, the arena and its first chunk are allocated as one block. New
+/// allocations are always taken from the head of the chunk list
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct arena_s {
+  TRI_memory_zone_t _zone;
+  arena_chunk_t* _chunks;
+  uint64_t _chunkSize;
+  uint64_t _reserved;
+  arena_chunk_t _first;
+}
+arena_t;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -116,6 +150,24 @@ static int CoreInitialised = 0;
 /// @brief configuration parameters for memory error tests
 ////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of bytes currently reserved by all arena zones
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<uint64_t> ArenaCurrent(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief high-water mark of ArenaCurrent
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<uint64_t> ArenaPeak(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief high-water mark of a single arena zone
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<uint64_t> ArenaLargest(0);
+
 #ifdef TRI_ENABLE_FAILURE_TESTS
 static size_t FailMinSize      = 0;
 static double FailProbability  = 0.0;
@@ -263,6 +315,139 @@ static void InitFailMalloc (void) {
 
 #endif
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                           private arena functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief rounds a size up to the alignment of arena allocations
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint64_t ArenaAlign (uint64_t n) {
+  return (n + sizeof(uint64_t) - 1) & ~((uint64_t) sizeof(uint64_t) - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the start of the data of an arena chunk
+////////////////////////////////////////////////////////////////////////////////
+
+static inline char* ArenaData (arena_chunk_t* chunk) {
+  return reinterpret_cast<char*>(chunk) + sizeof(arena_chunk_t);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief raises an atomic high-water mark
+////////////////////////////////////////////////////////////////////////////////
+
+static void ArenaRaiseMark (std::atomic<uint64_t>& mark,
+                            uint64_t value) {
+  uint64_t old = mark.load(std::memory_order_relaxed);
+
+  while (old < value &&
+         ! mark.compare_exchange_weak(old, value, std::memory_order_relaxed)) {
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief accounts for memory reserved by an arena zone
+////////////////////////////////////////////////////////////////////////////////
+
+static void ArenaReserved (arena_t* arena,
+                           uint64_t n) {
+  arena->_reserved += n;
+
+  ArenaRaiseMark(ArenaPeak, ArenaCurrent.fetch_add(n, std::memory_order_relaxed) + n);
+  ArenaRaiseMark(ArenaLargest, arena->_reserved);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates memory in an arena zone
+////////////////////////////////////////////////////////////////////////////////
+
+static void* ArenaAllocate (arena_t* arena,
+                            uint64_t n,
+                            bool set) {
+  uint64_t const needed = sizeof(uint64_t) + ArenaAlign(n);
+  arena_chunk_t* chunk = arena->_chunks;
+
+  if (chunk->_size - chunk->_used < needed) {
+    // big requests get a chunk of their own, which is put behind the head
+    // so the remaining space of the head chunk is not wasted
+    bool const big = (needed > arena->_chunkSize / 4);
+    uint64_t const size = big ? needed : arena->_chunkSize;
+
+    chunk = static_cast<arena_chunk_t*>(MALLOC_WRAPPER(&arena->_zone, (size_t) (sizeof(arena_chunk_t) + size)));
+
+    if (chunk == nullptr) {
+      TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+      return nullptr;
+    }
+
+    chunk->_size = size;
+    chunk->_used = 0;
+
+    if (big) {
+      chunk->_next = arena->_chunks->_next;
+      arena->_chunks->_next = chunk;
+    }
+    else {
+      chunk->_next = arena->_chunks;
+      arena->_chunks = chunk;
+    }
+
+    ArenaReserved(arena, sizeof(arena_chunk_t) + size);
+  }
+
+  char* p = ArenaData(chunk) + chunk->_used;
+  chunk->_used += needed;
+
+  * reinterpret_cast<uint64_t*>(p) = n;
+  p += sizeof(uint64_t);
+
+  if (set) {
+    memset(p, 0, (size_t) n);
+  }
+
+  return p;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reallocates memory in an arena zone
+///
+/// the last allocation of the head chunk is grown in place if possible,
+/// otherwise the contents are copied to a new allocation
+////////////////////////////////////////////////////////////////////////////////
+
+static void* ArenaReallocate (arena_t* arena,
+                              void* m,
+                              uint64_t n) {
+  char* p = static_cast<char*>(m);
+  uint64_t* header = reinterpret_cast<uint64_t*>(p - sizeof(uint64_t));
+  uint64_t const old = *header;
+
+  if (n <= old) {
+    return m;
+  }
+
+  arena_chunk_t* chunk = arena->_chunks;
+
+  if (p + ArenaAlign(old) == ArenaData(chunk) + chunk->_used &&
+      chunk->_size - chunk->_used >= ArenaAlign(n) - ArenaAlign(old)) {
+    chunk->_used += ArenaAlign(n) - ArenaAlign(old);
+    *header = n;
+
+    return m;
+  }
+
+  void* copy = ArenaAllocate(arena, n, false);
+
+  if (copy != nullptr) {
+    memcpy(copy, m, (size_t) old);
+  }
+
+  return copy;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
@@ -332,6 +517,10 @@ void* TRI_Allocate (TRI_memory_zone_t* zone, uint64_t n, bool set) {
 #endif
   char* m;
 
+  if (zone->_impl != nullptr) {
+    return ArenaAllocate(static_cast<arena_t*>(zone->_impl), n, set);
+  }
+
 #ifdef TRI_ENABLE_MAINTAINER_MODE
   CheckSize(n, file, line);
 
@@ -413,6 +602,10 @@ void* TRI_Reallocate (TRI_memory_zone_t* zone, void* m, uint64_t n) {
 #endif
   }
 
+  if (zone->_impl != nullptr) {
+    return ArenaReallocate(static_cast<arena_t*>(zone->_impl), m, n);
+  }
+
   p = (char*) m;
 
 #ifdef TRI_ENABLE_MAINTAINER_MODE
@@ -483,6 +676,11 @@ void TRI_FreeZ (TRI_memory_zone_t* zone, void* m, char const* file, int line) {
 void TRI_Free (TRI_memory_zone_t* zone, void* m) {
 #endif
 
+  if (zone->_impl != nullptr) {
+    // memory of arena zones is released with the zone
+    return;
+  }
+
 #ifdef TRI_ENABLE_MAINTAINER_MODE
   char* p;
 
@@ -538,6 +736,90 @@ void TRI_SystemFree (void* p) {
   free(p);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an arena memory zone
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_memory_zone_t* TRI_CreateArenaMemoryZone (size_t chunkSize) {
+  if (chunkSize < 256) {
+    chunkSize = 256;
+  }
+
+  chunkSize = (size_t) ArenaAlign(chunkSize);
+
+  arena_t* arena = static_cast<arena_t*>(BuiltInMalloc(sizeof(arena_t) + chunkSize));
+
+  if (arena == nullptr) {
+    TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+    return nullptr;
+  }
+
+  arena->_zone._zid      = 2;
+  arena->_zone._failed   = false;
+  arena->_zone._failable = true;
+  arena->_zone._impl     = arena;
+
+  arena->_first._next = nullptr;
+  arena->_first._size = chunkSize;
+  arena->_first._used = 0;
+
+  arena->_chunks    = &arena->_first;
+  arena->_chunkSize = chunkSize;
+  arena->_reserved  = 0;
+
+  ArenaReserved(arena, sizeof(arena_t) + chunkSize);
+
+  return &arena->_zone;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees an arena memory zone and all memory allocated in it
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FreeArenaMemoryZone (TRI_memory_zone_t* zone) {
+  arena_t* arena = static_cast<arena_t*>(zone->_impl);
+
+  TRI_ASSERT(arena != nullptr);
+
+  arena_chunk_t* chunk = arena->_chunks;
+
+  while (chunk != nullptr) {
+    arena_chunk_t* next = chunk->_next;
+
+    if (chunk != &arena->_first) {
+      free(chunk);
+    }
+
+    chunk = next;
+  }
+
+  ArenaCurrent.fetch_sub(arena->_reserved, std::memory_order_relaxed);
+
+  free(arena);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of bytes reserved by an arena memory zone
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t TRI_SizeArenaMemoryZone (TRI_memory_zone_t const* zone) {
+  TRI_ASSERT(zone->_impl != nullptr);
+
+  return static_cast<arena_t const*>(zone->_impl)->_reserved;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the arena memory statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_GetArenaMemoryStatistics (uint64_t* current,
+                                   uint64_t* peak,
+                                   uint64_t* largest) {
+  *current = ArenaCurrent.load(std::memory_order_relaxed);
+  *peak    = ArenaPeak.load(std::memory_order_relaxed);
+  *largest = ArenaLargest.load(std::memory_order_relaxed);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief wrapper for realloc
 ///
@@ -566,10 +848,12 @@ void TRI_InitialiseMemory () {
     TriCoreMemZone._zid      = 0;
     TriCoreMemZone._failed   = false;
     TriCoreMemZone._failable = false;
+    TriCoreMemZone._impl     = nullptr;
 
     TriUnknownMemZone._zid      = 1;
     TriUnknownMemZone._failed   = false;
     TriUnknownMemZone._failable = true;
+    TriUnknownMemZone._impl     = nullptr;
 
 #ifdef TRI_ENABLE_FAILURE_TESTS 
     InitFailMalloc(); 
@@ -141,6 +141,46 @@ void TRI_SystemFreeZ (void*, char const*, int);
 void TRI_SystemFree (void*);
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an arena memory zone
+///
+/// An arena zone hands out memory from a list of chunks with a bump pointer.
+/// TRI_Free is a no-op for memory allocated in an arena zone, and all memory
+/// is released at once by TRI_FreeArenaMemoryZone. This is meant for
+/// allocations that all die together, e.g. at the end of a query or request.
+/// Arena zones are not thread-safe, and memory allocated in an arena zone
+/// must only be passed to TRI_Reallocate and TRI_Free with the same zone.
+///
+/// @chunkSize is the size of the chunks requested from the system. Requests
+/// bigger than a quarter of the chunk size get a chunk of their own.
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_memory_zone_t* TRI_CreateArenaMemoryZone (size_t chunkSize);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees an arena memory zone and all memory allocated in it
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FreeArenaMemoryZone (TRI_memory_zone_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of bytes reserved by an arena memory zone
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t TRI_SizeArenaMemoryZone (TRI_memory_zone_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the arena memory statistics
+///
+/// @current is the number of bytes currently reserved by all arena zones,
+/// @peak is the high-water mark of @current, and @largest is the high-water
+/// mark of a single arena zone.
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_GetArenaMemoryStatistics (uint64_t* current,
+                                   uint64_t* peak,
+                                   uint64_t* largest);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief wrapper for realloc
 ///
@@ -37,6 +37,7 @@
 #include <sys/resource.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/wait.h>
 #endif
 
@@ -120,6 +121,43 @@ int TRI_writesocket (TRI_socket_t s, const void* buffer, size_t numBytesToWrite,
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes two buffers to a socket with a single gather write
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_writevsocket (TRI_socket_t s,
+                      const void* buffer1,
+                      size_t length1,
+                      const void* buffer2,
+                      size_t length2) {
+  int res;
+#ifdef _WIN32
+    WSABUF buffers[2];
+    DWORD sent = 0;
+
+    buffers[0].buf = (char*) buffer1;
+    buffers[0].len = (ULONG) length1;
+    buffers[1].buf = (char*) buffer2;
+    buffers[1].len = (ULONG) length2;
+
+    res = WSASend(s.fileHandle, buffers, 2, &sent, 0, NULL, NULL);
+
+    if (res == 0) {
+      res = (int) sent;
+    }
+#else
+    struct iovec buffers[2];
+
+    buffers[0].iov_base = (void*) buffer1;
+    buffers[0].iov_len  = length1;
+    buffers[1].iov_base = (void*) buffer2;
+    buffers[1].iov_len  = length2;
+
+    res = (int) writev(s.fileDescriptor, buffers, 2);
+#endif
+  return res;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets close-on-exit for a socket
 ////////////////////////////////////////////////////////////////////////////////
@@ -290,6 +290,20 @@ int TRI_readsocket (TRI_socket_t, void* buffer, size_t numBytesToRead, int flags
 
 int TRI_writesocket (TRI_socket_t, const void* buffer, size_t numBytesToWrite, int flags);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes two buffers to a socket with a single gather write
+///
+/// returns the number of bytes written (which may be less than the combined
+/// length of both buffers), or -1 on error. The error is in errno, or in
+/// WSAGetLastError() on Windows
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_writevsocket (TRI_socket_t,
+                      const void* buffer1,
+                      size_t length1,
+                      const void* buffer2,
+                      size_t length2);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets non-blocking mode for a socket
 ////////////////////////////////////////////////////////////////////////////////
@@ -407,19 +407,45 @@ void  TRI_FreeStringBuffer (TRI_memory_zone_t* zone, TRI_string_buffer_t * self)
 
 int TRI_DeflateStringBuffer (TRI_string_buffer_t* self,
                              size_t bufferSize) {
+  return TRI_CompressStringBuffer(self, bufferSize, false, 0, nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compress the string buffer using deflate or gzip
+///
+/// if maxLength is not 0, compression is given up as soon as the compressed
+/// data grows beyond maxLength bytes. the string buffer is left unmodified
+/// in this case, and compressed is set to false
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_CompressStringBuffer (TRI_string_buffer_t* self,
+                              size_t bufferSize,
+                              bool gzip,
+                              size_t maxLength,
+                              bool* compressed) {
   TRI_string_buffer_t deflated;
   const char* ptr;
   const char* end;
   char* buffer;
   int res;
 
+  if (compressed != nullptr) {
+    *compressed = false;
+  }
+
   z_stream strm;
   strm.zalloc = Z_NULL;
   strm.zfree  = Z_NULL;
   strm.opaque = Z_NULL;
 
   // initialise deflate procedure
-  res = deflateInit(&strm, Z_DEFAULT_COMPRESSION);
+  // adding 16 to the window bits makes zlib write a gzip header and trailer
+  res = deflateInit2(&strm,
+                     Z_DEFAULT_COMPRESSION,
+                     Z_DEFLATED,
+                     gzip ? MAX_WBITS + 16 : MAX_WBITS,
+                     8,
+                     Z_DEFAULT_STRATEGY);
 
   if (res != Z_OK) {
     return TRI_ERROR_OUT_OF_MEMORY;
@@ -474,6 +500,15 @@ int TRI_DeflateStringBuffer (TRI_string_buffer_t* self,
 
         return TRI_ERROR_OUT_OF_MEMORY;
       }
+
+      if (maxLength > 0 && TRI_LengthStringBuffer(&deflated) > maxLength) {
+        // compression does not pay off. leave the original data alone
+        (void) deflateEnd(&strm);
+        TRI_Free(TRI_UNKNOWN_MEM_ZONE, buffer);
+        TRI_DestroyStringBuffer(&deflated);
+
+        return TRI_ERROR_NO_ERROR;
+      }
     }
     while (strm.avail_out == 0);
   }
@@ -486,6 +521,10 @@ int TRI_DeflateStringBuffer (TRI_string_buffer_t* self,
 
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, buffer);
 
+  if (compressed != nullptr) {
+    *compressed = true;
+  }
+
   return TRI_ERROR_NO_ERROR;
 }
 
@@ -116,6 +116,20 @@ void TRI_FreeStringBuffer (TRI_memory_zone_t*, TRI_string_buffer_t *);
 int TRI_DeflateStringBuffer (TRI_string_buffer_t*,
                              size_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compress the string buffer using deflate or gzip
+///
+/// if the last but one argument is not 0, compression is given up as soon as
+/// the compressed data grows beyond this many bytes. the string buffer is left
+/// unmodified in this case
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_CompressStringBuffer (TRI_string_buffer_t*,
+                              size_t,
+                              bool,
+                              size_t,
+                              bool*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief ensure the string buffer has a specific capacity
 ////////////////////////////////////////////////////////////////////////////////
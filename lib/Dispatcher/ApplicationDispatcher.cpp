@@ -132,7 +132,14 @@ void ApplicationDispatcher::buildStandardQueue (size_t nrThreads,
   LOG_TRACE("setting up a standard queue with %d threads", (int) nrThreads);
 
   TRI_ASSERT(_dispatcher != nullptr);
-  _dispatcher->addStandardQueue(nrThreads, maxSize);
+
+  size_t nrShards = 1;
+
+  if (_applicationScheduler != nullptr) {
+    nrShards = _applicationScheduler->numberOfShards();
+  }
+
+  _dispatcher->addStandardQueue(nrThreads, maxSize, nrShards);
 }
 
 // -----------------------------------------------------------------------------
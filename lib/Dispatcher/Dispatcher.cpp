@@ -37,6 +37,7 @@
 #include "Dispatcher/DispatcherQueue.h"
 #include "Dispatcher/DispatcherThread.h"
 #include "Dispatcher/Job.h"
+#include "Scheduler/SchedulerThread.h"
 
 using namespace std;
 using namespace triagens::basics;
@@ -72,7 +73,10 @@ Dispatcher::Dispatcher (Scheduler* scheduler)
   : _scheduler(scheduler),
     _accessDispatcher(),
     _stopping(0),
-    _queues() {
+    _queues(),
+    _standardShards(),
+    _standardSize(0),
+    _nextShard(0) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -110,21 +114,56 @@ bool Dispatcher::isRunning () {
 ////////////////////////////////////////////////////////////////////////////////
 
 int Dispatcher::addStandardQueue (size_t nrThreads,
-                                  size_t maxSize) {
+                                  size_t maxSize,
+                                  size_t nrShards) {
   MUTEX_LOCKER(_accessDispatcher);
 
   if (_queues.find(QUEUE_NAME) != _queues.end()) {
     return TRI_ERROR_QUEUE_ALREADY_EXISTS;
   }
 
-  _queues[QUEUE_NAME] = new DispatcherQueue(
-    _scheduler,
-    this,
-    QUEUE_NAME,
-    DefaultDispatcherThread,
-    nullptr,
-    nrThreads,
-    maxSize);
+  if (nrShards <= 1) {
+    _queues[QUEUE_NAME] = new DispatcherQueue(
+      _scheduler,
+      this,
+      QUEUE_NAME,
+      DefaultDispatcherThread,
+      nullptr,
+      nrThreads,
+      maxSize);
+
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // split the threads over the shards, each shard gets at least one thread.
+  // the queue size is shared, so an unevenly loaded shard can still use all
+  // of it
+  for (size_t i = 0;  i < nrShards;  ++i) {
+    size_t n = nrThreads / nrShards + (i < nrThreads % nrShards ? 1 : 0);
+
+    if (n == 0) {
+      n = 1;
+    }
+
+    string const name = QUEUE_NAME + "-" + StringUtils::itoa(static_cast<uint64_t>(i));
+
+    DispatcherQueue* queue = new DispatcherQueue(
+      _scheduler,
+      this,
+      name,
+      DefaultDispatcherThread,
+      nullptr,
+      n,
+      maxSize);
+
+    queue->_shard = static_cast<ssize_t>(i);
+    queue->_sharedSize = &_standardSize;
+
+    _queues[name] = queue;
+    _standardShards.push_back(queue);
+  }
+
+  LOG_DEBUG("split standard dispatcher queue into %d shards", (int) nrShards);
 
   return TRI_ERROR_NO_ERROR;
 }
@@ -180,7 +219,14 @@ int Dispatcher::addJob (Job* job) {
 
   // try to find a suitable queue
   string const& name = job->queue();
-  DispatcherQueue* queue = lookupQueue(name);
+  DispatcherQueue* queue;
+
+  if (! _standardShards.empty() && name == QUEUE_NAME) {
+    queue = selectShard();
+  }
+  else {
+    queue = lookupQueue(name);
+  }
 
   if (queue == nullptr) {
     LOG_WARNING("unknown queue '%s'", name.c_str());
@@ -192,10 +238,25 @@ int Dispatcher::addJob (Job* job) {
   LOG_TRACE("added job %p to queue '%s'", (void*) job, name.c_str());
 
   // add the job to the list of ready jobs
-  if (! queue->addJob(job)) {
+  bool idle = true;
+
+  if (! queue->addJob(job, &idle)) {
     return TRI_ERROR_QUEUE_FULL; // queue full etc.
   }
 
+  // no thread of the shard is waiting, so wake up a thread of another shard.
+  // it will take over the job if the shard is still busy when it looks
+  if (! idle) {
+    size_t const n = _standardShards.size();
+    size_t const shard = static_cast<size_t>(queue->_shard);
+
+    for (size_t i = 1;  i < n;  ++i) {
+      if (_standardShards[(shard + i) % n]->wakeupIdleThread()) {
+        break;
+      }
+    }
+  }
+
   // indicate success, BUT never access job after it has been added to the queue
   return TRI_ERROR_NO_ERROR;
 }
@@ -351,6 +412,57 @@ DispatcherQueue* Dispatcher::lookupQueue (const std::string& name) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief selects the shard of the standard queue for a new job
+////////////////////////////////////////////////////////////////////////////////
+
+DispatcherQueue* Dispatcher::selectShard () {
+  size_t const n = _standardShards.size();
+
+  // jobs created by a scheduler thread stay on the shard of that thread
+  ssize_t current = SchedulerThread::currentThreadNumber;
+
+  if (current < 0) {
+
+    // requeued jobs stay on the shard of the dispatcher thread
+    DispatcherThread* thread = DispatcherThread::currentDispatcherThread;
+
+    if (thread != nullptr && thread->_queue->_dispatcher == this) {
+      current = thread->_queue->_shard;
+    }
+  }
+
+  if (current < 0) {
+    return _standardShards[_nextShard++ % n];
+  }
+
+  return _standardShards[static_cast<size_t>(current) % n];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes over a job from a busy sibling shard
+////////////////////////////////////////////////////////////////////////////////
+
+Job* Dispatcher::stealJob (DispatcherQueue* thief) {
+  if (_stopping != 0 || thief->_shard < 0) {
+    return nullptr;
+  }
+
+  size_t const n = _standardShards.size();
+  size_t const shard = static_cast<size_t>(thief->_shard);
+
+  for (size_t i = 1;  i < n;  ++i) {
+    Job* job = _standardShards[(shard + i) % n]->stealJob();
+
+    if (job != nullptr) {
+      LOG_TRACE("dispatcher shard %d took over job %p", (int) shard, (void*) job);
+      return job;
+    }
+  }
+
+  return nullptr;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -103,10 +103,16 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief adds a new queue
+///
+/// If more than one shard is requested, the standard queue is split into
+/// one queue per scheduler thread. Jobs are put into the shard of the
+/// scheduler thread which created them, and idle shards take over jobs from
+/// busy ones. The shards share the queue size.
 ////////////////////////////////////////////////////////////////////////////////
 
         int addStandardQueue (size_t nrThreads,
-                              size_t maxSize);
+                              size_t maxSize,
+                              size_t nrShards = 1);
 
 /////////////////////////////////////////////////////////////////////////
 /// @brief starts a new named queue
@@ -129,6 +135,12 @@ namespace triagens {
 
         int addJob (Job*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes over a job from a busy sibling shard
+////////////////////////////////////////////////////////////////////////////////
+
+        Job* stealJob (DispatcherQueue*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief tries to cancel a job
 ////////////////////////////////////////////////////////////////////////////////
@@ -183,6 +195,12 @@ namespace triagens {
 
         DispatcherQueue* lookupQueue (std::string const&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief selects the shard of the standard queue for a new job
+////////////////////////////////////////////////////////////////////////////////
+
+        DispatcherQueue* selectShard ();
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -213,6 +231,28 @@ namespace triagens {
 
         std::map<std::string, DispatcherQueue*> _queues;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shards of the standard queue
+///
+/// The shards are owned by _queues. The vector is filled before the
+/// dispatcher is started and is not changed afterwards, so it can be read
+/// without holding _accessDispatcher.
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<DispatcherQueue*> _standardShards;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of ready jobs in all shards of the standard queue
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<size_t> _standardSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief round-robin counter for jobs created outside the scheduler
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<size_t> _nextShard;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief standard queue name
 ////////////////////////////////////////////////////////////////////////////////
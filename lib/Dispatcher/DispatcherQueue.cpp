@@ -62,6 +62,7 @@ DispatcherQueue::DispatcherQueue (Scheduler* scheduler,
     _readyJobs(),
     _runningJobs(),
     _maxSize(maxSize),
+    _sharedSize(nullptr),
     _stopping(0),
     _monopolizer(0),
     _startedThreads(),
@@ -78,6 +79,7 @@ DispatcherQueue::DispatcherQueue (Scheduler* scheduler,
     _gracePeriod(5.0),
     _scheduler(scheduler),
     _dispatcher(dispatcher),
+    _shard(-1),
     createDispatcherThread(creator) {
 }
 
@@ -99,13 +101,23 @@ DispatcherQueue::~DispatcherQueue () {
 /// @brief adds a job
 ////////////////////////////////////////////////////////////////////////////////
 
-bool DispatcherQueue::addJob (Job* job) {
+bool DispatcherQueue::addJob (Job* job, bool* idle) {
   TRI_ASSERT(job != 0);
 
   CONDITION_LOCKER(guard, _accessQueue);
 
+  if (idle != nullptr) {
+    *idle = (0 < _nrWaiting);
+  }
+
   // queue is full
-  if (_readyJobs.size() >= _maxSize) {
+  if (_sharedSize != nullptr) {
+    if (_sharedSize->fetch_add(1) >= _maxSize) {
+      _sharedSize->fetch_sub(1);
+      return false;
+    }
+  }
+  else if (_readyJobs.size() >= _maxSize) {
     return false;
   }
 
@@ -125,6 +137,42 @@ bool DispatcherQueue::addJob (Job* job) {
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the first ready job on behalf of an idle sibling shard
+////////////////////////////////////////////////////////////////////////////////
+
+Job* DispatcherQueue::stealJob () {
+  CONDITION_LOCKER(guard, _accessQueue);
+
+  // our own threads will pick up the job soon enough
+  if (_stopping != 0 || 0 < _nrWaiting || _readyJobs.empty()) {
+    return nullptr;
+  }
+
+  // write jobs are taken as well. they monopolize the thief's shard, and a
+  // connection never runs a write request in parallel with other requests
+  Job* job = _readyJobs.front();
+  _readyJobs.pop_front();
+
+  return job;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wakes up one waiting thread
+////////////////////////////////////////////////////////////////////////////////
+
+bool DispatcherQueue::wakeupIdleThread () {
+  CONDITION_LOCKER(guard, _accessQueue);
+
+  if (_stopping != 0 || 0 == _nrWaiting) {
+    return false;
+  }
+
+  guard.signal();
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief tries to cancel a job
 ////////////////////////////////////////////////////////////////////////////////
@@ -170,6 +218,7 @@ bool DispatcherQueue::cancelJob (uint64_t jobId) {
         }
 
         _readyJobs.erase(it);
+        releaseReadyJobs(1);
       }
 
       return true;
@@ -179,6 +228,16 @@ bool DispatcherQueue::cancelJob (uint64_t jobId) {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the capacity of ready jobs which have been removed
+////////////////////////////////////////////////////////////////////////////////
+
+void DispatcherQueue::releaseReadyJobs (size_t n) {
+  if (_sharedSize != nullptr && 0 < n) {
+    _sharedSize->fetch_sub(n);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief downgrades the thread to special
 ////////////////////////////////////////////////////////////////////////////////
@@ -280,6 +339,7 @@ void DispatcherQueue::beginShutdown () {
         }
       }
     }
+    releaseReadyJobs(_readyJobs.size());
     _readyJobs.clear();
   }
 
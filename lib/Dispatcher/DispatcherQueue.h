@@ -95,7 +95,22 @@ namespace triagens {
 /// @brief adds a job
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool addJob (Job*);
+        bool addJob (Job*, bool* idle = nullptr);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the first ready job on behalf of an idle sibling shard
+///
+/// A job is only handed out if no thread of this queue is waiting for work
+/// itself.
+////////////////////////////////////////////////////////////////////////////////
+
+        Job* stealJob ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wakes up one waiting thread, returns false if there is none
+////////////////////////////////////////////////////////////////////////////////
+
+        bool wakeupIdleThread ();
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief tries to cancel a job
@@ -103,6 +118,12 @@ namespace triagens {
 
         bool cancelJob (uint64_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the capacity of ready jobs which have been removed
+////////////////////////////////////////////////////////////////////////////////
+
+        void releaseReadyJobs (size_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief downgrades the thread to special
 ////////////////////////////////////////////////////////////////////////////////
@@ -199,6 +220,15 @@ namespace triagens {
 
         size_t _maxSize;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of ready jobs of all shards of a sharded standard queue
+///
+/// The shards share the queue size, so _maxSize is checked against this
+/// counter instead of the shard's own jobs. nullptr for unsharded queues.
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<size_t>* _sharedSize;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief queue is shutting down
 ////////////////////////////////////////////////////////////////////////////////
@@ -340,6 +370,12 @@ namespace triagens {
 
         Dispatcher* _dispatcher;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shard number of a sharded standard queue, -1 otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+        ssize_t _shard;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief thread creator function
 ////////////////////////////////////////////////////////////////////////////////
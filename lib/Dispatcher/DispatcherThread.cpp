@@ -101,6 +101,7 @@ void DispatcherThread::run () {
       // try next job
       Job* job = _queue->_readyJobs.front();
       _queue->_readyJobs.pop_front();
+      _queue->releaseReadyJobs(1);
 
       // handle job type
       _jobType = job->type();
@@ -276,6 +277,20 @@ void DispatcherThread::run () {
         }
       }
 
+      // a shard of the standard queue first tries to help its siblings. the
+      // queue lock must not be held while looking at the other shards. the
+      // stolen job keeps its place in the shared queue size
+      if (_queue->_readyJobs.empty() && 0 <= _queue->_shard) {
+        _queue->_accessQueue.unlock();
+        Job* job = _queue->_dispatcher->stealJob(_queue);
+        _queue->_accessQueue.lock();
+
+        if (job != nullptr) {
+          _queue->_readyJobs.push_front(job);
+          continue;
+        }
+      }
+
       // wait, if there are no jobs
       if (_queue->_readyJobs.empty()) {
         _queue->_nrRunning--;
@@ -104,6 +104,10 @@ ApplicationEndpointServer::ApplicationEndpointServer (ApplicationServer* applica
     _defaultApiCompatibility(0),
     _allowMethodOverride(false),
     _backlogSize(64),
+    _compressResponseThreshold(0),
+    _compressResponseMaxSize(128 * 1024 * 1024),
+    _decompressRequests(true),
+    _maximalPipelinedRequests(1),
     _httpsKeyfile(),
     _cafile(),
     _sslProtocol(TLS_V1),
@@ -169,6 +173,7 @@ bool ApplicationEndpointServer::buildServers () {
                           _keepAliveTimeout);
 
   server->setEndpointList(&_endpointList);
+  server->setSchedulerShards(_applicationScheduler->numberOfShards());
   _servers.push_back(server);
 
   // ssl endpoints
@@ -188,6 +193,7 @@ bool ApplicationEndpointServer::buildServers () {
                              _sslContext);
 
     server->setEndpointList(&_endpointList);
+    server->setSchedulerShards(_applicationScheduler->numberOfShards());
     _servers.push_back(server);
   }
 
@@ -215,8 +221,12 @@ void ApplicationEndpointServer::setupOptions (map<string, ProgramOptionsDescript
   options["Server Options:help-admin"]
     ("server.allow-method-override", &_allowMethodOverride, "allow HTTP method override using special headers")
     ("server.backlog-size", &_backlogSize, "listen backlog size")
+    ("server.compress-response-threshold", &_compressResponseThreshold, "minimal response body size for compression (0 = disable compression)")
+    ("server.compress-response-max-size", &_compressResponseMaxSize, "maximal response body size for compression (0 = unlimited)")
+    ("server.decompress-requests", &_decompressRequests, "decompress gzip- or deflate-encoded request bodies")
     ("server.default-api-compatibility", &_defaultApiCompatibility, "default API compatibility version")
     ("server.keep-alive-timeout", &_keepAliveTimeout, "keep-alive timeout in seconds")
+    ("server.maximal-pipelined-requests", &_maximalPipelinedRequests, "maximal number of pipelined GET/HEAD requests executed concurrently per connection")
     ("server.reuse-address", &_reuseAddress, "try to reuse address")
   ;
 
@@ -267,6 +277,10 @@ bool ApplicationEndpointServer::parsePhase2 (ProgramOptions& options) {
     }
   }
 
+  if (_maximalPipelinedRequests == 0) {
+    LOG_FATAL_AND_EXIT("invalid value for --server.maximal-pipelined-requests. expecting a positive value");
+  }
+
   if (_defaultApiCompatibility < HttpRequest::MinCompatibility) {
     LOG_FATAL_AND_EXIT("invalid value for --server.default-api-compatibility. minimum allowed value is %d",
                        (int) HttpRequest::MinCompatibility);
@@ -560,6 +574,14 @@ bool ApplicationEndpointServer::prepare () {
                                            _setContext,
                                            _contextData);
 
+  HttpHandlerFactory::compression_options_t compression;
+  compression.minimalResponseSize = (size_t) _compressResponseThreshold;
+  compression.maximalResponseSize = (size_t) _compressResponseMaxSize;
+  compression.decompressRequests = _decompressRequests;
+
+  _handlerFactory->setCompressionOptions(compression);
+  _handlerFactory->setMaximalPipelinedRequests((size_t) _maximalPipelinedRequests);
+
   LOG_INFO("using default API compatibility: %ld", (long int) _defaultApiCompatibility);
 
   return true;
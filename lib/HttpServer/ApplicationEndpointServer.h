@@ -448,6 +448,80 @@ namespace triagens {
 
         int _backlogSize;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief minimal response body size for compression
+/// @startDocuBlock serverCompressResponseThreshold
+/// `--server.compress-response-threshold`
+///
+/// Response bodies of at least this many bytes are compressed with deflate
+/// or gzip if the client sent a matching *Accept-Encoding* header.
+/// Compression is carried out by the dispatcher thread that executed the
+/// request, so it does not delay the I/O threads. Responses that would not
+/// shrink by at least 10 % are sent uncompressed. Chunked responses and
+/// responses with a *Content-Encoding* of their own are never compressed.
+/// Responses that are eligible for compression carry a *Vary:
+/// Accept-Encoding* header.
+///
+/// Compression costs CPU time on every eligible response. This includes
+/// the traffic between coordinators and DBservers in a cluster, as the
+/// cluster-internal HTTP client accepts deflated responses.
+///
+/// A value of *0* turns off response compression. The default value is
+/// *0*, so compression must be enabled explicitly, e.g. with a value of
+/// *65536*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _compressResponseThreshold;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal response body size for compression
+/// @startDocuBlock serverCompressResponseMaxSize
+/// `--server.compress-response-max-size`
+///
+/// Response bodies larger than this many bytes are sent uncompressed, so
+/// a single huge response cannot occupy a dispatcher thread for too long.
+/// A value of *0* means no upper bound. The default value is *134217728*
+/// (128 MB).
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _compressResponseMaxSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decompress request bodies
+/// @startDocuBlock serverDecompressRequests
+/// `--server.decompress-requests`
+///
+/// If this option is set to *true*, request bodies sent with a
+/// *Content-Encoding* of *gzip* or *deflate* are decompressed by the
+/// dispatcher thread before the request is handled. Requests with other
+/// encodings are rejected with HTTP 415. The default value is *true*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _decompressRequests;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of pipelined requests executed per connection
+/// @startDocuBlock serverMaximalPipelinedRequests
+/// `--server.maximal-pipelined-requests`
+///
+/// Clients may send several HTTP requests over a connection without waiting
+/// for the responses (HTTP pipelining). This option controls how many of
+/// these requests are executed concurrently. Only *GET* and *HEAD* requests
+/// are executed concurrently; any other request waits until all requests
+/// sent before it have been answered, and is answered before any request
+/// sent after it gets executed. Responses are always sent back in request
+/// order.
+///
+/// The default value is *1*, which executes the requests of a connection
+/// one after the other.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _maximalPipelinedRequests;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief keyfile containing server certificate
 /// @startDocuBlock serverKeyfile
@@ -42,6 +42,35 @@ using namespace triagens::basics;
 using namespace triagens::rest;
 using namespace std;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private constants
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief minimal size of a response body that is not copied into the
+/// output buffer but sent separately using a gather write
+///
+/// copying small bodies is cheaper than the extra allocation
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MinimalGatherBodySize = 4096;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not requests of a type may run concurrently
+///
+/// RFC 7230, 6.3.2: only requests with safe methods can be executed while
+/// earlier requests of the same connection are still in progress
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsSafeRequestType (HttpRequest::HttpRequestType type) {
+  return (type == HttpRequest::HTTP_REQUEST_GET ||
+          type == HttpRequest::HTTP_REQUEST_HEAD);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                            class AsyncChunkedTask
 // -----------------------------------------------------------------------------
@@ -153,13 +182,16 @@ HttpCommTask::HttpCommTask (HttpServer* server,
     _connectionInfo(info),
     _server(server),
     _writeBuffers(),
+    _writeBodies(),
 #ifdef TRI_ENABLE_FIGURES
     _writeBuffersStats(),
 #endif
+    _pendingResponses(),
+    _maximalPipelinedRequests(1),
+    _deferredRequest(false),
     _readPosition(0),
     _bodyPosition(0),
     _bodyLength(0),
-    _requestPending(false),
     _closeRequested(false),
     _readRequestBody(false),
     _request(nullptr),
@@ -192,6 +224,7 @@ HttpCommTask::HttpCommTask (HttpServer* server,
   _maximalHeaderSize = p.maximalHeaderSize;
   _maximalBodySize = p.maximalBodySize;
   _maximalPipelineSize = p.maximalPipelineSize;
+  _maximalPipelinedRequests = server->handlerFactory()->maximalPipelinedRequests();
 
   ConnectionStatisticsAgentSetHttp(this);
   ConnectionStatisticsAgent::release();
@@ -214,6 +247,10 @@ HttpCommTask::~HttpCommTask () {
     delete i;
   }
 
+  for (auto i : _writeBodies) {
+    delete i;
+  }
+
 #ifdef TRI_ENABLE_FIGURES
 
   for (auto i : _writeBuffersStats) {
@@ -222,6 +259,11 @@ HttpCommTask::~HttpCommTask () {
 
 #endif
 
+  // free unanswered responses
+  for (auto i : _pendingResponses) {
+    freePendingResponse(i);
+  }
+
   // free request
   if (_request != nullptr) {
     delete _request;
@@ -261,17 +303,90 @@ void HttpCommTask::beginShutdown ()  {
 /// @brief handles response
 ////////////////////////////////////////////////////////////////////////////////
 
-void HttpCommTask::handleResponse (HttpResponse * response)  {
+void HttpCommTask::handleResponse (HttpResponse * response, HttpHandler* handler)  {
+  pending_response_t* entry = nullptr;
+
+  if (handler != nullptr) {
+    for (auto i : _pendingResponses) {
+      if (i->_handler == handler && ! i->_complete) {
+        entry = i;
+        break;
+      }
+    }
+  }
+
+  if (entry == nullptr) {
+    entry = createPendingResponse(nullptr);
+  }
+
+  TRI_request_statistics_t* statistics;
+
+  if (handler != nullptr) {
+    statistics = handler->RequestStatisticsAgent::transfer();
+  }
+  else {
+    statistics = RequestStatisticsAgent::transfer();
+  }
+
   if (response->isChunked()) {
-    _requestPending = true;
+    entry->_chunked = true;
     _isChunked = true;
   }
   else {
-    _requestPending = false;
-    _isChunked = false;
+    entry->_complete = true;
+  }
+
+  addResponse(response, entry, statistics);
+  flushPendingResponses();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief answers a request whose handler has not produced a response
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::handleMissingResponse (HttpHandler* handler) {
+  pending_response_t* entry = nullptr;
+
+  for (auto i : _pendingResponses) {
+    if (i->_handler == handler && ! i->_complete) {
+      entry = i;
+      break;
+    }
+  }
+
+  if (entry == nullptr) {
+    // the request has been answered already
+    return;
+  }
+
+  if (! entry->_chunked) {
+    try {
+      HttpResponse response(HttpResponse::SERVER_ERROR, HttpRequest::MinCompatibility);
+      handleResponse(&response, handler);
+      return;
+    }
+    catch (...) {
+      LOG_ERROR("cannot create error response");
+    }
   }
 
-  addResponse(response);
+  // the slot cannot be answered properly. the client would mismatch all
+  // further responses, so send the preceding ones and close the connection
+  entry->_handler = nullptr;
+  entry->_complete = true;
+  _closeRequested = true;
+  _isChunked = (chunkedResponse() != nullptr);
+
+  flushPendingResponses();
+
+  if (! _clientClosed &&
+      ! hasWriteBuffer() &&
+      _writeBuffers.empty() &&
+      _pendingResponses.empty() &&
+      ! _isChunked) {
+    _clientClosed = true;
+    _server->handleCommunicationClosed(this);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -279,7 +394,23 @@ void HttpCommTask::handleResponse (HttpResponse * response)  {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool HttpCommTask::processRead () {
-  if (_requestPending || _readBuffer->c_str() == nullptr) {
+  if (_readBuffer->c_str() == nullptr) {
+    return false;
+  }
+
+  if (_deferredRequest) {
+    // the request must wait until all requests before it have been answered
+    if (! _pendingResponses.empty()) {
+      return false;
+    }
+
+    _deferredRequest = false;
+    executeRequest();
+
+    return true;
+  }
+
+  if (! acceptsRequests()) {
     return false;
   }
 
@@ -516,13 +647,18 @@ bool HttpCommTask::processRead () {
           StringBuffer* buffer = new StringBuffer(TRI_UNKNOWN_MEM_ZONE);
           buffer->appendText("HTTP/1.1 100 (Continue)\r\n\r\n");
 
-          _writeBuffers.push_back(buffer);
+          // the interim response must not overtake earlier responses
+          pending_response_t* entry = createPendingResponse(nullptr);
+          entry->_complete = true;
+
+          entry->_writeBuffers.push_back(buffer);
+          entry->_writeBodies.push_back(nullptr);
 
 #ifdef TRI_ENABLE_FIGURES
-          _writeBuffersStats.push_back(0);
+          entry->_writeBuffersStats.push_back(0);
 #endif
 
-          fillWriteBuffer();
+          flushPendingResponses();
         }
       }
     }
@@ -568,100 +704,18 @@ bool HttpCommTask::processRead () {
   RequestStatisticsAgentSetReadEnd(this);
   RequestStatisticsAgentAddReceivedBytes(this, _bodyPosition - _startPosition + _bodyLength);
 
-  bool isOptions = (_requestType == HttpRequest::HTTP_REQUEST_OPTIONS);
   resetState(false);
 
-  // .............................................................................
-  // keep-alive handling
-  // .............................................................................
-
-  string connectionType = StringUtils::tolower(_request->header("connection"));
-
-  if (connectionType == "close") {
-    // client has sent an explicit "Connection: Close" header. we should close the connection
-    LOG_DEBUG("connection close requested by client");
-    _closeRequested = true;
-  }
-  else if (_request->isHttp10() && connectionType != "keep-alive") {
-    // HTTP 1.0 request, and no "Connection: Keep-Alive" header sent
-    // we should close the connection
-    LOG_DEBUG("no keep-alive, connection close requested by client");
-    _closeRequested = true;
-  }
-  else if (_keepAliveTimeout <= 0.0) {
-    // if keepAliveTimeout was set to 0.0, we'll close even keep-alive connections immediately
-    LOG_DEBUG("keep-alive disabled by admin");
-    _closeRequested = true;
-  }
+  // a request with side effects must not run concurrently with the requests
+  // before it. keep it until their responses have been sent
+  if (! IsSafeRequestType(_requestType) && ! _pendingResponses.empty()) {
+    LOG_TRACE("deferring pipelined request until earlier requests are answered");
 
-  // we keep the connection open in all other cases (HTTP 1.1 or Keep-Alive header sent)
-
-  // .............................................................................
-  // authenticate
-  // .............................................................................
-
-  auto const compatibility = _request->compatibility();
-
-  HttpResponse::HttpResponseCode authResult = _server->handlerFactory()->authenticateRequest(_request);
-
-  // authenticated or an OPTIONS request. OPTIONS requests currently go unauthenticated
-  if (authResult == HttpResponse::OK || isOptions) {
-
-    // handle HTTP OPTIONS requests directly
-    if (isOptions) {
-      processCorsOptions(compatibility);
-    }
-    else {
-      processRequest(compatibility);
-    }
-  }
-
-  // not found
-  else if (authResult == HttpResponse::NOT_FOUND) {
-    HttpResponse response(authResult, compatibility);
-    response.setContentType("application/json; charset=utf-8");
-
-    response.body()
-    .appendText("{\"error\":true,\"errorMessage\":\"")
-    .appendText(TRI_errno_string(TRI_ERROR_ARANGO_DATABASE_NOT_FOUND))
-    .appendText("\",\"code\":")
-    .appendInteger((int) authResult)
-    .appendText(",\"errorNum\":")
-    .appendInteger(TRI_ERROR_ARANGO_DATABASE_NOT_FOUND)
-    .appendText("}");
-
-    clearRequest();
-    handleResponse(&response);
-  }
-
-  // forbidden
-  else if (authResult == HttpResponse::FORBIDDEN) {
-    HttpResponse response(authResult, compatibility);
-    response.setContentType("application/json; charset=utf-8");
-
-    response.body()
-    .appendText("{\"error\":true,\"errorMessage\":\"change password\",\"code\":")
-    .appendInteger((int) authResult)
-    .appendText(",\"errorNum\":")
-    .appendInteger(TRI_ERROR_USER_CHANGE_PASSWORD)
-    .appendText("}");
-
-    clearRequest();
-    handleResponse(&response);
+    _deferredRequest = true;
+    return false;
   }
 
-  // not authenticated
-  else {
-    HttpResponse response(HttpResponse::UNAUTHORIZED, compatibility);
-    const string realm = "basic realm=\"" + _server->handlerFactory()->authenticationRealm(_request) + "\"";
-
-    if (sendWwwAuthenticateHeader()) {
-      response.setHeader("www-authenticate", strlen("www-authenticate"), realm.c_str());
-    }
-
-    clearRequest();
-    handleResponse(&response);
-  }
+  executeRequest();
 
   return true;
 }
@@ -671,14 +725,17 @@ bool HttpCommTask::processRead () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void HttpCommTask::sendChunk (StringBuffer* buffer) {
-  if (_isChunked) {
-    _writeBuffers.push_back(buffer);
+  pending_response_t* entry = chunkedResponse();
+
+  if (entry != nullptr) {
+    entry->_writeBuffers.push_back(buffer);
+    entry->_writeBodies.push_back(nullptr);
 
 #ifdef TRI_ENABLE_FIGURES
-    _writeBuffersStats.push_back(0);
+    entry->_writeBuffersStats.push_back(0);
 #endif
 
-    fillWriteBuffer();
+    flushPendingResponses();
   }
   else {
     delete buffer;
@@ -690,20 +747,28 @@ void HttpCommTask::sendChunk (StringBuffer* buffer) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void HttpCommTask::finishedChunked () {
-  StringBuffer* buffer = new StringBuffer(TRI_UNKNOWN_MEM_ZONE, 6);
-  buffer->appendText("0\r\n\r\n");
+  pending_response_t* entry = chunkedResponse();
+
+  if (entry != nullptr) {
+    StringBuffer* buffer = new StringBuffer(TRI_UNKNOWN_MEM_ZONE, 6);
+    buffer->appendText("0\r\n\r\n");
 
-  _writeBuffers.push_back(buffer);
+    entry->_writeBuffers.push_back(buffer);
+    entry->_writeBodies.push_back(nullptr);
 
 #ifdef TRI_ENABLE_FIGURES
-  _writeBuffersStats.push_back(0);
+    entry->_writeBuffersStats.push_back(0);
 #endif
 
-  _isChunked = false;
-  _requestPending = false;
+    entry->_complete = true;
+  }
+
+  _isChunked = (chunkedResponse() != nullptr);
 
-  fillWriteBuffer();
-  processRead();
+  flushPendingResponses();
+
+  while (processRead()) {
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -722,10 +787,12 @@ void HttpCommTask::setupDone () {
 /// @brief reads data from the socket
 ////////////////////////////////////////////////////////////////////////////////
 
-void HttpCommTask::addResponse (HttpResponse* response) {
+void HttpCommTask::addResponse (HttpResponse* response,
+                                pending_response_t* entry,
+                                TRI_request_statistics_t* statistics) {
 
   // CORS response handling
-  if (! _origin.empty()) {
+  if (! entry->_origin.empty()) {
 
     // the request contained an Origin header. We have to send back the
     // access-control-allow-origin header now
@@ -740,10 +807,10 @@ void HttpCommTask::addResponse (HttpResponse* response) {
     // x-arango-replication-lasttick, x-arango-replication-active");
 
     // send back original value of "Origin" header
-    response->setHeader("access-control-allow-origin", strlen("access-control-allow-origin"), _origin);
+    response->setHeader("access-control-allow-origin", strlen("access-control-allow-origin"), entry->_origin);
 
     // send back "Access-Control-Allow-Credentials" header
-    if (_denyCredentials) {
+    if (entry->_denyCredentials) {
       response->setHeader("access-control-allow-credentials", "false");
     }
     else {
@@ -763,46 +830,60 @@ void HttpCommTask::addResponse (HttpResponse* response) {
 
   size_t responseBodyLength = response->bodySize();
 
-  if (_requestType == HttpRequest::HTTP_REQUEST_HEAD) {
+  if (entry->_requestType == HttpRequest::HTTP_REQUEST_HEAD) {
     // clear body if this is an HTTP HEAD request
     // HEAD must not return a body
     response->headResponse(responseBodyLength);
   }
-  // else {
-  //    // to enable automatic deflating of responses, active this.
-  //   // deflate takes a lot of CPU time so it should only be enabled for
-  //   // dedicated purposes and not generally
-  //   if (responseBodyLength > 16384  && _acceptDeflate) {
-  //     response->deflate();
-  //     responseBodyLength = response->bodySize();
-  //   }
-  // }
-
-  // reserve some outbuffer size
-  StringBuffer* buffer
-    = new StringBuffer(TRI_UNKNOWN_MEM_ZONE, responseBodyLength + 128);
-
-  // write header
-  response->writeHeader(buffer);
-
-  // write body
-  if (_requestType != HttpRequest::HTTP_REQUEST_HEAD) {
-    if (_isChunked) {
-      if (0 != responseBodyLength) {
-        buffer->appendHex(response->body().length());
-        buffer->appendText("\r\n");
+
+  // note: response bodies are compressed by the dispatcher thread that ran the
+  // handler (see HttpHandler::compressResponse), never here in the I/O thread
+
+  StringBuffer* buffer;
+  StringBuffer* body = nullptr;
+
+  if (entry->_requestType != HttpRequest::HTTP_REQUEST_HEAD &&
+      ! entry->_chunked &&
+      responseBodyLength >= MinimalGatherBodySize) {
+    // large bodies are not copied into the output buffer. instead, the
+    // response body is handed over as is and sent after the header with a
+    // gather write
+    buffer = new StringBuffer(TRI_UNKNOWN_MEM_ZONE, 256);
+    response->writeHeader(buffer);
+
+    body = new StringBuffer(TRI_UNKNOWN_MEM_ZONE);
+    body->swap(&response->body());
+  }
+  else {
+    // reserve some outbuffer size
+    buffer = new StringBuffer(TRI_UNKNOWN_MEM_ZONE, responseBodyLength + 128);
+
+    // write header
+    response->writeHeader(buffer);
+
+    // write body
+    if (entry->_requestType != HttpRequest::HTTP_REQUEST_HEAD) {
+      if (entry->_chunked) {
+        if (0 != responseBodyLength) {
+          buffer->appendHex(response->body().length());
+          buffer->appendText("\r\n");
+          buffer->appendText(response->body());
+          buffer->appendText("\r\n");
+        }
+      }
+      else {
         buffer->appendText(response->body());
-        buffer->appendText("\r\n");
       }
     }
-    else {
-      buffer->appendText(response->body());
-    }
   }
 
-  _writeBuffers.push_back(buffer);
+  entry->_writeBuffers.push_back(buffer);
+  entry->_writeBodies.push_back(body);
           
-  LOG_TRACE("HTTP WRITE FOR %p: %s", (void*) this, buffer->c_str());
+  LOG_TRACE("HTTP WRITE FOR %p: %s%s", 
+            (void*) this, 
+            buffer->c_str(),
+            body == nullptr ? "" : body->c_str());
           
   // clear body
   response->body().clear();
@@ -810,25 +891,249 @@ void HttpCommTask::addResponse (HttpResponse* response) {
   double totalTime = 0.0;
 
 #ifdef TRI_ENABLE_FIGURES
-  _writeBuffersStats.push_back(RequestStatisticsAgent::transfer());
-  totalTime = RequestStatisticsAgent::elapsedSinceReadStart();
+  entry->_writeBuffersStats.push_back(statistics);
+
+  if (statistics != nullptr && statistics->_readStart != 0.0) {
+    totalTime = TRI_StatisticsTime() - statistics->_readStart;
+  }
 #endif
 
   // disable the following statement to prevent excessive logging of incoming requests
   LOG_USAGE(",\"http-request\",\"%s\",\"%s\",\"%s\",%d,%llu,%llu,\"%s\",%.6f",
             _connectionInfo.clientAddress.c_str(),
-            HttpRequest::translateMethod(_requestType).c_str(),
-            HttpRequest::translateVersion(_httpVersion).c_str(),
+            HttpRequest::translateMethod(entry->_requestType).c_str(),
+            HttpRequest::translateVersion(entry->_httpVersion).c_str(),
             (int) response->responseCode(),
-            (unsigned long long) _originalBodyLength,
+            (unsigned long long) entry->_originalBodyLength,
             (unsigned long long) responseBodyLength,
-            _fullUrl.c_str(),
+            entry->_fullUrl.c_str(),
             totalTime);
-          
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the next request can be read and executed
+////////////////////////////////////////////////////////////////////////////////
+
+bool HttpCommTask::acceptsRequests () const {
+  if (_isChunked || _closeRequested || _deferredRequest) {
+    return false;
+  }
+
+  if (_pendingResponses.empty()) {
+    return true;
+  }
+
+  if (_pendingResponses.size() >= _maximalPipelinedRequests) {
+    return false;
+  }
+
+  // further requests are only read while all requests in flight are safe
+  for (auto i : _pendingResponses) {
+    if (! i->_complete && ! IsSafeRequestType(i->_requestType)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a response slot for the current request
+////////////////////////////////////////////////////////////////////////////////
+
+HttpCommTask::pending_response_t* HttpCommTask::createPendingResponse (HttpHandler* handler) {
+  pending_response_t* entry = new pending_response_t;
+
+  entry->_handler = handler;
+  entry->_requestType = _requestType;
+  entry->_httpVersion = _httpVersion;
+  entry->_fullUrl = _fullUrl;
+  entry->_origin = _origin;
+  entry->_denyCredentials = _denyCredentials;
+  entry->_originalBodyLength = _originalBodyLength;
+  entry->_chunked = false;
+  entry->_complete = false;
+
+  _pendingResponses.push_back(entry);
+
+  return entry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the slot of the open chunked response, if any
+////////////////////////////////////////////////////////////////////////////////
+
+HttpCommTask::pending_response_t* HttpCommTask::chunkedResponse () const {
+  for (auto i : _pendingResponses) {
+    if (i->_chunked && ! i->_complete) {
+      return i;
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves the finished responses into the write buffers in order
+///
+/// output of the first unfinished slot (i.e. the chunks of a chunked
+/// response) is moved as well, output of later slots is held back
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::flushPendingResponses () {
+  while (! _pendingResponses.empty()) {
+    pending_response_t* entry = _pendingResponses.front();
+
+    while (! entry->_writeBuffers.empty()) {
+      _writeBuffers.push_back(entry->_writeBuffers.front());
+      entry->_writeBuffers.pop_front();
+
+      _writeBodies.push_back(entry->_writeBodies.front());
+      entry->_writeBodies.pop_front();
+
+#ifdef TRI_ENABLE_FIGURES
+      _writeBuffersStats.push_back(entry->_writeBuffersStats.front());
+      entry->_writeBuffersStats.pop_front();
+#endif
+    }
+
+    if (! entry->_complete) {
+      break;
+    }
+
+    _pendingResponses.pop_front();
+    freePendingResponse(entry);
+  }
+
   // start output
   fillWriteBuffer();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a response slot
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::freePendingResponse (pending_response_t* entry) {
+  for (auto i : entry->_writeBuffers) {
+    delete i;
+  }
+
+  for (auto i : entry->_writeBodies) {
+    delete i;
+  }
+
+#ifdef TRI_ENABLE_FIGURES
+
+  for (auto i : entry->_writeBuffersStats) {
+    TRI_ReleaseRequestStatistics(i);
+  }
+
+#endif
+
+  delete entry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the request that has just been read
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::executeRequest () {
+  bool isOptions = (_requestType == HttpRequest::HTTP_REQUEST_OPTIONS);
+
+  // .............................................................................
+  // keep-alive handling
+  // .............................................................................
+
+  string connectionType = StringUtils::tolower(_request->header("connection"));
+
+  if (connectionType == "close") {
+    // client has sent an explicit "Connection: Close" header. we should close the connection
+    LOG_DEBUG("connection close requested by client");
+    _closeRequested = true;
+  }
+  else if (_request->isHttp10() && connectionType != "keep-alive") {
+    // HTTP 1.0 request, and no "Connection: Keep-Alive" header sent
+    // we should close the connection
+    LOG_DEBUG("no keep-alive, connection close requested by client");
+    _closeRequested = true;
+  }
+  else if (_keepAliveTimeout <= 0.0) {
+    // if keepAliveTimeout was set to 0.0, we'll close even keep-alive connections immediately
+    LOG_DEBUG("keep-alive disabled by admin");
+    _closeRequested = true;
+  }
+
+  // we keep the connection open in all other cases (HTTP 1.1 or Keep-Alive header sent)
+
+  // .............................................................................
+  // authenticate
+  // .............................................................................
+
+  auto const compatibility = _request->compatibility();
+
+  HttpResponse::HttpResponseCode authResult = _server->handlerFactory()->authenticateRequest(_request);
+
+  // authenticated or an OPTIONS request. OPTIONS requests currently go unauthenticated
+  if (authResult == HttpResponse::OK || isOptions) {
+
+    // handle HTTP OPTIONS requests directly
+    if (isOptions) {
+      processCorsOptions(compatibility);
+    }
+    else {
+      processRequest(compatibility);
+    }
+  }
+
+  // not found
+  else if (authResult == HttpResponse::NOT_FOUND) {
+    HttpResponse response(authResult, compatibility);
+    response.setContentType("application/json; charset=utf-8");
+
+    response.body()
+    .appendText("{\"error\":true,\"errorMessage\":\"")
+    .appendText(TRI_errno_string(TRI_ERROR_ARANGO_DATABASE_NOT_FOUND))
+    .appendText("\",\"code\":")
+    .appendInteger((int) authResult)
+    .appendText(",\"errorNum\":")
+    .appendInteger(TRI_ERROR_ARANGO_DATABASE_NOT_FOUND)
+    .appendText("}");
+
+    clearRequest();
+    handleResponse(&response);
+  }
+
+  // forbidden
+  else if (authResult == HttpResponse::FORBIDDEN) {
+    HttpResponse response(authResult, compatibility);
+    response.setContentType("application/json; charset=utf-8");
+
+    response.body()
+    .appendText("{\"error\":true,\"errorMessage\":\"change password\",\"code\":")
+    .appendInteger((int) authResult)
+    .appendText(",\"errorNum\":")
+    .appendInteger(TRI_ERROR_USER_CHANGE_PASSWORD)
+    .appendText("}");
+
+    clearRequest();
+    handleResponse(&response);
+  }
+
+  // not authenticated
+  else {
+    HttpResponse response(HttpResponse::UNAUTHORIZED, compatibility);
+    const string realm = "basic realm=\"" + _server->handlerFactory()->authenticationRealm(_request) + "\"";
+
+    if (sendWwwAuthenticateHeader()) {
+      response.setHeader("www-authenticate", strlen("www-authenticate"), realm.c_str());
+    }
+
+    clearRequest();
+    handleResponse(&response);
+  }
+
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// check the content-length header of a request and fail it is broken
 ////////////////////////////////////////////////////////////////////////////////
@@ -884,9 +1189,12 @@ bool HttpCommTask::checkContentLength (bool expectContentLength) {
 
 void HttpCommTask::fillWriteBuffer () {
   if (! hasWriteBuffer() && ! _writeBuffers.empty()) {
-    StringBuffer * buffer = _writeBuffers.front();
+    StringBuffer* buffer = _writeBuffers.front();
     _writeBuffers.pop_front();
 
+    StringBuffer* body = _writeBodies.front();
+    _writeBodies.pop_front();
+
 #ifdef TRI_ENABLE_FIGURES
     TRI_request_statistics_t* statistics = _writeBuffersStats.front();
     _writeBuffersStats.pop_front();
@@ -894,7 +1202,12 @@ void HttpCommTask::fillWriteBuffer () {
     TRI_request_statistics_t* statistics = nullptr;
 #endif
 
-    setWriteBuffer(buffer, statistics);
+    if (body == nullptr) {
+      setWriteBuffer(buffer, statistics);
+    }
+    else {
+      setWriteBuffer(buffer, body, statistics);
+    }
   }
 }
 
@@ -1005,7 +1318,23 @@ void HttpCommTask::processRequest (uint32_t compatibility) {
 
   // synchronous request
   else {
+    // the response slot keeps the request's position in the pipeline. it
+    // is filled when the handler has finished, possibly out of order
+    pending_response_t* entry = createPendingResponse(handler);
+
     ok = _server->handleRequest(this, handler);
+
+    if (! ok) {
+      // the handler is gone, answer in its slot
+      HttpResponse response(HttpResponse::SERVER_ERROR, compatibility);
+
+      entry->_handler = nullptr;
+      entry->_complete = true;
+      addResponse(&response, entry, nullptr);
+      flushPendingResponses();
+    }
+
+    return;
   }
 
   if (! ok) {
@@ -1038,7 +1367,6 @@ void HttpCommTask::resetState (bool close) {
   if (close) {
     clearRequest();
 
-    _requestPending = false;
     _closeRequested = true;
 
     _readPosition    = 0;
@@ -1046,8 +1374,6 @@ void HttpCommTask::resetState (bool close) {
     _bodyLength      = 0;
   }
   else {
-    _requestPending = true;
-
     bool compact = false;
 
     if (_sinceCompactification > COMPACT_EVERY) {
@@ -1225,7 +1551,12 @@ void HttpCommTask::completedWriteBuffer () {
 
   fillWriteBuffer();
 
-  if (! _clientClosed && _closeRequested && ! hasWriteBuffer() && _writeBuffers.empty() && ! _isChunked) {
+  if (! _clientClosed &&
+      _closeRequested &&
+      ! hasWriteBuffer() &&
+      _writeBuffers.empty() &&
+      _pendingResponses.empty() &&
+      ! _isChunked) {
     _clientClosed = true;
     _server->handleCommunicationClosed(this);
   }
@@ -39,6 +39,7 @@
 namespace triagens {
   namespace rest {
     class HttpCommTask;
+    class HttpHandler;
     class HttpServer;
     class HttpResponse;
     class HttpRequest;
@@ -121,9 +122,22 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief handles response
+///
+/// the handler identifies the pipelined request the response belongs to. a
+/// null handler denotes a response generated for the current request by the
+/// task itself
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleResponse (HttpResponse*, HttpHandler* handler = nullptr);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief answers a request whose handler has not produced a response
+///
+/// the slot of the request is completed with an internal server error, so
+/// that the responses of later pipelined requests are not held back
 ////////////////////////////////////////////////////////////////////////////////
 
-        void handleResponse (HttpResponse*);
+        void handleMissingResponse (HttpHandler*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief reads data from the socket
@@ -149,6 +163,37 @@ namespace triagens {
 
         void setupDone ();
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief response slot of a pipelined request
+///
+/// a slot is created for each request in the order the requests are read.
+/// it keeps the request data needed for answering and collects the
+/// serialized response until all slots before it have been written
+////////////////////////////////////////////////////////////////////////////////
+
+        struct pending_response_t {
+          HttpHandler* _handler;
+          HttpRequest::HttpRequestType _requestType;
+          HttpRequest::HttpVersion _httpVersion;
+          std::string _fullUrl;
+          std::string _origin;
+          bool _denyCredentials;
+          size_t _originalBodyLength;
+          bool _chunked;
+          bool _complete;
+          std::deque<basics::StringBuffer*> _writeBuffers;
+          std::deque<basics::StringBuffer*> _writeBodies;
+#ifdef TRI_ENABLE_FIGURES
+          std::deque<TRI_request_statistics_t*> _writeBuffersStats;
+#endif
+        };
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -159,7 +204,45 @@ namespace triagens {
 /// @brief reads data from the socket
 ////////////////////////////////////////////////////////////////////////////////
 
-        void addResponse (HttpResponse*);
+        void addResponse (HttpResponse*,
+                          pending_response_t*,
+                          TRI_request_statistics_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the next request can be read and executed
+////////////////////////////////////////////////////////////////////////////////
+
+        bool acceptsRequests () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the request that has just been read
+////////////////////////////////////////////////////////////////////////////////
+
+        void executeRequest ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a response slot for the current request
+////////////////////////////////////////////////////////////////////////////////
+
+        pending_response_t* createPendingResponse (HttpHandler*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the slot of the open chunked response, if any
+////////////////////////////////////////////////////////////////////////////////
+
+        pending_response_t* chunkedResponse () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves the finished responses into the write buffers in order
+////////////////////////////////////////////////////////////////////////////////
+
+        void flushPendingResponses ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a response slot
+////////////////////////////////////////////////////////////////////////////////
+
+        void freePendingResponse (pending_response_t*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// check the content-length header of a request and fail it is broken
@@ -302,6 +385,16 @@ namespace triagens {
 
         std::deque<basics::StringBuffer*> _writeBuffers;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief response bodies belonging to the write buffers
+///
+/// a body is sent right after its write buffer using a gather write, so
+/// response bodies need not be copied into the write buffer. entries are
+/// null for write buffers without a separate body
+////////////////////////////////////////////////////////////////////////////////
+
+        std::deque<basics::StringBuffer*> _writeBodies;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief statistics buffers
 ////////////////////////////////////////////////////////////////////////////////
@@ -310,6 +403,25 @@ namespace triagens {
         std::deque<TRI_request_statistics_t*> _writeBuffersStats;
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief response slots of the requests in flight, in request order
+////////////////////////////////////////////////////////////////////////////////
+
+        std::deque<pending_response_t*> _pendingResponses;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of requests in flight
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _maximalPipelinedRequests;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief true if a request has been read but waits for the requests before
+/// it to be answered
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _deferredRequest;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief current read position
 ////////////////////////////////////////////////////////////////////////////////
@@ -328,12 +440,6 @@ namespace triagens {
 
         size_t _bodyLength;
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief true if request is complete but not handled
-////////////////////////////////////////////////////////////////////////////////
-
-        bool _requestPending;
-
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief true if a close has been requested by the client
 ////////////////////////////////////////////////////////////////////////////////
@@ -436,6 +542,8 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief true if within a chunked response
+///
+/// no further requests are read while a chunked response is open
 ////////////////////////////////////////////////////////////////////////////////
 
         bool _isChunked;
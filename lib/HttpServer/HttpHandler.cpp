@@ -30,9 +30,11 @@
 #include "HttpHandler.h"
 
 #include "Basics/logging.h"
+#include "HttpServer/HttpHandlerFactory.h"
 #include "HttpServer/HttpServerJob.h"
 #include "Rest/HttpRequest.h"
 
+using namespace triagens::basics;
 using namespace triagens::rest;
 
 // -----------------------------------------------------------------------------
@@ -122,6 +124,80 @@ HttpResponse* HttpHandler::stealResponse () {
   return tmp;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decompresses the request body if it was sent compressed
+////////////////////////////////////////////////////////////////////////////////
+
+bool HttpHandler::decompressRequest () {
+  if (_request == nullptr || _server == nullptr) {
+    return true;
+  }
+
+  if (! _server->compressionOptions().decompressRequests) {
+    return true;
+  }
+
+  int res = _request->decompressBody(_server->sizeRestrictions().maximalBodySize);
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    return true;
+  }
+
+  LOG_DEBUG("cannot decompress request body: %s", TRI_errno_string(res));
+
+  switch (res) {
+    case TRI_ERROR_NOT_IMPLEMENTED:
+      _response = createResponse(HttpResponse::UNSUPPORTED_MEDIA_TYPE);
+      break;
+    case TRI_ERROR_OUT_OF_MEMORY:
+      _response = createResponse(HttpResponse::REQUEST_ENTITY_TOO_LARGE);
+      break;
+    default:
+      _response = createResponse(HttpResponse::BAD);
+      break;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compresses the response body if the client accepts it
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpHandler::compressResponse () {
+  if (_request == nullptr || _response == nullptr || _server == nullptr) {
+    return;
+  }
+
+  auto const options = _server->compressionOptions();
+
+  if (options.minimalResponseSize == 0 ||
+      _response->isChunked() ||
+      _request->requestType() == HttpRequest::HTTP_REQUEST_HEAD) {
+    return;
+  }
+
+  // a missing accept-encoding header still produces a vary header, so that
+  // caches do not hand out compressed bodies to clients that cannot handle
+  // them
+  bool found;
+  char const* acceptEncoding = _request->header("accept-encoding", found);
+
+  bool compressed = false;
+  int res = _response->compressForClient(found ? acceptEncoding : "",
+                                         options.minimalResponseSize,
+                                         options.maximalResponseSize,
+                                         compressed);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    LOG_DEBUG("cannot compress response body: %s", TRI_errno_string(res));
+  }
+  else if (compressed) {
+    LOG_TRACE("compressed response body to %llu bytes",
+              (unsigned long long) _response->body().length());
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   Handler methods
 // -----------------------------------------------------------------------------
@@ -125,6 +125,24 @@ namespace triagens {
 
         HttpResponse* stealResponse ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decompresses the request body if it was sent compressed
+///
+/// returns false and creates an error response if the body cannot be
+/// decompressed. this is called by the dispatcher thread before execute()
+////////////////////////////////////////////////////////////////////////////////
+
+        bool decompressRequest ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compresses the response body if the client accepts it
+///
+/// this is called by the dispatcher thread after execute(), so the I/O
+/// thread only has to send the already compressed body
+////////////////////////////////////////////////////////////////////////////////
+
+        void compressResponse ();
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   Handler methods
 // -----------------------------------------------------------------------------
@@ -94,9 +94,15 @@ HttpHandlerFactory::HttpHandlerFactory (std::string const& authenticationRealm,
   : _authenticationRealm(authenticationRealm),
     _minCompatibility(minCompatibility),
     _allowMethodOverride(allowMethodOverride),
+    _compressionOptions(),
+    _maximalPipelinedRequests(1),
     _setContext(setContext),
     _setContextData(setContextData),
     _notFound(0) {
+
+  _compressionOptions.minimalResponseSize = 0;
+  _compressionOptions.maximalResponseSize = 0;
+  _compressionOptions.decompressRequests = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -107,6 +113,8 @@ HttpHandlerFactory::HttpHandlerFactory (HttpHandlerFactory const& that)
   : _authenticationRealm(that._authenticationRealm),
     _minCompatibility(that._minCompatibility),
     _allowMethodOverride(that._allowMethodOverride),
+    _compressionOptions(that._compressionOptions),
+    _maximalPipelinedRequests(that._maximalPipelinedRequests),
     _setContext(that._setContext),
     _setContextData(that._setContextData),
     _constructors(that._constructors),
@@ -124,6 +132,8 @@ HttpHandlerFactory& HttpHandlerFactory::operator= (HttpHandlerFactory const& tha
     _authenticationRealm = that._authenticationRealm;
     _minCompatibility = that._minCompatibility;
     _allowMethodOverride = that._allowMethodOverride;
+    _compressionOptions = that._compressionOptions;
+    _maximalPipelinedRequests = that._maximalPipelinedRequests;
     _setContext = that._setContext;
     _setContextData = that._setContextData;
     _constructors = that._constructors;
@@ -172,6 +182,38 @@ HttpHandlerFactory::size_restriction_t HttpHandlerFactory::sizeRestrictions () c
   return restrictions;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the compression settings
+////////////////////////////////////////////////////////////////////////////////
+
+HttpHandlerFactory::compression_options_t HttpHandlerFactory::compressionOptions () const {
+  return _compressionOptions;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the compression settings
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpHandlerFactory::setCompressionOptions (compression_options_t const& options) {
+  _compressionOptions = options;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the maximal number of requests executed per connection
+////////////////////////////////////////////////////////////////////////////////
+
+size_t HttpHandlerFactory::maximalPipelinedRequests () const {
+  return _maximalPipelinedRequests;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the maximal number of requests executed per connection
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpHandlerFactory::setMaximalPipelinedRequests (size_t value) {
+  _maximalPipelinedRequests = (value == 0 ? 1 : value);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief authenticates a new request
 ///
@@ -102,6 +102,20 @@ namespace triagens {
           size_t maximalBodySize;
           size_t maximalPipelineSize;
         } size_restriction_t;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compression settings
+///
+/// responses are only compressed if their body size is between the minimal
+/// and the maximal response size. a minimal response size of 0 turns off
+/// response compression. a maximal response size of 0 means no upper bound
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef struct {
+          size_t minimalResponseSize;
+          size_t maximalResponseSize;
+          bool decompressRequests;
+        } compression_options_t;
         
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
@@ -161,6 +175,30 @@ namespace triagens {
 
         virtual size_restriction_t sizeRestrictions () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the compression settings
+////////////////////////////////////////////////////////////////////////////////
+
+        compression_options_t compressionOptions () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the compression settings
+////////////////////////////////////////////////////////////////////////////////
+
+        void setCompressionOptions (compression_options_t const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the maximal number of requests executed per connection
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t maximalPipelinedRequests () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the maximal number of requests executed per connection
+////////////////////////////////////////////////////////////////////////////////
+
+        void setMaximalPipelinedRequests (size_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief authenticates a new request, wrapper method
 ////////////////////////////////////////////////////////////////////////////////
@@ -237,6 +275,18 @@ namespace triagens {
 
         bool _allowMethodOverride;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compression settings
+////////////////////////////////////////////////////////////////////////////////
+
+        compression_options_t _compressionOptions;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of pipelined requests executed per connection
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _maximalPipelinedRequests;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief set context callback
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,9 +39,11 @@
 #include "HttpServer/HttpHandler.h"
 #include "HttpServer/HttpListenTask.h"
 #include "HttpServer/HttpServerJob.h"
+#include "Rest/EndpointIp.h"
 #include "Rest/EndpointList.h"
 #include "Scheduler/ListenTask.h"
 #include "Scheduler/Scheduler.h"
+#include "Scheduler/SchedulerThread.h"
 
 using namespace triagens::basics;
 using namespace triagens::rest;
@@ -109,7 +111,9 @@ HttpServer::HttpServer (Scheduler* scheduler,
     _commTasks(),
     _handlers(),
     _task2handler(),
-    _keepAliveTimeout(keepAliveTimeout) {
+    _keepAliveTimeout(keepAliveTimeout),
+    _schedulerShards(1),
+    _sharedEndpoints() {
   GENERAL_SERVER_INIT(&_commTasksLock);
   GENERAL_SERVER_INIT(&_mappingLock);
 }
@@ -126,6 +130,10 @@ HttpServer::~HttpServer () {
 
   stopListening();
 
+  for (auto&& i : _sharedEndpoints) {
+    delete i.second;
+  }
+
   GENERAL_SERVER_DESTROY(&_mappingLock);
   GENERAL_SERVER_DESTROY(&_commTasksLock);
 }
@@ -194,6 +202,14 @@ void HttpServer::setEndpointList (const EndpointList* list) {
    _endpointList = list;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the number of scheduler shards
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpServer::setSchedulerShards (size_t shards) {
+  _schedulerShards = (shards == 0 ? 1 : shards);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief add another endpoint at runtime
 ///
@@ -217,16 +233,40 @@ bool HttpServer::addEndpoint (Endpoint* endpoint) {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool HttpServer::removeEndpoint (Endpoint* endpoint) {
-  for (auto task = _listenTasks.begin();  task != _listenTasks.end();  ++task) {
-    if ((*task)->endpoint() == endpoint) {
+
+  // copies of the endpoint used by other scheduler threads
+  unordered_set<Endpoint*> copies;
+
+  for (auto&& i : _sharedEndpoints) {
+    if (i.first == endpoint) {
+      copies.insert(i.second);
+    }
+  }
+
+  bool found = false;
+
+  for (auto task = _listenTasks.begin();  task != _listenTasks.end();) {
+    Endpoint* e = (*task)->endpoint();
+
+    if (e == endpoint || copies.find(e) != copies.end()) {
       // TODO: remove commtasks for the listentask??
 
       _scheduler->destroyTask(*task);
-      _listenTasks.erase(task);
-
-      LOG_INFO("removed endpoint '%s'", endpoint->getSpecification().c_str());
-      return true;
+      task = _listenTasks.erase(task);
+      found = true;
     }
+    else {
+      ++task;
+    }
+  }
+
+  // the copies are freed together with the server
+  for (auto e : copies) {
+    e->disconnect();
+  }
+
+  if (found) {
+    LOG_INFO("removed endpoint '%s'", endpoint->getSpecification().c_str());
   }
 
   return true;
@@ -345,8 +385,18 @@ void HttpServer::handleConnected (TRI_socket_t s, const ConnectionInfo& info) {
   GENERAL_SERVER_UNLOCK(&_commTasksLock);
 
   // registers the task and get the number of the scheduler thread
-  ssize_t n;
-  int res = _scheduler->registerTask(task, &n);
+  ssize_t n = SchedulerThread::currentThreadNumber;
+  int res;
+
+  // keep the connection in the scheduler thread which accepted it
+  if (1 < _schedulerShards &&
+      0 <= n &&
+      (info.endpointType == Endpoint::DOMAIN_IPV4 || info.endpointType == Endpoint::DOMAIN_IPV6)) {
+    res = _scheduler->registerTaskInThread(task, n);
+  }
+  else {
+    res = _scheduler->registerTask(task, &n);
+  }
 
   // register the ChunkedTask in the same thread
   if (res == TRI_ERROR_NO_ERROR) {
@@ -389,50 +439,63 @@ void HttpServer::handleCommunicationFailure (HttpCommTask* task) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void HttpServer::handleAsync (HttpCommTask* task) {
+  std::vector<HttpHandler*> handlers;
+
   GENERAL_SERVER_LOCK(&_mappingLock);
 
-  auto&& it = _task2handler.find(task);
+  // a connection might have several pipelined requests in flight. collect
+  // all handlers of the task whose jobs have finished
+  auto range = _task2handler.equal_range(task);
 
-  if (it == _task2handler.end() || it->second._task != task) {
-    LOG_WARNING("cannot find a task for the handler, giving up");
+  for (auto it = range.first;  it != range.second;) {
+    HttpHandler* handler = it->second._handler;
+    auto jt = _handlers.find(handler);
 
-    GENERAL_SERVER_UNLOCK(&_mappingLock);
-    return;
+    if (jt != _handlers.end() && jt->second._job == nullptr) {
+      _handlers.erase(jt);
+      it = _task2handler.erase(it);
+
+      handlers.push_back(handler);
+    }
+    else {
+      ++it;
+    }
   }
 
-  handler_task_job_t element = it->second;
-  _task2handler.erase(it);
+  GENERAL_SERVER_UNLOCK(&_mappingLock);
 
-  HttpHandler* handler = element._handler;
-  _handlers.erase(handler);
+  if (handlers.empty()) {
+    // the responses of all finished handlers might have been collected
+    // by an earlier signal already
+    LOG_DEBUG("cannot find a finished handler for the task");
+    return;
+  }
 
-  GENERAL_SERVER_UNLOCK(&_mappingLock);
+  for (auto handler : handlers) {
+    HttpResponse * response = handler->getResponse();
 
-  HttpResponse * response = handler->getResponse();
+    if (response == nullptr) {
+      basics::Exception err(TRI_ERROR_INTERNAL, 
+                            "no response received from handler",
+                            __FILE__, __LINE__);
 
-  if (response == nullptr) {
-    basics::Exception err(TRI_ERROR_INTERNAL, 
-                          "no response received from handler",
-                          __FILE__, __LINE__);
+      handler->handleError(err);
+      response = handler->getResponse();
+    }
 
-    handler->handleError(err);
-    response = handler->getResponse();
-  }
+    if (response == nullptr) {
+      LOG_ERROR("cannot get any response");
+      task->handleMissingResponse(handler);
+    }
+    else {
+      task->handleResponse(response, handler);
+    }
 
-  if (response == nullptr) {
     delete handler;
-    LOG_ERROR("cannot get any response");
-
-    return;
   }
-
-  handler->RequestStatisticsAgent::transfer(task);
-
-  task->handleResponse(response);
-          
-  delete handler;
               
-  task->processRead();
+  while (task->processRead()) {
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -505,7 +568,7 @@ bool HttpServer::handleRequest (HttpCommTask* task, HttpHandler* handler) {
       Handler::status_t status = handleRequestDirectly(task, handler);
 
       if (status.status != Handler::HANDLER_REQUEUE) {
-        shutdownHandlerByTask(task);
+        shutdownHandler(task, handler);
         return true;
       }
     }
@@ -524,7 +587,7 @@ bool HttpServer::handleRequest (HttpCommTask* task, HttpHandler* handler) {
 
         LOG_WARNING("task is indirect, but handler failed to create a job - this cannot work!");
 
-        shutdownHandlerByTask(task);
+        shutdownHandler(task, handler);
         return false;
       }
 
@@ -538,7 +601,7 @@ bool HttpServer::handleRequest (HttpCommTask* task, HttpHandler* handler) {
 
       LOG_WARNING("no dispatcher is known");
 
-      shutdownHandlerByTask(task);
+      shutdownHandler(task, handler);
       return false;
     }
   }
@@ -612,20 +675,76 @@ void HttpServer::jobDone (Job* ajob) {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool HttpServer::openEndpoint (Endpoint* endpoint) {
-  ListenTask* task = new HttpListenTask(this, endpoint);
+  vector<Endpoint*> endpoints;
+  endpoints.push_back(endpoint);
 
-  // ...................................................................
-  // For some reason we have failed in our endeavour to bind to the socket -
-  // this effectively terminates the server
-  // ...................................................................
+  // with scheduler sharding, each scheduler thread gets its own listen socket
+  // for the address and the kernel distributes new connections over them.
+  // all sockets must be marked as shared before the first one is bound
+  Endpoint::DomainType type = endpoint->getDomainType();
 
-  if (! task->isBound()) {
-    deleteTask(task);
-    return false;
+  if (1 < _schedulerShards &&
+      ! endpoint->isConnected() &&
+      (type == Endpoint::DOMAIN_IPV4 || type == Endpoint::DOMAIN_IPV6)) {
+    EndpointIp* ip = dynamic_cast<EndpointIp*>(endpoint);
+
+    for (size_t i = 1;  ip != nullptr && i < _schedulerShards;  ++i) {
+      Endpoint* shared = ip->createSharedEndpoint();
+
+      if (shared == nullptr) {
+        break;
+      }
+
+      endpoints.push_back(shared);
+    }
   }
 
-  _scheduler->registerTask(task);
-  _listenTasks.push_back(task);
+  vector<ListenTask*> tasks;
+
+  for (auto e : endpoints) {
+    ListenTask* task = new HttpListenTask(this, e);
+
+    // ...................................................................
+    // For some reason we have failed in our endeavour to bind to the socket -
+    // this effectively terminates the server
+    // ...................................................................
+
+    if (! task->isBound()) {
+      deleteTask(task);
+
+      for (auto t : tasks) {
+        deleteTask(t);
+      }
+
+      for (size_t i = 1;  i < endpoints.size();  ++i) {
+        endpoints[i]->disconnect();
+        delete endpoints[i];
+      }
+
+      return false;
+    }
+
+    tasks.push_back(task);
+  }
+
+  if (tasks.size() == 1) {
+    _scheduler->registerTask(tasks[0]);
+  }
+  else {
+    for (size_t i = 0;  i < tasks.size();  ++i) {
+      _scheduler->registerTaskInThread(tasks[i], (ssize_t) i);
+    }
+
+    for (size_t i = 1;  i < endpoints.size();  ++i) {
+      _sharedEndpoints.emplace_back(endpoint, endpoints[i]);
+    }
+
+    LOG_DEBUG("listening on endpoint '%s' in %d scheduler threads",
+              endpoint->getSpecification().c_str(),
+              (int) tasks.size());
+  }
+
+  _listenTasks.insert(_listenTasks.end(), tasks.begin(), tasks.end());
 
   return true;
 }
@@ -680,29 +799,32 @@ Handler::status_t HttpServer::handleRequestDirectly (HttpCommTask* task, HttpHan
     }
 
     RequestStatisticsAgentSetRequestEnd(handler);
-    handler->RequestStatisticsAgent::transfer(task);
 
     if (response != nullptr) {
-      task->handleResponse(response);
+      task->handleResponse(response, handler);
     }
     else {
       LOG_ERROR("cannot get any response");
+      task->handleMissingResponse(handler);
     }
   }
   catch (basics::Exception const& ex) {
     RequestStatisticsAgentSetExecuteError(handler);
 
     LOG_ERROR("caught exception: %s", DIAGNOSTIC_INFORMATION(ex));
+    task->handleMissingResponse(handler);
   }
   catch (std::exception const& ex) {
     RequestStatisticsAgentSetExecuteError(handler);
 
     LOG_ERROR("caught exception: %s", ex.what());
+    task->handleMissingResponse(handler);
   }
   catch (...) {
     RequestStatisticsAgentSetExecuteError(handler);
 
     LOG_ERROR("caught exception");
+    task->handleMissingResponse(handler);
   }
 
   return status;
@@ -713,54 +835,94 @@ Handler::status_t HttpServer::handleRequestDirectly (HttpCommTask* task, HttpHan
 ////////////////////////////////////////////////////////////////////////////////
 
 void HttpServer::shutdownHandlerByTask (Task* task) {
+  std::vector<HttpHandler*> handlers;
+
   GENERAL_SERVER_LOCK(&_mappingLock);
 
-  // remove the task from the map
-  auto&& it = _task2handler.find(task);
+  // remove the task from the map. there is one entry per request in flight
+  auto range = _task2handler.equal_range(task);
 
-  if (it == _task2handler.end() || it->second._task != task) {
+  if (range.first == range.second) {
     LOG_DEBUG("shutdownHandler called, but no handler is known for task");
 
     GENERAL_SERVER_UNLOCK(&_mappingLock);
     return;
   }
 
-  handler_task_job_t& element = it->second;
-  HttpHandler* handler = element._handler;
+  for (auto it = range.first;  it != range.second;  ++it) {
+    HttpHandler* handler = it->second._handler;
+
+    if (releaseHandler(handler)) {
+      handlers.push_back(handler);
+    }
+  }
+
+  _task2handler.erase(range.first, range.second);
+
+  GENERAL_SERVER_UNLOCK(&_mappingLock);
+
+  for (auto handler : handlers) {
+    delete handler;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shut downs a single handler of a task
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpServer::shutdownHandler (Task* task, HttpHandler* handler) {
+  GENERAL_SERVER_LOCK(&_mappingLock);
+
+  auto range = _task2handler.equal_range(task);
+
+  for (auto it = range.first;  it != range.second;  ++it) {
+    if (it->second._handler == handler) {
+      _task2handler.erase(it);
+      break;
+    }
+  }
+
+  bool unused = releaseHandler(handler);
 
-  _task2handler.erase(it);
+  GENERAL_SERVER_UNLOCK(&_mappingLock);
+
+  if (unused) {
+    delete handler;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases a handler whose task is going away
+///
+/// must be called with the mapping lock held. returns true if the handler
+/// has no job and must be deleted by the caller. otherwise the job is asked
+/// to shut down and the handler is deleted when the job is done
+////////////////////////////////////////////////////////////////////////////////
+
+bool HttpServer::releaseHandler (HttpHandler* handler) {
 
   // check if the handler contains a job or not
   auto&& jt = _handlers.find(handler);
 
   if (jt == _handlers.end() || jt->second._handler != handler) {
     LOG_DEBUG("shutdownHandler called, but handler of task is unknown");
-
-    GENERAL_SERVER_UNLOCK(&_mappingLock);
-    return;
+    return false;
   }
 
   // if we do not know a job, delete handler
-  handler_task_job_t& element2 = jt->second;
-  Job* job = element2._job;
+  handler_task_job_t& element = jt->second;
+  Job* job = element._job;
 
   if (job == nullptr) {
     _handlers.erase(jt);
-
-    GENERAL_SERVER_UNLOCK(&_mappingLock);
-
-    delete handler;
-    return;
+    return true;
   }
 
   // initiate shutdown if a job is known
-  else {
-    element2._task = nullptr;
-    job->beginShutdown();
+  element._task = nullptr;
+  job->beginShutdown();
 
-    GENERAL_SERVER_UNLOCK(&_mappingLock);
-    return;
-  }
+  return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -776,7 +938,7 @@ void HttpServer::registerHandler (HttpHandler* handler, HttpCommTask* task) {
   element._job = 0;
 
   _handlers[handler] = element;
-  _task2handler[task] = element;
+  _task2handler.emplace(task, element);
 
   GENERAL_SERVER_UNLOCK(&_mappingLock);
 }
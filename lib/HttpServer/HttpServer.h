@@ -166,6 +166,15 @@ namespace triagens {
 
         void setEndpointList (const EndpointList* list);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the number of scheduler shards
+///
+/// If greater than one, each IP endpoint gets one listen socket per scheduler
+/// thread, and connections stay in the thread which accepted them.
+////////////////////////////////////////////////////////////////////////////////
+
+        void setSchedulerShards (size_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief adds another endpoint at runtime
 ////////////////////////////////////////////////////////////////////////////////
@@ -296,6 +305,18 @@ namespace triagens {
 
         void shutdownHandlerByTask (Task* task);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shut downs a single handler of a task
+////////////////////////////////////////////////////////////////////////////////
+
+        void shutdownHandler (Task* task, HttpHandler* handler);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases a handler whose task is going away
+////////////////////////////////////////////////////////////////////////////////
+
+        bool releaseHandler (HttpHandler* handler);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief registers a task
 ////////////////////////////////////////////////////////////////////////////////
@@ -376,15 +397,30 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief map task to handler
+///
+/// a task has one entry for each of its pipelined requests in flight
 ////////////////////////////////////////////////////////////////////////////////
 
-        std::unordered_map<Task*, handler_task_job_t> _task2handler;
+        std::unordered_multimap<Task*, handler_task_job_t> _task2handler;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief keep-alive timeout
 ////////////////////////////////////////////////////////////////////////////////
 
         double _keepAliveTimeout;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of scheduler shards
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _schedulerShards;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief additional listen endpoints, the first entry is the original
+/// endpoint, the second its copy, which is owned by the server
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::pair<Endpoint*, Endpoint*>> _sharedEndpoints;
     };
   }
 }
@@ -141,7 +141,13 @@ Job::status_t HttpServerJob::work () {
   Handler::status_t status;
 
   try {
-    status = _handler->execute();
+    // compressed request bodies are inflated here rather than in the I/O thread
+    if (_handler->decompressRequest()) {
+      status = _handler->execute();
+    }
+    else {
+      status = Handler::status_t(Handler::HANDLER_DONE);
+    }
   }
   catch (...) {
     _handler->finalizeExecute();
@@ -149,6 +155,13 @@ Job::status_t HttpServerJob::work () {
   }
 
   _handler->finalizeExecute();
+
+  // responses of detached jobs are stored and may be fetched later by a
+  // different client, so only compress responses that are sent right away
+  if (! _isDetached && status.status == Handler::HANDLER_DONE) {
+    _handler->compressResponse();
+  }
+
   RequestStatisticsAgentSetRequestEnd(_handler);
 
   LOG_TRACE("finished job %p with status %d", (void*) this, (int) status.status);
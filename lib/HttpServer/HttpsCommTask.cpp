@@ -346,18 +346,23 @@ bool HttpsCommTask::trySSLWrite () {
   size_t len = 0;
 
   if (nullptr != _writeBuffer) {
-    TRI_ASSERT(_writeBuffer->length() >= writeLength);
+    TRI_ASSERT(writeBufferLength() >= writeLength);
 
     // size_t is unsigned, should never get < 0
-    len = _writeBuffer->length() - writeLength;
+    len = writeBufferLength() - writeLength;
   }
 
   // write buffer to SSL connection
   int nr = 0;
 
   if (0 < len) {
+    // SSL has no gather writes, so header and body are written one after the
+    // other. a retried write will get the exact same segment again
+    size_t segmentLength;
+    char const* segment = nextWriteSegment(segmentLength);
+
     ERR_clear_error();
-    nr = SSL_write(_ssl, _writeBuffer->begin() + writeLength, (int) len);
+    nr = SSL_write(_ssl, segment, (int) segmentLength);
 
     if (nr <= 0) {
       int res = SSL_get_error(_ssl, nr);
@@ -414,9 +419,7 @@ bool HttpsCommTask::trySSLWrite () {
   }
 
   if (len == 0) {
-    if (ownBuffer) {
-      delete _writeBuffer;
-    }
+    releaseWriteBuffer();
 
     callCompletedWriteBuffer = true;
   }
@@ -1,9 +1,18 @@
-#line 2 "lib/JsonParser/json-parser.ll"
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief json parser
 ///
 /// @file
 ///
+/// The scanner is hand-written. Structural characters are found with a plain
+/// switch, while the contents of strings are skipped in blocks of 16 bytes
+/// using SSE2 where available. The block scan also tells whether a string is
+/// pure ASCII without escape sequences, in which case it is copied as is
+/// instead of being unescaped and normalized.
+///
+/// The accepted grammar is the same as the one of the former flex scanner:
+/// keywords are case-insensitive, numbers may have a leading plus sign, and
+/// strings may contain any byte except an unescaped quote.
+///
 /// DISCLAIMER
 ///
 /// Copyright 2004-2012 triagens GmbH, Cologne, Germany
@@ -28,2291 +37,380 @@
 
 #include "Basics/Common.h"
 
+#include "Basics/files.h"
 #include "Basics/json.h"
-#include "Basics/tri-strings.h"
 #include "Basics/logging.h"
+#include "Basics/tri-strings.h"
+#include "JsonParser/json-scanner.h"
 
-#ifdef _WIN32
-#define YY_NO_UNISTD_H 1
-#else
-#ifndef __FreeBSD__
-int fileno(FILE *stream);
-#endif
-#endif
-
-#define YY_NO_INPUT
-
-
-
-#line 48 "lib/JsonParser/json-parser.cpp"
-
-#define  YY_INT_ALIGNED short int
-
-/* A lexical scanner generated by flex */
-
-#define FLEX_SCANNER
-#define YY_FLEX_MAJOR_VERSION 2
-#define YY_FLEX_MINOR_VERSION 5
-#define YY_FLEX_SUBMINOR_VERSION 39
-#if YY_FLEX_SUBMINOR_VERSION > 0
-#define FLEX_BETA
-#endif
-
-/* First, we deal with  platform-specific or compiler-specific issues. */
-
-/* begin standard C headers. */
-#include <stdio.h>
-#include <string.h>
-#include <errno.h>
-#include <stdlib.h>
-
-/* end standard C headers. */
-
-/* flex integer type definitions */
-
-#ifndef FLEXINT_H
-#define FLEXINT_H
-
-/* C99 systems have <inttypes.h>. Non-C99 systems may or may not. */
-
-#if defined (__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
-
-/* C99 says to define __STDC_LIMIT_MACROS before including stdint.h,
- * if you want the limit (max/min) macros for int types. 
- */
-#ifndef __STDC_LIMIT_MACROS
-#define __STDC_LIMIT_MACROS 1
-#endif
-
-#include <inttypes.h>
-typedef int8_t flex_int8_t;
-typedef uint8_t flex_uint8_t;
-typedef int16_t flex_int16_t;
-typedef uint16_t flex_uint16_t;
-typedef int32_t flex_int32_t;
-typedef uint32_t flex_uint32_t;
-#else
-typedef signed char flex_int8_t;
-typedef short int flex_int16_t;
-typedef int flex_int32_t;
-typedef unsigned char flex_uint8_t; 
-typedef unsigned short int flex_uint16_t;
-typedef unsigned int flex_uint32_t;
-
-/* Limits of integral types. */
-#ifndef INT8_MIN
-#define INT8_MIN               (-128)
-#endif
-#ifndef INT16_MIN
-#define INT16_MIN              (-32767-1)
-#endif
-#ifndef INT32_MIN
-#define INT32_MIN              (-2147483647-1)
-#endif
-#ifndef INT8_MAX
-#define INT8_MAX               (127)
-#endif
-#ifndef INT16_MAX
-#define INT16_MAX              (32767)
-#endif
-#ifndef INT32_MAX
-#define INT32_MAX              (2147483647)
-#endif
-#ifndef UINT8_MAX
-#define UINT8_MAX              (255U)
-#endif
-#ifndef UINT16_MAX
-#define UINT16_MAX             (65535U)
-#endif
-#ifndef UINT32_MAX
-#define UINT32_MAX             (4294967295U)
-#endif
-
-#endif /* ! C99 */
-
-#endif /* ! FLEXINT_H */
-
-#ifdef __cplusplus
-
-/* The "const" storage-class-modifier is valid. */
-#define YY_USE_CONST
-
-#else	/* ! __cplusplus */
-
-/* C99 requires __STDC__ to be defined as 1. */
-#if defined (__STDC__)
-
-#define YY_USE_CONST
-
-#endif	/* defined (__STDC__) */
-#endif	/* ! __cplusplus */
-
-#ifdef YY_USE_CONST
-#define yyconst const
-#else
-#define yyconst
-#endif
-
-/* Returned upon end-of-file. */
-#define YY_NULL 0
-
-/* Promotes a possibly negative, possibly signed char to an unsigned
- * integer for use as an array index.  If the signed char is negative,
- * we want to instead treat it as an 8-bit unsigned char, hence the
- * double cast.
- */
-#define YY_SC_TO_UI(c) ((unsigned int) (unsigned char) c)
-
-/* An opaque pointer. */
-#ifndef YY_TYPEDEF_YY_SCANNER_T
-#define YY_TYPEDEF_YY_SCANNER_T
-typedef void* yyscan_t;
+#if defined(__SSE2__) || defined(_M_X64)
+#define TRI_JSON_PARSER_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
 #endif
-
-/* For convenience, these vars (plus the bison vars far below)
-   are macros in the reentrant scanner. */
-#define yyin yyg->yyin_r
-#define yyout yyg->yyout_r
-#define yyextra yyg->yyextra_r
-#define yyleng yyg->yyleng_r
-#define yytext yyg->yytext_r
-#define yylineno (YY_CURRENT_BUFFER_LVALUE->yy_bs_lineno)
-#define yycolumn (YY_CURRENT_BUFFER_LVALUE->yy_bs_column)
-#define yy_flex_debug yyg->yy_flex_debug_r
-
-/* Enter a start condition.  This macro really ought to take a parameter,
- * but we do it the disgusting crufty way forced on us by the ()-less
- * definition of BEGIN.
- */
-#define BEGIN yyg->yy_start = 1 + 2 *
-
-/* Translate the current start state into a value that can be later handed
- * to BEGIN to return to the state.  The YYSTATE alias is for lex
- * compatibility.
- */
-#define YY_START ((yyg->yy_start - 1) / 2)
-#define YYSTATE YY_START
-
-/* Action number for EOF rule of a given start state. */
-#define YY_STATE_EOF(state) (YY_END_OF_BUFFER + state + 1)
-
-/* Special action meaning "start processing a new file". */
-#define YY_NEW_FILE tri_jsp_restart(yyin ,yyscanner )
-
-#define YY_END_OF_BUFFER_CHAR 0
-
-/* Size of default input buffer. */
-#ifndef YY_BUF_SIZE
-#define YY_BUF_SIZE 16384
 #endif
 
-/* The state buf must be large enough to hold one state per character in the main buffer.
- */
-#define YY_STATE_BUF_SIZE   ((YY_BUF_SIZE + 2) * sizeof(yy_state_type))
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private defines
+// -----------------------------------------------------------------------------
 
-#ifndef YY_TYPEDEF_YY_BUFFER_STATE
-#define YY_TYPEDEF_YY_BUFFER_STATE
-typedef struct yy_buffer_state *YY_BUFFER_STATE;
-#endif
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum length of a number token
+////////////////////////////////////////////////////////////////////////////////
 
-#ifndef YY_TYPEDEF_YY_SIZE_T
-#define YY_TYPEDEF_YY_SIZE_T
-typedef size_t yy_size_t;
-#endif
+#define MAX_NUMBER_LENGTH 512
 
-#define EOB_ACT_CONTINUE_SCAN 0
-#define EOB_ACT_END_OF_FILE 1
-#define EOB_ACT_LAST_MATCH 2
-
-    #define YY_LESS_LINENO(n)
-    #define YY_LINENO_REWIND_TO(ptr)
-    
-/* Return all but the first "n" matched characters back to the input stream. */
-#define yyless(n) \
-	do \
-		{ \
-		/* Undo effects of setting up yytext. */ \
-        int yyless_macro_arg = (n); \
-        YY_LESS_LINENO(yyless_macro_arg);\
-		*yy_cp = yyg->yy_hold_char; \
-		YY_RESTORE_YY_MORE_OFFSET \
-		yyg->yy_c_buf_p = yy_cp = yy_bp + yyless_macro_arg - YY_MORE_ADJ; \
-		YY_DO_BEFORE_ACTION; /* set up yytext again */ \
-		} \
-	while ( 0 )
-
-#define unput(c) yyunput( c, yyg->yytext_ptr , yyscanner )
-
-#ifndef YY_STRUCT_YY_BUFFER_STATE
-#define YY_STRUCT_YY_BUFFER_STATE
-struct yy_buffer_state
-	{
-	FILE *yy_input_file;
-
-	char *yy_ch_buf;		/* input buffer */
-	char *yy_buf_pos;		/* current position in input buffer */
-
-	/* Size of input buffer in bytes, not including room for EOB
-	 * characters.
-	 */
-	yy_size_t yy_buf_size;
-
-	/* Number of characters read into yy_ch_buf, not including EOB
-	 * characters.
-	 */
-	yy_size_t yy_n_chars;
-
-	/* Whether we "own" the buffer - i.e., we know we created it,
-	 * and can realloc() it to grow it, and should free() it to
-	 * delete it.
-	 */
-	int yy_is_our_buffer;
-
-	/* Whether this is an "interactive" input source; if so, and
-	 * if we're using stdio for input, then we want to use getc()
-	 * instead of fread(), to make sure we stop fetching input after
-	 * each newline.
-	 */
-	int yy_is_interactive;
-
-	/* Whether we're considered to be at the beginning of a line.
-	 * If so, '^' rules will be active on the next match, otherwise
-	 * not.
-	 */
-	int yy_at_bol;
-
-    int yy_bs_lineno; /**< The line count. */
-    int yy_bs_column; /**< The column count. */
-    
-	/* Whether to try to fill the input buffer when we reach the
-	 * end of it.
-	 */
-	int yy_fill_buffer;
-
-	int yy_buffer_status;
-
-#define YY_BUFFER_NEW 0
-#define YY_BUFFER_NORMAL 1
-	/* When an EOF's been seen but there's still some text to process
-	 * then we mark the buffer as YY_EOF_PENDING, to indicate that we
-	 * shouldn't try reading from the input source any more.  We might
-	 * still have a bunch of tokens to match, though, because of
-	 * possible backing-up.
-	 *
-	 * When we actually see the EOF, we change the status to "new"
-	 * (via tri_jsp_restart()), so that the user can continue scanning by
-	 * just pointing yyin at a new input file.
-	 */
-#define YY_BUFFER_EOF_PENDING 2
-
-	};
-#endif /* !YY_STRUCT_YY_BUFFER_STATE */
-
-/* We provide macros for accessing buffer states in case in the
- * future we want to put the buffer states in a more general
- * "scanner state".
- *
- * Returns the top of the stack, or NULL.
- */
-#define YY_CURRENT_BUFFER ( yyg->yy_buffer_stack \
-                          ? yyg->yy_buffer_stack[yyg->yy_buffer_stack_top] \
-                          : NULL)
-
-/* Same as previous macro, but useful when we know that the buffer stack is not
- * NULL or when we need an lvalue. For internal use only.
- */
-#define YY_CURRENT_BUFFER_LVALUE yyg->yy_buffer_stack[yyg->yy_buffer_stack_top]
-
-void tri_jsp_restart (FILE *input_file ,yyscan_t yyscanner );
-void tri_jsp__switch_to_buffer (YY_BUFFER_STATE new_buffer ,yyscan_t yyscanner );
-YY_BUFFER_STATE tri_jsp__create_buffer (FILE *file,int size ,yyscan_t yyscanner );
-void tri_jsp__delete_buffer (YY_BUFFER_STATE b ,yyscan_t yyscanner );
-void tri_jsp__flush_buffer (YY_BUFFER_STATE b ,yyscan_t yyscanner );
-void tri_jsp_push_buffer_state (YY_BUFFER_STATE new_buffer ,yyscan_t yyscanner );
-void tri_jsp_pop_buffer_state (yyscan_t yyscanner );
-
-static void tri_jsp_ensure_buffer_stack (yyscan_t yyscanner );
-static void tri_jsp__load_buffer_state (yyscan_t yyscanner );
-static void tri_jsp__init_buffer (YY_BUFFER_STATE b,FILE *file ,yyscan_t yyscanner );
-
-#define YY_FLUSH_BUFFER tri_jsp__flush_buffer(YY_CURRENT_BUFFER ,yyscanner)
-
-YY_BUFFER_STATE tri_jsp__scan_buffer (char *base,yy_size_t size ,yyscan_t yyscanner );
-YY_BUFFER_STATE tri_jsp__scan_string (yyconst char *yy_str ,yyscan_t yyscanner );
-YY_BUFFER_STATE tri_jsp__scan_bytes (yyconst char *bytes,yy_size_t len ,yyscan_t yyscanner );
-
-void *tri_jsp_alloc (yy_size_t ,yyscan_t yyscanner );
-void *tri_jsp_realloc (void *,yy_size_t ,yyscan_t yyscanner );
-void tri_jsp_free (void * ,yyscan_t yyscanner );
-
-#define yy_new_buffer tri_jsp__create_buffer
-
-#define yy_set_interactive(is_interactive) \
-	{ \
-	if ( ! YY_CURRENT_BUFFER ){ \
-        tri_jsp_ensure_buffer_stack (yyscanner); \
-		YY_CURRENT_BUFFER_LVALUE =    \
-            tri_jsp__create_buffer(yyin,YY_BUF_SIZE ,yyscanner); \
-	} \
-	YY_CURRENT_BUFFER_LVALUE->yy_is_interactive = is_interactive; \
-	}
-
-#define yy_set_bol(at_bol) \
-	{ \
-	if ( ! YY_CURRENT_BUFFER ){\
-        tri_jsp_ensure_buffer_stack (yyscanner); \
-		YY_CURRENT_BUFFER_LVALUE =    \
-            tri_jsp__create_buffer(yyin,YY_BUF_SIZE ,yyscanner); \
-	} \
-	YY_CURRENT_BUFFER_LVALUE->yy_at_bol = at_bol; \
-	}
-
-#define YY_AT_BOL() (YY_CURRENT_BUFFER_LVALUE->yy_at_bol)
-
-/* Begin user sect3 */
-
-#define tri_jsp_wrap(yyscanner) 1
-#define YY_SKIP_YYWRAP
-
-typedef unsigned char YY_CHAR;
-
-typedef int yy_state_type;
-
-#define yytext_ptr yytext_r
-
-static yy_state_type yy_get_previous_state (yyscan_t yyscanner );
-static yy_state_type yy_try_NUL_trans (yy_state_type current_state  ,yyscan_t yyscanner);
-static int yy_get_next_buffer (yyscan_t yyscanner );
-static void yy_fatal_error (yyconst char msg[] ,yyscan_t yyscanner );
-
-/* Done after the current pattern has been matched and before the
- * corresponding action - sets up yytext.
- */
-#define YY_DO_BEFORE_ACTION \
-	yyg->yytext_ptr = yy_bp; \
-	yyleng = (size_t) (yy_cp - yy_bp); \
-	yyg->yy_hold_char = *yy_cp; \
-	*yy_cp = '\0'; \
-	yyg->yy_c_buf_p = yy_cp;
-
-#define YY_NUM_RULES 15
-#define YY_END_OF_BUFFER 16
-/* This struct is not used in this scanner,
-   but its presence is necessary. */
-struct yy_trans_info
-	{
-	flex_int32_t yy_verify;
-	flex_int32_t yy_nxt;
-	};
-static yyconst flex_int16_t yy_accept[45] =
-    {   0,
-       13,   13,   16,   14,   13,   13,   14,   14,   11,    6,
-        6,   12,   14,   14,   14,    9,   10,    7,    8,   13,
-        0,    0,    4,    0,    6,    6,    0,    0,    6,    0,
-        0,    0,    5,    6,    0,    6,    0,    0,    0,    0,
-        2,    3,    1,    0
-    } ;
-
-static yyconst flex_int32_t yy_ec[256] =
-    {   0,
-        1,    1,    1,    1,    1,    1,    1,    1,    2,    3,
-        1,    1,    2,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    4,    5,    6,    5,    5,    5,    5,    5,    5,
-        5,    5,    7,    8,    9,   10,    5,   11,   12,   12,
-       12,   12,   12,   12,   12,   12,   12,   13,    5,    5,
-        5,    5,    5,    5,   14,    5,    5,    5,   15,   16,
-        5,    5,    5,    5,    5,   17,    5,   18,    5,    5,
-        5,   19,   20,   21,   22,    5,    5,    5,    5,    5,
-       23,   24,   25,    5,    5,    5,   26,    5,    5,    5,
-
-       27,   28,    5,    5,    5,    5,    5,   29,    5,   30,
-        5,    5,    5,   31,   32,   33,   34,    5,    5,    5,
-        1,    1,   35,    1,   36,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1
-    } ;
-
-static yyconst flex_int32_t yy_meta[37] =
-    {   0,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1
-    } ;
-
-static yyconst flex_int16_t yy_base[47] =
-    {   0,
-        0,    0,  119,  131,   35,   38,   42,   35,  131,   40,
-       41,  131,   35,   35,   39,  131,  131,  131,  131,   60,
-       48,   78,  131,   93,   61,   79,   48,   86,   89,   56,
-       57,   53,  131,   96,   71,   98,   83,   88,   97,  103,
-      131,  131,  131,  131,   91,   64
-    } ;
-
-static yyconst flex_int16_t yy_def[47] =
-    {   0,
-       44,    1,   44,   44,   44,   44,   45,   44,   44,   44,
-       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
-       46,   45,   44,   46,   44,   44,   44,   44,   44,   44,
-       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
-       44,   44,   44,    0,   44,   44
-    } ;
-
-static yyconst flex_int16_t yy_nxt[168] =
-    {   0,
-        4,    5,    6,    5,    4,    7,    8,    9,    8,    4,
-       10,   11,   12,    4,    4,   13,    4,   14,    4,    4,
-       15,    4,   16,    4,   17,    4,    4,   13,    4,   14,
-        4,    4,   15,    4,   18,   19,   20,   20,   20,   20,
-       20,   20,   21,   21,   21,   25,   26,   23,   30,   27,
-       27,   29,   29,   33,   28,   28,   31,   32,   34,   34,
-       30,   20,   20,   20,   21,   24,   28,   28,   31,   32,
-       27,   24,   37,   38,   39,   28,   21,   21,   21,   21,
-       21,   36,   36,   23,   37,   38,   39,   28,   27,   29,
-       29,   22,   35,   28,   35,   44,   36,   36,   27,   29,
-
-       29,   24,   40,   28,   41,   28,   34,   34,   36,   36,
-       28,   42,   21,   21,   40,   28,   41,   43,   44,   44,
-       44,   44,   28,   42,   44,   44,   44,   44,   44,   43,
-        3,   44,   44,   44,   44,   44,   44,   44,   44,   44,
-       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
-       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
-       44,   44,   44,   44,   44,   44,   44
-    } ;
-
-static yyconst flex_int16_t yy_chk[168] =
-    {   0,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    5,    5,    5,    6,
-        6,    6,    7,    7,    7,    8,    8,    7,   13,   10,
-       11,   11,   11,   21,   10,   11,   14,   15,   27,   27,
-       13,   20,   20,   20,   46,    7,   10,   11,   14,   15,
-       25,   21,   30,   31,   32,   25,    7,    7,   22,   22,
-       22,   35,   35,   22,   30,   31,   32,   25,   26,   26,
-       26,   45,   28,   26,   28,   24,   28,   28,   29,   29,
-
-       29,   22,   37,   29,   38,   26,   34,   34,   36,   36,
-       34,   39,   22,   22,   37,   29,   38,   40,    3,    0,
-        0,    0,   34,   39,    0,    0,    0,    0,    0,   40,
-       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
-       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
-       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
-       44,   44,   44,   44,   44,   44,   44
-    } ;
-
-/* The intent behind this definition is that it'll catch
- * any uses of REJECT which flex missed.
- */
-#define REJECT reject_used_but_not_detected
-#define yymore() yymore_used_but_not_detected
-#define YY_MORE_ADJ 0
-#define YY_RESTORE_YY_MORE_OFFSET
-
-#define END_OF_FILE 0
-#define FALSE_CONSTANT 1
-#define TRUE_CONSTANT 2
-#define NULL_CONSTANT 3
-#define NUMBER_CONSTANT 4
-#define STRING_CONSTANT 5
-#define OPEN_BRACE 6
-#define CLOSE_BRACE 7
-#define OPEN_BRACKET 8
-#define CLOSE_BRACKET 9
-#define COMMA 10
-#define COLON 11
-#define UNQUOTED_STRING 12
-#define STRING_CONSTANT_ASCII 13
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
 
 static char const* EmptyString = "";
 
-struct jsonData {
-  TRI_memory_zone_t* _memoryZone;
-  char const* _message;
-};
-
-#define YY_FATAL_ERROR(a)              \
-  do {                                 \
-    LOG_DEBUG("json-parser: %s", (a)); \
-    if (false) {                       \
-      yy_fatal_error(a, nullptr);         \
-    }                                  \
-  }                                    \
-  while (0)
-
-#define INITIAL 0
-
-#ifndef YY_NO_UNISTD_H
-/* Special case for "unistd.h", since it is non-ANSI. We include it way
- * down here because we want the user's section 1 to have been scanned first.
- * The user has a chance to override it with an option.
- */
-#include <unistd.h>
-#endif
-
-#define YY_EXTRA_TYPE struct jsonData
-
-/* Holds the entire state of the reentrant scanner. */
-struct yyguts_t
-    {
-
-    /* User-defined. Not touched by flex. */
-    YY_EXTRA_TYPE yyextra_r;
-
-    /* The rest are the same as the globals declared in the non-reentrant scanner. */
-    FILE *yyin_r, *yyout_r;
-    size_t yy_buffer_stack_top; /**< index of top of stack. */
-    size_t yy_buffer_stack_max; /**< capacity of stack. */
-    YY_BUFFER_STATE * yy_buffer_stack; /**< Stack as an array. */
-    char yy_hold_char;
-    yy_size_t yy_n_chars;
-    yy_size_t yyleng_r;
-    char *yy_c_buf_p;
-    int yy_init;
-    int yy_start;
-    int yy_did_buffer_switch_on_eof;
-    int yy_start_stack_ptr;
-    int yy_start_stack_depth;
-    int *yy_start_stack;
-    yy_state_type yy_last_accepting_state;
-    char* yy_last_accepting_cpos;
-
-    int yylineno_r;
-    int yy_flex_debug_r;
-
-    char *yytext_r;
-    int yy_more_flag;
-    int yy_more_len;
-
-    }; /* end struct yyguts_t */
-
-static int yy_init_globals (yyscan_t yyscanner );
-
-int tri_jsp_lex_init (yyscan_t* scanner);
-
-int tri_jsp_lex_init_extra (YY_EXTRA_TYPE user_defined,yyscan_t* scanner);
-
-/* Accessor methods to globals.
-   These are made visible to non-reentrant scanners for convenience. */
-
-int tri_jsp_lex_destroy (yyscan_t yyscanner );
-
-int tri_jsp_get_debug (yyscan_t yyscanner );
-
-void tri_jsp_set_debug (int debug_flag ,yyscan_t yyscanner );
-
-YY_EXTRA_TYPE tri_jsp_get_extra (yyscan_t yyscanner );
-
-void tri_jsp_set_extra (YY_EXTRA_TYPE user_defined ,yyscan_t yyscanner );
-
-FILE *tri_jsp_get_in (yyscan_t yyscanner );
-
-void tri_jsp_set_in  (FILE * in_str ,yyscan_t yyscanner );
-
-FILE *tri_jsp_get_out (yyscan_t yyscanner );
-
-void tri_jsp_set_out  (FILE * out_str ,yyscan_t yyscanner );
-
-yy_size_t tri_jsp_get_leng (yyscan_t yyscanner );
-
-char *tri_jsp_get_text (yyscan_t yyscanner );
-
-int tri_jsp_get_lineno (yyscan_t yyscanner );
-
-void tri_jsp_set_lineno (int line_number ,yyscan_t yyscanner );
-
-int tri_jsp_get_column  (yyscan_t yyscanner );
-
-void tri_jsp_set_column (int column_no ,yyscan_t yyscanner );
-
-/* Macros after this point can all be overridden by user definitions in
- * section 1.
- */
-
-#ifndef YY_SKIP_YYWRAP
-#ifdef __cplusplus
-extern "C" int tri_jsp_wrap (yyscan_t yyscanner );
-#else
-extern int tri_jsp_wrap (yyscan_t yyscanner );
-#endif
-#endif
+// -----------------------------------------------------------------------------
+// --SECTION--                                              forward declarations
+// -----------------------------------------------------------------------------
 
-#ifndef yytext_ptr
-static void yy_flex_strncpy (char *,yyconst char *,int ,yyscan_t yyscanner);
-#endif
+static bool ParseObject (TRI_json_scanner_t*, TRI_json_t*);
+static bool ParseValue (TRI_json_scanner_t*, TRI_json_t*, int);
 
-#ifdef YY_NEED_STRLEN
-static int yy_flex_strlen (yyconst char * ,yyscan_t yyscanner);
-#endif
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
 
-#ifndef YY_NO_INPUT
+////////////////////////////////////////////////////////////////////////////////
+/// @brief index of the lowest bit set in a non-zero mask
+////////////////////////////////////////////////////////////////////////////////
 
-#ifdef __cplusplus
-static int yyinput (yyscan_t yyscanner );
+#ifdef TRI_JSON_PARSER_SSE2
+static inline int LowestBit (int mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, (unsigned long) mask);
+  return (int) index;
 #else
-static int input (yyscan_t yyscanner );
+  return __builtin_ctz((unsigned int) mask);
 #endif
-
-#endif
-
-/* Amount of stuff to slurp up with each read. */
-#ifndef YY_READ_BUF_SIZE
-#define YY_READ_BUF_SIZE 8192
-#endif
-
-/* Copy whatever the last rule matched to the standard output. */
-#ifndef ECHO
-/* This used to be an fputs(), but since the string might contain NUL's,
- * we now use fwrite().
- */
-#define ECHO do { if (fwrite( yytext, yyleng, 1, yyout )) {} } while (0)
-#endif
-
-/* Gets input and stuffs it into "buf".  number of characters read, or YY_NULL,
- * is returned in "result".
- */
-#ifndef YY_INPUT
-#define YY_INPUT(buf,result,max_size) \
-	if ( YY_CURRENT_BUFFER_LVALUE->yy_is_interactive ) \
-		{ \
-		int c = '*'; \
-		size_t n; \
-		for ( n = 0; n < max_size && \
-			     (c = getc( yyin )) != EOF && c != '\n'; ++n ) \
-			buf[n] = (char) c; \
-		if ( c == '\n' ) \
-			buf[n++] = (char) c; \
-		if ( c == EOF && ferror( yyin ) ) \
-			YY_FATAL_ERROR( "input in flex scanner failed" ); \
-		result = n; \
-		} \
-	else \
-		{ \
-		errno=0; \
-		while ( (result = fread(buf, 1, max_size, yyin))==0 && ferror(yyin)) \
-			{ \
-			if( errno != EINTR) \
-				{ \
-				YY_FATAL_ERROR( "input in flex scanner failed" ); \
-				break; \
-				} \
-			errno=0; \
-			clearerr(yyin); \
-			} \
-		}\
-\
-
-#endif
-
-/* No semi-colon after return; correct usage is to write "yyterminate();" -
- * we don't want an extra ';' after the "return" because that will cause
- * some compilers to complain about unreachable statements.
- */
-#ifndef yyterminate
-#define yyterminate() return YY_NULL
-#endif
-
-/* Number of entries by which start-condition stack grows. */
-#ifndef YY_START_STACK_INCR
-#define YY_START_STACK_INCR 25
-#endif
-
-/* Report a fatal error. */
-#ifndef YY_FATAL_ERROR
-#define YY_FATAL_ERROR(msg) yy_fatal_error( msg , yyscanner)
-#endif
-
-/* end tables serialization structures and prototypes */
-
-/* Default declaration of generated scanner - a define so the user can
- * easily add parameters.
- */
-#ifndef YY_DECL
-#define YY_DECL_IS_OURS 1
-
-extern int tri_jsp_lex (yyscan_t yyscanner);
-
-#define YY_DECL int tri_jsp_lex (yyscan_t yyscanner)
-#endif /* !YY_DECL */
-
-/* Code executed at the beginning of each rule, after yytext and yyleng
- * have been set up.
- */
-#ifndef YY_USER_ACTION
-#define YY_USER_ACTION
-#endif
-
-/* Code executed at the end of each rule. */
-#ifndef YY_BREAK
-#define YY_BREAK break;
-#endif
-
-#define YY_RULE_SETUP \
-	YY_USER_ACTION
-
-/** The main scanner function which does all the work.
- */
-YY_DECL
-{
-	yy_state_type yy_current_state;
-	char *yy_cp, *yy_bp;
-	int yy_act;
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-
-	if ( !yyg->yy_init )
-		{
-		yyg->yy_init = 1;
-
-#ifdef YY_USER_INIT
-		YY_USER_INIT;
-#endif
-
-		if ( ! yyg->yy_start )
-			yyg->yy_start = 1;	/* first start state */
-
-		if ( ! yyin )
-			yyin = stdin;
-
-		if ( ! yyout )
-			yyout = stdout;
-
-		if ( ! YY_CURRENT_BUFFER ) {
-			tri_jsp_ensure_buffer_stack (yyscanner);
-			YY_CURRENT_BUFFER_LVALUE =
-				tri_jsp__create_buffer(yyin,YY_BUF_SIZE ,yyscanner);
-		}
-
-		tri_jsp__load_buffer_state(yyscanner );
-		}
-
-	{
-
- /* -----------------------------------------------------------------------------
-  * keywords
-  * ----------------------------------------------------------------------------- */
-
-	while ( 1 )		/* loops until end-of-file is reached */
-		{
-		yy_cp = yyg->yy_c_buf_p;
-
-		/* Support of yytext. */
-		*yy_cp = yyg->yy_hold_char;
-
-		/* yy_bp points to the position in yy_ch_buf of the start of
-		 * the current run.
-		 */
-		yy_bp = yy_cp;
-
-		yy_current_state = yyg->yy_start;
-yy_match:
-		do
-			{
-			YY_CHAR yy_c = yy_ec[YY_SC_TO_UI(*yy_cp)] ;
-			if ( yy_accept[yy_current_state] )
-				{
-				yyg->yy_last_accepting_state = yy_current_state;
-				yyg->yy_last_accepting_cpos = yy_cp;
-				}
-			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
-				{
-				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 45 )
-					yy_c = yy_meta[(unsigned int) yy_c];
-				}
-			yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-			++yy_cp;
-			}
-		while ( yy_current_state != 44 );
-		yy_cp = yyg->yy_last_accepting_cpos;
-		yy_current_state = yyg->yy_last_accepting_state;
-
-yy_find_action:
-		yy_act = yy_accept[yy_current_state];
-
-		YY_DO_BEFORE_ACTION;
-
-do_action:	/* This label is used only to access EOF actions. */
-
-		switch ( yy_act )
-	{ /* beginning of action switch */
-			case 0: /* must back up */
-			/* undo the effects of YY_DO_BEFORE_ACTION */
-			*yy_cp = yyg->yy_hold_char;
-			yy_cp = yyg->yy_last_accepting_cpos;
-			yy_current_state = yyg->yy_last_accepting_state;
-			goto yy_find_action;
-
-case 1:
-YY_RULE_SETUP
-{
-  return FALSE_CONSTANT;
-}
-	YY_BREAK
-case 2:
-YY_RULE_SETUP
-{
-  return NULL_CONSTANT;
-}
-	YY_BREAK
-case 3:
-YY_RULE_SETUP
-{
-  return TRUE_CONSTANT;
-}
-	YY_BREAK
-/* -----------------------------------------------------------------------------
-  * strings
-  * ----------------------------------------------------------------------------- */
-case 4:
-YY_RULE_SETUP
-{
-  // performance optimisation for all-ASCII strings without escape characters
-  // this matches the ASCII chars with ordinal numbers 35 (x23) to 127 (x7f), 
-  // plus space (32) and ! (33) but no quotation marks (34, x22) and backslashes (92, x5c)
-  return STRING_CONSTANT_ASCII;
-}
-	YY_BREAK
-case 5:
-/* rule 5 can match eol */
-YY_RULE_SETUP
-{
-  return STRING_CONSTANT;
-}
-	YY_BREAK
-/* -----------------------------------------------------------------------------
-  * numbers
-  * ----------------------------------------------------------------------------- */
-case 6:
-YY_RULE_SETUP
-{
-  return NUMBER_CONSTANT;
-}
-	YY_BREAK
-/* -----------------------------------------------------------------------------
-  * special characters
-  * ----------------------------------------------------------------------------- */
-case 7:
-YY_RULE_SETUP
-{
-  return OPEN_BRACE;
-}
-	YY_BREAK
-case 8:
-YY_RULE_SETUP
-{
-  return CLOSE_BRACE;
-}
-	YY_BREAK
-case 9:
-YY_RULE_SETUP
-{
-  return OPEN_BRACKET;
-}
-	YY_BREAK
-case 10:
-YY_RULE_SETUP
-{
-  return CLOSE_BRACKET;
-}
-	YY_BREAK
-case 11:
-YY_RULE_SETUP
-{
- return COMMA;
-}
-	YY_BREAK
-case 12:
-YY_RULE_SETUP
-{
-  return COLON;
-}
-	YY_BREAK
-/* -----------------------------------------------------------------------------
-  * Skip whitespaces. Whatever is left, should be an unquoted string appearing
-  * somewhere. This will be reported as an error.
-  * ----------------------------------------------------------------------------- */
-case 13:
-/* rule 13 can match eol */
-YY_RULE_SETUP
-{
-}
-	YY_BREAK
-case 14:
-YY_RULE_SETUP
-{
-  return UNQUOTED_STRING;
-}
-	YY_BREAK
-case 15:
-YY_RULE_SETUP
-ECHO;
-	YY_BREAK
-case YY_STATE_EOF(INITIAL):
-	yyterminate();
-
-	case YY_END_OF_BUFFER:
-		{
-		/* Amount of text matched not including the EOB char. */
-		int yy_amount_of_matched_text = (int) (yy_cp - yyg->yytext_ptr) - 1;
-
-		/* Undo the effects of YY_DO_BEFORE_ACTION. */
-		*yy_cp = yyg->yy_hold_char;
-		YY_RESTORE_YY_MORE_OFFSET
-
-		if ( YY_CURRENT_BUFFER_LVALUE->yy_buffer_status == YY_BUFFER_NEW )
-			{
-			/* We're scanning a new file or input source.  It's
-			 * possible that this happened because the user
-			 * just pointed yyin at a new source and called
-			 * tri_jsp_lex().  If so, then we have to assure
-			 * consistency between YY_CURRENT_BUFFER and our
-			 * globals.  Here is the right place to do so, because
-			 * this is the first action (other than possibly a
-			 * back-up) that will match for the new input source.
-			 */
-			yyg->yy_n_chars = YY_CURRENT_BUFFER_LVALUE->yy_n_chars;
-			YY_CURRENT_BUFFER_LVALUE->yy_input_file = yyin;
-			YY_CURRENT_BUFFER_LVALUE->yy_buffer_status = YY_BUFFER_NORMAL;
-			}
-
-		/* Note that here we test for yy_c_buf_p "<=" to the position
-		 * of the first EOB in the buffer, since yy_c_buf_p will
-		 * already have been incremented past the NUL character
-		 * (since all states make transitions on EOB to the
-		 * end-of-buffer state).  Contrast this with the test
-		 * in input().
-		 */
-		if ( yyg->yy_c_buf_p <= &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars] )
-			{ /* This was really a NUL. */
-			yy_state_type yy_next_state;
-
-			yyg->yy_c_buf_p = yyg->yytext_ptr + yy_amount_of_matched_text;
-
-			yy_current_state = yy_get_previous_state( yyscanner );
-
-			/* Okay, we're now positioned to make the NUL
-			 * transition.  We couldn't have
-			 * yy_get_previous_state() go ahead and do it
-			 * for us because it doesn't know how to deal
-			 * with the possibility of jamming (and we don't
-			 * want to build jamming into it because then it
-			 * will run more slowly).
-			 */
-
-			yy_next_state = yy_try_NUL_trans( yy_current_state , yyscanner);
-
-			yy_bp = yyg->yytext_ptr + YY_MORE_ADJ;
-
-			if ( yy_next_state )
-				{
-				/* Consume the NUL. */
-				yy_cp = ++yyg->yy_c_buf_p;
-				yy_current_state = yy_next_state;
-				goto yy_match;
-				}
-
-			else
-				{
-				yy_cp = yyg->yy_last_accepting_cpos;
-				yy_current_state = yyg->yy_last_accepting_state;
-				goto yy_find_action;
-				}
-			}
-
-		else switch ( yy_get_next_buffer( yyscanner ) )
-			{
-			case EOB_ACT_END_OF_FILE:
-				{
-				yyg->yy_did_buffer_switch_on_eof = 0;
-
-				if ( tri_jsp_wrap(yyscanner ) )
-					{
-					/* Note: because we've taken care in
-					 * yy_get_next_buffer() to have set up
-					 * yytext, we can now set up
-					 * yy_c_buf_p so that if some total
-					 * hoser (like flex itself) wants to
-					 * call the scanner after we return the
-					 * YY_NULL, it'll still work - another
-					 * YY_NULL will get returned.
-					 */
-					yyg->yy_c_buf_p = yyg->yytext_ptr + YY_MORE_ADJ;
-
-					yy_act = YY_STATE_EOF(YY_START);
-					goto do_action;
-					}
-
-				else
-					{
-					if ( ! yyg->yy_did_buffer_switch_on_eof )
-						YY_NEW_FILE;
-					}
-				break;
-				}
-
-			case EOB_ACT_CONTINUE_SCAN:
-				yyg->yy_c_buf_p =
-					yyg->yytext_ptr + yy_amount_of_matched_text;
-
-				yy_current_state = yy_get_previous_state( yyscanner );
-
-				yy_cp = yyg->yy_c_buf_p;
-				yy_bp = yyg->yytext_ptr + YY_MORE_ADJ;
-				goto yy_match;
-
-			case EOB_ACT_LAST_MATCH:
-				yyg->yy_c_buf_p =
-				&YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars];
-
-				yy_current_state = yy_get_previous_state( yyscanner );
-
-				yy_cp = yyg->yy_c_buf_p;
-				yy_bp = yyg->yytext_ptr + YY_MORE_ADJ;
-				goto yy_find_action;
-			}
-		break;
-		}
-
-	default:
-		YY_FATAL_ERROR(
-			"fatal flex scanner internal error--no action found" );
-	} /* end of action switch */
-		} /* end of scanning one token */
-	} /* end of user's declarations */
-} /* end of tri_jsp_lex */
-
-/* yy_get_next_buffer - try to read in a new buffer
- *
- * Returns a code representing an action:
- *	EOB_ACT_LAST_MATCH -
- *	EOB_ACT_CONTINUE_SCAN - continue scanning from current position
- *	EOB_ACT_END_OF_FILE - end of file
- */
-static int yy_get_next_buffer (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-	char *dest = YY_CURRENT_BUFFER_LVALUE->yy_ch_buf;
-	char *source = yyg->yytext_ptr;
-	int number_to_move, i;
-	int ret_val;
-
-	if ( yyg->yy_c_buf_p > &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars + 1] )
-		YY_FATAL_ERROR(
-		"fatal flex scanner internal error--end of buffer missed" );
-
-	if ( YY_CURRENT_BUFFER_LVALUE->yy_fill_buffer == 0 )
-		{ /* Don't try to fill the buffer, so this is an EOF. */
-		if ( yyg->yy_c_buf_p - yyg->yytext_ptr - YY_MORE_ADJ == 1 )
-			{
-			/* We matched a single character, the EOB, so
-			 * treat this as a final EOF.
-			 */
-			return EOB_ACT_END_OF_FILE;
-			}
-
-		else
-			{
-			/* We matched some text prior to the EOB, first
-			 * process it.
-			 */
-			return EOB_ACT_LAST_MATCH;
-			}
-		}
-
-	/* Try to read more data. */
-
-	/* First move last chars to start of buffer. */
-	number_to_move = (int) (yyg->yy_c_buf_p - yyg->yytext_ptr) - 1;
-
-	for ( i = 0; i < number_to_move; ++i )
-		*(dest++) = *(source++);
-
-	if ( YY_CURRENT_BUFFER_LVALUE->yy_buffer_status == YY_BUFFER_EOF_PENDING )
-		/* don't do the read, it's not guaranteed to return an EOF,
-		 * just force an EOF
-		 */
-		YY_CURRENT_BUFFER_LVALUE->yy_n_chars = yyg->yy_n_chars = 0;
-
-	else
-		{
-			yy_size_t num_to_read =
-			YY_CURRENT_BUFFER_LVALUE->yy_buf_size - number_to_move - 1;
-
-		while ( num_to_read <= 0 )
-			{ /* Not enough room in the buffer - grow it. */
-
-			/* just a shorter name for the current buffer */
-			YY_BUFFER_STATE b = YY_CURRENT_BUFFER_LVALUE;
-
-			int yy_c_buf_p_offset =
-				(int) (yyg->yy_c_buf_p - b->yy_ch_buf);
-
-			if ( b->yy_is_our_buffer )
-				{
-				yy_size_t new_size = b->yy_buf_size * 2;
-
-				if ( new_size <= 0 )
-					b->yy_buf_size += b->yy_buf_size / 8;
-				else
-					b->yy_buf_size *= 2;
-
-				b->yy_ch_buf = (char *)
-					/* Include room in for 2 EOB chars. */
-					tri_jsp_realloc((void *) b->yy_ch_buf,b->yy_buf_size + 2 ,yyscanner );
-				}
-			else
-				/* Can't grow it, we don't own it. */
-				b->yy_ch_buf = 0;
-
-			if ( ! b->yy_ch_buf )
-				YY_FATAL_ERROR(
-				"fatal error - scanner input buffer overflow" );
-
-			yyg->yy_c_buf_p = &b->yy_ch_buf[yy_c_buf_p_offset];
-
-			num_to_read = YY_CURRENT_BUFFER_LVALUE->yy_buf_size -
-						number_to_move - 1;
-
-			}
-
-		if ( num_to_read > YY_READ_BUF_SIZE )
-			num_to_read = YY_READ_BUF_SIZE;
-
-		/* Read in more data. */
-		YY_INPUT( (&YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[number_to_move]),
-			yyg->yy_n_chars, num_to_read );
-
-		YY_CURRENT_BUFFER_LVALUE->yy_n_chars = yyg->yy_n_chars;
-		}
-
-	if ( yyg->yy_n_chars == 0 )
-		{
-		if ( number_to_move == YY_MORE_ADJ )
-			{
-			ret_val = EOB_ACT_END_OF_FILE;
-			tri_jsp_restart(yyin  ,yyscanner);
-			}
-
-		else
-			{
-			ret_val = EOB_ACT_LAST_MATCH;
-			YY_CURRENT_BUFFER_LVALUE->yy_buffer_status =
-				YY_BUFFER_EOF_PENDING;
-			}
-		}
-
-	else
-		ret_val = EOB_ACT_CONTINUE_SCAN;
-
-	if ((yy_size_t) (yyg->yy_n_chars + number_to_move) > YY_CURRENT_BUFFER_LVALUE->yy_buf_size) {
-		/* Extend the array by 50%, plus the number we really need. */
-		yy_size_t new_size = yyg->yy_n_chars + number_to_move + (yyg->yy_n_chars >> 1);
-		YY_CURRENT_BUFFER_LVALUE->yy_ch_buf = (char *) tri_jsp_realloc((void *) YY_CURRENT_BUFFER_LVALUE->yy_ch_buf,new_size ,yyscanner );
-		if ( ! YY_CURRENT_BUFFER_LVALUE->yy_ch_buf )
-			YY_FATAL_ERROR( "out of dynamic memory in yy_get_next_buffer()" );
-	}
-
-	yyg->yy_n_chars += number_to_move;
-	YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars] = YY_END_OF_BUFFER_CHAR;
-	YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars + 1] = YY_END_OF_BUFFER_CHAR;
-
-	yyg->yytext_ptr = &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[0];
-
-	return ret_val;
-}
-
-/* yy_get_previous_state - get the state just before the EOB char was reached */
-
-    static yy_state_type yy_get_previous_state (yyscan_t yyscanner)
-{
-	yy_state_type yy_current_state;
-	char *yy_cp;
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-
-	yy_current_state = yyg->yy_start;
-
-	for ( yy_cp = yyg->yytext_ptr + YY_MORE_ADJ; yy_cp < yyg->yy_c_buf_p; ++yy_cp )
-		{
-		YY_CHAR yy_c = (*yy_cp ? yy_ec[YY_SC_TO_UI(*yy_cp)] : 1);
-		if ( yy_accept[yy_current_state] )
-			{
-			yyg->yy_last_accepting_state = yy_current_state;
-			yyg->yy_last_accepting_cpos = yy_cp;
-			}
-		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
-			{
-			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 45 )
-				yy_c = yy_meta[(unsigned int) yy_c];
-			}
-		yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-		}
-
-	return yy_current_state;
 }
-
-/* yy_try_NUL_trans - try to make a transition on the NUL character
- *
- * synopsis
- *	next_state = yy_try_NUL_trans( current_state );
- */
-    static yy_state_type yy_try_NUL_trans  (yy_state_type yy_current_state , yyscan_t yyscanner)
-{
-	int yy_is_jam;
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner; /* This var may be unused depending upon options. */
-	char *yy_cp = yyg->yy_c_buf_p;
-
-	YY_CHAR yy_c = 1;
-	if ( yy_accept[yy_current_state] )
-		{
-		yyg->yy_last_accepting_state = yy_current_state;
-		yyg->yy_last_accepting_cpos = yy_cp;
-		}
-	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
-		{
-		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 45 )
-			yy_c = yy_meta[(unsigned int) yy_c];
-		}
-	yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-	yy_is_jam = (yy_current_state == 44);
-
-	(void)yyg;
-	return yy_is_jam ? 0 : yy_current_state;
-}
-
-#ifndef YY_NO_INPUT
-#ifdef __cplusplus
-    static int yyinput (yyscan_t yyscanner)
-#else
-    static int input  (yyscan_t yyscanner)
 #endif
 
-{
-	int c;
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-
-	*yyg->yy_c_buf_p = yyg->yy_hold_char;
-
-	if ( *yyg->yy_c_buf_p == YY_END_OF_BUFFER_CHAR )
-		{
-		/* yy_c_buf_p now points to the character we want to return.
-		 * If this occurs *before* the EOB characters, then it's a
-		 * valid NUL; if not, then we've hit the end of the buffer.
-		 */
-		if ( yyg->yy_c_buf_p < &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars] )
-			/* This was really a NUL. */
-			*yyg->yy_c_buf_p = '\0';
-
-		else
-			{ /* need more input */
-			yy_size_t offset = yyg->yy_c_buf_p - yyg->yytext_ptr;
-			++yyg->yy_c_buf_p;
-
-			switch ( yy_get_next_buffer( yyscanner ) )
-				{
-				case EOB_ACT_LAST_MATCH:
-					/* This happens because yy_g_n_b()
-					 * sees that we've accumulated a
-					 * token and flags that we need to
-					 * try matching the token before
-					 * proceeding.  But for input(),
-					 * there's no matching to consider.
-					 * So convert the EOB_ACT_LAST_MATCH
-					 * to EOB_ACT_END_OF_FILE.
-					 */
-
-					/* Reset buffer status. */
-					tri_jsp_restart(yyin ,yyscanner);
-
-					/*FALLTHROUGH*/
-
-				case EOB_ACT_END_OF_FILE:
-					{
-					if ( tri_jsp_wrap(yyscanner ) )
-						return EOF;
-
-					if ( ! yyg->yy_did_buffer_switch_on_eof )
-						YY_NEW_FILE;
-#ifdef __cplusplus
-					return yyinput(yyscanner);
-#else
-					return input(yyscanner);
-#endif
-					}
-
-				case EOB_ACT_CONTINUE_SCAN:
-					yyg->yy_c_buf_p = yyg->yytext_ptr + offset;
-					break;
-				}
-			}
-		}
-
-	c = *(unsigned char *) yyg->yy_c_buf_p;	/* cast for 8-bit char's */
-	*yyg->yy_c_buf_p = '\0';	/* preserve yytext */
-	yyg->yy_hold_char = *++yyg->yy_c_buf_p;
-
-	return c;
-}
-#endif	/* ifndef YY_NO_INPUT */
-
-/** Immediately switch to a different input stream.
- * @param input_file A readable stream.
- * @param yyscanner The scanner object.
- * @note This function does not reset the start condition to @c INITIAL .
- */
-    void tri_jsp_restart  (FILE * input_file , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-
-	if ( ! YY_CURRENT_BUFFER ){
-        tri_jsp_ensure_buffer_stack (yyscanner);
-		YY_CURRENT_BUFFER_LVALUE =
-            tri_jsp__create_buffer(yyin,YY_BUF_SIZE ,yyscanner);
-	}
-
-	tri_jsp__init_buffer(YY_CURRENT_BUFFER,input_file ,yyscanner);
-	tri_jsp__load_buffer_state(yyscanner );
-}
-
-/** Switch to a different input buffer.
- * @param new_buffer The new input buffer.
- * @param yyscanner The scanner object.
- */
-    void tri_jsp__switch_to_buffer  (YY_BUFFER_STATE  new_buffer , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-
-	/* TODO. We should be able to replace this entire function body
-	 * with
-	 *		tri_jsp_pop_buffer_state();
-	 *		tri_jsp_push_buffer_state(new_buffer);
-     */
-	tri_jsp_ensure_buffer_stack (yyscanner);
-	if ( YY_CURRENT_BUFFER == new_buffer )
-		return;
-
-	if ( YY_CURRENT_BUFFER )
-		{
-		/* Flush out information for old buffer. */
-		*yyg->yy_c_buf_p = yyg->yy_hold_char;
-		YY_CURRENT_BUFFER_LVALUE->yy_buf_pos = yyg->yy_c_buf_p;
-		YY_CURRENT_BUFFER_LVALUE->yy_n_chars = yyg->yy_n_chars;
-		}
-
-	YY_CURRENT_BUFFER_LVALUE = new_buffer;
-	tri_jsp__load_buffer_state(yyscanner );
-
-	/* We don't actually know whether we did this switch during
-	 * EOF (tri_jsp_wrap()) processing, but the only time this flag
-	 * is looked at is after tri_jsp_wrap() is called, so it's safe
-	 * to go ahead and always set it.
-	 */
-	yyg->yy_did_buffer_switch_on_eof = 1;
-}
-
-static void tri_jsp__load_buffer_state  (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-	yyg->yy_n_chars = YY_CURRENT_BUFFER_LVALUE->yy_n_chars;
-	yyg->yytext_ptr = yyg->yy_c_buf_p = YY_CURRENT_BUFFER_LVALUE->yy_buf_pos;
-	yyin = YY_CURRENT_BUFFER_LVALUE->yy_input_file;
-	yyg->yy_hold_char = *yyg->yy_c_buf_p;
-}
-
-/** Allocate and initialize an input buffer state.
- * @param file A readable stream.
- * @param size The character buffer size in bytes. When in doubt, use @c YY_BUF_SIZE.
- * @param yyscanner The scanner object.
- * @return the allocated buffer state.
- */
-    YY_BUFFER_STATE tri_jsp__create_buffer  (FILE * file, int  size , yyscan_t yyscanner)
-{
-	YY_BUFFER_STATE b;
-    
-	b = (YY_BUFFER_STATE) tri_jsp_alloc(sizeof( struct yy_buffer_state ) ,yyscanner );
-	if ( ! b )
-		YY_FATAL_ERROR( "out of dynamic memory in tri_jsp__create_buffer()" );
-
-	b->yy_buf_size = size;
-
-	/* yy_ch_buf has to be 2 characters longer than the size given because
-	 * we need to put in 2 end-of-buffer characters.
-	 */
-	b->yy_ch_buf = (char *) tri_jsp_alloc(b->yy_buf_size + 2 ,yyscanner );
-	if ( ! b->yy_ch_buf )
-		YY_FATAL_ERROR( "out of dynamic memory in tri_jsp__create_buffer()" );
-
-	b->yy_is_our_buffer = 1;
-
-	tri_jsp__init_buffer(b,file ,yyscanner);
-
-	return b;
-}
-
-/** Destroy the buffer.
- * @param b a buffer created with tri_jsp__create_buffer()
- * @param yyscanner The scanner object.
- */
-    void tri_jsp__delete_buffer (YY_BUFFER_STATE  b , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-
-	if ( ! b )
-		return;
-
-	if ( b == YY_CURRENT_BUFFER ) /* Not sure if we should pop here. */
-		YY_CURRENT_BUFFER_LVALUE = (YY_BUFFER_STATE) 0;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scans the rest of a string, starting after the opening quote
+///
+/// returns the position of the closing quote or nullptr if the string is not
+/// terminated. ascii is set to false if the string contains escape sequences
+/// or non-ASCII characters
+////////////////////////////////////////////////////////////////////////////////
 
-	if ( b->yy_is_our_buffer )
-		tri_jsp_free((void *) b->yy_ch_buf ,yyscanner );
+static char const* ScanString (char const* p,
+                               char const* end,
+                               bool& ascii) {
+#ifdef TRI_JSON_PARSER_SSE2
+  __m128i const quote     = _mm_set1_epi8('"');
+  __m128i const backslash = _mm_set1_epi8('\\');
+#endif
 
-	tri_jsp_free((void *) b ,yyscanner );
-}
+  ascii = true;
 
-/* Initializes or reinitializes a buffer.
- * This function is sometimes called more than once on the same buffer,
- * such as during a tri_jsp_restart() or at EOF.
- */
-    static void tri_jsp__init_buffer  (YY_BUFFER_STATE  b, FILE * file , yyscan_t yyscanner)
+  while (true) {
+#ifdef TRI_JSON_PARSER_SSE2
+    // skip 16 bytes at a time until a quote, a backslash or, as long as the
+    // string is still pure ASCII, a byte with the high bit set is found
+    while (p + 16 <= end) {
+      __m128i const data = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+      __m128i special = _mm_or_si128(_mm_cmpeq_epi8(data, quote), _mm_cmpeq_epi8(data, backslash));
 
-{
-	int oerrno = errno;
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
+      if (ascii) {
+        special = _mm_or_si128(special, data);
+      }
 
-	tri_jsp__flush_buffer(b ,yyscanner);
+      int const mask = _mm_movemask_epi8(special);
 
-	b->yy_input_file = file;
-	b->yy_fill_buffer = 1;
+      if (mask != 0) {
+        p += LowestBit(mask);
+        break;
+      }
 
-    /* If b is the current buffer, then tri_jsp__init_buffer was _probably_
-     * called from tri_jsp_restart() or through yy_get_next_buffer.
-     * In that case, we don't want to reset the lineno or column.
-     */
-    if (b != YY_CURRENT_BUFFER){
-        b->yy_bs_lineno = 1;
-        b->yy_bs_column = 0;
+      p += 16;
     }
-
-        b->yy_is_interactive = file ? (isatty( fileno(file) ) > 0) : 0;
-    
-	errno = oerrno;
-}
-
-/** Discard all buffered characters. On the next scan, YY_INPUT will be called.
- * @param b the buffer state to be flushed, usually @c YY_CURRENT_BUFFER.
- * @param yyscanner The scanner object.
- */
-    void tri_jsp__flush_buffer (YY_BUFFER_STATE  b , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-	if ( ! b )
-		return;
-
-	b->yy_n_chars = 0;
-
-	/* We always need two end-of-buffer characters.  The first causes
-	 * a transition to the end-of-buffer state.  The second causes
-	 * a jam in that state.
-	 */
-	b->yy_ch_buf[0] = YY_END_OF_BUFFER_CHAR;
-	b->yy_ch_buf[1] = YY_END_OF_BUFFER_CHAR;
-
-	b->yy_buf_pos = &b->yy_ch_buf[0];
-
-	b->yy_at_bol = 1;
-	b->yy_buffer_status = YY_BUFFER_NEW;
-
-	if ( b == YY_CURRENT_BUFFER )
-		tri_jsp__load_buffer_state(yyscanner );
-}
-
-/** Pushes the new state onto the stack. The new state becomes
- *  the current state. This function will allocate the stack
- *  if necessary.
- *  @param new_buffer The new state.
- *  @param yyscanner The scanner object.
- */
-void tri_jsp_push_buffer_state (YY_BUFFER_STATE new_buffer , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-	if (new_buffer == NULL)
-		return;
-
-	tri_jsp_ensure_buffer_stack(yyscanner);
-
-	/* This block is copied from tri_jsp__switch_to_buffer. */
-	if ( YY_CURRENT_BUFFER )
-		{
-		/* Flush out information for old buffer. */
-		*yyg->yy_c_buf_p = yyg->yy_hold_char;
-		YY_CURRENT_BUFFER_LVALUE->yy_buf_pos = yyg->yy_c_buf_p;
-		YY_CURRENT_BUFFER_LVALUE->yy_n_chars = yyg->yy_n_chars;
-		}
-
-	/* Only push if top exists. Otherwise, replace top. */
-	if (YY_CURRENT_BUFFER)
-		yyg->yy_buffer_stack_top++;
-	YY_CURRENT_BUFFER_LVALUE = new_buffer;
-
-	/* copied from tri_jsp__switch_to_buffer. */
-	tri_jsp__load_buffer_state(yyscanner );
-	yyg->yy_did_buffer_switch_on_eof = 1;
-}
-
-/** Removes and deletes the top of the stack, if present.
- *  The next element becomes the new top.
- *  @param yyscanner The scanner object.
- */
-void tri_jsp_pop_buffer_state (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-	if (!YY_CURRENT_BUFFER)
-		return;
-
-	tri_jsp__delete_buffer(YY_CURRENT_BUFFER ,yyscanner);
-	YY_CURRENT_BUFFER_LVALUE = NULL;
-	if (yyg->yy_buffer_stack_top > 0)
-		--yyg->yy_buffer_stack_top;
-
-	if (YY_CURRENT_BUFFER) {
-		tri_jsp__load_buffer_state(yyscanner );
-		yyg->yy_did_buffer_switch_on_eof = 1;
-	}
-}
-
-/* Allocates the stack if it does not exist.
- *  Guarantees space for at least one push.
- */
-static void tri_jsp_ensure_buffer_stack (yyscan_t yyscanner)
-{
-	yy_size_t num_to_alloc;
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-
-	if (!yyg->yy_buffer_stack) {
-
-		/* First allocation is just for 2 elements, since we don't know if this
-		 * scanner will even need a stack. We use 2 instead of 1 to avoid an
-		 * immediate realloc on the next call.
-         */
-		num_to_alloc = 1;
-		yyg->yy_buffer_stack = (struct yy_buffer_state**)tri_jsp_alloc
-								(num_to_alloc * sizeof(struct yy_buffer_state*)
-								, yyscanner);
-		if ( ! yyg->yy_buffer_stack )
-			YY_FATAL_ERROR( "out of dynamic memory in tri_jsp_ensure_buffer_stack()" );
-								  
-		memset(yyg->yy_buffer_stack, 0, num_to_alloc * sizeof(struct yy_buffer_state*));
-				
-		yyg->yy_buffer_stack_max = num_to_alloc;
-		yyg->yy_buffer_stack_top = 0;
-		return;
-	}
-
-	if (yyg->yy_buffer_stack_top >= (yyg->yy_buffer_stack_max) - 1){
-
-		/* Increase the buffer to prepare for a possible push. */
-		int grow_size = 8 /* arbitrary grow size */;
-
-		num_to_alloc = yyg->yy_buffer_stack_max + grow_size;
-		yyg->yy_buffer_stack = (struct yy_buffer_state**)tri_jsp_realloc
-								(yyg->yy_buffer_stack,
-								num_to_alloc * sizeof(struct yy_buffer_state*)
-								, yyscanner);
-		if ( ! yyg->yy_buffer_stack )
-			YY_FATAL_ERROR( "out of dynamic memory in tri_jsp_ensure_buffer_stack()" );
-
-		/* zero only the new slots.*/
-		memset(yyg->yy_buffer_stack + yyg->yy_buffer_stack_max, 0, grow_size * sizeof(struct yy_buffer_state*));
-		yyg->yy_buffer_stack_max = num_to_alloc;
-	}
-}
-
-/** Setup the input buffer state to scan directly from a user-specified character buffer.
- * @param base the character buffer
- * @param size the size in bytes of the character buffer
- * @param yyscanner The scanner object.
- * @return the newly allocated buffer state object. 
- */
-YY_BUFFER_STATE tri_jsp__scan_buffer  (char * base, yy_size_t  size , yyscan_t yyscanner)
-{
-	YY_BUFFER_STATE b;
-    
-	if ( size < 2 ||
-	     base[size-2] != YY_END_OF_BUFFER_CHAR ||
-	     base[size-1] != YY_END_OF_BUFFER_CHAR )
-		/* They forgot to leave room for the EOB's. */
-		return 0;
-
-	b = (YY_BUFFER_STATE) tri_jsp_alloc(sizeof( struct yy_buffer_state ) ,yyscanner );
-	if ( ! b )
-		YY_FATAL_ERROR( "out of dynamic memory in tri_jsp__scan_buffer()" );
-
-	b->yy_buf_size = size - 2;	/* "- 2" to take care of EOB's */
-	b->yy_buf_pos = b->yy_ch_buf = base;
-	b->yy_is_our_buffer = 0;
-	b->yy_input_file = 0;
-	b->yy_n_chars = b->yy_buf_size;
-	b->yy_is_interactive = 0;
-	b->yy_at_bol = 1;
-	b->yy_fill_buffer = 0;
-	b->yy_buffer_status = YY_BUFFER_NEW;
-
-	tri_jsp__switch_to_buffer(b ,yyscanner );
-
-	return b;
-}
-
-/** Setup the input buffer state to scan a string. The next call to tri_jsp_lex() will
- * scan from a @e copy of @a str.
- * @param yystr a NUL-terminated string to scan
- * @param yyscanner The scanner object.
- * @return the newly allocated buffer state object.
- * @note If you want to scan bytes that may contain NUL values, then use
- *       tri_jsp__scan_bytes() instead.
- */
-YY_BUFFER_STATE tri_jsp__scan_string (yyconst char * yystr , yyscan_t yyscanner)
-{
-    
-	return tri_jsp__scan_bytes(yystr,strlen(yystr) ,yyscanner);
-}
-
-/** Setup the input buffer state to scan the given bytes. The next call to tri_jsp_lex() will
- * scan from a @e copy of @a bytes.
- * @param yybytes the byte buffer to scan
- * @param _yybytes_len the number of bytes in the buffer pointed to by @a bytes.
- * @param yyscanner The scanner object.
- * @return the newly allocated buffer state object.
- */
-YY_BUFFER_STATE tri_jsp__scan_bytes  (yyconst char * yybytes, yy_size_t  _yybytes_len , yyscan_t yyscanner)
-{
-	YY_BUFFER_STATE b;
-	char *buf;
-	yy_size_t n;
-	yy_size_t i;
-    
-	/* Get memory for full buffer, including space for trailing EOB's. */
-	n = _yybytes_len + 2;
-	buf = (char *) tri_jsp_alloc(n ,yyscanner );
-	if ( ! buf )
-		YY_FATAL_ERROR( "out of dynamic memory in tri_jsp__scan_bytes()" );
-
-	for ( i = 0; i < _yybytes_len; ++i )
-		buf[i] = yybytes[i];
-
-	buf[_yybytes_len] = buf[_yybytes_len+1] = YY_END_OF_BUFFER_CHAR;
-
-	b = tri_jsp__scan_buffer(buf,n ,yyscanner);
-	if ( ! b )
-		YY_FATAL_ERROR( "bad buffer in tri_jsp__scan_bytes()" );
-
-	/* It's okay to grow etc. this buffer, and we should throw it
-	 * away when we're done.
-	 */
-	b->yy_is_our_buffer = 1;
-
-	return b;
-}
-
-#ifndef YY_EXIT_FAILURE
-#define YY_EXIT_FAILURE 2
 #endif
 
-static void yy_fatal_error (yyconst char* msg , yyscan_t yyscanner)
-{
-    	(void) fprintf( stderr, "%s\n", msg );
-	exit( YY_EXIT_FAILURE );
-}
-
-/* Redefine yyless() so it works in section 3 code. */
-
-#undef yyless
-#define yyless(n) \
-	do \
-		{ \
-		/* Undo effects of setting up yytext. */ \
-        int yyless_macro_arg = (n); \
-        YY_LESS_LINENO(yyless_macro_arg);\
-		yytext[yyleng] = yyg->yy_hold_char; \
-		yyg->yy_c_buf_p = yytext + yyless_macro_arg; \
-		yyg->yy_hold_char = *yyg->yy_c_buf_p; \
-		*yyg->yy_c_buf_p = '\0'; \
-		yyleng = yyless_macro_arg; \
-		} \
-	while ( 0 )
-
-/* Accessor  methods (get/set functions) to struct members. */
-
-/** Get the user-defined data for this scanner.
- * @param yyscanner The scanner object.
- */
-YY_EXTRA_TYPE tri_jsp_get_extra  (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    return yyextra;
-}
-
-/** Get the current line number.
- * @param yyscanner The scanner object.
- */
-int tri_jsp_get_lineno  (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    
-        if (! YY_CURRENT_BUFFER)
-            return 0;
-    
-    return yylineno;
-}
-
-/** Get the current column number.
- * @param yyscanner The scanner object.
- */
-int tri_jsp_get_column  (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    
-        if (! YY_CURRENT_BUFFER)
-            return 0;
-    
-    return yycolumn;
-}
-
-/** Get the input stream.
- * @param yyscanner The scanner object.
- */
-FILE *tri_jsp_get_in  (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    return yyin;
-}
+    if (p >= end) {
+      return nullptr;
+    }
 
-/** Get the output stream.
- * @param yyscanner The scanner object.
- */
-FILE *tri_jsp_get_out  (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    return yyout;
-}
+    unsigned char const c = static_cast<unsigned char>(*p);
 
-/** Get the length of the current token.
- * @param yyscanner The scanner object.
- */
-yy_size_t tri_jsp_get_leng  (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    return yyleng;
-}
+    if (c == '"') {
+      return p;
+    }
 
-/** Get the current token.
- * @param yyscanner The scanner object.
- */
+    if (c == '\\') {
+      ascii = false;
 
-char *tri_jsp_get_text  (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    return yytext;
-}
+      // a backslash escapes any character but a newline
+      if (p + 1 >= end || p[1] == '\n') {
+        return nullptr;
+      }
 
-/** Set the user-defined data. This data is never touched by the scanner.
- * @param user_defined The data to be associated with this scanner.
- * @param yyscanner The scanner object.
- */
-void tri_jsp_set_extra (YY_EXTRA_TYPE  user_defined , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    yyextra = user_defined ;
-}
+      p += 2;
+    }
+    else {
+      if (c >= 0x80) {
+        ascii = false;
+      }
 
-/** Set the current line number.
- * @param line_number
- * @param yyscanner The scanner object.
- */
-void tri_jsp_set_lineno (int  line_number , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-
-        /* lineno is only valid if an input buffer exists. */
-        if (! YY_CURRENT_BUFFER )
-           YY_FATAL_ERROR( "tri_jsp_set_lineno called with no buffer" );
-    
-    yylineno = line_number;
+      ++p;
+    }
+  }
 }
 
-/** Set the current column.
- * @param line_number
- * @param yyscanner The scanner object.
- */
-void tri_jsp_set_column (int  column_no , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-
-        /* column is only valid if an input buffer exists. */
-        if (! YY_CURRENT_BUFFER )
-           YY_FATAL_ERROR( "tri_jsp_set_column called with no buffer" );
-    
-    yycolumn = column_no;
-}
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scans the digits of a number
+////////////////////////////////////////////////////////////////////////////////
 
-/** Set the input stream. This does not discard the current
- * input buffer.
- * @param in_str A readable stream.
- * @param yyscanner The scanner object.
- * @see tri_jsp__switch_to_buffer
- */
-void tri_jsp_set_in (FILE *  in_str , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    yyin = in_str ;
-}
+static inline char const* ScanDigits (char const* p,
+                                      char const* end) {
+  while (p < end && *p >= '0' && *p <= '9') {
+    ++p;
+  }
 
-void tri_jsp_set_out (FILE *  out_str , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    yyout = out_str ;
+  return p;
 }
 
-int tri_jsp_get_debug  (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    return yy_flex_debug;
-}
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scans a number
+///
+/// returns the end of the number or nullptr if there is no number at p
+////////////////////////////////////////////////////////////////////////////////
 
-void tri_jsp_set_debug (int  bdebug , yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    yy_flex_debug = bdebug ;
-}
+static char const* ScanNumber (char const* p,
+                               char const* end) {
+  if (*p == '-' || *p == '+') {
+    ++p;
+  }
 
-/* Accessor methods for yylval and yylloc */
+  if (p >= end || *p < '0' || *p > '9') {
+    return nullptr;
+  }
 
-/* User-visible API */
+  // a leading zero is not followed by other digits
+  if (*p == '0') {
+    ++p;
+  }
+  else {
+    p = ScanDigits(p, end);
+  }
 
-/* tri_jsp_lex_init is special because it creates the scanner itself, so it is
- * the ONLY reentrant function that doesn't take the scanner as the last argument.
- * That's why we explicitly handle the declaration, instead of using our macros.
- */
+  // fraction, only if followed by at least one digit
+  if (p + 1 < end && *p == '.' && p[1] >= '0' && p[1] <= '9') {
+    p = ScanDigits(p + 1, end);
+  }
 
-int tri_jsp_lex_init(yyscan_t* ptr_yy_globals)
+  // exponent, only if followed by at least one digit
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    char const* q = p + 1;
 
-{
-    if (ptr_yy_globals == NULL){
-        errno = EINVAL;
-        return 1;
+    if (q < end && (*q == '-' || *q == '+')) {
+      ++q;
     }
 
-    *ptr_yy_globals = (yyscan_t) tri_jsp_alloc ( sizeof( struct yyguts_t ), NULL );
-
-    if (*ptr_yy_globals == NULL){
-        errno = ENOMEM;
-        return 1;
+    if (q < end && *q >= '0' && *q <= '9') {
+      p = ScanDigits(q, end);
     }
+  }
 
-    /* By setting to 0xAA, we expose bugs in yy_init_globals. Leave at 0x00 for releases. */
-    memset(*ptr_yy_globals,0x00,sizeof(struct yyguts_t));
-
-    return yy_init_globals ( *ptr_yy_globals );
+  return p;
 }
 
-/* tri_jsp_lex_init_extra has the same functionality as tri_jsp_lex_init, but follows the
- * convention of taking the scanner as the last argument. Note however, that
- * this is a *pointer* to a scanner, as it will be allocated by this call (and
- * is the reason, too, why this function also must handle its own declaration).
- * The user defined value in the first argument will be available to tri_jsp_alloc in
- * the yyextra field.
- */
-
-int tri_jsp_lex_init_extra(YY_EXTRA_TYPE yy_user_defined,yyscan_t* ptr_yy_globals )
-
-{
-    struct yyguts_t dummy_yyguts;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks for a case-insensitive keyword
+////////////////////////////////////////////////////////////////////////////////
 
-    tri_jsp_set_extra (yy_user_defined, &dummy_yyguts);
+static inline bool MatchKeyword (char const* p,
+                                 char const* end,
+                                 char const* keyword,
+                                 size_t length) {
+  if ((size_t) (end - p) < length) {
+    return false;
+  }
 
-    if (ptr_yy_globals == NULL){
-        errno = EINVAL;
-        return 1;
-    }
-	
-    *ptr_yy_globals = (yyscan_t) tri_jsp_alloc ( sizeof( struct yyguts_t ), &dummy_yyguts );
-	
-    if (*ptr_yy_globals == NULL){
-        errno = ENOMEM;
-        return 1;
+  for (size_t i = 0; i < length; ++i) {
+    if ((p[i] | 0x20) != keyword[i]) {
+      return false;
     }
-    
-    /* By setting to 0xAA, we expose bugs in
-    yy_init_globals. Leave at 0x00 for releases. */
-    memset(*ptr_yy_globals,0x00,sizeof(struct yyguts_t));
-    
-    tri_jsp_set_extra (yy_user_defined, *ptr_yy_globals);
-    
-    return yy_init_globals ( *ptr_yy_globals );
-}
-
-static int yy_init_globals (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-    /* Initialization is the same as for the non-reentrant scanner.
-     * This function is called from tri_jsp_lex_destroy(), so don't allocate here.
-     */
-
-    yyg->yy_buffer_stack = 0;
-    yyg->yy_buffer_stack_top = 0;
-    yyg->yy_buffer_stack_max = 0;
-    yyg->yy_c_buf_p = (char *) 0;
-    yyg->yy_init = 0;
-    yyg->yy_start = 0;
-
-    yyg->yy_start_stack_ptr = 0;
-    yyg->yy_start_stack_depth = 0;
-    yyg->yy_start_stack =  NULL;
-
-/* Defined in main.c */
-#ifdef YY_STDINIT
-    yyin = stdin;
-    yyout = stdout;
-#else
-    yyin = (FILE *) 0;
-    yyout = (FILE *) 0;
-#endif
-
-    /* For future reference: Set errno on error, since we are called by
-     * tri_jsp_lex_init()
-     */
-    return 0;
-}
-
-/* tri_jsp_lex_destroy is for both reentrant and non-reentrant scanners. */
-int tri_jsp_lex_destroy  (yyscan_t yyscanner)
-{
-    struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
-
-    /* Pop the buffer stack, destroying each element. */
-	while(YY_CURRENT_BUFFER){
-		tri_jsp__delete_buffer(YY_CURRENT_BUFFER ,yyscanner );
-		YY_CURRENT_BUFFER_LVALUE = NULL;
-		tri_jsp_pop_buffer_state(yyscanner);
-	}
-
-	/* Destroy the stack itself. */
-	tri_jsp_free(yyg->yy_buffer_stack ,yyscanner);
-	yyg->yy_buffer_stack = NULL;
-
-    /* Destroy the start condition stack. */
-        tri_jsp_free(yyg->yy_start_stack ,yyscanner );
-        yyg->yy_start_stack = NULL;
-
-    /* Reset the globals. This is important in a non-reentrant scanner so the next time
-     * tri_jsp_lex() is called, initialization will occur. */
-    yy_init_globals( yyscanner);
-
-    /* Destroy the main struct (reentrant only). */
-    tri_jsp_free ( yyscanner , yyscanner );
-    yyscanner = NULL;
-    return 0;
-}
-
-/*
- * Internal utility routines.
- */
-
-#ifndef yytext_ptr
-static void yy_flex_strncpy (char* s1, yyconst char * s2, int n , yyscan_t yyscanner)
-{
-	int i;
-	for ( i = 0; i < n; ++i )
-		s1[i] = s2[i];
-}
-#endif
-
-#ifdef YY_NEED_STRLEN
-static int yy_flex_strlen (yyconst char * s , yyscan_t yyscanner)
-{
-	int n;
-	for ( n = 0; s[n]; ++n )
-		;
-
-	return n;
-}
-#endif
-
-void *tri_jsp_alloc (yy_size_t  size , yyscan_t yyscanner)
-{
-	return (void *) malloc( size );
-}
-
-void *tri_jsp_realloc  (void * ptr, yy_size_t  size , yyscan_t yyscanner)
-{
-	/* The cast to (char *) in the following accommodates both
-	 * implementations that use char* generic pointers, and those
-	 * that use void* generic pointers.  It works with the latter
-	 * because both ANSI C and C++ allow castless assignment from
-	 * any pointer type to void*, and deal with argument conversions
-	 * as though doing an assignment.
-	 */
-	return (void *) realloc( (char *) ptr, size );
-}
-
-void tri_jsp_free (void * ptr , yyscan_t yyscanner)
-{
-	free( (char *) ptr );	/* see tri_jsp_realloc() for (char *) cast */
-}
-
-#define YYTABLES_NAME "yytables"
-
-// -----------------------------------------------------------------------------
-// --SECTION--                                              forward declarations
-// -----------------------------------------------------------------------------
-
-static bool ParseObject (yyscan_t, TRI_json_t*);
-static bool ParseValue (yyscan_t, TRI_json_t*, int);
-
-// -----------------------------------------------------------------------------
-// --SECTION--                                                 private functions
-// -----------------------------------------------------------------------------
-
-////////////////////////////////////////////////////////////////////////////////
-/// @brief do not use, only here to silence compiler
-////////////////////////////////////////////////////////////////////////////////
+  }
 
-void TRI_JsonError (const char* msg) {
-  YY_FATAL_ERROR(msg);
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief parses an array
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool ParseArray (yyscan_t scanner, TRI_json_t* result) {
-  struct yyguts_t * yyg = (struct yyguts_t*) scanner;
+static bool ParseArray (TRI_json_scanner_t* scanner, TRI_json_t* result) {
+  TRI_InitArrayJson(scanner->_memoryZone, result);
 
-  TRI_InitArrayJson(yyextra._memoryZone, result);
-
-  int c = tri_jsp_lex(scanner);
+  int c = TRI_NextTokenJsonScanner(scanner);
   bool comma = false;
 
-  while (c != END_OF_FILE) {
-    if (c == CLOSE_BRACKET) {
+  while (c != TRI_JSON_TOKEN_END_OF_FILE) {
+    if (c == TRI_JSON_TOKEN_CLOSE_BRACKET) {
       return true;
     }
 
     if (comma) {
-      if (c != COMMA) {
-        yyextra._message = "expecting comma";
+      if (c != TRI_JSON_TOKEN_COMMA) {
+        scanner->_message = "expecting comma";
         return false;
       }
 
-      c = tri_jsp_lex(scanner);
+      c = TRI_NextTokenJsonScanner(scanner);
     }
     else {
       comma = true;
     }
 
-    {
-      // optimization: get the address of the next element in the array
-      // so we can create the upcoming element in place
-      TRI_json_t* next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
+    // optimization: get the address of the next element in the array
+    // so we can create the upcoming element in place
+    TRI_json_t* next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
 
-      if (next == nullptr) {
-        yyextra._message = "out-of-memory";
-        return false;
-      }
-      
-      // be paranoid and initialize the memory  
-      TRI_InitNullJson(next);
+    if (next == nullptr) {
+      scanner->_message = "out-of-memory";
+      return false;
+    }
 
-      if (! ParseValue(scanner, next, c)) {
-        // be paranoid 
+    // be paranoid and initialize the memory
+    TRI_InitNullJson(next);
 
-        return false;
-      }
+    if (! ParseValue(scanner, next, c)) {
+      return false;
     }
 
-    c = tri_jsp_lex(scanner);
+    c = TRI_NextTokenJsonScanner(scanner);
   }
 
-  yyextra._message = "expecting a list element, got end-of-file";
+  scanner->_message = "expecting a list element, got end-of-file";
 
   return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief parse an object
+/// @brief parses an object
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool ParseObject (yyscan_t scanner, TRI_json_t* result) {
-  struct yyguts_t * yyg = (struct yyguts_t*) scanner;
-
+static bool ParseObject (TRI_json_scanner_t* scanner, TRI_json_t* result) {
   bool comma = false;
-  TRI_InitObjectJson(yyextra._memoryZone, result);
+  TRI_InitObjectJson(scanner->_memoryZone, result);
 
-  int c = tri_jsp_lex(scanner);
+  int c = TRI_NextTokenJsonScanner(scanner);
 
-  while (c != END_OF_FILE) {
-    if (c == CLOSE_BRACE) {
+  while (c != TRI_JSON_TOKEN_END_OF_FILE) {
+    if (c == TRI_JSON_TOKEN_CLOSE_BRACE) {
       return true;
     }
 
     if (comma) {
-      if (c != COMMA) {
-        yyextra._message = "expecting comma";
+      if (c != TRI_JSON_TOKEN_COMMA) {
+        scanner->_message = "expecting comma";
         return false;
       }
 
-      c = tri_jsp_lex(scanner);
+      c = TRI_NextTokenJsonScanner(scanner);
     }
     else {
       comma = true;
     }
 
-    char* name;
-    size_t nameLen;
-
     // attribute name
-    if (c == STRING_CONSTANT) {
-      // "complex" attribute name
-      size_t outLength;
-      nameLen = yyleng - 2;
-
-      // do proper unescaping
-      name = TRI_UnescapeUtf8StringZ(yyextra._memoryZone, yytext + 1, nameLen, &outLength);
-      nameLen = outLength;
-    }
-    else if (c == STRING_CONSTANT_ASCII) {
-      // ASCII-only attribute name
-      nameLen = yyleng - 2;
-
-      // no unescaping necessary. just copy it
-      name = TRI_DuplicateString2Z(yyextra._memoryZone, yytext + 1, nameLen);
-    }
-    else {
+    if (c != TRI_JSON_TOKEN_STRING && c != TRI_JSON_TOKEN_STRING_ASCII) {
       // some other token found => invalid
-      yyextra._message = "expecting attribute name";
+      scanner->_message = "expecting attribute name";
       return false;
     }
-      
+
+    size_t nameLen;
+    char* name = TRI_StringTokenJsonScanner(scanner, c, &nameLen);
+
     if (name == nullptr) {
-      yyextra._message = "out-of-memory";
+      scanner->_message = "out-of-memory";
       return false;
     }
 
     // followed by a colon
-    c = tri_jsp_lex(scanner);
+    c = TRI_NextTokenJsonScanner(scanner);
 
-    if (c != COLON) {
-      TRI_FreeString(yyextra._memoryZone, name);
-      yyextra._message = "expecting colon";
+    if (c != TRI_JSON_TOKEN_COLON) {
+      TRI_FreeString(scanner->_memoryZone, name);
+      scanner->_message = "expecting colon";
       return false;
     }
 
     // followed by an object
-    c = tri_jsp_lex(scanner);
+    c = TRI_NextTokenJsonScanner(scanner);
 
-    {
-      // optimization: we allocate room for two elements at once
-      int res = TRI_ReserveVector(&result->_value._objects, 2);
+    // optimization: we allocate room for two elements at once
+    int res = TRI_ReserveVector(&result->_value._objects, 2);
 
-      if (res != TRI_ERROR_NO_ERROR) {
-        yyextra._message = "out-of-memory";
-        return false;
-      } 
- 
-      // get the address of the next element so we can create the attribute name in place
-      TRI_json_t* next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
-      // we made sure with the reserve call that we haven't run out of memory
-      TRI_ASSERT_EXPENSIVE(next != nullptr);
-
-      // store attribute name
-      TRI_InitStringJson(next, name, nameLen);
-
-      // now process the value
-      next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
-      // we made sure with the reserve call that we haven't run out of memory
-      TRI_ASSERT_EXPENSIVE(next != nullptr);
-      
-      // be paranoid and initialize the memory  
-      TRI_InitNullJson(next);
-
-      if (! ParseValue(scanner, next, c)) {
-        // be paranoid
-        return false;
-      }
+    if (res != TRI_ERROR_NO_ERROR) {
+      TRI_FreeString(scanner->_memoryZone, name);
+      scanner->_message = "out-of-memory";
+      return false;
     }
 
-    c = tri_jsp_lex(scanner);
+    // get the address of the next element so we can create the attribute name in place
+    TRI_json_t* next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
+    // we made sure with the reserve call that we haven't run out of memory
+    TRI_ASSERT_EXPENSIVE(next != nullptr);
+
+    // store attribute name
+    TRI_InitStringJson(next, name, nameLen);
+
+    // now process the value
+    next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
+    // we made sure with the reserve call that we haven't run out of memory
+    TRI_ASSERT_EXPENSIVE(next != nullptr);
+
+    // be paranoid and initialize the memory
+    TRI_InitNullJson(next);
+
+    if (! ParseValue(scanner, next, c)) {
+      return false;
+    }
+
+    c = TRI_NextTokenJsonScanner(scanner);
   }
 
-  yyextra._message = "expecting a object attribute name or element, got end-of-file";
+  scanner->_message = "expecting a object attribute name or element, got end-of-file";
 
   return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief parse an object
+/// @brief parses a value
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool ParseValue (yyscan_t scanner, TRI_json_t* result, int c) {
-  struct yyguts_t * yyg = (struct yyguts_t*) scanner;
-
+static bool ParseValue (TRI_json_scanner_t* scanner, TRI_json_t* result, int c) {
   switch (c) {
-    case FALSE_CONSTANT:
+    case TRI_JSON_TOKEN_FALSE:
       TRI_InitBooleanJson(result, false);
 
       return true;
 
-    case TRUE_CONSTANT:
+    case TRI_JSON_TOKEN_TRUE:
       TRI_InitBooleanJson(result, true);
 
       return true;
 
-    case NULL_CONSTANT:
+    case TRI_JSON_TOKEN_NULL:
       TRI_InitNullJson(result);
 
       return true;
 
-    case NUMBER_CONSTANT: {
-      char* ep;
+    case TRI_JSON_TOKEN_NUMBER: {
       double d;
 
-      if ((size_t) yyleng >= 512) {
-        yyextra._message = "number too big";
-        return false;
-      }
-
-      // need to reset errno because return value of 0 is not distinguishable from an error on Linux
-      errno = 0;
-
-      // yytext is null-terminated. can use it directly without copying it into a temporary buffer
-      d = strtod(yytext, &ep);
-
-      if (d == HUGE_VAL && errno == ERANGE) {
-        yyextra._message = "number too big";
-        return false;
-      }
-
-      if (d == 0 && errno == ERANGE) {
-        yyextra._message = "number too small";
-        return false;
-      }
-
-      if (ep != yytext + yyleng) {
-        yyextra._message = "cannot parse number";
+      if (! TRI_NumberTokenJsonScanner(scanner, &d)) {
         return false;
       }
 
@@ -2321,225 +419,382 @@ static bool ParseValue (yyscan_t scanner, TRI_json_t* result, int c) {
       return true;
     }
 
-    case STRING_CONSTANT: {
-      if (yyleng <= 2) {
+    case TRI_JSON_TOKEN_STRING:
+    case TRI_JSON_TOKEN_STRING_ASCII: {
+      if (scanner->_tokenLength <= 2) {
         // string is empty
         char const* ptr = EmptyString; // we'll create a reference to this compiled-in string
         TRI_InitStringReferenceJson(result, ptr, 0);
       }
       else {
-        // string is not empty, process it
         size_t outLength;
-        char* ptr = TRI_UnescapeUtf8StringZ(yyextra._memoryZone, yytext + 1, yyleng - 2, &outLength);
-        if (ptr == nullptr) {
-          yyextra._message = "out-of-memory";
-          return false;
-        }
-      
-       TRI_InitStringJson(result, ptr, outLength);
-      }
-      return true;
-    }
-    
-    case STRING_CONSTANT_ASCII: {
-      if (yyleng <= 2) {
-        // string is empty
-        char const* ptr = EmptyString; // we'll create a reference to this compiled-in string
-        TRI_InitStringReferenceJson(result, ptr, 0);
-       }
-      else {
-        char* ptr = TRI_DuplicateString2Z(yyextra._memoryZone, yytext + 1, yyleng - 2);
- 
+        char* ptr = TRI_StringTokenJsonScanner(scanner, c, &outLength);
+
         if (ptr == nullptr) {
-          yyextra._message = "out-of-memory";
+          scanner->_message = "out-of-memory";
           return false;
         }
- 
-        TRI_InitStringJson(result, ptr, yyleng - 2);
+
+        TRI_InitStringJson(result, ptr, outLength);
       }
       return true;
     }
 
-    case OPEN_BRACE:
+    case TRI_JSON_TOKEN_OPEN_BRACE:
       return ParseObject(scanner, result);
 
-    case OPEN_BRACKET:
+    case TRI_JSON_TOKEN_OPEN_BRACKET:
       return ParseArray(scanner, result);
-    
-    case CLOSE_BRACE:
-      yyextra._message = "expected object, got '}'";
-      return false;
-
-    case CLOSE_BRACKET:
-      yyextra._message = "expected object, got ']'";
-      return false;
-
-    case COMMA:
-      yyextra._message = "expected object, got ','";
-      return false;
-
-    case COLON:
-      yyextra._message = "expected object, got ':'";
-      return false;
-
-    case UNQUOTED_STRING:
-      yyextra._message = "expected object, got unquoted string";
-      return false;
-    
-    case END_OF_FILE:
-      yyextra._message = "expecting atom, got end-of-file";
-      return false;
   }
 
-  yyextra._message = "unknown atom";
+  TRI_UnexpectedTokenJsonScanner(scanner, c);
   return false;
 }
 
-// -----------------------------------------------------------------------------
-// --SECTION--                                                  public functions
-// -----------------------------------------------------------------------------
-
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief parses a json string
+/// @brief parses a json text of the given length
 ////////////////////////////////////////////////////////////////////////////////
 
-TRI_json_t* TRI_Json2String (TRI_memory_zone_t* zone, char const* text, char** error) {
-  TRI_json_t* object;
-  YY_BUFFER_STATE buf;
-  int c;
-  struct yyguts_t * yyg;
-  yyscan_t scanner;
-
-  object = static_cast<TRI_json_t*>
-                      (TRI_Allocate(zone, sizeof(TRI_json_t), false));
+static TRI_json_t* ParseText (TRI_memory_zone_t* zone,
+                              char const* text,
+                              size_t length,
+                              char** error) {
+  TRI_json_t* object = static_cast<TRI_json_t*>(TRI_Allocate(zone, sizeof(TRI_json_t), false));
 
   if (object == nullptr) {
     // out of memory
     return nullptr;
   }
-  
+
   // init as a JSON null object so the memory in object is initialised
   TRI_InitNullJson(object);
 
-  tri_jsp_lex_init(&scanner);
-  yyg = (struct yyguts_t*) scanner;
-
-  yyextra._memoryZone = zone;
+  TRI_json_scanner_t scanner;
+  TRI_InitJsonScanner(&scanner, zone, text, length);
 
-  buf = tri_jsp__scan_string((char yyconst*) text,scanner);
+  int c = TRI_NextTokenJsonScanner(&scanner);
 
-  c = tri_jsp_lex(scanner);
-  if (! ParseValue(scanner, object, c)) {
+  if (! ParseValue(&scanner, object, c)) {
     TRI_FreeJson(zone, object);
     object = nullptr;
-    LOG_DEBUG("failed to parse json object: '%s'", yyextra._message);
+    LOG_DEBUG("failed to parse json object: '%s'", scanner._message);
   }
   else {
-    c = tri_jsp_lex(scanner);
+    c = TRI_NextTokenJsonScanner(&scanner);
 
-    if (c != END_OF_FILE) {
+    if (c != TRI_JSON_TOKEN_END_OF_FILE) {
       TRI_FreeJson(zone, object);
       object = nullptr;
-      yyextra._message = "failed to parse json object: expecting EOF";
+      scanner._message = "failed to parse json object: expecting EOF";
 
       LOG_DEBUG("failed to parse json object: expecting EOF");
     }
   }
 
   if (error != nullptr) {
-    if (yyextra._message != nullptr) {
-      *error = TRI_DuplicateString(yyextra._message);
+    if (scanner._message != nullptr) {
+      *error = TRI_DuplicateString(scanner._message);
     }
     else {
       *error = nullptr;
     }
   }
 
-  tri_jsp__delete_buffer(buf,scanner);
-  tri_jsp_lex_destroy(scanner);
-
   return object;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief parses a json string
+/// @brief initialises a scanner for a json text of the given length
 ////////////////////////////////////////////////////////////////////////////////
 
-TRI_json_t* TRI_JsonString (TRI_memory_zone_t* zone, char const* text) {
-  return TRI_Json2String(zone, text, nullptr);
+void TRI_InitJsonScanner (TRI_json_scanner_t* scanner,
+                          TRI_memory_zone_t* zone,
+                          char const* text,
+                          size_t length) {
+  scanner->_ptr         = text;
+  scanner->_end         = text + length;
+  scanner->_token       = text;
+  scanner->_tokenLength = 0;
+  scanner->_memoryZone  = zone;
+  scanner->_message     = nullptr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief parses a json file
+/// @brief returns the next token
 ////////////////////////////////////////////////////////////////////////////////
 
-TRI_json_t* TRI_JsonFile (TRI_memory_zone_t* zone, char const* path, char** error) {
-  FILE* in;
-  TRI_json_t* value;
-  int c;
-  struct yyguts_t * yyg;
-  yyscan_t scanner;
-
-  value = static_cast<TRI_json_t*>(TRI_Allocate(zone, sizeof(TRI_json_t), false));
-  
-  if (value == nullptr) {
-    // out of memory
-    return nullptr;
+int TRI_NextTokenJsonScanner (TRI_json_scanner_t* scanner) {
+  char const* p = scanner->_ptr;
+  char const* end = scanner->_end;
+
+  // skip whitespace
+  while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+    ++p;
   }
 
-  in = fopen(path, "rb");
+  scanner->_token = p;
+  scanner->_tokenLength = 1;
 
-  if (in == nullptr) {
-    LOG_ERROR("cannot open file '%s': '%s'", path, TRI_LAST_ERROR_STR);
-    TRI_Free(zone, value);
+  if (p >= end) {
+    scanner->_ptr = p;
+    scanner->_tokenLength = 0;
+    return TRI_JSON_TOKEN_END_OF_FILE;
+  }
 
-    return nullptr;
+  int token;
+
+  switch (*p) {
+    case '{':
+      token = TRI_JSON_TOKEN_OPEN_BRACE;
+      break;
+
+    case '}':
+      token = TRI_JSON_TOKEN_CLOSE_BRACE;
+      break;
+
+    case '[':
+      token = TRI_JSON_TOKEN_OPEN_BRACKET;
+      break;
+
+    case ']':
+      token = TRI_JSON_TOKEN_CLOSE_BRACKET;
+      break;
+
+    case ',':
+      token = TRI_JSON_TOKEN_COMMA;
+      break;
+
+    case ':':
+      token = TRI_JSON_TOKEN_COLON;
+      break;
+
+    case '"': {
+      bool ascii;
+      char const* q = ScanString(p + 1, end, ascii);
+
+      if (q == nullptr) {
+        token = TRI_JSON_TOKEN_UNQUOTED_STRING;
+        break;
+      }
+
+      scanner->_tokenLength = (size_t) (q + 1 - p);
+      token = ascii ? TRI_JSON_TOKEN_STRING_ASCII : TRI_JSON_TOKEN_STRING;
+      break;
+    }
+
+    case 'f':
+    case 'F':
+      if (MatchKeyword(p, end, "false", 5)) {
+        scanner->_tokenLength = 5;
+        token = TRI_JSON_TOKEN_FALSE;
+      }
+      else {
+        token = TRI_JSON_TOKEN_UNQUOTED_STRING;
+      }
+      break;
+
+    case 'n':
+    case 'N':
+      if (MatchKeyword(p, end, "null", 4)) {
+        scanner->_tokenLength = 4;
+        token = TRI_JSON_TOKEN_NULL;
+      }
+      else {
+        token = TRI_JSON_TOKEN_UNQUOTED_STRING;
+      }
+      break;
+
+    case 't':
+    case 'T':
+      if (MatchKeyword(p, end, "true", 4)) {
+        scanner->_tokenLength = 4;
+        token = TRI_JSON_TOKEN_TRUE;
+      }
+      else {
+        token = TRI_JSON_TOKEN_UNQUOTED_STRING;
+      }
+      break;
+
+    case '-':
+    case '+':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9': {
+      char const* q = ScanNumber(p, end);
+
+      if (q == nullptr) {
+        token = TRI_JSON_TOKEN_UNQUOTED_STRING;
+      }
+      else {
+        scanner->_tokenLength = (size_t) (q - p);
+        token = TRI_JSON_TOKEN_NUMBER;
+      }
+      break;
+    }
+
+    default:
+      token = TRI_JSON_TOKEN_UNQUOTED_STRING;
   }
 
-  // init as a JSON null object so the memory in value is initialised
-  TRI_InitNullJson(value);
+  scanner->_ptr = p + scanner->_tokenLength;
 
-  tri_jsp_lex_init(&scanner);
-  yyg = (struct yyguts_t*) scanner;
+  return token;
+}
 
-  yyextra._memoryZone = zone;
-  yyin = in;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copies the contents of the current string token
+////////////////////////////////////////////////////////////////////////////////
+
+char* TRI_StringTokenJsonScanner (TRI_json_scanner_t* scanner,
+                                  int token,
+                                  size_t* length) {
+  char const* text = scanner->_token + 1;
+  size_t const textLength = scanner->_tokenLength - 2;
 
-  c = tri_jsp_lex(scanner);
-  if (! ParseValue(scanner, value, c)) {
-    TRI_FreeJson(zone, value);
-    value = nullptr;
-    LOG_DEBUG("failed to parse json value: '%s'", yyextra._message);
+  if (token == TRI_JSON_TOKEN_STRING_ASCII) {
+    // no unescaping necessary. just copy it
+    *length = textLength;
+    return TRI_DuplicateString2Z(scanner->_memoryZone, text, textLength);
   }
-  else {
-    c = tri_jsp_lex(scanner);
 
-    if (c != END_OF_FILE) {
-      TRI_FreeJson(zone, value);
-      value = nullptr;
-      LOG_DEBUG("failed to parse json value: expecting EOF");
-    }
+  // do proper unescaping
+  return TRI_UnescapeUtf8StringZ(scanner->_memoryZone, text, textLength, length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the current number token
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_NumberTokenJsonScanner (TRI_json_scanner_t* scanner,
+                                 double* value) {
+  char buffer[MAX_NUMBER_LENGTH];
+  size_t const length = scanner->_tokenLength;
+
+  if (length >= MAX_NUMBER_LENGTH) {
+    scanner->_message = "number too big";
+    return false;
   }
 
-  if (error != nullptr) {
-    if (yyextra._message != nullptr) {
-      *error = TRI_DuplicateString(yyextra._message);
-    }
-    else {
-      *error = nullptr;
-    }
+  // the token is not null-terminated in the input, so copy it
+  memcpy(buffer, scanner->_token, length);
+  buffer[length] = '\0';
+
+  // need to reset errno because return value of 0 is not distinguishable from an error on Linux
+  errno = 0;
+
+  char* ep;
+  double d = strtod(buffer, &ep);
+
+  if (d == HUGE_VAL && errno == ERANGE) {
+    scanner->_message = "number too big";
+    return false;
+  }
+
+  if (d == 0 && errno == ERANGE) {
+    scanner->_message = "number too small";
+    return false;
+  }
+
+  if (ep != buffer + length) {
+    scanner->_message = "cannot parse number";
+    return false;
+  }
+
+  *value = d;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the message of the scanner for a token that does not start a
+/// value
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_UnexpectedTokenJsonScanner (TRI_json_scanner_t* scanner,
+                                     int token) {
+  switch (token) {
+    case TRI_JSON_TOKEN_CLOSE_BRACE:
+      scanner->_message = "expected object, got '}'";
+      return;
+
+    case TRI_JSON_TOKEN_CLOSE_BRACKET:
+      scanner->_message = "expected object, got ']'";
+      return;
+
+    case TRI_JSON_TOKEN_COMMA:
+      scanner->_message = "expected object, got ','";
+      return;
+
+    case TRI_JSON_TOKEN_COLON:
+      scanner->_message = "expected object, got ':'";
+      return;
+
+    case TRI_JSON_TOKEN_UNQUOTED_STRING:
+      scanner->_message = "expected object, got unquoted string";
+      return;
+
+    case TRI_JSON_TOKEN_END_OF_FILE:
+      scanner->_message = "expecting atom, got end-of-file";
+      return;
+  }
+
+  scanner->_message = "unknown atom";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a json string
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_Json2String (TRI_memory_zone_t* zone, char const* text, char** error) {
+  return ParseText(zone, text, strlen(text), error);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a json string
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_JsonString (TRI_memory_zone_t* zone, char const* text) {
+  return TRI_Json2String(zone, text, nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a json file
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_JsonFile (TRI_memory_zone_t* zone, char const* path, char** error) {
+  size_t length;
+  char* text = TRI_SlurpFile(TRI_UNKNOWN_MEM_ZONE, path, &length);
+
+  if (text == nullptr) {
+    LOG_ERROR("cannot open file '%s': '%s'", path, TRI_LAST_ERROR_STR);
+
+    return nullptr;
   }
 
-  tri_jsp_lex_destroy(scanner);
+  TRI_json_t* value = ParseText(zone, text, length, error);
 
-  fclose(in);
+  TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, text);
 
   return value;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
 // Local Variables:
-// mode: C
 // mode: outline-minor
-// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
 // End:
-
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief json scanner
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_JSON_PARSER_JSON__SCANNER_H
+#define ARANGODB_JSON_PARSER_JSON__SCANNER_H 1
+
+#include "Basics/Common.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public defines
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tokens returned by the scanner
+///
+/// TRI_JSON_TOKEN_STRING_ASCII is a string without escape sequences and
+/// non-ASCII characters. Its contents can be used as they are
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_JSON_TOKEN_END_OF_FILE 0
+#define TRI_JSON_TOKEN_FALSE 1
+#define TRI_JSON_TOKEN_TRUE 2
+#define TRI_JSON_TOKEN_NULL 3
+#define TRI_JSON_TOKEN_NUMBER 4
+#define TRI_JSON_TOKEN_STRING 5
+#define TRI_JSON_TOKEN_OPEN_BRACE 6
+#define TRI_JSON_TOKEN_CLOSE_BRACE 7
+#define TRI_JSON_TOKEN_OPEN_BRACKET 8
+#define TRI_JSON_TOKEN_CLOSE_BRACKET 9
+#define TRI_JSON_TOKEN_COMMA 10
+#define TRI_JSON_TOKEN_COLON 11
+#define TRI_JSON_TOKEN_UNQUOTED_STRING 12
+#define TRI_JSON_TOKEN_STRING_ASCII 13
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scanner state
+///
+/// _token and _tokenLength describe the current token in the input. for
+/// strings, the token includes the quotes
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct TRI_json_scanner_s {
+  char const* _ptr;
+  char const* _end;
+  char const* _token;
+  size_t _tokenLength;
+  TRI_memory_zone_t* _memoryZone;
+  char const* _message;
+}
+TRI_json_scanner_t;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initialises a scanner for a json text of the given length
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_InitJsonScanner (TRI_json_scanner_t*,
+                          TRI_memory_zone_t*,
+                          char const*,
+                          size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the next token
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_NextTokenJsonScanner (TRI_json_scanner_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copies the contents of the current string token
+///
+/// the copy is unescaped and null-terminated. length is set to its length
+/// without the terminator. returns nullptr if out of memory
+////////////////////////////////////////////////////////////////////////////////
+
+char* TRI_StringTokenJsonScanner (TRI_json_scanner_t*,
+                                  int,
+                                  size_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the current number token
+///
+/// sets the message of the scanner and returns false if the number cannot be
+/// converted
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_NumberTokenJsonScanner (TRI_json_scanner_t*,
+                                 double*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the message of the scanner for a token that does not start a
+/// value
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_UnexpectedTokenJsonScanner (TRI_json_scanner_t*,
+                                     int);
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
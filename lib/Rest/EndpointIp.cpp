@@ -95,7 +95,8 @@ EndpointIp::EndpointIp (const Endpoint::EndpointType type,
   : Endpoint(type, domainType, encryption, specification, listenBacklog),
     _host(host),
     _port(port),
-    _reuseAddress(reuseAddress) {
+    _reuseAddress(reuseAddress),
+    _reusePort(false) {
 
   TRI_ASSERT(domainType == DOMAIN_IPV4 || domainType == Endpoint::DOMAIN_IPV6);
 }
@@ -181,11 +182,31 @@ TRI_socket_t EndpointIp::connectSocket (const struct addrinfo* aip,
         
         _errorMessage = errBuf;
 
+        TRI_CLOSE_SOCKET(listenSocket);
+        TRI_invalidatesocket(&listenSocket);
+        return listenSocket;
+      }
+    }
+
+#ifdef SO_REUSEPORT
+    // allow other sockets to listen on the same port
+    if (_reusePort) {
+      int opt = 1;
+      if (TRI_setsockopt(listenSocket, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<char*> (&opt), sizeof (opt)) == -1) {
+
+        pErr = STR_ERROR();
+        snprintf(errBuf, sizeof(errBuf), "setsockopt() failed with #%d - %s",
+                 errno,
+                 pErr);
+
+        _errorMessage = errBuf;
+
         TRI_CLOSE_SOCKET(listenSocket);
         TRI_invalidatesocket(&listenSocket);
         return listenSocket;
       }
     }
+#endif
 #endif
 
     // server needs to bind to socket
@@ -433,6 +454,28 @@ bool EndpointIp::initIncoming (TRI_socket_t incoming) {
   return setSocketFlags(incoming);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates another server endpoint for the same address
+////////////////////////////////////////////////////////////////////////////////
+
+EndpointIp* EndpointIp::createSharedEndpoint () {
+  TRI_ASSERT(_type == ENDPOINT_SERVER);
+  TRI_ASSERT(! _connected);
+
+  Endpoint* endpoint = Endpoint::serverFactory(_specification, _listenBacklog, _reuseAddress);
+  EndpointIp* shared = dynamic_cast<EndpointIp*>(endpoint);
+
+  if (shared == nullptr) {
+    delete endpoint;
+    return nullptr;
+  }
+
+  _reusePort = true;
+  shared->_reusePort = true;
+
+  return shared;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
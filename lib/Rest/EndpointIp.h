@@ -139,6 +139,16 @@ namespace triagens {
           return _host;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates another server endpoint for the same address
+///
+/// both endpoints will use SO_REUSEPORT, so each of them can be bound to a
+/// listen socket of its own. this must be called before the endpoint is
+/// connected. the caller owns the new endpoint
+////////////////////////////////////////////////////////////////////////////////
+
+        EndpointIp* createSharedEndpoint ();
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -163,6 +173,12 @@ namespace triagens {
 
         bool _reuseAddress;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not several sockets may listen on the same port
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _reusePort;
+
     };
 
   }
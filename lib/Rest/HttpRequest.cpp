@@ -510,6 +510,101 @@ int HttpRequest::setBody (char const* newBody,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+int HttpRequest::decompressBody (size_t maximalSize) {
+  bool found;
+  string encoding = header("content-encoding", found);
+
+  if (! found) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  StringUtils::tolowerInPlace(&encoding);
+  encoding = StringUtils::trim(encoding);
+
+  if (encoding.empty() || encoding == "identity") {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  bool const isGzip = (encoding == "gzip" || encoding == "x-gzip");
+
+  if (! isGzip && encoding != "deflate") {
+    return TRI_ERROR_NOT_IMPLEMENTED;
+  }
+
+  if (_bodySize == 0) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  z_stream strm;
+  strm.zalloc   = Z_NULL;
+  strm.zfree    = Z_NULL;
+  strm.opaque   = Z_NULL;
+  strm.avail_in = 0;
+  strm.next_in  = Z_NULL;
+
+  // adding 32 to the window bits lets zlib detect gzip and zlib headers.
+  // some clients send raw deflate data without a zlib header for
+  // "Content-Encoding: deflate", so check for a valid zlib header first
+  // (see StringBuffer::inflate)
+  unsigned char const* start = (unsigned char const*) _body;
+  int windowBits = MAX_WBITS + 32;
+
+  if (! isGzip && 
+      (_bodySize < 2 || ((((uint32_t) start[0]) << 8) | ((uint32_t) start[1])) % 31 != 0)) {
+    windowBits = - MAX_WBITS;
+  }
+
+  if (inflateInit2(&strm, windowBits) != Z_OK) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  size_t const bufferSize = 16384;
+  char buffer[bufferSize];
+  StringBuffer inflated(TRI_UNKNOWN_MEM_ZONE, _bodySize * 4);
+
+  strm.avail_in = (uInt) _bodySize;
+  strm.next_in  = (unsigned char*) start;
+
+  int res;
+
+  do {
+    strm.avail_out = (uInt) bufferSize;
+    strm.next_out  = (unsigned char*) buffer;
+
+    res = ::inflate(&strm, Z_NO_FLUSH);
+
+    if (res != Z_OK && res != Z_STREAM_END) {
+      (void) inflateEnd(&strm);
+
+      return (res == Z_MEM_ERROR ? TRI_ERROR_OUT_OF_MEMORY : TRI_ERROR_BAD_PARAMETER);
+    }
+
+    size_t const produced = bufferSize - strm.avail_out;
+
+    if (inflated.length() + produced > maximalSize) {
+      (void) inflateEnd(&strm);
+
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    inflated.appendText(buffer, produced);
+  }
+  while (res != Z_STREAM_END && (strm.avail_in > 0 || strm.avail_out == 0));
+
+  (void) inflateEnd(&strm);
+
+  if (res != Z_STREAM_END) {
+    // truncated input
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  return setBody(inflated.c_str(), inflated.length());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets a header field
 ////////////////////////////////////////////////////////////////////////////////
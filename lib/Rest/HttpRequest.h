@@ -521,6 +521,18 @@ namespace triagens {
 
         int setBody (char const* newBody, size_t length);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decompresses a gzip- or deflate-encoded body in place
+///
+/// the encoding is determined from the content-encoding header. bodies
+/// without a content-encoding header or with an identity encoding are left
+/// alone. returns TRI_ERROR_NOT_IMPLEMENTED for unknown encodings,
+/// TRI_ERROR_BAD_PARAMETER for corrupted input and TRI_ERROR_OUT_OF_MEMORY
+/// if the decompressed body would exceed the given maximal size
+////////////////////////////////////////////////////////////////////////////////
+
+        int decompressBody (size_t maximalSize);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief set a header field
 ////////////////////////////////////////////////////////////////////////////////
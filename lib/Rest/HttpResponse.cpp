@@ -38,6 +38,59 @@ using namespace triagens::basics;
 using namespace triagens::rest;
 using namespace std;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks whether an accept-encoding header allows an encoding
+///
+/// codings explicitly disabled by the client with a quality value of 0 are
+/// not accepted
+////////////////////////////////////////////////////////////////////////////////
+
+static bool AcceptsEncoding (std::string const& acceptEncoding,
+                             std::string const& encoding) {
+  std::vector<std::string> const parts = StringUtils::split(acceptEncoding, ',');
+
+  for (auto const& part : parts) {
+    std::vector<std::string> const params = StringUtils::split(part, ';');
+
+    if (params.empty() ||
+        StringUtils::tolower(StringUtils::trim(params[0])) != encoding) {
+      continue;
+    }
+
+    for (size_t i = 1; i < params.size(); ++i) {
+      std::string const param = StringUtils::trim(params[i]);
+
+      if (param.size() > 2 && param[0] == 'q' && param[1] == '=' &&
+          StringUtils::doubleDecimal(param.substr(2)) <= 0.0) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks whether a content type is worth compressing
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsCompressibleContentType (std::string const& contentType) {
+  if (contentType.compare(0, 6, "image/") == 0 ||
+      contentType.compare(0, 6, "audio/") == 0 ||
+      contentType.compare(0, 6, "video/") == 0) {
+    return false;
+  }
+
+  return (contentType.find("zip") == std::string::npos &&
+          contentType.find("compressed") == std::string::npos);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                             static public methods
 // -----------------------------------------------------------------------------
@@ -852,6 +905,77 @@ int HttpResponse::deflate (size_t bufferSize) {
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compresses the response body using deflate or gzip
+////////////////////////////////////////////////////////////////////////////////
+
+int HttpResponse::compress (bool gzip,
+                            size_t maxLength,
+                            bool& compressed,
+                            size_t bufferSize) {
+  int res = _body.compress(bufferSize, gzip, maxLength, compressed);
+
+  if (res != TRI_ERROR_NO_ERROR || ! compressed) {
+    return res;
+  }
+
+  setHeader("content-encoding", strlen("content-encoding"), gzip ? "gzip" : "deflate");
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compresses the response body for a client
+////////////////////////////////////////////////////////////////////////////////
+
+int HttpResponse::compressForClient (std::string const& acceptEncoding,
+                                     size_t minimalSize,
+                                     size_t maximalSize,
+                                     bool& compressed,
+                                     size_t bufferSize) {
+  compressed = false;
+
+  size_t const length = _body.length();
+
+  if (length < minimalSize ||
+      (maximalSize > 0 && length > maximalSize)) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  bool found;
+  header("content-encoding", strlen("content-encoding"), found);
+
+  if (found || ! IsCompressibleContentType(header(string("content-type")))) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // the body is sent compressed or not depending on the accept-encoding
+  // header, so caches must store the variants separately
+  string vary = header("vary", strlen("vary"), found);
+
+  if (! found || vary.empty()) {
+    setHeader("vary", strlen("vary"), "Accept-Encoding");
+  }
+  else if (StringUtils::tolower(vary).find("accept-encoding") == string::npos &&
+           StringUtils::trim(vary) != "*") {
+    setHeader("vary", strlen("vary"), vary + ", Accept-Encoding");
+  }
+
+  bool gzip;
+
+  if (AcceptsEncoding(acceptEncoding, "deflate")) {
+    gzip = false;
+  }
+  else if (AcceptsEncoding(acceptEncoding, "gzip")) {
+    gzip = true;
+  }
+  else {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // give up if compression saves less than 10 %
+  return compress(gzip, length - length / 10, compressed, bufferSize);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
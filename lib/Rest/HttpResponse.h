@@ -368,6 +368,38 @@ namespace triagens {
 
         int deflate (size_t = 16384);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compresses the response body using deflate or gzip
+///
+/// the body must already be set. if the compressed body would be larger than
+/// maxLength bytes (and maxLength is not 0), the body is left uncompressed.
+/// compressed is set to true if the body was replaced by its compressed
+/// version, and the content-encoding header is set accordingly
+////////////////////////////////////////////////////////////////////////////////
+
+        int compress (bool gzip,
+                      size_t maxLength,
+                      bool& compressed,
+                      size_t = 16384);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compresses the response body for a client
+///
+/// acceptEncoding is the value of the client's accept-encoding header (empty
+/// if the client did not send one). the body is compressed with deflate or
+/// gzip if the client accepts one of them, its size lies between minimalSize
+/// and maximalSize (0 = unlimited), its content type is worth compressing,
+/// it is not encoded yet and compression saves at least 10 %. all responses
+/// that pass the size and content type checks get a "Vary: Accept-Encoding"
+/// header
+////////////////////////////////////////////////////////////////////////////////
+
+        int compressForClient (std::string const& acceptEncoding,
+                               size_t minimalSize,
+                               size_t maximalSize,
+                               bool& compressed,
+                               size_t = 16384);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -36,6 +36,7 @@
 #include "Basics/Exceptions.h"
 #include "Basics/logging.h"
 #include "Basics/process-utils.h"
+#include "Basics/socket-utils.h"
 #include "Scheduler/PeriodicTask.h"
 #include "Scheduler/SchedulerLibev.h"
 #include "Scheduler/SignalTask.h"
@@ -340,6 +341,7 @@ ApplicationScheduler::ApplicationScheduler (ApplicationServer* applicationServer
     _multiSchedulerAllowed(true),
     _nrSchedulerThreads(4),
     _backend(0),
+    _sharding(false),
     _descriptorMinimum(256) {
 }
 
@@ -371,6 +373,19 @@ Scheduler* ApplicationScheduler::scheduler () const {
   return _scheduler;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of shards for listen sockets and dispatcher
+/// queues
+////////////////////////////////////////////////////////////////////////////////
+
+size_t ApplicationScheduler::numberOfShards () const {
+  if (_sharding && _multiSchedulerAllowed && 1 < _nrSchedulerThreads) {
+    return (size_t) _nrSchedulerThreads;
+  }
+
+  return 1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief installs a signal handler
 ////////////////////////////////////////////////////////////////////////////////
@@ -425,6 +440,7 @@ void ApplicationScheduler::setupOptions (map<string, ProgramOptionsDescription>&
   if (_multiSchedulerAllowed) {
     options["Server Options:help-admin"]
       ("scheduler.threads", &_nrSchedulerThreads, "number of threads for I/O scheduler")
+      ("scheduler.sharding", &_sharding, "use a listen socket and a dispatcher queue per scheduler thread")
     ;
   }
 }
@@ -452,6 +468,13 @@ bool ApplicationScheduler::parsePhase2 (triagens::basics::ProgramOptions& option
   // adjust file descriptors
   adjustFileDescriptors();
 
+#ifndef SO_REUSEPORT
+  if (_sharding) {
+    LOG_WARNING("SO_REUSEPORT is not supported on this platform, ignoring --scheduler.sharding");
+    _sharding = false;
+  }
+#endif
+
   return true;
 }
 
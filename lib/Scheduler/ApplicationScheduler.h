@@ -94,6 +94,16 @@ namespace triagens {
 
         Scheduler* scheduler () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of shards for listen sockets and dispatcher
+/// queues
+///
+/// this is the number of scheduler threads if sharding is enabled, and 1
+/// otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t numberOfShards () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief installs a signal handler
 ////////////////////////////////////////////////////////////////////////////////
@@ -240,6 +250,26 @@ namespace triagens {
 
         uint32_t _backend;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief per-thread sharding of listen sockets and dispatcher queues
+/// @startDocuBlock schedulerSharding
+/// `--scheduler.sharding`
+///
+/// If set to *true*, each scheduler thread gets a listen socket of its own
+/// for every TCP endpoint, using *SO_REUSEPORT* so that the kernel spreads
+/// incoming connections over the threads. Connections stay in the thread
+/// that accepted them, and their requests are put into a dispatcher queue
+/// belonging to that thread. Dispatcher threads only take over requests
+/// from another queue if their own queue is empty.
+///
+/// This keeps a request on one core from accept to response. It requires
+/// *SO_REUSEPORT* support by the operating system (Linux 3.9 or higher) and
+/// more than one scheduler thread. The default is *false*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _sharding;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief minimum number of file descriptors
 ////////////////////////////////////////////////////////////////////////////////
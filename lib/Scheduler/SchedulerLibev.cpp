@@ -288,7 +288,7 @@ SchedulerLibev::SchedulerLibev (size_t concurrency, int backend)
   _wakers = new ev_async*[nrThreads];
 
   for (size_t i = 0;  i < nrThreads;  ++i) {
-    threads[i] = new SchedulerThread(this, EventLoop(i), i == 0);
+    threads[i] = new SchedulerThread(this, EventLoop(i), i == 0, i);
 
     ev_async* w = new ev_async;
 
@@ -61,11 +61,15 @@ using namespace triagens::rest;
 /// @brief constructor
 ////////////////////////////////////////////////////////////////////////////////
 
-SchedulerThread::SchedulerThread (Scheduler* scheduler, EventLoop loop, bool defaultLoop)
+SchedulerThread::SchedulerThread (Scheduler* scheduler,
+                                  EventLoop loop,
+                                  bool defaultLoop,
+                                  size_t number)
   : Thread("scheduler"),
     _scheduler(scheduler),
     _defaultLoop(defaultLoop),
     _loop(loop),
+    _number(number),
     _stopping(0),
     _stopped(0),
     _open(0),
@@ -233,6 +237,8 @@ void SchedulerThread::destroyTask (Task* task) {
 void SchedulerThread::run () {
   LOG_TRACE("scheduler thread started (%llu)", (unsigned long long) threadId());
 
+  currentThreadNumber = static_cast<ssize_t>(_number);
+
   if (_defaultLoop) {
 #ifdef TRI_HAVE_POSIX_THREADS
     sigset_t all;
@@ -335,6 +341,13 @@ void SchedulerThread::run () {
   SCHEDULER_UNLOCK(&_queueLock);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a global, but thread-local place to hold the number of the current
+/// scheduler thread. If we are not in a scheduler thread this is set to -1.
+////////////////////////////////////////////////////////////////////////////////
+
+thread_local ssize_t SchedulerThread::currentThreadNumber = -1;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -72,7 +72,7 @@ namespace triagens {
 /// @brief constructor
 ////////////////////////////////////////////////////////////////////////////////
 
-        SchedulerThread (Scheduler*, EventLoop, bool defaultLoop);
+        SchedulerThread (Scheduler*, EventLoop, bool defaultLoop, size_t number);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destructor
@@ -122,6 +122,13 @@ namespace triagens {
 
         void destroyTask (Task*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a global, but thread-local place to hold the number of the current
+/// scheduler thread. If we are not in a scheduler thread this is set to -1.
+////////////////////////////////////////////////////////////////////////////////
+
+        static thread_local ssize_t currentThreadNumber;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    Thread methods
 // -----------------------------------------------------------------------------
@@ -189,6 +196,12 @@ namespace triagens {
 
         EventLoop _loop;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of the thread within the scheduler
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t const _number;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief true if scheduler threads is shutting down
 ////////////////////////////////////////////////////////////////////////////////
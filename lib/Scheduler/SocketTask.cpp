@@ -58,6 +58,7 @@ SocketTask::SocketTask (TRI_socket_t socket, double keepAliveTimeout)
     _commSocket(socket),
     _keepAliveTimeout(keepAliveTimeout),
     _writeBuffer(nullptr),
+    _writeBody(nullptr),
 #ifdef TRI_ENABLE_FIGURES
     _writeBufferStatistics(0),
 #endif
@@ -85,9 +86,7 @@ SocketTask::~SocketTask () {
     TRI_invalidatesocket(&_commSocket);
   }
 
-  if (_writeBuffer != nullptr && ownBuffer) {
-    delete _writeBuffer;
-  }
+  releaseWriteBuffer();
 
 #ifdef TRI_ENABLE_FIGURES
 
@@ -176,21 +175,51 @@ bool SocketTask::handleWrite () {
   size_t len = 0;
 
   if (nullptr != _writeBuffer) {
-    TRI_ASSERT(_writeBuffer->length() >= writeLength);
-    len = _writeBuffer->length() - writeLength;
+    TRI_ASSERT(writeBufferLength() >= writeLength);
+    len = writeBufferLength() - writeLength;
   }
 
   int nr = 0;
 
   if (0 < len) {
-    nr = TRI_WRITE_SOCKET(_commSocket, _writeBuffer->begin() + writeLength, (int) len, 0);
+    size_t const headerLength = _writeBuffer->length();
+
+    if (_writeBody != nullptr && writeLength < headerLength) {
+      // send the rest of the header and the body with a single system call
+      nr = TRI_writevsocket(_commSocket,
+                            _writeBuffer->begin() + writeLength,
+                            headerLength - writeLength,
+                            _writeBody->begin(),
+                            _writeBody->length());
+    }
+    else {
+      size_t segmentLength;
+      char const* segment = nextWriteSegment(segmentLength);
+
+      nr = TRI_WRITE_SOCKET(_commSocket, segment, (int) segmentLength, 0);
+    }
 
     if (nr < 0) {
-      if (errno == EINTR) {
+#ifdef _WIN32
+      // send() and WSASend() report their errors via WSAGetLastError()
+      int const error = WSAGetLastError();
+      bool const interrupted = (error == WSAEINTR);
+      bool const wouldBlock = (error == WSAEWOULDBLOCK);
+#else
+      int const error = errno;
+      bool const interrupted = (error == EINTR);
+      bool const wouldBlock = (error == EWOULDBLOCK);
+#endif
+
+      if (interrupted) {
         return handleWrite();
       }
-      else if (errno != EWOULDBLOCK) {
-        LOG_DEBUG("write failed with %d: %s", (int) errno, strerror(errno));
+      else if (! wouldBlock) {
+#ifdef _WIN32
+        LOG_DEBUG("write failed with %d", error);
+#else
+        LOG_DEBUG("write failed with %d: %s", error, strerror(error));
+#endif
 
         return false;
       }
@@ -203,9 +232,7 @@ bool SocketTask::handleWrite () {
   }
 
   if (len == 0) {
-    if (nullptr != _writeBuffer && ownBuffer) {
-      delete _writeBuffer;
-    }
+    releaseWriteBuffer();
 
     callCompletedWriteBuffer = true;
   }
@@ -271,9 +298,7 @@ void SocketTask::setWriteBuffer (StringBuffer* buffer,
   }
   else {
     if (_writeBuffer != nullptr) {
-      if (this->ownBuffer) {
-        delete _writeBuffer;
-      }
+      releaseWriteBuffer();
     }
 
     _writeBuffer = buffer;
@@ -300,6 +325,107 @@ void SocketTask::setWriteBuffer (StringBuffer* buffer,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets an active write buffer consisting of a header and a body
+////////////////////////////////////////////////////////////////////////////////
+
+void SocketTask::setWriteBuffer (StringBuffer* header,
+                                 StringBuffer* body,
+                                 TRI_request_statistics_t* statistics) {
+  if (body == nullptr || body->empty()) {
+    delete body;
+    setWriteBuffer(header, statistics, true);
+    return;
+  }
+
+  if (header->empty()) {
+    delete header;
+    setWriteBuffer(body, statistics, true);
+    return;
+  }
+
+#ifdef TRI_ENABLE_FIGURES
+
+  _writeBufferStatistics = statistics;
+
+  if (_writeBufferStatistics != nullptr) {
+    _writeBufferStatistics->_writeStart = TRI_StatisticsTime();
+    _writeBufferStatistics->_sentBytes += header->length() + body->length();
+  }
+
+#endif
+
+  if (_writeBuffer != nullptr) {
+    releaseWriteBuffer();
+  }
+
+  writeLength = 0;
+
+  _writeBuffer = header;
+  _writeBody = body;
+  this->ownBuffer = true;
+
+  if (_clientClosed) {
+    return;
+  }
+
+  TRI_ASSERT(tid == Thread::currentThreadId());
+
+  _scheduler->startSocketEvents(writeWatcher);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the total length of the active write buffer and body
+////////////////////////////////////////////////////////////////////////////////
+
+size_t SocketTask::writeBufferLength () const {
+  if (_writeBuffer == nullptr) {
+    return 0;
+  }
+
+  if (_writeBody == nullptr) {
+    return _writeBuffer->length();
+  }
+
+  return _writeBuffer->length() + _writeBody->length();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the next contiguous part of the active write buffer and
+/// body that has not been sent yet
+////////////////////////////////////////////////////////////////////////////////
+
+char const* SocketTask::nextWriteSegment (size_t& length) const {
+  TRI_ASSERT(_writeBuffer != nullptr);
+
+  size_t const headerLength = _writeBuffer->length();
+
+  if (writeLength < headerLength || _writeBody == nullptr) {
+    length = headerLength - writeLength;
+    return _writeBuffer->begin() + writeLength;
+  }
+
+  length = writeBufferLength() - writeLength;
+  return _writeBody->begin() + (writeLength - headerLength);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the active write buffer (if owned) and body
+////////////////////////////////////////////////////////////////////////////////
+
+void SocketTask::releaseWriteBuffer () {
+  if (_writeBuffer != nullptr && ownBuffer) {
+    delete _writeBuffer;
+  }
+
+  _writeBuffer = nullptr;
+
+  if (_writeBody != nullptr) {
+    delete _writeBody;
+    _writeBody = nullptr;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief checks for presence of an active write buffer
 ////////////////////////////////////////////////////////////////////////////////
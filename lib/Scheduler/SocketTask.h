@@ -165,6 +165,36 @@ namespace triagens {
                              TRI_request_statistics_t*,
                              bool ownBuffer = true);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets an active write buffer consisting of a header and a body
+///
+/// both buffers are sent with gather writes, so the body does not need to be
+/// copied behind the header. the task takes ownership of both buffers
+////////////////////////////////////////////////////////////////////////////////
+
+        void setWriteBuffer (basics::StringBuffer*,
+                             basics::StringBuffer*,
+                             TRI_request_statistics_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the total length of the active write buffer and body
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t writeBufferLength () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the next contiguous part of the active write buffer and
+/// body that has not been sent yet
+////////////////////////////////////////////////////////////////////////////////
+
+        char const* nextWriteSegment (size_t&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the active write buffer (if owned) and body
+////////////////////////////////////////////////////////////////////////////////
+
+        void releaseWriteBuffer ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief checks for presence of an active write buffer
 ////////////////////////////////////////////////////////////////////////////////
@@ -243,6 +273,14 @@ namespace triagens {
 
         basics::StringBuffer* _writeBuffer;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the body to be sent after the current write buffer (may be null)
+///
+/// the body is always owned by the task
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::StringBuffer* _writeBody;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief the current write buffer statistics
 ////////////////////////////////////////////////////////////////////////////////
@@ -264,6 +302,8 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief number of bytes already written
+///
+/// this counts bytes of the write buffer and the body together
 ////////////////////////////////////////////////////////////////////////////////
 
         size_t writeLength;
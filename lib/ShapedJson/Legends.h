@@ -279,6 +279,9 @@ namespace triagens {
           lookupAttributePathByPid = FailureFunction2;
           findOrCreateAttributePathByName = FailureFunction2;
           lookupAttributePathByName = FailureFunction2;
+
+          // JSON made from the legend is allocated here
+          _memoryZone = TRI_UNKNOWN_MEM_ZONE;
         }
 
         ~LegendReader () {
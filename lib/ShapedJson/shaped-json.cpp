@@ -36,6 +36,7 @@
 #include "Basics/string-buffer.h"
 #include "Basics/tri-strings.h"
 #include "Basics/vector.h"
+#include "JsonParser/json-scanner.h"
 #include "ShapedJson/json-shaper.h"
 
 // #define DEBUG_JSON_SHAPER 1
@@ -45,6 +46,7 @@
 // -----------------------------------------------------------------------------
 
 static bool FillShapeValueJson (TRI_shaper_t* shaper, TRI_shape_value_t* dst, TRI_json_t const* json, size_t, bool);
+static bool ParseShapeValue (struct shape_text_parser_s* parser, TRI_shape_value_t* dst, int c, size_t level);
 static TRI_json_t* JsonShapeData (TRI_shaper_t* shaper, TRI_shape_t const* shape, char const* data, uint64_t size);
 static bool StringifyJsonShapeData (TRI_shaper_t* shaper, TRI_string_buffer_t* buffer, TRI_shape_t const* shape, char const* data, uint64_t size);
 
@@ -352,7 +354,7 @@ static int SortShapeValuesFunc (void const* l, void const* r) {
 /// @brief converts a null into TRI_shape_value_t
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueNull (TRI_shaper_t* shaper, TRI_shape_value_t* dst, TRI_json_t const* json) {
+static bool FillShapeValueNull (TRI_shaper_t* shaper, TRI_shape_value_t* dst) {
   dst->_type = TRI_SHAPE_NULL;
   dst->_sid = BasicShapes::TRI_SHAPE_SID_NULL;
   dst->_fixedSized = true;
@@ -366,7 +368,7 @@ static bool FillShapeValueNull (TRI_shaper_t* shaper, TRI_shape_value_t* dst, TR
 /// @brief converts a boolean into TRI_shape_value_t
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueBoolean (TRI_shaper_t* shaper, TRI_shape_value_t* dst, TRI_json_t const* json) {
+static bool FillShapeValueBoolean (TRI_shaper_t* shaper, TRI_shape_value_t* dst, bool value) {
   TRI_shape_boolean_t* ptr;
 
   dst->_type = TRI_SHAPE_BOOLEAN;
@@ -380,7 +382,7 @@ static bool FillShapeValueBoolean (TRI_shaper_t* shaper, TRI_shape_value_t* dst,
     return false;
   }
 
-  *ptr = json->_value._boolean ? 1 : 0;
+  *ptr = value ? 1 : 0;
 
   return true;
 }
@@ -389,7 +391,7 @@ static bool FillShapeValueBoolean (TRI_shaper_t* shaper, TRI_shape_value_t* dst,
 /// @brief converts a number into TRI_shape_value_t
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueNumber (TRI_shaper_t* shaper, TRI_shape_value_t* dst, TRI_json_t const* json) {
+static bool FillShapeValueNumber (TRI_shaper_t* shaper, TRI_shape_value_t* dst, double value) {
   TRI_shape_number_t* ptr;
 
   dst->_type = TRI_SHAPE_NUMBER;
@@ -402,19 +404,27 @@ static bool FillShapeValueNumber (TRI_shaper_t* shaper, TRI_shape_value_t* dst,
     return false;
   }
 
-  *ptr = json->_value._number;
+  *ptr = value;
 
   return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a string into TRI_shape_value_t
+///
+/// the length includes the trailing '\0', which is written by this function.
+/// the string itself need not be null-terminated
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueString (TRI_shaper_t* shaper, TRI_shape_value_t* dst, TRI_json_t const* json) {
+static bool FillShapeValueString (TRI_shaper_t* shaper,
+                                  TRI_shape_value_t* dst,
+                                  char const* data,
+                                  size_t length) {
   char* ptr;
 
-  if (json->_value._string.length <= TRI_SHAPE_SHORT_STRING_CUT) { // includes '\0'
+  TRI_ASSERT(length > 0);
+
+  if (length <= TRI_SHAPE_SHORT_STRING_CUT) { // includes '\0'
     dst->_type = TRI_SHAPE_SHORT_STRING;
     dst->_sid = BasicShapes::TRI_SHAPE_SID_SHORT_STRING;
     dst->_fixedSized = true;
@@ -427,42 +437,56 @@ static bool FillShapeValueString (TRI_shaper_t* shaper, TRI_shape_value_t* dst,
       return false;
     }
 
-    * ((TRI_shape_length_short_string_t*) ptr) = json->_value._string.length;
+    * ((TRI_shape_length_short_string_t*) ptr) = (TRI_shape_length_short_string_t) length;
 
-    memcpy(ptr + sizeof(TRI_shape_length_short_string_t),
-           json->_value._string.data,
-           json->_value._string.length);
+    memcpy(ptr + sizeof(TRI_shape_length_short_string_t), data, length - 1);
   }
   else {
     dst->_type = TRI_SHAPE_LONG_STRING;
     dst->_sid = BasicShapes::TRI_SHAPE_SID_LONG_STRING;
     dst->_fixedSized = false;
-    dst->_size = sizeof(TRI_shape_length_long_string_t) + json->_value._string.length;
+    dst->_size = sizeof(TRI_shape_length_long_string_t) + length;
     dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->_memoryZone, dst->_size, false)));
 
     if (dst->_value == nullptr) {
       return false;
     }
 
-    * ((TRI_shape_length_long_string_t*) ptr) = json->_value._string.length;
+    * ((TRI_shape_length_long_string_t*) ptr) = (TRI_shape_length_long_string_t) length;
 
-    memcpy(ptr + sizeof(TRI_shape_length_long_string_t),
-           json->_value._string.data,
-           json->_value._string.length);
+    memcpy(ptr + sizeof(TRI_shape_length_long_string_t), data, length - 1);
+    ptr[sizeof(TRI_shape_length_long_string_t) + length - 1] = '\0';
   }
 
   return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief converts a json list into TRI_shape_value_t
+/// @brief frees the data of shape values, but not the values themselves
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueList (TRI_shaper_t* shaper,
-                                TRI_shape_value_t* dst,
-                                TRI_json_t const* json,
-                                size_t level,
-                                bool create) {
+static void FreeShapeValues (TRI_memory_zone_t* zone,
+                             TRI_shape_value_t* values,
+                             TRI_shape_value_t* end) {
+  for (TRI_shape_value_t* p = values;  p < end;  ++p) {
+    if (p->_value != nullptr) {
+      TRI_Free(zone, p->_value);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the shape values of the elements of a list into
+/// TRI_shape_value_t
+///
+/// the element values are not freed
+////////////////////////////////////////////////////////////////////////////////
+
+static bool FillShapeValueListValues (TRI_shaper_t* shaper,
+                                      TRI_shape_value_t* dst,
+                                      TRI_shape_value_t const* values,
+                                      size_t n,
+                                      bool create) {
   TRI_shape_sid_t s;
   TRI_shape_sid_t l;
 
@@ -471,12 +495,7 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
 
   char* ptr;
 
-  // sanity checks
-  TRI_ASSERT(json->_type == TRI_JSON_ARRAY);
-
   // check for special case "empty list"
-  size_t const n = json->_value._objects._length;
-
   if (n == 0) {
     dst->_type = TRI_SHAPE_LIST;
     dst->_sid = BasicShapes::TRI_SHAPE_SID_LIST;
@@ -493,41 +512,12 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
     return true;
   }
   
-  // helper function to free shape values
-  auto freeShapeValues = [] (TRI_memory_zone_t* zone, TRI_shape_value_t* values, TRI_shape_value_t* end) {
-    TRI_shape_value_t* p = values;
-    TRI_shape_value_t* e = end;
-
-    for (;  p < e;  ++p) {
-      if (p->_value != nullptr) {
-        TRI_Free(zone, p->_value);
-      }
-    }
-
-    TRI_Free(zone, values);
-  };
-  
-
-  // convert into TRI_shape_value_t array
-  TRI_shape_value_t* values = static_cast<TRI_shape_value_t*>(TRI_Allocate(shaper->_memoryZone, sizeof(TRI_shape_value_t) * n, true));
-
-  if (values == nullptr) {
-    return false;
-  }
-
   uint64_t total = 0;
 
-  TRI_shape_value_t* p = values;
-
-  for (size_t i = 0;  i < n;  ++i, ++p) {
-    TRI_json_t const* el = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
-    bool ok = FillShapeValueJson(shaper, p, el, level + 1, create);
-
-    if (! ok) {
-      freeShapeValues(shaper->_memoryZone, values, p);
-      return false;
-    }
+  TRI_shape_value_t const* p = values;
+  TRI_shape_value_t const* const e = values + n; // end does not change
 
+  for (;  p < e;  ++p) {
     total += p->_size;
   }
 
@@ -538,10 +528,7 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
   s = values[0]._sid;
   l = values[0]._size;
   
-  p = values;
-  TRI_shape_value_t* const e = values + n; // end does not change
-
-  for (;  p < e;  ++p) {
+  for (p = values;  p < e;  ++p) {
     if (p->_sid != s) {
       hs = false;
       break;
@@ -557,7 +544,6 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
     TRI_homogeneous_sized_list_shape_t* shape = static_cast<TRI_homogeneous_sized_list_shape_t*>(TRI_Allocate(shaper->_memoryZone, sizeof(TRI_homogeneous_sized_list_shape_t), true));
 
     if (shape == nullptr) {
-      freeShapeValues(shaper->_memoryZone, values, e);
       return false;
     }
 
@@ -571,7 +557,6 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
     TRI_shape_t const* found = shaper->findShape(shaper, &shape->base, create);
 
     if (found == nullptr) {
-      freeShapeValues(shaper->_memoryZone, values, e);
       TRI_Free(shaper->_memoryZone, shape);
       return false;
     }
@@ -586,7 +571,6 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
     dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->_memoryZone, dst->_size, true)));
 
     if (dst->_value == nullptr) {
-      freeShapeValues(shaper->_memoryZone, values, e);
       return false;
     }
 
@@ -605,7 +589,6 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
     TRI_homogeneous_list_shape_t* shape = static_cast<TRI_homogeneous_list_shape_t*>(TRI_Allocate(shaper->_memoryZone, sizeof(TRI_homogeneous_list_shape_t), true));
 
     if (shape == nullptr) {
-      freeShapeValues(shaper->_memoryZone, values, e);
       return false;
     }
 
@@ -618,7 +601,6 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
     TRI_shape_t const* found = shaper->findShape(shaper, &shape->base, create);
 
     if (found == nullptr) {
-      freeShapeValues(shaper->_memoryZone, values, e);
       TRI_Free(shaper->_memoryZone, shape);
       return false;
     }
@@ -635,7 +617,6 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
     dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->_memoryZone, dst->_size, true)));
 
     if (dst->_value == nullptr) {
-      freeShapeValues(shaper->_memoryZone, values, e);
       return false;
     }
 
@@ -672,7 +653,6 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
     dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->_memoryZone, dst->_size, true)));
 
     if (dst->_value == nullptr) {
-      freeShapeValues(shaper->_memoryZone, values, e);
       return false;
     }
 
@@ -699,111 +679,85 @@ static bool FillShapeValueList (TRI_shaper_t* shaper,
     *offsets = offset;
   }
 
-  // free TRI_shape_value_t array
-  freeShapeValues(shaper->_memoryZone, values, e);
   return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief converts a json array into TRI_shape_value_t
+/// @brief converts a json list into TRI_shape_value_t
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueArray (TRI_shaper_t* shaper,
-                                 TRI_shape_value_t* dst,
-                                 TRI_json_t const* json,
-                                 size_t level,
-                                 bool create) {
-  TRI_shape_sid_t* sids;
-  TRI_shape_aid_t* aids;
-  TRI_shape_size_t* offsetsF;
-  TRI_shape_size_t* offsetsV;
-  TRI_shape_size_t offset;
-
-  char* ptr;
-
+static bool FillShapeValueList (TRI_shaper_t* shaper,
+                                TRI_shape_value_t* dst,
+                                TRI_json_t const* json,
+                                size_t level,
+                                bool create) {
   // sanity checks
-  TRI_ASSERT(json->_type == TRI_JSON_OBJECT);
-  TRI_ASSERT(json->_value._objects._length % 2 == 0);
+  TRI_ASSERT(json->_type == TRI_JSON_ARRAY);
 
-  // number of attributes
-  size_t n = json->_value._objects._length / 2;
+  size_t const n = json->_value._objects._length;
+
+  if (n == 0) {
+    return FillShapeValueListValues(shaper, dst, nullptr, 0, create);
+  }
 
   // convert into TRI_shape_value_t array
-  TRI_shape_value_t* values = static_cast<TRI_shape_value_t*>(TRI_Allocate(shaper->_memoryZone, n * sizeof(TRI_shape_value_t), true));
+  TRI_shape_value_t* values = static_cast<TRI_shape_value_t*>(TRI_Allocate(shaper->_memoryZone, sizeof(TRI_shape_value_t) * n, true));
 
   if (values == nullptr) {
     return false;
   }
-  
-  
-  // helper function to free shape values
-  auto freeShapeValues = [] (TRI_memory_zone_t* zone, TRI_shape_value_t* values, TRI_shape_value_t* end) {
-    TRI_shape_value_t* p = values;
-    TRI_shape_value_t* e = end;
-
-    for (;  p < e;  ++p) {
-      if (p->_value != nullptr) {
-        TRI_Free(zone, p->_value);
-      }
-    }
-
-    TRI_Free(zone, values);
-  };
-
-
-  uint64_t total = 0;
-  size_t f = 0;
-  size_t v = 0;
 
   TRI_shape_value_t* p = values;
 
   for (size_t i = 0;  i < n;  ++i, ++p) {
-    TRI_json_t const* key = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, 2 * i));
-    TRI_ASSERT(key != nullptr);
-    TRI_ASSERT(key->_type == TRI_JSON_STRING);
-
-    char const* k = key->_value._string.data;
+    TRI_json_t const* el = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
+    bool ok = FillShapeValueJson(shaper, p, el, level + 1, create);
 
-    if (k == nullptr ||
-        key->_value._string.length == 1) {
-      // empty attribute name
-      p--;
-      continue;
+    if (! ok) {
+      FreeShapeValues(shaper->_memoryZone, values, p);
+      TRI_Free(shaper->_memoryZone, values);
+      return false;
     }
+  }
 
-    if (*k == '_' && level == 0) {
-      // on top level, strip reserved attributes before shaping
-      if (strcmp(k, "_key") == 0 || 
-          strcmp(k, "_rev") == 0 ||
-          strcmp(k, "_id") == 0 ||
-          strcmp(k, "_from") == 0 ||
-          strcmp(k, "_to") == 0) {
-        // found a reserved attribute - discard it
-        --p;
-        continue;
-      }
-    }
+  bool ok = FillShapeValueListValues(shaper, dst, values, n, create);
 
-    // first find an identifier for the name
-    p->_aid = shaper->findOrCreateAttributeByName(shaper, k);
+  // free TRI_shape_value_t array
+  FreeShapeValues(shaper->_memoryZone, values, values + n);
+  TRI_Free(shaper->_memoryZone, values);
 
-    // convert value
-    bool ok;
-    if (p->_aid == 0) {
-      ok = false;
-    }
-    else {
-      TRI_json_t const* val = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, 2 * i + 1));
-      TRI_ASSERT(val != nullptr);
+  return ok;
+}
 
-      ok = FillShapeValueJson(shaper, p, val, level + 1, create);
-    }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the shape values of the attributes of an array into
+/// TRI_shape_value_t
+///
+/// the attribute values must have their _aid set. they are sorted, but not
+/// freed
+////////////////////////////////////////////////////////////////////////////////
 
-    if (! ok) {
-      freeShapeValues(shaper->_memoryZone, values, p);
-      return false;
-    }
+static bool FillShapeValueArrayValues (TRI_shaper_t* shaper,
+                                       TRI_shape_value_t* dst,
+                                       TRI_shape_value_t* values,
+                                       size_t n,
+                                       bool create) {
+  TRI_shape_sid_t* sids;
+  TRI_shape_aid_t* aids;
+  TRI_shape_size_t* offsetsF;
+  TRI_shape_size_t* offsetsV;
+  TRI_shape_size_t offset;
+
+  char* ptr;
 
+  uint64_t total = 0;
+  size_t f = 0;
+  size_t v = 0;
+
+  TRI_shape_value_t* p = values;
+  TRI_shape_value_t* const e = values + n;
+
+  for (;  p < e;  ++p) {
     total += p->_size;
 
     // count fixed and variable sized values
@@ -818,9 +772,6 @@ static bool FillShapeValueArray (TRI_shaper_t* shaper,
   // add variable offset table size
   total += (v + 1) * sizeof(TRI_shape_size_t);
 
-  // now adjust n because we might have excluded empty attributes
-  n = f + v;
-
   // now sort the shape entries
   if (n > 1) {
     TRI_SortShapeValues(values, n);
@@ -845,7 +796,6 @@ static bool FillShapeValueArray (TRI_shaper_t* shaper,
   TRI_array_shape_t* a = reinterpret_cast<TRI_array_shape_t*>(ptr = static_cast<char*>(TRI_Allocate(shaper->_memoryZone, byteSize, true)));
 
   if (ptr == nullptr) {
-    freeShapeValues(shaper->_memoryZone, values, values + n);
     return false;
   }
 
@@ -878,7 +828,6 @@ static bool FillShapeValueArray (TRI_shaper_t* shaper,
   dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->_memoryZone, dst->_size, true)));
 
   if (ptr == nullptr) {
-    freeShapeValues(shaper->_memoryZone, values, values + n);
     TRI_Free(shaper->_memoryZone, a);
     return false;
   }
@@ -888,8 +837,6 @@ static bool FillShapeValueArray (TRI_shaper_t* shaper,
   ptr += (v + 1) * sizeof(TRI_shape_size_t);
 
   // and fill in attributes
-  TRI_shape_value_t* const e = values + n;
-
   for (p = values;  p < e;  ++p) {
     *aids++ = p->_aid;
     *sids++ = p->_sid;
@@ -911,9 +858,6 @@ static bool FillShapeValueArray (TRI_shaper_t* shaper,
     }
   }
 
-  // free TRI_shape_value_t array
-  freeShapeValues(shaper->_memoryZone, values, e);
-
   // lookup this shape
   TRI_shape_t const* found = shaper->findShape(shaper, &a->base, create);
 
@@ -928,6 +872,93 @@ static bool FillShapeValueArray (TRI_shaper_t* shaper,
   return true;
 }
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a json array into TRI_shape_value_t
+////////////////////////////////////////////////////////////////////////////////
+
+static bool FillShapeValueArray (TRI_shaper_t* shaper,
+                                 TRI_shape_value_t* dst,
+                                 TRI_json_t const* json,
+                                 size_t level,
+                                 bool create) {
+  // sanity checks
+  TRI_ASSERT(json->_type == TRI_JSON_OBJECT);
+  TRI_ASSERT(json->_value._objects._length % 2 == 0);
+
+  // number of attributes
+  size_t n = json->_value._objects._length / 2;
+
+  // convert into TRI_shape_value_t array
+  TRI_shape_value_t* values = static_cast<TRI_shape_value_t*>(TRI_Allocate(shaper->_memoryZone, n * sizeof(TRI_shape_value_t), true));
+
+  if (values == nullptr) {
+    return false;
+  }
+
+  TRI_shape_value_t* p = values;
+
+  for (size_t i = 0;  i < n;  ++i, ++p) {
+    TRI_json_t const* key = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, 2 * i));
+    TRI_ASSERT(key != nullptr);
+    TRI_ASSERT(key->_type == TRI_JSON_STRING);
+
+    char const* k = key->_value._string.data;
+
+    if (k == nullptr ||
+        key->_value._string.length == 1) {
+      // empty attribute name
+      p--;
+      continue;
+    }
+
+    if (*k == '_' && level == 0) {
+      // on top level, strip reserved attributes before shaping
+      if (strcmp(k, "_key") == 0 || 
+          strcmp(k, "_rev") == 0 ||
+          strcmp(k, "_id") == 0 ||
+          strcmp(k, "_from") == 0 ||
+          strcmp(k, "_to") == 0) {
+        // found a reserved attribute - discard it
+        --p;
+        continue;
+      }
+    }
+
+    // first find an identifier for the name
+    p->_aid = shaper->findOrCreateAttributeByName(shaper, k);
+
+    // convert value
+    bool ok;
+    if (p->_aid == 0) {
+      ok = false;
+    }
+    else {
+      TRI_json_t const* val = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, 2 * i + 1));
+      TRI_ASSERT(val != nullptr);
+
+      ok = FillShapeValueJson(shaper, p, val, level + 1, create);
+    }
+
+    if (! ok) {
+      FreeShapeValues(shaper->_memoryZone, values, p);
+      TRI_Free(shaper->_memoryZone, values);
+      return false;
+    }
+  }
+
+  // now adjust n because we might have excluded empty attributes
+  n = (size_t) (p - values);
+
+  bool ok = FillShapeValueArrayValues(shaper, dst, values, n, create);
+
+  // free TRI_shape_value_t array
+  FreeShapeValues(shaper->_memoryZone, values, values + n);
+  TRI_Free(shaper->_memoryZone, values);
+
+  return ok;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a json object into TRI_shape_value_t
 ////////////////////////////////////////////////////////////////////////////////
@@ -942,17 +973,17 @@ static bool FillShapeValueJson (TRI_shaper_t* shaper,
       return false;
 
     case TRI_JSON_NULL:
-      return FillShapeValueNull(shaper, dst, json);
+      return FillShapeValueNull(shaper, dst);
 
     case TRI_JSON_BOOLEAN:
-      return FillShapeValueBoolean(shaper, dst, json);
+      return FillShapeValueBoolean(shaper, dst, json->_value._boolean);
 
     case TRI_JSON_NUMBER:
-      return FillShapeValueNumber(shaper, dst, json);
+      return FillShapeValueNumber(shaper, dst, json->_value._number);
 
     case TRI_JSON_STRING:
     case TRI_JSON_STRING_REFERENCE:
-      return FillShapeValueString(shaper, dst, json);
+      return FillShapeValueString(shaper, dst, json->_value._string.data, json->_value._string.length);
 
     case TRI_JSON_OBJECT:
       return FillShapeValueArray(shaper, dst, json, level, create);
@@ -964,6 +995,406 @@ static bool FillShapeValueJson (TRI_shaper_t* shaper,
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief state of the conversion of a json text into shape values
+///
+/// _values is a stack holding the values of the elements and attributes of
+/// all lists and arrays that are currently parsed. _skip is non-zero while
+/// the value of a stripped attribute is parsed. such values are only checked,
+/// but not shaped
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct shape_text_parser_s {
+  TRI_json_scanner_t _scanner;
+  TRI_shaper_t* _shaper;
+  TRI_shaped_json_info_t* _info;
+  std::vector<TRI_shape_value_t> _values;
+  size_t _skip;
+  bool _create;
+  int _res;
+}
+shape_text_parser_t;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pushes a shape value onto the value stack of the parser
+///
+/// frees the data of the value if out of memory
+////////////////////////////////////////////////////////////////////////////////
+
+static bool PushShapeValue (shape_text_parser_t* parser,
+                            TRI_shape_value_t const* value) {
+  try {
+    parser->_values.push_back(*value);
+  }
+  catch (...) {
+    if (value->_value != nullptr) {
+      TRI_Free(parser->_shaper->_memoryZone, value->_value);
+    }
+    parser->_res = TRI_ERROR_OUT_OF_MEMORY;
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the values of the parser stack above a position
+////////////////////////////////////////////////////////////////////////////////
+
+static void PopShapeValues (shape_text_parser_t* parser,
+                            size_t start) {
+  std::vector<TRI_shape_value_t>& values = parser->_values;
+
+  FreeShapeValues(parser->_shaper->_memoryZone, values.data() + start, values.data() + values.size());
+  values.resize(start);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a string token into TRI_shape_value_t
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ParseShapeValueString (shape_text_parser_t* parser,
+                                   TRI_shape_value_t* dst,
+                                   int c) {
+  TRI_json_scanner_t* scanner = &parser->_scanner;
+
+  if (parser->_skip > 0) {
+    return true;
+  }
+
+  if (c == TRI_JSON_TOKEN_STRING_ASCII) {
+    // no unescaping necessary, shape the string straight from the input
+    if (! FillShapeValueString(parser->_shaper, dst, scanner->_token + 1, scanner->_tokenLength - 1)) {
+      parser->_res = TRI_ERROR_OUT_OF_MEMORY;
+      return false;
+    }
+
+    return true;
+  }
+
+  size_t length;
+  char* ptr = TRI_StringTokenJsonScanner(scanner, c, &length);
+
+  if (ptr == nullptr) {
+    scanner->_message = "out-of-memory";
+    parser->_res = TRI_ERROR_OUT_OF_MEMORY;
+    return false;
+  }
+
+  bool ok = FillShapeValueString(parser->_shaper, dst, ptr, length + 1);
+  TRI_FreeString(scanner->_memoryZone, ptr);
+
+  if (! ok) {
+    parser->_res = TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a json list into TRI_shape_value_t
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ParseShapeValueList (shape_text_parser_t* parser,
+                                 TRI_shape_value_t* dst,
+                                 size_t level) {
+  TRI_json_scanner_t* scanner = &parser->_scanner;
+  std::vector<TRI_shape_value_t>& values = parser->_values;
+  size_t const start = values.size();
+  bool comma = false;
+  bool ok = false;
+
+  int c = TRI_NextTokenJsonScanner(scanner);
+
+  while (true) {
+    if (c == TRI_JSON_TOKEN_END_OF_FILE) {
+      scanner->_message = "expecting a list element, got end-of-file";
+      break;
+    }
+
+    if (c == TRI_JSON_TOKEN_CLOSE_BRACKET) {
+      if (parser->_skip > 0) {
+        ok = true;
+        break;
+      }
+
+      ok = FillShapeValueListValues(parser->_shaper, dst, values.data() + start, values.size() - start, parser->_create);
+
+      if (! ok) {
+        parser->_res = TRI_ERROR_ARANGO_SHAPER_FAILED;
+      }
+      break;
+    }
+
+    if (comma) {
+      if (c != TRI_JSON_TOKEN_COMMA) {
+        scanner->_message = "expecting comma";
+        break;
+      }
+
+      c = TRI_NextTokenJsonScanner(scanner);
+    }
+    else {
+      comma = true;
+    }
+
+    TRI_shape_value_t value;
+    value._value = nullptr;
+
+    if (! ParseShapeValue(parser, &value, c, level + 1) ||
+        ! PushShapeValue(parser, &value)) {
+      break;
+    }
+
+    c = TRI_NextTokenJsonScanner(scanner);
+  }
+
+  PopShapeValues(parser, start);
+
+  return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a json array into TRI_shape_value_t
+///
+/// empty attribute names and, on top level, the reserved attributes are
+/// skipped as in FillShapeValueArray
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ParseShapeValueArray (shape_text_parser_t* parser,
+                                  TRI_shape_value_t* dst,
+                                  size_t level) {
+  TRI_json_scanner_t* scanner = &parser->_scanner;
+  TRI_shaped_json_info_t* info = parser->_info;
+  std::vector<TRI_shape_value_t>& values = parser->_values;
+  size_t const start = values.size();
+  bool comma = false;
+  bool ok = false;
+
+  int c = TRI_NextTokenJsonScanner(scanner);
+
+  while (true) {
+    if (c == TRI_JSON_TOKEN_END_OF_FILE) {
+      scanner->_message = "expecting a object attribute name or element, got end-of-file";
+      break;
+    }
+
+    if (c == TRI_JSON_TOKEN_CLOSE_BRACE) {
+      if (parser->_skip > 0) {
+        ok = true;
+        break;
+      }
+
+      ok = FillShapeValueArrayValues(parser->_shaper, dst, values.data() + start, values.size() - start, parser->_create);
+
+      if (! ok) {
+        parser->_res = TRI_ERROR_ARANGO_SHAPER_FAILED;
+      }
+      break;
+    }
+
+    if (comma) {
+      if (c != TRI_JSON_TOKEN_COMMA) {
+        scanner->_message = "expecting comma";
+        break;
+      }
+
+      c = TRI_NextTokenJsonScanner(scanner);
+    }
+    else {
+      comma = true;
+    }
+
+    // attribute name
+    if (c != TRI_JSON_TOKEN_STRING && c != TRI_JSON_TOKEN_STRING_ASCII) {
+      scanner->_message = "expecting attribute name";
+      break;
+    }
+
+    // short plain names are copied onto the stack, all others are unescaped
+    char buffer[256];
+    char* name;
+    size_t nameLength;
+
+    if (c == TRI_JSON_TOKEN_STRING_ASCII && scanner->_tokenLength - 2 < sizeof(buffer)) {
+      nameLength = scanner->_tokenLength - 2;
+      memcpy(buffer, scanner->_token + 1, nameLength);
+      buffer[nameLength] = '\0';
+      name = buffer;
+    }
+    else {
+      name = TRI_StringTokenJsonScanner(scanner, c, &nameLength);
+
+      if (name == nullptr) {
+        scanner->_message = "out-of-memory";
+        parser->_res = TRI_ERROR_OUT_OF_MEMORY;
+        break;
+      }
+    }
+
+    // followed by a colon
+    c = TRI_NextTokenJsonScanner(scanner);
+
+    if (c != TRI_JSON_TOKEN_COLON) {
+      if (name != buffer) {
+        TRI_FreeString(scanner->_memoryZone, name);
+      }
+      scanner->_message = "expecting colon";
+      break;
+    }
+
+    bool skip = false;
+    bool isKey = false;
+
+    if (nameLength == 0) {
+      // empty attribute name
+      skip = true;
+    }
+    else if (*name == '_' && level == 0) {
+      // on top level, strip reserved attributes before shaping
+      if (strcmp(name, "_key") == 0) {
+        isKey = (info != nullptr && ! info->_hasKey);
+        skip = true;
+      }
+      else if (strcmp(name, "_rev") == 0 ||
+               strcmp(name, "_id") == 0 ||
+               strcmp(name, "_from") == 0 ||
+               strcmp(name, "_to") == 0) {
+        skip = true;
+      }
+    }
+
+    if (parser->_skip > 0) {
+      skip = true;
+      isKey = false;
+    }
+
+    TRI_shape_value_t value;
+    value._value = nullptr;
+
+    if (! skip) {
+      // first find an identifier for the name
+      value._aid = parser->_shaper->findOrCreateAttributeByName(parser->_shaper, name);
+    }
+
+    if (name != buffer) {
+      TRI_FreeString(scanner->_memoryZone, name);
+    }
+
+    if (! skip && value._aid == 0) {
+      parser->_res = TRI_ERROR_ARANGO_SHAPER_FAILED;
+      break;
+    }
+
+    // followed by a value
+    c = TRI_NextTokenJsonScanner(scanner);
+
+    if (isKey) {
+      info->_hasKey = true;
+
+      if (c == TRI_JSON_TOKEN_STRING || c == TRI_JSON_TOKEN_STRING_ASCII) {
+        size_t keyLength;
+        info->_key = TRI_StringTokenJsonScanner(scanner, c, &keyLength);
+
+        if (info->_key == nullptr) {
+          scanner->_message = "out-of-memory";
+          parser->_res = TRI_ERROR_OUT_OF_MEMORY;
+          break;
+        }
+      }
+    }
+
+    if (skip) {
+      // values of skipped attributes are checked, but not shaped
+      ++parser->_skip;
+      bool valid = ParseShapeValue(parser, &value, c, level + 1);
+      --parser->_skip;
+
+      if (! valid) {
+        break;
+      }
+    }
+    else if (! ParseShapeValue(parser, &value, c, level + 1) ||
+             ! PushShapeValue(parser, &value)) {
+      break;
+    }
+
+    c = TRI_NextTokenJsonScanner(scanner);
+  }
+
+  PopShapeValues(parser, start);
+
+  return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a json value into TRI_shape_value_t
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ParseShapeValue (shape_text_parser_t* parser,
+                             TRI_shape_value_t* dst,
+                             int c,
+                             size_t level) {
+  TRI_json_scanner_t* scanner = &parser->_scanner;
+  TRI_shaper_t* shaper = parser->_shaper;
+  bool const skip = (parser->_skip > 0);
+  bool ok;
+
+  switch (c) {
+    case TRI_JSON_TOKEN_FALSE:
+      ok = skip || FillShapeValueBoolean(shaper, dst, false);
+      break;
+
+    case TRI_JSON_TOKEN_TRUE:
+      ok = skip || FillShapeValueBoolean(shaper, dst, true);
+      break;
+
+    case TRI_JSON_TOKEN_NULL:
+      ok = skip || FillShapeValueNull(shaper, dst);
+      break;
+
+    case TRI_JSON_TOKEN_NUMBER: {
+      double d;
+
+      if (! TRI_NumberTokenJsonScanner(scanner, &d)) {
+        return false;
+      }
+
+      if (skip) {
+        ok = true;
+      }
+      else if (std::isnan(d) || d == HUGE_VAL || d == -HUGE_VAL) {
+        // cannot be represented in json, see TRI_InitNumberJson
+        ok = FillShapeValueNull(shaper, dst);
+      }
+      else {
+        ok = FillShapeValueNumber(shaper, dst, d);
+      }
+      break;
+    }
+
+    case TRI_JSON_TOKEN_STRING:
+    case TRI_JSON_TOKEN_STRING_ASCII:
+      return ParseShapeValueString(parser, dst, c);
+
+    case TRI_JSON_TOKEN_OPEN_BRACE:
+      return ParseShapeValueArray(parser, dst, level);
+
+    case TRI_JSON_TOKEN_OPEN_BRACKET:
+      return ParseShapeValueList(parser, dst, level);
+
+    default:
+      TRI_UnexpectedTokenJsonScanner(scanner, c);
+      return false;
+  }
+
+  if (! ok) {
+    parser->_res = TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  return ok;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a data null blob into a json object
 ////////////////////////////////////////////////////////////////////////////////
@@ -2109,6 +2540,28 @@ void TRI_FreeShapedJson (TRI_memory_zone_t* zone,
   TRI_Free(zone, shaped);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initialises the information about a json text
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_InitShapedJsonInfo (TRI_shaped_json_info_t* info) {
+  info->_isObject = false;
+  info->_hasKey = false;
+  info->_key = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroys the information about a json text, but does not free the
+/// pointer
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_DestroyShapedJsonInfo (TRI_shaped_json_info_t* info) {
+  if (info->_key != nullptr) {
+    TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, info->_key);
+    info->_key = nullptr;
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -2161,6 +2614,69 @@ TRI_shaped_json_t* TRI_ShapedJsonJson (TRI_shaper_t* shaper,
   return shaped;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a json text of the given length into a shaped json object
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_ShapedJsonString (TRI_shaper_t* shaper,
+                          char const* text,
+                          size_t length,
+                          bool create,
+                          TRI_shaped_json_t** shaped,
+                          TRI_shaped_json_info_t* info) {
+  *shaped = nullptr;
+
+  shape_text_parser_t parser;
+
+  TRI_InitJsonScanner(&parser._scanner, TRI_UNKNOWN_MEM_ZONE, text, length);
+  parser._shaper = shaper;
+  parser._info = info;
+  parser._skip = 0;
+  parser._create = create;
+  parser._res = TRI_ERROR_HTTP_CORRUPTED_JSON;
+
+  TRI_shape_value_t dst;
+  dst._value = nullptr;
+
+  int c = TRI_NextTokenJsonScanner(&parser._scanner);
+
+  if (info != nullptr) {
+    info->_isObject = (c == TRI_JSON_TOKEN_OPEN_BRACE);
+  }
+
+  if (! ParseShapeValue(&parser, &dst, c, 0)) {
+    if (parser._res == TRI_ERROR_HTTP_CORRUPTED_JSON) {
+      LOG_DEBUG("failed to parse json object: '%s'", parser._scanner._message);
+    }
+    return parser._res;
+  }
+
+  if (TRI_NextTokenJsonScanner(&parser._scanner) != TRI_JSON_TOKEN_END_OF_FILE) {
+    LOG_DEBUG("failed to parse json object: expecting EOF");
+
+    if (dst._value != nullptr) {
+      TRI_Free(shaper->_memoryZone, dst._value);
+    }
+    return TRI_ERROR_HTTP_CORRUPTED_JSON;
+  }
+
+  // no need to prefill shaped with 0's as all attributes are set directly afterwards
+  *shaped = static_cast<TRI_shaped_json_t*>(TRI_Allocate(shaper->_memoryZone, sizeof(TRI_shaped_json_t), false));
+
+  if (*shaped == nullptr) {
+    if (dst._value != nullptr) {
+      TRI_Free(shaper->_memoryZone, dst._value);
+    }
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  (*shaped)->_sid = dst._sid;
+  (*shaped)->_data.length = (uint32_t) dst._size;
+  (*shaped)->_data.data = dst._value;
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a shaped json object into a json object
 ////////////////////////////////////////////////////////////////////////////////
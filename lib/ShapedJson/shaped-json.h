@@ -881,6 +881,20 @@ typedef struct TRI_shaped_sub_s {
 }
 TRI_shaped_sub_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief information about a json text gathered while shaping it
+///
+/// _hasKey is set if the top-level object has a _key attribute. _key is its
+/// value if it is a string, and nullptr otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct TRI_shaped_json_info_s {
+  bool _isObject;
+  bool _hasKey;
+  char* _key;
+}
+TRI_shaped_json_info_t;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    ATTRIBUTE PATH
 // -----------------------------------------------------------------------------
@@ -931,6 +945,19 @@ void TRI_DestroyShapedJson (struct TRI_memory_zone_s*, TRI_shaped_json_t*);
 void TRI_FreeShapedJson (struct TRI_memory_zone_s*,
                          TRI_shaped_json_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initialises the information about a json text
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_InitShapedJsonInfo (TRI_shaped_json_info_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroys the information about a json text, but does not free the
+/// pointer
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_DestroyShapedJsonInfo (TRI_shaped_json_info_t*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -950,6 +977,23 @@ TRI_shaped_json_t* TRI_ShapedJsonJson (struct TRI_shaper_s*,
                                        TRI_json_t const*,
                                        bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a json text of the given length into a shaped json object
+///
+/// the text is shaped directly, without building a json object first. the
+/// result is the same as that of TRI_ShapedJsonJson for the parsed text.
+/// returns TRI_ERROR_HTTP_CORRUPTED_JSON if the text cannot be parsed and
+/// TRI_ERROR_ARANGO_SHAPER_FAILED if it cannot be shaped. the information
+/// is optional and must be initialised with TRI_InitShapedJsonInfo
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_ShapedJsonString (struct TRI_shaper_s*,
+                          char const*,
+                          size_t,
+                          bool,
+                          TRI_shaped_json_t**,
+                          TRI_shaped_json_info_t*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a shaped json object into a json object
 ////////////////////////////////////////////////////////////////////////////////
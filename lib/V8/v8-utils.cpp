@@ -2719,6 +2719,9 @@ static void JS_RemoveRecursiveDirectory (const v8::FunctionCallbackInfo<v8::Valu
 /// Returns information about the server:
 ///
 /// - `uptime`: time since server start in seconds.
+/// - `physicalMemory`: the physical memory of the machine in bytes.
+/// - `arenaMemory`: the memory currently reserved by arena memory zones,
+///   the high-water mark of it, and the high-water mark of a single arena.
 ////////////////////////////////////////////////////////////////////////////////
 
 static void JS_ServerStatistics (const v8::FunctionCallbackInfo<v8::Value>& args) {
@@ -2732,6 +2735,16 @@ static void JS_ServerStatistics (const v8::FunctionCallbackInfo<v8::Value>& args
   result->Set(TRI_V8_ASCII_STRING("uptime"),         v8::Number::New(isolate, (double) info._uptime));
   result->Set(TRI_V8_ASCII_STRING("physicalMemory"), v8::Number::New(isolate, (double) TRI_PhysicalMemory));
 
+  uint64_t current, peak, largest;
+  TRI_GetArenaMemoryStatistics(&current, &peak, &largest);
+
+  v8::Handle<v8::Object> arena = v8::Object::New(isolate);
+  arena->Set(TRI_V8_ASCII_STRING("current"), v8::Number::New(isolate, (double) current));
+  arena->Set(TRI_V8_ASCII_STRING("peak"),    v8::Number::New(isolate, (double) peak));
+  arena->Set(TRI_V8_ASCII_STRING("largest"), v8::Number::New(isolate, (double) largest));
+
+  result->Set(TRI_V8_ASCII_STRING("arenaMemory"), arena);
+
   TRI_V8_RETURN(result);
 }
 